@@ -19,17 +19,20 @@ static void MultMatrix_default( float m0[4][4], float m1[4][4],
 
 static void TransformVectorNormalize_default(float vec[3], float mtx[4][4])
 {
-    float len;
+    float len, x, y, z;
 
-    vec[0] = mtx[0][0] * vec[0]
-           + mtx[1][0] * vec[1]
-           + mtx[2][0] * vec[2];
-    vec[1] = mtx[0][1] * vec[0]
-           + mtx[1][1] * vec[1]
-           + mtx[2][1] * vec[2];
-    vec[2] = mtx[0][2] * vec[0]
-           + mtx[1][2] * vec[1]
-           + mtx[2][2] * vec[2];
+    x = vec[0];
+    y = vec[1];
+    z = vec[2];
+    vec[0] = mtx[0][0] * x
+           + mtx[1][0] * y
+           + mtx[2][0] * z;
+    vec[1] = mtx[0][1] * x
+           + mtx[1][1] * y
+           + mtx[2][1] * z;
+    vec[2] = mtx[0][2] * x
+           + mtx[1][2] * y
+           + mtx[2][2] * z;
     len = vec[0]*vec[0] + vec[1]*vec[1] + vec[2]*vec[2];
     if (len != 0.0)
     {
@@ -48,6 +48,9 @@ static INLINE void Transpose3x3Matrix( float mtx[4][4] )
 #ifdef __NEON_OPT
 void MathInitNeon();
 #endif
+#if !defined(NOSSE)
+void MathInitSSE();
+#endif
 
 #ifdef __cplusplus
 }
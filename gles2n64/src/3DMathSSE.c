@@ -0,0 +1,61 @@
+#include "3DMath.h"
+
+#if !defined(NOSSE)
+#include <emmintrin.h>
+
+static void MultMatrix_sse( float m0[4][4], float m1[4][4], float dest[4][4])
+{
+    __m128 r0 = _mm_loadu_ps(m0[0]);
+    __m128 r1 = _mm_loadu_ps(m0[1]);
+    __m128 r2 = _mm_loadu_ps(m0[2]);
+    __m128 r3 = _mm_loadu_ps(m0[3]);
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        __m128 d = _mm_mul_ps(r0, _mm_set1_ps(m1[i][0]));
+        d = _mm_add_ps(d, _mm_mul_ps(r1, _mm_set1_ps(m1[i][1])));
+        d = _mm_add_ps(d, _mm_mul_ps(r2, _mm_set1_ps(m1[i][2])));
+        d = _mm_add_ps(d, _mm_mul_ps(r3, _mm_set1_ps(m1[i][3])));
+        _mm_storeu_ps(dest[i], d);
+    }
+
+    //the scalar version sums the last row backwards, keep its rounding
+    {
+        __m128 d = _mm_mul_ps(r3, _mm_set1_ps(m1[3][3]));
+        d = _mm_add_ps(d, _mm_mul_ps(r2, _mm_set1_ps(m1[3][2])));
+        d = _mm_add_ps(d, _mm_mul_ps(r1, _mm_set1_ps(m1[3][1])));
+        d = _mm_add_ps(d, _mm_mul_ps(r0, _mm_set1_ps(m1[3][0])));
+        _mm_storeu_ps(dest[3], d);
+    }
+}
+
+static void TransformVectorNormalize_sse(float vec[3], float mtx[4][4])
+{
+    float out[4];
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(mtx[0]), _mm_set1_ps(vec[0]));
+    __m128 len;
+
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(mtx[1]), _mm_set1_ps(vec[1])));
+    v = _mm_add_ps(v, _mm_mul_ps(_mm_loadu_ps(mtx[2]), _mm_set1_ps(vec[2])));
+    _mm_storeu_ps(out, v);
+
+    len = _mm_set1_ps(out[0]*out[0] + out[1]*out[1] + out[2]*out[2]);
+    if (_mm_cvtss_f32(len) != 0.0f)
+    {
+        v = _mm_div_ps(v, _mm_sqrt_ps(len));
+        _mm_storeu_ps(out, v);
+    }
+
+    //vec has 3 floats only
+    vec[0] = out[0];
+    vec[1] = out[1];
+    vec[2] = out[2];
+}
+
+void MathInitSSE()
+{
+    MultMatrix = MultMatrix_sse;
+    TransformVectorNormalize = TransformVectorNormalize_sse;
+}
+#endif
@@ -1,14 +1,11 @@
 #include "Types.h"
 
 #include "CRC.h" // __LIBRETRO__: Allow it to rename symbols
+#include "texhash.h"
 
 #define CRC32_POLYNOMIAL     0x04C11DB7
 
-#ifdef __CRC_OPT
-unsigned int CRCTable[ 256 * 4];
-#else
 unsigned int CRCTable[ 256 ];
-#endif
 
 u32 Reflect( u32 ref, char ch )
 {
@@ -39,43 +36,12 @@ void CRC_BuildTable()
 
         CRCTable[i] = Reflect( crc, 32 );
     }
-
-#ifdef __CRC_OPT
-    for (i = 0; i < 256; i++)
-    {
-        for(j = 0; j < 3; j++)
-        {
-            CRCTable[256*(j+1) + i] = (CRCTable[256*j + i]>>8) ^ CRCTable[CRCTable[256*j + i]&0xFF];
-        }
-    }
-#endif
-
 }
 
+//texture and palette keys, CRC32C on the CPU's CRC instructions when it has them
 u32 CRC_Calculate( u32 crc, void *buffer, u32 count )
 {
-    u8 *p;
-    u32 orig = crc;
-
-    p = (u8*) buffer;
-
-#ifdef __CRC_OPT
-    while(count > 3)
-    {
-        crc ^= *(unsigned int*) p; p += 4;
-        crc = CRCTable[3*256 + (crc&0xFF)]
-          ^ CRCTable[2*256 + ((crc>>8)&0xFF)]
-          ^ CRCTable[1*256 + ((crc>>16)&0xFF)]
-          ^ CRCTable[0*256 + ((crc>>24))];
-
-        count -= 4;
-    }
-#endif
-
-    while (count--)
-        crc = (crc >> 8) ^ CRCTable[(crc & 0xFF) ^ *p++];
-
-    return crc ^ orig;
+    return texhash( crc, buffer, count );
 }
 
 u32 CRC_CalculatePalette( u32 crc, void *buffer, u32 count )
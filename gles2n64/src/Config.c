@@ -76,7 +76,6 @@ Option configOptions[] =
     {"texture force bilinear", &config.texture.forceBilinear, 0},
     {"texture max anisotropy", &config.texture.maxAnisotropy, 0},
     {"texture use IA", &config.texture.useIA, 0},
-    {"texture fast CRC", &config.texture.fastCRC, 1},
     {"texture pow2", &config.texture.pow2, 1},
     {"", NULL, 0},
 
@@ -89,6 +88,7 @@ Option configOptions[] =
 //// (part of the Galaxy S Zelda crash-fix
     {"tribuffer opt", &config.tribufferOpt, 1},
 //
+    {"shader cache", &config.shaderCache, 1},
     {"", NULL, 0},
 
     {"#Hack Settings:", NULL, 0},
@@ -32,7 +32,6 @@ typedef struct
         int forceBilinear;
         int sai2x;
         int useIA;
-        int fastCRC;
         int pow2;
     } texture;
 
@@ -53,6 +52,7 @@ typedef struct
 //// (part of the Galaxy S Zelda crash-fix
     int     tribufferOpt;
 //
+    int     shaderCache;
 
     int     hackBanjoTooie;
     int     hackZelda;
@@ -1,4 +1,4 @@
-#include <stdlib.h>
+#include <string.h>
 #include "DepthBuffer.h"
 #include "Types.h"
 
@@ -6,160 +6,110 @@ DepthBufferInfo depthBuffer;
 
 void DepthBuffer_Init()
 {
-    depthBuffer.current = NULL;
-    depthBuffer.top = NULL;
-    depthBuffer.bottom = NULL;
-    depthBuffer.numBuffers = 0;
+    memset(&depthBuffer, 0, sizeof(depthBuffer));
 }
 
-void DepthBuffer_RemoveBottom()
+static INLINE u32 DepthBuffer_Slot( u32 address )
 {
-    DepthBuffer *newBottom = depthBuffer.bottom->higher;
-
-    if (depthBuffer.bottom == depthBuffer.top)
-        depthBuffer.top = NULL;
-
-    free( depthBuffer.bottom );
-
-    depthBuffer.bottom = newBottom;
-
-    if (depthBuffer.bottom != NULL)
-        depthBuffer.bottom->lower = NULL;
-
-    depthBuffer.numBuffers--;
+    return (address * 2654435761u) >> 26 & (DEPTHBUFFER_INDEX - 1);
 }
 
-void DepthBuffer_Remove( DepthBuffer *buffer )
+static u32 DepthBuffer_Find( u32 address )
 {
-    if ((buffer == depthBuffer.bottom) &&
-        (buffer == depthBuffer.top))
-    {
-        depthBuffer.top = NULL;
-        depthBuffer.bottom = NULL;
-    }
-    else if (buffer == depthBuffer.bottom)
-    {
-        depthBuffer.bottom = buffer->higher;
-
-        if (depthBuffer.bottom)
-            depthBuffer.bottom->lower = NULL;
-    }
-    else if (buffer == depthBuffer.top)
-    {
-        depthBuffer.top = buffer->lower;
+    u32 i = DepthBuffer_Slot( address );
 
-        if (depthBuffer.top)
-            depthBuffer.top->higher = NULL;
-    }
-    else
-    {
-        buffer->higher->lower = buffer->lower;
-        buffer->lower->higher = buffer->higher;
-    }
+    while (depthBuffer.index[i] && depthBuffer.index[i]->address != address)
+        i = (i + 1) & (DEPTHBUFFER_INDEX - 1);
 
-    free( buffer );
-    depthBuffer.numBuffers--;
+    return i;
 }
 
-void DepthBuffer_RemoveBuffer( u32 address )
+static void DepthBuffer_Link( DepthBuffer *buffer )
 {
-    DepthBuffer *current = depthBuffer.bottom;
-    while (current != NULL)
-    {
-        if (current->address == address)
-        {
-            DepthBuffer_Remove( current );
-            return;
-        }
-        current = current->higher;
-    }
+    depthBuffer.index[DepthBuffer_Find( buffer->address )] = buffer;
 }
 
-DepthBuffer *DepthBuffer_AddTop()
+//moves the entries after it back, so no search stops at the hole it leaves
+static void DepthBuffer_Unlink( DepthBuffer *buffer )
 {
-    DepthBuffer *newtop = (DepthBuffer*)malloc( sizeof( DepthBuffer ) );
-
-    newtop->lower = depthBuffer.top;
-    newtop->higher = NULL;
+    u32 i = DepthBuffer_Find( buffer->address ), j = i, k;
 
-    if (depthBuffer.top)
-        depthBuffer.top->higher = newtop;
-
-    if (!depthBuffer.bottom)
-        depthBuffer.bottom = newtop;
-
-    depthBuffer.top = newtop;
-
-    depthBuffer.numBuffers++;
-
-    return newtop;
+    depthBuffer.index[i] = NULL;
+    for (;;)
+    {
+        j = (j + 1) & (DEPTHBUFFER_INDEX - 1);
+        if (!depthBuffer.index[j])
+            break;
+
+        //entries whose home slot is between the hole and them stay
+        k = DepthBuffer_Slot( depthBuffer.index[j]->address );
+        if (((j - k) & (DEPTHBUFFER_INDEX - 1)) < ((j - i) & (DEPTHBUFFER_INDEX - 1)))
+            continue;
+
+        depthBuffer.index[i] = depthBuffer.index[j];
+        depthBuffer.index[j] = NULL;
+        i = j;
+    }
 }
 
-void DepthBuffer_MoveToTop( DepthBuffer *newtop )
+void DepthBuffer_RemoveBuffer( u32 address )
 {
-    if (newtop == depthBuffer.top)
+    DepthBuffer *buffer = DepthBuffer_FindBuffer( address );
+    DepthBuffer *last;
+
+    if (!buffer)
         return;
 
-    if (newtop == depthBuffer.bottom)
-    {
-        depthBuffer.bottom = newtop->higher;
-        depthBuffer.bottom->lower = NULL;
-    }
-    else
+    if (depthBuffer.current == buffer)
+        depthBuffer.current = NULL;
+    DepthBuffer_Unlink( buffer );
+
+    //keep the buffers packed
+    last = &depthBuffer.buffers[--depthBuffer.numBuffers];
+    if (buffer != last)
     {
-        newtop->higher->lower = newtop->lower;
-        newtop->lower->higher = newtop->higher;
+        DepthBuffer_Unlink( last );
+        *buffer = *last;
+        DepthBuffer_Link( buffer );
+        if (depthBuffer.current == last)
+            depthBuffer.current = buffer;
     }
-
-    newtop->higher = NULL;
-    newtop->lower = depthBuffer.top;
-    depthBuffer.top->higher = newtop;
-    depthBuffer.top = newtop;
 }
 
 void DepthBuffer_Destroy()
 {
-    while (depthBuffer.bottom)
-        DepthBuffer_RemoveBottom();
-
-    depthBuffer.top = NULL;
+    DepthBuffer_Init();
 }
 
 void DepthBuffer_SetBuffer( u32 address )
 {
-    DepthBuffer *current = depthBuffer.top;
+    DepthBuffer *current = DepthBuffer_FindBuffer( address );
 
-    // Search through saved depth buffers
-    while (current != NULL)
+    if (!current)
     {
-        if (current->address == address)
+        if (depthBuffer.numBuffers < DEPTHBUFFER_MAX)
+            current = &depthBuffer.buffers[depthBuffer.numBuffers++];
+        else
         {
-            DepthBuffer_MoveToTop( current );
-            depthBuffer.current = current;
-            return;
+            int i;
+            current = &depthBuffer.buffers[0];
+            for (i = 1; i < DEPTHBUFFER_MAX; i++)
+                if (depthBuffer.buffers[i].lastUsed < current->lastUsed)
+                    current = &depthBuffer.buffers[i];
+            DepthBuffer_Unlink( current );
         }
-        current = current->lower;
-    }
-
-    current = DepthBuffer_AddTop();
 
-    current->address = address;
-    current->cleared = TRUE;
+        current->address = address;
+        current->cleared = TRUE;
+        DepthBuffer_Link( current );
+    }
 
+    current->lastUsed = ++depthBuffer.useCount;
     depthBuffer.current = current;
 }
 
 DepthBuffer *DepthBuffer_FindBuffer( u32 address )
 {
-    DepthBuffer *current = depthBuffer.top;
-
-    while (current)
-    {
-        if (current->address == address)
-            return current;
-        current = current->lower;
-    }
-
-    return NULL;
+    return depthBuffer.index[DepthBuffer_Find( address )];
 }
 
@@ -11,17 +11,22 @@ extern "C" {
 #define depthBuffer gln64depthBuffer
 #endif
 
+#define DEPTHBUFFER_MAX     16      //the least recently used is reused beyond
+#define DEPTHBUFFER_INDEX   64      //a power of 2, well above DEPTHBUFFER_MAX
+
 typedef struct DepthBuffer
 {
-    struct DepthBuffer *higher, *lower;
-
     u32 address, cleared;
+    u32 lastUsed;
 } DepthBuffer;
 
 typedef struct
 {
-    DepthBuffer *top, *bottom, *current;
+    DepthBuffer buffers[DEPTHBUFFER_MAX];
+    DepthBuffer *index[DEPTHBUFFER_INDEX];  //by address, linear probing
+    DepthBuffer *current;
     int numBuffers;
+    u32 useCount;
 } DepthBufferInfo;
 
 extern DepthBufferInfo depthBuffer;
@@ -26,6 +26,7 @@
 
 #include "CRC.h"
 #include "Debug.h"
+#include "plugin/ucode_id.h"
 
 #ifdef __LIBRETRO__ // Prefix symbol
 #define uc_crc gln64uc_crc
@@ -48,6 +49,19 @@ SpecialMicrocodeInfo specialMicrocodes[] =
     //{F3DCBFD, FALSE, 0x1b4ace88, "RSP Gfx ucode F3DEXBG.NoN fifo 2.08  Yoshitaka Yasumoto 1999 Nintendo."},
 };
 
+// ucode_id families and the GBI each one maps to
+static const int familyMicrocodes[][2] =
+{
+    {UCODE_FAMILY_FAST3D, F3D},
+    {UCODE_FAMILY_F3DEX, F3DEX},
+    {UCODE_FAMILY_F3DEX2, F3DEX2},
+    {UCODE_FAMILY_WAVERACE, F3DWRUS},
+    {UCODE_FAMILY_DKR, F3DDKR},
+    {UCODE_FAMILY_S2DEX, S2DEX},
+    {UCODE_FAMILY_PD, F3DPD},
+    {UCODE_FAMILY_CBFD, F3DCBFD},
+};
+
 u32 G_RDPHALF_1, G_RDPHALF_2, G_RDPHALF_CONT;
 u32 G_SPNOOP;
 u32 G_SETOTHERMODE_H, G_SETOTHERMODE_L;
@@ -164,6 +178,7 @@ MicrocodeInfo *GBI_DetectMicrocode( u32 uc_start, u32 uc_dstart, u16 uc_dsize )
 {
    int i;
     MicrocodeInfo *current;
+    const struct ucode_info *info;
 
     for (i = 0; i < GBI.numMicrocodes; i++)
     {
@@ -187,7 +202,8 @@ MicrocodeInfo *GBI_DetectMicrocode( u32 uc_start, u32 uc_dstart, u16 uc_dsize )
     current->type = NONE;
 
     // See if we can identify it by CRC
-    uc_crc = CRC_Calculate( 0xFFFFFFFF, &RDRAM[uc_start & 0x1FFFFFFF], 4096);
+    info = ucode_id_lookup( uc_start );
+    uc_crc = info->crc_4k;
     LOG(LOG_MINIMAL, "UCODE CRC=0x%x\n", uc_crc);
 
     for (i = 0; i < sizeof( specialMicrocodes ) / sizeof( SpecialMicrocodeInfo ); i++)
@@ -272,6 +288,16 @@ MicrocodeInfo *GBI_DetectMicrocode( u32 uc_start, u32 uc_dstart, u16 uc_dsize )
         }
     }
 
+    // Fall back on the family the core's ucode table knows it by
+    for (i = 0; i < sizeof( familyMicrocodes ) / sizeof( familyMicrocodes[0] ); i++)
+    {
+        if (info->family == familyMicrocodes[i][0])
+        {
+            current->type = familyMicrocodes[i][1];
+            return current;
+        }
+    }
+
     // Let the user choose the microcode
     LOG(LOG_ERROR, "[gles2n64]: Warning - unknown ucode!!!\n");
     if(last_good_ucode != (u32)-1)
@@ -313,6 +339,12 @@ void GBI_MakeCurrent( MicrocodeInfo *current )
         for (i = 0; i <= 0xFF; i++)
             GBI.cmd[i] = GBI_Unknown;
 
+        //commands the new ucode leaves out must not keep the values of the
+        //last one, gSPKeepsTriangles would batch triangles across them
+        G_SPNOOP = G_DL = G_ENDDL = G_CULLDL = G_BRANCH_Z = 0x100;
+        G_MTX = G_POPMTX = G_VTX = G_MODIFYVTX = G_VTXCOLORBASE = 0x100;
+        G_TRI1 = G_TRI2 = G_TRI4 = G_QUAD = 0x100;
+
         RDP_Init();
         switch (current->type)
         {
@@ -1,5 +1,6 @@
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
@@ -117,6 +118,28 @@ void OGL_UpdateScale()
 
 int retro_return(bool just_flipping);
 
+static void OGL_InitStream()
+{
+    glGenBuffers(1, &OGL.stream.vbo);
+    glGenBuffers(1, &OGL.stream.ibo);
+    glBindBuffer(GL_ARRAY_BUFFER, OGL.stream.vbo);
+    glBufferData(GL_ARRAY_BUFFER, STREAM_VERTICES * sizeof(GLStreamVertex), NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, OGL.stream.ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, STREAM_ELEMENTS * sizeof(GLushort), NULL, GL_STREAM_DRAW);
+    OGL.stream.vertex = 0;
+    OGL.stream.element = 0;
+    OGL_ReleaseStream();
+}
+
+//Unbinds the stream buffers, for the client arrays of lines and rects and for
+//whoever draws after us. Triangles bind them again on their next draw.
+void OGL_ReleaseStream()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    OGL.renderState = RS_NONE;
+}
+
 bool OGL_Start()
 {
     OGL_InitStates();
@@ -168,8 +191,14 @@ bool OGL_Start()
     TextureCache_Init();
 
     memset(OGL.triangles.vertices, 0, VERTBUFF_SIZE * sizeof(SPVertex));
-    memset(OGL.triangles.elements, 0, ELEMBUFF_SIZE * sizeof(GLubyte));
+    memset(OGL.triangles.elements, 0, ELEMBUFF_SIZE * sizeof(GLushort));
+    memset(OGL.triangles.stamp, 0, VERTBUFF_SIZE * sizeof(u32));
     OGL.triangles.num = 0;
+    OGL.triangles.numCopies = 0;
+    OGL.triangles.currentStamp = 1;
+    memset(&OGL.stats, 0, sizeof(OGL.stats));
+
+    OGL_InitStream();
 
 #ifdef __TRIBUFFER_OPT
     __indexmap_init();
@@ -190,6 +219,9 @@ void OGL_Stop()
 
     ShaderCombiner_Destroy();
     TextureCache_Destroy();
+
+    glDeleteBuffers(1, &OGL.stream.vbo);
+    glDeleteBuffers(1, &OGL.stream.ibo);
 }
 
 void OGL_UpdateCullFace()
@@ -545,11 +577,50 @@ void OGL_DrawTriangle(SPVertex *vertices, int v0, int v1, int v2)
 
 }
 
+//vertices[] may have changed, copy them to the stream again when used
+void OGL_InvalidateVertices()
+{
+    //a stamp from before a wrap-around could be taken for the current one
+    if (++OGL.triangles.currentStamp == 0)
+    {
+        memset(OGL.triangles.stamp, 0, VERTBUFF_SIZE * sizeof(u32));
+        OGL.triangles.currentStamp = 1;
+    }
+}
+
+//stream index of vertices[v], copying it for the batch on first use
+static INLINE GLushort OGL_StreamVertex(int v)
+{
+    if (OGL.triangles.stamp[v] != OGL.triangles.currentStamp)
+    {
+        SPVertex *src = &OGL.triangles.vertices[v];
+        GLStreamVertex *dest = &OGL.triangles.copies[OGL.triangles.numCopies];
+
+        dest->x = src->x;
+        dest->y = src->y;
+        dest->z = src->z;
+        dest->w = src->w;
+        dest->r = src->r;
+        dest->g = src->g;
+        dest->b = src->b;
+        dest->a = src->a;
+        dest->s = src->s;
+        dest->t = src->t;
+
+        OGL.triangles.streamIndex[v] = OGL.stream.vertex + OGL.triangles.numCopies++;
+        OGL.triangles.stamp[v] = OGL.triangles.currentStamp;
+    }
+    return OGL.triangles.streamIndex[v];
+}
+
 void OGL_AddTriangle(int v0, int v1, int v2)
 {
-    OGL.triangles.elements[OGL.triangles.num++] = v0;
-    OGL.triangles.elements[OGL.triangles.num++] = v1;
-    OGL.triangles.elements[OGL.triangles.num++] = v2;
+    if (OGL.triangles.num + 3 > ELEMBUFF_SIZE)
+        OGL_DrawTriangles();
+
+    OGL.triangles.elements[OGL.triangles.num++] = OGL_StreamVertex(v0);
+    OGL.triangles.elements[OGL.triangles.num++] = OGL_StreamVertex(v1);
+    OGL.triangles.elements[OGL.triangles.num++] = OGL_StreamVertex(v2);
 }
 
 void OGL_SetColorArray()
@@ -578,6 +649,8 @@ void OGL_DrawTriangles()
     if (OGL.renderingToTexture && config.ignoreOffscreenRendering)
     {
         OGL.triangles.num = 0;
+        OGL.triangles.numCopies = 0;
+        OGL_InvalidateVertices();
         return;
     }
 
@@ -599,11 +672,13 @@ void OGL_DrawTriangles()
 
     if (OGL.renderState != RS_TRIANGLE)
     {
-        glVertexAttribPointer(SC_POSITION, 4, GL_FLOAT, GL_FALSE, sizeof(SPVertex), &OGL.triangles.vertices[0].x);
+        glBindBuffer(GL_ARRAY_BUFFER, OGL.stream.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, OGL.stream.ibo);
+        glVertexAttribPointer(SC_POSITION, 4, GL_FLOAT, GL_FALSE, sizeof(GLStreamVertex), (GLvoid*)offsetof(GLStreamVertex, x));
         glEnableVertexAttribArray(SC_POSITION);
-        glVertexAttribPointer(SC_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(SPVertex), &OGL.triangles.vertices[0].r);
+        glVertexAttribPointer(SC_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(GLStreamVertex), (GLvoid*)offsetof(GLStreamVertex, r));
         glEnableVertexAttribArray(SC_COLOR);
-        glVertexAttribPointer(SC_TEXCOORD0, 2, GL_FLOAT, GL_FALSE, sizeof(SPVertex), &OGL.triangles.vertices[0].s);
+        glVertexAttribPointer(SC_TEXCOORD0, 2, GL_FLOAT, GL_FALSE, sizeof(GLStreamVertex), (GLvoid*)offsetof(GLStreamVertex, s));
         glEnableVertexAttribArray(SC_TEXCOORD0);
 
         OGL_UpdateCullFace();
@@ -612,9 +687,39 @@ void OGL_DrawTriangles()
         OGL.renderState = RS_TRIANGLE;
     }
 
-    glDrawElements(GL_TRIANGLES, OGL.triangles.num, GL_UNSIGNED_BYTE, OGL.triangles.elements);
+    //Both buffers are filled front to back and orphaned when full, so what
+    //is written never overlaps what earlier draws may still be reading.
+    if (OGL.triangles.numCopies)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, OGL.stream.vertex * sizeof(GLStreamVertex),
+                OGL.triangles.numCopies * sizeof(GLStreamVertex), OGL.triangles.copies);
+        OGL.stream.vertex += OGL.triangles.numCopies;
+        OGL.stats.vertices += OGL.triangles.numCopies;
+        OGL.triangles.numCopies = 0;
+    }
+
+    if (OGL.stream.element + OGL.triangles.num > STREAM_ELEMENTS)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, STREAM_ELEMENTS * sizeof(GLushort), NULL, GL_STREAM_DRAW);
+        OGL.stream.element = 0;
+    }
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, OGL.stream.element * sizeof(GLushort),
+            OGL.triangles.num * sizeof(GLushort), OGL.triangles.elements);
+
+    glDrawElements(GL_TRIANGLES, OGL.triangles.num, GL_UNSIGNED_SHORT, (GLvoid*)(OGL.stream.element * sizeof(GLushort)));
+    OGL.stream.element += OGL.triangles.num;
+    OGL.stats.drawCalls++;
+    OGL.stats.triangles += OGL.triangles.num / 3;
     OGL.triangles.num = 0;
 
+    //the next batch must fit, even with no vertex shared
+    if (OGL.stream.vertex + ELEMBUFF_SIZE > STREAM_VERTICES)
+    {
+        glBufferData(GL_ARRAY_BUFFER, STREAM_VERTICES * sizeof(GLStreamVertex), NULL, GL_STREAM_DRAW);
+        OGL.stream.vertex = 0;
+        OGL_InvalidateVertices();
+    }
+
 #ifdef __TRIBUFFER_OPT
     __indexmap_clear();
 #endif
@@ -635,6 +740,8 @@ void OGL_DrawLine(int v0, int v1, float width )
         OGL_SetColorArray();
         glDisableVertexAttribArray(SC_TEXCOORD0);
         glDisableVertexAttribArray(SC_TEXCOORD1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glVertexAttribPointer(SC_POSITION, 4, GL_FLOAT, GL_FALSE, sizeof(SPVertex), &OGL.triangles.vertices[0].x);
         glVertexAttribPointer(SC_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(SPVertex), &OGL.triangles.vertices[0].r);
 
@@ -649,6 +756,7 @@ void OGL_DrawLine(int v0, int v1, float width )
     elem[1] = v1;
     glLineWidth( width * OGL.scaleX );
     glDrawElements(GL_LINES, 2, GL_UNSIGNED_SHORT, elem);
+    OGL.stats.drawCalls++;
 }
 
 void OGL_DrawRect( int ulx, int uly, int lrx, int lry, float *color)
@@ -672,6 +780,7 @@ void OGL_DrawRect( int ulx, int uly, int lrx, int lry, float *color)
     if (OGL.renderState != RS_RECT)
     {
         glVertexAttrib4f(SC_POSITION, 0, 0, gSP.viewport.nearz, 1.0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glVertexAttribPointer(SC_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(GLVertex), &OGL.rect[0].x);
         OGL.renderState = RS_RECT;
     }
@@ -691,6 +800,7 @@ void OGL_DrawRect( int ulx, int uly, int lrx, int lry, float *color)
 
     glVertexAttrib4fv(SC_COLOR, color);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    OGL.stats.drawCalls++;
     glEnable(GL_SCISSOR_TEST);
     OGL_UpdateViewport();
 
@@ -727,6 +837,7 @@ void OGL_DrawTexturedRect( float ulx, float uly, float lrx, float lry, float uls
     {
         glVertexAttrib4f(SC_COLOR, 0, 0, 0, 0);
         glVertexAttrib4f(SC_POSITION, 0, 0, (gDP.otherMode.depthSource == G_ZS_PRIM) ? gDP.primDepth.z : gSP.viewport.nearz, 1.0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
         glVertexAttribPointer(SC_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(GLVertex), &OGL.rect[0].x);
         glVertexAttribPointer(SC_TEXCOORD0, 2, GL_FLOAT, GL_FALSE, sizeof(GLVertex), &OGL.rect[0].s0);
         glVertexAttribPointer(SC_TEXCOORD1, 2, GL_FLOAT, GL_FALSE, sizeof(GLVertex), &OGL.rect[0].s1);
@@ -840,6 +951,7 @@ void OGL_DrawTexturedRect( float ulx, float uly, float lrx, float lry, float uls
     }
 
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    OGL.stats.drawCalls++;
     OGL_UpdateViewport();
 }
 
@@ -907,6 +1019,12 @@ void OGL_SwapBuffers()
     //OGL_DrawTriangles();
     scProgramChanged = 0;
 
+    LOG(LOG_VERBOSE, "[gles2n64]: %u draw calls, %u triangles, %u vertices uploaded, %u color and %u depth image switches\n",
+            OGL.stats.drawCalls, OGL.stats.triangles, OGL.stats.vertices, OGL.stats.colorImages, OGL.stats.depthImages);
+    memset(&OGL.stats, 0, sizeof(OGL.stats));
+
+    //the frontend runs in between and leaves no binding or pointer to rely on
+    OGL_ReleaseStream();
     retro_return(true);
 
     OGL.screenUpdate = false;
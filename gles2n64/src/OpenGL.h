@@ -46,7 +46,11 @@ extern "C" {
 
 #define INDEXMAP_SIZE 64
 #define VERTBUFF_SIZE 256
-#define ELEMBUFF_SIZE 1024
+#define ELEMBUFF_SIZE 6144
+
+//the stream buffers triangles are drawn from, GLushort indices reach all of it
+#define STREAM_VERTICES 65536
+#define STREAM_ELEMENTS (STREAM_VERTICES * 3)
 
 typedef struct
 {
@@ -58,13 +62,44 @@ typedef struct
     float s0, t0, s1, t1;
 } GLVertex;
 
+//what a triangle vertex needs on the GPU
+typedef struct
+{
+    float x, y, z, w;
+    float r, g, b, a;
+    float s, t;
+} GLStreamVertex;
+
 typedef struct triangles_t
 {
    SPVertex    vertices[VERTBUFF_SIZE];
-   GLubyte     elements[ELEMBUFF_SIZE];
+   GLushort    elements[ELEMBUFF_SIZE];
    int         num;
+
+   //vertices copied for the batch, and where each of vertices[] went in the
+   //stream while its stamp is the current one
+   GLStreamVertex  copies[ELEMBUFF_SIZE];
+   int             numCopies;
+   GLushort        streamIndex[VERTBUFF_SIZE];
+   u32             stamp[VERTBUFF_SIZE];
+   u32             currentStamp;
 } triangles_t;
 
+typedef struct
+{
+    GLuint  vbo, ibo;
+    int     vertex, element;    //next free in each
+} GLStream;
+
+typedef struct
+{
+    u32     drawCalls;
+    u32     vertices;           //uploaded to the stream
+    u32     triangles;
+    u32     colorImages;        //color image address changes
+    u32     depthImages;        //depth image address changes
+} GLStats;
+
 typedef struct
 {
     bool    screenUpdate;
@@ -78,6 +113,8 @@ typedef struct
 
 
     struct triangles_t triangles;
+    GLStream stream;
+    GLStats stats;
 
     unsigned int    renderState;
 
@@ -91,6 +128,8 @@ void OGL_Stop();
 
 void OGL_AddTriangle(int v0, int v1, int v2);
 void OGL_DrawTriangles();
+void OGL_InvalidateVertices();
+void OGL_ReleaseStream();
 void OGL_DrawTriangle(SPVertex *vertices, int v0, int v1, int v2);
 void OGL_DrawLine(int v0, int v1, float width);
 void OGL_DrawRect(int ulx, int uly, int lrx, int lry, float *color);
@@ -14,6 +14,7 @@
 #include "GBI.h"
 #include "gSP.h"
 #include "Textures.h"
+#include "Config.h"
 
 RSPInfo     RSP;
 
@@ -33,6 +34,11 @@ void RSP_LoadMatrix( f32 mtx[4][4], u32 address )
             mtx[i][j] = (GLfloat)(n64Mat->integer[i][j^1]) + (GLfloat)(n64Mat->fraction[i][j^1]) * recip;
 }
 
+//The display list is decoded and drawn here, on the emulator's coroutine.
+//In the libretro build that coroutine shares its OS thread with the frontend,
+//which owns the GL context and has no way to share it with another thread.
+//Moving the GL work to a second stage would therefore only delay it, not run
+//it alongside the r4300, so the list is processed in one pass.
 void RSP_ProcessDList()
 {
    int i, j;
@@ -101,10 +107,22 @@ void RSP_ProcessDList()
         RSP.cmd = _SHIFTR( w0, 24, 8 );
         RSP.PC[RSP.PCi] += 8;
 
+        //batched triangles are drawn before any command that may change the
+        //render state, and anything but a triangle may rewrite the vertices
+        if (!gSPTriangleCommand(RSP.cmd))
+        {
+            if (!gSPKeepsTriangles(RSP.cmd))
+                OGL_DrawTriangles();
+            OGL_InvalidateVertices();
+        }
+
         GBI.cmd[RSP.cmd]( w0, w1 );
 
     }
 
+    OGL_DrawTriangles();
+    OGL_ReleaseStream();
+
     RSP.busy = FALSE;
     RSP.DList++;
     gSP.changed |= CHANGED_COLORBUFFER;
@@ -1,10 +1,13 @@
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
+#include <limits.h>
 #include "OpenGL.h"
 #include "ShaderCombiner.h"
 #include "Common.h"
 #include "Textures.h"
 #include "Config.h"
+#include "m64p_config.h"
 
 
 //(sa - sb) * m + a
@@ -75,7 +78,15 @@ int ACEncodeB[] = {7, 7, 7, 7, 7, 7, 7, 7, 0, 1, 2, 3, 4, 5, 7, 7, 7, 7, 7, 6, 7
 int ACEncodeC[] = {7, 7, 7, 7, 7, 7, 7, 7, 0, 1, 2, 3, 4, 5, 7, 6, 7, 7, 7, 7, 7};
 int ACEncodeD[] = {7, 7, 7, 7, 7, 7, 7, 7, 0, 1, 2, 3, 4, 5, 7, 7, 7, 7, 7, 6, 7};
 
-ShaderProgram *scProgramRoot = NULL;
+//compiled programs, chained by (mux, flags) hash
+#define SC_HASH_SIZE    512
+static ShaderProgram *scProgramHash[SC_HASH_SIZE];
+
+//(mux, flags) pairs compiled in earlier runs of this rom, one per line
+#define SC_CACHE_VERSION    1
+#define SC_CACHE_MAX        2048
+static char scCacheFile[PATH_MAX];
+
 ShaderProgram *scProgramCurrent = NULL;
 int scProgramChanged = 0;
 int scProgramCount = 0;
@@ -233,10 +244,9 @@ const char * _alpha_param_str(int param)
     }
 }
 
-void *mux_new(u64 dmux, bool cycle2)
+void mux_decode(DecodedMux *mux, u64 dmux, bool cycle2)
 {
    int i, j;
-   DecodedMux *mux = malloc(sizeof(DecodedMux)); 
 
    mux->combine.mux = dmux;
    mux->flags = 0;
@@ -344,8 +354,6 @@ void *mux_new(u64 dmux, bool cycle2)
         }
 
     }
-
-    return mux;
 }
 
 bool mux_find(DecodedMux *dmux, int index, int src)
@@ -407,12 +415,18 @@ void mux_hack(DecodedMux *dmux)
 }
 
 
-int _program_compare(ShaderProgram *prog, DecodedMux *dmux, u32 flags)
+static inline u32 _program_hash(u64 mux, u32 flags)
 {
-    if (prog)
-        return ((prog->combine.mux == dmux->combine.mux) && (prog->flags == flags));
-    else
-        return 1;
+    u32 h = (u32)mux ^ (u32)(mux >> 32) * 0x9E3779B1 ^ flags;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6D;
+    h ^= h >> 12;
+    return h & (SC_HASH_SIZE - 1);
+}
+
+static inline int _program_compare(ShaderProgram *prog, u64 mux, u32 flags)
+{
+    return ((prog->combine.mux == mux) && (prog->flags == flags));
 }
 
 void _glcompiler_error(GLint shader)
@@ -584,6 +598,102 @@ void _update_uniforms()
     }
 };
 
+static ShaderProgram *_program_insert(u64 mux, u32 flags)
+{
+    DecodedMux dmux;
+    ShaderProgram *prog;
+    u32 h = _program_hash(mux, flags);
+
+    mux_decode(&dmux, mux, flags & SC_2CYCLE);
+    mux_hack(&dmux);
+
+    prog = ShaderCombiner_Compile(&dmux, flags);
+    prog->next = scProgramHash[h];
+    scProgramHash[h] = prog;
+    scProgramCount++;
+    return prog;
+}
+
+static ShaderProgram *_program_find(u64 mux, u32 flags)
+{
+    ShaderProgram *prog = scProgramHash[_program_hash(mux, flags)];
+    while (prog && !_program_compare(prog, mux, flags))
+        prog = prog->next;
+    return prog;
+}
+
+static void _cache_open()
+{
+    FILE *f;
+    char line[64], name[21];
+    int version = 0, n = 0, i;
+    unsigned long long mux;
+    unsigned int flags;
+
+    scCacheFile[0] = 0;
+    if (!config.shaderCache || !config.romName[0])
+        return;
+
+    //one file per rom, named after the header name
+    for (i = 0; config.romName[i]; i++)
+        name[i] = isalnum((unsigned char)config.romName[i]) ? config.romName[i] : '_';
+    name[i] = 0;
+    snprintf(scCacheFile, PATH_MAX, "%s/gles2n64_%s.shaders", ConfigGetUserCachePath(), name);
+
+    f = fopen(scCacheFile, "r");
+    if (f)
+    {
+        if (!fgets(line, sizeof(line), f) || sscanf(line, "gles2n64 shaders %d", &version) != 1 ||
+            version != SC_CACHE_VERSION)
+        {
+            fclose(f);
+            f = NULL;
+        }
+    }
+    if (!f)
+    {
+        //missing, or written by another version: start over
+        f = fopen(scCacheFile, "w");
+        if (f)
+        {
+            fprintf(f, "gles2n64 shaders %d\n", SC_CACHE_VERSION);
+            fclose(f);
+        }
+        else
+            scCacheFile[0] = 0;
+        return;
+    }
+
+    while (n < SC_CACHE_MAX && fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "%llx %x", &mux, &flags) != 2 || _program_find(mux, flags))
+            continue;
+        //fog needs the fog varying of the vertex shader
+        if ((flags & SC_FOGENABLED) && !config.enableFog)
+            continue;
+        _program_insert(mux, flags);
+        n++;
+    }
+    fclose(f);
+
+    LOG(LOG_VERBOSE, "[gles2n64]: Precompiled %i shaders from %s\n", n, scCacheFile);
+}
+
+static void _cache_append(u64 mux, u32 flags)
+{
+    FILE *f;
+
+    if (!scCacheFile[0] || scProgramCount > SC_CACHE_MAX)
+        return;
+
+    f = fopen(scCacheFile, "a");
+    if (f)
+    {
+        fprintf(f, "%016llx %x\n", (unsigned long long)mux, flags);
+        fclose(f);
+    }
+}
+
 void ShaderCombiner_Init()
 {
     //compile vertex shader:
@@ -613,27 +723,31 @@ void ShaderCombiner_Init()
     {
         _glcompiler_error(_vertex_shader);
     }
+
+    memset(scProgramHash, 0, sizeof(scProgramHash));
+    scProgramCount = scProgramChanged = 0;
+    scProgramCurrent = NULL;
+    _cache_open();
 };
 
-void ShaderCombiner_DeletePrograms(ShaderProgram *prog)
+void ShaderCombiner_Destroy()
 {
-    if (prog)
+    int i;
+    for (i = 0; i < SC_HASH_SIZE; i++)
     {
-        ShaderCombiner_DeletePrograms(prog->left);
-        ShaderCombiner_DeletePrograms(prog->right);
-        glDeleteProgram(prog->program);
-        //glDeleteShader(prog->fragment);
-        free(prog);
-        scProgramCount--;
+        ShaderProgram *prog = scProgramHash[i];
+        while (prog)
+        {
+            ShaderProgram *next = prog->next;
+            glDeleteProgram(prog->program);
+            free(prog);
+            prog = next;
+        }
+        scProgramHash[i] = NULL;
     }
-}
-
-void ShaderCombiner_Destroy()
-{
-    ShaderCombiner_DeletePrograms(scProgramRoot);
     glDeleteShader(_vertex_shader);
     scProgramCount = scProgramChanged = 0;
-    scProgramRoot = scProgramCurrent = NULL;
+    scProgramCurrent = NULL;
 }
 
 void ShaderCombiner_Set(u64 mux, int flags)
@@ -668,54 +782,26 @@ void ShaderCombiner_Set(u64 mux, int flags)
     }
 
 
-    DecodedMux *dmux;
-    dmux = mux_new(mux, flags&SC_2CYCLE);
-    mux_hack(mux);
-
     //if already bound:
-    if (scProgramCurrent)
+    if (scProgramCurrent && _program_compare(scProgramCurrent, mux, flags))
     {
-        if (_program_compare(scProgramCurrent, dmux, flags))
-        {
-            scProgramChanged = 0;
-            return;
-        }
+        scProgramChanged = 0;
+        return;
     }
 
-    //traverse binary tree for cached programs
+    //look up cached programs, build a new one on a miss
     scProgramChanged = 1;
-    ShaderProgram *root = scProgramRoot;
-    ShaderProgram *prog = root;
-    while(!_program_compare(prog, dmux, flags))
-    {
-        root = prog;
-        if (prog->combine.mux < dmux->combine.mux)
-            prog = prog->right;
-        else
-            prog = prog->left;
-    }
-
-    //build new program
+    ShaderProgram *prog = _program_find(mux, flags);
     if (!prog)
     {
-        scProgramCount++;
-        prog = ShaderCombiner_Compile(dmux, flags);
-        if (!root)
-            scProgramRoot = prog;
-        else if (root->combine.mux < dmux->combine.mux)
-            root->right = prog;
-        else
-            root->left = prog;
-
+        prog = _program_insert(mux, flags);
+        _cache_append(mux, flags);
     }
 
     prog->lastUsed = OGL.frame_dl;
     scProgramCurrent = prog;
     glUseProgram(prog->program);
     _force_uniforms();
-
-    if (dmux)
-       free(dmux);
 }
 
 ShaderProgram *ShaderCombiner_Compile(DecodedMux *dmux, int flags)
@@ -726,7 +812,7 @@ ShaderProgram *ShaderCombiner_Compile(DecodedMux *dmux, int flags)
     char *buffer = frag;
     ShaderProgram *prog = (ShaderProgram*) malloc(sizeof(ShaderProgram));
 
-    prog->left = prog->right = NULL;
+    prog->next = NULL;
     prog->usesT0 = prog->usesT1 = prog->usesCol = prog->usesNoise = 0;
     prog->combine = dmux->combine;
     prog->flags = flags;
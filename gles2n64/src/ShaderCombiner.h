@@ -176,7 +176,7 @@ typedef struct ShaderProgram
     UniformLocation uniforms;
     gDPCombine      combine;
     u32             flags;
-    struct ShaderProgram   *left, *right;
+    struct ShaderProgram   *next;   //hash chain
     u32             lastUsed;
 } ShaderProgram;
 
@@ -194,7 +194,7 @@ typedef struct
    int flags;
 } DecodedMux;
 
-void *mux_new(u64 mux, bool cycle2);
+void mux_decode(DecodedMux *dmux, u64 mux, bool cycle2);
 void mux_hack(DecodedMux *mux);
 bool mux_find(DecodedMux *mux, int index, int src);
 bool mux_swap(DecodedMux *mux, int cycle, int src0, int src1);
@@ -209,7 +209,6 @@ extern int ACEncodeB[];
 extern int ACEncodeC[];
 extern int ACEncodeD[];
 
-extern ShaderProgram    *scProgramRoot;
 extern ShaderProgram    *scProgramCurrent;
 extern int              scProgramChanged;
 extern int              scProgramCount;
@@ -13,6 +13,7 @@
 #include "N64.h"
 #include "CRC.h"
 #include "convert.h"
+#include "texdecode.h"
 //#include "FrameBuffer.h"
 
 #define FORMAT_NONE     0
@@ -24,255 +25,84 @@
 
 TextureCache    cache;
 
-typedef u32 (*GetTexelFunc)( void *src, u16 x, u16 i, u8 palette );
-
-u32 GetNone( void *src, u16 x, u16 i, u8 palette )
-{
-    return 0x00000000;
-}
-
-u32 GetCI4IA_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    if (x & 1)
-        return IA88_RGBA4444( *(u16*)&TMEM[256 + (palette << 4) + (color4B & 0x0F)] );
-    else
-        return IA88_RGBA4444( *(u16*)&TMEM[256 + (palette << 4) + (color4B >> 4)] );
-}
-
-u32 GetCI4IA_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    if (x & 1)
-        return IA88_RGBA8888( *(u16*)&TMEM[256 + (palette << 4) + (color4B & 0x0F)] );
-    else
-        return IA88_RGBA8888( *(u16*)&TMEM[256 + (palette << 4) + (color4B >> 4)] );
-}
-
-u32 GetCI4RGBA_RGBA5551( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    if (x & 1)
-        return RGBA5551_RGBA5551( *(u16*)&TMEM[256 + (palette << 4) + (color4B & 0x0F)] );
-    else
-        return RGBA5551_RGBA5551( *(u16*)&TMEM[256 + (palette << 4) + (color4B >> 4)] );
-}
-
-u32 GetCI4RGBA_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    if (x & 1)
-        return RGBA5551_RGBA8888( *(u16*)&TMEM[256 + (palette << 4) + (color4B & 0x0F)] );
-    else
-        return RGBA5551_RGBA8888( *(u16*)&TMEM[256 + (palette << 4) + (color4B >> 4)] );
-}
-
-u32 GetIA31_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return IA31_RGBA8888( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-u32 GetIA31_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return IA31_RGBA4444( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-u32 GetIA31_IA88( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return IA31_IA88( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-u32 GetI4_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return I4_RGBA8888( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-u32 GetI4_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return I4_RGBA4444( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-u32 GetI4_I8( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return I4_I8( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-
-u32 GetI4_IA88( void *src, u16 x, u16 i, u8 palette )
-{
-    u8 color4B = ((u8*)src)[(x>>1)^(i<<1)];
-    return I4_IA88( (x & 1) ? (color4B & 0x0F) : (color4B >> 4) );
-}
-
-u32 GetCI8IA_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA88_RGBA4444( *(u16*)&TMEM[256 + ((u8*)src)[x^(i<<1)]] );
-}
-
-u32 GetCI8IA_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA88_RGBA8888( *(u16*)&TMEM[256 + ((u8*)src)[x^(i<<1)]] );
-}
-
-u32 GetCI8RGBA_RGBA5551( void *src, u16 x, u16 i, u8 palette )
-{
-    return RGBA5551_RGBA5551( *(u16*)&TMEM[256 + ((u8*)src)[x^(i<<1)]] );
-}
-
-u32 GetCI8RGBA_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return RGBA5551_RGBA8888( *(u16*)&TMEM[256 + ((u8*)src)[x^(i<<1)]] );
-}
-
-u32 GetIA44_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA44_RGBA8888(((u8*)src)[x^(i<<1)]);
-}
-
-u32 GetIA44_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA44_RGBA4444(((u8*)src)[x^(i<<1)]);
-}
-
-u32 GetIA44_IA88( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA44_IA88(((u8*)src)[x^(i<<1)]);
-}
-
-u32 GetI8_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return I8_RGBA8888(((u8*)src)[x^(i<<1)]);
-}
-
-u32 GetI8_I8( void *src, u16 x, u16 i, u8 palette )
-{
-    return ((u8*)src)[x^(i<<1)];
-}
-
-u32 GetI8_IA88( void *src, u16 x, u16 i, u8 palette )
-{
-    return I8_IA88(((u8*)src)[x^(i<<1)]);
-}
-
-u32 GetI8_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    return I8_RGBA4444(((u8*)src)[x^(i<<1)]);
-}
-
-u32 GetRGBA5551_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return RGBA5551_RGBA8888( ((u16*)src)[x^i] );
-}
-
-u32 GetRGBA5551_RGBA5551( void *src, u16 x, u16 i, u8 palette )
-{
-    return RGBA5551_RGBA5551( ((u16*)src)[x^i] );
-}
-
-u32 GetIA88_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA88_RGBA8888(((u16*)src)[x^i]);
-}
-
-u32 GetIA88_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA88_RGBA4444(((u16*)src)[x^i]);
-}
-
-u32 GetIA88_IA88( void *src, u16 x, u16 i, u8 palette )
-{
-    return IA88_IA88(((u16*)src)[x^i]);
-}
-
-u32 GetRGBA8888_RGBA8888( void *src, u16 x, u16 i, u8 palette )
-{
-    return ((u32*)src)[x^i];
-}
-
-u32 GetRGBA8888_RGBA4444( void *src, u16 x, u16 i, u8 palette )
-{
-    return RGBA8888_RGBA4444(((u32*)src)[x^i]);
-}
-
-
 typedef struct
 {
     int format;
-    GetTexelFunc getTexel;
+    int decode, tlut;
     int lineShift, maxTexels;
 } TextureFormat;
 
+#define NO_DECODE   -1
 
 TextureFormat textureFormatIA[4*6] =
 {
     // 4-bit
-    {   FORMAT_RGBA5551,    GetCI4RGBA_RGBA5551,    4,  4096 }, // RGBA (SELECT)
-    {   FORMAT_NONE,        GetNone,                4,  8192 }, // YUV
-    {   FORMAT_RGBA5551,    GetCI4RGBA_RGBA5551,    4,  4096 }, // CI
-    {   FORMAT_IA88,        GetIA31_IA88,           4,  8192 }, // IA
-    {   FORMAT_IA88,        GetI4_IA88,             4,  8192 }, // I
-    {   FORMAT_RGBA8888,    GetCI4IA_RGBA8888,      4,  4096 }, // IA Palette
+    {   FORMAT_RGBA5551,    TEXDEC_CI4,     TEXDEC_TLUT_RGBA16, 4,  4096 }, // RGBA (SELECT)
+    {   FORMAT_NONE,        NO_DECODE,      0,                  4,  8192 }, // YUV
+    {   FORMAT_RGBA5551,    TEXDEC_CI4,     TEXDEC_TLUT_RGBA16, 4,  4096 }, // CI
+    {   FORMAT_IA88,        TEXDEC_IA4,     0,                  4,  8192 }, // IA
+    {   FORMAT_IA88,        TEXDEC_I4,      0,                  4,  8192 }, // I
+    {   FORMAT_RGBA8888,    TEXDEC_CI4,     TEXDEC_TLUT_IA16,   4,  4096 }, // IA Palette
     // 8-bit
-    {   FORMAT_RGBA5551,    GetCI8RGBA_RGBA5551,    3,  2048 }, // RGBA (SELECT)
-    {   FORMAT_NONE,        GetNone,                3,  4096 }, // YUV
-    {   FORMAT_RGBA5551,    GetCI8RGBA_RGBA5551,    3,  2048 }, // CI
-    {   FORMAT_IA88,        GetIA44_IA88,           3,  4096 }, // IA
-    {   FORMAT_IA88,        GetI8_IA88,             3,  4096 }, // I
-    {   FORMAT_RGBA8888,    GetCI8IA_RGBA8888,      3,  2048 }, // IA Palette
+    {   FORMAT_RGBA5551,    TEXDEC_CI8,     TEXDEC_TLUT_RGBA16, 3,  2048 }, // RGBA (SELECT)
+    {   FORMAT_NONE,        NO_DECODE,      0,                  3,  4096 }, // YUV
+    {   FORMAT_RGBA5551,    TEXDEC_CI8,     TEXDEC_TLUT_RGBA16, 3,  2048 }, // CI
+    {   FORMAT_IA88,        TEXDEC_IA8,     0,                  3,  4096 }, // IA
+    {   FORMAT_IA88,        TEXDEC_I8,      0,                  3,  4096 }, // I
+    {   FORMAT_RGBA8888,    TEXDEC_CI8,     TEXDEC_TLUT_IA16,   3,  2048 }, // IA Palette
     // 16-bit
-    {   FORMAT_RGBA5551,    GetRGBA5551_RGBA5551,   2,  2048 }, // RGBA
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // YUV
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // CI
-    {   FORMAT_IA88,        GetIA88_IA88,           2,  2048 }, // IA
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // I
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // IA Palette
+    {   FORMAT_RGBA5551,    TEXDEC_RGBA16,  0,                  2,  2048 }, // RGBA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // YUV
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // CI
+    {   FORMAT_IA88,        TEXDEC_IA16,    0,                  2,  2048 }, // IA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // I
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // IA Palette
     // 32-bit
-    {   FORMAT_RGBA8888,    GetRGBA8888_RGBA8888,   2,  1024 }, // RGBA
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // YUV
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // CI
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // IA
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // I
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // IA Palette
+    {   FORMAT_RGBA8888,    TEXDEC_RGBA32,  0,                  2,  1024 }, // RGBA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // YUV
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // CI
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // IA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // I
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // IA Palette
 };
 
 TextureFormat textureFormatRGBA[4*6] =
 {
     // 4-bit
-    {   FORMAT_RGBA5551,    GetCI4RGBA_RGBA5551,    4,  4096 }, // RGBA (SELECT)
-    {   FORMAT_NONE,        GetNone,                4,  8192 }, // YUV
-    {   FORMAT_RGBA5551,    GetCI4RGBA_RGBA5551,    4,  4096 }, // CI
-    {   FORMAT_RGBA4444,    GetIA31_RGBA4444,       4,  8192 }, // IA
-    {   FORMAT_RGBA4444,    GetI4_RGBA4444,         4,  8192 }, // I
-    {   FORMAT_RGBA8888,    GetCI4IA_RGBA8888,      4,  4096 }, // IA Palette
+    {   FORMAT_RGBA5551,    TEXDEC_CI4,     TEXDEC_TLUT_RGBA16, 4,  4096 }, // RGBA (SELECT)
+    {   FORMAT_NONE,        NO_DECODE,      0,                  4,  8192 }, // YUV
+    {   FORMAT_RGBA5551,    TEXDEC_CI4,     TEXDEC_TLUT_RGBA16, 4,  4096 }, // CI
+    {   FORMAT_RGBA4444,    TEXDEC_IA4,     0,                  4,  8192 }, // IA
+    {   FORMAT_RGBA4444,    TEXDEC_I4,      0,                  4,  8192 }, // I
+    {   FORMAT_RGBA8888,    TEXDEC_CI4,     TEXDEC_TLUT_IA16,   4,  4096 }, // IA Palette
     // 8-bit
-    {   FORMAT_RGBA5551,    GetCI8RGBA_RGBA5551,    3,  2048 }, // RGBA (SELECT)
-    {   FORMAT_NONE,        GetNone,                3,  4096 }, // YUV
-    {   FORMAT_RGBA5551,    GetCI8RGBA_RGBA5551,    3,  2048 }, // CI
-    {   FORMAT_RGBA4444,    GetIA44_RGBA4444,       3,  4096 }, // IA
-    {   FORMAT_RGBA8888,    GetI8_RGBA8888,         3,  4096 }, // I
-    {   FORMAT_RGBA8888,    GetCI8IA_RGBA8888,      3,  2048 }, // IA Palette
+    {   FORMAT_RGBA5551,    TEXDEC_CI8,     TEXDEC_TLUT_RGBA16, 3,  2048 }, // RGBA (SELECT)
+    {   FORMAT_NONE,        NO_DECODE,      0,                  3,  4096 }, // YUV
+    {   FORMAT_RGBA5551,    TEXDEC_CI8,     TEXDEC_TLUT_RGBA16, 3,  2048 }, // CI
+    {   FORMAT_RGBA4444,    TEXDEC_IA8,     0,                  3,  4096 }, // IA
+    {   FORMAT_RGBA8888,    TEXDEC_I8,      0,                  3,  4096 }, // I
+    {   FORMAT_RGBA8888,    TEXDEC_CI8,     TEXDEC_TLUT_IA16,   3,  2048 }, // IA Palette
     // 16-bit
-    {   FORMAT_RGBA5551,    GetRGBA5551_RGBA5551,   2,  2048 }, // RGBA
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // YUV
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // CI
-    {   FORMAT_RGBA8888,    GetIA88_RGBA8888,       2,  2048 }, // IA
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // I
-    {   FORMAT_NONE,        GetNone,                2,  2048 }, // IA Palette
+    {   FORMAT_RGBA5551,    TEXDEC_RGBA16,  0,                  2,  2048 }, // RGBA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // YUV
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // CI
+    {   FORMAT_RGBA8888,    TEXDEC_IA16,    0,                  2,  2048 }, // IA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // I
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  2048 }, // IA Palette
     // 32-bit
-    {   FORMAT_RGBA8888,    GetRGBA8888_RGBA8888,   2,  1024 }, // RGBA
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // YUV
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // CI
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // IA
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // I
-    {   FORMAT_NONE,        GetNone,                2,  1024 }, // IA Palette
+    {   FORMAT_RGBA8888,    TEXDEC_RGBA32,  0,                  2,  1024 }, // RGBA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // YUV
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // CI
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // IA
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // I
+    {   FORMAT_NONE,        NO_DECODE,      0,                  2,  1024 }, // IA Palette
 };
 
+// texdecode output of each FORMAT_*
+static const int textureOutput[6] =
+{
+    TEXDEC_OUT_RGBA8888, TEXDEC_OUT_I8, TEXDEC_OUT_IA88, TEXDEC_OUT_RGBA4444, TEXDEC_OUT_RGBA5551, TEXDEC_OUT_RGBA8888
+};
 
 TextureFormat *textureFormat = textureFormatIA;
 
@@ -348,6 +178,22 @@ void __texture_format(int size, int format, TextureFormat *texFormat)
     }
 }
 
+// Palette of a CI texture from TMEM, where each entry is a swapped u16 per
+// 64-bit word
+static void __texture_palette(const TextureFormat *texFormat, CachedTexture *texInfo, u32 *lut)
+{
+    u16 tlut[256];
+    int i, count, base;
+
+    if (texFormat->decode != TEXDEC_CI4 && texFormat->decode != TEXDEC_CI8)
+        return;
+
+    count = (texFormat->decode == TEXDEC_CI4) ? 16 : 256;
+    base = (texFormat->decode == TEXDEC_CI4) ? (texInfo->palette << 4) : 0;
+    for (i = 0; i < count; i++)
+        tlut[i] = swapword( *(u16*)&TMEM[256 + base + i] );
+    texdec_palette(lut, tlut, count, texFormat->tlut);
+}
 
 int isTexCacheInit = 0;
 
@@ -566,15 +412,14 @@ void TextureCache_Destroy()
 
 void TextureCache_LoadBackground( CachedTexture *texInfo )
 {
-    u32 *dest, *scaledDest;
-    u8 *swapped, *src;
-    u32 numBytes, bpl;
-    u32 x, y, j, tx, ty;
-    u16 clampSClamp,  clampTClamp;
+    u8 *dest, *row;
+    u32 bpl, texel, width;
+    u32 x, y, ty;
+    u16 clampTClamp;
+    u32 lut[256];
 
     int bytePerPixel=0;
     TextureFormat   texFormat;
-    GetTexelFunc    getTexel;
     GLint glWidth=0, glHeight=0;
     GLenum glType=0;
     GLenum glFormat=0;
@@ -618,45 +463,35 @@ void TextureCache_LoadBackground( CachedTexture *texInfo )
     glWidth = texInfo->realWidth;
     glHeight = texInfo->realHeight;
     texInfo->textureBytes = (glWidth * glHeight) * bytePerPixel;
-    getTexel = texFormat.getTexel;
 
     bpl = gSP.bgImage.width << gSP.bgImage.size >> 1;
-    numBytes = bpl * gSP.bgImage.height;
-    swapped = (u8*) malloc(numBytes);
-    dest = (u32*) malloc(texInfo->textureBytes);
+    dest = (u8*) malloc(texInfo->textureBytes);
 
-    if (!dest || !swapped)
+    if (!dest)
     {
         LOG(LOG_ERROR, "Malloc failed!\n");
         return;
     }
 
-    UnswapCopy(&RDRAM[gSP.bgImage.address], swapped, numBytes);
+    __texture_palette(&texFormat, texInfo, lut);
 
-    clampSClamp = texInfo->width - 1;
+    // decoded straight from RDRAM, columns past the width repeat the last one
+    width = min(texInfo->width, texInfo->realWidth);
     clampTClamp = texInfo->height - 1;
 
-    j = 0;
-    for (y = 0; y < texInfo->realHeight; y++)
+    for (y = 0; y < texInfo->realHeight && texFormat.decode != NO_DECODE && width; y++)
     {
         ty = min(y, clampTClamp);
-        src = &swapped[bpl * ty];
-        for (x = 0; x < texInfo->realWidth; x++)
-        {
-            tx = min(x, clampSClamp);
-            if (bytePerPixel == 4)
-                ((u32*)dest)[j++] = getTexel(src, tx, 0, texInfo->palette);
-            else if (bytePerPixel == 2)
-                ((u16*)dest)[j++] = getTexel(src, tx, 0, texInfo->palette);
-            else if (bytePerPixel == 1)
-                ((u8*)dest)[j++] = getTexel(src, tx, 0, texInfo->palette);
-        }
+        row = dest + y * texInfo->realWidth * bytePerPixel;
+        texel = ((gSP.bgImage.address + bpl * ty) << 1) >> gSP.bgImage.size;
+        texdec_row(row, textureOutput[texFormat.format], texFormat.decode, RDRAM, texel, TEXDEC_XOR_HOST, width, lut);
+        for (x = width; x < texInfo->realWidth; x++)
+            memcpy(row + x * bytePerPixel, row + (width - 1) * bytePerPixel, bytePerPixel);
     }
 
     glTexImage2D( GL_TEXTURE_2D, 0, glFormat, glWidth, glHeight, 0, glFormat, glType, dest);
 
     free(dest);
-    free(swapped);
 
 
     if (config.texture.enableMipmap)
@@ -665,16 +500,18 @@ void TextureCache_LoadBackground( CachedTexture *texInfo )
 
 void TextureCache_Load( CachedTexture *texInfo )
 {
-    u32 *dest, *scaledDest;
+    u8 *dest, *row, *decoded;
 
     void *src;
-    u16 x, y, i, j, tx, ty, line;
+    u16 x, y, tx, ty, line, maxTX;
     u16 mirrorSBit, maskSMask, clampSClamp;
     u16 mirrorTBit, maskTMask, clampTClamp;
+    u16 *columns;
+    u32 lut[256];
+    int identity;
 
     int bytePerPixel=0;
     TextureFormat   texFormat;
-    GetTexelFunc    getTexel;
     GLint glWidth=0, glHeight=0;
     GLenum glType=0;
     GLenum glFormat=0;
@@ -718,13 +555,15 @@ void TextureCache_Load( CachedTexture *texInfo )
     glWidth = texInfo->realWidth;
     glHeight = texInfo->realHeight;
     texInfo->textureBytes = (glWidth * glHeight) * bytePerPixel;
-    getTexel = texFormat.getTexel;
 
-    dest = (u32*)malloc(texInfo->textureBytes);
+    dest = (u8*)malloc(texInfo->textureBytes);
+    columns = (u16*)malloc(texInfo->realWidth * sizeof(u16));
 
-    if (!dest)
+    if (!dest || !columns)
     {
         LOG(LOG_ERROR, "Malloc failed!\n");
+        free(dest);
+        free(columns);
         return;
     }
 
@@ -770,38 +609,59 @@ void TextureCache_Load( CachedTexture *texInfo )
     if (clampTClamp & 0x8000) clampTClamp = 0;
     if (clampSClamp & 0x8000) clampSClamp = 0;
 
-    j = 0;
-    for (y = 0; y < texInfo->realHeight; y++)
+    // the S clamp/mask/mirror is the same for every row, each row is decoded
+    // once up to the last texel used and then gathered, or decoded in place
+    // when the columns map to themselves
+    maxTX = 0;
+    identity = 1;
+    for (x = 0; x < texInfo->realWidth; x++)
     {
+        tx = min(x, clampSClamp) & maskSMask;
+        if (x & mirrorSBit) tx ^= maskSMask;
+        columns[x] = tx;
+        if (tx > maxTX) maxTX = tx;
+        if (tx != x) identity = 0;
+    }
+
+    decoded = identity ? NULL : (u8*)malloc((maxTX + 1) * bytePerPixel);
+    if (!identity && !decoded)
+        texFormat.decode = NO_DECODE;
+    __texture_palette(&texFormat, texInfo, lut);
+
+    for (y = 0; y < texInfo->realHeight && texFormat.decode != NO_DECODE; y++)
+    {
+        // odd lines have their 32-bit words (64-bit for 32-bit texels) swapped
+        u32 lineXor;
+
         ty = min(y, clampTClamp) & maskTMask;
         if (y & mirrorTBit) ty ^= maskTMask;
         src = &TMEM[(texInfo->tMem + line * ty) & 511];
-        i = (ty & 1) << 1;
-        for (x = 0; x < texInfo->realWidth; x++)
-        {
-            tx = min(x, clampSClamp) & maskSMask;
+        row = dest + y * texInfo->realWidth * bytePerPixel;
+        lineXor = (ty & 1) ? (texInfo->size == G_IM_SIZ_32b ? 8 : 4) : 0;
 
-            if (x & mirrorSBit) tx ^= maskSMask;
-
-            if (bytePerPixel == 4)
-            {
-                ((u32*)dest)[j] = getTexel(src, tx, i, texInfo->palette);
-            }
-            else if (bytePerPixel == 2)
-            {
-                ((u16*)dest)[j] = getTexel(src, tx, i, texInfo->palette);
-            }
-            else if (bytePerPixel == 1)
-            {
-                ((u8*)dest)[j] = getTexel(src, tx, i, texInfo->palette);
-            }
-            j++;
+        if (identity)
+        {
+            texdec_row(row, textureOutput[texFormat.format], texFormat.decode, src, 0, lineXor, texInfo->realWidth, lut);
+            continue;
         }
+
+        texdec_row(decoded, textureOutput[texFormat.format], texFormat.decode, src, 0, lineXor, maxTX + 1, lut);
+        if (bytePerPixel == 4)
+            for (x = 0; x < texInfo->realWidth; x++)
+                ((u32*)row)[x] = ((u32*)decoded)[columns[x]];
+        else if (bytePerPixel == 2)
+            for (x = 0; x < texInfo->realWidth; x++)
+                ((u16*)row)[x] = ((u16*)decoded)[columns[x]];
+        else
+            for (x = 0; x < texInfo->realWidth; x++)
+                row[x] = decoded[columns[x]];
     }
 
     glTexImage2D( GL_TEXTURE_2D, 0, glFormat, glWidth, glHeight, 0, glFormat, glType, dest);
 
     free(dest);
+    free(decoded);
+    free(columns);
 
     if (config.texture.enableMipmap)
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -823,13 +683,7 @@ u32 TextureCache_CalculateCRC( u32 t, u32 width, u32 height )
 
     crc = 0xFFFFFFFF;
 
-#ifdef __CRC_OPT
-    unsigned n = (config.texture.fastCRC) ? MAX(1, height / 8) : 1;
-#else
-    unsigned n = 1;
-#endif
-
-    for (y = 0; y < height; y += n)
+    for (y = 0; y < height; y++)
     {
         src = (void*) &TMEM[(gSP.textureTile[t]->tmem + (y * line)) & 511];
         crc = CRC_Calculate( crc, src, bpl );
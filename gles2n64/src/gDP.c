@@ -366,6 +366,7 @@ void gDPSetColorImage( u32 format, u32 size, u32 width, u32 address )
 
     if (gDP.colorImage.address != addr)
     {
+        OGL.stats.colorImages++;
         gDP.colorImage.changed = FALSE;
         if (width == VI.width)
             gDP.colorImage.height = VI.height;
@@ -463,6 +464,8 @@ void gDPSetDepthImage( u32 address )
 //      OGL_ClearDepthBuffer();
 
     u32 addr = RSP_SegmentToPhysical(address);
+    if (addr != gDP.depthImageAddress)
+        OGL.stats.depthImages++;
     DepthBuffer_SetBuffer(addr);
 
     if (depthBuffer.current->cleared)
@@ -983,6 +983,10 @@ void gSPDMATriangles( u32 tris, u32 n )
     for (i = 0; i < n; i++)
     {
         int mode = 0;
+
+        //the texture coordinates below are per triangle
+        OGL_InvalidateVertices();
+
         if (!(triangles->flag & 0x40))
         {
             if (gSP.viewport.vscale[0] > 0)
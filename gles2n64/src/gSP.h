@@ -13,34 +13,29 @@
 #define CHANGED_FOGPOSITION     0x20
 #define CHANGED_TEXTURESCALE    0x40
 
-#define gSPFlushTriangles() \
-if \
+//commands that only draw triangles from the vertices already loaded
+#define gSPTriangleCommand(cmd) \
+    (((cmd) == G_TRI1) || ((cmd) == G_TRI2) || ((cmd) == G_TRI4) || ((cmd) == G_QUAD))
+
+//Commands the triangle batch is kept across. With tribufferOpt these include
+//the ones loading vertices or matrices and walking the display lists, none
+//of them changes the render state and the batch holds copies of its vertices.
+#define gSPKeepsTriangles(cmd) \
 ( \
+    gSPTriangleCommand(cmd) || \
     ( \
-         (config.tribufferOpt) && \
-         (OGL.triangles.num > 1000) || \
-         ( \
-             (RSP.nextCmd != G_NOOP) && \
-             (RSP.nextCmd != G_RDPNOOP) && \
-             (RSP.nextCmd != G_MOVEMEM) && \
-             (RSP.nextCmd != G_ENDDL) && \
-             (RSP.nextCmd != G_DL) && \
-             (RSP.nextCmd != G_VTXCOLORBASE) && \
-             (RSP.nextCmd != G_TRI1) && \
-             (RSP.nextCmd != G_TRI2) && \
-             (RSP.nextCmd != G_TRI4) && \
-             (RSP.nextCmd != G_QUAD) && \
-             (RSP.nextCmd != G_VTX) && \
-             (RSP.nextCmd != G_MTX) \
-         ) \
-    ) || \
-    ( \
-        (RSP.nextCmd != G_TRI1) && \
-        (RSP.nextCmd != G_TRI2) && \
-        (RSP.nextCmd != G_TRI4) && \
-        (RSP.nextCmd != G_QUAD) \
+        (config.tribufferOpt) && \
+        ( \
+            ((cmd) == G_NOOP) || ((cmd) == G_RDPNOOP) || ((cmd) == G_SPNOOP) || \
+            ((cmd) == G_VTX) || ((cmd) == G_MODIFYVTX) || ((cmd) == G_VTXCOLORBASE) || \
+            ((cmd) == G_MTX) || ((cmd) == G_POPMTX) || \
+            ((cmd) == G_DL) || ((cmd) == G_ENDDL) || ((cmd) == G_CULLDL) || ((cmd) == G_BRANCH_Z) \
+        ) \
     ) \
-) \
+)
+
+#define gSPFlushTriangles() \
+if (!gSPKeepsTriangles(RSP.nextCmd)) \
 { \
     OGL_DrawTriangles(); \
 }
@@ -216,6 +211,9 @@ extern void (*gSPBillboardVertex)(u32 v, u32 i);
 #ifdef __NEON_OPT
 void gSPInitNeon();
 #endif
+#if !defined(NOSSE)
+void gSPInitSSE();
+#endif
 
 #endif
 
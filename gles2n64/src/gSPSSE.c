@@ -0,0 +1,171 @@
+#include "gSP.h"
+#include "OpenGL.h"
+#include "3DMath.h"
+
+#if !defined(NOSSE)
+#include <emmintrin.h>
+
+//Products are summed in the order of the scalar versions in gSP.c and
+//normals are divided by their length like there, so SSE scalar math (x86-64)
+//gives the same results to the bit.
+
+#define LOAD_ROW(m, i)  _mm_loadu_ps(m[i])
+
+static INLINE __m128 _transform(__m128 m0, __m128 m1, __m128 m2, __m128 m3, const float *v)
+{
+    __m128 r = _mm_mul_ps(_mm_set1_ps(v[0]), m0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[1]), m1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(v[2]), m2));
+    return _mm_add_ps(r, m3);
+}
+
+static INLINE __m128 _transform3(__m128 m0, __m128 m1, __m128 m2, const float *v)
+{
+    __m128 r = _mm_mul_ps(m0, _mm_set1_ps(v[0]));
+    r = _mm_add_ps(r, _mm_mul_ps(m1, _mm_set1_ps(v[1])));
+    return _mm_add_ps(r, _mm_mul_ps(m2, _mm_set1_ps(v[2])));
+}
+
+//length of (x, y, z), or 1 where it is 0
+static INLINE __m128 _length(__m128 x, __m128 y, __m128 z)
+{
+    __m128 len = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+    __m128 zero = _mm_cmpeq_ps(len, _mm_setzero_ps());
+    return _mm_or_ps(_mm_andnot_ps(zero, _mm_sqrt_ps(len)), _mm_and_ps(zero, _mm_set1_ps(1.0f)));
+}
+
+//ambient plus every light, for the unit normals (x, y, z) of 4 vertices
+static INLINE void _light4(__m128 x, __m128 y, __m128 z, __m128 *r, __m128 *g, __m128 *b)
+{
+    int i;
+    __m128 zero = _mm_setzero_ps();
+    *r = _mm_set1_ps(gSP.lights[gSP.numLights].r);
+    *g = _mm_set1_ps(gSP.lights[gSP.numLights].g);
+    *b = _mm_set1_ps(gSP.lights[gSP.numLights].b);
+    for (i = 0; i < gSP.numLights; i++)
+    {
+        SPLight *l = &gSP.lights[i];
+        __m128 intensity = _mm_mul_ps(x, _mm_set1_ps(l->x));
+        intensity = _mm_add_ps(intensity, _mm_mul_ps(y, _mm_set1_ps(l->y)));
+        intensity = _mm_add_ps(intensity, _mm_mul_ps(z, _mm_set1_ps(l->z)));
+        intensity = _mm_max_ps(intensity, zero);
+        *r = _mm_add_ps(*r, _mm_mul_ps(_mm_set1_ps(l->r), intensity));
+        *g = _mm_add_ps(*g, _mm_mul_ps(_mm_set1_ps(l->g), intensity));
+        *b = _mm_add_ps(*b, _mm_mul_ps(_mm_set1_ps(l->b), intensity));
+    }
+    *r = _mm_min_ps(*r, _mm_set1_ps(1.0f));
+    *g = _mm_min_ps(*g, _mm_set1_ps(1.0f));
+    *b = _mm_min_ps(*b, _mm_set1_ps(1.0f));
+}
+
+#ifdef __VEC4_OPT
+static void gSPTransformVertex4SSE(u32 v, float mtx[4][4])
+{
+    __m128 m0 = LOAD_ROW(mtx, 0), m1 = LOAD_ROW(mtx, 1);
+    __m128 m2 = LOAD_ROW(mtx, 2), m3 = LOAD_ROW(mtx, 3);
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+
+    _mm_storeu_ps(&vtx[0].x, _transform(m0, m1, m2, m3, &vtx[0].x));
+    _mm_storeu_ps(&vtx[1].x, _transform(m0, m1, m2, m3, &vtx[1].x));
+    _mm_storeu_ps(&vtx[2].x, _transform(m0, m1, m2, m3, &vtx[2].x));
+    _mm_storeu_ps(&vtx[3].x, _transform(m0, m1, m2, m3, &vtx[3].x));
+}
+
+//4x transform normal and normalize
+static void gSPTransformNormal4SSE(u32 v, float mtx[4][4])
+{
+    __m128 m0 = LOAD_ROW(mtx, 0), m1 = LOAD_ROW(mtx, 1), m2 = LOAD_ROW(mtx, 2);
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+    __m128 n0 = _transform3(m0, m1, m2, &vtx[0].nx);
+    __m128 n1 = _transform3(m0, m1, m2, &vtx[1].nx);
+    __m128 n2 = _transform3(m0, m1, m2, &vtx[2].nx);
+    __m128 n3 = _transform3(m0, m1, m2, &vtx[3].nx);
+    __m128 len;
+
+    //n0..n3 become x, y, z, pad of the 4 normals
+    _MM_TRANSPOSE4_PS(n0, n1, n2, n3);
+    len = _length(n0, n1, n2);
+    n0 = _mm_div_ps(n0, len);
+    n1 = _mm_div_ps(n1, len);
+    n2 = _mm_div_ps(n2, len);
+    _MM_TRANSPOSE4_PS(n0, n1, n2, n3);
+
+    _mm_storeu_ps(&vtx[0].nx, n0);
+    _mm_storeu_ps(&vtx[1].nx, n1);
+    _mm_storeu_ps(&vtx[2].nx, n2);
+    _mm_storeu_ps(&vtx[3].nx, n3);
+}
+
+static void gSPLightVertex4SSE(u32 v)
+{
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+    float r[4], g[4], b[4];
+    __m128 x, y, z, rr, gg, bb;
+    int j;
+
+    gSPTransformNormal4(v, gSP.matrix.modelView[gSP.matrix.modelViewi]);
+
+    x = _mm_setr_ps(vtx[0].nx, vtx[1].nx, vtx[2].nx, vtx[3].nx);
+    y = _mm_setr_ps(vtx[0].ny, vtx[1].ny, vtx[2].ny, vtx[3].ny);
+    z = _mm_setr_ps(vtx[0].nz, vtx[1].nz, vtx[2].nz, vtx[3].nz);
+    _light4(x, y, z, &rr, &gg, &bb);
+    _mm_storeu_ps(r, rr);
+    _mm_storeu_ps(g, gg);
+    _mm_storeu_ps(b, bb);
+
+    for(j = 0; j < 4; j++)
+    {
+        vtx[j].r = r[j];
+        vtx[j].g = g[j];
+        vtx[j].b = b[j];
+    }
+}
+
+static void gSPBillboardVertex4SSE(u32 v)
+{
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+    __m128 origin = _mm_loadu_ps(&OGL.triangles.vertices[0].x);
+
+    _mm_storeu_ps(&vtx[0].x, _mm_add_ps(_mm_loadu_ps(&vtx[0].x), origin));
+    _mm_storeu_ps(&vtx[1].x, _mm_add_ps(_mm_loadu_ps(&vtx[1].x), origin));
+    _mm_storeu_ps(&vtx[2].x, _mm_add_ps(_mm_loadu_ps(&vtx[2].x), origin));
+    _mm_storeu_ps(&vtx[3].x, _mm_add_ps(_mm_loadu_ps(&vtx[3].x), origin));
+}
+#endif
+
+static void gSPTransformVertexSSE(float vtx[4], float mtx[4][4])
+{
+    _mm_storeu_ps(vtx, _transform(LOAD_ROW(mtx, 0), LOAD_ROW(mtx, 1), LOAD_ROW(mtx, 2), LOAD_ROW(mtx, 3), vtx));
+}
+
+static void gSPLightVertexSSE(u32 v)
+{
+    SPVertex *vtx = &OGL.triangles.vertices[v];
+    __m128 rr, gg, bb;
+
+    TransformVectorNormalize(&vtx->nx, gSP.matrix.modelView[gSP.matrix.modelViewi]);
+    _light4(_mm_set_ss(vtx->nx), _mm_set_ss(vtx->ny), _mm_set_ss(vtx->nz), &rr, &gg, &bb);
+    _mm_store_ss(&vtx->r, rr);
+    _mm_store_ss(&vtx->g, gg);
+    _mm_store_ss(&vtx->b, bb);
+}
+
+static void gSPBillboardVertexSSE(u32 v, u32 i)
+{
+    float *vtx = &OGL.triangles.vertices[v].x;
+    _mm_storeu_ps(vtx, _mm_add_ps(_mm_loadu_ps(vtx), _mm_loadu_ps(&OGL.triangles.vertices[i].x)));
+}
+
+void gSPInitSSE()
+{
+#ifdef __VEC4_OPT
+    gSPTransformVertex4 = gSPTransformVertex4SSE;
+    gSPTransformNormal4 = gSPTransformNormal4SSE;
+    gSPLightVertex4 = gSPLightVertex4SSE;
+    gSPBillboardVertex4 = gSPBillboardVertex4SSE;
+#endif
+    gSPTransformVertex = gSPTransformVertexSSE;
+    gSPLightVertex = gSPLightVertexSSE;
+    gSPBillboardVertex = gSPBillboardVertexSSE;
+}
+#endif
@@ -60,17 +60,26 @@ EXPORT m64p_error CALL PluginStartup(m64p_dynlib_handle CoreLibHandle,
         void *Context, void (*DebugCallback)(void *, int, const char *))
 {
 
-#ifdef __NEON_OPT
+#if defined(__NEON_OPT) || !defined(NOSSE)
    unsigned cpu = 0;
 
    if (perf_get_cpu_features_cb)
       cpu = perf_get_cpu_features_cb();
+#endif
 
+#ifdef __NEON_OPT
    if (cpu & RETRO_SIMD_NEON)
    {
       MathInitNeon();
       gSPInitNeon();
    }
+#endif
+#if !defined(NOSSE)
+   if (cpu & RETRO_SIMD_SSE2)
+   {
+      MathInitSSE();
+      gSPInitSSE();
+   }
 #endif
     return M64ERR_SUCCESS;
 }
@@ -0,0 +1,317 @@
+// Checks the SSE2 (x86) or NEON (ARM) vertex kernels of gles2n64 against a
+// double precision definition of the RSP transform and lighting, so both
+// architectures are held to the same results. The tolerance is relative to
+// the size of the terms summed, as float sums of large terms that cancel
+// are only that precise.
+// Covers the gSP hooks (gSPTransformVertex/4, gSPTransformNormal4,
+// gSPLightVertex/4, gSPBillboardVertex/4) and the 3DMath ones, scalar and
+// SIMD, then times the SIMD gSP kernels. Build and run from the top
+// directory:
+//
+//   FLAGS="-O2 -D__LIBRETRO__ -DINLINE=inline -D__VEC4_OPT -DSDL_VIDEO_OPENGL_ES2=1
+//          -Ilibretro -Imupen64plus-core/src/api -Igles2n64/src"
+//   SRC="gles2n64/src/3DMath.c gles2n64/src/3DMathSSE.c gles2n64/src/gSPSSE.c"
+//   gcc $FLAGS -o vertex_check gles2n64/tools/vertex_check.c $SRC -lm
+//   ./vertex_check [rounds]
+//
+// On ARM add -DNOSSE -D__NEON_OPT -mfpu=neon and build 3DMathNeon.c and
+// gSPNeon.c instead of the SSE files.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "gSP.h"
+#include "OpenGL.h"
+#include "3DMath.h"
+
+// what gSP.c and OpenGL.c would provide
+GLInfo OGL;
+gSPInfo gSP;
+void (*gSPTransformVertex4)(u32 v, float mtx[4][4]);
+void (*gSPTransformNormal4)(u32 v, float mtx[4][4]);
+void (*gSPLightVertex4)(u32 v);
+void (*gSPBillboardVertex4)(u32 v);
+void (*gSPTransformVertex)(float vtx[4], float mtx[4][4]);
+void (*gSPLightVertex)(u32 v);
+void (*gSPBillboardVertex)(u32 v, u32 i);
+
+#define TOLERANCE 1e-5
+#define FIRST     4   // vertex 0 is the billboard origin
+
+static int bad;
+
+static double frand(double lo, double hi)
+{
+    return lo + (hi - lo) * rand() / (double)RAND_MAX;
+}
+
+static void check(const char *what, int vertex, int lane, double got, double want, double scale)
+{
+    double err = fabs(got - want) / (scale > 1.0 ? scale : 1.0);
+    if (err > TOLERANCE && bad++ < 16)
+        printf("%s: vertex %i, lane %i is %.9g, not %.9g\n", what, vertex, lane, got, want);
+}
+
+static void random_matrix(float m[4][4], double range)
+{
+    int i, j;
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 4; j++)
+            m[i][j] = (float)frand(-range, range);
+}
+
+static void random_vertices(int n)
+{
+    int i;
+    for (i = 0; i < n; i++)
+    {
+        SPVertex *v = &OGL.triangles.vertices[i];
+        v->x = (float)(rand() % 65536 - 32768);
+        v->y = (float)(rand() % 65536 - 32768);
+        v->z = (float)(rand() % 65536 - 32768);
+        v->w = 1.0f;
+        // s8 normals as loaded by gSPVertex, sometimes all zero
+        if (rand() % 16)
+        {
+            v->nx = (float)(rand() % 256 - 128);
+            v->ny = (float)(rand() % 256 - 128);
+            v->nz = (float)(rand() % 256 - 128);
+        }
+        else
+            v->nx = v->ny = v->nz = 0.0f;
+        v->r = v->g = v->b = v->a = 0.5f;
+    }
+}
+
+static void random_lights()
+{
+    int i;
+    gSP.numLights = rand() % 8;
+    for (i = 0; i <= gSP.numLights; i++)
+    {
+        float x = (float)frand(-1, 1), y = (float)frand(-1, 1), z = (float)frand(-1, 1);
+        float len = sqrtf(x * x + y * y + z * z);
+        gSP.lights[i].r = (float)frand(0, 1);
+        gSP.lights[i].g = (float)frand(0, 1);
+        gSP.lights[i].b = (float)frand(0, 1);
+        gSP.lights[i].x = x / len;
+        gSP.lights[i].y = y / len;
+        gSP.lights[i].z = z / len;
+    }
+}
+
+// the definitions, in double precision, returning the scale of the terms
+static double ref_transform(const SPVertex *v, float m[4][4], double out[4])
+{
+    double scale = 0.0;
+    int i;
+    for (i = 0; i < 4; i++)
+    {
+        out[i] = (double)v->x * m[0][i] + (double)v->y * m[1][i] + (double)v->z * m[2][i] + m[3][i];
+        scale += fabs(v->x * m[0][i]) + fabs(v->y * m[1][i]) + fabs(v->z * m[2][i]) + fabs(m[3][i]);
+    }
+    return scale;
+}
+
+static double ref_normal(const float *n, float m[4][4], double out[3])
+{
+    double len, scale = 0.0;
+    int i;
+    for (i = 0; i < 3; i++)
+    {
+        out[i] = (double)n[0] * m[0][i] + (double)n[1] * m[1][i] + (double)n[2] * m[2][i];
+        scale += fabs(n[0] * m[0][i]) + fabs(n[1] * m[1][i]) + fabs(n[2] * m[2][i]);
+    }
+    len = sqrt(out[0] * out[0] + out[1] * out[1] + out[2] * out[2]);
+    if (len == 0.0)
+        return 1.0;
+    for (i = 0; i < 3; i++)
+        out[i] /= len;
+    return scale / len;
+}
+
+static double ref_light(const float *n, float m[4][4], double out[3])
+{
+    double normal[3], scale;
+    int i;
+    scale = ref_normal(n, m, normal) * (gSP.numLights + 1);
+    out[0] = gSP.lights[gSP.numLights].r;
+    out[1] = gSP.lights[gSP.numLights].g;
+    out[2] = gSP.lights[gSP.numLights].b;
+    for (i = 0; i < gSP.numLights; i++)
+    {
+        double intensity = normal[0] * gSP.lights[i].x + normal[1] * gSP.lights[i].y + normal[2] * gSP.lights[i].z;
+        if (intensity < 0.0) intensity = 0.0;
+        out[0] += gSP.lights[i].r * intensity;
+        out[1] += gSP.lights[i].g * intensity;
+        out[2] += gSP.lights[i].b * intensity;
+    }
+    for (i = 0; i < 3; i++)
+        if (out[i] > 1.0) out[i] = 1.0;
+    return scale;
+}
+
+static void check_gsp(int n)
+{
+    static SPVertex saved[VERTBUFF_SIZE];
+    float (*mtx)[4] = gSP.matrix.modelView[0];
+    int last4 = FIRST + (n - FIRST) / 4 * 4;   // the 4 vertex kernels run below
+    double want[4], scale;
+    int i, j;
+
+    gSP.matrix.modelViewi = 0;
+    random_matrix(mtx, 2.0);
+    random_lights();
+    random_vertices(n);
+    for (i = 0; i < n; i++)
+        saved[i] = OGL.triangles.vertices[i];
+
+    // transforms
+    for (i = FIRST; i + 4 <= n; i += 4)
+        gSPTransformVertex4(i, mtx);
+    for (; i < n; i++)
+        gSPTransformVertex(&OGL.triangles.vertices[i].x, mtx);
+    for (i = FIRST; i < n; i++)
+    {
+        scale = ref_transform(&saved[i], mtx, want);
+        for (j = 0; j < 4; j++)
+            check(i < last4 ? "transform4" : "transform", i, j, (&OGL.triangles.vertices[i].x)[j], want[j], scale);
+    }
+
+    // normals
+    for (i = 0; i < n; i++)
+        OGL.triangles.vertices[i] = saved[i];
+    for (i = FIRST; i + 4 <= n; i += 4)
+        gSPTransformNormal4(i, mtx);
+    for (i = FIRST; i < last4; i++)
+    {
+        scale = ref_normal(&saved[i].nx, mtx, want);
+        for (j = 0; j < 3; j++)
+            check("normal4", i, j, (&OGL.triangles.vertices[i].nx)[j], want[j], scale);
+    }
+
+    // lighting
+    for (i = 0; i < n; i++)
+        OGL.triangles.vertices[i] = saved[i];
+    for (i = FIRST; i + 4 <= n; i += 4)
+        gSPLightVertex4(i);
+    for (; i < n; i++)
+        gSPLightVertex(i);
+    for (i = FIRST; i < n; i++)
+    {
+        scale = ref_light(&saved[i].nx, mtx, want);
+        for (j = 0; j < 3; j++)
+            check(i < last4 ? "light4" : "light", i, j, (&OGL.triangles.vertices[i].r)[j], want[j], scale);
+    }
+
+    // billboards
+    for (i = 0; i < n; i++)
+        OGL.triangles.vertices[i] = saved[i];
+    for (i = FIRST; i + 4 <= n; i += 4)
+        gSPBillboardVertex4(i);
+    for (; i < n; i++)
+        gSPBillboardVertex(i, 0);
+    for (i = FIRST; i < n; i++)
+        for (j = 0; j < 4; j++)
+            check("billboard", i, j, (&OGL.triangles.vertices[i].x)[j],
+                    (double)(&saved[i].x)[j] + (&saved[0].x)[j],
+                    fabs((&saved[i].x)[j]) + fabs((&saved[0].x)[j]));
+}
+
+static void check_math()
+{
+    float m0[4][4], m1[4][4], dest[4][4], vec[3], in[3];
+    double want[3], scale;
+    int i, j, k;
+
+    random_matrix(m0, 2.0);
+    random_matrix(m1, 2.0);
+    MultMatrix(m0, m1, dest);
+    for (i = 0; i < 4; i++)
+        for (j = 0; j < 4; j++)
+        {
+            double d = 0.0;
+            scale = 0.0;
+            for (k = 0; k < 4; k++)
+            {
+                d += (double)m0[k][j] * m1[i][k];
+                scale += fabs(m0[k][j] * m1[i][k]);
+            }
+            check("MultMatrix", i, j, dest[i][j], d, scale);
+        }
+
+    for (i = 0; i < 3; i++)
+        in[i] = vec[i] = (float)(rand() % 256 - 128);
+    TransformVectorNormalize(vec, m0);
+    scale = ref_normal(in, m0, want);
+    for (i = 0; i < 3; i++)
+        check("TransformVectorNormalize", 0, i, vec[i], want[i], scale);
+}
+
+static double time_gsp(unsigned rounds)
+{
+    float (*mtx)[4] = gSP.matrix.modelView[0];
+    clock_t start = clock();
+    unsigned r;
+    int i;
+
+    gSP.numLights = 2;
+    for (r = 0; r < rounds; r++)
+    {
+        random_vertices(64);
+        for (i = 0; i < 64; i += 4)
+        {
+            gSPTransformVertex4(i, mtx);
+            gSPLightVertex4(i);
+        }
+    }
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned rounds = (argc > 1) ? atoi(argv[1]) : 20000;
+    double seconds, base;
+    unsigned r;
+
+    // 3DMath.c, scalar
+    for (r = 0; r < rounds; r++)
+        check_math();
+
+#ifdef __NEON_OPT
+    MathInitNeon();
+    gSPInitNeon();
+    printf("checking the NEON kernels\n");
+#else
+    MathInitSSE();
+    gSPInitSSE();
+    printf("checking the SSE2 kernels\n");
+#endif
+
+    for (r = 0; r < rounds && bad < 16; r++)
+    {
+        check_math();
+        check_gsp(FIRST + rand() % (VERTBUFF_SIZE - FIRST));
+    }
+
+    // vertex setup alone, then setup plus transform and two lights
+    gSP.numLights = 0;
+    {
+        clock_t start = clock();
+        for (r = 0; r < rounds; r++)
+            random_vertices(64);
+        base = (double)(clock() - start) / CLOCKS_PER_SEC;
+    }
+    seconds = time_gsp(rounds) - base;
+    printf("transform + 2 lights: %.1f ns per vertex\n", seconds > 0 ? seconds * 1e9 / (rounds * 64.0) : 0.0);
+
+    if (bad)
+    {
+        printf("MISMATCH in %i values\n", bad);
+        return 1;
+    }
+    printf("all results within %g\n", TOLERANCE);
+    return 0;
+}
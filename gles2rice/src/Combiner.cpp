@@ -376,8 +376,6 @@ void CColorCombiner::UpdateCombiner(uint32 dwMux0, uint32 dwMux1)
                 dwMux1 = 0xfffcf438;
             }
         }
-        uint64 mux64 = (((uint64)dwMux1)<<32)+dwMux0;
-        int index=m_DecodedMuxList.find(mux64);
 
         if (options.enableHackForGames == HACK_FOR_CONKER)
         {
@@ -397,40 +395,7 @@ void CColorCombiner::UpdateCombiner(uint32 dwMux0, uint32 dwMux1)
             }
         }
 
-        if (index >= 0)
-        {
-            m_decodedMux = m_DecodedMuxList[index];
-        }
-        else
-        {
-            m_decodedMux.Decode(dwMux0, dwMux1);
-            m_decodedMux.splitType[0] = CM_FMT_TYPE_NOT_CHECKED;
-            m_decodedMux.splitType[1] = CM_FMT_TYPE_NOT_CHECKED;
-            m_decodedMux.splitType[2] = CM_FMT_TYPE_NOT_CHECKED;
-            m_decodedMux.splitType[3] = CM_FMT_TYPE_NOT_CHECKED;
-
-            m_decodedMux.Hack();
-
-            if (!m_bSupportMultiTexture)
-            {
-                m_decodedMux.ReplaceVal(MUX_TEXEL1, MUX_TEXEL0, -1, MUX_MASK);
-                m_decodedMux.ReplaceVal(MUX_LODFRAC, 1, -1, MUX_MASK);
-                m_decodedMux.ReplaceVal(MUX_PRIMLODFRAC, 1, -1, MUX_MASK);
-            }
-
-            m_decodedMux.Simplify();
-            if (m_supportedStages > 1)    
-                m_decodedMux.SplitComplexStages();
-            
-            m_DecodedMuxList.add(m_decodedMux.m_u64Mux, *m_pDecodedMux);
-#ifdef DEBUGGER
-            if (logCombiners) 
-            {
-                TRACE0("Add a new mux");
-                DisplayMuxString();
-            }
-#endif
-        }
+        LoadDecodedMux(dwMux0, dwMux1);
 
         m_bTex0Enabled = m_decodedMux.m_bTexel0IsUsed;
         m_bTex1Enabled = m_decodedMux.m_bTexel1IsUsed;
@@ -441,6 +406,54 @@ void CColorCombiner::UpdateCombiner(uint32 dwMux0, uint32 dwMux1)
     }
 }
 
+// Fills m_pDecodedMux for the mux, from the list of the muxes decoded before
+// or by decoding it
+void CColorCombiner::LoadDecodedMux(uint32 dwMux0, uint32 dwMux1)
+{
+    uint64 mux64 = (((uint64)dwMux1)<<32)+dwMux0;
+    int index=m_DecodedMuxList.find(mux64);
+
+    if (index >= 0)
+    {
+        *m_pDecodedMux = m_DecodedMuxList[index];
+    }
+    else
+    {
+        DecodeMux(dwMux0, dwMux1);
+        m_DecodedMuxList.add(mux64, *m_pDecodedMux);
+#ifdef DEBUGGER
+        if (logCombiners) 
+        {
+            TRACE0("Add a new mux");
+            DisplayMuxString();
+        }
+#endif
+    }
+}
+
+void CColorCombiner::DecodeMux(uint32 dwMux0, uint32 dwMux1)
+{
+    DecodedMux &m_decodedMux = *m_pDecodedMux;
+
+    m_decodedMux.Decode(dwMux0, dwMux1);
+    m_decodedMux.splitType[0] = CM_FMT_TYPE_NOT_CHECKED;
+    m_decodedMux.splitType[1] = CM_FMT_TYPE_NOT_CHECKED;
+    m_decodedMux.splitType[2] = CM_FMT_TYPE_NOT_CHECKED;
+    m_decodedMux.splitType[3] = CM_FMT_TYPE_NOT_CHECKED;
+
+    m_decodedMux.Hack();
+
+    if (!m_bSupportMultiTexture)
+    {
+        m_decodedMux.ReplaceVal(MUX_TEXEL1, MUX_TEXEL0, -1, MUX_MASK);
+        m_decodedMux.ReplaceVal(MUX_LODFRAC, 1, -1, MUX_MASK);
+        m_decodedMux.ReplaceVal(MUX_PRIMLODFRAC, 1, -1, MUX_MASK);
+    }
+
+    m_decodedMux.Simplify();
+    if (m_supportedStages > 1)    
+        m_decodedMux.SplitComplexStages();
+}
 
 #ifdef DEBUGGER
 void CColorCombiner::DisplayMuxString(void)
@@ -60,6 +60,9 @@ protected:
     virtual void InitCombinerCycleFill(void)=0;
     virtual void InitCombinerCycle12(void)=0;
 
+    virtual void LoadDecodedMux(uint32 dwMux0, uint32 dwMux1);
+    void DecodeMux(uint32 dwMux0, uint32 dwMux1);
+
     bool    m_bTex0Enabled;
     bool    m_bTex1Enabled;
     bool    m_bTexelsEnable;
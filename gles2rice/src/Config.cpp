@@ -344,6 +344,9 @@ BOOL InitConfiguration(void)
     ConfigSetDefaultBool(l_ConfigVideoRice, "LoadHiResTextures", FALSE, "Enable hi-resolution texture file loading");
     ConfigSetDefaultBool(l_ConfigVideoRice, "DumpTexturesToFiles", FALSE, "Enable texture dumping");
     ConfigSetDefaultBool(l_ConfigVideoRice, "ShowFPS", FALSE, "Display On-screen FPS");
+    ConfigSetDefaultBool(l_ConfigVideoRice, "ShaderCache", TRUE, "Remember the combiners of each game and compile their shaders at start");
+    ConfigSetDefaultBool(l_ConfigVideoRice, "BatchTriangles", TRUE, "Draw the triangles of consecutive commands in one call while the render state is unchanged");
+    ConfigSetDefaultBool(l_ConfigVideoRice, "ShareTextures", TRUE, "Load identical textures found at different addresses into one texture");
 
     ConfigSetDefaultInt(l_ConfigVideoRice, "Mipmapping", 2, "Use Mipmapping? 0=no, 1=nearest, 2=bilinear, 3=trilinear");
     ConfigSetDefaultInt(l_ConfigVideoRice, "FogMethod", 0, "Enable, Disable or Force fog generation (0=Disable, 1=Enable n64 choose, 2=Force Fog)");
@@ -395,8 +398,13 @@ bool isSSESupported()
 {
     int SSESupport = 0;
 
+// The vertex kernels are NEON ones in ARM builds.
+#if defined(NOSSE)
+#if defined(__NEON_OPT)
+    return true;
+#endif
 // And finally, check the CPUID for Streaming SIMD Extensions support.
-#if !defined(__GNUC__) && !defined(NO_ASM)
+#elif !defined(__GNUC__) && !defined(NO_ASM)
     _asm
 	{
             mov      eax, 1          // Put a "1" in eax to tell CPUID to get the feature bits
@@ -404,7 +412,7 @@ bool isSSESupported()
             and      edx, 02000000h  // Test bit 25, for Streaming SIMD Extensions existence.
             mov      SSESupport, edx // SIMD Extensions).  Set return value to 1 to indicate,
     }
-#elif defined(__GNUC__) && defined(__x86_64__) && !defined(NO_ASM)
+#elif defined(__GNUC__) && defined(__x86_64__)
   return true;
 #elif !defined(NO_ASM) // GCC assumed
    asm volatile (
@@ -458,6 +466,9 @@ static void ReadConfiguration(void)
     options.bLoadHiResCRCOnly = ConfigGetParamBool(l_ConfigVideoRice, "LoadHiResCRCOnly");
     options.bDumpTexturesToFiles = ConfigGetParamBool(l_ConfigVideoRice, "DumpTexturesToFiles");
     options.bShowFPS = ConfigGetParamBool(l_ConfigVideoRice, "ShowFPS");
+    options.bShaderCache = ConfigGetParamBool(l_ConfigVideoRice, "ShaderCache");
+    options.bBatchTriangles = ConfigGetParamBool(l_ConfigVideoRice, "BatchTriangles");
+    options.bShareTextures = ConfigGetParamBool(l_ConfigVideoRice, "ShareTextures");
 
     options.mipmapping = TEXTURE_NO_MIPMAP;
     //options.mipmapping = ConfigGetParamInt(l_ConfigVideoRice, "Mipmapping");
@@ -479,14 +490,12 @@ static void ReadConfiguration(void)
     status.isVertexShaderSupported = false;
 
     status.isSSEEnabled = status.isSSESupported && options.bEnableSSE;
-#if !defined(NO_ASM)
     if( status.isSSEEnabled )
     {
         ProcessVertexData = ProcessVertexDataSSE;
         DebugMessage(M64MSG_INFO, "SSE processing enabled.");
     }
     else
-#endif
     {
         ProcessVertexData = ProcessVertexDataNoSSE;
         DebugMessage(M64MSG_INFO, "Disabled SSE processing.");
@@ -211,6 +211,9 @@ typedef struct {
     BOOL    bUseFullTMEM;
 
     BOOL    bShowFPS;
+    BOOL    bShaderCache;
+    BOOL    bBatchTriangles;
+    BOOL    bShareTextures;
 
     uint32  mipmapping;
     uint32  fogMethod;
@@ -20,6 +20,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Config.h"
 #include "ConvertImage.h"
 #include "RenderBase.h"
+#include "texdecode.h"
 
 ConvertFunction     gConvertFunctions_FullTMEM[ 8 ][ 4 ] = 
 {
@@ -61,985 +62,251 @@ ConvertFunction     gConvertTlutFunctions[ 8 ][ 4 ] =
 
 extern bool conkerSwapHack;
 
-void ConvertRGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-
-    // Copy of the base pointer
-    uint16 * pSrc = (uint16*)(tinfo.pPhysicalAddress);
-
-    uint8 * pByteSrc = (uint8 *)pSrc;
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    uint32 nFiddle;
-
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y&1) == 0)
-                nFiddle = 0x2;
-            else
-                nFiddle = 0x2 | 0x4;
-
-            // dwDst points to start of destination row
-            uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
-
-            // DWordOffset points to the current dword we're looking at
-            // (process 2 pixels at a time). May be a problem if we don't start on even pixel
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset ^ nFiddle];
-
-                dwDst[x] = Convert555ToRGBA(w);
-                
-                // Increment word offset to point to the next two pixels
-                dwWordOffset += 2;
-            }
-        }
-    }
-    else
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            // dwDst points to start of destination row
-            uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
-
-            // DWordOffset points to the current dword we're looking at
-            // (process 2 pixels at a time). May be a problem if we don't start on even pixel
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset ^ 0x2];
-
-                dwDst[x] = Convert555ToRGBA(w);
-                
-                // Increment word offset to point to the next two pixels
-                dwWordOffset += 2;
-            }
-        }
-    }
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-}
-
-void ConvertRGBA32(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    uint32 * pSrc = (uint32*)(tinfo.pPhysicalAddress);
-
-    if( options.bUseFullTMEM )
-    {
-        Tile &tile = gRDP.tiles[tinfo.tileNo];
-
-        uint32 *pWordSrc;
-        if( tinfo.tileNo >= 0 )
-        {
-            pWordSrc = (uint32*)&g_Tmem.g_Tmem64bit[tile.dwTMem];
-
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
-
-                uint32 nFiddle = ( y&1 )? 0x2 : 0;
-                int idx = tile.dwLine*4*y;
-
-                for (uint32 x = 0; x < tinfo.WidthToLoad; x++, idx++)
-                {
-                    uint32 w = pWordSrc[idx^nFiddle];
-                    uint8* psw = (uint8*)&w;
-                    uint8* pdw = (uint8*)&dwDst[x];
-                    pdw[0] = psw[2];    // Blue
-                    pdw[1] = psw[1];    // Green
-                    pdw[2] = psw[0];    // Red
-                    pdw[3] = psw[3];    // Alpha
-                }
-            }
-        }
-    }
-    else
-    {
-        if (tinfo.bSwapped)
-        {
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                if ((y%2) == 0)
-                {
-                    uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-                    uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
-
-                    for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                    {
-                        pDst[0] = pS[1];    // Blue
-                        pDst[1] = pS[2];    // Green
-                        pDst[2] = pS[3];    // Red
-                        pDst[3] = pS[0];    // Alpha
-                        pS+=4;
-                        pDst+=4;
-                    }
-                }
-                else
-                {
-                    uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-                    uint8 *pS = (uint8 *)pSrc;
-                    int n;
-
-                    n = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
-                    for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                    {
-                        *pDst++ = COLOR_RGBA(pS[(n+3)^0x8],
-                            pS[(n+2)^0x8],
-                            pS[(n+1)^0x8],
-                            pS[(n+0)^0x8]);
-
-                        n += 4;
-                    }
-                }
-            }
-        }
-        else
-        {
-            for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-            {
-                uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-                uint8 *pS = (uint8 *)pSrc + (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad*4);
-
-                for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-                {
-                    pDst[0] = pS[1];    // Blue
-                    pDst[1] = pS[2];    // Green
-                    pDst[2] = pS[3];    // Red
-                    pDst[3] = pS[0];    // Alpha
-                    pS+=4;
-                    pDst+=4;
-                }
-            }
-        }
-    }
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-}
-
-// E.g. Dear Mario text
-// Copy, Score etc
-void ConvertIA4(CTexture *pTexture, const TxtrInfo &tinfo)
+// Decodes the loaded area of a non-TMEM texture row by row with texdecode.
+// Odd lines of a swapped texture have their words swapped as in TMEM.
+void ConvertTexdec(CTexture *pTexture, const TxtrInfo &tinfo, uint32 format, uint32 output, const uint32 *lut)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
-
-#ifdef DEBUGGER
-    if (((long long)pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
-#endif
+    uint32 oddXor = (tinfo.Size == TXT_SIZE_32b) ? 0x8 : 0x4;
 
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // For odd lines, swap words too
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-
-            // This may not work if X is not even?
-            uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // Do two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                // Even
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-                // Odd
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = OneToEight[(b & 0x01)     ];
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + (y * dInfo.lPitch);
+        uint32 odd = y & 1;
+        uint32 texel = ((((y+tinfo.TopToLoad) * tinfo.Pitch) << 1) >> tinfo.Size) + tinfo.LeftToLoad;
 
-            // This may not work if X is not even?
-            uint32 dwByteOffset = (y+tinfo.TopToLoad) * tinfo.Pitch + (tinfo.LeftToLoad/2);
+        // Conker's I4 textures swap every other group of 4 lines the other way
+        if (format == TEXDEC_I4 && conkerSwapHack && (y&4))
+            odd ^= 1;
 
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // Do two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                // Even
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = ThreeToEight[(b & 0xE0) >> 5];
-                *pDst++ = OneToEight[(b & 0x10) >> 4];  
-                // Odd
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = ThreeToEight[(b & 0x0E) >> 1];
-                *pDst++ = OneToEight[(b & 0x01)     ];
-
-                dwByteOffset++;
-            }
-        }
+        texdec_row((uint8 *)dInfo.lpSurface + y * dInfo.lPitch, output, format, tinfo.pPhysicalAddress,
+            texel, TEXDEC_XOR_HOST | ((tinfo.bSwapped && odd) ? oddXor : 0), tinfo.WidthToLoad, lut);
     }
 
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
-
 }
 
-// E.g Mario's head textures
-void ConvertIA8(CTexture *pTexture, const TxtrInfo &tinfo)
+// The palette as texdecode wants it, Rice keeps it in swapped 16-bit words
+void ConvertTexdecPalette(uint32 *lut, const TxtrInfo &tinfo, uint32 count, uint32 tlutFormat, bool bIgnoreAlpha)
 {
-    DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
-
-#ifdef DEBUGGER
-    if (((long long)pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
-#endif
-
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            // For odd lines, swap words too
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-            // Points to current byte
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                uint8 I = FourToEight[(b & 0xf0)>>4];
-
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = FourToEight[(b & 0x0f)   ];
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
-    {
-        register const uint8* FourToEightArray = &FourToEight[0];
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // Points to current byte
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                register uint8 b = pSrc[(dwByteOffset++) ^ 0x3];
-                uint8 I = *(FourToEightArray+(b>>4));
+    uint16 * pPal = (uint16 *)tinfo.PalAddress;
+    uint16 tlut[256];
 
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = I;
-                *pDst++ = *(FourToEightArray+(b&0xF));
-            }
-        }
-    }   
-    
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
+    for (uint32 i = 0; i < count; i++)
+        tlut[i] = pPal[i^1];    // Remember palette is in different endian order!
+    texdec_palette(lut, tlut, count, tlutFormat);
 
+    if (bIgnoreAlpha)
+        for (uint32 i = 0; i < count; i++)
+            lut[i] |= 0xFF000000;
 }
 
-// E.g. camera's clouds, shadows
-void ConvertIA16(CTexture *pTexture, const TxtrInfo &tinfo)
+// Full TMEM path: tiles are decoded from TMEM, which is in N64 byte order
+// with odd lines interleaved, textures without a tile from RDRAM as above.
+// The format comes from the size, the texture format and the TLUT mode.
+void ConvertTexdecFullTMEM(CTexture *pTexture, const TxtrInfo &tinfo, uint32 output)
 {
     DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint16 * pSrc = (uint16*)(tinfo.pPhysicalAddress);
-    uint8 * pByteSrc = (uint8 *)pSrc;
-
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            if ((y%2) == 0)
-                nFiddle = 0x2;
-            else
-                nFiddle = 0x4 | 0x2;
-
-            // Points to current word
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset^nFiddle];
-
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w & 0xFF);
+    uint32 lut[256];
+    uint32 format;
+    uint32 oddXor = (tinfo.Size == TXT_SIZE_32b) ? 0x8 : 0x4;
+    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
+    if( tinfo.Format <= TXT_FMT_CI ) bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_NONE);
 
-                dwWordOffset += 2;
-            }
-        }
-    }
+    if( tinfo.Size == TXT_SIZE_32b )
+        format = TEXDEC_RGBA32;
+    else if( tinfo.Size == TXT_SIZE_16b )
+        format = tinfo.Format == TXT_FMT_RGBA ? TEXDEC_RGBA16 : TEXDEC_IA16;
+    else if( gRDP.otherMode.text_tlut>=2 || ( tinfo.Format != TXT_FMT_IA && tinfo.Format != TXT_FMT_I) )
+        format = tinfo.Size == TXT_SIZE_4b ? TEXDEC_CI4 : TEXDEC_CI8;
+    else if( tinfo.Format == TXT_FMT_IA )
+        format = tinfo.Size == TXT_SIZE_4b ? TEXDEC_IA4 : TEXDEC_IA8;
     else
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // Points to current word
-            uint32 dwWordOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad * 2);
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint16 w = *(uint16 *)&pByteSrc[dwWordOffset^0x2];
-
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w >> 8);
-                *pDst++ = (uint8)(w & 0xFF);
+        format = tinfo.Size == TXT_SIZE_4b ? TEXDEC_I4 : TEXDEC_I8;
 
-                dwWordOffset += 2;
-            }
-        }       
-    }
-
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-}
-
-
-
-// Used by MarioKart
-void ConvertI4(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
-
-#ifdef DEBUGGER
-    if (((long long) pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
-#endif
-
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    if (tinfo.bSwapped)
+    if( format == TEXDEC_CI4 || format == TEXDEC_CI8 )
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
+        uint32 count = format == TEXDEC_CI4 ? 16 : 256;
+        uint32 tlutFormat = tinfo.TLutFmt == TLUT_FMT_IA16 ? TEXDEC_TLUT_IA16 : TEXDEC_TLUT_RGBA16;
 
-            // Might not work with non-even starting X
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            // For odd lines, swap words too
-            if( !conkerSwapHack || (y&4) == 0 )
-            {
-                if ((y%2) == 0)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
-            else
-            {
-                if ((y%2) == 1)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                // Even
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   // Other implementations seem to or in (b&0xF0)>>4
-                *pDst++ = FourToEight[(b & 0xF0)>>4]; // why?
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-                // Odd
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-
-                dwByteOffset++;
-            }
-        }
-
-        conkerSwapHack = false;
-    }
-    else
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            // Might not work with non-even starting X
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                // Even
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   // Other implementations seem to or in (b&0xF0)>>4
-                *pDst++ = FourToEight[(b & 0xF0)>>4]; // why?
-                *pDst++ = FourToEight[(b & 0xF0)>>4];
-                *pDst++ = FourToEight[(b & 0xF0)>>4];   
-                // Odd
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-                *pDst++ = FourToEight[(b & 0x0F)];
-
-                dwByteOffset++;
-            }
-        }
-    }
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-}
-
-// Used by MarioKart
-void ConvertI8(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-    uint32 nFiddle;
-
-    long long pSrc = (long long) tinfo.pPhysicalAddress;
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
+        if( tinfo.tileNo >= 0 )
         {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = *(uint8*)((pSrc+dwByteOffset)^nFiddle);
+            // The TLUT sits in the upper half of TMEM, one entry per 64 bits
+            uint32 base = 0x400 + (format == TEXDEC_CI4 ? tinfo.Palette*0x40 : 0);
+            uint16 tlut[256];
 
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;        // Alpha not 255?
+            for (uint32 i = 0; i < count; i++)
+                tlut[i] = (uint16)g_Tmem.g_Tmem16bit[base + (i<<2)];
+            texdec_palette(lut, tlut, count, tlutFormat);
 
-                dwByteOffset++;
-            }
+            if (bIgnoreAlpha)
+                for (uint32 i = 0; i < count; i++)
+                    lut[i] |= 0xFF000000;
         }
-    }
-    else
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
+        else
         {
-            uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = *(uint8*)((pSrc+dwByteOffset)^0x3);
-
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;
-                *pDst++ = b;        // Alpha not 255?
-
-                dwByteOffset++;
-            }
+            ConvertTexdecPalette(lut, tinfo, count, tlutFormat, bIgnoreAlpha);
         }
+        bIgnoreAlpha = false;
     }
 
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-
-}
-
-//*****************************************************************************
-// Convert CI4 images. We need to switch on the palette type
-//*****************************************************************************
-void ConvertCI4( CTexture * p_texture, const TxtrInfo & tinfo )
-{
-    if ( tinfo.TLutFmt == TLUT_FMT_RGBA16 )
-    {
-        ConvertCI4_RGBA16( p_texture, tinfo );  
-    }
-    else if ( tinfo.TLutFmt == TLUT_FMT_IA16 )
-    {
-        ConvertCI4_IA16( p_texture, tinfo );                    
-    }
-}
-
-//*****************************************************************************
-// Convert CI8 images. We need to switch on the palette type
-//*****************************************************************************
-void ConvertCI8( CTexture * p_texture, const TxtrInfo & tinfo )
-{
-    if ( tinfo.TLutFmt == TLUT_FMT_RGBA16 )
-    {
-        ConvertCI8_RGBA16( p_texture, tinfo );  
-    }
-    else if ( tinfo.TLutFmt == TLUT_FMT_IA16 )
-    {
-        ConvertCI8_IA16( p_texture, tinfo );                    
-    }
-}
-
-// Used by Starfox intro
-void ConvertCI4_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
-    uint16 * pPal = (uint16 *)tinfo.PalAddress;
-    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_NONE);
-    
     if (!pTexture->StartUpdate(&dInfo))
         return;
 
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *pDst |= 0xFF000000;
-                }
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                pDst[1] = Convert555ToRGBA(pPal[blo^1]);    // Remember palette is in different endian order!
-
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
+    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
     {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
-        {
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *pDst |= 0xFF000000;
-                }
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = Convert555ToRGBA(pPal[bhi^1]);    // Remember palette is in different endian order!
-                pDst[1] = Convert555ToRGBA(pPal[blo^1]);    // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
-
-                dwByteOffset++;
-            }
-        }
-    }
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-}
+        uint8 *pDst = (uint8 *)dInfo.lpSurface + y * dInfo.lPitch;
+        uint32 odd = y & 1;
 
-// Used by Starfox intro
-void ConvertCI4_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
-
-#ifdef DEBUGGER
-    if (((long long) pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
-#endif
-
-    uint16 * pPal = (uint16 *)tinfo.PalAddress;
-    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
-
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
+        if( tinfo.tileNo >= 0 )
         {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+            // Rice loads 32 bit tiles with both halves of a line side by side
+            Tile &tile = gRDP.tiles[tinfo.tileNo];
+            uint32 lineBytes = tile.dwLine * (tinfo.Size == TXT_SIZE_32b ? 16 : 8);
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                    *pDst |= 0xFF000000;
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two at a time
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                pDst[1] = ConvertIA16ToRGBA(pPal[blo^1]);   // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
-
-                dwByteOffset++;
-            }
+            texdec_row(pDst, output, format, &g_Tmem.g_Tmem64bit[tile.dwTMem],
+                ((lineBytes * y) << 1) >> tinfo.Size, odd ? oddXor : 0, tinfo.WidthToLoad, lut);
         }
-    }
-    else
-    {
-        for (uint32 y = 0; y <  tinfo.HeightToLoad; y++)
+        else
         {
-            uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-            if (tinfo.WidthToLoad == 1)
-            {
-                // corner case
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-                uint8 bhi = (b&0xf0)>>4;
-                *pDst = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                    *pDst |= 0xFF000000;
-            }
-            else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2)
-            {
-                // two pixels at a time
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+            uint32 texel = ((((y+tinfo.TopToLoad) * tinfo.Pitch) << 1) >> tinfo.Size) + tinfo.LeftToLoad;
 
-                uint8 bhi = (b&0xf0)>>4;
-                uint8 blo = (b&0x0f);
-
-                pDst[0] = ConvertIA16ToRGBA(pPal[bhi^1]);   // Remember palette is in different endian order!
-                pDst[1] = ConvertIA16ToRGBA(pPal[blo^1]);   // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    pDst[0] |= 0xFF000000;
-                    pDst[1] |= 0xFF000000;
-                }
-
-                pDst+=2;
-
-                dwByteOffset++;
-            }
+            texdec_row(pDst, output, format, tinfo.pPhysicalAddress,
+                texel, TEXDEC_XOR_HOST | ((tinfo.bSwapped && odd) ? oddXor : 0), tinfo.WidthToLoad, lut);
         }
-    }
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
-}
-
-
-// Used by MarioKart for Cars etc
-void ConvertCI8_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
-{
-    DrawInfo dInfo;
-    uint32 nFiddle;
-
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
-
-#ifdef DEBUGGER
-    if (((long long) pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
-#endif
-
-    uint16 * pPal = (uint16 *)tinfo.PalAddress;
-    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_NONE);
 
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
-    
-    if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
+        if( bIgnoreAlpha )
         {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
+            if( output == TEXDEC_OUT_ARGB4444 )
+                for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
+                    ((uint16 *)pDst)[x] |= 0xF000;
             else
-                nFiddle = 0x7;
-
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
-
-                *pDst++ = Convert555ToRGBA(pPal[b^1]);  // Remember palette is in different endian order!
-                
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
-
-                dwByteOffset++;
-            }
-        }
-    }
-    else
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-            int dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
-
-                *pDst++ = Convert555ToRGBA(pPal[b^1]);  // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
-
-                dwByteOffset++;
-            }
+                for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
+                    ((uint32 *)pDst)[x] |= 0xFF000000;
         }
     }
 
     pTexture->EndUpdate(&dInfo);
     pTexture->SetOthersVariables();
+}
 
+void ConvertRGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    ConvertTexdec(pTexture, tinfo, TEXDEC_RGBA16, TEXDEC_OUT_BGRA8888, NULL);
 }
 
+void ConvertRGBA32(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    if( options.bUseFullTMEM )
+        ConvertTexdecFullTMEM(pTexture, tinfo, TEXDEC_OUT_BGRA8888);
+    else
+        ConvertTexdec(pTexture, tinfo, TEXDEC_RGBA32, TEXDEC_OUT_BGRA8888, NULL);
+}
 
-// Used by MarioKart for Cars etc
-void ConvertCI8_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
+// E.g. Dear Mario text
+// Copy, Score etc
+void ConvertIA4(CTexture *pTexture, const TxtrInfo &tinfo)
 {
-    DrawInfo dInfo;
-    uint32 nFiddle;
+    ConvertTexdec(pTexture, tinfo, TEXDEC_IA4, TEXDEC_OUT_BGRA8888, NULL);
+}
 
-    uint8 * pSrc = (uint8*)(tinfo.pPhysicalAddress);
+// E.g Mario's head textures
+void ConvertIA8(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    ConvertTexdec(pTexture, tinfo, TEXDEC_IA8, TEXDEC_OUT_BGRA8888, NULL);
+}
 
-#ifdef DEBUGGER
-    if (((long long) pSrc) % 4) TRACE0("Texture src addr is not aligned to 4 bytes, check me");
-#endif
+// E.g. camera's clouds, shadows
+void ConvertIA16(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    ConvertTexdec(pTexture, tinfo, TEXDEC_IA16, TEXDEC_OUT_BGRA8888, NULL);
+}
 
-    uint16 * pPal = (uint16 *)tinfo.PalAddress;
-    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
 
-    if (!pTexture->StartUpdate(&dInfo))
-        return;
 
+// Used by MarioKart
+void ConvertI4(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    ConvertTexdec(pTexture, tinfo, TEXDEC_I4, TEXDEC_OUT_BGRA8888, NULL);
     if (tinfo.bSwapped)
-    {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            if ((y%2) == 0)
-                nFiddle = 0x3;
-            else
-                nFiddle = 0x7;
-
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        conkerSwapHack = false;
+}
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ nFiddle];
+// Used by MarioKart
+void ConvertI8(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    ConvertTexdec(pTexture, tinfo, TEXDEC_I8, TEXDEC_OUT_BGRA8888, NULL);
+}
 
-                *pDst++ = ConvertIA16ToRGBA(pPal[b^1]); // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
+//*****************************************************************************
+// Convert CI4 images. We need to switch on the palette type
+//*****************************************************************************
+void ConvertCI4( CTexture * p_texture, const TxtrInfo & tinfo )
+{
+    if ( tinfo.TLutFmt == TLUT_FMT_RGBA16 )
+    {
+        ConvertCI4_RGBA16( p_texture, tinfo );  
+    }
+    else if ( tinfo.TLutFmt == TLUT_FMT_IA16 )
+    {
+        ConvertCI4_IA16( p_texture, tinfo );                    
+    }
+}
 
-                dwByteOffset++;
-            }
-        }
+//*****************************************************************************
+// Convert CI8 images. We need to switch on the palette type
+//*****************************************************************************
+void ConvertCI8( CTexture * p_texture, const TxtrInfo & tinfo )
+{
+    if ( tinfo.TLutFmt == TLUT_FMT_RGBA16 )
+    {
+        ConvertCI8_RGBA16( p_texture, tinfo );  
     }
-    else
+    else if ( tinfo.TLutFmt == TLUT_FMT_IA16 )
     {
-        for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-        {
-            uint32 *pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
+        ConvertCI8_IA16( p_texture, tinfo );                    
+    }
+}
 
-            uint32 dwByteOffset = ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-            
-            for (uint32 x = 0; x < tinfo.WidthToLoad; x++)
-            {
-                uint8 b = pSrc[dwByteOffset ^ 0x3];
+// Used by Starfox intro
+void ConvertCI4_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    uint32 lut[16];
 
-                *pDst++ = ConvertIA16ToRGBA(pPal[b^1]); // Remember palette is in different endian order!
-                if( bIgnoreAlpha )
-                {
-                    *(pDst-1) |= 0xFF000000;
-                }
+    ConvertTexdecPalette(lut, tinfo, 16, TEXDEC_TLUT_RGBA16, tinfo.TLutFmt==TLUT_FMT_NONE);
+    ConvertTexdec(pTexture, tinfo, TEXDEC_CI4, TEXDEC_OUT_BGRA8888, lut);
+}
 
-                dwByteOffset++;
-            }
-        }
-    }
+// Used by Starfox intro
+void ConvertCI4_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    uint32 lut[16];
 
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
+    ConvertTexdecPalette(lut, tinfo, 16, TEXDEC_TLUT_IA16, tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
+    ConvertTexdec(pTexture, tinfo, TEXDEC_CI4, TEXDEC_OUT_BGRA8888, lut);
+}
+
+
+// Used by MarioKart for Cars etc
+void ConvertCI8_RGBA16(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    uint32 lut[256];
+
+    ConvertTexdecPalette(lut, tinfo, 256, TEXDEC_TLUT_RGBA16, tinfo.TLutFmt==TLUT_FMT_NONE);
+    ConvertTexdec(pTexture, tinfo, TEXDEC_CI8, TEXDEC_OUT_BGRA8888, lut);
+}
+
+
+// Used by MarioKart for Cars etc
+void ConvertCI8_IA16(CTexture *pTexture, const TxtrInfo &tinfo)
+{
+    uint32 lut[256];
+
+    ConvertTexdecPalette(lut, tinfo, 256, TEXDEC_TLUT_IA16, tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
+    ConvertTexdec(pTexture, tinfo, TEXDEC_CI8, TEXDEC_OUT_BGRA8888, lut);
 }
 
 void ConvertYUV(CTexture *pTexture, const TxtrInfo &tinfo)
@@ -1170,301 +437,17 @@ uint32 ConvertYUV16ToR8G8B8(int Y, int U, int V)
 // Used by Starfox intro
 void Convert4b(CTexture *pTexture, const TxtrInfo &tinfo)
 {
-    DrawInfo dInfo;
-
-    if (!pTexture->StartUpdate(&dInfo)) 
-        return;
-
-    uint16 * pPal = (uint16 *)tinfo.PalAddress;
-    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
-    if( tinfo.Format <= TXT_FMT_CI ) bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_NONE);
-
-    Tile &tile = gRDP.tiles[tinfo.tileNo];
-
-    uint8 *pByteSrc = tinfo.tileNo >= 0 ? (uint8*)&g_Tmem.g_Tmem64bit[tile.dwTMem] : (uint8*)(tinfo.pPhysicalAddress);
-
-    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-    {
-        uint32 nFiddle;
-        if( tinfo.tileNo < 0 )  
-        {
-            if (tinfo.bSwapped)
-            {
-                if ((y%2) == 0)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
-            else
-            {
-                nFiddle = 3;
-            }
-        }
-        else
-        {
-            nFiddle = ( y&1 )? 0x4 : 0;
-        }
-
-        uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-        int idx = tinfo.tileNo>=0 ? tile.dwLine*8*y : ((y+tinfo.TopToLoad) * tinfo.Pitch) + (tinfo.LeftToLoad / 2);
-
-        if (tinfo.WidthToLoad == 1)
-        {
-            // corner case
-            uint8 b = pByteSrc[idx^nFiddle];
-            uint8 bhi = (b&0xf0)>>4;
-            if( gRDP.otherMode.text_tlut>=2 || ( tinfo.Format != TXT_FMT_IA && tinfo.Format != TXT_FMT_I) )
-            {
-                if( tinfo.TLutFmt == TLUT_FMT_IA16 )
-                {
-                    if( tinfo.tileNo>=0 )
-                        *pDst = ConvertIA16ToRGBA(g_Tmem.g_Tmem16bit[0x400+tinfo.Palette*0x40+(bhi<<2)]);
-                    else
-                        *pDst = ConvertIA16ToRGBA(pPal[bhi^1]);
-                }
-                else
-                {
-                    if( tinfo.tileNo>=0 )
-                        *pDst = Convert555ToRGBA(g_Tmem.g_Tmem16bit[0x400+tinfo.Palette*0x40+(bhi<<2)]);
-                    else
-                        *pDst = Convert555ToRGBA(pPal[bhi^1]);
-                }
-            }
-            else if( tinfo.Format == TXT_FMT_IA )
-                *pDst = ConvertIA4ToRGBA(b>>4);
-            else    // if( tinfo.Format == TXT_FMT_I )
-                *pDst = ConvertI4ToRGBA(b>>4);
-            if( bIgnoreAlpha )
-                *pDst |= 0xFF000000;
-        }
-        else for (uint32 x = 0; x < tinfo.WidthToLoad; x+=2, idx++)
-        {
-            // two pixels at a time
-            uint8 b = pByteSrc[idx^nFiddle];
-            uint8 bhi = (b&0xf0)>>4;
-            uint8 blo = (b&0x0f);
-
-            if( gRDP.otherMode.text_tlut>=2 || ( tinfo.Format != TXT_FMT_IA && tinfo.Format != TXT_FMT_I) )
-            {
-                if( tinfo.TLutFmt == TLUT_FMT_IA16 )
-                {
-                    if( tinfo.tileNo>=0 )
-                    {
-                        pDst[0] = ConvertIA16ToRGBA(g_Tmem.g_Tmem16bit[0x400+tinfo.Palette*0x40+(bhi<<2)]);
-                        pDst[1] = ConvertIA16ToRGBA(g_Tmem.g_Tmem16bit[0x400+tinfo.Palette*0x40+(blo<<2)]);
-                    }
-                    else
-                    {
-                        pDst[0] = ConvertIA16ToRGBA(pPal[bhi^1]);
-                        pDst[1] = ConvertIA16ToRGBA(pPal[blo^1]);
-                    }
-                }
-                else
-                {
-                    if( tinfo.tileNo>=0 )
-                    {
-                        pDst[0] = Convert555ToRGBA(g_Tmem.g_Tmem16bit[0x400+tinfo.Palette*0x40+(bhi<<2)]);
-                        pDst[1] = Convert555ToRGBA(g_Tmem.g_Tmem16bit[0x400+tinfo.Palette*0x40+(blo<<2)]);
-                    }
-                    else
-                    {
-                        pDst[0] = Convert555ToRGBA(pPal[bhi^1]);
-                        pDst[1] = Convert555ToRGBA(pPal[blo^1]);
-                    }
-                }
-            }
-            else if( tinfo.Format == TXT_FMT_IA )
-            {
-                pDst[0] = ConvertIA4ToRGBA(b>>4);
-                pDst[1] = ConvertIA4ToRGBA(b&0xF);
-            }
-            else    // if( tinfo.Format == TXT_FMT_I )
-            {
-                pDst[0] = ConvertI4ToRGBA(b>>4);
-                pDst[1] = ConvertI4ToRGBA(b&0xF);
-            }
-
-            if( bIgnoreAlpha )
-            {
-                pDst[0] |= 0xFF000000;
-                pDst[1] |= 0xFF000000;
-            }
-            pDst+=2;
-        }
-    }
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
+    ConvertTexdecFullTMEM(pTexture, tinfo, TEXDEC_OUT_BGRA8888);
 }
 
 void Convert8b(CTexture *pTexture, const TxtrInfo &tinfo)
 {
-    DrawInfo dInfo;
-    if (!pTexture->StartUpdate(&dInfo)) 
-        return;
-
-    uint16 * pPal = (uint16 *)tinfo.PalAddress;
-    bool bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_UNKNOWN);
-    if( tinfo.Format <= TXT_FMT_CI ) bIgnoreAlpha = (tinfo.TLutFmt==TLUT_FMT_NONE);
-
-    Tile &tile = gRDP.tiles[tinfo.tileNo];
-
-    uint8 *pByteSrc;
-    if( tinfo.tileNo >= 0 )
-    {
-        pByteSrc = (uint8*)&g_Tmem.g_Tmem64bit[tile.dwTMem];
-    }
-    else
-    {
-        pByteSrc = (uint8*)(tinfo.pPhysicalAddress);
-    }
-
-
-    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-    {
-        uint32 * pDst = (uint32 *)((uint8 *)dInfo.lpSurface + y * dInfo.lPitch);
-
-        uint32 nFiddle;
-        if( tinfo.tileNo < 0 )  
-        {
-            if (tinfo.bSwapped)
-            {
-                if ((y%2) == 0)
-                    nFiddle = 0x3;
-                else
-                    nFiddle = 0x7;
-            }
-            else
-            {
-                nFiddle = 3;
-            }
-        }
-        else
-        {
-            nFiddle = ( y&1 )? 0x4 : 0;
-        }
-
-
-        int idx = tinfo.tileNo>=0? tile.dwLine*8*y : ((y+tinfo.TopToLoad) * tinfo.Pitch) + tinfo.LeftToLoad;
-
-        for (uint32 x = 0; x < tinfo.WidthToLoad; x++, idx++)
-        {
-            uint8 b = pByteSrc[idx^nFiddle];
-
-            if( gRDP.otherMode.text_tlut>=2 || ( tinfo.Format != TXT_FMT_IA && tinfo.Format != TXT_FMT_I) )
-            {
-                if( tinfo.TLutFmt == TLUT_FMT_IA16 )
-                {
-                    if( tinfo.tileNo>=0 )
-                        *pDst = ConvertIA16ToRGBA(g_Tmem.g_Tmem16bit[0x400+(b<<2)]);
-                    else
-                        *pDst = ConvertIA16ToRGBA(pPal[b^1]);
-                }
-                else
-                {
-                    if( tinfo.tileNo>=0 )
-                        *pDst = Convert555ToRGBA(g_Tmem.g_Tmem16bit[0x400+(b<<2)]);
-                    else
-                        *pDst = Convert555ToRGBA(pPal[b^1]);
-                }
-            }
-            else if( tinfo.Format == TXT_FMT_IA )
-            {
-                uint8 I = FourToEight[(b & 0xf0)>>4];
-                uint8 * pByteDst = (uint8*)pDst;
-                pByteDst[0] = I;
-                pByteDst[1] = I;
-                pByteDst[2] = I;
-                pByteDst[3] = FourToEight[(b & 0x0f)   ];
-            }
-            else    // if( tinfo.Format == TXT_FMT_I )
-            {
-                uint8 * pByteDst = (uint8*)pDst;
-                pByteDst[0] = b;
-                pByteDst[1] = b;
-                pByteDst[2] = b;
-                pByteDst[3] = b;
-            }
-
-            if( bIgnoreAlpha )
-            {
-                *pDst |= 0xFF000000;
-            }
-            pDst++;
-        }
-    }
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
+    ConvertTexdecFullTMEM(pTexture, tinfo, TEXDEC_OUT_BGRA8888);
 }
 
 
 void Convert16b(CTexture *pTexture, const TxtrInfo &tinfo)
 {
-    DrawInfo dInfo;
-    if (!pTexture->StartUpdate(&dInfo)) 
-        return;
-
-    Tile &tile = gRDP.tiles[tinfo.tileNo];
-
-    uint16 *pWordSrc;
-    if( tinfo.tileNo >= 0 )
-        pWordSrc = (uint16*)&g_Tmem.g_Tmem64bit[tile.dwTMem];
-    else
-        pWordSrc = (uint16*)(tinfo.pPhysicalAddress);
-
-
-    for (uint32 y = 0; y < tinfo.HeightToLoad; y++)
-    {
-        uint32 * dwDst = (uint32 *)((uint8 *)dInfo.lpSurface + y*dInfo.lPitch);
-
-        uint32 nFiddle;
-        if( tinfo.tileNo < 0 )  
-        {
-            if (tinfo.bSwapped)
-            {
-                if ((y&1) == 0)
-                    nFiddle = 0x1;
-                else
-                    nFiddle = 0x3;
-            }
-            else
-            {
-                nFiddle = 0x1;
-            }
-        }
-        else
-        {
-            nFiddle = ( y&1 )? 0x2 : 0;
-        }
-
-
-        int idx = tinfo.tileNo>=0? tile.dwLine*4*y : (((y+tinfo.TopToLoad) * tinfo.Pitch)>>1) + tinfo.LeftToLoad;
-
-        for (uint32 x = 0; x < tinfo.WidthToLoad; x++, idx++)
-        {
-            uint16 w = pWordSrc[idx^nFiddle];
-            uint16 w2 = tinfo.tileNo>=0? ((w>>8)|(w<<8)) : w;
-
-            if( tinfo.Format == TXT_FMT_RGBA )
-            {
-                dwDst[x] = Convert555ToRGBA(w2);
-            }
-            else if( tinfo.Format == TXT_FMT_YUV )
-            {
-            }
-            else if( tinfo.Format >= TXT_FMT_IA )
-            {
-                uint8 * pByteDst = (uint8*)&dwDst[x];
-                *pByteDst++ = (uint8)(w2 >> 8);
-                *pByteDst++ = (uint8)(w2 >> 8);
-                *pByteDst++ = (uint8)(w2 >> 8);
-                *pByteDst++ = (uint8)(w2 & 0xFF);
-            }
-        }
-    }
-
-    pTexture->EndUpdate(&dInfo);
-    pTexture->SetOthersVariables();
+    ConvertTexdecFullTMEM(pTexture, tinfo, TEXDEC_OUT_BGRA8888);
 }
 
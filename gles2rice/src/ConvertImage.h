@@ -245,6 +245,11 @@ uint16 ConvertYUV16ToR4G4B4(int Y, int U, int V);
 
 typedef void    ( * ConvertFunction )( CTexture * p_texture, const TxtrInfo & ti );
 
+// Shared texdecode paths, format and output are texdecode enums
+void ConvertTexdec(CTexture *pTexture, const TxtrInfo &tinfo, uint32 format, uint32 output, const uint32 *lut);
+void ConvertTexdecPalette(uint32 *lut, const TxtrInfo &tinfo, uint32 count, uint32 tlutFormat, bool bIgnoreAlpha);
+void ConvertTexdecFullTMEM(CTexture *pTexture, const TxtrInfo &tinfo, uint32 output);
+
 void ConvertRGBA16(CTexture *pTexture, const TxtrInfo &tinfo);
 void ConvertRGBA32(CTexture *pTexture, const TxtrInfo &tinfo);
 
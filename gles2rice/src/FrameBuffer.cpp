@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "UcodeDefs.h"
 #include "RSP_Parser.h"
 #include "Render.h"
+#include "texhash.h"
 
 #ifndef min
 #define min(a,b) ((a) < (b) ? (a) : (b))
@@ -553,11 +554,26 @@ extern uint32 dwAsmdwBytesPerLine;
 extern uint32 dwAsmCRC;
 extern uint8* pAsmStart;
 
+// Hi-res texture packs and texture dumps are named after the Rice CRC,
+// otherwise every byte is hashed, which the CRC instructions make cheaper than sampling
+bool IsRDRAMCRCExact(void)
+{
+    return !options.bLoadHiResTextures && !options.bDumpTexturesToFiles &&
+        (texhash_backend() != TEXHASH_TABLE || !currentRomOptions.bFastTexCRC);
+}
+
 uint32 CalculateRDRAMCRC(void *pPhysicalAddress, uint32 left, uint32 top, uint32 width, uint32 height, uint32 size, uint32 pitchInBytes )
 {
     dwAsmCRC = 0;
     dwAsmdwBytesPerLine = ((width<<size)+1)/2;
 
+    if (IsRDRAMCRCExact())
+    {
+        uint8 *pStart = (uint8*)pPhysicalAddress + (top * pitchInBytes) + (((left<<size)+1)>>1);
+        dwAsmCRC = texhash_rect(0, pStart, dwAsmdwBytesPerLine, height, pitchInBytes);
+        return dwAsmCRC;
+    }
+
     if (currentRomOptions.bFastTexCRC && !options.bLoadHiResTextures && (height>=32 || (dwAsmdwBytesPerLine>>2)>=16))
     {
         uint32 realWidthInDWORD = dwAsmdwBytesPerLine>>2;
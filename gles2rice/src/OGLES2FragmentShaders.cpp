@@ -17,6 +17,9 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
 #include <stdlib.h>
+#include <ctype.h>
+
+#include "m64p_config.h"
 #include "OGLDebug.h"
 #include "OGLES2FragmentShaders.h"
 #include "OGLRender.h"
@@ -218,6 +221,9 @@ COGL_FragmentProgramCombiner::COGL_FragmentProgramCombiner(CRender *pRender)
     bAlphaTestPreviousState = DISABLE;
     bFogState = DISABLE;
     bFogPreviousState = DISABLE;
+    memset(m_shaderCacheHash, -1, sizeof(m_shaderCacheHash));
+    m_curShaderCacheEntry = -1;
+    m_szShaderCacheFile[0] = 0;
 
     //Create shaders for fill and copy
     GLint success;
@@ -308,6 +314,7 @@ COGL_FragmentProgramCombiner::~COGL_FragmentProgramCombiner()
     }
 
     m_vCompiledShaders.clear();
+    m_vShaderCache.clear();
 }
 
 bool COGL_FragmentProgramCombiner::Initialize(void)
@@ -321,9 +328,161 @@ bool COGL_FragmentProgramCombiner::Initialize(void)
         m_bFragmentProgramIsSupported = true;
 //    }
 
+    OpenShaderCacheFile();
     return true;
 }
 
+static uint32 ShaderCacheHash(uint64 mux)
+{
+    uint32 h = (uint32)mux ^ (uint32)(mux >> 32);
+    h ^= h >> 16;
+    h ^= h >> 8;
+    return h & (SHADER_CACHE_HASH_SIZE - 1);
+}
+
+int COGL_FragmentProgramCombiner::FindShaderCacheEntry(uint64 mux)
+{
+    int i = m_shaderCacheHash[ShaderCacheHash(mux)];
+    while (i >= 0 && m_vShaderCache[i].mux != mux)
+        i = m_vShaderCache[i].next;
+    return i;
+}
+
+// Decodes the mux into m_pDecodedMux and keeps it, still without programs
+int COGL_FragmentProgramCombiner::AddShaderCacheEntry(uint64 mux)
+{
+    OGLShaderCacheEntry entry;
+    uint32 h = ShaderCacheHash(mux);
+
+    DecodeMux((uint32)mux, (uint32)(mux >> 32));
+
+    entry.mux = mux;
+    entry.next = m_shaderCacheHash[h];
+    entry.program = -1;
+    entry.decodedMux = *(DecodedMuxForPixelShader*)m_pDecodedMux;
+    m_vShaderCache.push_back(entry);
+    m_shaderCacheHash[h] = m_vShaderCache.size() - 1;
+    return m_shaderCacheHash[h];
+}
+
+// A mux that was decoded before is copied back with the index of its
+// programs, instead of decoding and simplifying it again
+void COGL_FragmentProgramCombiner::LoadDecodedMux(uint32 dwMux0, uint32 dwMux1)
+{
+    if( !m_bFragmentProgramIsSupported )
+    {
+        COGLColorCombiner4::LoadDecodedMux(dwMux0, dwMux1);
+        return;
+    }
+
+    uint64 mux64 = (((uint64)dwMux1)<<32)+dwMux0;
+    int index = FindShaderCacheEntry(mux64);
+
+    if (index >= 0)
+    {
+        *m_pDecodedMux = m_vShaderCache[index].decodedMux;
+    }
+    else
+    {
+        index = AddShaderCacheEntry(mux64);
+#ifdef DEBUGGER
+        if (logCombiners) 
+        {
+            TRACE0("Add a new mux");
+            DisplayMuxString();
+        }
+#endif
+    }
+    m_curShaderCacheEntry = index;
+}
+
+// The programs are kept, the muxes stay decoded
+void COGL_FragmentProgramCombiner::ClearCompiledShaders(void)
+{
+    m_vCompiledShaders.clear();
+    for (uint32 i=0; i<m_vShaderCache.size(); i++)
+        m_vShaderCache[i].program = -1;
+}
+
+// The muxes compiled in earlier runs of this game, one per line, are
+// compiled now rather than when the game first uses them. GLES2 has no
+// program binaries to keep, so the file only lists the muxes.
+#define SHADER_CACHE_VERSION    1
+#define SHADER_CACHE_MAX        1024
+
+void COGL_FragmentProgramCombiner::OpenShaderCacheFile(void)
+{
+    FILE *f;
+    char line[64], name[51];
+    int version = 0, n = 0, i;
+    unsigned long long mux;
+
+    m_szShaderCacheFile[0] = 0;
+    if (!options.bShaderCache || !g_curRomInfo.szGameName[0])
+        return;
+
+    for (i = 0; g_curRomInfo.szGameName[i] && i < 50; i++)
+        name[i] = isalnum((unsigned char)g_curRomInfo.szGameName[i]) ? g_curRomInfo.szGameName[i] : '_';
+    name[i] = 0;
+    snprintf(m_szShaderCacheFile, PATH_MAX, "%s" OSAL_DIR_SEPARATOR_STR "rice_%s.shaders", ConfigGetUserCachePath(), name);
+
+    f = fopen(m_szShaderCacheFile, "r");
+    if (f)
+    {
+        if (!fgets(line, sizeof(line), f) || sscanf(line, "rice shaders %d", &version) != 1 ||
+            version != SHADER_CACHE_VERSION)
+        {
+            fclose(f);
+            f = NULL;
+        }
+    }
+    if (!f)
+    {
+        // missing, or written by another version: start over
+        f = fopen(m_szShaderCacheFile, "w");
+        if (f)
+        {
+            fprintf(f, "rice shaders %d\n", SHADER_CACHE_VERSION);
+            fclose(f);
+        }
+        else
+            m_szShaderCacheFile[0] = 0;
+        return;
+    }
+
+    // the game has not set a mux yet, keep it that way
+    DecodedMuxForPixelShader saved = *(DecodedMuxForPixelShader*)m_pDecodedMux;
+    while (n < SHADER_CACHE_MAX && fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "%llx", &mux) != 1 || FindShaderCacheEntry(mux) >= 0)
+            continue;
+        m_curShaderCacheEntry = AddShaderCacheEntry(mux);
+        ParseDecodedMux();
+        n++;
+    }
+    fclose(f);
+    *m_pDecodedMux = saved;
+    m_curShaderCacheEntry = -1;
+    m_lastIndex = -1;
+
+    DebugMessage(M64MSG_VERBOSE, "Compiled the shaders of %i combiners from %s", n, m_szShaderCacheFile);
+}
+
+void COGL_FragmentProgramCombiner::AppendShaderCacheFile(uint64 mux)
+{
+    FILE *f;
+
+    if (!m_szShaderCacheFile[0] || m_vShaderCache.size() > SHADER_CACHE_MAX)
+        return;
+
+    f = fopen(m_szShaderCacheFile, "a");
+    if (f)
+    {
+        fprintf(f, "%016llx\n", (unsigned long long)mux);
+        fclose(f);
+    }
+}
+
 
 
 void COGL_FragmentProgramCombiner::DisableCombiner(void)
@@ -644,6 +803,8 @@ int COGL_FragmentProgramCombiner::ParseDecodedMux()
        }
     }
     m_lastIndex = m_vCompiledShaders.size()-4;
+    if (m_curShaderCacheEntry >= 0)
+        m_vShaderCache[m_curShaderCacheEntry].program = m_lastIndex;
 
     return m_lastIndex;
 }
@@ -734,23 +895,25 @@ int COGL_FragmentProgramCombiner::FindCompiledMux()
 #ifdef DEBUGGER
     if( debuggerDropCombiners )
     {
-        m_vCompiledShaders.clear();
+        ClearCompiledShaders();
         //m_dwLastMux0 = m_dwLastMux1 = 0;
         debuggerDropCombiners = false;
     }
 #endif
-    for( uint32 i=0; i<m_vCompiledShaders.size(); i++ )
+    // The programs are stored 4 per mux: without and with alpha test, each
+    // without and with fog
+    int index = m_curShaderCacheEntry;
+    if( index < 0 || m_vShaderCache[index].mux != m_pDecodedMux->m_u64Mux )
     {
-        if( m_vCompiledShaders[i].dwMux0 == m_pDecodedMux->m_dwMux0 
-            && m_vCompiledShaders[i].dwMux1 == m_pDecodedMux->m_dwMux1 
-            && m_vCompiledShaders[i].fogIsUsed == bFogState
-            && m_vCompiledShaders[i].alphaTest == bAlphaTestState)
-        {
-            return (int)i;
-        }
+        index = m_curShaderCacheEntry = FindShaderCacheEntry(m_pDecodedMux->m_u64Mux);
+        if( index < 0 )
+            return -1;
     }
 
-    return -1;
+    if( m_vShaderCache[index].program < 0 )
+        return -1;
+
+    return m_vShaderCache[index].program + (bAlphaTestState ? 2 : 0) + (bFogState ? 1 : 0);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -766,7 +929,7 @@ void COGL_FragmentProgramCombiner::InitCombinerCycle12(void)
     if( debuggerDropCombiners )
     {
         UpdateCombiner(m_pDecodedMux->m_dwMux0,m_pDecodedMux->m_dwMux1);
-        m_vCompiledShaders.clear();
+        ClearCompiledShaders();
         m_dwLastMux0 = m_dwLastMux1 = 0;
         debuggerDropCombiners = false;
     }
@@ -782,7 +945,10 @@ void COGL_FragmentProgramCombiner::InitCombinerCycle12(void)
         m_lastIndex = FindCompiledMux();
         if( m_lastIndex < 0 )       // Can not found
         {
-            m_lastIndex = ParseDecodedMux();
+            if( m_curShaderCacheEntry < 0 )
+                m_curShaderCacheEntry = AddShaderCacheEntry(m_pDecodedMux->m_u64Mux);
+            m_lastIndex = ParseDecodedMux() + (bAlphaTestState ? 2 : 0) + (bFogState ? 1 : 0);
+            AppendShaderCacheFile(m_pDecodedMux->m_u64Mux);
         }
 
         m_dwLastMux0 = m_pDecodedMux->m_dwMux0;
@@ -22,6 +22,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include <vector>
 
 #include "osal_opengl.h"
+#include "osal_files.h"
 
 #include "OGLCombiner.h"
 #include "OGLExtCombiner.h"
@@ -48,6 +49,18 @@ typedef struct
 
 } OGLShaderCombinerSaveType;
 
+// A mux as decoded and simplified, and its programs once compiled
+typedef struct
+{
+    uint64  mux;
+    int     next;       // next entry of the same hash, -1 for none
+    int     program;    // first of its 4 programs in m_vCompiledShaders, -1 until compiled
+
+    DecodedMuxForPixelShader decodedMux;
+} OGLShaderCacheEntry;
+
+#define SHADER_CACHE_HASH_SIZE  256
+
 
 class COGL_FragmentProgramCombiner : public COGLColorCombiner4
 {
@@ -78,10 +91,21 @@ protected:
     bool m_bFragmentProgramIsSupported;
     std::vector<OGLShaderCombinerSaveType> m_vCompiledShaders;
 
+    std::vector<OGLShaderCacheEntry> m_vShaderCache;
+    int m_shaderCacheHash[SHADER_CACHE_HASH_SIZE];
+    int m_curShaderCacheEntry;
+    char m_szShaderCacheFile[PATH_MAX];
+
 private:
     virtual int ParseDecodedMux();
     virtual void GenerateProgramStr();
     int FindCompiledMux();
+    void LoadDecodedMux(uint32 dwMux0, uint32 dwMux1);
+    int FindShaderCacheEntry(uint64 mux);
+    int AddShaderCacheEntry(uint64 mux);
+    void ClearCompiledShaders(void);
+    void OpenShaderCacheFile(void);
+    void AppendShaderCacheFile(uint64 mux);
     virtual void GenerateCombinerSetting(int index);
     virtual void GenerateCombinerSettingConstants(int index);
     float m_AlphaRef;
@@ -299,6 +299,21 @@ void COGLGraphicsContext::UpdateFrame(bool swapOnly)
     if (renderCallback)
         (*renderCallback)(status.bScreenIsDrawn);
 
+    // Average draw calls, triangles and shared texture loads per frame, over the last 300 frames
+    static uint32 dwFrames = 0, dwDrawCalls = 0, dwTrisDrawn = 0, dwTexturesShared = 0;
+    dwDrawCalls += status.dwNumDrawCalls;
+    dwTrisDrawn += status.dwNumTrisDrawn;
+    dwTexturesShared += status.dwNumTexturesShared;
+    if (++dwFrames == 300)
+    {
+        DebugMessage(M64MSG_VERBOSE, "%.1f draw calls, %.1f triangles, %.1f shared texture loads per frame",
+            dwDrawCalls/300.0f, dwTrisDrawn/300.0f, dwTexturesShared/300.0f);
+        dwFrames = dwDrawCalls = dwTrisDrawn = dwTexturesShared = 0;
+    }
+    status.dwNumDrawCalls = 0;
+    status.dwNumTrisDrawn = 0;
+    status.dwNumTexturesShared = 0;
+
    retro_return(true);
    
    /*if (options.bShowFPS)
@@ -16,6 +16,9 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 
+#include <stddef.h>
+#include <string.h>
+
 #include "osal_opengl.h"
 
 #include "OGLES2FragmentShaders.h"
@@ -50,6 +53,8 @@ OGLRender::OGLRender()
     }
 
     m_bEnableMultiTexture = false;
+    m_streamVBO = 0;
+    m_dwStreamVertex = 0;
 }
 
 OGLRender::~OGLRender()
@@ -66,6 +71,11 @@ bool OGLRender::InitDeviceObjects()
 
 bool OGLRender::ClearDeviceObjects()
 {
+    if( m_streamVBO )
+    {
+        glDeleteBuffers(1, &m_streamVBO);
+        m_streamVBO = 0;
+    }
     return true;
 }
 
@@ -83,29 +93,31 @@ void OGLRender::Initialize(void)
     m_bSupportClampToEdge = true;
     OGLXUVFlagMaps[TEXTURE_UV_FLAG_CLAMP].realFlag = GL_CLAMP_TO_EDGE;
 
-    glVertexAttribPointer(VS_POSITION,4,GL_FLOAT,GL_FALSE,sizeof(float)*5,&(g_vtxProjected5[0][0]));
-
-    OPENGL_CHECK_ERRORS;
-
-    if( m_bMultiTexture )
+    if( !m_streamVBO )
     {
-       glVertexAttribPointer(VS_TEXCOORD0,2,GL_FLOAT,GL_FALSE, sizeof( TLITVERTEX ), &(g_vtxBuffer[0].tcord[0].u));
-       OPENGL_CHECK_ERRORS;
-       glVertexAttribPointer(VS_TEXCOORD1,2,GL_FLOAT,GL_FALSE, sizeof( TLITVERTEX ), &(g_vtxBuffer[0].tcord[1].u));
-       OPENGL_CHECK_ERRORS;
-    }
-    else
-    {
-       glVertexAttribPointer(VS_TEXCOORD0,2,GL_FLOAT,GL_FALSE, sizeof( TLITVERTEX ), &(g_vtxBuffer[0].tcord[0].u));
-       OPENGL_CHECK_ERRORS;
+        glGenBuffers(1, &m_streamVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_streamVBO);
+        glBufferData(GL_ARRAY_BUFFER, OGL_STREAM_VERTICES*sizeof(OGLStreamVertex), NULL, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        OPENGL_CHECK_ERRORS;
+        m_dwStreamVertex = 0;
     }
 
-    if (m_bSupportFogCoordExt)
-    {
-       glVertexAttribPointer(VS_FOG,1,GL_FLOAT,GL_FALSE,sizeof(float)*5,&(g_vtxProjected5[0][4]));
-       OPENGL_CHECK_ERRORS;
-    }
+    SetClientVertexArrays();
+}
 
+// Points the vertex attributes at the arrays the triangles are prepared in,
+// which rects, lines and the combiners expect
+void OGLRender::SetClientVertexArrays()
+{
+    glVertexAttribPointer(VS_POSITION,4,GL_FLOAT,GL_FALSE,sizeof(float)*5,&(g_vtxProjected5[0][0]));
+    OPENGL_CHECK_ERRORS;
+    glVertexAttribPointer(VS_TEXCOORD0,2,GL_FLOAT,GL_FALSE, sizeof( TLITVERTEX ), &(g_vtxBuffer[0].tcord[0].u));
+    OPENGL_CHECK_ERRORS;
+    glVertexAttribPointer(VS_TEXCOORD1,2,GL_FLOAT,GL_FALSE, sizeof( TLITVERTEX ), &(g_vtxBuffer[0].tcord[1].u));
+    OPENGL_CHECK_ERRORS;
+    glVertexAttribPointer(VS_FOG,1,GL_FLOAT,GL_FALSE,sizeof(float)*5,&(g_vtxProjected5[0][4]));
+    OPENGL_CHECK_ERRORS;
     glVertexAttribPointer(VS_COLOR, 4, GL_UNSIGNED_BYTE,GL_TRUE, sizeof(uint8)*4, &(g_oglVtxColors[0][0]) );
     OPENGL_CHECK_ERRORS;
 }
@@ -569,8 +581,52 @@ bool OGLRender::RenderFlushTris()
 
     //if options.bOGLVertexClipper == FALSE )
     {
-        glDrawElements( GL_TRIANGLES, gRSP.numVertices, GL_UNSIGNED_SHORT, g_vtxIndex );
+        // The vertices are already in draw order, so no indices are needed.
+        // Each batch goes after the previous ones in the buffer, and a full
+        // buffer is given new storage rather than written over while the GPU
+        // may still read it.
+        static OGLStreamVertex vtx[MAX_BATCH_VERTICES];
+        uint32 dwNum = gRSP.numVertices;
+
+        for( uint32 i=0; i<dwNum; i++ )
+        {
+            vtx[i].x = g_vtxProjected5[i][0];
+            vtx[i].y = g_vtxProjected5[i][1];
+            vtx[i].z = g_vtxProjected5[i][2];
+            vtx[i].w = g_vtxProjected5[i][3];
+            vtx[i].fog = g_vtxProjected5[i][4];
+            vtx[i].u0 = g_vtxBuffer[i].tcord[0].u;
+            vtx[i].v0 = g_vtxBuffer[i].tcord[0].v;
+            vtx[i].u1 = g_vtxBuffer[i].tcord[1].u;
+            vtx[i].v1 = g_vtxBuffer[i].tcord[1].v;
+            memcpy(vtx[i].rgba, g_oglVtxColors[i], 4);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, m_streamVBO);
+        if( m_dwStreamVertex + dwNum > OGL_STREAM_VERTICES )
+        {
+            glBufferData(GL_ARRAY_BUFFER, OGL_STREAM_VERTICES*sizeof(OGLStreamVertex), NULL, GL_STREAM_DRAW);
+            m_dwStreamVertex = 0;
+        }
+        glBufferSubData(GL_ARRAY_BUFFER, m_dwStreamVertex*sizeof(OGLStreamVertex), dwNum*sizeof(OGLStreamVertex), vtx);
+        OPENGL_CHECK_ERRORS;
+
+        glVertexAttribPointer(VS_POSITION,4,GL_FLOAT,GL_FALSE,sizeof(OGLStreamVertex),(GLvoid*)offsetof(OGLStreamVertex,x));
+        glVertexAttribPointer(VS_TEXCOORD0,2,GL_FLOAT,GL_FALSE,sizeof(OGLStreamVertex),(GLvoid*)offsetof(OGLStreamVertex,u0));
+        glVertexAttribPointer(VS_TEXCOORD1,2,GL_FLOAT,GL_FALSE,sizeof(OGLStreamVertex),(GLvoid*)offsetof(OGLStreamVertex,u1));
+        glVertexAttribPointer(VS_FOG,1,GL_FLOAT,GL_FALSE,sizeof(OGLStreamVertex),(GLvoid*)offsetof(OGLStreamVertex,fog));
+        glVertexAttribPointer(VS_COLOR,4,GL_UNSIGNED_BYTE,GL_TRUE,sizeof(OGLStreamVertex),(GLvoid*)offsetof(OGLStreamVertex,rgba));
         OPENGL_CHECK_ERRORS;
+
+        glDrawArrays( GL_TRIANGLES, m_dwStreamVertex, dwNum );
+        OPENGL_CHECK_ERRORS;
+        m_dwStreamVertex += dwNum;
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        SetClientVertexArrays();
+
+        status.dwNumDrawCalls++;
+        status.dwNumTrisDrawn += dwNum/3;
     }
 /*  else
     {
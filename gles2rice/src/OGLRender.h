@@ -22,6 +22,18 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "Combiner.h"
 #include "Render.h"
 
+// One vertex of the stream buffer RenderFlushTris draws from
+typedef struct
+{
+    float   x, y, z, w;
+    float   fog;
+    float   u0, v0;
+    float   u1, v1;
+    uint8   rgba[4];
+} OGLStreamVertex;
+
+enum { OGL_STREAM_VERTICES = 32*MAX_BATCH_VERTICES };
+
 class OGLRender : public CRender
 {
     friend class COGLColorCombiner;
@@ -91,6 +103,8 @@ public:
     virtual void SetTexWrapS(int unitno,GLuint flag);
     virtual void SetTexWrapT(int unitno,GLuint flag);
 
+    void SetClientVertexArrays();
+
 protected:
     COLOR PostProcessDiffuseColor(COLOR curDiffuseColor);
     COLOR PostProcessSpecularColor();
@@ -109,6 +123,11 @@ protected:
     BOOL    m_texUnitEnabled[8];
 
     bool m_bEnableMultiTexture;
+
+    // Triangles are copied into this buffer front to back, and it is
+    // orphaned when full
+    GLuint  m_streamVBO;
+    uint32  m_dwStreamVertex;
 };
 
 #endif
@@ -230,6 +230,7 @@ void RSP_GBI2_Tri1(Gfx *gfx)
     if( gfx->words.w0 == 0x05000017 && gfx->gbi2tri1.flag == 0x80 )
     {
         // The ObjLoadTxtr / Tlut cmd for Evangelion.v64
+        CRender::g_pRender->FlushTris();
         RSP_S2DEX_SPObjLoadTxtr(gfx);
         DebuggerAppendMsg("Fix me, SPObjLoadTxtr as RSP_GBI2_Tri2");
     }
@@ -292,6 +293,7 @@ void RSP_GBI2_Tri2(Gfx *gfx)
     if( gfx->words.w0 == 0x0600002f && gfx->gbi2tri2.flag == 0x80 )
     {
         // The ObjTxSprite cmd for Evangelion.v64
+        CRender::g_pRender->FlushTris();
         RSP_S2DEX_SPObjLoadTxSprite(gfx);
         DebuggerAppendMsg("Fix me, SPObjLoadTxSprite as RSP_GBI2_Tri2");
     }
@@ -658,6 +660,7 @@ void RSP_GBI2_Mtx(Gfx *gfx)
 
     if( gfx->gbi2matrix.param == 0 && gfx->gbi2matrix.len == 0 )
     {
+        CRender::g_pRender->FlushTris();
         DLParser_Bomberman2TextRect(gfx);
         return;
     }
@@ -690,6 +693,7 @@ void RSP_GBI2_Mtx(Gfx *gfx)
             dlistMtxCount++;
             if( dlistMtxCount == 2 )
             {
+                CRender::g_pRender->FlushTris();
                 CRender::g_pRender->ClearZBuffer(1.0f);
             }
         }
@@ -66,7 +66,6 @@ void RDP_GFX_DLInMem(Gfx *gfx)
     LOG_UCODE("#############################################");
 }
 
-extern Matrix ALIGN(16, dkrMatrixTransposed)
 void RSP_Mtx_DKR(Gfx *gfx)
 {   
     uint32 dwAddr = RSPSegmentAddr((gfx->words.w1));
@@ -137,9 +136,6 @@ void RSP_Mtx_DKR(Gfx *gfx)
         mat = matToLoad;
     }
 
-    if( status.isSSEEnabled )
-        MatrixTranspose(&dkrMatrixTransposed, &mat);
-
     DEBUGGER_IF_DUMP(logMatrix,TRACE3("DKR Matrix: cmd=0x%X, idx = %d, mul=%d", dwCommand, index, mul));
     LOG_UCODE("    DKR Loading Mtx: %d, command=%d", index, dwCommand);
     DEBUGGER_PAUSE_AND_DUMP(NEXT_MATRIX_CMD,{TRACE0("Paused at DKR Matrix Cmd");});
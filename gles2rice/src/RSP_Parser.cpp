@@ -27,6 +27,7 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #include "RenderTexture.h"
 #include "Video.h"
 #include "ucode.h"
+#include "plugin/ucode_id.h"
 #include <time.h>
 
 
@@ -268,6 +269,38 @@ uint32  g_dwRDPPalCrc[16];
 #include "RSP_GBI_Sprite2D.h"
 #include "RDP_Texture.h"
 
+// Commands that leave the render state alone, so the triangles before and
+// after them can be drawn in one call. The batch is drawn before and after
+// every other command, as those may change the state around their own
+// triangles too.
+static bool IsBatchSafeCommand(RDPInstruction func)
+{
+    return func == RSP_GBI1_Tri1 || func == RSP_GBI1_Tri2 || func == RSP_GBI0_Tri4 ||
+        func == RSP_GBI2_Tri1 || func == RSP_GBI2_Tri2 || func == RSP_Tri4_PD ||
+        func == RSP_GBI0_Vtx || func == RSP_GBI1_Vtx || func == RSP_GBI2_Vtx ||
+        func == RSP_Vtx_DKR || func == RSP_Vtx_Gemini || func == RSP_Vtx_WRUS ||
+        func == RSP_Vtx_ShadowOfEmpire || func == RSP_Vtx_PD || func == RSP_Vtx_Conker ||
+        func == RSP_GBI0_Mtx || func == RSP_GBI2_Mtx || func == RSP_Mtx_DKR ||
+        func == RSP_GBI1_PopMtx || func == RSP_GBI2_PopMtx ||
+        func == RSP_GBI0_DL || func == RSP_GBI2_DL || func == RSP_GBI1_EndDL || func == RSP_GBI2_EndDL ||
+        func == RSP_GBI1_CullDL || func == RSP_GBI2_CullDL ||
+        func == RSP_GBI1_Noop || func == RSP_GBI1_SpNoop;
+}
+
+static inline void DLParser_Dispatch(Gfx *pgfx)
+{
+    RDPInstruction func = currentUcodeMap[pgfx->words.w0 >>24];
+    if( IsBatchSafeCommand(func) )
+    {
+        func(pgfx);
+        return;
+    }
+
+    CRender::g_pRender->FlushTris();
+    func(pgfx);
+    CRender::g_pRender->FlushTris();
+}
+
 //////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////
 //                  Init and Reset                      //
@@ -714,7 +747,7 @@ uint32 DLParser_CheckUcode(uint32 ucStart, uint32 ucDStart, uint32 ucSize, uint3
         base = ucStart & 0x1fffffff;
 
         uint32 crc_size = ComputeCRC32( 0, &g_pRDRAMu8[ base ], 8);//size );
-        uint32 crc_800 = ComputeCRC32( 0, &g_pRDRAMu8[ base ], 0x800 );
+        uint32 crc_800 = ucode_id_lookup( base )->crc_2k;
         uint32 ucode;
         ucode = DLParser_IdentifyUcode( crc_size, crc_800, (char*)str );
         if ( (int)ucode == ~0 )
@@ -886,7 +919,7 @@ void DLParser_Process(OSTask * pTask)
                 gDlistStack[gDlistStackPointer].pc, pgfx->words.w0, pgfx->words.w1, (gRSP.ucode!=5&&gRSP.ucode!=10)?ucodeNames_GBI1[(pgfx->words.w0>>24)]:ucodeNames_GBI2[(pgfx->words.w0>>24)]);
 #endif
             gDlistStack[gDlistStackPointer].pc += 8;
-            currentUcodeMap[pgfx->words.w0 >>24](pgfx);
+            DLParser_Dispatch(pgfx);
 
             if ( gDlistStackPointer >= 0 && --gDlistStack[gDlistStackPointer].countdown < 0 )
             {
@@ -897,6 +930,7 @@ void DLParser_Process(OSTask * pTask)
 
     }
 
+    CRender::g_pRender->FlushTris();
     CRender::g_pRender->EndRendering();
 
     if( gRSP.ucode >= 17)
@@ -1666,9 +1700,10 @@ void RDP_DLParser_Process(void)
     {
         Gfx *pgfx = (Gfx*)&g_pRDRAMu32[(gDlistStack[gDlistStackPointer].pc>>2)];
         gDlistStack[gDlistStackPointer].pc += 8;
-        currentUcodeMap[pgfx->words.w0 >>24](pgfx);
+        DLParser_Dispatch(pgfx);
     }
 
+    CRender::g_pRender->FlushTris();
     CRender::g_pRender->EndRendering();
 }
 
@@ -72,7 +72,9 @@ CRender::CRender() :
     m_dwMagFilter(FILTER_POINT),
     m_dwAlpha(0xFF),
     m_Mux(0),
-    m_bBlendModeValid(FALSE)
+    m_bBlendModeValid(FALSE),
+    m_dwBatchedVertices(0),
+    m_bBatchNegativeW(false)
 {
     InitRenderBase();
 
@@ -238,7 +240,6 @@ void CRender::SetWorldView(const Matrix & mat, bool bPush, bool bReplace)
     {
         gRSPmodelViewTop = gRSPmodelViewTop * reverseY;
     }
-    MatrixTranspose(&gRSPmodelViewTopTranspose, &gRSPmodelViewTop);
 
     gRSP.bMatrixIsUpdated = true;
     gRSP.bWorldMatrixIsUpdated = true;
@@ -261,7 +262,6 @@ void CRender::PopWorldView()
         {
             gRSPmodelViewTop = gRSPmodelViewTop * reverseY;
         }
-        MatrixTranspose(&gRSPmodelViewTopTranspose, &gRSPmodelViewTop);
         gRSP.bMatrixIsUpdated = true;
         gRSP.bWorldMatrixIsUpdated = true;
     }
@@ -330,6 +330,7 @@ void CRender::RenderReset()
     SetZBias(0);
     gRSP.numVertices = 0;
     gRSP.maxVertexID = 0;
+    m_dwBatchedVertices = 0;
     gRSP.curTile = 0;
     gRSP.fTexScaleX = 1/32.0f;;
     gRSP.fTexScaleY = 1/32.0f;
@@ -1178,32 +1179,28 @@ bool CRender::DrawTriangles()
         if( IsUsedAsDI(g_CI.dwAddr) && gRDP.otherMode.z_cmp+gRDP.otherMode.z_upd > 0 )
         {
             TRACE0("Warning: using Flushtris to write Z-Buffer" );
-            gRSP.numVertices = 0;
-            gRSP.maxVertexID = 0;
+            gRSP.numVertices = m_dwBatchedVertices;
             skipNext = true;
             return true;
         }
         else if( skipNext )
         {
             skipNext = false;
-            gRSP.numVertices = 0;
-            gRSP.maxVertexID = 0;
+            gRSP.numVertices = m_dwBatchedVertices;
             return true;
         }   
     }
 
     if( status.bN64IsDrawingTextureBuffer && frameBufferOptions.bIgnore )
     {
-        gRSP.numVertices = 0;
-        gRSP.maxVertexID = 0;
+        gRSP.numVertices = m_dwBatchedVertices;
         return true;
     }
 
     extern bool bConkerHideShadow;
     if( options.enableHackForGames == HACK_FOR_CONKER && bConkerHideShadow )
     {
-        gRSP.numVertices = 0;
-        gRSP.maxVertexID = 0;
+        gRSP.numVertices = m_dwBatchedVertices;
         return true;
     }
 
@@ -1221,7 +1218,7 @@ bool CRender::DrawTriangles()
     }
     */
 
-    if (gRSP.numVertices == 0) 
+    if (gRSP.numVertices == m_dwBatchedVertices) 
         return true;
 
     if( status.bHandleN64RenderTexture )
@@ -1234,11 +1231,6 @@ bool CRender::DrawTriangles()
         }
     }
 
-    if( !gRDP.bFogEnableInBlender && gRSP.bFogEnabled )
-    {
-        TurnFogOnOff(false);
-    }
-
     for( int t=0; t<2; t++ )
     {
         float halfscaleS = 1;
@@ -1264,7 +1256,7 @@ bool CRender::DrawTriangles()
 
         if( halfscaleS < 1 )
         {
-            for( uint32 i=0; i<gRSP.numVertices; i++ )
+            for( uint32 i=m_dwBatchedVertices; i<gRSP.numVertices; i++ )
             {
                 if( t == 0 )
                 {
@@ -1324,6 +1316,56 @@ bool CRender::DrawTriangles()
         */
     }
 
+    // SetFogFlagForNegativeW turns fog off for a whole draw with a vertex
+    // behind the eye, so such triangles only join a batch of their kind
+    bool bNegativeW = false;
+    if( gRSP.bFogEnabled )
+    {
+        for( uint32 i=m_dwBatchedVertices; i<gRSP.numVertices; i++ )
+        {
+            if( g_vtxBuffer[i].rhw < 0 )
+                bNegativeW = true;
+        }
+    }
+
+    if( m_dwBatchedVertices > 0 && bNegativeW != m_bBatchNegativeW )
+        FlushBatchedTris();
+
+    // The batch stays open for the triangles of the next commands, until
+    // DLParser_Process reaches one that may change the render state
+    m_dwBatchedVertices = gRSP.numVertices;
+    m_bBatchNegativeW = bNegativeW;
+    if( !options.bBatchTriangles || status.isVertexShaderEnabled || status.bUseHW_T_L )
+        FlushTris();
+
+    return true;
+}
+
+// Draws the batch without the vertices added since, and moves those to the front
+void CRender::FlushBatchedTris()
+{
+    uint32 dwFirst = m_dwBatchedVertices;
+    uint32 dwNum = gRSP.numVertices - dwFirst;
+
+    gRSP.numVertices = dwFirst;
+    FlushTris();
+
+    memmove(g_vtxProjected5[0], g_vtxProjected5[dwFirst], dwNum*sizeof(g_vtxProjected5[0]));
+    memmove(g_vtxBuffer, g_vtxBuffer+dwFirst, dwNum*sizeof(g_vtxBuffer[0]));
+    memmove(g_oglVtxColors[0], g_oglVtxColors[dwFirst], dwNum*sizeof(g_oglVtxColors[0]));
+    gRSP.numVertices = dwNum;
+}
+
+void CRender::FlushTris()
+{
+    if( m_dwBatchedVertices == 0 )
+        return;
+
+    if( !gRDP.bFogEnableInBlender && gRSP.bFogEnabled )
+    {
+        TurnFogOnOff(false);
+    }
+
     if( status.bHandleN64RenderTexture && g_pRenderTextureInfo->CI_Info.dwSize == TXT_SIZE_8b )
     {
         ZBufferEnable(FALSE);
@@ -1337,13 +1379,14 @@ bool CRender::DrawTriangles()
         HackZAll();
     }
 
-    bool res = RenderFlushTris();
+    RenderFlushTris();
     g_clippedVtxCount = 0;
 
-    LOG_UCODE("DrawTriangles: Draw %d Triangles", gRSP.numVertices/3);
+    LOG_UCODE("FlushTris: Draw %d Triangles", gRSP.numVertices/3);
     
     gRSP.numVertices = 0;   // Reset index
     gRSP.maxVertexID = 0;
+    m_dwBatchedVertices = 0;
 
     DEBUGGER_PAUSE_AND_DUMP_COUNT_N(NEXT_FLUSH_TRI, {
         TRACE0("Pause after DrawTriangles\n");
@@ -1354,8 +1397,6 @@ bool CRender::DrawTriangles()
     {
         TurnFogOnOff(true);
     }
-
-    return res;
 }
 
 inline int ReverseCITableLookup(uint32 *pTable, int size, uint32 val)
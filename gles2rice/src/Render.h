@@ -172,6 +172,7 @@ public:
     virtual COLOR PostProcessSpecularColor()=0;
     
     bool DrawTriangles();
+    void FlushTris();
     virtual bool RenderFlushTris()=0;
 
     bool TexRect(int nX0, int nY0, int nX1, int nY1, float fS0, float fT0, float fScaleS, float fScaleT, bool colorFlag, uint32 difcolor);
@@ -227,6 +228,11 @@ public:
 
 
 protected:
+    // Vertices DrawTriangles has prepared and left for FlushTris to draw
+    uint32          m_dwBatchedVertices;
+    bool            m_bBatchNegativeW;
+    void            FlushBatchedTris();
+
     BOOL            m_savedZBufferFlag;
     uint32          m_savedMinFilter;
     uint32          m_savedMagFilter;
@@ -121,13 +121,14 @@ ALIGN(16,RSP_Options gRSP)
 ALIGN(16,RDP_Options gRDP)
 
 static ALIGN(16,XVECTOR4 g_normal)
+static ALIGN(16,XVECTOR4 g_vtxNormals[MAX_VERTS])   // normals of the SIMD loaders
 //static int norms[3];
 
 ALIGN(16,XVECTOR4 g_vtxNonTransformed[MAX_VERTS])
 ALIGN(16,XVECTOR4 g_vecProjected[MAX_VERTS])
 ALIGN(16,XVECTOR4 g_vtxTransformed[MAX_VERTS])
 
-float       g_vtxProjected5[1000][5];
+float       g_vtxProjected5[MAX_BATCH_VERTICES][5];
 float       g_vtxProjected5Clipped[2000][5];
 
 //uint32        g_dwVtxFlags[MAX_VERTS];            // Z_POS Z_NEG etc
@@ -140,12 +141,12 @@ float       g_fFogCoord[MAX_VERTS];
 
 EXTERNAL_VERTEX g_vtxForExternal[MAX_VERTS];
 
-TLITVERTEX          g_vtxBuffer[1000];
+TLITVERTEX          g_vtxBuffer[MAX_BATCH_VERTICES];
 TLITVERTEX          g_clippedVtxBuffer[2000];
-uint8               g_oglVtxColors[1000][4];
+uint8               g_oglVtxColors[MAX_BATCH_VERTICES][4];
 int                 g_clippedVtxCount=0;
 TLITVERTEX          g_texRectTVtx[4];
-unsigned short      g_vtxIndex[1000];
+unsigned short      g_vtxIndex[MAX_BATCH_VERTICES];
 unsigned int        g_minIndex, g_maxIndex;
 
 float               gRSPfFogMin;
@@ -155,11 +156,8 @@ float               gRSPfFogDivider;
 uint32          gRSPnumLights;
 Light   gRSPlights[16];
 
-ALIGN(16,Matrix  gRSPworldProjectTransported)
 ALIGN(16,Matrix  gRSPworldProject)
 ALIGN(16,Matrix  gRSPmodelViewTop)
-ALIGN(16,Matrix  gRSPmodelViewTopTranspose)
-ALIGN(16,Matrix  dkrMatrixTransposed)
 
 N64Light        gRSPn64lights[16];
 
@@ -261,370 +259,236 @@ __asm l3:                               \
 #endif
 
 
-#if !defined(__GNUC__) && !defined(NO_ASM)
-__declspec( naked ) void  __fastcall SSEVec3Transform(int i)
+/*
+ *  Vertex kernels of the SIMD loaders
+ *
+ *  Four vertices go through each kernel at a time as structures of arrays:
+ *  one vector holds the x of the 4 vertices, the next their y, and so on.
+ *  The vectors are SSE ones on x86, NEON ones with __NEON_OPT, and plain
+ *  arrays the compiler may vectorize elsewhere.
+ */
+#if !defined(NOSSE)
+#include <xmmintrin.h>
+
+typedef __m128 vec4f;
+
+static inline vec4f vSet(float f)               { return _mm_set1_ps(f); }
+static inline vec4f vLoad(const float *p)       { return _mm_load_ps(p); }
+static inline void  vStore(float *p, vec4f a)   { _mm_store_ps(p, a); }
+static inline vec4f vAdd(vec4f a, vec4f b)      { return _mm_add_ps(a, b); }
+static inline vec4f vMul(vec4f a, vec4f b)      { return _mm_mul_ps(a, b); }
+static inline vec4f vMax(vec4f a, vec4f b)      { return _mm_max_ps(a, b); }
+static inline vec4f vMin(vec4f a, vec4f b)      { return _mm_min_ps(a, b); }
+static inline vec4f vRcp(vec4f a)               { return _mm_div_ps(_mm_set1_ps(1.0f), a); }
+
+// 1/sqrt(a), 0 where a is 0
+static inline vec4f vRsqrtNZ(vec4f a)
 {
-    __asm
-    {
-        shl     ecx,4;      // ecx = i
-
-        movaps  xmm1,   DWORD PTR g_vtxNonTransformed [ecx];        // xmm1 as original vector
-
-        movaps  xmm4,   DWORD PTR gRSPworldProjectTransported;          // row1
-        movaps  xmm5,   DWORD PTR gRSPworldProjectTransported[0x10];    // row2
-        movaps  xmm6,   DWORD PTR gRSPworldProjectTransported[0x20];    // row3
-        movaps  xmm7,   DWORD PTR gRSPworldProjectTransported[0x30];    // row4
-
-        mulps   xmm4, xmm1;     // row 1
-        mulps   xmm5, xmm1;     // row 2
-        mulps   xmm6, xmm1;     // row 3
-        mulps   xmm7, xmm1;     // row 4
-
-        movhlps xmm0, xmm4;     // xmm4 high to xmm0 low
-        movlhps xmm0, xmm5;     // xmm5 low to xmm0 high
-
-        addps   xmm4, xmm0;     // result of add are in xmm4 low
-        addps   xmm5, xmm0;     // result of add are in xmm5 high
-
-        shufps  xmm0, xmm4, 0x44;   // move xmm4 low DWORDs to xmm0 high
-        shufps  xmm4, xmm5, 0xe4;   // move xmm5 high DWORS to xmm4
-        movhlps xmm5, xmm0;         // xmm4, xmm5 are mirrored
-
-        shufps  xmm4, xmm4, 0x08;   // move xmm4's 3rd uint32 to its 2nd uint32
-        shufps  xmm5, xmm5, 0x0d;   // move xmm5's 4th uint32 to its 2nd uint32, 
-                                    // and move its 2nd uint32 to its 1st uint32
-        
-        addps   xmm4, xmm5;     // results are in 1st and 2nd uint32
-
-
-        movhlps xmm0, xmm6;     // xmm6 high to xmm0 low
-        movlhps xmm0, xmm7;     // xmm7 low to xmm0 high
-
-        addps   xmm6, xmm0;     // result of add are in xmm6 low
-        addps   xmm7, xmm0;     // result of add are in xmm7 high
-
-        shufps  xmm0, xmm6, 0x44;   // move xmm6 low DWORDs to xmm0 high
-        shufps  xmm6, xmm7, 0xe4;   // move xmm7 high DWORS to xmm6
-        movhlps xmm7, xmm0;         // xmm6, xmm7 are mirrored
-
-        shufps  xmm6, xmm6, 0x08;   // move xmm6's 3rd uint32 to its 2nd uint32
-        shufps  xmm7, xmm7, 0x0d;   // move xmm7's 4th uint32 to its 2nd uint32, 
-                                    // and move its 2nd uint32 to its 1st uint32
-        
-        addps   xmm6, xmm7;     // results are in 1st and 2nd uint32
-        
-        movlhps xmm4, xmm6;     // final result is in xmm4
-        movaps  DWORD PTR g_vtxTransformed [ecx], xmm4;
-
-        movaps  xmm0,xmm4;
-        shufps  xmm0,xmm0,0xff;
-        divps   xmm4,xmm0;
-        rcpps   xmm0,xmm0;
-        movhlps xmm0,xmm4;
-        shufps  xmm0,xmm0,0xe8;
-        movlhps xmm4,xmm0;
-
-        movaps  DWORD PTR g_vecProjected [ecx], xmm4;
-
-        emms;
-        ret;
-    }
+    vec4f nz = _mm_cmpgt_ps(a, _mm_setzero_ps());
+    return _mm_and_ps(nz, _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a)));
 }
 
-// Only used by DKR
-__declspec( naked ) void  __fastcall SSEVec3TransformDKR(XVECTOR4 &pOut, const XVECTOR4 &pV)
+static inline void vTranspose(vec4f &a, vec4f &b, vec4f &c, vec4f &d)
 {
-    __asm
-    {
-        movaps  xmm1,   DWORD PTR [edx];        // xmm1 as original vector
-
-        movaps  xmm4,   DWORD PTR dkrMatrixTransposed;  // row1
-        movaps  xmm5,   DWORD PTR dkrMatrixTransposed[0x10];    // row2
-        movaps  xmm6,   DWORD PTR dkrMatrixTransposed[0x20];    // row3
-        movaps  xmm7,   DWORD PTR dkrMatrixTransposed[0x30];    // row4
-
-        mulps   xmm4, xmm1;     // row 1
-        mulps   xmm5, xmm1;     // row 2
-        mulps   xmm6, xmm1;     // row 3
-        mulps   xmm7, xmm1;     // row 4
-
-        movhlps xmm0, xmm4;     // xmm4 high to xmm0 low
-        movlhps xmm0, xmm5;     // xmm5 low to xmm0 high
-
-        addps   xmm4, xmm0;     // result of add are in xmm4 low
-        addps   xmm5, xmm0;     // result of add are in xmm5 high
-
-        shufps  xmm0, xmm4, 0x44;   // move xmm4 low DWORDs to xmm0 high
-        shufps  xmm4, xmm5, 0xe4;   // move xmm5 high DWORS to xmm4
-        movhlps xmm5, xmm0;         // xmm4, xmm5 are mirrored
-
-        shufps  xmm4, xmm4, 0x08;   // move xmm4's 3rd uint32 to its 2nd uint32
-        shufps  xmm5, xmm5, 0x0d;   // move xmm5's 4th uint32 to its 2nd uint32, 
-        // and move its 2nd uint32 to its 1st uint32
-
-        addps   xmm4, xmm5;     // results are in 1st and 2nd uint32
-
-
-        movhlps xmm0, xmm6;     // xmm6 high to xmm0 low
-        movlhps xmm0, xmm7;     // xmm7 low to xmm0 high
-
-        addps   xmm6, xmm0;     // result of add are in xmm6 low
-        addps   xmm7, xmm0;     // result of add are in xmm7 high
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+}
 
-        shufps  xmm0, xmm6, 0x44;   // move xmm6 low DWORDs to xmm0 high
-        shufps  xmm6, xmm7, 0xe4;   // move xmm7 high DWORS to xmm6
-        movhlps xmm7, xmm0;         // xmm6, xmm7 are mirrored
+#elif defined(__NEON_OPT)
+#include <arm_neon.h>
 
-        shufps  xmm6, xmm6, 0x08;   // move xmm6's 3rd uint32 to its 2nd uint32
-        shufps  xmm7, xmm7, 0x0d;   // move xmm7's 4th uint32 to its 2nd uint32, 
-        // and move its 2nd uint32 to its 1st uint32
+typedef float32x4_t vec4f;
 
-        addps   xmm6, xmm7;     // results are in 1st and 2nd uint32
+static inline vec4f vSet(float f)               { return vdupq_n_f32(f); }
+static inline vec4f vLoad(const float *p)       { return vld1q_f32(p); }
+static inline void  vStore(float *p, vec4f a)   { vst1q_f32(p, a); }
+static inline vec4f vAdd(vec4f a, vec4f b)      { return vaddq_f32(a, b); }
+static inline vec4f vMul(vec4f a, vec4f b)      { return vmulq_f32(a, b); }
+static inline vec4f vMax(vec4f a, vec4f b)      { return vmaxq_f32(a, b); }
+static inline vec4f vMin(vec4f a, vec4f b)      { return vminq_f32(a, b); }
 
-        movlhps xmm4, xmm6;     // final result is in xmm4
-        movaps  DWORD PTR [ecx], xmm4;
+static inline vec4f vRcp(vec4f a)
+{
+#if defined(__aarch64__)
+    return vdivq_f32(vdupq_n_f32(1.0f), a);
+#else
+    // estimate and two Newton-Raphson steps, as ARMv7 has no divide
+    vec4f r = vrecpeq_f32(a);
+    r = vmulq_f32(vrecpsq_f32(a, r), r);
+    return vmulq_f32(vrecpsq_f32(a, r), r);
+#endif
+}
 
-        emms;
-        ret;
-    }
+// 1/sqrt(a), 0 where a is 0
+static inline vec4f vRsqrtNZ(vec4f a)
+{
+    uint32x4_t nz = vcgtq_f32(a, vdupq_n_f32(0.0f));
+    vec4f r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    return vreinterpretq_f32_u32(vandq_u32(nz, vreinterpretq_u32_f32(r)));
 }
-#elif defined(__GNUC__) && defined(__x86_64__) && !defined(NO_ASM)
-void SSEVec3Transform(int i)
+
+static inline void vTranspose(vec4f &a, vec4f &b, vec4f &c, vec4f &d)
 {
-  asm volatile(" shl               $4,      %0   \n"
-               " movslq           %k0,     %q0   \n"
-               " movaps      (%1,%q0),  %%xmm1   \n"
-               " movaps         0(%2),  %%xmm4   \n"
-               " movaps        16(%2),  %%xmm5   \n"
-               " movaps        32(%2),  %%xmm6   \n"
-               " movaps        48(%2),  %%xmm7   \n"
-               " mulps         %%xmm1,  %%xmm4   \n"
-               " mulps         %%xmm1,  %%xmm5   \n"
-               " mulps         %%xmm1,  %%xmm6   \n"
-               " mulps         %%xmm1,  %%xmm7   \n"
-               " movhlps       %%xmm4,  %%xmm0   \n"
-               " movlhps       %%xmm5,  %%xmm0   \n"
-               " addps         %%xmm0,  %%xmm4   \n"
-               " addps         %%xmm0,  %%xmm5   \n"
-               " shufps $0x44, %%xmm4,  %%xmm0   \n"
-               " shufps $0xe4, %%xmm5,  %%xmm4   \n"
-               " movhlps       %%xmm0,  %%xmm5   \n"
-               " shufps $0x08, %%xmm4,  %%xmm4   \n"
-               " shufps $0x0d, %%xmm5,  %%xmm5   \n"
-               " addps         %%xmm5,  %%xmm4   \n"
-               " movhlps       %%xmm6,  %%xmm0   \n"
-               " movlhps       %%xmm7,  %%xmm0   \n"
-               " addps         %%xmm0,  %%xmm6   \n"
-               " addps         %%xmm0,  %%xmm7   \n"
-               " shufps $0x44, %%xmm6,  %%xmm0   \n"
-               " shufps $0xe4, %%xmm7,  %%xmm6   \n"
-               " movhlps       %%xmm0,  %%xmm7   \n"
-               " shufps $0x08, %%xmm6,  %%xmm6   \n"
-               " shufps $0x0d, %%xmm7,  %%xmm7   \n"
-               " addps         %%xmm7,  %%xmm6   \n"
-               " movlhps       %%xmm6,  %%xmm4   \n"
-               " movaps        %%xmm4, (%3,%q0)  \n"
-               " movaps        %%xmm4,  %%xmm0   \n"
-               " shufps $0xff, %%xmm0,  %%xmm0   \n"
-               " divps         %%xmm0,  %%xmm4   \n"
-               " rcpps         %%xmm0,  %%xmm0   \n"
-               " movhlps       %%xmm4,  %%xmm0   \n"
-               " shufps $0xe8, %%xmm0,  %%xmm0   \n"
-               " movlhps       %%xmm0,  %%xmm4   \n"
-               " movaps        %%xmm4, (%4,%q0)  \n"
-               : "+r"(i)
-               : "r"(g_vtxNonTransformed), "r"(&gRSPworldProjectTransported.m[0][0]), "r"(g_vtxTransformed), "r"(g_vecProjected)
-               : "memory", "%xmm0", "%xmm1", "%xmm4", "%xmm5", "%xmm6", "%xmm7"
-               );
+    float32x4x2_t ab = vtrnq_f32(a, b);     // a0 b0 a2 b2, a1 b1 a3 b3
+    float32x4x2_t cd = vtrnq_f32(c, d);     // c0 d0 c2 d2, c1 d1 c3 d3
+    a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
 }
-#elif !defined(NO_ASM) // 32-bit GCC assumed
-void SSEVec3Transform(int i)
+
+#else
+struct vec4f { float f[4]; };
+
+static inline vec4f vSet(float f)               { vec4f r = {{f, f, f, f}}; return r; }
+static inline vec4f vLoad(const float *p)       { vec4f r = {{p[0], p[1], p[2], p[3]}}; return r; }
+static inline void  vStore(float *p, vec4f a)   { for (int k=0; k<4; k++) p[k] = a.f[k]; }
+static inline vec4f vAdd(vec4f a, vec4f b)      { for (int k=0; k<4; k++) a.f[k] += b.f[k]; return a; }
+static inline vec4f vMul(vec4f a, vec4f b)      { for (int k=0; k<4; k++) a.f[k] *= b.f[k]; return a; }
+static inline vec4f vMax(vec4f a, vec4f b)      { for (int k=0; k<4; k++) a.f[k] = a.f[k] > b.f[k] ? a.f[k] : b.f[k]; return a; }
+static inline vec4f vMin(vec4f a, vec4f b)      { for (int k=0; k<4; k++) a.f[k] = a.f[k] < b.f[k] ? a.f[k] : b.f[k]; return a; }
+static inline vec4f vRcp(vec4f a)               { for (int k=0; k<4; k++) a.f[k] = 1.0f / a.f[k]; return a; }
+
+// 1/sqrt(a), 0 where a is 0
+static inline vec4f vRsqrtNZ(vec4f a)
 {
-  asm volatile(" shl               $4,      %0   \n"
-               " movaps       (%1,%0),  %%xmm1   \n"
-               " movaps         0(%2),  %%xmm4   \n"
-               " movaps        16(%2),  %%xmm5   \n"
-               " movaps        32(%2),  %%xmm6   \n"
-               " movaps        48(%2),  %%xmm7   \n"
-               " mulps         %%xmm1,  %%xmm4   \n"
-               " mulps         %%xmm1,  %%xmm5   \n"
-               " mulps         %%xmm1,  %%xmm6   \n"
-               " mulps         %%xmm1,  %%xmm7   \n"
-               " movhlps       %%xmm4,  %%xmm0   \n"
-               " movlhps       %%xmm5,  %%xmm0   \n"
-               " addps         %%xmm0,  %%xmm4   \n"
-               " addps         %%xmm0,  %%xmm5   \n"
-               " shufps $0x44, %%xmm4,  %%xmm0   \n"
-               " shufps $0xe4, %%xmm5,  %%xmm4   \n"
-               " movhlps       %%xmm0,  %%xmm5   \n"
-               " shufps $0x08, %%xmm4,  %%xmm4   \n"
-               " shufps $0x0d, %%xmm5,  %%xmm5   \n"
-               " addps         %%xmm5,  %%xmm4   \n"
-               " movhlps       %%xmm6,  %%xmm0   \n"
-               " movlhps       %%xmm7,  %%xmm0   \n"
-               " addps         %%xmm0,  %%xmm6   \n"
-               " addps         %%xmm0,  %%xmm7   \n"
-               " shufps $0x44, %%xmm6,  %%xmm0   \n"
-               " shufps $0xe4, %%xmm7,  %%xmm6   \n"
-               " movhlps       %%xmm0,  %%xmm7   \n"
-               " shufps $0x08, %%xmm6,  %%xmm6   \n"
-               " shufps $0x0d, %%xmm7,  %%xmm7   \n"
-               " addps         %%xmm7,  %%xmm6   \n"
-               " movlhps       %%xmm6,  %%xmm4   \n"
-               " movaps        %%xmm4,  (%3,%0)  \n"
-               " movaps        %%xmm4,  %%xmm0   \n"
-               " shufps $0xff, %%xmm0,  %%xmm0   \n"
-               " divps         %%xmm0,  %%xmm4   \n"
-               " rcpps         %%xmm0,  %%xmm0   \n"
-               " movhlps       %%xmm4,  %%xmm0   \n"
-               " shufps $0xe8, %%xmm0,  %%xmm0   \n"
-               " movlhps       %%xmm0,  %%xmm4   \n"
-               " movaps        %%xmm4,  (%4,%0)  \n"
-               : "+r"(i)
-               : "r"(g_vtxNonTransformed), "r"(&gRSPworldProjectTransported.m[0][0]), "r"(g_vtxTransformed), "r"(g_vecProjected)
-               : "memory", "%xmm0", "%xmm1", "%xmm4", "%xmm5", "%xmm6", "%xmm7"
-               );
+    for (int k=0; k<4; k++)
+        a.f[k] = a.f[k] > 0 ? 1.0f / sqrtf(a.f[k]) : 0.0f;
+    return a;
 }
-#endif
-float real255 = 255.0f;
-float real128 = 128.0f;
 
-#if !defined(__GNUC__) && !defined(NO_ASM)
-__declspec( naked ) void  __fastcall SSEVec3TransformNormal()
+static inline void vTranspose(vec4f &a, vec4f &b, vec4f &c, vec4f &d)
 {
-    __asm
+    vec4f r[4] = {a, b, c, d};
+    for (int k=0; k<4; k++)
     {
-        mov     DWORD PTR [g_normal][12], 0;
+        a.f[k] = r[k].f[0];
+        b.f[k] = r[k].f[1];
+        c.f[k] = r[k].f[2];
+        d.f[k] = r[k].f[3];
+    }
+}
+#endif
 
-        movaps  xmm4,   DWORD PTR gRSPmodelViewTopTranspose;    // row1
-        movaps  xmm5,   DWORD PTR gRSPmodelViewTopTranspose[0x10];  // row2
-        movaps  xmm1,   DWORD PTR [g_normal];       // xmm1 as the normal vector
-        movaps  xmm6,   DWORD PTR gRSPmodelViewTopTranspose[0x20];  // row3
+// Vertices v[0] to v[n-1], n up to 4, as x, y, z and w vectors. Missing
+// vertices repeat the last one.
+static inline void LoadVertices4(const XVECTOR4 *v, uint32 n, vec4f &x, vec4f &y, vec4f &z, vec4f &w)
+{
+    ALIGN(16, XVECTOR4 pad[4])
 
-        mulps   xmm4, xmm1;     // row 1
-        mulps   xmm5, xmm1;     // row 2
-        mulps   xmm6, xmm1;     // row 3
+    if( n < 4 )
+    {
+        for( uint32 k=0; k<4; k++ )
+            pad[k] = v[k < n ? k : n-1];
+        v = pad;
+    }
+    x = vLoad(&v[0].x);
+    y = vLoad(&v[1].x);
+    z = vLoad(&v[2].x);
+    w = vLoad(&v[3].x);
+    vTranspose(x, y, z, w);
+}
 
-        movhlps xmm0, xmm4;     // xmm4 high to xmm0 low
-        movlhps xmm0, xmm5;     // xmm5 low to xmm0 high
+static inline void StoreVertices4(XVECTOR4 *v, uint32 n, vec4f x, vec4f y, vec4f z, vec4f w)
+{
+    ALIGN(16, XVECTOR4 pad[4])
+    XVECTOR4 *out = n < 4 ? pad : v;
+
+    vTranspose(x, y, z, w);
+    vStore(&out[0].x, x);
+    vStore(&out[1].x, y);
+    vStore(&out[2].x, z);
+    vStore(&out[3].x, w);
+    for( uint32 k=0; out == pad && k<n; k++ )
+        v[k] = pad[k];
+}
 
-        addps   xmm4, xmm0;     // result of add are in xmm4 low
-        addps   xmm5, xmm0;     // result of add are in xmm5 high
+// g_vtxNonTransformed[dwV0..] (w taken as 1) times m into g_vtxTransformed,
+// and divided by w into g_vecProjected with 1/w as w. The sums are in the
+// order of Vec3Transform.
+static void TransformVertices(uint32 dwV0, uint32 dwNum, const Matrix &m)
+{
+    vec4f m11 = vSet(m._11), m12 = vSet(m._12), m13 = vSet(m._13), m14 = vSet(m._14);
+    vec4f m21 = vSet(m._21), m22 = vSet(m._22), m23 = vSet(m._23), m24 = vSet(m._24);
+    vec4f m31 = vSet(m._31), m32 = vSet(m._32), m33 = vSet(m._33), m34 = vSet(m._34);
+    vec4f m41 = vSet(m._41), m42 = vSet(m._42), m43 = vSet(m._43), m44 = vSet(m._44);
 
-        shufps  xmm0, xmm4, 0x44;   // move xmm4 low DWORDs to xmm0 high
-        shufps  xmm4, xmm5, 0xe4;   // move xmm5 high DWORS to xmm4
-        movhlps xmm5, xmm0;         // xmm4, xmm5 are mirrored
+    for( uint32 i = dwV0; i < dwV0 + dwNum; i += 4 )
+    {
+        uint32 n = min(4u, dwV0 + dwNum - i);
+        vec4f x, y, z, w;
 
-        shufps  xmm4, xmm4, 0x08;   // move xmm4's 3rd uint32 to its 2nd uint32
-        shufps  xmm5, xmm5, 0x0d;   // move xmm5's 4th uint32 to its 2nd uint32, 
+        LoadVertices4(&g_vtxNonTransformed[i], n, x, y, z, w);
 
-        addps   xmm4, xmm5;     // results are in 1st and 2nd uint32
+        vec4f tx = vAdd(vAdd(vAdd(vMul(x, m11), vMul(y, m21)), vMul(z, m31)), m41);
+        vec4f ty = vAdd(vAdd(vAdd(vMul(x, m12), vMul(y, m22)), vMul(z, m32)), m42);
+        vec4f tz = vAdd(vAdd(vAdd(vMul(x, m13), vMul(y, m23)), vMul(z, m33)), m43);
+        vec4f tw = vAdd(vAdd(vAdd(vMul(x, m14), vMul(y, m24)), vMul(z, m34)), m44);
+        vec4f rw = vRcp(tw);
 
-        movaps  xmm1,xmm4;
-        mulps   xmm1,xmm1;  //square
-        movlhps xmm7, xmm1;
-        shufps  xmm7, xmm7,0x03;
-        addss   xmm7, xmm1;
+        StoreVertices4(&g_vtxTransformed[i], n, tx, ty, tz, tw);
+        StoreVertices4(&g_vecProjected[i], n, vMul(tx, rw), vMul(ty, rw), vMul(tz, rw), rw);
+    }
+}
 
-        movhlps xmm0, xmm6;     // xmm6 high to xmm0 low
-        addps   xmm6, xmm0;     // result of add are in xmm6 low
+// g_vtxNormals[dwV0..] times the 3x3 part of m, normalized, or 0 where they
+// have no length, as Vec3TransformNormal
+static void TransformNormals(uint32 dwV0, uint32 dwNum, const Matrix &m)
+{
+    vec4f m11 = vSet(m._11), m12 = vSet(m._12), m13 = vSet(m._13);
+    vec4f m21 = vSet(m._21), m22 = vSet(m._22), m23 = vSet(m._23);
+    vec4f m31 = vSet(m._31), m32 = vSet(m._32), m33 = vSet(m._33);
 
-        movlhps xmm0, xmm6;
-        shufps  xmm0, xmm0, 0x03;
-        addss   xmm0, xmm6;     // result of add is at xmm0's 1st uint32
+    for( uint32 i = dwV0; i < dwV0 + dwNum; i += 4 )
+    {
+        uint32 n = min(4u, dwV0 + dwNum - i);
+        vec4f x, y, z, w;
 
-        movlhps xmm4, xmm0;
+        LoadVertices4(&g_vtxNormals[i], n, x, y, z, w);
 
-        mulss   xmm0,xmm0;
-        addss   xmm7,xmm0;      // xmm7 1st uint32 is the sum of squares
+        vec4f tx = vAdd(vAdd(vMul(x, m11), vMul(y, m21)), vMul(z, m31));
+        vec4f ty = vAdd(vAdd(vMul(x, m12), vMul(y, m22)), vMul(z, m32));
+        vec4f tz = vAdd(vAdd(vMul(x, m13), vMul(y, m23)), vMul(z, m33));
+        vec4f f = vRsqrtNZ(vAdd(vAdd(vMul(tx, tx), vMul(ty, ty)), vMul(tz, tz)));
 
-#ifdef DEBUGGER
-        movaps  DWORD PTR [g_normal], xmm4;
-        movss  DWORD PTR [g_normal][12], xmm7;
-#endif
-        xorps   xmm0,xmm0;
-        ucomiss xmm0,xmm7;
-        jz      l2
+        StoreVertices4(&g_vtxNormals[i], n, vMul(tx, f), vMul(ty, f), vMul(tz, f), vSet(0.0f));
+    }
+}
 
-        rsqrtss xmm7,xmm7;
-        shufps  xmm7,xmm7,0;
-#ifdef DEBUGGER
-        movss  DWORD PTR [g_normal][12], xmm7;
-#endif
-        mulps   xmm4,xmm7;
+// Ambient plus the directional lights for the normals of g_vtxNormals, into
+// g_dwVtxDifColor with an alpha of 0xFF, as LightVert does
+static void LightVertices(uint32 dwV0, uint32 dwNum)
+{
+    vec4f zero = vSet(0.0f), full = vSet(255.0f);
 
-        movaps  DWORD PTR [g_normal], xmm4;     // Normalized
-        mov     DWORD PTR [g_normal][12], 0;
+    for( uint32 i = dwV0; i < dwV0 + dwNum; i += 4 )
+    {
+        uint32 n = min(4u, dwV0 + dwNum - i);
+        vec4f x, y, z, w;
+        ALIGN(16, float col[3][4])
+
+        LoadVertices4(&g_vtxNormals[i], n, x, y, z, w);
+
+        vec4f r = vSet(gRSP.fAmbientLightR);
+        vec4f g = vSet(gRSP.fAmbientLightG);
+        vec4f b = vSet(gRSP.fAmbientLightB);
+        for( uint32 l=0; l < gRSPnumLights; l++ )
+        {
+            vec4f fCosT = vAdd(vAdd(vMul(x, vSet(gRSPlights[l].x)), vMul(y, vSet(gRSPlights[l].y))), vMul(z, vSet(gRSPlights[l].z)));
+            fCosT = vMax(fCosT, zero);
+            r = vAdd(r, vMul(vSet(gRSPlights[l].fr), fCosT));
+            g = vAdd(g, vMul(vSet(gRSPlights[l].fg), fCosT));
+            b = vAdd(b, vMul(vSet(gRSPlights[l].fb), fCosT));
+        }
+        vStore(col[0], vMin(r, full));
+        vStore(col[1], vMin(g, full));
+        vStore(col[2], vMin(b, full));
 
-        emms;
-        ret;
-l2:
-        movss   DWORD PTR [g_normal], xmm0;
-        movss   DWORD PTR [g_normal][12], xmm0;
-        emms;
-        ret;
+        for( uint32 k=0; k<n; k++ )
+            g_dwVtxDifColor[i+k] = 0xff000000|(((uint32)col[0][k])<<16)|(((uint32)col[1][k])<<8)|((uint32)col[2][k]);
     }
 }
-#elif defined(__GNUC__) && !defined(NO_ASM)  // this code should compile for both 64-bit and 32-bit architectures
-void SSEVec3TransformNormal(void)
-{
-  asm volatile(" movl              $0,  12(%0)    \n"
-           " movaps          (%1),  %%xmm4    \n"
-           " movaps        16(%1),  %%xmm5    \n"
-           " movaps          (%0),  %%xmm1    \n"
-           " movaps        32(%1),  %%xmm6    \n"
-           " mulps         %%xmm1,  %%xmm4    \n"
-           " mulps         %%xmm1,  %%xmm5    \n"
-           " mulps         %%xmm1,  %%xmm6    \n"
-           " movhlps       %%xmm4,  %%xmm0    \n"
-           " movlhps       %%xmm5,  %%xmm0    \n"
-           " addps         %%xmm0,  %%xmm4    \n"
-           " addps         %%xmm0,  %%xmm5    \n"
-           " shufps $0x44, %%xmm4,  %%xmm0    \n"
-           " shufps $0xe4, %%xmm5,  %%xmm4    \n"
-           " movhlps       %%xmm0,  %%xmm5    \n"
-           " shufps $0x08, %%xmm4,  %%xmm4    \n"
-           " shufps $0x0d, %%xmm5,  %%xmm5    \n"
-           " addps         %%xmm5,  %%xmm4    \n"
-           " movaps        %%xmm4,  %%xmm1    \n"
-           " mulps         %%xmm1,  %%xmm1    \n"
-           " movlhps       %%xmm1,  %%xmm7    \n"
-           " shufps $0x03, %%xmm7,  %%xmm7    \n"
-           " addss         %%xmm1,  %%xmm7    \n"
-           " movhlps       %%xmm6,  %%xmm0    \n"
-           " addps         %%xmm0,  %%xmm6    \n"
-           " movlhps       %%xmm6,  %%xmm0    \n"
-           " shufps $0x03, %%xmm0,  %%xmm0    \n"
-           " addss         %%xmm6,  %%xmm0    \n"
-           " movlhps       %%xmm0,  %%xmm4    \n"
-           " mulss         %%xmm0,  %%xmm0    \n"
-           " addss         %%xmm0,  %%xmm7    \n"
-#ifdef DEBUGGER
-           " movaps        %%xmm4,    (%0)    \n"
-           " movss         %%xmm7,  12(%0)    \n"
-#endif
-           " xorps         %%xmm0,  %%xmm0    \n"
-           " ucomiss       %%xmm7,  %%xmm0    \n"
-           " jz                0f             \n"
-           " rsqrtss       %%xmm7,  %%xmm7    \n"
-           " shufps $0x00, %%xmm7,  %%xmm7    \n"
-#ifdef DEBUGGER
-           " movss         %%xmm7,  12(%0)    \n"
-#endif
-           " mulps         %%xmm7,  %%xmm4    \n"
-           " movaps        %%xmm4,    (%0)    \n"
-           " movl              $0,  12(%0)    \n"
-           " jmp               1f             \n"
-           "0:                                \n"
-           " movss         %%xmm0,    (%0)    \n"
-           " movss         %%xmm0,  12(%0)    \n"
-           "1:                                \n"
-           :
-           : "r"(&g_normal.x), "r"(&gRSPmodelViewTopTranspose.m[0][0])
-           : "memory", "cc", "%xmm0", "%xmm1", "%xmm4", "%xmm5", "%xmm6", "%xmm7"
-           );
-}
-#endif
 
 void NormalizeNormalVec()
 {
@@ -637,13 +501,11 @@ void NormalizeNormalVec()
 
 void InitRenderBase()
 {
-#if !defined(NO_ASM)
     if( status.isSSEEnabled && !g_curRomInfo.bPrimaryDepthHack && options.enableHackForGames != HACK_FOR_NASCAR)
     {
         ProcessVertexData = ProcessVertexDataSSE;
     }
     else
-#endif
     {
         ProcessVertexData = ProcessVertexDataNoSSE;
     }
@@ -1115,163 +977,6 @@ uint32 LightVertNew(XVECTOR4 & norm)
 }
 
 
-float zero = 0.0f;
-float onef = 1.0f;
-float fcosT;
-
-#if !defined(__GNUC__) && !defined(NO_ASM)
-__declspec( naked ) uint32  __fastcall SSELightVert()
-{
-    __asm
-    {
-        movaps      xmm3, DWORD PTR gRSP;   // loading Ambient colors, xmm3 is the result color
-        movaps      xmm4, DWORD PTR [g_normal]; // xmm4 is the normal
-
-        mov         ecx, 0;
-loopback:
-        cmp         ecx, DWORD PTR gRSPnumLights;
-        jae         breakout;
-        mov         eax,ecx;
-        imul        eax,0x44;
-        movups      xmm5, DWORD PTR gRSPlights[eax];        // Light Dir
-        movups      xmm1, DWORD PTR gRSPlights[0x14][eax];  // Light color
-        mulps       xmm5, xmm4;                             // Light Dir * normals
-
-        movhlps     xmm0,xmm5;
-        addps       xmm0,xmm5;
-        shufps      xmm5,xmm0,0x01;
-        addps       xmm0,xmm5;
-
-        comiss      xmm0,zero;
-        jc          endloop
-
-        shufps      xmm0,xmm0,0;                    // fcosT
-        mulps       xmm1,xmm0; 
-        addps       xmm3,xmm1; 
-endloop:
-        inc         ecx;
-        jmp         loopback;
-breakout:
-
-        movss       xmm0,DWORD PTR real255;
-        shufps      xmm0,xmm0,0;
-        minps       xmm0,xmm3;
-
-        // Without using a memory
-        cvtss2si    eax,xmm0;       // move the 1st uint32 to eax
-        shl         eax,10h;
-        or          eax,0FF000000h;
-        shufps      xmm0,xmm0,0E5h; // move the 2nd uint32 to the 1st uint32
-        cvtss2si    ecx,xmm0;       // move the 1st uint32 to ecx
-        shl         ecx,8;
-        or          eax,ecx;
-        shufps      xmm0,xmm0,0E6h; // Move the 3rd uint32 to the 1st uint32
-        cvtss2si    ecx,xmm0;
-        or          eax,ecx;
-
-        ret;
-    }
-}
-#elif defined(__GNUC__) && defined(__x86_64__) && !defined(NO_ASM)
-uint32 SSELightVert(void)
-{
-  uint32 rval;
-  float f255 = 255.0, fZero = 0.0;
-  
-  asm volatile(" movaps        %1,  %%xmm3    \n" // xmm3 == gRSP.fAmbientLight{RGBA}
-           " movaps            %2,  %%xmm4    \n" // xmm4 == g_normal.{xyz}
-           " xor            %%rcx,   %%rcx    \n"
-           "0:                                \n"
-           " cmpl              %3,   %%ecx    \n"
-           " jae               2f             \n"
-           " mov            %%rcx,   %%rax    \n"
-           " imul    $0x44, %%rax,   %%rax    \n"
-           " movups   (%4,%%rax,),  %%xmm5    \n"  // xmm5 == gRSPlights[l].{xyzr}
-           " movups 20(%4,%%rax,),  %%xmm1    \n"  // xmm1 == gRSPlights[l].{frfgfbfa}
-           " mulps         %%xmm4,  %%xmm5    \n"
-           " movhlps       %%xmm5,  %%xmm0    \n"
-           " addps         %%xmm5,  %%xmm0    \n"
-           " shufps $0x01, %%xmm0,  %%xmm5    \n"
-           " addps         %%xmm5,  %%xmm0    \n"
-           " comiss            %6,  %%xmm0    \n"
-           " jc                1f             \n"
-           " shufps $0x00, %%xmm0,  %%xmm0    \n"
-           " mulps         %%xmm0,  %%xmm1    \n"
-           " addps         %%xmm1,  %%xmm3    \n"
-           "1:                                \n"
-           " inc            %%rcx             \n"
-           " jmp               0b             \n"
-           "2:                                \n"
-           " movss             %5,  %%xmm0    \n"
-           " shufps $0x00, %%xmm0,  %%xmm0    \n"
-           " minps         %%xmm3,  %%xmm0    \n"
-           " cvtss2si      %%xmm0,   %%eax    \n"
-           " shll           $0x10,   %%eax    \n"
-           " orl      $0xff000000,   %%eax    \n"
-           " shufps $0xe5, %%xmm0,  %%xmm0    \n"
-           " cvtss2si      %%xmm0,   %%ecx    \n"
-           " shll              $8,   %%ecx    \n"
-           " orl            %%ecx,   %%eax    \n"
-           " shufps $0xe6, %%xmm0,  %%xmm0    \n"
-           " cvtss2si      %%xmm0,   %%ecx    \n"
-           " orl            %%ecx,   %%eax    \n"
-           : "=&a"(rval)
-           : "m"(gRSP), "m"(g_normal), "m"(gRSPnumLights), "r"(gRSPlights), "m"(f255), "m"(fZero)
-           : "%rcx", "memory", "cc", "%xmm0", "%xmm1", "%xmm3", "%xmm4", "%xmm5"
-           );
-  return rval;
-}
-#elif !defined(NO_ASM) // 32-bit GCC assumed
-uint32 SSELightVert(void)
-{
-  uint32 rval;
-  float f255 = 255.0, fZero = 0.0;
-
-  asm volatile(" movaps            %1,  %%xmm3    \n"
-               " movaps            %2,  %%xmm4    \n"
-               " xor            %%ecx,   %%ecx    \n"
-               "0:                                \n"
-               " cmpl              %3,   %%ecx    \n"
-               " jae               2f             \n"
-               " mov            %%ecx,   %%eax    \n"
-               " imul    $0x44, %%eax,   %%eax    \n"
-               " movups   (%4,%%eax,),  %%xmm5    \n"
-               " movups 20(%4,%%eax,),  %%xmm1    \n"
-               " mulps         %%xmm4,  %%xmm5    \n"
-               " movhlps       %%xmm5,  %%xmm0    \n"
-               " addps         %%xmm5,  %%xmm0    \n"
-               " shufps $0x01, %%xmm0,  %%xmm5    \n"
-               " addps         %%xmm5,  %%xmm0    \n"
-               " comiss            %6,  %%xmm0    \n"
-               " jc                1f             \n"
-               " shufps $0x00, %%xmm0,  %%xmm0    \n"
-               " mulps         %%xmm0,  %%xmm1    \n"
-               " addps         %%xmm1,  %%xmm3    \n"
-               "1:                                \n"
-               " inc            %%ecx             \n"
-               " jmp               0b             \n"
-               "2:                                \n"
-               " movss             %5,  %%xmm0    \n"
-               " shufps $0x00, %%xmm0,  %%xmm0    \n"
-               " minps         %%xmm3,  %%xmm0    \n"
-               " cvtss2si      %%xmm0,   %%eax    \n"
-               " shll           $0x10,   %%eax    \n"
-               " orl      $0xff000000,   %%eax    \n"
-               " shufps $0xe5, %%xmm0,  %%xmm0    \n"
-               " cvtss2si      %%xmm0,   %%ecx    \n"
-               " shll              $8,   %%ecx    \n"
-               " orl            %%ecx,   %%eax    \n"
-               " shufps $0xe6, %%xmm0,  %%xmm0    \n"
-               " cvtss2si      %%xmm0,   %%ecx    \n"
-               " orl            %%ecx,   %%eax    \n"
-               : "=&a"(rval)
-               : "m"(gRSP), "m"(g_normal), "m"(gRSPnumLights), "r"(gRSPlights), "m"(f255), "m"(fZero)
-               : "%rcx", "memory", "cc", "%xmm0", "%xmm1", "%xmm3", "%xmm4", "%xmm5"
-               );
-  return rval;
-}
-#endif
-
 inline void ReplaceAlphaWithFogFactor(int i)
 {
     if( gRDP.geometryMode & G_FOG )
@@ -1300,7 +1005,6 @@ inline void ReplaceAlphaWithFogFactor(int i)
 // Assumes dwAddr has already been checked! 
 // Don't inline - it's too big with the transform macros
 
-#if !defined(NO_ASM)
 void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 {
     UpdateCombinedMatrix();
@@ -1322,15 +1026,32 @@ void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 
     for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
     {
-        SP_Timing(RSP_GBI0_Vtx);
-
         FiddledVtx & vert = pVtxBase[i - dwV0];
 
         g_vtxNonTransformed[i].x = (float)vert.x;
         g_vtxNonTransformed[i].y = (float)vert.y;
         g_vtxNonTransformed[i].z = (float)vert.z;
+        g_vtxNonTransformed[i].w = 1;
 
-        SSEVec3Transform(i);
+        g_vtxNormals[i].x = (float)vert.norma.nx;
+        g_vtxNormals[i].y = (float)vert.norma.ny;
+        g_vtxNormals[i].z = (float)vert.norma.nz;
+        g_vtxNormals[i].w = 0;
+    }
+
+    TransformVertices(dwV0, dwNum, gRSPworldProject);
+    if( gRSP.bLightingEnable )
+    {
+        TransformNormals(dwV0, dwNum, gRSPmodelViewTop);
+        if( options.enableHackForGames != HACK_FOR_ZELDA_MM )
+            LightVertices(dwV0, dwNum);
+    }
+
+    for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+    {
+        SP_Timing(RSP_GBI0_Vtx);
+
+        FiddledVtx & vert = pVtxBase[i - dwV0];
 
         if( gRSP.bFogEnabled )
         {
@@ -1339,9 +1060,6 @@ void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
                 g_fFogCoord[i] = gRSPfFogMin;
         }
 
-        ReplaceAlphaWithFogFactor(i);
-
-
         VTX_DUMP( 
         {
             uint32 *dat = (uint32*)(&vert);
@@ -1356,14 +1074,8 @@ void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 
         if( gRSP.bLightingEnable )
         {
-            g_normal.x = (float)vert.norma.nx;
-            g_normal.y = (float)vert.norma.ny;
-            g_normal.z = (float)vert.norma.nz;
-
-            SSEVec3TransformNormal();
-            if( options.enableHackForGames != HACK_FOR_ZELDA_MM )
-                g_dwVtxDifColor[i] = SSELightVert();
-            else
+            g_normal = g_vtxNormals[i];
+            if( options.enableHackForGames == HACK_FOR_ZELDA_MM )
                 g_dwVtxDifColor[i] = LightVert(g_normal, i);
             *(((uint8*)&(g_dwVtxDifColor[i]))+3) = vert.rgba.a; // still use alpha from the vertex
         }
@@ -1389,6 +1101,8 @@ void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
             g_dwVtxDifColor[i] = COLOR_RGBA(vert.rgba.r, vert.rgba.g, vert.rgba.b, vert.rgba.a);
         }
 
+        ReplaceAlphaWithFogFactor(i);
+
         // Update texture coords n.b. need to divide tu/tv by bogus scale on addition to buffer
 
         // If the vertex is already lit, then there is no normal (and hence we
@@ -1407,7 +1121,6 @@ void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
     VTX_DUMP(TRACE2("Setting Vertexes: %d - %d\n", dwV0, dwV0+dwNum-1));
     DEBUGGER_PAUSE_AND_DUMP(NEXT_VERTEX_CMD,{TRACE0("Paused at Vertex Command");});
 }
-#endif
 
 void ProcessVertexDataNoSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 {
@@ -1528,6 +1241,12 @@ void ProcessVertexDataNoSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 
 bool PrepareTriangle(uint32 dwV0, uint32 dwV1, uint32 dwV2)
 {
+    if( gRSP.numVertices + 3 > MAX_BATCH_VERTICES )
+    {
+        CRender::g_pRender->DrawTriangles();
+        CRender::g_pRender->FlushTris();
+    }
+
     if( status.isVertexShaderEnabled || status.bUseHW_T_L )
     {
         g_vtxIndex[gRSP.numVertices++] = dwV0;
@@ -1769,15 +1488,36 @@ void ProcessVertexDataDKR(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
     uint32 end = dwV0 + dwNum;
     for (uint32 i = dwV0; i < end; i++)
     {
-        XVECTOR3 w;
+        short wA = *(short*)((pVtxBase+nOff + 6) ^ 2);
+        short wB = *(short*)((pVtxBase+nOff + 8) ^ 2);
 
         g_vtxNonTransformed[i].x = (float)*(short*)((pVtxBase+nOff + 0) ^ 2);
         g_vtxNonTransformed[i].y = (float)*(short*)((pVtxBase+nOff + 2) ^ 2);
         g_vtxNonTransformed[i].z = (float)*(short*)((pVtxBase+nOff + 4) ^ 2);
+        g_vtxNonTransformed[i].w = 1;
+
+        g_vtxNormals[i].x = (s8)(wA >> 8);
+        g_vtxNormals[i].y = (s8)(wA);
+        g_vtxNormals[i].z = (s8)(wB >> 8);
+        g_vtxNormals[i].w = 0;
+
+        nOff += 10;
+    }
+
+    if( status.isSSEEnabled )
+    {
+        TransformVertices(dwV0, dwNum, matWorldProject);
+        if( gRSP.bLightingEnable )
+        {
+            TransformNormals(dwV0, dwNum, matWorldProject);
+            LightVertices(dwV0, dwNum);
+        }
+    }
 
-        //if( status.isSSEEnabled )
-        //  SSEVec3TransformDKR(g_vtxTransformed[i], g_vtxNonTransformed[i]);
-        //else
+    nOff = 0;
+    for (uint32 i = dwV0; i < end; i++)
+    {
+        if( !status.isSSEEnabled )
             Vec3Transform(&g_vtxTransformed[i], (XVECTOR3*)&g_vtxNonTransformed[i], &matWorldProject);  // Convert to w=1
 
         if( gRSP.DKRVtxCount == 0 && dwNum==1 )
@@ -1795,10 +1535,14 @@ void ProcessVertexDataDKR(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
             g_vtxTransformed[i].w  = gRSP.DKRBaseVec.w;
         }
 
-        g_vecProjected[i].w = 1.0f / g_vtxTransformed[i].w;
-        g_vecProjected[i].x = g_vtxTransformed[i].x * g_vecProjected[i].w;
-        g_vecProjected[i].y = g_vtxTransformed[i].y * g_vecProjected[i].w;
-        g_vecProjected[i].z = g_vtxTransformed[i].z * g_vecProjected[i].w;
+        // the kernel projected the vertices before the base was added
+        if( !status.isSSEEnabled || addbase )
+        {
+            g_vecProjected[i].w = 1.0f / g_vtxTransformed[i].w;
+            g_vecProjected[i].x = g_vtxTransformed[i].x * g_vecProjected[i].w;
+            g_vecProjected[i].y = g_vtxTransformed[i].y * g_vecProjected[i].w;
+            g_vecProjected[i].z = g_vtxTransformed[i].z * g_vecProjected[i].w;
+        }
 
         gRSP.DKRVtxCount++;
 
@@ -1824,17 +1568,12 @@ void ProcessVertexDataDKR(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 
         if (gRSP.bLightingEnable)
         {
-            g_normal.x = (char)r; //norma.nx;
-            g_normal.y = (char)g; //norma.ny;
-            g_normal.z = (char)b; //norma.nz;
-
-            Vec3TransformNormal(g_normal, matWorldProject)
-#if !defined(NO_ASM)
-            if( status.isSSEEnabled )
-                g_dwVtxDifColor[i] = SSELightVert();
-            else
-#endif
+            if( !status.isSSEEnabled )
+            {
+                g_normal = g_vtxNormals[i];
+                Vec3TransformNormal(g_normal, matWorldProject)
                 g_dwVtxDifColor[i] = LightVert(g_normal, i);
+            }
         }
         else
         {
@@ -1869,16 +1608,34 @@ void ProcessVertexDataPD(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
     for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
     {
         N64VtxPD &vert = pVtxBase[i - dwV0];
+        uint8 *addr = g_pRDRAMu8+dwPDCIAddr+ (vert.cidx&0xFF);
 
         g_vtxNonTransformed[i].x = (float)vert.x;
         g_vtxNonTransformed[i].y = (float)vert.y;
         g_vtxNonTransformed[i].z = (float)vert.z;
+        g_vtxNonTransformed[i].w = 1;
 
-#if !defined(NO_ASM)
-        if( status.isSSEEnabled )
-            SSEVec3Transform(i);
-        else
-#endif
+        g_vtxNormals[i].x = (char)addr[3];
+        g_vtxNormals[i].y = (char)addr[2];
+        g_vtxNormals[i].z = (char)addr[1];
+        g_vtxNormals[i].w = 0;
+    }
+
+    if( status.isSSEEnabled )
+    {
+        TransformVertices(dwV0, dwNum, gRSPworldProject);
+        if( gRSP.bLightingEnable )
+        {
+            TransformNormals(dwV0, dwNum, gRSPmodelViewTop);
+            LightVertices(dwV0, dwNum);
+        }
+    }
+
+    for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+    {
+        N64VtxPD &vert = pVtxBase[i - dwV0];
+
+        if( !status.isSSEEnabled )
         {
             Vec3Transform(&g_vtxTransformed[i], (XVECTOR3*)&g_vtxNonTransformed[i], &gRSPworldProject); // Convert to w=1
             g_vecProjected[i].w = 1.0f / g_vtxTransformed[i].w;
@@ -1901,17 +1658,8 @@ void ProcessVertexDataPD(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 
         if( gRSP.bLightingEnable )
         {
-            g_normal.x = (char)r;
-            g_normal.y = (char)g;
-            g_normal.z = (char)b;
-#if !defined(NO_ASM)
-            if( status.isSSEEnabled )
-            {
-                SSEVec3TransformNormal();
-                g_dwVtxDifColor[i] = SSELightVert();
-            }
-            else
-#endif
+            g_normal = g_vtxNormals[i];
+            if( !status.isSSEEnabled )
             {
                 Vec3TransformNormal(g_normal, gRSPmodelViewTop);
                 g_dwVtxDifColor[i] = LightVert(g_normal, i);
@@ -1978,19 +1726,24 @@ void ProcessVertexDataConker(uint32 dwAddr, uint32 dwV0, uint32 dwNum)
 
     for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
     {
-        SP_Timing(RSP_GBI0_Vtx);
-
         FiddledVtx & vert = pVtxBase[i - dwV0];
 
         g_vtxNonTransformed[i].x = (float)vert.x;
         g_vtxNonTransformed[i].y = (float)vert.y;
         g_vtxNonTransformed[i].z = (float)vert.z;
+        g_vtxNonTransformed[i].w = 1;
+    }
 
-#if !defined(NO_ASM)
-        if( status.isSSEEnabled )
-            SSEVec3Transform(i);
-        else
-#endif
+    if( status.isSSEEnabled )
+        TransformVertices(dwV0, dwNum, gRSPworldProject);
+
+    for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+    {
+        SP_Timing(RSP_GBI0_Vtx);
+
+        FiddledVtx & vert = pVtxBase[i - dwV0];
+
+        if( !status.isSSEEnabled )
         {
             Vec3Transform(&g_vtxTransformed[i], (XVECTOR3*)&g_vtxNonTransformed[i], &gRSPworldProject); // Convert to w=1
             g_vecProjected[i].w = 1.0f / g_vtxTransformed[i].w;
@@ -2135,12 +1888,29 @@ void ProcessVertexData_Rogue_Squadron(uint32 dwXYZAddr, uint32 dwColorAddr, uint
         g_vtxNonTransformed[i].x = (float)vertxyz.x;
         g_vtxNonTransformed[i].y = (float)vertxyz.y;
         g_vtxNonTransformed[i].z = (float)vertxyz.z;
+        g_vtxNonTransformed[i].w = 1;
 
-#if !defined(NO_ASM)
-        if( status.isSSEEnabled )
-            SSEVec3Transform(i);
-        else
-#endif
+        g_vtxNormals[i].x = (float)vertcolors.nx;
+        g_vtxNormals[i].y = (float)vertcolors.ny;
+        g_vtxNormals[i].z = (float)vertcolors.nz;
+        g_vtxNormals[i].w = 0;
+    }
+
+    if( status.isSSEEnabled )
+    {
+        TransformVertices(dwV0, dwNum, gRSPworldProject);
+        if( gRSP.bLightingEnable )
+        {
+            TransformNormals(dwV0, dwNum, gRSPmodelViewTop);
+            LightVertices(dwV0, dwNum);
+        }
+    }
+
+    for (uint32 i = dwV0; i < dwV0 + dwNum; i++)
+    {
+        RS_Vtx_Color & vertcolors = pVtxColorBase[i - dwV0];
+
+        if( !status.isSSEEnabled )
         {
             Vec3Transform(&g_vtxTransformed[i], (XVECTOR3*)&g_vtxNonTransformed[i], &gRSPworldProject); // Convert to w=1
             g_vecProjected[i].w = 1.0f / g_vtxTransformed[i].w;
@@ -2165,18 +1935,8 @@ void ProcessVertexData_Rogue_Squadron(uint32 dwXYZAddr, uint32 dwColorAddr, uint
 
         if( gRSP.bLightingEnable )
         {
-            g_normal.x = (float)vertcolors.nx;
-            g_normal.y = (float)vertcolors.ny;
-            g_normal.z = (float)vertcolors.nz;
-
-#if !defined(NO_ASM)
-            if( status.isSSEEnabled )
-            {
-                SSEVec3TransformNormal();
-                g_dwVtxDifColor[i] = SSELightVert();
-            }
-            else
-#endif
+            g_normal = g_vtxNormals[i];
+            if( !status.isSSEEnabled )
             {
                 Vec3TransformNormal(g_normal, gRSPmodelViewTop);
                 g_dwVtxDifColor[i] = LightVert(g_normal, i);
@@ -2390,12 +2150,6 @@ void UpdateCombinedMatrix()
         {
             gRSPworldProject = gRSPworldProject * reverseY;
         }
-#if !defined(NO_ASM)
-        if( status.isSSEEnabled )
-        {
-            MatrixTranspose(&gRSPworldProjectTransported, &gRSPworldProject);
-        }
-#endif
         gRSP.bCombinedMatrixIsUpdated = false;
     }
 
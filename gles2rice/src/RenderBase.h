@@ -40,6 +40,7 @@ enum FillMode
 };
 
 enum { MAX_VERTS = 80 };        // F3DLP.Rej supports up to 80 verts!
+enum { MAX_BATCH_VERTICES = 1000 };     // Triangle vertices drawn in one call
 
 void myVec3Transform(float *vecout, float *vecin, float* m);
 
@@ -47,7 +48,7 @@ void myVec3Transform(float *vecout, float *vecin, float* m);
 // to be accessed in faster speed
 extern ALIGN(16, XVECTOR4 g_vtxTransformed[MAX_VERTS])
 extern ALIGN(16, XVECTOR4 g_vecProjected[MAX_VERTS])
-extern float        g_vtxProjected5[1000][5];
+extern float        g_vtxProjected5[MAX_BATCH_VERTICES][5];
 extern float        g_vtxProjected5Clipped[2000][5];
 extern VECTOR2      g_fVtxTxtCoords[MAX_VERTS];
 extern uint32       g_dwVtxDifColor[MAX_VERTS];
@@ -55,13 +56,13 @@ extern uint32       g_dwVtxDifColor[MAX_VERTS];
 
 extern RenderTexture g_textures[MAX_TEXTURES];
 
-extern TLITVERTEX       g_vtxBuffer[1000];
-extern unsigned short   g_vtxIndex[1000];
+extern TLITVERTEX       g_vtxBuffer[MAX_BATCH_VERTICES];
+extern unsigned short   g_vtxIndex[MAX_BATCH_VERTICES];
 
 extern TLITVERTEX       g_clippedVtxBuffer[2000];
 extern int              g_clippedVtxCount;
 
-extern uint8            g_oglVtxColors[1000][4];
+extern uint8            g_oglVtxColors[MAX_BATCH_VERTICES][4];
 extern uint32           g_clipFlag[MAX_VERTS];
 extern uint32           g_clipFlag2[MAX_VERTS];
 extern float            g_fFogCoord[MAX_VERTS];
@@ -83,11 +84,9 @@ extern EXTERNAL_VERTEX  g_vtxForExternal[MAX_VERTS];
 
 extern uint32             gRSPnumLights;
 extern Light              gRSPlights[16];
-extern ALIGN(16, Matrix   gRSPworldProjectTransported)
 extern ALIGN(16, Matrix   gRSPworldProject)
 extern N64Light           gRSPn64lights[16];
 extern ALIGN(16, Matrix   gRSPmodelViewTop)
-extern ALIGN(16, Matrix   gRSPmodelViewTopTranspose)
 extern float              gRSPfFogMin;
 extern float              gRSPfFogMax;
 extern float              gRSPfFogDivider;
@@ -239,9 +238,7 @@ void InitVertexTextureConstants();
 bool PrepareTriangle(uint32 dwV0, uint32 dwV1, uint32 dwV2);
 bool IsTriangleVisible(uint32 dwV0, uint32 dwV1, uint32 dwV2);
 extern void (*ProcessVertexData)(uint32 dwAddr, uint32 dwV0, uint32 dwNum);
-#if !defined(NO_ASM)
 void ProcessVertexDataSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum);
-#endif
 void ProcessVertexDataNoSSE(uint32 dwAddr, uint32 dwV0, uint32 dwNum);
 void ProcessVertexDataExternal(uint32 dwAddr, uint32 dwV0, uint32 dwNum);
 void SetPrimitiveColor(uint32 dwCol, uint32 LODMin, uint32 LODFrac);
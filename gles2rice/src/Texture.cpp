@@ -37,6 +37,7 @@ CTexture::CTexture(uint32 dwWidth, uint32 dwHeight, TextureUsage usage) :
     m_bClampedS(false),
     m_bClampedT(false),
     m_bIsEnhancedTexture(false),
+    m_dwRefCount(1),
     m_Usage(usage),
         m_pTexture(NULL),
         m_dwTextureFmt(TEXTURE_FMT_A8R8G8B8)
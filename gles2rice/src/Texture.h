@@ -74,6 +74,8 @@ public:
     bool        m_bClampedT;
 
     bool        m_bIsEnhancedTexture;
+
+    uint32      m_dwRefCount;   // Cache entries using this texture
     
     TextureUsage    m_Usage;
 
@@ -74,6 +74,7 @@ inline int GetNextPrime(int nFirst)
 CTextureManager::CTextureManager() :
     m_pHead(NULL),
     m_pCacheTxtrList(NULL),
+    m_pSharedTxtrList(NULL),
     m_numOfCachedTxtrList(809)
 {
     m_numOfCachedTxtrList = GetNextPrime(800);
@@ -83,9 +84,13 @@ CTextureManager::CTextureManager() :
     m_pOldestTexture            = NULL;
 
     m_pCacheTxtrList = new TxtrCacheEntry *[m_numOfCachedTxtrList];
+    m_pSharedTxtrList = new TxtrCacheEntry *[m_numOfCachedTxtrList];
 
     for (uint32 i = 0; i < m_numOfCachedTxtrList; i++)
+    {
         m_pCacheTxtrList[i] = NULL;
+        m_pSharedTxtrList[i] = NULL;
+    }
 
     memset(&m_blackTextureEntry, 0, sizeof(TxtrCacheEntry));
     memset(&m_PrimColorTextureEntry, 0, sizeof(TxtrCacheEntry));
@@ -100,6 +105,8 @@ CTextureManager::~CTextureManager()
 
     delete []m_pCacheTxtrList;
     m_pCacheTxtrList = NULL;    
+    delete []m_pSharedTxtrList;
+    m_pSharedTxtrList = NULL;
 }
 
 
@@ -255,6 +262,8 @@ void CTextureManager::RecycleTexture(TxtrCacheEntry *pEntry)
     if (g_bUseSetTextureMem)
         return;
 
+    RemoveSharedTexture(pEntry);
+
     if( CDeviceBuilder::GetGeneralDeviceType() == OGL_DEVICE )
     {
         // Fix me, why I can not reuse the texture in OpenGL,
@@ -263,9 +272,9 @@ void CTextureManager::RecycleTexture(TxtrCacheEntry *pEntry)
         return;
     }
 
-    if (pEntry->pTexture == NULL)
+    if (pEntry->pTexture == NULL || pEntry->pTexture->m_dwRefCount > 1)
     {
-        // No point in saving!
+        // No point in saving, or other entries still draw with it
         delete pEntry;
     }
     else
@@ -313,6 +322,108 @@ uint32 CTextureManager::Hash(uint32 dwValue)
     return (dwValue>>2) % m_numOfCachedTxtrList;
 }
 
+uint32 CTextureManager::SharedHash(uint32 dwCRC, uint32 dwPalCRC)
+{
+    return (dwCRC ^ (dwPalCRC * 0x9E3779B1)) % m_numOfCachedTxtrList;
+}
+
+// Entries whose texels were converted in this texture, by content
+void CTextureManager::AddSharedTexture(TxtrCacheEntry *pEntry)
+{
+    if (m_pSharedTxtrList == NULL || pEntry->bInSharedList || pEntry->pTexture == NULL)
+        return;
+
+    uint32 dwKey = SharedHash(pEntry->dwCRC, pEntry->dwPalCRC);
+
+    pEntry->pNextShared = m_pSharedTxtrList[dwKey];
+    m_pSharedTxtrList[dwKey] = pEntry;
+    pEntry->bInSharedList = true;
+}
+
+void CTextureManager::RemoveSharedTexture(TxtrCacheEntry *pEntry)
+{
+    if (m_pSharedTxtrList == NULL || !pEntry->bInSharedList)
+        return;
+
+    TxtrCacheEntry **p = &m_pSharedTxtrList[SharedHash(pEntry->dwCRC, pEntry->dwPalCRC)];
+
+    while (*p)
+    {
+        if (*p == pEntry)
+        {
+            *p = pEntry->pNextShared;
+            break;
+        }
+        p = &(*p)->pNextShared;
+    }
+
+    pEntry->pNextShared = NULL;
+    pEntry->bInSharedList = false;
+}
+
+// An entry whose texture would be converted from the same texels, with the same
+// palette, sizes and tile modes, as the texture described by pti
+TxtrCacheEntry * CTextureManager::FindSharedTexture(TxtrInfo * pti, uint32 dwCRC, uint32 dwPalCRC)
+{
+    if (m_pSharedTxtrList == NULL)
+        return NULL;
+
+    // The palette CRC only covers CI and 4/8 bit RGBA textures
+    bool bPalHashed = pti->Format == TXT_FMT_CI || (pti->Format == TXT_FMT_RGBA && pti->Size <= TXT_SIZE_8b);
+
+    for (TxtrCacheEntry *pEntry = m_pSharedTxtrList[SharedHash(dwCRC, dwPalCRC)]; pEntry; pEntry = pEntry->pNextShared)
+    {
+        TxtrInfo &ti = pEntry->ti;
+
+        // The RDRAM bytes are word swapped, so the conversion also depends on the address alignment
+        if (pEntry->dwCRC == dwCRC && pEntry->dwPalCRC == dwPalCRC &&
+            (ti.Address & 7) == (pti->Address & 7) &&
+            ti.WidthToLoad == pti->WidthToLoad &&
+            ti.HeightToLoad == pti->HeightToLoad &&
+            ti.WidthToCreate == pti->WidthToCreate &&
+            ti.HeightToCreate == pti->HeightToCreate &&
+            ti.LeftToLoad == pti->LeftToLoad &&
+            ti.TopToLoad == pti->TopToLoad &&
+            ti.Pitch == pti->Pitch &&
+            ti.Format == pti->Format &&
+            ti.Size == pti->Size &&
+            ti.TLutFmt == pti->TLutFmt &&
+            ti.Palette == pti->Palette &&
+            (bPalHashed || ti.PalAddress == pti->PalAddress) &&
+            ti.bSwapped == pti->bSwapped &&
+            ti.maskS == pti->maskS &&
+            ti.maskT == pti->maskT &&
+            ti.mirrorS == pti->mirrorS &&
+            ti.mirrorT == pti->mirrorT &&
+            ti.clampS == pti->clampS &&
+            ti.clampT == pti->clampT )
+        {
+            return pEntry;
+        }
+    }
+
+    return NULL;
+}
+
+// Gives pEntry a texture of its own before its texels are converted again
+void CTextureManager::UnshareTexture(TxtrCacheEntry *pEntry)
+{
+    if (pEntry->pTexture == NULL || pEntry->pTexture->m_dwRefCount == 1)
+        return;
+
+    pEntry->pTexture->m_dwRefCount--;
+    pEntry->pTexture = CDeviceBuilder::GetBuilder()->CreateTexture(pEntry->ti.WidthToCreate, pEntry->ti.HeightToCreate);
+    if (pEntry->pTexture == NULL || pEntry->pTexture->GetTexture() == NULL)
+    {
+        TRACE2("Warning, unable to create %d x %d texture!", pEntry->ti.WidthToCreate, pEntry->ti.HeightToCreate);
+    }
+    else
+    {
+        pEntry->pTexture->m_bScaledS = false;
+        pEntry->pTexture->m_bScaledT = false;
+    }
+}
+
 void CTextureManager::MakeTextureYoungest(TxtrCacheEntry *pEntry)
 {
     if (!g_bUseSetTextureMem)
@@ -452,11 +563,23 @@ void CTextureManager::RemoveTexture(TxtrCacheEntry * pEntry)
     }
 }
     
-TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWidth, uint32 dwHeight)
+TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWidth, uint32 dwHeight, CTexture *pSharedTexture)
 {
     TxtrCacheEntry * pEntry = NULL;
 
-    if (g_bUseSetTextureMem)
+    if (pSharedTexture)
+    {
+        pEntry = new TxtrCacheEntry;
+        if (pEntry == NULL)
+        {
+            _VIDEO_DisplayTemporaryMessage("Error to create an texture entry");
+            return NULL;
+        }
+
+        pEntry->pTexture = pSharedTexture;
+        pSharedTexture->m_dwRefCount++;
+    }
+    else if (g_bUseSetTextureMem)
     {
         uint32 widthToCreate = dwWidth;
         uint32 heightToCreate = dwHeight;
@@ -482,7 +605,7 @@ TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWi
     pEntry = ReviveTexture(dwWidth, dwHeight);
     }
 
-    if (pEntry == NULL || g_bUseSetTextureMem)
+    if (pEntry == NULL || (g_bUseSetTextureMem && pSharedTexture == NULL))
     {
         // Couldn't find on - recreate!
         pEntry = new TxtrCacheEntry;
@@ -510,6 +633,8 @@ TxtrCacheEntry * CTextureManager::CreateNewCacheEntry(uint32 dwAddr, uint32 dwWi
     pEntry->pNext = NULL;
     pEntry->pNextYoungest = NULL;
     pEntry->pLastYoungest = NULL;
+    pEntry->pNextShared = NULL;
+    pEntry->bInSharedList = false;
     pEntry->dwUses = 0;
     pEntry->dwTimeLastUsed = status.gRDPTime;
     pEntry->dwCRC = 0;
@@ -677,6 +802,38 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
         }
     }
 
+    // Tile textures loaded straight from RDRAM can share the texture of identical
+    // texels loaded before, when their CRC covers every byte
+    bool bShareable = options.bShareTextures && doCRCCheck && AutoExtendTexture && !loadFromTextureBuffer &&
+        !g_bUseSetTextureMem && IsRDRAMCRCExact() &&
+        !(options.bUseFullTMEM && fromTMEM && status.bAllowLoadFromTMEM) && gRDP.tiles[7].dwFormat != TXT_FMT_YUV;
+
+    if (pEntry == NULL && bShareable)
+    {
+        TxtrCacheEntry *pShared = FindSharedTexture(pgti, dwAsmCRC, dwPalCRC);
+        if (pShared)
+        {
+            pEntry = CreateNewCacheEntry(pgti->Address, pgti->WidthToCreate, pgti->HeightToCreate, pShared->pTexture);
+            if (pEntry)
+            {
+                pEntry->ti = *pgti;
+                pEntry->dwCRC = dwAsmCRC;
+                pEntry->dwPalCRC = dwPalCRC;
+                pEntry->maxCI = maxCI;
+                pEntry->dwEnhancementFlag = TEXTURE_NO_ENHANCEMENT;
+                pEntry->FrameLastUpdated = status.gDlistCount;
+                AddSharedTexture(pEntry);
+                status.dwNumTexturesShared++;
+                LOG_TEXTURE(TRACE0("   Share texture of identical texels:\n"));
+
+                pEntry->lastEntry = g_lastTextureEntry;
+                g_lastTextureEntry = pEntry;
+                lastEntryModified = true;
+                return pEntry;
+            }
+        }
+    }
+
     if (pEntry == NULL)
     {
         // We need to create a new entry, and add it
@@ -691,6 +848,10 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
         }
     }
 
+    // The texels are converted again, other entries keep the old ones
+    RemoveSharedTexture(pEntry);
+    UnshareTexture(pEntry);
+
     pEntry->ti = *pgti;
     pEntry->dwCRC = dwAsmCRC;
     pEntry->dwPalCRC = dwPalCRC;
@@ -761,6 +922,9 @@ TxtrCacheEntry * CTextureManager::GetTexture(TxtrInfo * pgti, bool fromTMEM, boo
           ExpandTextureT(pEntry);
        }
 
+       if( bShareable && dwType != TEXTURE_FMT_UNKNOWN )
+          AddSharedTexture(pEntry);
+
 #ifdef DEBUGGER
        if( pauseAtNext && eventToPause == NEXT_NEW_TEXTURE )
        {
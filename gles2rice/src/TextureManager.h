@@ -130,11 +130,14 @@ public:
 typedef struct TxtrCacheEntry
 {
     TxtrCacheEntry():
-        pTexture(NULL),pEnhancedTexture(NULL),txtrBufIdx(0) {}
+        pNextShared(NULL),bInSharedList(false),pTexture(NULL),pEnhancedTexture(NULL),txtrBufIdx(0) {}
 
     ~TxtrCacheEntry()
     {
-        SAFE_DELETE(pTexture);
+        // pTexture may be shared with entries of identical texels
+        if (pTexture && --pTexture->m_dwRefCount == 0)
+            delete pTexture;
+        pTexture = NULL;
         SAFE_DELETE(pEnhancedTexture);
     }
     
@@ -143,6 +146,9 @@ typedef struct TxtrCacheEntry
     struct TxtrCacheEntry *pNextYoungest;
     struct TxtrCacheEntry *pLastYoungest;
 
+    struct TxtrCacheEntry *pNextShared; // Next entry in the same content hash bucket
+    bool        bInSharedList;
+
     TxtrInfo ti;
     uint32      dwCRC;
     uint32      dwPalCRC;
@@ -170,12 +176,17 @@ typedef struct TxtrCacheEntry
 class CTextureManager
 {
 protected:
-    TxtrCacheEntry * CreateNewCacheEntry(uint32 dwAddr, uint32 dwWidth, uint32 dwHeight);
+    TxtrCacheEntry * CreateNewCacheEntry(uint32 dwAddr, uint32 dwWidth, uint32 dwHeight, CTexture *pSharedTexture = NULL);
     void AddTexture(TxtrCacheEntry *pEntry);
     void RemoveTexture(TxtrCacheEntry * pEntry);
     void RecycleTexture(TxtrCacheEntry *pEntry);
     TxtrCacheEntry * ReviveTexture( uint32 width, uint32 height );
     TxtrCacheEntry * GetTxtrCacheEntry(TxtrInfo * pti);
+
+    void AddSharedTexture(TxtrCacheEntry *pEntry);
+    void RemoveSharedTexture(TxtrCacheEntry *pEntry);
+    TxtrCacheEntry * FindSharedTexture(TxtrInfo * pti, uint32 dwCRC, uint32 dwPalCRC);
+    void UnshareTexture(TxtrCacheEntry *pEntry);
     
     void ConvertTexture(TxtrCacheEntry * pEntry, bool fromTMEM);
     void ConvertTexture_16(TxtrCacheEntry * pEntry, bool fromTMEM);
@@ -201,6 +212,7 @@ protected:
         int arrayWidth, int flag, int mask, int mirror, int clamp, uint32 otherSize);
 
     uint32 Hash(uint32 dwValue);
+    uint32 SharedHash(uint32 dwCRC, uint32 dwPalCRC);
     bool TCacheEntryIsLoaded(TxtrCacheEntry *pEntry);
 
     void updateColorTexture(CTexture *ptexture, uint32 color);
@@ -213,6 +225,7 @@ public:
 protected:
     TxtrCacheEntry * m_pHead;
     TxtrCacheEntry ** m_pCacheTxtrList;
+    TxtrCacheEntry ** m_pSharedTxtrList;   // Same entries, hashed by texel and palette CRC
     uint32 m_numOfCachedTxtrList;
 
     TxtrCacheEntry m_blackTextureEntry;
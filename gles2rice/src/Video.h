@@ -88,6 +88,9 @@ typedef struct {
     uint32  DPCycleCount;       // Count how many CPU cycles DP used in this DLIST
 
     uint32  dwNumTrisRendered;
+    uint32  dwNumDrawCalls;         // Draw calls of this frame
+    uint32  dwNumTrisDrawn;         // Triangles of these draw calls
+    uint32  dwNumTexturesShared;    // Texture loads of this frame that used an identical texture
     uint32  dwNumDListsCulled;
     uint32  dwNumTrisClipped;
     uint32  dwNumVertices;
@@ -43,8 +43,10 @@
 #include <math.h>
 #include "3dmath.h"
 
-#ifndef NOSSE
-#include <xmmintrin.h>
+#if !defined(NOSSE)
+#include <emmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
 #endif
 
 void calc_light (VERTEX *v)
@@ -208,6 +210,183 @@ void MulMatricesC(float m1[4][4],float m2[4][4],float r[4][4])
    }
 }
 
+// Generic vertex kernels. The SIMD versions below finish the last n & 3
+// vertices of a batch with these, starting at vertex i.
+static void load_vertices_range(VERTEX *v, VERTEX_BATCH *b, uint32_t addr, int i, int n, int lit)
+{
+   for (; i < n; i++)
+   {
+      uint32_t a = addr + (i << 4);
+      b->x[i] = (float)((short*)gfx.RDRAM)[((a >> 1) + 0)^1];
+      b->y[i] = (float)((short*)gfx.RDRAM)[((a >> 1) + 1)^1];
+      b->z[i] = (float)((short*)gfx.RDRAM)[((a >> 1) + 2)^1];
+      v[i].flags = ((uint16_t*)gfx.RDRAM)[((a >> 1) + 3)^1];
+      v[i].ou = (float)((short*)gfx.RDRAM)[((a >> 1) + 4)^1];
+      v[i].ov = (float)((short*)gfx.RDRAM)[((a >> 1) + 5)^1];
+      v[i].uv_scaled = 0;
+      v[i].a = ((uint8_t*)gfx.RDRAM)[(a + 15)^3];
+      if (lit)
+      {
+         v[i].vec[0] = ((int8_t*)gfx.RDRAM)[(a + 12)^3];
+         v[i].vec[1] = ((int8_t*)gfx.RDRAM)[(a + 13)^3];
+         v[i].vec[2] = ((int8_t*)gfx.RDRAM)[(a + 14)^3];
+      }
+      else
+      {
+         v[i].r = ((uint8_t*)gfx.RDRAM)[(a + 12)^3];
+         v[i].g = ((uint8_t*)gfx.RDRAM)[(a + 13)^3];
+         v[i].b = ((uint8_t*)gfx.RDRAM)[(a + 14)^3];
+      }
+   }
+}
+
+static void transform_vertices_range(VERTEX *v, VERTEX_BATCH *b, int i, int n, float mat[4][4], const VERTEX *origin, uint32_t flags)
+{
+   for (; i < n; i++)
+   {
+      VERTEX *vtx = &v[i];
+      float x = b->x[i], y = b->y[i], z = b->z[i];
+
+      vtx->x = x*mat[0][0] + y*mat[1][0] + z*mat[2][0] + mat[3][0];
+      vtx->y = x*mat[0][1] + y*mat[1][1] + z*mat[2][1] + mat[3][1];
+      vtx->z = x*mat[0][2] + y*mat[1][2] + z*mat[2][2] + mat[3][2];
+      vtx->w = x*mat[0][3] + y*mat[1][3] + z*mat[2][3] + mat[3][3];
+
+      if (origin)
+      {
+         vtx->x += origin->x;
+         vtx->y += origin->y;
+         vtx->z += origin->z;
+         vtx->w += origin->w;
+      }
+
+      if (fabs(vtx->w) < 0.001) vtx->w = 0.001f;
+      vtx->oow = 1.0f / vtx->w;
+      vtx->x_w = vtx->x * vtx->oow;
+      vtx->y_w = vtx->y * vtx->oow;
+      vtx->z_w = vtx->z * vtx->oow;
+      if (flags & VTX_FOG)
+         CalculateFog (vtx);
+
+      vtx->uv_calculated = 0xFFFFFFFF;
+      vtx->screen_translated = 0;
+      vtx->shade_mod = 0;
+
+      vtx->scr_off = 0;
+      if (vtx->x < -vtx->w) vtx->scr_off |= 1;
+      if (vtx->x > vtx->w) vtx->scr_off |= 2;
+      if (vtx->y < -vtx->w) vtx->scr_off |= 4;
+      if (vtx->y > vtx->w) vtx->scr_off |= 8;
+      if (vtx->w < 0.1f) vtx->scr_off |= 16;
+      if ((flags & VTX_CLIP_Z) && fabs(vtx->z_w) > 1.0) vtx->scr_off |= 32;
+   }
+}
+
+static void light_vertices_range(VERTEX *v, int i, int n)
+{
+   for (; i < n; i++)
+   {
+      NormalizeVector (v[i].vec);
+      calc_light (&v[i]);
+   }
+}
+
+static void LoadVerticesC(VERTEX *v, VERTEX_BATCH *b, uint32_t addr, int n, int lit)
+{
+   load_vertices_range(v, b, addr, 0, n, lit);
+}
+
+static void TransformVerticesC(VERTEX *v, VERTEX_BATCH *b, int n, float mat[4][4], const VERTEX *origin, uint32_t flags)
+{
+   transform_vertices_range(v, b, 0, n, mat, origin, flags);
+}
+
+static void LightVerticesC(VERTEX *v, int n)
+{
+   light_vertices_range(v, 0, n);
+}
+
+#if !defined(NOSSE) || defined(HAVE_NEON)
+// Results of four transformed vertices, scattered into the VERTEX array
+// by store_vertex_lanes()
+typedef struct
+{
+   DECLAREALIGN16VAR(x[4]);
+   DECLAREALIGN16VAR(y[4]);
+   DECLAREALIGN16VAR(z[4]);
+   DECLAREALIGN16VAR(w[4]);
+   DECLAREALIGN16VAR(oow[4]);
+   DECLAREALIGN16VAR(x_w[4]);
+   DECLAREALIGN16VAR(y_w[4]);
+   DECLAREALIGN16VAR(z_w[4]);
+   DECLAREALIGN16VAR(f[4]);
+   int32_t a[4];
+   int32_t scr_off[4];
+} VERTEX_LANES;
+
+// fog: 0 = leave f alone, 1 = fog disabled, 2 = fog enabled (see CalculateFog)
+static INLINE void store_vertex_lanes(VERTEX *v, const VERTEX_LANES *l, int fog)
+{
+   int k;
+   for (k = 0; k < 4; k++)
+   {
+      v[k].x = l->x[k];
+      v[k].y = l->y[k];
+      v[k].z = l->z[k];
+      v[k].w = l->w[k];
+      v[k].oow = l->oow[k];
+      v[k].x_w = l->x_w[k];
+      v[k].y_w = l->y_w[k];
+      v[k].z_w = l->z_w[k];
+      if (fog == 2)
+      {
+         v[k].f = l->f[k];
+         v[k].a = (uint8_t)l->a[k];
+      }
+      else if (fog == 1)
+         v[k].f = 1.0f;
+      v[k].uv_calculated = 0xFFFFFFFF;
+      v[k].screen_translated = 0;
+      v[k].shade_mod = 0;
+      v[k].scr_off = l->scr_off[k];
+   }
+}
+
+// Per-vertex fields of four F3D vertices whose position and st were
+// already split out: w1 holds z:flags, w3 the color/normal bytes.
+static INLINE void store_loaded_lanes(VERTEX *v, const float *s, const float *t, const uint32_t *w1, const uint32_t *w3, int lit)
+{
+   int k;
+   for (k = 0; k < 4; k++)
+   {
+      v[k].flags = (uint16_t)w1[k];
+      v[k].ou = s[k];
+      v[k].ov = t[k];
+      v[k].uv_scaled = 0;
+      v[k].a = (uint8_t)w3[k];
+      if (lit)
+      {
+         v[k].vec[0] = (int8_t)(w3[k] >> 24);
+         v[k].vec[1] = (int8_t)(w3[k] >> 16);
+         v[k].vec[2] = (int8_t)(w3[k] >> 8);
+      }
+      else
+      {
+         v[k].r = (uint8_t)(w3[k] >> 24);
+         v[k].g = (uint8_t)(w3[k] >> 16);
+         v[k].b = (uint8_t)(w3[k] >> 8);
+      }
+   }
+}
+
+static INLINE int vertex_fog_mode(uint32_t flags)
+{
+   if (!(flags & VTX_FOG))
+      return 0;
+   return (rdp.flags & FOG_ENABLED) ? 2 : 1;
+}
+#endif
+
 // 2011-01-03 Balrog - removed because is in NASM format and not 64-bit compatible
 // This will need fixing.
 MULMATRIX MulMatrices = MulMatricesC;
@@ -215,6 +394,9 @@ TRANSFORMVECTOR TransformVector = TransformVectorC;
 TRANSFORMVECTOR InverseTransformVector = InverseTransformVectorC;
 DOTPRODUCT DotProduct = DotProductC;
 NORMALIZEVECTOR NormalizeVector = NormalizeVectorC;
+LOADVERTICES LoadVertices = LoadVerticesC;
+TRANSFORMVERTICES TransformVertices = TransformVerticesC;
+LIGHTVERTICES LightVertices = LightVerticesC;
 
 #if !defined(NOSSE)
 // 2008.03.29 H.Morii - added SSE 3DNOW! 3x3 1x3 matrix multiplication
@@ -245,6 +427,191 @@ void MulMatricesSSE(float m1[4][4],float m2[4][4],float r[4][4])
       __builtin_ia32_storeups(r[i], destrow);
    }
 }
+
+static void LoadVerticesSSE2(VERTEX *v, VERTEX_BATCH *b, uint32_t addr, int n, int lit)
+{
+   int i = 0;
+
+   // RDRAM is stored as native 32 bit words, so a word aligned vertex is
+   // four words: x:y, z:flags, s:t and r:g:b:a
+   if (!(addr & 3))
+   {
+      for (; i + 4 <= n; i += 4)
+      {
+         const __m128i *src = (const __m128i*)(gfx.RDRAM + addr + (i << 4));
+         __m128 w0 = _mm_castsi128_ps(_mm_loadu_si128(src + 0));
+         __m128 w1 = _mm_castsi128_ps(_mm_loadu_si128(src + 1));
+         __m128 w2 = _mm_castsi128_ps(_mm_loadu_si128(src + 2));
+         __m128 w3 = _mm_castsi128_ps(_mm_loadu_si128(src + 3));
+         __m128i xy, zf, st;
+         DECLAREALIGN16VAR(s[4]);
+         DECLAREALIGN16VAR(t[4]);
+         uint32_t flags[4], color[4];
+
+         _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+         xy = _mm_castps_si128(w0);
+         zf = _mm_castps_si128(w1);
+         st = _mm_castps_si128(w2);
+
+         _mm_store_ps(b->x + i, _mm_cvtepi32_ps(_mm_srai_epi32(xy, 16)));
+         _mm_store_ps(b->y + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(xy, 16), 16)));
+         _mm_store_ps(b->z + i, _mm_cvtepi32_ps(_mm_srai_epi32(zf, 16)));
+         _mm_store_ps(s, _mm_cvtepi32_ps(_mm_srai_epi32(st, 16)));
+         _mm_store_ps(t, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(st, 16), 16)));
+         _mm_storeu_si128((__m128i*)flags, zf);
+         _mm_storeu_si128((__m128i*)color, _mm_castps_si128(w3));
+
+         store_loaded_lanes(&v[i], s, t, flags, color, lit);
+      }
+   }
+   load_vertices_range(v, b, addr, i, n, lit);
+}
+
+static void TransformVerticesSSE(VERTEX *v, VERTEX_BATCH *b, int n, float mat[4][4], const VERTEX *origin, uint32_t flags)
+{
+   int i = 0, j, k;
+   int fog = vertex_fog_mode(flags);
+   __m128 m[4][4], org[4];
+   const __m128 sign = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 one = _mm_set1_ps(1.0f);
+   const __m128 w_min = _mm_set1_ps(0.001f);
+   const __m128 w_clip = _mm_set1_ps(0.1f);
+   const __m128 fog_max = _mm_set1_ps(255.0f);
+   const __m128 fog_mul = _mm_set1_ps(rdp.fog_multiplier);
+   const __m128 fog_off = _mm_set1_ps(rdp.fog_offset);
+   VERTEX_LANES out;
+
+   // A billboard origin inside the batch changes while it is transformed
+   if (origin >= v && origin < v + n)
+   {
+      transform_vertices_range(v, b, 0, n, mat, origin, flags);
+      return;
+   }
+
+   for (j = 0; j < 4; j++)
+      for (k = 0; k < 4; k++)
+         m[j][k] = _mm_set1_ps(mat[j][k]);
+   if (origin)
+   {
+      org[0] = _mm_set1_ps(origin->x);
+      org[1] = _mm_set1_ps(origin->y);
+      org[2] = _mm_set1_ps(origin->z);
+      org[3] = _mm_set1_ps(origin->w);
+   }
+
+   for (; i + 4 <= n; i += 4)
+   {
+      __m128 x = _mm_load_ps(b->x + i);
+      __m128 y = _mm_load_ps(b->y + i);
+      __m128 z = _mm_load_ps(b->z + i);
+      __m128 px = x*m[0][0] + y*m[1][0] + z*m[2][0] + m[3][0];
+      __m128 py = x*m[0][1] + y*m[1][1] + z*m[2][1] + m[3][1];
+      __m128 pz = x*m[0][2] + y*m[1][2] + z*m[2][2] + m[3][2];
+      __m128 pw = x*m[0][3] + y*m[1][3] + z*m[2][3] + m[3][3];
+      __m128 small, oow, zw, neg_w;
+      __m128i off;
+
+      if (origin)
+      {
+         px += org[0];
+         py += org[1];
+         pz += org[2];
+         pw += org[3];
+      }
+
+      small = _mm_cmplt_ps(_mm_andnot_ps(sign, pw), w_min);
+      pw = _mm_or_ps(_mm_and_ps(small, w_min), _mm_andnot_ps(small, pw));
+      oow = one / pw;
+      zw = pz * oow;
+
+      _mm_store_ps(out.x, px);
+      _mm_store_ps(out.y, py);
+      _mm_store_ps(out.z, pz);
+      _mm_store_ps(out.w, pw);
+      _mm_store_ps(out.oow, oow);
+      _mm_store_ps(out.x_w, px * oow);
+      _mm_store_ps(out.y_w, py * oow);
+      _mm_store_ps(out.z_w, zw);
+
+      if (fog == 2)
+      {
+         __m128 f = _mm_min_ps(fog_max, _mm_max_ps(zero, zw * fog_mul + fog_off));
+         f = _mm_andnot_ps(_mm_cmplt_ps(pw, zero), f);
+         _mm_store_ps(out.f, f);
+         _mm_storeu_si128((__m128i*)out.a, _mm_cvttps_epi32(f));
+      }
+
+      neg_w = _mm_xor_ps(pw, sign);
+      off =                    _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(px, neg_w)), _mm_set1_epi32(1));
+      off = _mm_or_si128(off, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(px, pw)), _mm_set1_epi32(2)));
+      off = _mm_or_si128(off, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(py, neg_w)), _mm_set1_epi32(4)));
+      off = _mm_or_si128(off, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(py, pw)), _mm_set1_epi32(8)));
+      off = _mm_or_si128(off, _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(pw, w_clip)), _mm_set1_epi32(16)));
+      if (flags & VTX_CLIP_Z)
+         off = _mm_or_si128(off, _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(_mm_andnot_ps(sign, zw), one)), _mm_set1_epi32(32)));
+      _mm_storeu_si128((__m128i*)out.scr_off, off);
+
+      store_vertex_lanes(&v[i], &out, fog);
+   }
+   transform_vertices_range(v, b, i, n, mat, origin, flags);
+}
+
+static void LightVerticesSSE(VERTEX *v, int n)
+{
+   int i = 0, k;
+   uint32_t l;
+   const __m128 zero = _mm_setzero_ps();
+   const __m128 one = _mm_set1_ps(1.0f);
+
+   for (; i + 4 <= n; i += 4)
+   {
+      __m128 nx = _mm_setr_ps(v[i].vec[0], v[i+1].vec[0], v[i+2].vec[0], v[i+3].vec[0]);
+      __m128 ny = _mm_setr_ps(v[i].vec[1], v[i+1].vec[1], v[i+2].vec[1], v[i+3].vec[1]);
+      __m128 nz = _mm_setr_ps(v[i].vec[2], v[i+1].vec[2], v[i+2].vec[2], v[i+3].vec[2]);
+      __m128 len = nx*nx + ny*ny + nz*nz;
+      __m128 nonzero = _mm_cmpneq_ps(len, zero);
+      __m128 root = _mm_sqrt_ps(len);
+      __m128 r = _mm_set1_ps(rdp.light[rdp.num_lights].r);
+      __m128 g = _mm_set1_ps(rdp.light[rdp.num_lights].g);
+      __m128 bl = _mm_set1_ps(rdp.light[rdp.num_lights].b);
+      DECLAREALIGN16VAR(vec[3][4]);
+      int32_t color[3][4];
+
+      nx = _mm_or_ps(_mm_and_ps(nonzero, nx / root), _mm_andnot_ps(nonzero, nx));
+      ny = _mm_or_ps(_mm_and_ps(nonzero, ny / root), _mm_andnot_ps(nonzero, ny));
+      nz = _mm_or_ps(_mm_and_ps(nonzero, nz / root), _mm_andnot_ps(nonzero, nz));
+
+      for (l = 0; l < rdp.num_lights; l++)
+      {
+         __m128 intensity = _mm_set1_ps(rdp.light_vector[l][0])*nx
+                          + _mm_set1_ps(rdp.light_vector[l][1])*ny
+                          + _mm_set1_ps(rdp.light_vector[l][2])*nz;
+         intensity = _mm_and_ps(_mm_cmpgt_ps(intensity, zero), intensity);
+         r  += _mm_set1_ps(rdp.light[l].r) * intensity;
+         g  += _mm_set1_ps(rdp.light[l].g) * intensity;
+         bl += _mm_set1_ps(rdp.light[l].b) * intensity;
+      }
+
+      _mm_store_ps(vec[0], nx);
+      _mm_store_ps(vec[1], ny);
+      _mm_store_ps(vec[2], nz);
+      _mm_storeu_si128((__m128i*)color[0], _mm_cvttps_epi32(_mm_min_ps(r, one) * _mm_set1_ps(255.0f)));
+      _mm_storeu_si128((__m128i*)color[1], _mm_cvttps_epi32(_mm_min_ps(g, one) * _mm_set1_ps(255.0f)));
+      _mm_storeu_si128((__m128i*)color[2], _mm_cvttps_epi32(_mm_min_ps(bl, one) * _mm_set1_ps(255.0f)));
+
+      for (k = 0; k < 4; k++)
+      {
+         v[i+k].vec[0] = vec[0][k];
+         v[i+k].vec[1] = vec[1][k];
+         v[i+k].vec[2] = vec[2][k];
+         v[i+k].r = (uint8_t)color[0][k];
+         v[i+k].g = (uint8_t)color[1][k];
+         v[i+k].b = (uint8_t)color[2][k];
+      }
+   }
+   light_vertices_range(v, i, n);
+}
 #elif defined(HAVE_NEON)
 static float DotProductNeon(float *v0, float *v1)
 {
@@ -264,8 +631,299 @@ static float DotProductNeon(float *v0, float *v1)
         );
    return dot;
 }
+
+// ARMv7 NEON has no divide or square root, refine the estimates instead
+static INLINE float32x4_t neon_reciprocal(float32x4_t x)
+{
+#ifdef __aarch64__
+   return vdivq_f32(vdupq_n_f32(1.0f), x);
+#else
+   float32x4_t r = vrecpeq_f32(x);
+   r = vmulq_f32(vrecpsq_f32(x, r), r);
+   return vmulq_f32(vrecpsq_f32(x, r), r);
+#endif
+}
+
+static INLINE float32x4_t neon_rsqrt(float32x4_t x)
+{
+#ifdef __aarch64__
+   return vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(x));
+#else
+   float32x4_t r = vrsqrteq_f32(x);
+   r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+   return vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, r), r), r);
+#endif
+}
+
+static void LoadVerticesNeon(VERTEX *v, VERTEX_BATCH *b, uint32_t addr, int n, int lit)
+{
+   int i = 0;
+
+   // RDRAM is stored as native 32 bit words, so a word aligned vertex is
+   // four words: x:y, z:flags, s:t and r:g:b:a
+   if (!(addr & 3))
+   {
+      for (; i + 4 <= n; i += 4)
+      {
+         uint32x4x4_t w = vld4q_u32((const uint32_t*)(gfx.RDRAM + addr + (i << 4)));
+         int32x4_t xy = vreinterpretq_s32_u32(w.val[0]);
+         int32x4_t st = vreinterpretq_s32_u32(w.val[2]);
+         DECLAREALIGN16VAR(s[4]);
+         DECLAREALIGN16VAR(t[4]);
+         uint32_t flags[4], color[4];
+
+         vst1q_f32(b->x + i, vcvtq_f32_s32(vshrq_n_s32(xy, 16)));
+         vst1q_f32(b->y + i, vcvtq_f32_s32(vshrq_n_s32(vshlq_n_s32(xy, 16), 16)));
+         vst1q_f32(b->z + i, vcvtq_f32_s32(vshrq_n_s32(vreinterpretq_s32_u32(w.val[1]), 16)));
+         vst1q_f32(s, vcvtq_f32_s32(vshrq_n_s32(st, 16)));
+         vst1q_f32(t, vcvtq_f32_s32(vshrq_n_s32(vshlq_n_s32(st, 16), 16)));
+         vst1q_u32(flags, w.val[1]);
+         vst1q_u32(color, w.val[3]);
+
+         store_loaded_lanes(&v[i], s, t, flags, color, lit);
+      }
+   }
+   load_vertices_range(v, b, addr, i, n, lit);
+}
+
+static void TransformVerticesNeon(VERTEX *v, VERTEX_BATCH *b, int n, float mat[4][4], const VERTEX *origin, uint32_t flags)
+{
+   int i = 0, j, k;
+   int fog = vertex_fog_mode(flags);
+   float32x4_t m[4][4], org[4];
+   const float32x4_t zero = vdupq_n_f32(0.0f);
+   const float32x4_t one = vdupq_n_f32(1.0f);
+   const float32x4_t w_min = vdupq_n_f32(0.001f);
+   const float32x4_t w_clip = vdupq_n_f32(0.1f);
+   const float32x4_t fog_max = vdupq_n_f32(255.0f);
+   const float32x4_t fog_mul = vdupq_n_f32(rdp.fog_multiplier);
+   const float32x4_t fog_off = vdupq_n_f32(rdp.fog_offset);
+   VERTEX_LANES out;
+
+   // A billboard origin inside the batch changes while it is transformed
+   if (origin >= v && origin < v + n)
+   {
+      transform_vertices_range(v, b, 0, n, mat, origin, flags);
+      return;
+   }
+
+   for (j = 0; j < 4; j++)
+      for (k = 0; k < 4; k++)
+         m[j][k] = vdupq_n_f32(mat[j][k]);
+   if (origin)
+   {
+      org[0] = vdupq_n_f32(origin->x);
+      org[1] = vdupq_n_f32(origin->y);
+      org[2] = vdupq_n_f32(origin->z);
+      org[3] = vdupq_n_f32(origin->w);
+   }
+
+   for (; i + 4 <= n; i += 4)
+   {
+      float32x4_t x = vld1q_f32(b->x + i);
+      float32x4_t y = vld1q_f32(b->y + i);
+      float32x4_t z = vld1q_f32(b->z + i);
+      float32x4_t p[4], oow, zw, neg_w;
+      uint32x4_t off;
+
+      // separate multiplies and adds, so the sums round like the C version
+      for (k = 0; k < 4; k++)
+      {
+         p[k] = vaddq_f32(vmulq_f32(x, m[0][k]), vmulq_f32(y, m[1][k]));
+         p[k] = vaddq_f32(p[k], vmulq_f32(z, m[2][k]));
+         p[k] = vaddq_f32(p[k], m[3][k]);
+         if (origin)
+            p[k] = vaddq_f32(p[k], org[k]);
+      }
+
+      p[3] = vbslq_f32(vcltq_f32(vabsq_f32(p[3]), w_min), w_min, p[3]);
+      oow = neon_reciprocal(p[3]);
+      zw = vmulq_f32(p[2], oow);
+
+      vst1q_f32(out.x, p[0]);
+      vst1q_f32(out.y, p[1]);
+      vst1q_f32(out.z, p[2]);
+      vst1q_f32(out.w, p[3]);
+      vst1q_f32(out.oow, oow);
+      vst1q_f32(out.x_w, vmulq_f32(p[0], oow));
+      vst1q_f32(out.y_w, vmulq_f32(p[1], oow));
+      vst1q_f32(out.z_w, zw);
+
+      if (fog == 2)
+      {
+         float32x4_t f = vminq_f32(fog_max, vmaxq_f32(zero, vaddq_f32(vmulq_f32(zw, fog_mul), fog_off)));
+         f = vbslq_f32(vcltq_f32(p[3], zero), zero, f);
+         vst1q_f32(out.f, f);
+         vst1q_s32(out.a, vcvtq_s32_f32(f));
+      }
+
+      neg_w = vnegq_f32(p[3]);
+      off =                vandq_u32(vcltq_f32(p[0], neg_w), vdupq_n_u32(1));
+      off = vorrq_u32(off, vandq_u32(vcgtq_f32(p[0], p[3]), vdupq_n_u32(2)));
+      off = vorrq_u32(off, vandq_u32(vcltq_f32(p[1], neg_w), vdupq_n_u32(4)));
+      off = vorrq_u32(off, vandq_u32(vcgtq_f32(p[1], p[3]), vdupq_n_u32(8)));
+      off = vorrq_u32(off, vandq_u32(vcltq_f32(p[3], w_clip), vdupq_n_u32(16)));
+      if (flags & VTX_CLIP_Z)
+         off = vorrq_u32(off, vandq_u32(vcgtq_f32(vabsq_f32(zw), one), vdupq_n_u32(32)));
+      vst1q_s32(out.scr_off, vreinterpretq_s32_u32(off));
+
+      store_vertex_lanes(&v[i], &out, fog);
+   }
+   transform_vertices_range(v, b, i, n, mat, origin, flags);
+}
+
+static void LightVerticesNeon(VERTEX *v, int n)
+{
+   int i = 0, k;
+   uint32_t l;
+   const float32x4_t zero = vdupq_n_f32(0.0f);
+   const float32x4_t one = vdupq_n_f32(1.0f);
+   const float32x4_t scale = vdupq_n_f32(255.0f);
+
+   for (; i + 4 <= n; i += 4)
+   {
+      DECLAREALIGN16VAR(vec[3][4]);
+      int32_t color[3][4];
+      float32x4_t nx, ny, nz, len, inv, r, g, bl;
+      uint32x4_t nonzero;
+
+      for (k = 0; k < 4; k++)
+      {
+         vec[0][k] = v[i+k].vec[0];
+         vec[1][k] = v[i+k].vec[1];
+         vec[2][k] = v[i+k].vec[2];
+      }
+      nx = vld1q_f32(vec[0]);
+      ny = vld1q_f32(vec[1]);
+      nz = vld1q_f32(vec[2]);
+
+      len = vaddq_f32(vaddq_f32(vmulq_f32(nx, nx), vmulq_f32(ny, ny)), vmulq_f32(nz, nz));
+      nonzero = vmvnq_u32(vceqq_f32(len, zero));
+      inv = neon_rsqrt(len);
+      nx = vbslq_f32(nonzero, vmulq_f32(nx, inv), nx);
+      ny = vbslq_f32(nonzero, vmulq_f32(ny, inv), ny);
+      nz = vbslq_f32(nonzero, vmulq_f32(nz, inv), nz);
+
+      r = vdupq_n_f32(rdp.light[rdp.num_lights].r);
+      g = vdupq_n_f32(rdp.light[rdp.num_lights].g);
+      bl = vdupq_n_f32(rdp.light[rdp.num_lights].b);
+      for (l = 0; l < rdp.num_lights; l++)
+      {
+         float32x4_t intensity = vmulq_n_f32(nx, rdp.light_vector[l][0]);
+         intensity = vaddq_f32(intensity, vmulq_n_f32(ny, rdp.light_vector[l][1]));
+         intensity = vaddq_f32(intensity, vmulq_n_f32(nz, rdp.light_vector[l][2]));
+         intensity = vbslq_f32(vcgtq_f32(intensity, zero), intensity, zero);
+         r = vaddq_f32(r, vmulq_n_f32(intensity, rdp.light[l].r));
+         g = vaddq_f32(g, vmulq_n_f32(intensity, rdp.light[l].g));
+         bl = vaddq_f32(bl, vmulq_n_f32(intensity, rdp.light[l].b));
+      }
+
+      vst1q_f32(vec[0], nx);
+      vst1q_f32(vec[1], ny);
+      vst1q_f32(vec[2], nz);
+      vst1q_s32(color[0], vcvtq_s32_f32(vmulq_f32(vminq_f32(r, one), scale)));
+      vst1q_s32(color[1], vcvtq_s32_f32(vmulq_f32(vminq_f32(g, one), scale)));
+      vst1q_s32(color[2], vcvtq_s32_f32(vmulq_f32(vminq_f32(bl, one), scale)));
+
+      for (k = 0; k < 4; k++)
+      {
+         v[i+k].vec[0] = vec[0][k];
+         v[i+k].vec[1] = vec[1][k];
+         v[i+k].vec[2] = vec[2][k];
+         v[i+k].r = (uint8_t)color[0][k];
+         v[i+k].g = (uint8_t)color[1][k];
+         v[i+k].b = (uint8_t)color[2][k];
+      }
+   }
+   light_vertices_range(v, i, n);
+}
 #endif
 
+#define CHECK_VERTICES 23
+
+static int close_enough(float a, float b)
+{
+   return fabs(a - b) <= 1e-4 * max(1.0, fabs(b));
+}
+
+// Runs a synthetic, partly clipped, fogged and lit batch through the selected
+// vertex kernels and the generic ones. Returns 0 if they disagree by more
+// than rounding noise (the NEON kernels use refined estimates for 1/x).
+static int vertex_kernels_match(void)
+{
+   static float mat[4][4] = {
+      {  0.9f,  0.1f,  0.05f, 0.05f },
+      { -0.1f,  0.8f,  0.02f, 0.03f },
+      {  0.04f,-0.03f, 0.7f,  0.4f  },
+      { 10.0f,-20.0f, 30.0f, 40.0f  } };
+   static VERTEX_BATCH batch;
+   VERTEX simd[CHECK_VERTICES], ref[CHECK_VERTICES];
+   uint32_t saved_flags = rdp.flags, saved_num_lights = rdp.num_lights;
+   float saved_fog[2] = { rdp.fog_multiplier, rdp.fog_offset };
+   LIGHT saved_light[3];
+   float saved_vector[2][3];
+   uint32_t seed = 64;
+   int i, ok = 1;
+
+   memcpy(saved_light, rdp.light, sizeof(saved_light));
+   memcpy(saved_vector, rdp.light_vector, sizeof(saved_vector));
+   rdp.flags |= FOG_ENABLED;
+   rdp.fog_multiplier = 128.0f;
+   rdp.fog_offset = -16.0f;
+   rdp.num_lights = 2;
+   for (i = 0; i < 3; i++)
+   {
+      rdp.light[i].r = 0.2f + 0.3f * i;
+      rdp.light[i].g = 0.7f - 0.2f * i;
+      rdp.light[i].b = 0.4f;
+   }
+   rdp.light_vector[0][0] = 0.6f;  rdp.light_vector[0][1] = 0.8f;  rdp.light_vector[0][2] = 0.0f;
+   rdp.light_vector[1][0] = 0.0f;  rdp.light_vector[1][1] = -0.6f; rdp.light_vector[1][2] = 0.8f;
+
+   memset(simd, 0, sizeof(simd));
+   for (i = 0; i < CHECK_VERTICES; i++)
+   {
+      seed = seed * 1103515245 + 12345;
+      batch.x[i] = (float)((int)(seed >> 16 & 0x7FF) - 1024);
+      seed = seed * 1103515245 + 12345;
+      batch.y[i] = (float)((int)(seed >> 16 & 0x7FF) - 1024);
+      seed = seed * 1103515245 + 12345;
+      batch.z[i] = (float)((int)(seed >> 16 & 0x7FF) - 1024);
+      simd[i].vec[0] = (float)(int8_t)(seed >> 8);
+      simd[i].vec[1] = (float)(int8_t)(seed >> 16);
+      simd[i].vec[2] = (float)(int8_t)(seed >> 24);
+   }
+   simd[5].vec[0] = simd[5].vec[1] = simd[5].vec[2] = 0.0f;
+   memcpy(ref, simd, sizeof(ref));
+
+   TransformVertices(simd, &batch, CHECK_VERTICES, mat, NULL, VTX_FOG | VTX_CLIP_Z);
+   LightVertices(simd, CHECK_VERTICES);
+   TransformVerticesC(ref, &batch, CHECK_VERTICES, mat, NULL, VTX_FOG | VTX_CLIP_Z);
+   LightVerticesC(ref, CHECK_VERTICES);
+
+   for (i = 0; i < CHECK_VERTICES; i++)
+   {
+      if (!close_enough(simd[i].x, ref[i].x) || !close_enough(simd[i].y, ref[i].y) ||
+          !close_enough(simd[i].z, ref[i].z) || !close_enough(simd[i].w, ref[i].w) ||
+          !close_enough(simd[i].oow, ref[i].oow) || !close_enough(simd[i].z_w, ref[i].z_w) ||
+          !close_enough(simd[i].x_w, ref[i].x_w) || !close_enough(simd[i].y_w, ref[i].y_w) ||
+          !close_enough(simd[i].f, ref[i].f) || !close_enough(simd[i].vec[0], ref[i].vec[0]) ||
+          !close_enough(simd[i].vec[1], ref[i].vec[1]) || !close_enough(simd[i].vec[2], ref[i].vec[2]) ||
+          abs(simd[i].a - ref[i].a) > 1 || abs(simd[i].r - ref[i].r) > 1 ||
+          abs(simd[i].g - ref[i].g) > 1 || abs(simd[i].b - ref[i].b) > 1 ||
+          simd[i].scr_off != ref[i].scr_off)
+         ok = 0;
+   }
+
+   rdp.flags = saved_flags;
+   rdp.num_lights = saved_num_lights;
+   rdp.fog_multiplier = saved_fog[0];
+   rdp.fog_offset = saved_fog[1];
+   memcpy(rdp.light, saved_light, sizeof(saved_light));
+   memcpy(rdp.light_vector, saved_vector, sizeof(saved_vector));
+   return ok;
+}
+
 void math_init(void)
 {
    unsigned cpu = 0;
@@ -277,6 +935,9 @@ void math_init(void)
    if (cpu & RETRO_SIMD_SSE2)
    {
       MulMatrices = MulMatricesSSE;
+      LoadVertices = LoadVerticesSSE2;
+      TransformVertices = TransformVerticesSSE;
+      LightVertices = LightVerticesSSE;
       if (log_cb)
          log_cb(RETRO_LOG_INFO, "SSE detected, using (some) optimized math functions.\n");
    }
@@ -284,9 +945,21 @@ void math_init(void)
    if (cpu & RETRO_SIMD_NEON)
    {
       DotProduct = DotProductNeon;
+      LoadVertices = LoadVerticesNeon;
+      TransformVertices = TransformVerticesNeon;
+      LightVertices = LightVerticesNeon;
       if (log_cb)
          log_cb(RETRO_LOG_INFO, "NEON detected, using (some) optimized math functions.\n");
    }
 #endif
+
+   if (TransformVertices != TransformVerticesC && !vertex_kernels_match())
+   {
+      LoadVertices = LoadVerticesC;
+      TransformVertices = TransformVerticesC;
+      LightVertices = LightVerticesC;
+      if (log_cb)
+         log_cb(RETRO_LOG_WARN, "SIMD vertex pipeline disagrees with the C version, disabled.\n");
+   }
 }
 
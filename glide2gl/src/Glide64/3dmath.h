@@ -41,6 +41,20 @@ void calc_light (VERTEX *v);
 void calc_linear (VERTEX *v);
 void calc_sphere (VERTEX *v);
 
+// Untransformed vertex positions, kept as separate x/y/z arrays so the
+// vertex kernels below can work on four vertices at a time.
+// Entry i belongs to the i-th VERTEX passed to the kernels.
+typedef struct
+{
+   DECLAREALIGN16VAR(x[MAX_VTX]);
+   DECLAREALIGN16VAR(y[MAX_VTX]);
+   DECLAREALIGN16VAR(z[MAX_VTX]);
+} VERTEX_BATCH;
+
+// TransformVertices flags
+#define VTX_FOG     0x1   // CalculateFog() every vertex
+#define VTX_CLIP_Z  0x2   // set scr_off bit 32 when |z_w| > 1 (DKR)
+
 void math_init();
 
 typedef void (*MULMATRIX)(float m1[4][4],float m2[4][4],float r[4][4]); 
@@ -52,3 +66,16 @@ typedef float (*DOTPRODUCT)(register float *v1, register float *v2);
 extern DOTPRODUCT DotProduct;
 typedef void (*NORMALIZEVECTOR)(float *v);
 extern NORMALIZEVECTOR NormalizeVector;
+
+// Reads n vertices in the 16 byte F3D layout from RDRAM at addr: positions
+// go to the batch, flags/st/alpha to v, and either the color or, when lit,
+// the normal.
+typedef void (*LOADVERTICES)(VERTEX *v, VERTEX_BATCH *b, uint32_t addr, int n, int lit);
+extern LOADVERTICES LoadVertices;
+// Transforms the batch by mat into v: clip space position (plus origin's,
+// for billboards), w clamp, 1/w, projected xyz, scr_off and optionally fog.
+typedef void (*TRANSFORMVERTICES)(VERTEX *v, VERTEX_BATCH *b, int n, float mat[4][4], const VERTEX *origin, uint32_t flags);
+extern TRANSFORMVERTICES TransformVertices;
+// NormalizeVector + calc_light for n vertices
+typedef void (*LIGHTVERTICES)(VERTEX *v, int n);
+extern LIGHTVERTICES LightVertices;
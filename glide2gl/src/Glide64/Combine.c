@@ -6959,6 +6959,7 @@ static void cc_env_inter_one_using__one_sub_t0_mul_primlod ()
          GR_CMBX_DETAIL_FACTOR, 0,
          GR_CMBX_ZERO, 0);
    cmb.tex_ccolor = rand()&0xFFFFFF00;
+   dlist_cache_abort();
    cmb.tex |= 1;
    percent = (float)(lod_frac) / 255.0f;
    cmb.dc0_detailmax = cmb.dc1_detailmax = percent;
@@ -13467,6 +13468,19 @@ static COMBINER alpha_cmb_list[] =
    // { #ACEND }
 };
 
+#define COMBINE_CACHE_BITS 7
+
+typedef struct
+{
+   uint32_t key;
+   int valid;
+   COMBINER *entry;
+} COMBINE_CACHE;
+
+static COMBINE_CACHE cc_cache[1 << COMBINE_CACHE_BITS];
+static COMBINE_CACHE ac_cache[1 << COMBINE_CACHE_BITS];
+uint32_t combine_cache_hits, combine_cache_misses;
+
 // CountCombine - count the # of entries in the combine lists
 void CountCombine(void)
 {
@@ -13504,6 +13518,56 @@ void CountCombine(void)
 
    //color_cmb_list_count = sizeof(color_cmb_list) >> 3; // #bytes/4/2
    //alpha_cmb_list_count = sizeof(alpha_cmb_list) >> 3;
+
+   memset(cc_cache, 0, sizeof(cc_cache));
+   memset(ac_cache, 0, sizeof(ac_cache));
+   combine_cache_hits = combine_cache_misses = 0;
+}
+
+// Binary search of one bucket of a combine list, NULL if the mode isn't there
+static COMBINER *SearchCombine(COMBINER *list, const uint32_t *bucket, uint32_t actual_combine)
+{
+   int current=0x7FFFFFFF, last;
+   int left = bucket[0], right = bucket[1];
+   uint32_t current_combine = 0;
+
+   while (1)
+   {
+      last = current;
+      current = left + ((right-left) >> 1);
+      if (current == last)
+         break;  // can't be found!
+
+      current_combine = list[current].key;
+      if (current_combine < actual_combine)
+         left = current;
+      else if (current_combine > actual_combine)
+         right = current;
+      else
+         break;  // found it!
+   }
+
+   return (current_combine == actual_combine) ? &list[current] : NULL;
+}
+
+// Most frames only switch between a handful of combine modes, so remember
+// where the search ended for the recent ones. Only the list entry is cached,
+// its cc_/ac_ function still runs since it reads the current colors and tiles.
+static COMBINER *FindCombine(COMBINE_CACHE *cache, COMBINER *list, const uint32_t *bucket, uint32_t actual_combine)
+{
+   COMBINE_CACHE *slot = &cache[(actual_combine * 2654435761u) >> (32 - COMBINE_CACHE_BITS)];
+
+   if (slot->valid && slot->key == actual_combine)
+   {
+      combine_cache_hits++;
+      return slot->entry;
+   }
+
+   combine_cache_misses++;
+   slot->key = actual_combine;
+   slot->entry = SearchCombine(list, bucket, actual_combine);
+   slot->valid = 1;
+   return slot->entry;
 }
 
 //****************************************************************
@@ -13563,36 +13627,18 @@ void Combine(void)
 
 #ifdef FASTSEARCH
    // Fast, ordered search
-   int current=0x7FFFFFFF, last;
-   uint32_t actual_combine, current_combine, color_combine, alpha_combine;
-   int left, right;
+   uint32_t actual_combine, color_combine, alpha_combine;
+   COMBINER *entry;
 
    actual_combine = cmb_mode_c;
    color_combine = actual_combine;
    if ((rdp.cycle2 & 0xFFFF) == 0x1FFF)
       actual_combine = (rdp.cycle1 << 16) | (rdp.cycle1 & 0xFFFF);
 
-   left = cc_lookup[actual_combine>>24];
-   right = cc_lookup[(actual_combine>>24)+1];
-
-   while (1)
-   {
-      last = current;
-      current = left + ((right-left) >> 1);
-      if (current == last)
-         break;  // can't be found!
-
-      current_combine = color_cmb_list[current].key;
-      if (current_combine < actual_combine)
-         left = current;
-      else if (current_combine > actual_combine)
-         right = current;
-      else
-         break;  // found it!
-   }
+   entry = FindCombine(cc_cache, color_cmb_list, &cc_lookup[actual_combine>>24], actual_combine);
 
    // Check if we didn't find it
-   if (actual_combine != current_combine)
+   if (entry == NULL)
    {
       rdp.uncombined |= 1;
 #ifdef UNIMP_LOG
@@ -13612,12 +13658,11 @@ void Combine(void)
       cc_t0 ();
    }
    else
-      color_cmb_list[current].func();
+      entry->func();
 
    LRDP(" | |- Color done\n");
 
    // Now again for alpha
-   current = 0x7FFFFFFF;
    actual_combine = cmb_mode_a;
    alpha_combine = actual_combine;
    if ((rdp.cycle2 & 0x0FFF0000) == 0x01FF0000)
@@ -13625,29 +13670,12 @@ void Combine(void)
    if ((rdp.cycle1 & 0x0FFF0000) == 0x0FFF0000)
       actual_combine = (rdp.cycle2 & 0x0FFF0000) | ((rdp.cycle2 >> 16) & 0x00000FFF);
 
-   left = ac_lookup[(actual_combine>>20)&0xFF];
-   right = ac_lookup[((actual_combine>>20)&0xFF)+1];
-
-   while (1)
-   {
-      last = current;
-      current = left + ((right-left) >> 1);
-      if (current == last)
-         break;  // can't be found!
-
-      current_combine = alpha_cmb_list[current].key;
-      if (current_combine < actual_combine)
-         left = current;
-      else if (current_combine > actual_combine)
-         right = current;
-      else
-         break;  // found it!
-   }
+   entry = FindCombine(ac_cache, alpha_cmb_list, &ac_lookup[(actual_combine>>20)&0xFF], actual_combine);
 
    // Check if we didn't find it
-   if (actual_combine != current_combine || !found)
+   if (entry == NULL || !found)
    {
-      if (actual_combine != current_combine)
+      if (entry == NULL)
       {
          rdp.uncombined |= 2;
 #ifdef UNIMP_LOG
@@ -13673,7 +13701,7 @@ void Combine(void)
       //tex |= 3;
    }
    else
-      alpha_cmb_list[current].func();
+      entry->func();
 
 
    if (color_combine == 0x69351fff) //text, PD, need to change texture alpha
@@ -101,6 +101,7 @@ typedef struct
 } COMBINE;
 
 extern COMBINE cmb;
+extern uint32_t combine_cache_hits, combine_cache_misses;
 
 void Combine(void);
 void CombineBlender(void);
@@ -0,0 +1,712 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+* Copyright (c) 2002  Dave2001
+* Copyright (c) 2003-2009  Sergey 'Gonetz' Lipski
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+//****************************************************************
+//
+// Glide64 - Glide Plugin for Nintendo 64 emulators
+// Project started on December 29th, 2001
+//
+// Authors:
+// Dave2001, original author, founded the project in 2001, left it in 2002
+// Gugaman, joined the project in 2002, left it in 2002
+// Sergey 'Gonetz' Lipski, joined the project in 2002, main author since fall of 2002
+// Hiroshi 'KoolSmoky' Morii, joined the project in 2007
+//
+//****************************************************************
+//
+// To modify Glide64:
+// * Write your name and (optional)email, commented by your work, so I know who did it, and so that you can find which parts you modified when it comes time to send it to me.
+// * Do NOT send me the whole project or file that you modified.  Take out your modified code sections, and tell me where to put them.  If people sent the whole thing, I would have many different versions, but no idea how to combine them all.
+//
+//****************************************************************
+//
+// Display list replay cache
+//
+// A recorded entry holds
+// - the key: the task header in DMEM, the VI registers, the settings and
+//   the texture generation,
+// - the plugin state when the list started and when it ended,
+// - the 4KB RDRAM pages the list read, as they were before it ran, and the
+//   pages it wrote, as they were after it ran,
+// - the Glitch64 calls it made.
+// RDRAM is compared page by page, nothing is hashed, so a replayed list
+// draws exactly what interpreting it again would draw.
+//
+//****************************************************************
+
+// DListCache.c makes the real calls
+#define DLIST_CACHE_NO_WRAPPERS
+
+#include "Gfx_1.3.h"
+#include "Combine.h"
+
+#define DLC_PAGE_SHIFT    12
+#define DLC_PAGE_SIZE     (1 << DLC_PAGE_SHIFT)
+#define DLC_MAX_PAGES     2048            // 8MB of RDRAM
+#define DLC_ENTRY_PAGES   512             // pages read and written by one list
+#define DLC_STREAM_MAX    (4 << 20)       // bytes of recorded calls
+#define DLC_ENTRIES       4
+#define DLC_VI_REGS       13
+#define DLC_RETRY         8               // lists between two tries once they keep missing
+
+#define DLC_PAGE_READ     1
+#define DLC_PAGE_WRITTEN  2
+
+typedef struct
+{
+   int valid;
+   uint32_t last_used;
+
+   // key
+   uint32_t task[16];
+   uint32_t vi[DLC_VI_REGS];
+   uint32_t generation;
+   SETTINGS settings;
+
+   uint8_t *entry_state;
+   uint8_t *exit_state;
+   uint32_t state_size;
+   uint32_t tex_steps;  // how often the list bumped rdp.tex_ctr
+
+   uint16_t *read_pages;
+   uint8_t *read_data;
+   int num_read;
+   uint16_t *write_pages;
+   uint8_t *write_data;
+   int num_write;
+   int pages_alloc;
+
+   uint32_t *stream;
+   uint32_t stream_size;  // in words
+   uint32_t stream_alloc;
+} DLIST_CACHE_ENTRY;
+
+int dlist_cache_recording = 0;
+
+static DLIST_CACHE_ENTRY entries[DLC_ENTRIES];
+static DLIST_CACHE_ENTRY *rec;
+static uint8_t page_state[DLC_MAX_PAGES];
+static uint8_t *cur_state;
+static uint32_t cur_state_size;
+static uint32_t generation;
+static uint32_t swap_generation;
+static uint32_t use_counter;
+static uint32_t rec_tex_ctr;
+static int misses;
+
+extern uint32_t lod_frac;
+
+static uint32_t state_size(const DLIST_CACHE_STATE *state, int count)
+{
+   uint32_t size = sizeof(rdp) + MAX_VTX * sizeof(VERTEX) + sizeof(cmb) + sizeof(lod_frac);
+   int i;
+   for (i = 0; i < count; i++)
+      size += state[i].size;
+   return size;
+}
+
+// rdp.tex_ctr counts up forever, so the snapshot keeps it out and only
+// notes for each vertex if its texture coordinates are up to date
+static void save_state(uint8_t *dst, const DLIST_CACHE_STATE *state, int count)
+{
+   struct RDP *r = (struct RDP*)dst;
+   VERTEX *v;
+   int i;
+
+   memcpy(dst, &rdp, sizeof(rdp));
+   r->tex_ctr = 0;
+   dst += sizeof(rdp);
+
+   v = (VERTEX*)dst;
+   memcpy(v, rdp.vtx, MAX_VTX * sizeof(VERTEX));
+   for (i = 0; i < MAX_VTX; i++)
+      v[i].uv_calculated = (v[i].uv_calculated == rdp.tex_ctr);
+   dst += MAX_VTX * sizeof(VERTEX);
+
+   memcpy(dst, &cmb, sizeof(cmb));
+   dst += sizeof(cmb);
+   memcpy(dst, &lod_frac, sizeof(lod_frac));
+   dst += sizeof(lod_frac);
+
+   for (i = 0; i < count; i++)
+   {
+      memcpy(dst, state[i].ptr, state[i].size);
+      dst += state[i].size;
+   }
+}
+
+static void load_state(const uint8_t *src, const DLIST_CACHE_STATE *state, int count, uint32_t tex_ctr)
+{
+   int i;
+
+   memcpy(&rdp, src, sizeof(rdp));
+   rdp.tex_ctr = tex_ctr;
+   src += sizeof(rdp);
+
+   memcpy(rdp.vtx, src, MAX_VTX * sizeof(VERTEX));
+   for (i = 0; i < MAX_VTX; i++)
+      rdp.vtx[i].uv_calculated = rdp.vtx[i].uv_calculated ? tex_ctr : 0xFFFFFFFF;
+   src += MAX_VTX * sizeof(VERTEX);
+
+   memcpy(&cmb, src, sizeof(cmb));
+   src += sizeof(cmb);
+   memcpy(&lod_frac, src, sizeof(lod_frac));
+   src += sizeof(lod_frac);
+
+   for (i = 0; i < count; i++)
+   {
+      memcpy(state[i].ptr, src, state[i].size);
+      src += state[i].size;
+   }
+}
+
+static void read_key(uint32_t *task, uint32_t *vi)
+{
+   memcpy(task, gfx.DMEM + 0xFC0, 16 * sizeof(uint32_t));
+   vi[0] = *gfx.VI_STATUS_REG;
+   vi[1] = *gfx.VI_ORIGIN_REG;
+   vi[2] = *gfx.VI_WIDTH_REG;
+   vi[3] = *gfx.VI_INTR_REG;
+   vi[4] = *gfx.VI_TIMING_REG;
+   vi[5] = *gfx.VI_V_SYNC_REG;
+   vi[6] = *gfx.VI_H_SYNC_REG;
+   vi[7] = *gfx.VI_LEAP_REG;
+   vi[8] = *gfx.VI_H_START_REG;
+   vi[9] = *gfx.VI_V_START_REG;
+   vi[10] = *gfx.VI_V_BURST_REG;
+   vi[11] = *gfx.VI_X_SCALE_REG;
+   vi[12] = *gfx.VI_Y_SCALE_REG;
+}
+
+static void free_entry(DLIST_CACHE_ENTRY *e)
+{
+   free(e->entry_state);
+   free(e->exit_state);
+   free(e->read_pages);
+   free(e->read_data);
+   free(e->write_pages);
+   free(e->write_data);
+   free(e->stream);
+   memset(e, 0, sizeof(*e));
+}
+
+void dlist_cache_reset(void)
+{
+   int i;
+   dlist_cache_recording = 0;
+   rec = NULL;
+   for (i = 0; i < DLC_ENTRIES; i++)
+      free_entry(&entries[i]);
+   free(cur_state);
+   cur_state = NULL;
+   cur_state_size = 0;
+   misses = 0;
+}
+
+void dlist_cache_invalidate(void)
+{
+   int i;
+   dlist_cache_recording = 0;
+   generation++;
+   for (i = 0; i < DLC_ENTRIES; i++)
+      entries[i].valid = false;
+}
+
+void dlist_cache_abort(void)
+{
+   dlist_cache_recording = 0;
+}
+
+static int grow_pages(DLIST_CACHE_ENTRY *e)
+{
+   int n = e->pages_alloc ? e->pages_alloc * 2 : 16;
+   uint16_t *rp, *wp;
+   uint8_t *rd, *wd;
+
+   if (n > DLC_ENTRY_PAGES)
+      return false;
+   rp = (uint16_t*)realloc(e->read_pages, n * sizeof(uint16_t));
+   if (rp)
+      e->read_pages = rp;
+   wp = (uint16_t*)realloc(e->write_pages, n * sizeof(uint16_t));
+   if (wp)
+      e->write_pages = wp;
+   rd = (uint8_t*)realloc(e->read_data, n * DLC_PAGE_SIZE);
+   if (rd)
+      e->read_data = rd;
+   wd = (uint8_t*)realloc(e->write_data, n * DLC_PAGE_SIZE);
+   if (wd)
+      e->write_data = wd;
+   if (!rp || !wp || !rd || !wd)
+      return false;
+   e->pages_alloc = n;
+   return true;
+}
+
+static int add_read_page(uint32_t page)
+{
+   if (rec->num_read + rec->num_write >= rec->pages_alloc && !grow_pages(rec))
+   {
+      dlist_cache_abort();
+      return false;
+   }
+   rec->read_pages[rec->num_read] = page;
+   memcpy(rec->read_data + rec->num_read * DLC_PAGE_SIZE, gfx.RDRAM + (page << DLC_PAGE_SHIFT), DLC_PAGE_SIZE);
+   rec->num_read++;
+   page_state[page] |= DLC_PAGE_READ;
+   return true;
+}
+
+static int add_write_page(uint32_t page)
+{
+   if (rec->num_read + rec->num_write >= rec->pages_alloc && !grow_pages(rec))
+   {
+      dlist_cache_abort();
+      return false;
+   }
+   // the content is taken when the list ends
+   rec->write_pages[rec->num_write++] = page;
+   page_state[page] |= DLC_PAGE_WRITTEN;
+   return true;
+}
+
+static int clip_range(uint32_t *addr, uint32_t *size)
+{
+   uint32_t end = (uint32_t)BMASK + 1;
+   *addr &= BMASK;
+   if (*size > end - *addr)
+      *size = end - *addr;
+   return *size != 0;
+}
+
+void dlist_cache_read_range(uint32_t addr, uint32_t size)
+{
+   uint32_t page, last;
+
+   if (!clip_range(&addr, &size))
+      return;
+   last = (addr + size - 1) >> DLC_PAGE_SHIFT;
+   for (page = addr >> DLC_PAGE_SHIFT; page <= last; page++)
+   {
+      // the list reads what it drew itself, the pages can't be compared
+      if (page_state[page] & DLC_PAGE_WRITTEN)
+      {
+         dlist_cache_abort();
+         return;
+      }
+      if (!(page_state[page] & DLC_PAGE_READ) && !add_read_page(page))
+         return;
+   }
+}
+
+void dlist_cache_write_range(uint32_t addr, uint32_t size, int overwrite)
+{
+   uint32_t page, last, end;
+
+   if (!clip_range(&addr, &size))
+      return;
+   end = addr + size;
+   last = (end - 1) >> DLC_PAGE_SHIFT;
+   for (page = addr >> DLC_PAGE_SHIFT; page <= last; page++)
+   {
+      uint32_t start = page << DLC_PAGE_SHIFT;
+      if (page_state[page] & DLC_PAGE_WRITTEN)
+         continue;
+      // what is left of a page the list doesn't fully overwrite is an input
+      if (!(overwrite && addr <= start && end >= start + DLC_PAGE_SIZE) &&
+            !(page_state[page] & DLC_PAGE_READ) && !add_read_page(page))
+         return;
+      if (!add_write_page(page))
+         return;
+   }
+}
+
+static uint32_t *stream_alloc(uint32_t words)
+{
+   uint32_t *p;
+   if (rec->stream_size + words > rec->stream_alloc)
+   {
+      uint32_t n = rec->stream_alloc ? rec->stream_alloc * 2 : 16384;
+      while (n < rec->stream_size + words)
+         n *= 2;
+      if (n * sizeof(uint32_t) > DLC_STREAM_MAX || !(p = (uint32_t*)realloc(rec->stream, n * sizeof(uint32_t))))
+      {
+         dlist_cache_abort();
+         return NULL;
+      }
+      rec->stream = p;
+      rec->stream_alloc = n;
+   }
+   p = rec->stream + rec->stream_size;
+   rec->stream_size += words;
+   return p;
+}
+
+void dlist_cache_op(int op, const uint32_t *args, int count)
+{
+   uint32_t *p = stream_alloc(1 + count);
+   if (!p)
+      return;
+   p[0] = op | (count << 8);
+   if (count)
+      memcpy(p + 1, args, count * sizeof(uint32_t));
+}
+
+void dlist_cache_draw(int op, uint32_t count, const VERTEX *v)
+{
+   uint32_t words = (count * sizeof(VERTEX)) >> 2;
+   uint32_t *p;
+
+   // noise is drawn from rand() for every triangle
+   if (rdp.noise != NOISE_MODE_NONE)
+   {
+      dlist_cache_abort();
+      return;
+   }
+   if (!(p = stream_alloc(2 + words)))
+      return;
+   p[0] = op | ((1 + words) << 8);
+   p[1] = count;
+   memcpy(p + 2, v, count * sizeof(VERTEX));
+}
+
+void dlist_cache_triangle(const void *a, const void *b, const void *c)
+{
+   uint32_t words = (3 * sizeof(VERTEX)) >> 2;
+   uint32_t *p;
+
+   if (rdp.noise != NOISE_MODE_NONE)
+   {
+      dlist_cache_abort();
+      return;
+   }
+   if (!(p = stream_alloc(1 + words)))
+      return;
+   p[0] = DLC_DRAW_TRIANGLE | (words << 8);
+   memcpy(p + 1, a, sizeof(VERTEX));
+   memcpy(p + 1 + words / 3, b, sizeof(VERTEX));
+   memcpy(p + 1 + 2 * words / 3, c, sizeof(VERTEX));
+}
+
+void dlist_cache_interrupt(void)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_INTERRUPT, NULL, 0);
+}
+
+// newSwapBuffers is called from inside the list when the game swaps at
+// setcolorimage. The swap itself is replayed as a whole, so what it does
+// is not recorded.
+int dlist_cache_swap_begin(void)
+{
+   if (!dlist_cache_recording)
+      return false;
+   dlist_cache_op(DLC_SWAP, NULL, 0);
+   if (!dlist_cache_recording)
+      return false;
+   dlist_cache_recording = 0;
+   swap_generation = generation;
+   return true;
+}
+
+void dlist_cache_swap_end(int recording)
+{
+   // unless the swap changed texture memory meanwhile
+   if (recording && rec && swap_generation == generation)
+      dlist_cache_recording = 1;
+}
+
+static INLINE float arg_float(uint32_t u)
+{
+   union { uint32_t u; float f; } v;
+   v.u = u;
+   return v.f;
+}
+
+static void replay(const DLIST_CACHE_ENTRY *e)
+{
+   const uint32_t *s = e->stream;
+   const uint32_t *end = e->stream + e->stream_size;
+
+   while (s < end)
+   {
+      uint32_t op = *s & 0xFF;
+      uint32_t words = *s >> 8;
+      s++;
+      switch (op)
+      {
+         case DLC_DRAW_TRIANGLE:
+            grDrawTriangle(s, s + words / 3, s + 2 * words / 3);
+            break;
+         case DLC_DRAW_FAN:
+            {
+               void *pointers[1];
+               pointers[0] = (void*)(s + 1);
+               grDrawVertexArray(GR_TRIANGLE_FAN, s[0], pointers);
+            }
+            break;
+         case DLC_DRAW_STRIP:
+            grDrawVertexArrayContiguous(GR_TRIANGLE_STRIP, s[0], (void*)(s + 1), sizeof(VERTEX));
+            break;
+         case DLC_INTERRUPT:
+            *gfx.MI_INTR_REG |= 0x20;
+            gfx.CheckInterrupts();
+            break;
+         case DLC_SWAP:
+            rdp.updatescreen = 1;
+            newSwapBuffers();
+            break;
+         case DLC_ALPHA_BLEND_FUNCTION:
+            grAlphaBlendFunction(s[0], s[1], s[2], s[3]);
+            break;
+         case DLC_ALPHA_COMBINE:
+            grAlphaCombine(s[0], s[1], s[2], s[3], s[4]);
+            break;
+         case DLC_ALPHA_COMBINE_EXT:
+            grAlphaCombineExt(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9]);
+            break;
+         case DLC_ALPHA_TEST_FUNCTION:
+            grAlphaTestFunction(s[0]);
+            break;
+         case DLC_ALPHA_TEST_REFERENCE:
+            grAlphaTestReferenceValue(s[0]);
+            break;
+         case DLC_BUFFER_CLEAR:
+            grBufferClear(s[0], s[1], s[2]);
+            break;
+         case DLC_CHROMAKEY_MODE:
+            grChromakeyMode(s[0]);
+            break;
+         case DLC_CHROMAKEY_VALUE:
+            grChromakeyValue(s[0]);
+            break;
+         case DLC_CLIP_WINDOW:
+            grClipWindow(s[0], s[1], s[2], s[3]);
+            break;
+         case DLC_COLOR_COMBINE:
+            grColorCombine(s[0], s[1], s[2], s[3], s[4]);
+            break;
+         case DLC_COLOR_COMBINE_EXT:
+            grColorCombineExt(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9]);
+            break;
+         case DLC_COLOR_MASK:
+            grColorMask(s[0], s[1]);
+            break;
+         case DLC_CONSTANT_COLOR:
+            grConstantColorValue(s[0]);
+            break;
+         case DLC_CONSTANT_COLOR_EXT:
+            grConstantColorValueExt(s[0], s[1]);
+            break;
+         case DLC_CONSTANT_COLOR_EXT_ZERO:
+            grConstantColorValueExtZero(s[0], s[1]);
+            break;
+         case DLC_COORDINATE_SPACE:
+            grCoordinateSpace(s[0]);
+            break;
+         case DLC_CULL_MODE:
+            grCullMode(s[0]);
+            break;
+         case DLC_DEPTH_BIAS_LEVEL:
+            grDepthBiasLevel((FxI32)s[0]);
+            break;
+         case DLC_DEPTH_BUFFER_FUNCTION:
+            grDepthBufferFunction(s[0]);
+            break;
+         case DLC_DEPTH_BUFFER_MODE:
+            grDepthBufferMode(s[0]);
+            break;
+         case DLC_DEPTH_MASK:
+            grDepthMask(s[0]);
+            break;
+         case DLC_FOG_COLOR:
+            grFogColorValue(s[0]);
+            break;
+         case DLC_FOG_MODE:
+            grFogMode(s[0]);
+            break;
+         case DLC_RENDER_BUFFER:
+            grRenderBuffer(s[0]);
+            break;
+         case DLC_STIPPLE_MODE:
+            grStippleMode(s[0]);
+            break;
+         case DLC_STIPPLE_PATTERN:
+            grStipplePattern(s[0]);
+            break;
+         case DLC_TEX_ALPHA_COMBINE_EXT:
+            grTexAlphaCombineExt(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10]);
+            break;
+         case DLC_TEX_CLAMP_MODE:
+            grTexClampMode(s[0], s[1], s[2]);
+            break;
+         case DLC_TEX_COLOR_COMBINE_EXT:
+            grTexColorCombineExt(s[0], s[1], s[2], s[3], s[4], s[5], s[6], s[7], s[8], s[9], s[10]);
+            break;
+         case DLC_TEX_COMBINE:
+            grTexCombine(s[0], s[1], s[2], s[3], s[4], s[5], s[6]);
+            break;
+         case DLC_TEX_DETAIL_CONTROL:
+            grTexDetailControl(s[0], (int)s[1], (FxU8)s[2], arg_float(s[3]));
+            break;
+         case DLC_TEX_FILTER_MODE:
+            grTexFilterMode(s[0], s[1], s[2]);
+            break;
+         case DLC_TEX_LOD_BIAS:
+            grTexLodBiasValue(s[0], arg_float(s[1]));
+            break;
+         case DLC_TEX_SOURCE:
+            {
+               GrTexInfo info;
+               memcpy(&info, s + 3, sizeof(info));
+               grTexSource(s[0], s[1], s[2], &info);
+            }
+            break;
+         case DLC_VERTEX_LAYOUT:
+            grVertexLayout(s[0], (FxI32)s[1], s[2]);
+            break;
+      }
+      s += words;
+   }
+}
+
+static int entry_matches(const DLIST_CACHE_ENTRY *e, const uint32_t *task, const uint32_t *vi, uint32_t size)
+{
+   int i;
+
+   if (!e->valid || e->generation != generation || e->state_size != size ||
+         memcmp(e->task, task, sizeof(e->task)) || memcmp(e->vi, vi, sizeof(e->vi)) ||
+         memcmp(&e->settings, &settings, sizeof(settings)) ||
+         memcmp(e->entry_state, cur_state, size))
+      return false;
+   for (i = 0; i < e->num_read; i++)
+      if (memcmp(e->read_data + i * DLC_PAGE_SIZE, gfx.RDRAM + (e->read_pages[i] << DLC_PAGE_SHIFT), DLC_PAGE_SIZE))
+         return false;
+   return true;
+}
+
+int dlist_cache_begin(const DLIST_CACHE_STATE *state, int count)
+{
+   uint32_t task[16], vi[DLC_VI_REGS];
+   uint32_t size = state_size(state, count);
+   DLIST_CACHE_ENTRY *e;
+   int i;
+
+   dlist_cache_recording = 0;
+   rec = NULL;
+
+   if (size != cur_state_size)
+   {
+      free(cur_state);
+      cur_state = (uint8_t*)malloc(size);
+      cur_state_size = cur_state ? size : 0;
+      if (!cur_state)
+         return false;
+   }
+   read_key(task, vi);
+   save_state(cur_state, state, count);
+
+   for (i = 0; i < DLC_ENTRIES; i++)
+   {
+      e = &entries[i];
+      if (entry_matches(e, task, vi, size))
+      {
+         uint32_t tex_ctr = (uint32_t)(((uint64_t)rdp.tex_ctr + e->tex_steps) % 0xFFFFFFFF);
+         e->last_used = ++use_counter;
+         misses = 0;
+         replay(e);
+         for (i = 0; i < e->num_write; i++)
+            memcpy(gfx.RDRAM + (e->write_pages[i] << DLC_PAGE_SHIFT), e->write_data + i * DLC_PAGE_SIZE, DLC_PAGE_SIZE);
+         load_state(e->exit_state, state, count, tex_ctr);
+         return true;
+      }
+   }
+
+   // lists that never repeat aren't recorded every time
+   if (++misses > DLC_RETRY && (misses % DLC_RETRY))
+      return false;
+
+   e = &entries[0];
+   for (i = 0; i < DLC_ENTRIES; i++)
+   {
+      if (!entries[i].valid)
+      {
+         e = &entries[i];
+         break;
+      }
+      if (entries[i].last_used < e->last_used)
+         e = &entries[i];
+   }
+
+   e->valid = false;
+   if (e->state_size != size)
+   {
+      free(e->entry_state);
+      free(e->exit_state);
+      e->entry_state = (uint8_t*)malloc(size);
+      e->exit_state = (uint8_t*)malloc(size);
+      e->state_size = size;
+      if (!e->entry_state || !e->exit_state)
+      {
+         free_entry(e);
+         return false;
+      }
+   }
+   memcpy(e->task, task, sizeof(task));
+   memcpy(e->vi, vi, sizeof(vi));
+   memcpy(&e->settings, &settings, sizeof(settings));
+   memcpy(e->entry_state, cur_state, size);
+   e->generation = generation;
+   e->num_read = e->num_write = 0;
+   e->stream_size = 0;
+
+   memset(page_state, 0, sizeof(page_state));
+   rec = e;
+   rec_tex_ctr = rdp.tex_ctr;
+   dlist_cache_recording = 1;
+   return false;
+}
+
+void dlist_cache_end(const DLIST_CACHE_STATE *state, int count)
+{
+   int i;
+
+   if (!dlist_cache_recording || !rec)
+   {
+      dlist_cache_recording = 0;
+      return;
+   }
+   dlist_cache_recording = 0;
+
+   for (i = 0; i < rec->num_write; i++)
+      memcpy(rec->write_data + i * DLC_PAGE_SIZE, gfx.RDRAM + (rec->write_pages[i] << DLC_PAGE_SHIFT), DLC_PAGE_SIZE);
+   save_state(rec->exit_state, state, count);
+
+   // tex_ctr skips 0xFFFFFFFF, the value of a vertex without texture coordinates
+   if (rdp.tex_ctr >= rec_tex_ctr)
+      rec->tex_steps = rdp.tex_ctr - rec_tex_ctr;
+   else
+      rec->tex_steps = rdp.tex_ctr + (0xFFFFFFFF - rec_tex_ctr);
+
+   rec->last_used = ++use_counter;
+   rec->valid = true;
+   rec = NULL;
+   misses = 0;
+}
@@ -0,0 +1,611 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+* Copyright (c) 2002  Dave2001
+* Copyright (c) 2003-2009  Sergey 'Gonetz' Lipski
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+//****************************************************************
+//
+// Display list replay cache
+//
+// ProcessDList records the Glitch64 calls one display list makes, the
+// RDRAM pages it reads and writes and the plugin state before and after
+// it. When a later display list starts from the same state and reads the
+// same RDRAM, the recorded calls are replayed instead of interpreting the
+// list again. Everything the cache can't follow stops the recording.
+//
+// This header is included by Gfx_1.3.h, so every gr* call of the plugin
+// goes through the wrappers below.
+//
+//****************************************************************
+
+#ifndef DLIST_CACHE_H
+#define DLIST_CACHE_H
+
+// A piece of plugin state that must match before a list is replayed and
+// is restored after it
+typedef struct
+{
+   void *ptr;
+   uint32_t size;
+} DLIST_CACHE_STATE;
+
+extern int dlist_cache_recording;
+
+// Replays the display list if it is cached and returns true, otherwise
+// starts recording it. state lists the rdp.c globals the lists use.
+int dlist_cache_begin(const DLIST_CACHE_STATE *state, int count);
+void dlist_cache_end(const DLIST_CACHE_STATE *state, int count);
+void dlist_cache_abort(void);
+void dlist_cache_reset(void);
+
+// Texture memory changed, no recorded list may be replayed any more
+void dlist_cache_invalidate(void);
+
+void dlist_cache_read_range(uint32_t addr, uint32_t size);
+void dlist_cache_write_range(uint32_t addr, uint32_t size, int overwrite);
+void dlist_cache_interrupt(void);
+int dlist_cache_swap_begin(void);
+void dlist_cache_swap_end(int recording);
+
+// The RDRAM the list reads. Writes that overwrite every byte of the range
+// don't depend on what was there before.
+#define dlist_cache_read(addr, size) \
+   do { if (dlist_cache_recording) dlist_cache_read_range((addr), (size)); } while (0)
+#define dlist_cache_write(addr, size, overwrite) \
+   do { if (dlist_cache_recording) dlist_cache_write_range((addr), (size), (overwrite)); } while (0)
+
+enum
+{
+   DLC_DRAW_TRIANGLE = 1,
+   DLC_DRAW_FAN,
+   DLC_DRAW_STRIP,
+   DLC_INTERRUPT,
+   DLC_SWAP,
+   DLC_ALPHA_BLEND_FUNCTION,
+   DLC_ALPHA_COMBINE,
+   DLC_ALPHA_COMBINE_EXT,
+   DLC_ALPHA_TEST_FUNCTION,
+   DLC_ALPHA_TEST_REFERENCE,
+   DLC_BUFFER_CLEAR,
+   DLC_CHROMAKEY_MODE,
+   DLC_CHROMAKEY_VALUE,
+   DLC_CLIP_WINDOW,
+   DLC_COLOR_COMBINE,
+   DLC_COLOR_COMBINE_EXT,
+   DLC_COLOR_MASK,
+   DLC_CONSTANT_COLOR,
+   DLC_CONSTANT_COLOR_EXT,
+   DLC_CONSTANT_COLOR_EXT_ZERO,
+   DLC_COORDINATE_SPACE,
+   DLC_CULL_MODE,
+   DLC_DEPTH_BIAS_LEVEL,
+   DLC_DEPTH_BUFFER_FUNCTION,
+   DLC_DEPTH_BUFFER_MODE,
+   DLC_DEPTH_MASK,
+   DLC_FOG_COLOR,
+   DLC_FOG_MODE,
+   DLC_RENDER_BUFFER,
+   DLC_STIPPLE_MODE,
+   DLC_STIPPLE_PATTERN,
+   DLC_TEX_ALPHA_COMBINE_EXT,
+   DLC_TEX_CLAMP_MODE,
+   DLC_TEX_COLOR_COMBINE_EXT,
+   DLC_TEX_COMBINE,
+   DLC_TEX_DETAIL_CONTROL,
+   DLC_TEX_FILTER_MODE,
+   DLC_TEX_LOD_BIAS,
+   DLC_TEX_SOURCE,
+   DLC_VERTEX_LAYOUT
+};
+
+void dlist_cache_op(int op, const uint32_t *args, int count);
+void dlist_cache_draw(int op, uint32_t count, const VERTEX *v);
+void dlist_cache_triangle(const void *a, const void *b, const void *c);
+
+static INLINE uint32_t dlist_cache_float(float f)
+{
+   union { float f; uint32_t u; } v;
+   v.f = f;
+   return v.u;
+}
+
+// Recorded calls
+
+static INLINE void dlc_grDrawTriangle(const void *a, const void *b, const void *c)
+{
+   if (dlist_cache_recording)
+      dlist_cache_triangle(a, b, c);
+   grDrawTriangle(a, b, c);
+}
+
+static INLINE void dlc_grDrawVertexArray(FxU32 mode, FxU32 Count, void *pointers)
+{
+   // Glitch64 draws the fan from the vertices the first pointer points to
+   if (dlist_cache_recording)
+      dlist_cache_draw(DLC_DRAW_FAN, Count, *(VERTEX**)pointers);
+   grDrawVertexArray(mode, Count, pointers);
+}
+
+static INLINE void dlc_grDrawVertexArrayContiguous(FxU32 mode, FxU32 Count, void *pointers, FxU32 stride)
+{
+   if (dlist_cache_recording)
+   {
+      if (mode == GR_TRIANGLE_STRIP && stride == sizeof(VERTEX))
+         dlist_cache_draw(DLC_DRAW_STRIP, Count, (VERTEX*)pointers);
+      else
+         dlist_cache_abort();
+   }
+   grDrawVertexArrayContiguous(mode, Count, pointers, stride);
+}
+
+static INLINE void dlc_grAlphaBlendFunction(GrAlphaBlendFnc_t rgb_sf, GrAlphaBlendFnc_t rgb_df,
+      GrAlphaBlendFnc_t alpha_sf, GrAlphaBlendFnc_t alpha_df)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[4] = { rgb_sf, rgb_df, alpha_sf, alpha_df };
+      dlist_cache_op(DLC_ALPHA_BLEND_FUNCTION, a, 4);
+   }
+   grAlphaBlendFunction(rgb_sf, rgb_df, alpha_sf, alpha_df);
+}
+
+static INLINE void dlc_grAlphaCombine(GrCombineFunction_t function, GrCombineFactor_t factor,
+      GrCombineLocal_t local, GrCombineOther_t other, FxBool invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[5] = { function, factor, local, other, invert };
+      dlist_cache_op(DLC_ALPHA_COMBINE, a, 5);
+   }
+   grAlphaCombine(function, factor, local, other, invert);
+}
+
+static INLINE void dlc_grAlphaCombineExt(GrACUColor_t a, GrCombineMode_t a_mode,
+      GrACUColor_t b, GrCombineMode_t b_mode, GrACUColor_t c, FxBool c_invert,
+      GrACUColor_t d, FxBool d_invert, FxU32 shift, FxBool invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t args[10] = { a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert };
+      dlist_cache_op(DLC_ALPHA_COMBINE_EXT, args, 10);
+   }
+   grAlphaCombineExt(a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert);
+}
+
+static INLINE void dlc_grAlphaTestFunction(GrCmpFnc_t function)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_ALPHA_TEST_FUNCTION, (const uint32_t*)&function, 1);
+   grAlphaTestFunction(function);
+}
+
+static INLINE void dlc_grAlphaTestReferenceValue(GrAlpha_t value)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a = value;
+      dlist_cache_op(DLC_ALPHA_TEST_REFERENCE, &a, 1);
+   }
+   grAlphaTestReferenceValue(value);
+}
+
+static INLINE void dlc_grBufferClear(GrColor_t color, GrAlpha_t alpha, FxU32 depth)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[3] = { color, alpha, depth };
+      dlist_cache_op(DLC_BUFFER_CLEAR, a, 3);
+   }
+   grBufferClear(color, alpha, depth);
+}
+
+static INLINE void dlc_grChromakeyMode(GrChromakeyMode_t mode)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_CHROMAKEY_MODE, (const uint32_t*)&mode, 1);
+   grChromakeyMode(mode);
+}
+
+static INLINE void dlc_grChromakeyValue(GrColor_t value)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_CHROMAKEY_VALUE, (const uint32_t*)&value, 1);
+   grChromakeyValue(value);
+}
+
+static INLINE void dlc_grClipWindow(FxU32 minx, FxU32 miny, FxU32 maxx, FxU32 maxy)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[4] = { minx, miny, maxx, maxy };
+      dlist_cache_op(DLC_CLIP_WINDOW, a, 4);
+   }
+   grClipWindow(minx, miny, maxx, maxy);
+}
+
+static INLINE void dlc_grColorCombine(GrCombineFunction_t function, GrCombineFactor_t factor,
+      GrCombineLocal_t local, GrCombineOther_t other, FxBool invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[5] = { function, factor, local, other, invert };
+      dlist_cache_op(DLC_COLOR_COMBINE, a, 5);
+   }
+   grColorCombine(function, factor, local, other, invert);
+}
+
+static INLINE void dlc_grColorCombineExt(GrCCUColor_t a, GrCombineMode_t a_mode,
+      GrCCUColor_t b, GrCombineMode_t b_mode, GrCCUColor_t c, FxBool c_invert,
+      GrCCUColor_t d, FxBool d_invert, FxU32 shift, FxBool invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t args[10] = { a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert };
+      dlist_cache_op(DLC_COLOR_COMBINE_EXT, args, 10);
+   }
+   grColorCombineExt(a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert);
+}
+
+static INLINE void dlc_grColorMask(FxBool rgb, FxBool alpha)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[2] = { rgb, alpha };
+      dlist_cache_op(DLC_COLOR_MASK, a, 2);
+   }
+   grColorMask(rgb, alpha);
+}
+
+static INLINE void dlc_grConstantColorValue(GrColor_t value)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_CONSTANT_COLOR, (const uint32_t*)&value, 1);
+   grConstantColorValue(value);
+}
+
+static INLINE void dlc_grConstantColorValueExt(GrChipID_t tmu, GrColor_t value)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[2] = { tmu, value };
+      dlist_cache_op(DLC_CONSTANT_COLOR_EXT, a, 2);
+   }
+   grConstantColorValueExt(tmu, value);
+}
+
+static INLINE void dlc_grConstantColorValueExtZero(GrChipID_t tmu, GrColor_t value)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[2] = { tmu, value };
+      dlist_cache_op(DLC_CONSTANT_COLOR_EXT_ZERO, a, 2);
+   }
+   grConstantColorValueExtZero(tmu, value);
+}
+
+static INLINE void dlc_grCoordinateSpace(GrCoordinateSpaceMode_t mode)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_COORDINATE_SPACE, (const uint32_t*)&mode, 1);
+   grCoordinateSpace(mode);
+}
+
+static INLINE void dlc_grCullMode(GrCullMode_t mode)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_CULL_MODE, (const uint32_t*)&mode, 1);
+   grCullMode(mode);
+}
+
+static INLINE void dlc_grDepthBiasLevel(FxI32 level)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_DEPTH_BIAS_LEVEL, (const uint32_t*)&level, 1);
+   grDepthBiasLevel(level);
+}
+
+static INLINE void dlc_grDepthBufferFunction(GrCmpFnc_t function)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_DEPTH_BUFFER_FUNCTION, (const uint32_t*)&function, 1);
+   grDepthBufferFunction(function);
+}
+
+static INLINE void dlc_grDepthBufferMode(GrDepthBufferMode_t mode)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_DEPTH_BUFFER_MODE, (const uint32_t*)&mode, 1);
+   grDepthBufferMode(mode);
+}
+
+static INLINE void dlc_grDepthMask(FxBool mask)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_DEPTH_MASK, (const uint32_t*)&mask, 1);
+   grDepthMask(mask);
+}
+
+static INLINE void dlc_grFogColorValue(GrColor_t fogcolor)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_FOG_COLOR, (const uint32_t*)&fogcolor, 1);
+   grFogColorValue(fogcolor);
+}
+
+static INLINE void dlc_grFogMode(GrFogMode_t mode)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_FOG_MODE, (const uint32_t*)&mode, 1);
+   grFogMode(mode);
+}
+
+static INLINE void dlc_grRenderBuffer(GrBuffer_t buffer)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_RENDER_BUFFER, (const uint32_t*)&buffer, 1);
+   grRenderBuffer(buffer);
+}
+
+static INLINE void dlc_grStippleMode(GrStippleMode_t mode)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_STIPPLE_MODE, (const uint32_t*)&mode, 1);
+   grStippleMode(mode);
+}
+
+static INLINE void dlc_grStipplePattern(GrStipplePattern_t pattern)
+{
+   if (dlist_cache_recording)
+      dlist_cache_op(DLC_STIPPLE_PATTERN, (const uint32_t*)&pattern, 1);
+   grStipplePattern(pattern);
+}
+
+static INLINE void dlc_grTexAlphaCombineExt(GrChipID_t tmu, GrTACUColor_t a, GrCombineMode_t a_mode,
+      GrTACUColor_t b, GrCombineMode_t b_mode, GrTACUColor_t c, FxBool c_invert,
+      GrTACUColor_t d, FxBool d_invert, FxU32 shift, FxBool invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t args[11] = { tmu, a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert };
+      dlist_cache_op(DLC_TEX_ALPHA_COMBINE_EXT, args, 11);
+   }
+   grTexAlphaCombineExt(tmu, a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert);
+}
+
+static INLINE void dlc_grTexClampMode(GrChipID_t tmu, GrTextureClampMode_t s_clampmode,
+      GrTextureClampMode_t t_clampmode)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[3] = { tmu, s_clampmode, t_clampmode };
+      dlist_cache_op(DLC_TEX_CLAMP_MODE, a, 3);
+   }
+   grTexClampMode(tmu, s_clampmode, t_clampmode);
+}
+
+static INLINE void dlc_grTexColorCombineExt(GrChipID_t tmu, GrTCCUColor_t a, GrCombineMode_t a_mode,
+      GrTCCUColor_t b, GrCombineMode_t b_mode, GrTCCUColor_t c, FxBool c_invert,
+      GrTCCUColor_t d, FxBool d_invert, FxU32 shift, FxBool invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t args[11] = { tmu, a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert };
+      dlist_cache_op(DLC_TEX_COLOR_COMBINE_EXT, args, 11);
+   }
+   grTexColorCombineExt(tmu, a, a_mode, b, b_mode, c, c_invert, d, d_invert, shift, invert);
+}
+
+static INLINE void dlc_grTexCombine(GrChipID_t tmu, GrCombineFunction_t rgb_function,
+      GrCombineFactor_t rgb_factor, GrCombineFunction_t alpha_function,
+      GrCombineFactor_t alpha_factor, FxBool rgb_invert, FxBool alpha_invert)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[7] = { tmu, rgb_function, rgb_factor, alpha_function, alpha_factor, rgb_invert, alpha_invert };
+      dlist_cache_op(DLC_TEX_COMBINE, a, 7);
+   }
+   grTexCombine(tmu, rgb_function, rgb_factor, alpha_function, alpha_factor, rgb_invert, alpha_invert);
+}
+
+static INLINE void dlc_grTexDetailControl(GrChipID_t tmu, int lod_bias, FxU8 detail_scale, float detail_max)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[4] = { tmu, (uint32_t)lod_bias, detail_scale, dlist_cache_float(detail_max) };
+      dlist_cache_op(DLC_TEX_DETAIL_CONTROL, a, 4);
+   }
+   grTexDetailControl(tmu, lod_bias, detail_scale, detail_max);
+}
+
+static INLINE void dlc_grTexFilterMode(GrChipID_t tmu, GrTextureFilterMode_t minfilter_mode,
+      GrTextureFilterMode_t magfilter_mode)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[3] = { tmu, minfilter_mode, magfilter_mode };
+      dlist_cache_op(DLC_TEX_FILTER_MODE, a, 3);
+   }
+   grTexFilterMode(tmu, minfilter_mode, magfilter_mode);
+}
+
+static INLINE void dlc_grTexLodBiasValue(GrChipID_t tmu, float bias)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[2] = { tmu, dlist_cache_float(bias) };
+      dlist_cache_op(DLC_TEX_LOD_BIAS, a, 2);
+   }
+   grTexLodBiasValue(tmu, bias);
+}
+
+static INLINE void dlc_grTexSource(GrChipID_t tmu, FxU32 startAddress, FxU32 evenOdd, GrTexInfo *info)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[3 + (sizeof(GrTexInfo) + 3) / 4];
+      a[0] = tmu;
+      a[1] = startAddress;
+      a[2] = evenOdd;
+      memcpy(a + 3, info, sizeof(GrTexInfo));
+      dlist_cache_op(DLC_TEX_SOURCE, a, sizeof(a) / 4);
+   }
+   grTexSource(tmu, startAddress, evenOdd, info);
+}
+
+static INLINE void dlc_grVertexLayout(FxU32 param, FxI32 offset, FxU32 mode)
+{
+   if (dlist_cache_recording)
+   {
+      uint32_t a[3] = { param, (uint32_t)offset, mode };
+      dlist_cache_op(DLC_VERTEX_LAYOUT, a, 3);
+   }
+   grVertexLayout(param, offset, mode);
+}
+
+// Calls that change texture memory or read back what was drawn, a list
+// making them is never cached
+
+static INLINE void dlc_grTexDownloadMipMap(GrChipID_t tmu, FxU32 startAddress, FxU32 evenOdd, GrTexInfo *info)
+{
+   dlist_cache_invalidate();
+   grTexDownloadMipMap(tmu, startAddress, evenOdd, info);
+}
+
+static INLINE void dlc_grTextureBufferExt(GrChipID_t tmu, FxU32 startAddress, GrLOD_t lodmin, GrLOD_t lodmax,
+      GrAspectRatio_t aspect, GrTextureFormat_t fmt, FxU32 evenOdd)
+{
+   dlist_cache_invalidate();
+   grTextureBufferExt(tmu, startAddress, lodmin, lodmax, aspect, fmt, evenOdd);
+}
+
+static INLINE void dlc_grTextureAuxBufferExt(GrChipID_t tmu, FxU32 startAddress, GrLOD_t thisLOD,
+      GrLOD_t largeLOD, GrAspectRatio_t aspectRatio, GrTextureFormat_t format, FxU32 odd_even_mask)
+{
+   dlist_cache_invalidate();
+   grTextureAuxBufferExt(tmu, startAddress, thisLOD, largeLOD, aspectRatio, format, odd_even_mask);
+}
+
+#ifdef HAVE_HWFBE
+static INLINE void dlc_grAuxBufferExt(GrBuffer_t buffer)
+{
+   dlist_cache_invalidate();
+   grAuxBufferExt(buffer);
+}
+#endif
+
+static INLINE FxBool dlc_grLfbLock(GrLock_t type, GrBuffer_t buffer, GrLfbWriteMode_t writeMode,
+      GrOriginLocation_t origin, FxBool pixelPipeline, GrLfbInfo_t *info)
+{
+   if (dlist_cache_recording)
+      dlist_cache_abort();
+   return grLfbLock(type, buffer, writeMode, origin, pixelPipeline, info);
+}
+
+static INLINE FxBool dlc_grLfbWriteRegion(GrBuffer_t dst_buffer, FxU32 dst_x, FxU32 dst_y,
+      GrLfbSrcFmt_t src_format, FxU32 src_width, FxU32 src_height, FxBool pixelPipeline,
+      FxI32 src_stride, void *src_data)
+{
+   if (dlist_cache_recording)
+      dlist_cache_abort();
+   return grLfbWriteRegion(dst_buffer, dst_x, dst_y, src_format, src_width, src_height,
+         pixelPipeline, src_stride, src_data);
+}
+
+static INLINE FxBool dlc_grLfbReadRegion(GrBuffer_t src_buffer, FxU32 src_x, FxU32 src_y,
+      FxU32 src_width, FxU32 src_height, FxU32 dst_stride, void *dst_data)
+{
+   if (dlist_cache_recording)
+      dlist_cache_abort();
+   return grLfbReadRegion(src_buffer, src_x, src_y, src_width, src_height, dst_stride, dst_data);
+}
+
+static INLINE void dlc_grBufferSwap(FxU32 swap_interval)
+{
+   if (dlist_cache_recording)
+      dlist_cache_abort();
+   grBufferSwap(swap_interval);
+}
+
+static INLINE void dlc_grFogTable(const GrFog_t ft[])
+{
+   if (dlist_cache_recording)
+      dlist_cache_abort();
+   grFogTable(ft);
+}
+
+static INLINE void dlc_grSstOrigin(GrOriginLocation_t origin)
+{
+   if (dlist_cache_recording)
+      dlist_cache_abort();
+   grSstOrigin(origin);
+}
+
+#ifndef DLIST_CACHE_NO_WRAPPERS
+#define grDrawTriangle              dlc_grDrawTriangle
+#define grDrawVertexArray           dlc_grDrawVertexArray
+#define grDrawVertexArrayContiguous dlc_grDrawVertexArrayContiguous
+#define grAlphaBlendFunction        dlc_grAlphaBlendFunction
+#define grAlphaCombine              dlc_grAlphaCombine
+#define grAlphaCombineExt           dlc_grAlphaCombineExt
+#define grAlphaTestFunction         dlc_grAlphaTestFunction
+#define grAlphaTestReferenceValue   dlc_grAlphaTestReferenceValue
+#define grBufferClear               dlc_grBufferClear
+#define grChromakeyMode             dlc_grChromakeyMode
+#define grChromakeyValue            dlc_grChromakeyValue
+#define grClipWindow                dlc_grClipWindow
+#define grColorCombine              dlc_grColorCombine
+#define grColorCombineExt           dlc_grColorCombineExt
+#define grColorMask                 dlc_grColorMask
+#define grConstantColorValue        dlc_grConstantColorValue
+#define grConstantColorValueExt     dlc_grConstantColorValueExt
+#define grConstantColorValueExtZero dlc_grConstantColorValueExtZero
+#define grCoordinateSpace           dlc_grCoordinateSpace
+#define grCullMode                  dlc_grCullMode
+#define grDepthBiasLevel            dlc_grDepthBiasLevel
+#define grDepthBufferFunction       dlc_grDepthBufferFunction
+#define grDepthBufferMode           dlc_grDepthBufferMode
+#define grDepthMask                 dlc_grDepthMask
+#define grFogColorValue             dlc_grFogColorValue
+#define grFogMode                   dlc_grFogMode
+#define grRenderBuffer              dlc_grRenderBuffer
+#define grStippleMode               dlc_grStippleMode
+#define grStipplePattern            dlc_grStipplePattern
+#define grTexAlphaCombineExt        dlc_grTexAlphaCombineExt
+#define grTexClampMode              dlc_grTexClampMode
+#define grTexColorCombineExt        dlc_grTexColorCombineExt
+#define grTexCombine                dlc_grTexCombine
+#define grTexDetailControl          dlc_grTexDetailControl
+#define grTexFilterMode             dlc_grTexFilterMode
+#define grTexLodBiasValue           dlc_grTexLodBiasValue
+#define grTexSource                 dlc_grTexSource
+#define grVertexLayout              dlc_grVertexLayout
+#define grTexDownloadMipMap         dlc_grTexDownloadMipMap
+#define grTextureBufferExt          dlc_grTextureBufferExt
+#define grTextureAuxBufferExt       dlc_grTextureAuxBufferExt
+#ifdef HAVE_HWFBE
+#define grAuxBufferExt              dlc_grAuxBufferExt
+#endif
+#define grLfbLock                   dlc_grLfbLock
+#define grLfbWriteRegion            dlc_grLfbWriteRegion
+#define grLfbReadRegion             dlc_grLfbReadRegion
+#define grBufferSwap                dlc_grBufferSwap
+#define grFogTable                  dlc_grFogTable
+#define grSstOrigin                 dlc_grSstOrigin
+#endif
+
+#endif // DLIST_CACHE_H
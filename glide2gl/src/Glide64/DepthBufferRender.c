@@ -48,9 +48,40 @@
 #include "Gfx_1.3.h"
 #include "rdp.h"
 #include "DepthBufferRender.h"
+#include "../../../mupen64plus-core/src/osal/thread.h"
+
+#if !defined(NOSSE)
+#include <emmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
 
 uint16_t *zLUT;
 
+// Triangles are not drawn into the depth image right away. They are queued
+// with the scissor they were drawn with and rasterized together when the
+// display list ends or something else is about to touch the depth image,
+// so the scanlines can be split into bands and drawn on several threads.
+typedef struct
+{
+   struct vertexi vtx[12];
+   int vertices;
+   int dzdx;
+   int ul_x, ul_y, lr_x, lr_y;   // rdp.scissor_o
+   int top, bottom;              // scanlines it can touch
+} DEPTH_POLY;
+
+#define MAX_DEPTH_BANDS 4
+#define DEPTH_BAND_MIN_PIXELS 0x10000   // less work than this isn't worth a thread
+
+static DEPTH_POLY *depth_queue;
+static int depth_queue_count, depth_queue_size;
+static uint32_t depth_queue_zimg, depth_queue_width;
+static int depth_queue_top, depth_queue_bottom;
+static uint32_t depth_queue_pixels;
+static int depth_bands;
+static osal_pool *depth_pool;   // depth_bands - 1 workers, started on first use
+
 #define ZLUT_SIZE 0x40000
 
 void ZLUT_init(void)
@@ -81,15 +112,28 @@ void ZLUT_release(void)
    if (zLUT)
       free(zLUT);
    zLUT = 0;
+
+   // anything still queued belongs to the closed rom
+   if (depth_queue)
+      free(depth_queue);
+   depth_queue = 0;
+   depth_queue_count = depth_queue_size = 0;
+
+   osal_pool_destroy(depth_pool);
+   depth_pool = 0;
+   depth_bands = 0;
 }
 
-static struct vertexi *max_vtx;                   // Max y vertex (ending vertex)
-static struct vertexi *start_vtx, *end_vtx;      // First and last vertex in array
-static struct vertexi *right_vtx, *left_vtx;     // Current right and left vertex
+typedef struct
+{
+   const struct vertexi *max_vtx;                  // Max y vertex (ending vertex)
+   const struct vertexi *start_vtx, *end_vtx;      // First and last vertex in array
+   const struct vertexi *right_vtx, *left_vtx;     // Current right and left vertex
 
-static int right_height, left_height;
-static int right_x, right_dxdy, left_x, left_dxdy;
-static int left_z, left_dzdy;
+   int right_height, left_height;
+   int right_x, right_dxdy, left_x, left_dxdy;
+   int left_z, left_dzdy;
+} EDGE_WALK;
 
 // ( x * y) >> 16
 #define imul16(x, y) ((((long long)x) * ((long long)y)) >> 16)
@@ -122,34 +166,34 @@ static INLINE int idiv16(int x, int y)        // (x << 16) / y
 
 #define iceil(x) (((x + 0xffff) >> 16))
 
-static void RightSection(void)
+static void RightSection(EDGE_WALK *e)
 {
    // Walk backwards trough the vertex array
 
-   struct vertexi *v2, *v1 = right_vtx;
-   if(right_vtx > start_vtx)
-      v2 = right_vtx-1;     
+   const struct vertexi *v2, *v1 = e->right_vtx;
+   if(e->right_vtx > e->start_vtx)
+      v2 = e->right_vtx-1;     
    else
-      v2 = end_vtx;         // Wrap to end of array
-   right_vtx = v2;
+      v2 = e->end_vtx;         // Wrap to end of array
+   e->right_vtx = v2;
 
    // v1 = top vertex
    // v2 = bottom vertex 
 
    // Calculate number of scanlines in this section
 
-   right_height = iceil(v2->y) - iceil(v1->y);
-   if(right_height <= 0) return;
+   e->right_height = iceil(v2->y) - iceil(v1->y);
+   if(e->right_height <= 0) return;
 
    // Guard against possible div overflows
 
-   if(right_height > 1)
+   if(e->right_height > 1)
    {
       // OK, no worries, we have a section that is at least
       // one pixel high. Calculate slope as usual.
 
       int height = v2->y - v1->y;
-      right_dxdy  = idiv16(v2->x - v1->x, height);
+      e->right_dxdy  = idiv16(v2->x - v1->x, height);
    }
    else
    {
@@ -158,46 +202,46 @@ static void RightSection(void)
       // using 18:14 bit precision to avoid overflows.
 
       int inv_height = (0x10000 << 14) / (v2->y - v1->y);  
-      right_dxdy = imul14(v2->x - v1->x, inv_height);
+      e->right_dxdy = imul14(v2->x - v1->x, inv_height);
    }
 
    // Prestep initial values
 
    int prestep = (iceil(v1->y) << 16) - v1->y;
-   right_x = v1->x + imul16(prestep, right_dxdy);
+   e->right_x = v1->x + imul16(prestep, e->right_dxdy);
 }
 
-static void LeftSection(void)
+static void LeftSection(EDGE_WALK *e)
 {
    // Walk forward trough the vertex array
 
-   struct vertexi *v2, *v1 = left_vtx;
-   if(left_vtx < end_vtx)
-      v2 = left_vtx+1;
+   const struct vertexi *v2, *v1 = e->left_vtx;
+   if(e->left_vtx < e->end_vtx)
+      v2 = e->left_vtx+1;
    else
-      v2 = start_vtx;      // Wrap to start of array
-   left_vtx = v2;
+      v2 = e->start_vtx;      // Wrap to start of array
+   e->left_vtx = v2;
 
    // v1 = top vertex
    // v2 = bottom vertex 
 
    // Calculate number of scanlines in this section
 
-   left_height = iceil(v2->y) - iceil(v1->y);
+   e->left_height = iceil(v2->y) - iceil(v1->y);
 
-   if(left_height <= 0)
+   if(e->left_height <= 0)
       return;
 
    // Guard against possible div overflows
 
-   if(left_height > 1)
+   if(e->left_height > 1)
    {
       // OK, no worries, we have a section that is at least
       // one pixel high. Calculate slope as usual.
 
       int height = v2->y - v1->y;
-      left_dxdy = idiv16(v2->x - v1->x, height);
-      left_dzdy = idiv16(v2->z - v1->z, height);
+      e->left_dxdy = idiv16(v2->x - v1->x, height);
+      e->left_dzdy = idiv16(v2->z - v1->z, height);
    }
    else
    {
@@ -206,35 +250,108 @@ static void LeftSection(void)
       // using 18:14 bit precision to avoid overflows.
 
       int inv_height = (0x10000 << 14) / (v2->y - v1->y);
-      left_dxdy = imul14(v2->x - v1->x, inv_height);
-      left_dzdy = imul14(v2->z - v1->z, inv_height);
+      e->left_dxdy = imul14(v2->x - v1->x, inv_height);
+      e->left_dzdy = imul14(v2->z - v1->z, inv_height);
    }
 
    // Prestep initial values
 
    int prestep = (iceil(v1->y) << 16) - v1->y;
-   left_x = v1->x + imul16(prestep, left_dxdy);
-   left_z = v1->z + imul16(prestep, left_dzdy);
+   e->left_x = v1->x + imul16(prestep, e->left_dxdy);
+   e->left_z = v1->z + imul16(prestep, e->left_dzdy);
 }
 
+// Draws one span into the depth image, keeping the nearer value
+static void DepthSpan(uint16_t *destptr, int shift, int width, int z, int dzdx)
+{
+   int x = 0;
+   int trueZ;
+   int idx;
+   uint16_t encodedZ;
+
+#if !defined(NOSSE) || defined(HAVE_NEON)
+   // The zLUT lookups stay scalar, but z/8192 and the clamp are done four
+   // pixels at a time. z>>13 only differs from z/8192 for negative z, which
+   // is clamped to 0 either way.
+   if (width >= 4)
+   {
+      int lanes[4];
+      lanes[0] = z;
+      lanes[1] = (int)((uint32_t)z + (uint32_t)dzdx);
+      lanes[2] = (int)((uint32_t)z + 2u * (uint32_t)dzdx);
+      lanes[3] = (int)((uint32_t)z + 3u * (uint32_t)dzdx);
+#if !defined(NOSSE)
+      __m128i zv = _mm_loadu_si128((__m128i*)lanes);
+      __m128i step = _mm_set1_epi32((int)(4u * (uint32_t)dzdx));
+      __m128i zmax = _mm_set1_epi32(0x3FFFF);
+#else
+      int32x4_t zv = vld1q_s32(lanes);
+      int32x4_t step = vdupq_n_s32((int)(4u * (uint32_t)dzdx));
+      int32x4_t zmin = vdupq_n_s32(0);
+      int32x4_t zmax = vdupq_n_s32(0x3FFFF);
+#endif
+
+      for (; x + 4 <= width; x += 4)
+      {
+         int i;
+#if !defined(NOSSE)
+         __m128i t = _mm_srai_epi32(zv, 13);
+         __m128i over;
+         t = _mm_andnot_si128(_mm_srai_epi32(t, 31), t);
+         over = _mm_cmpgt_epi32(t, zmax);
+         t = _mm_or_si128(_mm_and_si128(over, zmax), _mm_andnot_si128(over, t));
+         _mm_storeu_si128((__m128i*)lanes, t);
+         zv = _mm_add_epi32(zv, step);
+#else
+         vst1q_s32(lanes, vminq_s32(vmaxq_s32(vshrq_n_s32(zv, 13), zmin), zmax));
+         zv = vaddq_s32(zv, step);
+#endif
+         for (i = 0; i < 4; i++)
+         {
+            encodedZ = zLUT[lanes[i]];
+            idx = (shift+x+i)^1;
+            if(encodedZ < destptr[idx])
+               destptr[idx] = encodedZ;
+         }
+      }
+      z = (int)((uint32_t)z + (uint32_t)x * (uint32_t)dzdx);
+   }
+#endif
 
-void Rasterize(struct vertexi * vtx, int vertices, int dzdx)
+   for (; x < width; x++)
+   {
+      trueZ = z/8192;
+      if (trueZ < 0) trueZ = 0;
+      else if (trueZ > 0x3FFFF) trueZ = 0x3FFFF;
+      encodedZ = zLUT[trueZ];
+      idx = (shift+x)^1;
+      if(encodedZ < destptr[idx]) 
+         destptr[idx] = encodedZ;
+      z += dzdx;
+   }
+}
+
+// Rasterizes the scanlines of one queued polygon in [band_top, band_bottom)
+static void RasterizePoly(const DEPTH_POLY *poly, uint16_t *destptr, int zi_width, int band_top, int band_bottom)
 {
+   EDGE_WALK e;
    int n;
-   start_vtx = vtx;        // First vertex in array
+   const struct vertexi *vtx = poly->vtx;
+   int dzdx = poly->dzdx;
+   e.start_vtx = vtx;        // First vertex in array
 
    // Search trough the vtx array to find min y, max y
    // and the location of these structures.
 
-   struct vertexi *min_vtx = vtx;
-   max_vtx = vtx;
+   const struct vertexi *min_vtx = vtx;
+   e.max_vtx = vtx;
 
    int min_y = vtx->y;
    int max_y = vtx->y;
 
    vtx++;
 
-   for (n = 1; n < vertices; n++)
+   for (n = 1; n < poly->vertices; n++)
    {
       if(vtx->y < min_y)
       {
@@ -244,7 +361,7 @@ void Rasterize(struct vertexi * vtx, int vertices, int dzdx)
       else if(vtx->y > max_y)
       {
          max_y = vtx->y;
-         max_vtx = vtx;
+         e.max_vtx = vtx;
       }
       vtx++;
    }
@@ -252,100 +369,230 @@ void Rasterize(struct vertexi * vtx, int vertices, int dzdx)
    // OK, now we know where in the array we should start and
    // where to end while scanning the edges of the polygon
 
-   left_vtx  = min_vtx;    // Left side starting vertex
-   right_vtx = min_vtx;    // Right side starting vertex
-   end_vtx   = vtx-1;      // Last vertex in array
+   e.left_vtx  = min_vtx;    // Left side starting vertex
+   e.right_vtx = min_vtx;    // Right side starting vertex
+   e.end_vtx   = vtx-1;      // Last vertex in array
 
    // Search for the first usable right section
 
    do {
-      if(right_vtx == max_vtx)
+      if(e.right_vtx == e.max_vtx)
          return;
-      RightSection();
-   } while(right_height <= 0);
+      RightSection(&e);
+   } while(e.right_height <= 0);
 
    // Search for the first usable left section
 
    do {
-      if(left_vtx == max_vtx)
+      if(e.left_vtx == e.max_vtx)
          return;
-      LeftSection();
-   } while(left_height <= 0);
+      LeftSection(&e);
+   } while(e.left_height <= 0);
 
-   uint16_t * destptr = (uint16_t*)(gfx.RDRAM+rdp.zimg);
    int y1 = iceil(min_y);
-   if (y1 >= (int)rdp.scissor_o.lr_y) return;
-   int shift;
+   int y_end = min(poly->lr_y, band_bottom);
+   if (y1 >= y_end) return;
+   int ul_y = max(poly->ul_y, band_top);
 
    for(;;)
    {
-      int x1 = iceil(left_x);
-      if (x1 < (int)rdp.scissor_o.ul_x)
-         x1 = rdp.scissor_o.ul_x;
-      int width = iceil(right_x) - x1;
-      if (x1+width >= (int)rdp.scissor_o.lr_x)
-         width = rdp.scissor_o.lr_x - x1 - 1;
-
-      if(width > 0 && y1 >= (int)rdp.scissor_o.ul_y)
+      int x1 = iceil(e.left_x);
+      if (x1 < poly->ul_x)
+         x1 = poly->ul_x;
+      int width = iceil(e.right_x) - x1;
+      if (x1+width >= poly->lr_x)
+         width = poly->lr_x - x1 - 1;
+
+      if(width > 0 && y1 >= ul_y)
       {
-         int x;
          // Prestep initial z
 
-         int prestep = (x1 << 16) - left_x;
-         int z = left_z + imul16(prestep, dzdx);
+         int prestep = (x1 << 16) - e.left_x;
+         int z = e.left_z + imul16(prestep, dzdx);
 
-         shift = x1 + y1*rdp.zi_width;
          //draw to depth buffer
-         int trueZ;
-         int idx;
-         uint16_t encodedZ;
-         for (x = 0; x < width; x++)
-         {
-            trueZ = z/8192;
-            if (trueZ < 0) trueZ = 0;
-            else if (trueZ > 0x3FFFF) trueZ = 0x3FFFF;
-            encodedZ = zLUT[trueZ];
-            idx = (shift+x)^1;
-            if(encodedZ < destptr[idx]) 
-               destptr[idx] = encodedZ;
-            z += dzdx;
-         }
+         DepthSpan(destptr, x1 + y1*zi_width, width, z, dzdx);
       }
 
-      //destptr += rdp.zi_width;
       y1++;
-      if (y1 >= (int)rdp.scissor_o.lr_y)
+      if (y1 >= y_end)
          return;
 
       // Scan the right side
 
-      if(--right_height <= 0) // End of this section?
+      if(--e.right_height <= 0) // End of this section?
       {
          do
          {
-            if(right_vtx == max_vtx)
+            if(e.right_vtx == e.max_vtx)
                return;
-            RightSection();
-         } while(right_height <= 0);
+            RightSection(&e);
+         } while(e.right_height <= 0);
       }
       else 
-         right_x += right_dxdy;
+         e.right_x += e.right_dxdy;
 
       // Scan the left side
 
-      if(--left_height <= 0) // End of this section ?
+      if(--e.left_height <= 0) // End of this section ?
       {
          do
          {
-            if(left_vtx == max_vtx)
+            if(e.left_vtx == e.max_vtx)
                return;
-            LeftSection();
-         } while(left_height <= 0);
+            LeftSection(&e);
+         } while(e.left_height <= 0);
+      }
+      else
+      {
+         e.left_x += e.left_dxdy;
+         e.left_z += e.left_dzdy;
+      }
+   }
+}
+
+typedef struct
+{
+   int top, bottom;
+} DEPTH_BAND;
+
+static void RasterizeBand(void *arg)
+{
+   const DEPTH_BAND *band = (const DEPTH_BAND*)arg;
+   uint16_t *destptr = (uint16_t*)(gfx.RDRAM+depth_queue_zimg);
+   int i;
+
+   for (i = 0; i < depth_queue_count; i++)
+   {
+      const DEPTH_POLY *poly = &depth_queue[i];
+      if (poly->bottom > band->top && poly->top < band->bottom)
+         RasterizePoly(poly, destptr, depth_queue_width, band->top, band->bottom);
+   }
+}
+
+// Draws everything queued by Rasterize() into the depth image
+void RasterizeFlush(void)
+{
+   DEPTH_BAND bands[MAX_DEPTH_BANDS];
+   void *jobs[MAX_DEPTH_BANDS];
+   int i, count = 1;
+
+   if (!depth_queue_count)
+      return;
+
+   // the depth test reads the old values, so these are not overwritten
+   dlist_cache_write(depth_queue_zimg + depth_queue_top * depth_queue_width * 2,
+         (depth_queue_bottom - depth_queue_top + 1) * depth_queue_width * 2, 0);
+
+   if (!depth_bands)
+   {
+      depth_bands = min(osal_cpu_count(), MAX_DEPTH_BANDS);
+      if (depth_bands > 1)
+         depth_pool = osal_pool_create(depth_bands - 1);
+      if (!depth_pool)
+         depth_bands = 1;
+   }
+
+   // Each band owns whole scanlines, so the threads never write the same
+   // depth value and the result doesn't depend on how the work is split
+   if (depth_queue_pixels >= DEPTH_BAND_MIN_PIXELS)
+      count = min(depth_bands, depth_queue_bottom - depth_queue_top);
+   for (i = 0; i < count; i++)
+   {
+      int rows = depth_queue_bottom - depth_queue_top;
+      bands[i].top = depth_queue_top + rows * i / count;
+      bands[i].bottom = depth_queue_top + rows * (i + 1) / count;
+      jobs[i] = &bands[i];
+   }
+
+   osal_pool_run(depth_pool, RasterizeBand, jobs, count);
+
+   depth_queue_count = 0;
+   depth_queue_pixels = 0;
+}
+
+// Flushes the queue if it may draw into [addr, addr+size) of RDRAM
+void RasterizeFlushRange(uint32_t addr, uint32_t size)
+{
+   uint32_t start, end;
+
+   if (!depth_queue_count)
+      return;
+
+   start = depth_queue_zimg + depth_queue_top * depth_queue_width * 2;
+   end = depth_queue_zimg + (depth_queue_bottom + 1) * depth_queue_width * 2;
+   if (addr < end && addr + size > start)
+      RasterizeFlush();
+}
+
+void Rasterize(struct vertexi * vtx, int vertices, int dzdx)
+{
+   DEPTH_POLY *poly;
+   int n, min_y, max_y, min_x, max_x;
+
+   if (vertices > 12)
+      return;
+
+   // Everything in the queue goes into the same depth image
+   if (depth_queue_count && (depth_queue_zimg != rdp.zimg || depth_queue_width != rdp.zi_width))
+      RasterizeFlush();
+
+   if (depth_queue_count == depth_queue_size)
+   {
+      int size = depth_queue_size ? depth_queue_size * 2 : 256;
+      DEPTH_POLY *queue = (DEPTH_POLY*)realloc(depth_queue, size * sizeof(DEPTH_POLY));
+      if (queue == NULL)
+      {
+         RasterizeFlush();
+         if (!depth_queue_size)
+            return;
       }
       else
       {
-         left_x += left_dxdy;
-         left_z += left_dzdy;
+         depth_queue = queue;
+         depth_queue_size = size;
       }
    }
+
+   poly = &depth_queue[depth_queue_count];
+   poly->ul_x = rdp.scissor_o.ul_x;
+   poly->ul_y = rdp.scissor_o.ul_y;
+   poly->lr_x = rdp.scissor_o.lr_x;
+   poly->lr_y = rdp.scissor_o.lr_y;
+
+   min_y = max_y = vtx[0].y;
+   min_x = max_x = vtx[0].x;
+   for (n = 1; n < vertices; n++)
+   {
+      min_y = min(min_y, vtx[n].y);
+      max_y = max(max_y, vtx[n].y);
+      min_x = min(min_x, vtx[n].x);
+      max_x = max(max_x, vtx[n].x);
+   }
+
+   // Scanlines are drawn from iceil(min_y) up to, but not including,
+   // iceil(max_y). Drop polygons that can't reach the scissor.
+   poly->top = max(iceil(min_y), poly->ul_y);
+   poly->bottom = min(iceil(max_y) + 1, poly->lr_y);
+   if (poly->top >= poly->bottom)
+      return;
+
+   memcpy(poly->vtx, vtx, vertices * sizeof(struct vertexi));
+   poly->vertices = vertices;
+   poly->dzdx = dzdx;
+
+   if (!depth_queue_count)
+   {
+      depth_queue_zimg = rdp.zimg;
+      depth_queue_width = rdp.zi_width;
+      depth_queue_top = poly->top;
+      depth_queue_bottom = poly->bottom;
+   }
+   else
+   {
+      depth_queue_top = min(depth_queue_top, poly->top);
+      depth_queue_bottom = max(depth_queue_bottom, poly->bottom);
+   }
+   depth_queue_pixels += (poly->bottom - poly->top) * (iceil(max_x) - iceil(min_x) + 1);
+   depth_queue_count++;
 }
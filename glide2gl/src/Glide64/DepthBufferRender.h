@@ -56,5 +56,7 @@ void ZLUT_init(void);
 void ZLUT_release(void);
 
 void Rasterize(struct vertexi * vtx, int vertices, int dzdx);
+void RasterizeFlush(void);
+void RasterizeFlushRange(uint32_t addr, uint32_t size);
 
 #endif //DEPTH_BUFFER_RENDER_H
@@ -46,6 +46,23 @@
 #include "Gfx_1.3.h"
 #include "FBtoScreen.h"
 #include "TexCache.h"
+#include "DepthBufferRender.h"
+#include "texdecode.h"
+
+// Converts up to count RGBA16 texels of the frame buffer row starting at
+// texel to ARGB1555, stopping at bound (the end of RDRAM). Returns the
+// number of texels written.
+static uint32_t fb_row_to_1555(uint16_t *dst, const uint16_t *src, uint32_t texel, uint32_t count, uint32_t bound)
+{
+   // texels are read in pairs from a 32 bit word
+   bound &= ~1;
+   if (texel >= bound)
+      return 0;
+   if (count > bound - texel)
+      count = bound - texel;
+   texdec_row(dst, TEXDEC_OUT_ARGB1555, TEXDEC_RGBA16, src, texel, TEXDEC_XOR_HOST, count, NULL);
+   return count;
+}
 
 static int SetupFBtoScreenCombiner(uint32_t texture_size, uint32_t opaque)
 {
@@ -214,7 +231,6 @@ static void DrawFrameBufferToScreen256(FB_TO_SCREEN_INFO *fb_info)
   src32 += fb_info->ul_x + fb_info->ul_y * fb_info->width;
   uint32_t w_tail = width%256;
   uint32_t h_tail = height%256;
-  uint16_t c;
   uint32_t c32;
   uint32_t idx;
   uint32_t bound = BMASK+1-fb_info->addr;
@@ -234,17 +250,7 @@ static void DrawFrameBufferToScreen256(FB_TO_SCREEN_INFO *fb_info)
       if (fb_info->size == 2)
       {
         for (y=0; y < cur_height; y++)
-        {
-          for (x=0; x < cur_width; x++)
-          {
-            idx = (x+256*w+(y+256*h)*fb_info->width)^1;
-            if (idx >= bound)
-              break;
-            c = src[idx];
-            *(dst++) = (c >> 1) | ((c&1)<<15);
-          }
-          dst += cur_tail;
-        }
+          fb_row_to_1555(dst + y*256, src, 256*w+(y+256*h)*fb_info->width, cur_width, bound);
       }
       else
       {
@@ -259,7 +265,7 @@ static void DrawFrameBufferToScreen256(FB_TO_SCREEN_INFO *fb_info)
             r = (uint8_t)((c32 >> 24)&0xFF);
             r = (uint8_t)((float)r / 255.0f * 31.0f);
             g = (uint8_t)((c32 >> 16)&0xFF);
-            g = (uint8_t)((float)g / 255.0f * 63.0f);
+            g = (uint8_t)((float)g / 255.0f * 31.0f);
             b = (uint8_t)((c32 >>  8)&0xFF);
             b = (uint8_t)((float)b / 255.0f * 31.0f);
             a = (c32&0xFF) ? 1 : 0;
@@ -341,24 +347,16 @@ bool DrawFrameBufferToScreen(FB_TO_SCREEN_INFO *fb_info)
       uint16_t * dst = tex;
       uint16_t * src = (uint16_t*)image;
       src += fb_info->ul_x + fb_info->ul_y * fb_info->width;
-      uint16_t c;
-      uint32_t idx;
       const uint32_t bound = (BMASK+1-fb_info->addr) >> 1;
-      bool empty = true;
+      uint16_t used = 0;
       for (y = 0; y < height; y++)
       {
-         for (x = 0; x < width; x++)
-         {
-            idx = (x+y*fb_info->width)^1;
-            if (idx >= bound)
-               break;
-            c = src[idx];
-            if (c) empty = false;
-            *(dst++) = (c >> 1) | ((c&1)<<15);
-         }
-         dst += texwidth-width;
+         uint32_t n = fb_row_to_1555(dst, src, y*fb_info->width, width, bound);
+         for (x = 0; x < n; x++)
+            used |= dst[x];
+         dst += texwidth;
       }
-      if (empty)
+      if (!used)
          return false;
       t_info.format = GR_TEXFMT_ARGB_1555;
       t_info.data = tex;
@@ -564,6 +562,7 @@ void DrawDepthBufferToScreen(FB_TO_SCREEN_INFO *fb_info)
 {
    uint32_t width = fb_info->lr_x - fb_info->ul_x + 1;
    uint32_t height = fb_info->lr_y - fb_info->ul_y + 1;
+   RasterizeFlush();
    if (width > 512)
    {
       DrawDepthBufferToScreen256(fb_info);
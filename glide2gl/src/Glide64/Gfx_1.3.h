@@ -196,4 +196,6 @@ int GetTexAddrUMA(int tmu, int texsize);
 void ReadSettings(void);
 void ReadSpecialSettings (const char * name);
 
+#include "DListCache.h"
+
 #endif //_GFX_H_INCLUDED__
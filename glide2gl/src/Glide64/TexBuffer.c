@@ -579,7 +579,7 @@ int CopyDepthBuffer(void)
          GR_ASPECT_LOG2_1x1, GR_TEXFMT_RGB_565, GR_MIPMAPLEVELMASK_BOTH );
    grAuxBufferExt( GR_BUFFER_TEXTUREAUXBUFFER_EXT );
 
-   rdp.update |= UPDATE_ZBUF_ENABLED | UPDATE_COMBINE | UPDATE_TEXTURE | UPDATE_ALPHA_COMPARE;
+   rdp.update |= UPDATE_ZBUF_ENABLED | UPDATE_COMBINE | UPDATE_TEXTURE | UPDATE_ALPHA_COMPARE | UPDATE_SCISSOR;
    if (settings.fog && (rdp.flags & FOG_ENABLED))
       grFogMode (GR_FOG_WITH_TABLE_ON_FOGCOORD_EXT);
    LRDP("CopyDepthBuffer draw, OK\n");
@@ -655,7 +655,7 @@ int SwapTextureBuffer(void)
       rdp.update |= UPDATE_VIEWPORT | UPDATE_SCISSOR;
    }
 
-   rdp.update |= UPDATE_ZBUF_ENABLED | UPDATE_COMBINE | UPDATE_TEXTURE | UPDATE_ALPHA_COMPARE;
+   rdp.update |= UPDATE_ZBUF_ENABLED | UPDATE_COMBINE | UPDATE_TEXTURE | UPDATE_ALPHA_COMPARE | UPDATE_SCISSOR;
 
    if (settings.fog && (rdp.flags & FOG_ENABLED))
       grFogMode (GR_FOG_WITH_TABLE_ON_FOGCOORD_EXT);
@@ -41,6 +41,7 @@
 #include "TexCache.h"
 #include "Combine.h"
 #include "Util.h"
+#include "texhash.h"
 
 void LoadTex (int id, int tmu);
 
@@ -122,6 +123,7 @@ void TexCacheInit(void)
 void ClearCache(void)
 {
    int i;
+   dlist_cache_invalidate();
    voodoo.tmem_ptr[0] = offset_textures;
    rdp.n_cached[0] = 0;
    voodoo.tmem_ptr[1] = offset_textures;
@@ -129,9 +131,12 @@ void ClearCache(void)
 
    for (i = 0; i < 65536; i++)
       DeleteList(&cachelut[i]);
+
+   grTexPoolTrimExt();
 }
 
 //****************************************************************
+// width is in 64 bit words, line the bytes skipped after each row
 uint32_t textureCRC(uint8_t *addr, int width, int height, int line)
 {
    uint32_t crc = 0;
@@ -139,6 +144,10 @@ uint32_t textureCRC(uint8_t *addr, int width, int height, int line)
    unsigned int i;
    uint64_t twopixel_crc;
 
+   // The CRC32C table fallback is slower than the old hash below
+   if (texhash_backend() != TEXHASH_TABLE)
+      return texhash_rect(0, addr, width << 3, height, (width << 3) + line);
+
    pixelpos = (uint32_t*)addr;
    for (; height; height--)
    {
@@ -1292,8 +1301,10 @@ void LoadTex(int id, int tmu)
 
       uint32_t texture_size = grTexTextureMemRequired (GR_MIPMAPLEVELMASK_BOTH, t_info);
 
-      // Check for end of memory (too many textures to fit, clear cache)
-      if (voodoo.tmem_ptr[tmu]+texture_size >= voodoo.tex_max_addr)
+      // Check for end of memory (too many textures to fit, or more GL
+      // storage than the budget allows, clear cache)
+      if (voodoo.tmem_ptr[tmu]+texture_size >= voodoo.tex_max_addr
+            || grTexPoolFullExt())
       {
          LRDP("Cache size reached, clearing...\n");
          ClearCache ();
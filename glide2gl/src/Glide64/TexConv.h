@@ -45,6 +45,16 @@ static INLINE void TexConv_ARGB1555_ARGB4444 (unsigned char * src, unsigned char
    uint32_t *_src = (uint32_t *)src;
    uint32_t *_dst = (uint32_t *)dst;
 
+#ifdef TEXLOAD_SIMD
+   for (; size >= 4; size -= 4, _src += 4, _dst += 4)
+   {
+      tl_vec v = tl_load(_src);
+      tl_vec c = tl_or(tl_and(tl_srl16(v, 1), tl_set16(0x000F)),
+            tl_or(tl_and(tl_srl16(v, 2), tl_set16(0x00F0)), tl_and(tl_srl16(v, 3), tl_set16(0x0F00))));
+      tl_store(_dst, tl_or(c, tl_and(tl_sra16(v, 15), tl_set16(0xF000))));
+   }
+   if (size)
+#endif
    do
    {
       uint32_t v6 = *_src++;
@@ -60,6 +70,16 @@ static INLINE void TexConv_AI88_ARGB4444 (unsigned char * src, unsigned char * d
    uint32_t *_src = (uint32_t *)src;
    uint32_t *_dst = (uint32_t *)dst;
 
+#ifdef TEXLOAD_SIMD
+   for (; size >= 4; size -= 4, _src += 4, _dst += 4)
+   {
+      tl_vec v = tl_load(_src);
+      tl_vec i = tl_and(v, tl_set16(0x00F0));
+      tl_vec c = tl_or(tl_or(tl_srl16(i, 4), i), tl_sll16(i, 4));
+      tl_store(_dst, tl_or(c, tl_and(v, tl_set16(0xF000))));
+   }
+   if (size)
+#endif
    do
    {
       uint32_t v6 = *_src++;
@@ -75,6 +95,15 @@ static INLINE void TexConv_A8_ARGB4444 (unsigned char * src, unsigned char * dst
    uint32_t *_src = (uint32_t *)src;
    uint32_t *_dst = (uint32_t *)dst;
 
+#ifdef TEXLOAD_SIMD
+   for (; size >= 4; size -= 4, _src += 4, _dst += 8)
+   {
+      tl_vec a = tl_hi4(tl_load(_src));
+      tl_store(_dst, tl_mul16(tl_zip_lo8(a, tl_zero()), 0x1111));
+      tl_store(_dst + 4, tl_mul16(tl_zip_hi8(a, tl_zero()), 0x1111));
+   }
+   if (size)
+#endif
    do
    {
       uint32_t v6 = *_src++;
@@ -37,6 +37,7 @@
 //
 //****************************************************************
 
+#include "TexLoadSIMD.h"
 #include "TexLoad4b.h"
 #include "TexLoad8b.h"
 #include "TexLoad16b.h"
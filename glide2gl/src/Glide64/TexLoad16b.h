@@ -63,7 +63,11 @@ static INLINE void load16bRGBA(uint8_t *src, uint8_t *dst, int wid_64, int heigh
    {
       v17 = v8;
       v9 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v6 += 4, v7 += 4)
+         tl_store(v7, tl_ror16_1(tl_bswap16(tl_load(v6))));
+#endif
+      for (; v9; v9--)
       {
          v10 = bswap32(*v6++);
          v11 = bswap32(*v6++);
@@ -75,14 +79,18 @@ static INLINE void load16bRGBA(uint8_t *src, uint8_t *dst, int wid_64, int heigh
          ALOWORD(v11) = __ROR16((uint16_t)v11, 1, nbits16);
          *v7++ = v10;
          *v7++ = v11;
-      }while (--v9);
+      }
       if ( v17 == 1 )
          break;
       v18 = v17 - 1;
       v12 = (uint32_t *)&src[(line + (uintptr_t)v6 - (uintptr_t)src) & 0xFFF];
       v13 = (uint32_t *)((char *)v7 + ext);
       v14 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v14 >= 2; v14 -= 2, v12 += 4, v13 += 4)
+         tl_store(v13, tl_swap_words(tl_ror16_1(tl_bswap16(tl_load(v12)))));
+#endif
+      for (; v14; v14--)
       {
          v16 = bswap32(*v12++);
          v15 = bswap32(*v12++);
@@ -95,7 +103,6 @@ static INLINE void load16bRGBA(uint8_t *src, uint8_t *dst, int wid_64, int heigh
          *v13++ = v15;
          *v13++ = v16;
       }
-      while (--v14);
       v6 = (uint32_t *)&src[(line + (uintptr_t)v12 - (uintptr_t)src) & 0xFFF];
       v7 = (uint32_t *)((char *)v13 + ext);
       v8 = v18 - 1;
@@ -124,24 +131,32 @@ static INLINE void load16bIA(uint8_t *src, uint8_t *dst, int wid_64, int height,
    {
       v15 = v8;
       v9 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v6 += 4, v7 += 4)
+         tl_store(v7, tl_load(v6));
+#endif
+      for (; v9; v9--)
       {
          *v7++ = *v6++;
          *v7++ = *v6++;
-      }while (--v9 );
+      }
       if ( v15 == 1 )
          break;
       v16 = v15 - 1;
       v11 = (uint32_t *)((char *)v6 + line);
       v12 = (uint32_t *)((char *)v7 + ext);
       v9 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v11 += 4, v12 += 4)
+         tl_store(v12, tl_swap_words(tl_load(v11)));
+#endif
+      for (; v9; v9--)
       {
          v14 = *v11;
          *v12++ = v11[1];
          *v12++ = v14;
          v11 += 2;
-      }while (--v9 );
+      }
       v6 = (uint32_t *)((char *)v11 + line);
       v7 = (uint32_t *)((char *)v12 + ext);
       v8 = v16 - 1;
@@ -38,6 +38,30 @@
 //****************************************************************
 #include "Gfx_1.3.h"
 
+#ifdef TEXLOAD_SIMD
+// Reads four texels of a 32-bit texture from TMEM, the RG halves at tmem16
+// and the BA halves at tmem16 + 0x400, as ARGB8888. xorval 1 or 3 is the
+// line interleave; taddr must be a multiple of 4.
+static INLINE tl_vec load32b_texels(const uint16_t *tmem16, uint32_t taddr, uint32_t xorval)
+{
+   tl_vec v = tl_join64(tl_load64(tmem16 + taddr), tl_load64(tmem16 + (taddr | 0x400)));
+   tl_vec rg, ba;
+   v = (xorval == 1) ? tl_rev16in32(v) : tl_rev16in64(v);
+   rg = tl_zip_lo16(v, tl_zero());
+   ba = tl_zip_hi16(v, tl_zero());
+   return tl_or(tl_sll32(tl_and(ba, tl_set32(0xFF)), 24), tl_or(tl_sll32(rg, 8), tl_srl32(ba, 8)));
+}
+
+// Splits four RGBA8888 words into TMEM, the reverse of load32b_texels.
+static INLINE void store32b_texels(uint16_t *tmem16, uint32_t taddr, uint32_t xorval, tl_vec c)
+{
+   tl_vec v = tl_narrow32(tl_srl32(c, 16), tl_and(c, tl_set32(0xFFFF)));
+   v = (xorval == 1) ? tl_rev16in32(v) : tl_rev16in64(v);
+   tl_store_lo64(tmem16 + taddr, v);
+   tl_store_hi64(tmem16 + (taddr | 0x400), v);
+}
+#endif
+
 //****************************************************************
 // Size: 2, Format: 0
 //
@@ -60,7 +84,18 @@ uint32_t Load32bRGBA (uintptr_t dst, uintptr_t src, int wid_64, int height, int
    {
       uint32_t tline = tbase + line * t;
       uint32_t xorval = (t & 1) ? 3 : 1;
-      for (s = 0; s < width; s++)
+      s = 0;
+#ifdef TEXLOAD_SIMD
+      // the xor only stays inside groups of four that start on a multiple of 4
+      for (; s < width && ((tline + s) & 3); s++)
+      {
+         uint32_t taddr = ((tline + s) ^ xorval) & 0x3ff;
+         *tex++ = ((tmem16[taddr|0x400] & 0xFF)<<24) | (tmem16[taddr] << 8) | (tmem16[taddr|0x400] >> 8);
+      }
+      for (; s + 4 <= width; s += 4, tex += 4)
+         tl_store(tex, load32b_texels(tmem16, (tline + s) & 0x3ff, xorval));
+#endif
+      for (; s < width; s++)
       {
          uint32_t taddr = ((tline + s) ^ xorval) & 0x3ff;
          *tex++ = ((tmem16[taddr|0x400] & 0xFF)<<24) | (tmem16[taddr] << 8) | (tmem16[taddr|0x400] >> 8);
@@ -76,6 +111,20 @@ uint32_t Load32bRGBA (uintptr_t dst, uintptr_t src, int wid_64, int height, int
       tex = (uint32_t *)dst;
       uint16_t *tex16 = (uint16_t*)dst;
       uint32_t c;
+#ifdef TEXLOAD_SIMD
+      for (; tex_size >= 8; tex_size -= 8, tex += 8, tex16 += 8)
+      {
+         // keep the high nibble of each channel and gather them per texel
+         tl_vec a = tl_and(tl_srl32(tl_load(tex), 4), tl_set8(0x0F));
+         tl_vec b = tl_and(tl_srl32(tl_load(tex + 4), 4), tl_set8(0x0F));
+         a = tl_or(a, tl_srl32(a, 4));
+         b = tl_or(b, tl_srl32(b, 4));
+         a = tl_or(tl_and(a, tl_set32(0xFF)), tl_sll32(tl_and(tl_srl32(a, 16), tl_set32(0xFF)), 8));
+         b = tl_or(tl_and(b, tl_set32(0xFF)), tl_sll32(tl_and(tl_srl32(b, 16), tl_set32(0xFF)), 8));
+         tl_store(tex16, tl_narrow32(a, b));
+      }
+      if (tex_size)
+#endif
       do
       {
          c = *tex++;
@@ -105,7 +154,14 @@ void LoadTile32b (uint32_t tile, uint32_t ul_s, uint32_t ul_t, uint32_t width, u
       tline = tbase + line * j;
       s = ((j + ul_t) * rdp.timg.width) + ul_s;
       xorval = (j & 1) ? 3 : 1;				
-      for (i = 0; i < width; i++)
+      dlist_cache_read((addr + s) << 2, width << 2);
+      i = 0;
+#ifdef TEXLOAD_SIMD
+      // tline is a multiple of 4, so each group of four stays together
+      for (; i + 4 <= width; i += 4)
+         store32b_texels(tmem16, (tline + i) & 0x3ff, xorval, tl_load(src + addr + s + i));
+#endif
+      for (; i < width; i++)
       {
          c = src[addr + s + i];
          ptr = ((tline + i) ^ xorval) & 0x3ff;
@@ -159,12 +215,19 @@ void LoadBlock32b(uint32_t tile, uint32_t ul_s, uint32_t ul_t, uint32_t lr_s, ui
          tmem16[ptr|0x400] = c & 0xffff;
          j += dxt;
       }
+      dlist_cache_read(addr << 2, i << 2);
    }
    else
    {
       addr += (ul_t * tiwindwords) + slindwords;
       uint32_t c, ptr;
-      for (i = 0; i < width; i ++)
+      dlist_cache_read(addr << 2, width << 2);
+      i = 0;
+#ifdef TEXLOAD_SIMD
+      for (; i + 4 <= width; i += 4)
+         store32b_texels(tmem16, (tb + i) & 0x3ff, 1, tl_load(src + addr + i));
+#endif
+      for (; i < width; i ++)
       {
          ptr = ((tb + i) ^ 1) & 0x3ff;
          c = src[addr + i];
@@ -39,6 +39,27 @@
 
 #include <stdint.h>
 
+#ifdef TEXLOAD_SIMD
+// 4-bit IA texel iiia to the 8-bit IA44 aaaa iiii
+static INLINE tl_vec load4b_ia31(tl_vec n)
+{
+   tl_vec one = tl_set8(1);
+   tl_vec a = tl_and(tl_cmpeq8(tl_and(n, one), one), tl_set8(0xF0));
+   return tl_or(a, tl_or(tl_and(n, tl_set8(0x0E)), tl_and(tl_srl16(n, 3), one)));
+}
+
+// Widens 16 bytes of 4-bit texels to 32 bytes, high nibble first: I4 to
+// I8, or IA31 to IA44 when ia is set.
+static INLINE void load4b_expand(uint32_t *dst, tl_vec v, int ia)
+{
+   tl_vec hi = tl_hi4(v), lo = tl_lo4(v);
+   tl_vec a = tl_zip_lo8(hi, lo);
+   tl_vec b = tl_zip_hi8(hi, lo);
+   tl_store(dst, ia ? load4b_ia31(a) : tl_dup4(a));
+   tl_store(dst + 4, ia ? load4b_ia31(b) : tl_dup4(b));
+}
+#endif
+
 static INLINE void load4bCI(uint8_t *src, uint8_t *dst, int wid_64, int height, uint16_t line, int ext, uint16_t *pal)
 {
    uint8_t *v7;
@@ -367,6 +388,11 @@ static INLINE void load4bIA(uint8_t *src, uint8_t *dst, int wid_64, int height,
    {
       v57 = v8;
       v9 = wid_64;
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v6 += 4, v7 += 8)
+         load4b_expand(v7, tl_load(v6), 1);
+      if (v9)
+#endif
       do
       {
          v10 = v9;
@@ -419,6 +445,11 @@ static INLINE void load4bIA(uint8_t *src, uint8_t *dst, int wid_64, int height,
       v33 = (uint32_t *)((char *)v6 + line);
       v34 = (uint32_t *)((char *)v7 + ext);
       v35 = wid_64;
+#ifdef TEXLOAD_SIMD
+      for (; v35 >= 2; v35 -= 2, v33 += 4, v34 += 8)
+         load4b_expand(v34, tl_swap_words(tl_load(v33)), 1);
+      if (v35)
+#endif
       do
       {
          v36 = v35;
@@ -508,6 +539,11 @@ static INLINE void load4bI(uint8_t *src, uint8_t *dst, int wid_64, int height, i
    {
       v33 = v8;
       v9 = wid_64;
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v6 += 4, v7 += 8)
+         load4b_expand(v7, tl_load(v6), 0);
+      if (v9)
+#endif
       do
       {
          v10 = v9;
@@ -540,6 +576,11 @@ static INLINE void load4bI(uint8_t *src, uint8_t *dst, int wid_64, int height, i
       v21 = (uint32_t *)((char *)v6 + line);
       v22 = (uint32_t *)((char *)v7 + ext);
       v23 = wid_64;
+#ifdef TEXLOAD_SIMD
+      for (; v23 >= 2; v23 -= 2, v21 += 4, v22 += 8)
+         load4b_expand(v22, tl_swap_words(tl_load(v21)), 0);
+      if (v23)
+#endif
       do
       {
          v24 = v23;
@@ -247,28 +247,34 @@ static INLINE void load8bIA4(uint8_t *src, uint8_t *dst, int wid_64, int height,
    {
       v21 = v8;
       v9 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v6 += 4, v7 += 4)
+         tl_store(v7, tl_nibble_swap(tl_load(v6)));
+#endif
+      for (; v9; v9--)
       {
          uint32_t col1 = *v6++;
          uint32_t col2 = *v6++;
          *v7++ = ((col1 << 4) & 0xF0F0F0F0) | ((col1 >> 4) & 0xF0F0F0F);
          *v7++ = (col2 << 4) & 0xF0F0F0F0 | ((col2 >> 4) & 0xF0F0F0F);
       }
-      while (--v9);
       if ( v21 == 1 )
          break;
       v22 = v21 - 1;
       v18 = wid_64;
       v16 = (uint32_t *)((char *)v6 + line);
       v17 = (uint32_t *)((char *)v7 + ext);
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v18 >= 2; v18 -= 2, v16 += 4, v17 += 4)
+         tl_store(v17, tl_swap_words(tl_nibble_swap(tl_load(v16))));
+#endif
+      for (; v18; v18--)
       {
          v20 = *v16++;
          *v17++ = ((v16[0] << 4) & 0xF0F0F0F0) | ((v16[0] >> 4) & 0xF0F0F0F);
          v16++;
          *v17++ = ((v20 << 4) & 0xF0F0F0F0) | ((v20 >> 4) & 0xF0F0F0F);
       }
-      while (--v18);
       v6 = (uint32_t *)((char *)v16 + line);
       v7 = (uint32_t *)((char *)v17 + ext);
       v8 = v22 - 1;
@@ -301,24 +307,32 @@ static INLINE void load8bI(uint8_t *src, uint8_t *dst, int wid_64, int height, i
    {
       v19 = v8;
       v9 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v9 >= 2; v9 -= 2, v6 += 4, v7 += 4)
+         tl_store(v7, tl_load(v6));
+#endif
+      for (; v9; v9--)
       {
          *v7++ = *v6++;
          *v7++ = *v6++;
-      }while (--v9);
+      }
       if ( v19 == 1 )
          break;
       v20 = v19 - 1;
       v14 = (uint32_t *)((char *)v6 + line);
       v15 = (uint32_t *)((char *)v7 + ext);
       v16 = wid_64;
-      do
+#ifdef TEXLOAD_SIMD
+      for (; v16 >= 2; v16 -= 2, v14 += 4, v15 += 4)
+         tl_store(v15, tl_swap_words(tl_load(v14)));
+#endif
+      for (; v16; v16--)
       {
          uint32_t col2 = *v14++;
          uint32_t col1 = *v14++;
          *v15++ = col1;
          *v15++ = col2;
-      }while (--v16);
+      }
       v6 = (uint32_t *)((char *)v14 + line);
       v7 = (uint32_t *)((char *)v15 + ext);
       v8 = v20 - 1;
@@ -0,0 +1,228 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+* Copyright (c) 2002  Dave2001
+* Copyright (c) 2003-2009  Sergey 'Gonetz' Lipski
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+//****************************************************************
+//
+// 16 byte vector helpers for the TMEM loads (rdp.c), the texture
+// loaders (TexLoad*.h) and the converters (TexConv.h). Every helper has
+// an SSE2 and a NEON version so the loaders are written once; without
+// either TEXLOAD_SIMD is not defined and only the scalar loops are built.
+//
+//****************************************************************
+
+#ifndef TEXLOADSIMD_H
+#define TEXLOADSIMD_H
+
+#include <stdint.h>
+
+#if !defined(NOSSE) && !defined(TEXLOAD_NO_SIMD)
+#define TEXLOAD_SIMD
+#include <emmintrin.h>
+
+typedef __m128i tl_vec;
+
+#define tl_load(p)         _mm_loadu_si128((const __m128i*)(p))
+#define tl_store(p, v)     _mm_storeu_si128((__m128i*)(p), (v))
+#define tl_load64(p)       _mm_loadl_epi64((const __m128i*)(p))
+#define tl_store_lo64(p, v) _mm_storel_epi64((__m128i*)(p), (v))
+#define tl_store_hi64(p, v) _mm_storel_epi64((__m128i*)(p), _mm_unpackhi_epi64((v), (v)))
+#define tl_join64(lo, hi)  _mm_unpacklo_epi64((lo), (hi))
+#define tl_zero()          _mm_setzero_si128()
+#define tl_set8(c)         _mm_set1_epi8((char)(c))
+#define tl_set16(c)        _mm_set1_epi16((short)(c))
+#define tl_set32(c)        _mm_set1_epi32((int)(c))
+#define tl_and(a, b)       _mm_and_si128((a), (b))
+#define tl_or(a, b)        _mm_or_si128((a), (b))
+#define tl_cmpeq8(a, b)    _mm_cmpeq_epi8((a), (b))
+#define tl_srl16(v, n)     _mm_srli_epi16((v), (n))
+#define tl_sll16(v, n)     _mm_slli_epi16((v), (n))
+#define tl_sra16(v, n)     _mm_srai_epi16((v), (n))
+#define tl_srl32(v, n)     _mm_srli_epi32((v), (n))
+#define tl_sll32(v, n)     _mm_slli_epi32((v), (n))
+#define tl_mul16(v, c)     _mm_mullo_epi16((v), _mm_set1_epi16((short)(c)))
+#define tl_zip_lo8(a, b)   _mm_unpacklo_epi8((a), (b))
+#define tl_zip_hi8(a, b)   _mm_unpackhi_epi8((a), (b))
+#define tl_zip_lo16(a, b)  _mm_unpacklo_epi16((a), (b))
+#define tl_zip_hi16(a, b)  _mm_unpackhi_epi16((a), (b))
+
+// swaps the two 32-bit words of each 64-bit word (TMEM odd line interleave)
+static INLINE tl_vec tl_swap_words(tl_vec v)
+{
+   return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// reverses the 16-bit halves of each 32-bit word
+static INLINE tl_vec tl_rev16in32(tl_vec v)
+{
+   return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// reverses the 16-bit quarters of each 64-bit word
+static INLINE tl_vec tl_rev16in64(tl_vec v)
+{
+   return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+static INLINE tl_vec tl_bswap16(tl_vec v)
+{
+   return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static INLINE tl_vec tl_bswap32(tl_vec v)
+{
+   return tl_rev16in32(tl_bswap16(v));
+}
+
+// packs eight 32-bit lanes below 0x10000 into 16-bit lanes, a first
+static INLINE tl_vec tl_narrow32(tl_vec a, tl_vec b)
+{
+   a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+   b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+   return _mm_packs_epi32(a, b);
+}
+
+#elif defined(HAVE_NEON) && !defined(TEXLOAD_NO_SIMD)
+#define TEXLOAD_SIMD
+#include <arm_neon.h>
+
+typedef uint8x16_t tl_vec;
+
+#define TL_U16(v)          vreinterpretq_u16_u8(v)
+#define TL_U32(v)          vreinterpretq_u32_u8(v)
+#define TL_V16(v)          vreinterpretq_u8_u16(v)
+#define TL_V32(v)          vreinterpretq_u8_u32(v)
+
+#define tl_load(p)         vld1q_u8((const uint8_t*)(p))
+#define tl_store(p, v)     vst1q_u8((uint8_t*)(p), (v))
+#define tl_load64(p)       vcombine_u8(vld1_u8((const uint8_t*)(p)), vdup_n_u8(0))
+#define tl_store_lo64(p, v) vst1_u8((uint8_t*)(p), vget_low_u8(v))
+#define tl_store_hi64(p, v) vst1_u8((uint8_t*)(p), vget_high_u8(v))
+#define tl_join64(lo, hi)  vcombine_u8(vget_low_u8(lo), vget_low_u8(hi))
+#define tl_zero()          vdupq_n_u8(0)
+#define tl_set8(c)         vdupq_n_u8((uint8_t)(c))
+#define tl_set16(c)        TL_V16(vdupq_n_u16((uint16_t)(c)))
+#define tl_set32(c)        TL_V32(vdupq_n_u32((uint32_t)(c)))
+#define tl_and(a, b)       vandq_u8((a), (b))
+#define tl_or(a, b)        vorrq_u8((a), (b))
+#define tl_cmpeq8(a, b)    vceqq_u8((a), (b))
+#define tl_srl16(v, n)     TL_V16(vshrq_n_u16(TL_U16(v), (n)))
+#define tl_sll16(v, n)     TL_V16(vshlq_n_u16(TL_U16(v), (n)))
+#define tl_sra16(v, n)     TL_V16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u8(v), (n))))
+#define tl_srl32(v, n)     TL_V32(vshrq_n_u32(TL_U32(v), (n)))
+#define tl_sll32(v, n)     TL_V32(vshlq_n_u32(TL_U32(v), (n)))
+#define tl_mul16(v, c)     TL_V16(vmulq_n_u16(TL_U16(v), (uint16_t)(c)))
+#define tl_zip_lo8(a, b)   (vzipq_u8((a), (b)).val[0])
+#define tl_zip_hi8(a, b)   (vzipq_u8((a), (b)).val[1])
+#define tl_zip_lo16(a, b)  TL_V16(vzipq_u16(TL_U16(a), TL_U16(b)).val[0])
+#define tl_zip_hi16(a, b)  TL_V16(vzipq_u16(TL_U16(a), TL_U16(b)).val[1])
+
+static INLINE tl_vec tl_swap_words(tl_vec v)
+{
+   return TL_V32(vrev64q_u32(TL_U32(v)));
+}
+
+static INLINE tl_vec tl_rev16in32(tl_vec v)
+{
+   return TL_V16(vrev32q_u16(TL_U16(v)));
+}
+
+static INLINE tl_vec tl_rev16in64(tl_vec v)
+{
+   return TL_V16(vrev64q_u16(TL_U16(v)));
+}
+
+static INLINE tl_vec tl_bswap16(tl_vec v)
+{
+   return vrev16q_u8(v);
+}
+
+static INLINE tl_vec tl_bswap32(tl_vec v)
+{
+   return vrev32q_u8(v);
+}
+
+static INLINE tl_vec tl_narrow32(tl_vec a, tl_vec b)
+{
+   return TL_V16(vcombine_u16(vmovn_u32(TL_U32(a)), vmovn_u32(TL_U32(b))));
+}
+#endif
+
+#ifdef TEXLOAD_SIMD
+// (v >> 1) | (v << 15) in each 16-bit lane
+static INLINE tl_vec tl_ror16_1(tl_vec v)
+{
+   return tl_or(tl_srl16(v, 1), tl_sll16(v, 15));
+}
+
+// the high and the low nibble of each byte
+static INLINE tl_vec tl_hi4(tl_vec v)
+{
+   return tl_and(tl_srl16(v, 4), tl_set8(0x0F));
+}
+
+static INLINE tl_vec tl_lo4(tl_vec v)
+{
+   return tl_and(v, tl_set8(0x0F));
+}
+
+// n * 0x11 for bytes below 16
+static INLINE tl_vec tl_dup4(tl_vec v)
+{
+   return tl_or(v, tl_sll16(v, 4));
+}
+
+static INLINE tl_vec tl_nibble_swap(tl_vec v)
+{
+   return tl_or(tl_sll16(tl_lo4(v), 4), tl_hi4(v));
+}
+#endif
+
+// Copies qwords 64-bit words with each 32-bit word byte swapped, the way
+// RDRAM is moved into TMEM. dst and src need no alignment.
+static INLINE void tmem_bswap_qwords(uint32_t *dst, const uint32_t *src, int qwords)
+{
+#ifdef TEXLOAD_SIMD
+   for (; qwords >= 2; qwords -= 2, dst += 4, src += 4)
+      tl_store(dst, tl_bswap32(tl_load(src)));
+#endif
+   for (; qwords > 0; qwords--)
+   {
+      *dst++ = bswap32(*src++);
+      *dst++ = bswap32(*src++);
+   }
+}
+
+// Swaps the two 32-bit words of qwords 64-bit words in place, the TMEM
+// interleave of odd lines.
+static INLINE void tmem_swap_words(uint32_t *dst, int qwords)
+{
+#ifdef TEXLOAD_SIMD
+   for (; qwords >= 2; qwords -= 2, dst += 4)
+      tl_store(dst, tl_swap_words(tl_load(dst)));
+#endif
+   for (; qwords > 0; qwords--, dst += 2)
+   {
+      uint32_t t = dst[0];
+      dst[0] = dst[1];
+      dst[1] = t;
+   }
+}
+
+#endif  // ifndef TEXLOADSIMD_H
@@ -37,9 +37,73 @@
 //
 //****************************************************************
 
+#include <float.h>
+
+// The SSE2 paths below do the same float operations in the same order as
+// the scalar loops, four texels at a time, so they give exactly the same
+// texels. That only holds when scalar float math isn't done in x87
+// precision or fused.
+#if !defined(NOSSE) && !defined(TEXMOD_NO_SIMD) && defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0 && !defined(__FMA__) && !defined(__FAST_MATH__)
+#define TEXMOD_SSE2
+#include <emmintrin.h>
+
+// four 16-bit texels, zero extended
+static INLINE __m128i texmod_load(const uint16_t *src)
+{
+   return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i*)src), _mm_setzero_si128());
+}
+
+// stores the low 16 bits of each lane, like the scalar uint16_t store
+static INLINE void texmod_store(uint16_t *dst, __m128i v)
+{
+   v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+   _mm_storel_epi64((__m128i*)dst, _mm_packs_epi32(v, v));
+}
+
+// (col >> shift) & mask
+static INLINE __m128i texmod_field(__m128i col, int shift, int mask)
+{
+   return _mm_and_si128(_mm_srl_epi32(col, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(mask));
+}
+
+// (float)((col >> shift) & mask)
+static INLINE __m128 texmod_float(__m128i col, int shift, int mask)
+{
+   return _mm_cvtepi32_ps(texmod_field(col, shift, mask));
+}
+
+// (uint8_t)v and (uint16_t)v truncate through a 32-bit int
+static INLINE __m128i texmod_u8(__m128 v)
+{
+   return _mm_and_si128(_mm_cvttps_epi32(v), _mm_set1_epi32(0xFF));
+}
+
+static INLINE __m128i texmod_u16(__m128 v)
+{
+   return _mm_and_si128(_mm_cvttps_epi32(v), _mm_set1_epi32(0xFFFF));
+}
+
+// min()/max() of lanes that fit in an int16
+static INLINE __m128i texmod_min(__m128i v, int limit)
+{
+   return _mm_min_epi16(v, _mm_set1_epi32(limit));
+}
+
+static INLINE __m128i texmod_max0(__m128i v)
+{
+   return _mm_max_epi16(v, _mm_setzero_si128());
+}
+
+// a | (r << 8) | (g << 4) | b, a already in place
+static INLINE __m128i texmod_argb(__m128i a, __m128i r, __m128i g, __m128i b)
+{
+   return _mm_or_si128(_mm_or_si128(a, _mm_slli_epi32(r, 8)), _mm_or_si128(_mm_slli_epi32(g, 4), b));
+}
+#endif
+
 static void mod_tex_inter_color_using_factor (uint16_t *dst, int size, uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
    float percent = factor / 255.0f;
    float percent_i = 1 - percent;
    uint32_t cr, cg, cb;
@@ -50,7 +114,19 @@ static void mod_tex_inter_color_using_factor (uint16_t *dst, int size, uint32_t
    cg = (color >> 8) & 0xF;
    cb = (color >> 4) & 0xF;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), vpi = _mm_set1_ps(percent_i);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(vpi, texmod_float(c, 8, 0xF)), _mm_mul_ps(vp, vcr)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(vpi, texmod_float(c, 4, 0xF)), _mm_mul_ps(vp, vcg)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(vpi, texmod_float(c, 0, 0xF)), _mm_mul_ps(vp, vcb)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       a = col & 0xF000;
@@ -63,7 +139,7 @@ static void mod_tex_inter_color_using_factor (uint16_t *dst, int size, uint32_t
 
 static void mod_tex_inter_col_using_col1 (uint16_t *dst, int size, uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
 	uint32_t cr, cg, cb;
 	uint16_t col, a;
 	uint8_t r, g, b;
@@ -79,7 +155,20 @@ static void mod_tex_inter_col_using_col1 (uint16_t *dst, int size, uint32_t colo
 	cg = (color0 >> 8) & 0xF;
 	cb = (color0 >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vpr = _mm_set1_ps(percent_r), vpg = _mm_set1_ps(percent_g), vpb = _mm_set1_ps(percent_b);
+   __m128 vpr_i = _mm_set1_ps(percent_r_i), vpg_i = _mm_set1_ps(percent_g_i), vpb_i = _mm_set1_ps(percent_b_i);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(vpr_i, texmod_float(c, 8, 0xF)), _mm_mul_ps(vpr, vcr)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(vpg_i, texmod_float(c, 4, 0xF)), _mm_mul_ps(vpg, vcg)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(vpb_i, texmod_float(c, 0, 0xF)), _mm_mul_ps(vpb, vcb)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
    {
       col = *dst;
       a = col & 0xF000;
@@ -92,7 +181,7 @@ static void mod_tex_inter_col_using_col1 (uint16_t *dst, int size, uint32_t colo
 
 static void mod_full_color_sub_tex (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
    uint32_t cr, cg, cb, ca;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -102,7 +191,20 @@ static void mod_full_color_sub_tex (uint16_t *dst, int size, uint32_t color)
    cb = (color >> 4) & 0xF;
    ca = color & 0xF;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128i vca = _mm_set1_epi32(ca), vcr = _mm_set1_epi32(cr), vcg = _mm_set1_epi32(cg), vcb = _mm_set1_epi32(cb);
+   __m128i byte = _mm_set1_epi32(0xFF);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i a = _mm_and_si128(_mm_sub_epi32(vca, texmod_field(c, 12, 0xF)), byte);
+      __m128i r = _mm_and_si128(_mm_sub_epi32(vcr, texmod_field(c, 8, 0xF)), byte);
+      __m128i g = _mm_and_si128(_mm_sub_epi32(vcg, texmod_field(c, 4, 0xF)), byte);
+      __m128i b = _mm_and_si128(_mm_sub_epi32(vcb, texmod_field(c, 0, 0xF)), byte);
+      texmod_store(dst, texmod_argb(_mm_slli_epi32(a, 12), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       a = (uint8_t)(ca - ((col >> 12) & 0xF));
@@ -115,7 +217,7 @@ static void mod_full_color_sub_tex (uint16_t *dst, int size, uint32_t color)
 
 static void mod_col_inter_col1_using_tex (uint16_t *dst, int size, uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
    uint32_t cr0, cg0, cb0, cr1, cg1, cb1;
    uint16_t col;
    uint8_t r, g, b;
@@ -129,7 +231,23 @@ static void mod_col_inter_col1_using_tex (uint16_t *dst, int size, uint32_t colo
    cg1 = (color1 >> 8) & 0xF;
    cb1 = (color1 >> 4) & 0xF;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f), bias = _mm_set1_ps(0.0001f);
+   __m128 vcr0 = _mm_set1_ps((float)cr0), vcg0 = _mm_set1_ps((float)cg0), vcb0 = _mm_set1_ps((float)cb0);
+   __m128 vcr1 = _mm_set1_ps((float)cr1), vcg1 = _mm_set1_ps((float)cg1), vcb1 = _mm_set1_ps((float)cb1);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 pr = _mm_div_ps(texmod_float(c, 8, 0xF), v15);
+      __m128 pg = _mm_div_ps(texmod_float(c, 4, 0xF), v15);
+      __m128 pb = _mm_div_ps(texmod_float(c, 0, 0xF), v15);
+      __m128i r = texmod_min(texmod_u8(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pr), vcr0), _mm_mul_ps(pr, vcr1)), bias)), 15);
+      __m128i g = texmod_min(texmod_u8(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pg), vcg0), _mm_mul_ps(pg, vcg1)), bias)), 15);
+      __m128i b = texmod_min(texmod_u8(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pb), vcb0), _mm_mul_ps(pb, vcb1)), bias)), 15);
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       a = col & 0xF000;
@@ -145,7 +263,7 @@ static void mod_col_inter_col1_using_tex (uint16_t *dst, int size, uint32_t colo
 
 static void mod_col_inter_col1_using_texa (uint16_t *dst, int size, uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
 	uint32_t cr0, cg0, cb0, cr1, cg1, cb1;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -159,7 +277,22 @@ static void mod_col_inter_col1_using_texa (uint16_t *dst, int size, uint32_t col
 	cg1 = (color1 >> 8) & 0xF;
 	cb1 = (color1 >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr0 = _mm_set1_ps((float)cr0), vcg0 = _mm_set1_ps((float)cg0), vcb0 = _mm_set1_ps((float)cb0);
+   __m128 vcr1 = _mm_set1_ps((float)cr1), vcg1 = _mm_set1_ps((float)cg1), vcb1 = _mm_set1_ps((float)cb1);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 p = _mm_div_ps(texmod_float(c, 12, 0xF), v15);
+      __m128 pi = _mm_sub_ps(one, p);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(pi, vcr0), _mm_mul_ps(p, vcr1)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(pi, vcg0), _mm_mul_ps(p, vcg1)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(pi, vcb0), _mm_mul_ps(p, vcb1)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -174,7 +307,7 @@ static void mod_col_inter_col1_using_texa (uint16_t *dst, int size, uint32_t col
 
 static void mod_col_inter_col1_using_texa__mul_tex (uint16_t *dst, int size, uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
 	uint32_t cr0, cg0, cb0, cr1, cg1, cb1;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -188,7 +321,22 @@ static void mod_col_inter_col1_using_texa__mul_tex (uint16_t *dst, int size, uin
 	cg1 = (color1 >> 8) & 0xF;
 	cb1 = (color1 >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr0 = _mm_set1_ps((float)cr0), vcg0 = _mm_set1_ps((float)cg0), vcb0 = _mm_set1_ps((float)cb0);
+   __m128 vcr1 = _mm_set1_ps((float)cr1), vcg1 = _mm_set1_ps((float)cg1), vcb1 = _mm_set1_ps((float)cb1);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 p = _mm_div_ps(texmod_float(c, 12, 0xF), v15);
+      __m128 pi = _mm_sub_ps(one, p);
+      __m128i r = texmod_u8(_mm_mul_ps(_mm_mul_ps(_mm_div_ps(_mm_add_ps(_mm_mul_ps(pi, vcr0), _mm_mul_ps(p, vcr1)), v15), _mm_div_ps(texmod_float(c, 8, 0xF), v15)), v15));
+      __m128i g = texmod_u8(_mm_mul_ps(_mm_mul_ps(_mm_div_ps(_mm_add_ps(_mm_mul_ps(pi, vcg0), _mm_mul_ps(p, vcg1)), v15), _mm_div_ps(texmod_float(c, 4, 0xF), v15)), v15));
+      __m128i b = texmod_u8(_mm_mul_ps(_mm_mul_ps(_mm_div_ps(_mm_add_ps(_mm_mul_ps(pi, vcb0), _mm_mul_ps(p, vcb1)), v15), _mm_div_ps(texmod_float(c, 0, 0xF), v15)), v15));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -203,7 +351,7 @@ static void mod_col_inter_col1_using_texa__mul_tex (uint16_t *dst, int size, uin
 
 static void mod_col_inter_tex_using_tex (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
 	uint32_t cr, cg, cb;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -214,7 +362,22 @@ static void mod_col_inter_tex_using_tex (uint16_t *dst, int size, uint32_t color
 	cg = (color >> 8) & 0xF;
 	cb = (color >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 tr = texmod_float(c, 8, 0xF), pr = _mm_div_ps(tr, v15);
+      __m128 tg = texmod_float(c, 4, 0xF), pg = _mm_div_ps(tg, v15);
+      __m128 tb = texmod_float(c, 0, 0xF), pb = _mm_div_ps(tb, v15);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pr), vcr), _mm_mul_ps(pr, tr)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pg), vcg), _mm_mul_ps(pg, tg)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pb), vcb), _mm_mul_ps(pb, tb)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -230,7 +393,7 @@ static void mod_col_inter_tex_using_tex (uint16_t *dst, int size, uint32_t color
 
 static void mod_col_inter_tex_using_texa (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
 	uint32_t cr, cg, cb;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -241,7 +404,21 @@ static void mod_col_inter_tex_using_texa (uint16_t *dst, int size, uint32_t colo
 	cg = (color >> 8) & 0xF;
 	cb = (color >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 p = _mm_div_ps(texmod_float(c, 12, 0xF), v15);
+      __m128 pi = _mm_sub_ps(one, p);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(pi, vcr), _mm_mul_ps(p, texmod_float(c, 8, 0xF))));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(pi, vcg), _mm_mul_ps(p, texmod_float(c, 4, 0xF))));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(pi, vcb), _mm_mul_ps(p, texmod_float(c, 0, 0xF))));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -258,7 +435,7 @@ static void mod_col2_inter__col_inter_col1_using_tex__using_texa (uint16_t *dst,
 																  uint32_t color0, uint32_t color1,
 																  uint32_t color2)
 {
-   int i;
+   int i = 0;
 	uint32_t cr0, cg0, cb0, cr1, cg1, cb1, cr2, cg2, cb2;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -275,7 +452,26 @@ static void mod_col2_inter__col_inter_col1_using_tex__using_texa (uint16_t *dst,
 	cg2 = (color2 >> 8) & 0xF;
 	cb2 = (color2 >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr0 = _mm_set1_ps((float)cr0), vcg0 = _mm_set1_ps((float)cg0), vcb0 = _mm_set1_ps((float)cb0);
+   __m128 vcr1 = _mm_set1_ps((float)cr1), vcg1 = _mm_set1_ps((float)cg1), vcb1 = _mm_set1_ps((float)cb1);
+   __m128 vcr2 = _mm_set1_ps((float)cr2), vcg2 = _mm_set1_ps((float)cg2), vcb2 = _mm_set1_ps((float)cb2);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 pa = _mm_div_ps(texmod_float(c, 12, 0xF), v15);
+      __m128 pa_i = _mm_sub_ps(one, pa);
+      __m128 pr = _mm_div_ps(texmod_float(c, 8, 0xF), v15);
+      __m128 pg = _mm_div_ps(texmod_float(c, 4, 0xF), v15);
+      __m128 pb = _mm_div_ps(texmod_float(c, 0, 0xF), v15);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pr), vcr0), _mm_mul_ps(pr, vcr1)), pa), _mm_mul_ps(vcr2, pa_i)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pg), vcg0), _mm_mul_ps(pg, vcg1)), pa), _mm_mul_ps(vcg2, pa_i)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pb), vcb0), _mm_mul_ps(pb, vcb1)), pa), _mm_mul_ps(vcb2, pa_i)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -292,13 +488,22 @@ static void mod_col2_inter__col_inter_col1_using_tex__using_texa (uint16_t *dst,
 
 static void mod_tex_scale_fac_add_fac (uint16_t *dst, int size, uint32_t factor)
 {
-   int i;
+   int i = 0;
 	float percent = factor / 255.0f;
 	uint16_t col;
 	uint8_t a;
 	float base_a = (1.0f - percent) * 15.0f;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), vbase = _mm_set1_ps(base_a);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i a = texmod_u8(_mm_add_ps(vbase, _mm_mul_ps(vp, texmod_float(c, 12, 0xF))));
+      texmod_store(dst, _mm_or_si128(_mm_slli_epi32(a, 12), _mm_and_si128(c, _mm_set1_epi32(0x0FFF))));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = (uint8_t)(base_a + percent * (col>>12));
@@ -308,7 +513,7 @@ static void mod_tex_scale_fac_add_fac (uint16_t *dst, int size, uint32_t factor)
 
 static void mod_tex_sub_col_mul_fac_add_tex (uint16_t *dst, int size, uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
 	float percent = factor / 255.0f;
 	uint32_t cr, cg, cb;
 	uint16_t col, a;
@@ -318,7 +523,22 @@ static void mod_tex_sub_col_mul_fac_add_tex (uint16_t *dst, int size, uint32_t c
 	cg = (color >> 8) & 0xF;
 	cb = (color >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), zero = _mm_setzero_ps(), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 tr = texmod_float(c, 8, 0xF);
+      __m128 tg = texmod_float(c, 4, 0xF);
+      __m128 tb = texmod_float(c, 0, 0xF);
+      __m128i r = texmod_u16(_mm_max_ps(_mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(tr, vcr), vp), tr), v15), zero));
+      __m128i g = texmod_u16(_mm_max_ps(_mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(tg, vcg), vp), tg), v15), zero));
+      __m128i b = texmod_u16(_mm_max_ps(_mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(tb, vcb), vp), tb), v15), zero));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -341,7 +561,7 @@ static void mod_tex_sub_col_mul_fac_add_tex (uint16_t *dst, int size, uint32_t c
 
 static void mod_tex_scale_col_add_col (uint16_t *dst, int size, uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
 	uint32_t cr0, cg0, cb0, cr1, cg1, cb1;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -355,7 +575,20 @@ static void mod_tex_scale_col_add_col (uint16_t *dst, int size, uint32_t color0,
 	cg1 = (color1 >> 8) & 0xF;
 	cb1 = (color1 >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 v15 = _mm_set1_ps(15.0f), bias = _mm_set1_ps(0.0001f);
+   __m128 vcr0 = _mm_set1_ps((float)cr0), vcg0 = _mm_set1_ps((float)cg0), vcb0 = _mm_set1_ps((float)cb0);
+   __m128 vcr1 = _mm_set1_ps((float)cr1), vcg1 = _mm_set1_ps((float)cg1), vcb1 = _mm_set1_ps((float)cb1);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_min(texmod_u8(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_div_ps(texmod_float(c, 8, 0xF), v15), vcr0), vcr1), bias)), 15);
+      __m128i g = texmod_min(texmod_u8(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_div_ps(texmod_float(c, 4, 0xF), v15), vcg0), vcg1), bias)), 15);
+      __m128i b = texmod_min(texmod_u8(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_div_ps(texmod_float(c, 0, 0xF), v15), vcb0), vcb1), bias)), 15);
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -371,7 +604,7 @@ static void mod_tex_scale_col_add_col (uint16_t *dst, int size, uint32_t color0,
 
 static void mod_tex_add_col (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
    uint32_t cr, cg, cb;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -380,7 +613,19 @@ static void mod_tex_add_col (uint16_t *dst, int size, uint32_t color)
    cg = (color >> 8) & 0xF;
    cb = (color >> 4) & 0xF;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128i vcr = _mm_set1_epi32(cr), vcg = _mm_set1_epi32(cg), vcb = _mm_set1_epi32(cb);
+   __m128i nibble = _mm_set1_epi32(0xF);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = _mm_and_si128(_mm_add_epi32(vcr, texmod_field(c, 8, 0xF)), nibble);
+      __m128i g = _mm_and_si128(_mm_add_epi32(vcg, texmod_field(c, 4, 0xF)), nibble);
+      __m128i b = _mm_and_si128(_mm_add_epi32(vcb, texmod_field(c, 0, 0xF)), nibble);
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       a = (uint8_t)((col >> 12) & 0xF);
@@ -394,7 +639,7 @@ static void mod_tex_add_col (uint16_t *dst, int size, uint32_t color)
 
 static void mod_col_mul_texa_add_tex (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
 	uint32_t cr, cg, cb;
 	uint16_t col;
 	uint8_t r, g, b;
@@ -405,7 +650,21 @@ static void mod_col_mul_texa_add_tex (uint16_t *dst, int size, uint32_t color)
 	cg = (color >> 8) & 0xF;
 	cb = (color >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 v15 = _mm_set1_ps(15.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   __m128i nibble = _mm_set1_epi32(0xF);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 f = _mm_div_ps(texmod_float(c, 12, 0xF), v15);
+      __m128i r = _mm_and_si128(texmod_u8(_mm_add_ps(_mm_mul_ps(vcr, f), texmod_float(c, 8, 0xF))), nibble);
+      __m128i g = _mm_and_si128(texmod_u8(_mm_add_ps(_mm_mul_ps(vcg, f), texmod_float(c, 4, 0xF))), nibble);
+      __m128i b = _mm_and_si128(texmod_u8(_mm_add_ps(_mm_mul_ps(vcb, f), texmod_float(c, 0, 0xF))), nibble);
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -419,7 +678,7 @@ static void mod_col_mul_texa_add_tex (uint16_t *dst, int size, uint32_t color)
 
 static void mod_tex_sub_col (uint16_t *dst, int size, uint32_t color)
 {
-   int i, cr, cg, cb;
+   int i = 0, cr, cg, cb;
 	uint16_t col;
 	uint8_t a, r, g, b;
 
@@ -427,7 +686,19 @@ static void mod_tex_sub_col (uint16_t *dst, int size, uint32_t color)
 	cg = (color >> 8) & 0xF;
 	cb = (color >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   // a is (uint8_t)(col & 0xF000) there, so alpha always ends up 0
+   __m128i vcr = _mm_set1_epi32(cr), vcg = _mm_set1_epi32(cg), vcb = _mm_set1_epi32(cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_max0(_mm_sub_epi32(texmod_field(c, 8, 0xF), vcr));
+      __m128i g = texmod_max0(_mm_sub_epi32(texmod_field(c, 4, 0xF), vcg));
+      __m128i b = texmod_max0(_mm_sub_epi32(texmod_field(c, 0, 0xF), vcb));
+      texmod_store(dst, texmod_argb(_mm_setzero_si128(), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = (uint8_t)(col & 0xF000);
@@ -440,7 +711,7 @@ static void mod_tex_sub_col (uint16_t *dst, int size, uint32_t color)
 
 static void mod_tex_sub_col_mul_fac (uint16_t *dst, int size, uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
 	float percent = factor / 255.0f;
 	uint32_t cr, cg, cb;
 	uint16_t col, a;
@@ -450,7 +721,19 @@ static void mod_tex_sub_col_mul_fac (uint16_t *dst, int size, uint32_t color, ui
 	cg = (color >> 8) & 0xF;
 	cb = (color >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), zero = _mm_setzero_ps(), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_u16(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(texmod_float(c, 8, 0xF), vcr), vp), v15), zero));
+      __m128i g = texmod_u16(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(texmod_float(c, 4, 0xF), vcg), vp), v15), zero));
+      __m128i b = texmod_u16(_mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_sub_ps(texmod_float(c, 0, 0xF), vcb), vp), v15), zero));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = (uint8_t)((col >> 12) & 0xF);
@@ -473,7 +756,7 @@ static void mod_tex_sub_col_mul_fac (uint16_t *dst, int size, uint32_t color, ui
 
 static void mod_col_inter_tex_using_col1 (uint16_t *dst, int size, uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
 	uint32_t cr, cg, cb;
 	uint16_t col, a;
 	uint8_t r, g, b;
@@ -489,7 +772,20 @@ static void mod_col_inter_tex_using_col1 (uint16_t *dst, int size, uint32_t colo
 	cg = (color0 >> 8) & 0xF;
 	cb = (color0 >> 4) & 0xF;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vpr = _mm_set1_ps(percent_r), vpg = _mm_set1_ps(percent_g), vpb = _mm_set1_ps(percent_b);
+   __m128 vpr_i = _mm_set1_ps(percent_r_i), vpg_i = _mm_set1_ps(percent_g_i), vpb_i = _mm_set1_ps(percent_b_i);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(vpr, texmod_float(c, 8, 0xF)), _mm_mul_ps(vpr_i, vcr)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(vpg, texmod_float(c, 4, 0xF)), _mm_mul_ps(vpg_i, vcg)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(vpb, texmod_float(c, 0, 0xF)), _mm_mul_ps(vpb_i, vcb)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = (uint8_t)((col >> 12) & 0xF);
@@ -502,7 +798,7 @@ static void mod_col_inter_tex_using_col1 (uint16_t *dst, int size, uint32_t colo
 
 static void mod_tex_inter_noise_using_col (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
 	uint16_t col, a;
 	uint8_t r, g, b, noise;
 
@@ -513,7 +809,22 @@ static void mod_tex_inter_noise_using_col (uint16_t *dst, int size, uint32_t col
 	float percent_g_i = 1.0f - percent_g;
 	float percent_b_i = 1.0f - percent_b;
 
-	for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vpr = _mm_set1_ps(percent_r), vpg = _mm_set1_ps(percent_g), vpb = _mm_set1_ps(percent_b);
+   __m128 vpr_i = _mm_set1_ps(percent_r_i), vpg_i = _mm_set1_ps(percent_g_i), vpb_i = _mm_set1_ps(percent_b_i);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      // same rand() sequence as the scalar loop
+      int n0 = rand()%16, n1 = rand()%16, n2 = rand()%16, n3 = rand()%16;
+      __m128 vn = _mm_cvtepi32_ps(_mm_setr_epi32(n0, n1, n2, n3));
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(vpr_i, texmod_float(c, 8, 0xF)), _mm_mul_ps(vpr, vn)));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(vpg_i, texmod_float(c, 4, 0xF)), _mm_mul_ps(vpg, vn)));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(vpb_i, texmod_float(c, 0, 0xF)), _mm_mul_ps(vpb, vn)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+	for (; i < size; i++)
 	{
 		col = *dst;
 		a = col & 0xF000;
@@ -527,7 +838,7 @@ static void mod_tex_inter_noise_using_col (uint16_t *dst, int size, uint32_t col
 
 static void mod_tex_inter_col_using_texa (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
    uint32_t cr, cg, cb;
    uint16_t col;
    uint8_t r, g, b;
@@ -538,7 +849,21 @@ static void mod_tex_inter_col_using_texa (uint16_t *dst, int size, uint32_t colo
    cg = (color >> 8) & 0xF;
    cb = (color >> 4) & 0xF;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v15 = _mm_set1_ps(15.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128 p = _mm_div_ps(texmod_float(c, 12, 0xF), v15);
+      __m128 pi = _mm_sub_ps(one, p);
+      __m128i r = texmod_u8(_mm_add_ps(_mm_mul_ps(p, vcr), _mm_mul_ps(pi, texmod_float(c, 8, 0xF))));
+      __m128i g = texmod_u8(_mm_add_ps(_mm_mul_ps(p, vcg), _mm_mul_ps(pi, texmod_float(c, 4, 0xF))));
+      __m128i b = texmod_u8(_mm_add_ps(_mm_mul_ps(p, vcb), _mm_mul_ps(pi, texmod_float(c, 0, 0xF))));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       a = col & 0xF000;
@@ -553,7 +878,7 @@ static void mod_tex_inter_col_using_texa (uint16_t *dst, int size, uint32_t colo
 
 static void mod_tex_mul_col (uint16_t *dst, int size, uint32_t color)
 {
-   int i;
+   int i = 0;
    float cr, cg, cb;
    uint16_t col;
    uint8_t r, g, b;
@@ -563,7 +888,18 @@ static void mod_tex_mul_col (uint16_t *dst, int size, uint32_t color)
    cg = (float)((color >> 8) & 0xF)/16.0f;
    cb = (float)((color >> 4) & 0xF)/16.0f;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vcr = _mm_set1_ps(cr), vcg = _mm_set1_ps(cg), vcb = _mm_set1_ps(cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_u8(_mm_mul_ps(vcr, texmod_float(c, 8, 0xF)));
+      __m128i g = texmod_u8(_mm_mul_ps(vcg, texmod_float(c, 4, 0xF)));
+      __m128i b = texmod_u8(_mm_mul_ps(vcb, texmod_float(c, 0, 0xF)));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       a = col & 0xF000;
@@ -576,7 +912,7 @@ static void mod_tex_mul_col (uint16_t *dst, int size, uint32_t color)
 
 static void mod_tex_scale_fac_add_col (uint16_t *dst, int size, uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
    float percent = factor / 255.0f;
    uint32_t cr, cg, cb;
    uint16_t col;
@@ -586,7 +922,19 @@ static void mod_tex_scale_fac_add_col (uint16_t *dst, int size, uint32_t color,
    cg = (color >> 8) & 0xF;
    cb = (color >> 4) & 0xF;
 
-   for (i = 0; i < size; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i + 4 <= size; i += 4, dst += 4)
+   {
+      __m128i c = texmod_load(dst);
+      __m128i r = texmod_u8(_mm_add_ps(vcr, _mm_mul_ps(vp, texmod_float(c, 8, 0xF))));
+      __m128i g = texmod_u8(_mm_add_ps(vcg, _mm_mul_ps(vp, texmod_float(c, 4, 0xF))));
+      __m128i b = texmod_u8(_mm_add_ps(vcb, _mm_mul_ps(vp, texmod_float(c, 0, 0xF))));
+      texmod_store(dst, texmod_argb(_mm_and_si128(c, _mm_set1_epi32(0xF000)), r, g, b));
+   }
+#endif
+   for (; i < size; i++)
    {
       col = *dst;
       r = cr + percent * (float)((col>>8)&0xF);
@@ -37,9 +37,38 @@
 //
 //****************************************************************
 
+#ifdef TEXMOD_SSE2
+// (float)(5-bit channel) / 31.0f * 255.0f
+static INLINE __m128 texmod_ci_float(__m128i col, int shift)
+{
+   return _mm_mul_ps(_mm_div_ps(texmod_float(col, shift, 0x1F), _mm_set1_ps(31.0f)), _mm_set1_ps(255.0f));
+}
+
+// the 8-bit channel as a float again, as it is used after (uint8_t)
+static INLINE __m128 texmod_ci_u8float(__m128i col, int shift)
+{
+   return _mm_cvtepi32_ps(texmod_u8(texmod_ci_float(col, shift)));
+}
+
+// ((r >> 3) << 11) | ((g >> 3) << 6) | ((b >> 3) << 1) | a
+static INLINE __m128i texmod_ci_pack(__m128i r, __m128i g, __m128i b, __m128i a)
+{
+   r = _mm_slli_epi32(_mm_srli_epi32(r, 3), 11);
+   g = _mm_slli_epi32(_mm_srli_epi32(g, 3), 6);
+   b = _mm_slli_epi32(_mm_srli_epi32(b, 3), 1);
+   return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+// v > 255.0f ? 255.0f : v, then v < 0.0f ? 0.0f : v
+static INLINE __m128 texmod_ci_clamp(__m128 v)
+{
+   return _mm_max_ps(_mm_min_ps(v, _mm_set1_ps(255.0f)), _mm_setzero_ps());
+}
+#endif
+
 static void mod_tex_inter_color_using_factor_CI (uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
    float percent = factor / 255.0f;
    float percent_i = 1 - percent;
    uint8_t cr, cg, cb;
@@ -50,7 +79,21 @@ static void mod_tex_inter_color_using_factor_CI (uint32_t color, uint32_t factor
    cg = (uint8_t)((color >> 16) & 0xFF);
    cb = (uint8_t)((color >> 8) & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), vpi = _mm_set1_ps(percent_i);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   __m128 v255 = _mm_set1_ps(255.0f);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpi, texmod_ci_u8float(c, 11)), _mm_mul_ps(vp, vcr)), v255));
+      __m128i g = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpi, texmod_ci_u8float(c, 6)), _mm_mul_ps(vp, vcg)), v255));
+      __m128i b = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpi, texmod_ci_u8float(c, 1)), _mm_mul_ps(vp, vcb)), v255));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -69,7 +112,7 @@ static void mod_tex_inter_color_using_factor_CI (uint32_t color, uint32_t factor
 
 static void mod_tex_inter_col_using_col1_CI (uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
    uint8_t cr, cg, cb;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -85,7 +128,22 @@ static void mod_tex_inter_col_using_col1_CI (uint32_t color0, uint32_t color1)
    cg = (uint8_t)((color0 >> 16) & 0xFF);
    cb = (uint8_t)((color0 >> 8)  & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vpr = _mm_set1_ps(percent_r), vpg = _mm_set1_ps(percent_g), vpb = _mm_set1_ps(percent_b);
+   __m128 vpr_i = _mm_set1_ps(percent_r_i), vpg_i = _mm_set1_ps(percent_g_i), vpb_i = _mm_set1_ps(percent_b_i);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   __m128 v255 = _mm_set1_ps(255.0f);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpr_i, texmod_ci_u8float(c, 11)), _mm_mul_ps(vpr, vcr)), v255));
+      __m128i g = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpg_i, texmod_ci_u8float(c, 6)), _mm_mul_ps(vpg, vcg)), v255));
+      __m128i b = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpb_i, texmod_ci_u8float(c, 1)), _mm_mul_ps(vpb, vcb)), v255));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -104,7 +162,7 @@ static void mod_tex_inter_col_using_col1_CI (uint32_t color0, uint32_t color1)
 
 static void mod_full_color_sub_tex_CI (uint32_t color)
 {
-   int i;
+   int i = 0;
    uint8_t cr, cg, cb, ca;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -114,7 +172,20 @@ static void mod_full_color_sub_tex_CI (uint32_t color)
    cb = (uint8_t)((color >> 8) & 0xFF);
    ca = (uint8_t)(color & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128i vca = _mm_set1_epi32(ca), vcr = _mm_set1_epi32(cr), vcg = _mm_set1_epi32(cg), vcb = _mm_set1_epi32(cb);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_max0(_mm_sub_epi32(vcr, texmod_u8(texmod_ci_float(c, 11))));
+      __m128i g = texmod_max0(_mm_sub_epi32(vcg, texmod_u8(texmod_ci_float(c, 6))));
+      __m128i b = texmod_max0(_mm_sub_epi32(vcb, texmod_u8(texmod_ci_float(c, 1))));
+      a = texmod_max0(_mm_sub_epi32(vca, a));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -134,7 +205,7 @@ static void mod_full_color_sub_tex_CI (uint32_t color)
 
 static void mod_col_inter_col1_using_tex_CI (uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
    uint32_t cr0, cg0, cb0, cr1, cg1, cb1;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -147,7 +218,25 @@ static void mod_col_inter_col1_using_tex_CI (uint32_t color0, uint32_t color1)
    cg1 = (uint8_t)((color1 >> 16) & 0xFF);
    cb1 = (uint8_t)((color1 >> 8)  & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 one = _mm_set1_ps(1.0f), v31 = _mm_set1_ps(31.0f);
+   __m128 vcr0 = _mm_set1_ps((float)cr0), vcg0 = _mm_set1_ps((float)cg0), vcb0 = _mm_set1_ps((float)cb0);
+   __m128 vcr1 = _mm_set1_ps((float)cr1), vcg1 = _mm_set1_ps((float)cg1), vcb1 = _mm_set1_ps((float)cb1);
+   __m128 v255 = _mm_set1_ps(255.0f);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128 pr = _mm_div_ps(texmod_float(c, 11, 0x1F), v31);
+      __m128 pg = _mm_div_ps(texmod_float(c, 6, 0x1F), v31);
+      __m128 pb = _mm_div_ps(texmod_float(c, 1, 0x1F), v31);
+      __m128i r = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pr), vcr0), _mm_mul_ps(pr, vcr1)), v255));
+      __m128i g = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pg), vcg0), _mm_mul_ps(pg, vcg1)), v255));
+      __m128i b = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(one, pb), vcb0), _mm_mul_ps(pb, vcb1)), v255));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -166,7 +255,7 @@ static void mod_col_inter_col1_using_tex_CI (uint32_t color0, uint32_t color1)
 
 static void mod_tex_sub_col_mul_fac_add_tex_CI(uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
    float percent = factor / 255.0f;
    uint8_t cr, cg, cb, a;
    uint16_t col;
@@ -176,7 +265,31 @@ static void mod_tex_sub_col_mul_fac_add_tex_CI(uint32_t color, uint32_t factor)
    cg = (uint8_t)((color >> 16) & 0xFF);
    cb = (uint8_t)((color >> 8) & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), v255 = _mm_set1_ps(255.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128 fr = texmod_ci_u8float(c, 11);
+      __m128 fg = texmod_ci_u8float(c, 6);
+      __m128 fb = texmod_ci_u8float(c, 1);
+      __m128 over;
+      fr = texmod_ci_clamp(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(fr, vcr), vp), fr));
+      fg = texmod_ci_clamp(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(fg, vcg), vp), fg));
+      fb = _mm_add_ps(_mm_mul_ps(_mm_sub_ps(fb, vcb), vp), fb);
+      // b > 255 clamps g there, not b
+      over = _mm_cmpgt_ps(fb, v255);
+      fg = _mm_or_ps(_mm_and_ps(over, v255), _mm_andnot_ps(over, fg));
+      fb = _mm_max_ps(fb, _mm_setzero_ps());
+      __m128i r = texmod_u8(fr);
+      __m128i g = texmod_u8(fg);
+      __m128i b = texmod_u8(fb);
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -201,7 +314,7 @@ static void mod_tex_sub_col_mul_fac_add_tex_CI(uint32_t color, uint32_t factor)
 
 static void mod_tex_scale_col_add_col_CI (uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
    uint8_t cr, cg, cb;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -213,7 +326,21 @@ static void mod_tex_scale_col_add_col_CI (uint32_t color0, uint32_t color1)
    cg = (uint8_t)((color1 >> 16) & 0xFF);
    cb = (uint8_t)((color1 >> 8)  & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vpr = _mm_set1_ps(percent_r), vpg = _mm_set1_ps(percent_g), vpb = _mm_set1_ps(percent_b);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   __m128 v255 = _mm_set1_ps(255.0f);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpr, texmod_ci_u8float(c, 11)), vcr), v255));
+      __m128i g = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpg, texmod_ci_u8float(c, 6)), vcg), v255));
+      __m128i b = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpb, texmod_ci_u8float(c, 1)), vcb), v255));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -232,7 +359,7 @@ static void mod_tex_scale_col_add_col_CI (uint32_t color0, uint32_t color1)
 
 static void mod_tex_add_col_CI (uint32_t color)
 {
-   int i;
+   int i = 0;
    uint8_t cr, cg, cb;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -241,7 +368,19 @@ static void mod_tex_add_col_CI (uint32_t color)
    cg = (uint8_t)((color >> 16) & 0xFF);
    cb = (uint8_t)((color >> 8) & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128i vcr = _mm_set1_epi32(cr), vcg = _mm_set1_epi32(cg), vcb = _mm_set1_epi32(cb);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_min(_mm_add_epi32(vcr, texmod_u8(texmod_ci_float(c, 11))), 255);
+      __m128i g = texmod_min(_mm_add_epi32(vcg, texmod_u8(texmod_ci_float(c, 6))), 255);
+      __m128i b = texmod_min(_mm_add_epi32(vcb, texmod_u8(texmod_ci_float(c, 1))), 255);
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -260,7 +399,7 @@ static void mod_tex_add_col_CI (uint32_t color)
 
 static void mod_tex_sub_col_CI (uint32_t color)
 {
-   int i;
+   int i = 0;
    uint8_t cr, cg, cb;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -269,7 +408,19 @@ static void mod_tex_sub_col_CI (uint32_t color)
    cg = (uint8_t)((color >> 16) & 0xFF);
    cb = (uint8_t)((color >> 8) & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128i vcr = _mm_set1_epi32(cr), vcg = _mm_set1_epi32(cg), vcb = _mm_set1_epi32(cb);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_max0(_mm_sub_epi32(texmod_u8(texmod_ci_float(c, 11)), vcr));
+      __m128i g = texmod_max0(_mm_sub_epi32(texmod_u8(texmod_ci_float(c, 6)), vcg));
+      __m128i b = texmod_max0(_mm_sub_epi32(texmod_u8(texmod_ci_float(c, 1)), vcb));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -288,7 +439,7 @@ static void mod_tex_sub_col_CI (uint32_t color)
 
 static void mod_tex_sub_col_mul_fac_CI (uint32_t color, uint32_t factor)
 {
-   int i;
+   int i = 0;
 	float percent = factor / 255.0f;
 	uint8_t cr, cg, cb;
 	uint16_t col;
@@ -299,7 +450,28 @@ static void mod_tex_sub_col_mul_fac_CI (uint32_t color, uint32_t factor)
 	cg = (uint8_t)((color >> 16) & 0xFF);
 	cb = (uint8_t)((color >> 8) & 0xFF);
 
-	for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vp = _mm_set1_ps(percent), v255 = _mm_set1_ps(255.0f);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128 over;
+      __m128 fr = texmod_ci_clamp(_mm_mul_ps(_mm_sub_ps(texmod_ci_float(c, 11), vcr), vp));
+      __m128 fg = texmod_ci_clamp(_mm_mul_ps(_mm_sub_ps(texmod_ci_float(c, 6), vcg), vp));
+      __m128 fb = _mm_mul_ps(_mm_sub_ps(texmod_ci_float(c, 1), vcb), vp);
+      // b > 255 clamps g there, not b
+      over = _mm_cmpgt_ps(fb, v255);
+      fg = _mm_or_ps(_mm_and_ps(over, v255), _mm_andnot_ps(over, fg));
+      fb = _mm_max_ps(fb, _mm_setzero_ps());
+      __m128i r = texmod_u8(fr);
+      __m128i g = texmod_u8(fg);
+      __m128i b = texmod_u8(fb);
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+	for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);
@@ -331,7 +503,7 @@ static void mod_tex_sub_col_mul_fac_CI (uint32_t color, uint32_t factor)
 
 static void mod_col_inter_tex_using_col1_CI (uint32_t color0, uint32_t color1)
 {
-   int i;
+   int i = 0;
    uint8_t cr, cg, cb;
    uint16_t col;
    uint8_t a, r, g, b;
@@ -347,7 +519,22 @@ static void mod_col_inter_tex_using_col1_CI (uint32_t color0, uint32_t color1)
    cg = (uint8_t)((color0 >> 16) & 0xFF);
    cb = (uint8_t)((color0 >> 8)  & 0xFF);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vpr = _mm_set1_ps(percent_r), vpg = _mm_set1_ps(percent_g), vpb = _mm_set1_ps(percent_b);
+   __m128 vpr_i = _mm_set1_ps(percent_r_i), vpg_i = _mm_set1_ps(percent_g_i), vpb_i = _mm_set1_ps(percent_b_i);
+   __m128 vcr = _mm_set1_ps((float)cr), vcg = _mm_set1_ps((float)cg), vcb = _mm_set1_ps((float)cb);
+   __m128 v255 = _mm_set1_ps(255.0f);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpr, texmod_ci_u8float(c, 11)), _mm_mul_ps(vpr_i, vcr)), v255));
+      __m128i g = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpg, texmod_ci_u8float(c, 6)), _mm_mul_ps(vpg_i, vcg)), v255));
+      __m128i b = texmod_u8(_mm_min_ps(_mm_add_ps(_mm_mul_ps(vpb, texmod_ci_u8float(c, 1)), _mm_mul_ps(vpb_i, vcb)), v255));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -366,7 +553,7 @@ static void mod_col_inter_tex_using_col1_CI (uint32_t color0, uint32_t color1)
 
 static void mod_tex_inter_col_using_texa_CI (uint32_t color)
 {
-   int i;
+   int i = 0;
    uint8_t a, r, g, b;
 
    r = (uint8_t)((float)((color >> 24) & 0xFF) / 255.0f * 31.0f);
@@ -375,7 +562,17 @@ static void mod_tex_inter_col_using_texa_CI (uint32_t color)
    a = (color&0xFF) ? 1 : 0;
    uint16_t col16 = (uint16_t)((r<<11)|(g<<6)|(b<<1)|a);
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128i vcol = _mm_set1_epi16(col16), one = _mm_set1_epi16(1);
+   for (; i < 256; i += 8)
+   {
+      __m128i c = _mm_loadu_si128((const __m128i*)(rdp.pal_8 + i));
+      __m128i mask = _mm_cmpeq_epi16(_mm_and_si128(c, one), one);
+      c = _mm_or_si128(_mm_and_si128(mask, vcol), _mm_andnot_si128(mask, c));
+      _mm_storeu_si128((__m128i*)(rdp.pal_8 + i), c);
+   }
+#endif
+   for (; i < 256; i++)
    {
       if (rdp.pal_8[i]&1)
          rdp.pal_8[i] = col16;
@@ -384,7 +581,7 @@ static void mod_tex_inter_col_using_texa_CI (uint32_t color)
 
 static void mod_tex_mul_col_CI(uint32_t color)
 {
-   int i;
+   int i = 0;
    uint8_t a, r, g, b;
    uint16_t col;
    float cr, cg, cb;
@@ -393,7 +590,19 @@ static void mod_tex_mul_col_CI(uint32_t color)
    cg = (float)((color >> 16) & 0xFF) / 255.0f;
    cb = (float)((color >> 8)  & 0xFF) / 255.0f;
 
-   for (i = 0; i < 256; i++)
+#ifdef TEXMOD_SSE2
+   __m128 vcr = _mm_set1_ps(cr), vcg = _mm_set1_ps(cg), vcb = _mm_set1_ps(cb);
+   for (; i < 256; i += 4)
+   {
+      __m128i c = texmod_load(rdp.pal_8 + i);
+      __m128i a = _mm_and_si128(c, _mm_set1_epi32(1));
+      __m128i r = texmod_u8(_mm_mul_ps(texmod_float(c, 11, 0x1F), vcr));
+      __m128i g = texmod_u8(_mm_mul_ps(texmod_float(c, 6, 0x1F), vcg));
+      __m128i b = texmod_u8(_mm_mul_ps(texmod_float(c, 1, 0x1F), vcb));
+      texmod_store(rdp.pal_8 + i, texmod_ci_pack(r, g, b, a));
+   }
+#endif
+   for (; i < 256; i++)
    {
       col = rdp.pal_8[i];
       a = (uint8_t)(col&0x0001);;
@@ -45,6 +45,12 @@
 #include "TexCache.h"
 #include "DepthBufferRender.h"
 
+#if !defined(NOSSE)
+#include <emmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #define Vj rdp.vtxbuf2[j]
 #define Vi rdp.vtxbuf2[i]
 
@@ -519,14 +525,62 @@ void draw_tri (VERTEX **vtx, uint16_t linew)
 //*
 static void InterpolateColors(VERTEX *va, VERTEX *vb, VERTEX *res, float percent)
 {
+#if !defined(NOSSE)
+   // b, g, r, a as four floats; the lerp stays between two bytes, so
+   // truncating and packing gives the same bytes as the scalar casts
+   __m128i zero = _mm_setzero_si128();
+   __m128i ca, cb, ci;
+   __m128 c;
+   int32_t pa, pb, pr;
+
+   memcpy(&pa, &va->b, 4);
+   memcpy(&pb, &vb->b, 4);
+   ca = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pa), zero), zero);
+   cb = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pb), zero), zero);
+   c = _mm_add_ps(_mm_cvtepi32_ps(ca), _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(cb, ca)), _mm_set1_ps(percent)));
+   ci = _mm_cvttps_epi32(c);
+   ci = _mm_packs_epi32(ci, ci);
+   pr = _mm_cvtsi128_si32(_mm_packus_epi16(ci, ci));
+   memcpy(&res->b, &pr, 4);
+#else
    res->b = (uint8_t)interp2p(va->b, vb->b, percent);
    res->g = (uint8_t)interp2p(va->g, vb->g, percent);;
    res->r = (uint8_t)interp2p(va->r, vb->r, percent);;
    res->a = (uint8_t)interp2p(va->a, vb->a, percent);;
+#endif
    res->f = interp2p(va->f, vb->f, percent);;
 }
 
 //*/
+
+// Interpolates x, y, z, q, u0, v0, u1 and v1, which follow each other in
+// VERTEX, from va towards vb
+static INLINE void InterpolateCoords(VERTEX *va, VERTEX *vb, VERTEX *res, float percent)
+{
+#if !defined(NOSSE)
+   __m128 p = _mm_set1_ps(percent);
+   __m128 a0 = _mm_loadu_ps(&va->x);
+   __m128 a1 = _mm_loadu_ps(&va->u0);
+   _mm_storeu_ps(&res->x, _mm_add_ps(a0, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&vb->x), a0), p)));
+   _mm_storeu_ps(&res->u0, _mm_add_ps(a1, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&vb->u0), a1), p)));
+#elif defined(HAVE_NEON)
+   // separate multiply and add, vmla may be fused and round differently
+   float32x4_t a0 = vld1q_f32(&va->x);
+   float32x4_t a1 = vld1q_f32(&va->u0);
+   vst1q_f32(&res->x, vaddq_f32(a0, vmulq_n_f32(vsubq_f32(vld1q_f32(&vb->x), a0), percent)));
+   vst1q_f32(&res->u0, vaddq_f32(a1, vmulq_n_f32(vsubq_f32(vld1q_f32(&vb->u0), a1), percent)));
+#else
+   res->x = va->x + (vb->x - va->x) * percent;
+   res->y = va->y + (vb->y - va->y) * percent;
+   res->z = va->z + (vb->z - va->z) * percent;
+   res->q = va->q + (vb->q - va->q) * percent;
+   res->u0 = va->u0 + (vb->u0 - va->u0) * percent;
+   res->v0 = va->v0 + (vb->v0 - va->v0) * percent;
+   res->u1 = va->u1 + (vb->u1 - va->u1) * percent;
+   res->v1 = va->v1 + (vb->v1 - va->v1) * percent;
+#endif
+}
+
 //
 // clip_w - clips aint the z-axis
 //
@@ -557,16 +611,11 @@ static void clip_w (int interpolate_colors)
          }
          else      // First is in, second is out, save intersection
          {
+            // q is interpolated too, do_triangle_stuff replaces it
             percent = (-Vi.w) / (Vj.w - Vi.w);
             rdp.vtxbuf[index].not_zclipped = 0;
-            rdp.vtxbuf[index].x = Vi.x + (Vj.x - Vi.x) * percent;
-            rdp.vtxbuf[index].y = Vi.y + (Vj.y - Vi.y) * percent;
-            rdp.vtxbuf[index].z = Vi.z + (Vj.z - Vi.z) * percent;
+            InterpolateCoords(&Vi, &Vj, &rdp.vtxbuf[index], percent);
             rdp.vtxbuf[index].w = 0.01f;
-            rdp.vtxbuf[index].u0 = Vi.u0 + (Vj.u0 - Vi.u0) * percent;
-            rdp.vtxbuf[index].v0 = Vi.v0 + (Vj.v0 - Vi.v0) * percent;
-            rdp.vtxbuf[index].u1 = Vi.u1 + (Vj.u1 - Vi.u1) * percent;
-            rdp.vtxbuf[index].v1 = Vi.v1 + (Vj.v1 - Vi.v1) * percent;
             if (interpolate_colors)
                InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
             else
@@ -580,14 +629,8 @@ static void clip_w (int interpolate_colors)
          {
             percent = (-Vj.w) / (Vi.w - Vj.w);
             rdp.vtxbuf[index].not_zclipped = 0;
-            rdp.vtxbuf[index].x = Vj.x + (Vi.x - Vj.x) * percent;
-            rdp.vtxbuf[index].y = Vj.y + (Vi.y - Vj.y) * percent;
-            rdp.vtxbuf[index].z = Vj.z + (Vi.z - Vj.z) * percent;
+            InterpolateCoords(&Vj, &Vi, &rdp.vtxbuf[index], percent);
             rdp.vtxbuf[index].w = 0.01f;
-            rdp.vtxbuf[index].u0 = Vj.u0 + (Vi.u0 - Vj.u0) * percent;
-            rdp.vtxbuf[index].v0 = Vj.v0 + (Vi.v0 - Vj.v0) * percent;
-            rdp.vtxbuf[index].u1 = Vj.u1 + (Vi.u1 - Vj.u1) * percent;
-            rdp.vtxbuf[index].v1 = Vj.v1 + (Vi.v1 - Vj.v1) * percent;
             if (interpolate_colors)
                InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
             else
@@ -602,6 +645,31 @@ static void clip_w (int interpolate_colors)
    rdp.n_global = index;
 }
 
+// Triangles that only cross the x/y clip planes are left to the hardware
+// scissor when it lies inside the clip rectangle and the vertices stay
+// within the guard band around the screen. Inside the scissor they cover
+// the same pixels as the clipped polygon, and the depth buffer renderer
+// stops at the scissor as well.
+static void clip_guard_band(void)
+{
+   int i;
+
+   if (!(rdp.clip & (CLIP_XMAX | CLIP_XMIN | CLIP_YMAX | CLIP_YMIN)) || !rdp.scissor_set)
+      return;
+   // the scissor is exclusive at lr, compare the outer pixel centers
+   if (rdp.scissor.ul_x + 0.5f < rdp.clip_min_x || rdp.scissor.lr_x - 0.5f > rdp.clip_max_x ||
+         rdp.scissor.ul_y + 0.5f < rdp.clip_min_y || rdp.scissor.lr_y - 0.5f > rdp.clip_max_y)
+      return;
+
+   for (i = 0; i < rdp.n_global; i++)
+   {
+      if (rdp.vtxbuf[i].x < -GUARD_BAND || rdp.vtxbuf[i].x > settings.res_x + GUARD_BAND ||
+            rdp.vtxbuf[i].y < -GUARD_BAND || rdp.vtxbuf[i].y > settings.res_y + GUARD_BAND)
+         return;
+   }
+   rdp.clip &= ~(CLIP_XMAX | CLIP_XMIN | CLIP_YMAX | CLIP_YMIN);
+}
+
 void do_triangle_stuff (uint16_t linew, int old_interpolate) // what else?? do the triangle stuff :P (to keep from writing code twice)
 {
    int i;
@@ -669,6 +737,7 @@ void do_triangle_stuff (uint16_t linew, int old_interpolate) // what else?? do t
          rdp.clip &= ~CLIP_ZMIN;
       if (!settings.clip_zmax)
          rdp.clip &= ~CLIP_ZMAX;
+      clip_guard_band();
    }
    render_tri (linew, old_interpolate);
 }
@@ -686,6 +755,7 @@ void do_triangle_stuff_2 (uint16_t linew)
       if (rdp.vtxbuf[i].y > rdp.clip_max_y) rdp.clip |= CLIP_YMAX;
       if (rdp.vtxbuf[i].y < rdp.clip_min_y) rdp.clip |= CLIP_YMIN;
    }
+   clip_guard_band();
 
    render_tri (linew, true);
 }
@@ -926,336 +996,98 @@ static void DepthBuffer(VERTEX * vtx, int n)
       vtx[i].z = ScaleZ(vtx[i].z);
 }
 
-void clip_tri(int interpolate_colors)
+enum
 {
-   int i,j,index,n=rdp.n_global;
-   float percent;
+   CLIP_BELOW,       // keeps coord <= bound
+   CLIP_ABOVE,       // keeps coord >= bound
+   CLIP_BELOW_OPEN   // keeps coord < bound
+};
 
-   // Check which clipping is needed
-   if (rdp.clip & CLIP_XMAX) // right of the screen
-   {
-      // Swap vertex buffers
-      VERTEX *tmp = rdp.vtxbuf2;
-      rdp.vtxbuf2 = rdp.vtxbuf;
-      rdp.vtxbuf = tmp;
-      rdp.vtx_buffer ^= 1;
-      index = 0;
-
-      // Check the vertices for clipping
-      for (i=0; i<n; i++)
-      {
-         j = i+1;
-         if (j == n) j = 0;
-
-         if (Vi.x <= rdp.clip_max_x)
-         {
-            if (Vj.x <= rdp.clip_max_x)   // Both are in, save the last one
-            {
-               rdp.vtxbuf[index++] = Vj;
-            }
-            else      // First is in, second is out, save intersection
-            {
-               percent = (rdp.clip_max_x - Vi.x) / (Vj.x - Vi.x);
-               rdp.vtxbuf[index].x = rdp.clip_max_x;
-               rdp.vtxbuf[index].y = Vi.y + (Vj.y - Vi.y) * percent;
-               rdp.vtxbuf[index].z = Vi.z + (Vj.z - Vi.z) * percent;
-               rdp.vtxbuf[index].q = Vi.q + (Vj.q - Vi.q) * percent;
-               rdp.vtxbuf[index].u0 = Vi.u0 + (Vj.u0 - Vi.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vi.v0 + (Vj.v0 - Vi.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vi.u1 + (Vj.u1 - Vi.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vi.v1 + (Vj.v1 - Vi.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 8;
-            }
-         }
-         else
-         {
-            //if (Vj.x > rdp.clip_max_x)  // Both are out, save nothing
-            if (Vj.x <= rdp.clip_max_x) // First is out, second is in, save intersection & in point
-            {
-               percent = (rdp.clip_max_x - Vj.x) / (Vi.x - Vj.x);
-               rdp.vtxbuf[index].x = rdp.clip_max_x;
-               rdp.vtxbuf[index].y = Vj.y + (Vi.y - Vj.y) * percent;
-               rdp.vtxbuf[index].z = Vj.z + (Vi.z - Vj.z) * percent;
-               rdp.vtxbuf[index].q = Vj.q + (Vi.q - Vj.q) * percent;
-               rdp.vtxbuf[index].u0 = Vj.u0 + (Vi.u0 - Vj.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vj.v0 + (Vi.v0 - Vj.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vj.u1 + (Vi.u1 - Vj.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vj.v1 + (Vi.v1 - Vj.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 8;
+//
+// clip_plane - one Sutherland-Hodgman pass of the n vertices in rdp.vtxbuf
+// against a plane on x (axis 0), y (1) or z (2). Intersections get value
+// for the clipped coordinate and number | flag when colors are left to
+// render_tri. Returns the new vertex count.
+//
+static int clip_plane(int n, int axis, int side, float bound, float value, int flag, int interpolate_colors)
+{
+   int i, j, index = 0;
+   uint8_t in[32];
+   float percent;
 
-               // Save the in point
-               rdp.vtxbuf[index++] = Vj;
-            }
-         }
-      }
-      n = index;
-   }
+   // Swap vertex buffers
+   VERTEX *tmp = rdp.vtxbuf2;
+   rdp.vtxbuf2 = rdp.vtxbuf;
+   rdp.vtxbuf = tmp;
+   rdp.vtx_buffer ^= 1;
 
-   if (rdp.clip & CLIP_XMIN) // left of the screen
+   for (i = 0; i < n; i++)
    {
-      // Swap vertex buffers
-      VERTEX *tmp = rdp.vtxbuf2;
-      rdp.vtxbuf2 = rdp.vtxbuf;
-      rdp.vtxbuf = tmp;
-      rdp.vtx_buffer ^= 1;
-      index = 0;
-
-      // Check the vertices for clipping
-      for (i=0; i<n; i++)
-      {
-         j = i+1;
-         if (j == n) j = 0;
-
-         if (Vi.x >= rdp.clip_min_x)
-         {
-            if (Vj.x >= rdp.clip_min_x)   // Both are in, save the last one
-            {
-               rdp.vtxbuf[index++] = Vj;
-            }
-            else      // First is in, second is out, save intersection
-            {
-               percent = (rdp.clip_min_x - Vi.x) / (Vj.x - Vi.x);
-               rdp.vtxbuf[index].x = rdp.clip_min_x;
-               rdp.vtxbuf[index].y = Vi.y + (Vj.y - Vi.y) * percent;
-               rdp.vtxbuf[index].z = Vi.z + (Vj.z - Vi.z) * percent;
-               rdp.vtxbuf[index].q = Vi.q + (Vj.q - Vi.q) * percent;
-               rdp.vtxbuf[index].u0 = Vi.u0 + (Vj.u0 - Vi.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vi.v0 + (Vj.v0 - Vi.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vi.u1 + (Vj.u1 - Vi.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vi.v1 + (Vj.v1 - Vi.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 8;
-            }
-         }
-         else
-         {
-            //if (Vj.x < rdp.clip_min_x)  // Both are out, save nothing
-            if (Vj.x >= rdp.clip_min_x) // First is out, second is in, save intersection & in point
-            {
-               percent = (rdp.clip_min_x - Vj.x) / (Vi.x - Vj.x);
-               rdp.vtxbuf[index].x = rdp.clip_min_x;
-               rdp.vtxbuf[index].y = Vj.y + (Vi.y - Vj.y) * percent;
-               rdp.vtxbuf[index].z = Vj.z + (Vi.z - Vj.z) * percent;
-               rdp.vtxbuf[index].q = Vj.q + (Vi.q - Vj.q) * percent;
-               rdp.vtxbuf[index].u0 = Vj.u0 + (Vi.u0 - Vj.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vj.v0 + (Vi.v0 - Vj.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vj.u1 + (Vi.u1 - Vj.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vj.v1 + (Vi.v1 - Vj.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 8;
-
-               // Save the in point
-               rdp.vtxbuf[index++] = Vj;
-            }
-         }
-      }
-      n = index;
+      float c = (&Vi.x)[axis];
+      in[i] = (side == CLIP_BELOW) ? (c <= bound) : (side == CLIP_ABOVE) ? (c >= bound) : (c < bound);
    }
 
-   if (rdp.clip & CLIP_YMAX) // top of the screen
+   // Check the vertices for clipping
+   for (i=0; i<n; i++)
    {
-      // Swap vertex buffers
-      VERTEX *tmp = rdp.vtxbuf2;
-      rdp.vtxbuf2 = rdp.vtxbuf;
-      rdp.vtxbuf = tmp;
-      rdp.vtx_buffer ^= 1;
-      index = 0;
-
-      // Check the vertices for clipping
-      for (i=0; i<n; i++)
-      {
-         j = i+1;
-         if (j == n) j = 0;
+      j = i+1;
+      if (j == n) j = 0;
 
-         if (Vi.y <= rdp.clip_max_y)
+      if (in[i])
+      {
+         if (in[j])   // Both are in, save the last one
          {
-            if (Vj.y <= rdp.clip_max_y)   // Both are in, save the last one
-            {
-               rdp.vtxbuf[index++] = Vj;
-            }
-            else      // First is in, second is out, save intersection
-            {
-               percent = (rdp.clip_max_y - Vi.y) / (Vj.y - Vi.y);
-               rdp.vtxbuf[index].x = Vi.x + (Vj.x - Vi.x) * percent;
-               rdp.vtxbuf[index].y = rdp.clip_max_y;
-               rdp.vtxbuf[index].z = Vi.z + (Vj.z - Vi.z) * percent;
-               rdp.vtxbuf[index].q = Vi.q + (Vj.q - Vi.q) * percent;
-               rdp.vtxbuf[index].u0 = Vi.u0 + (Vj.u0 - Vi.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vi.v0 + (Vj.v0 - Vi.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vi.u1 + (Vj.u1 - Vi.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vi.v1 + (Vj.v1 - Vi.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 16;
-            }
+            rdp.vtxbuf[index++] = Vj;
          }
-         else
+         else      // First is in, second is out, save intersection
          {
-            //if (Vj.y > rdp.clip_max_y)  // Both are out, save nothing
-            if (Vj.y <= rdp.clip_max_y) // First is out, second is in, save intersection & in point
-            {
-               percent = (rdp.clip_max_y - Vj.y) / (Vi.y - Vj.y);
-               rdp.vtxbuf[index].x = Vj.x + (Vi.x - Vj.x) * percent;
-               rdp.vtxbuf[index].y = rdp.clip_max_y;
-               rdp.vtxbuf[index].z = Vj.z + (Vi.z - Vj.z) * percent;
-               rdp.vtxbuf[index].q = Vj.q + (Vi.q - Vj.q) * percent;
-               rdp.vtxbuf[index].u0 = Vj.u0 + (Vi.u0 - Vj.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vj.v0 + (Vi.v0 - Vj.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vj.u1 + (Vi.u1 - Vj.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vj.v1 + (Vi.v1 - Vj.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 16;
-
-               // Save the in point
-               rdp.vtxbuf[index++] = Vj;
-            }
+            percent = (bound - (&Vi.x)[axis]) / ((&Vj.x)[axis] - (&Vi.x)[axis]);
+            InterpolateCoords(&Vi, &Vj, &rdp.vtxbuf[index], percent);
+            (&rdp.vtxbuf[index].x)[axis] = value;
+            if (interpolate_colors)
+               InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
+            else
+               rdp.vtxbuf[index++].number = Vi.number | Vj.number | flag;
          }
       }
-      n = index;
-   }
-
-   if (rdp.clip & CLIP_YMIN) // bottom of the screen
-   {
-      // Swap vertex buffers
-      VERTEX *tmp = rdp.vtxbuf2;
-      rdp.vtxbuf2 = rdp.vtxbuf;
-      rdp.vtxbuf = tmp;
-      rdp.vtx_buffer ^= 1;
-      index = 0;
-
-      // Check the vertices for clipping
-      for (i=0; i<n; i++)
+      else
       {
-         j = i+1;
-         if (j == n) j = 0;
-
-         if (Vi.y >= rdp.clip_min_y)
-         {
-            if (Vj.y >= rdp.clip_min_y)   // Both are in, save the last one
-            {
-               rdp.vtxbuf[index++] = Vj;
-            }
-            else      // First is in, second is out, save intersection
-            {
-               percent = (rdp.clip_min_y - Vi.y) / (Vj.y - Vi.y);
-               rdp.vtxbuf[index].x = Vi.x + (Vj.x - Vi.x) * percent;
-               rdp.vtxbuf[index].y = rdp.clip_min_y;
-               rdp.vtxbuf[index].z = Vi.z + (Vj.z - Vi.z) * percent;
-               rdp.vtxbuf[index].q = Vi.q + (Vj.q - Vi.q) * percent;
-               rdp.vtxbuf[index].u0 = Vi.u0 + (Vj.u0 - Vi.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vi.v0 + (Vj.v0 - Vi.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vi.u1 + (Vj.u1 - Vi.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vi.v1 + (Vj.v1 - Vi.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 16;
-            }
-         }
-         else
+         //if (!in[j])  // Both are out, save nothing
+         if (in[j]) // First is out, second is in, save intersection & in point
          {
-            //if (Vj.y < rdp.clip_min_y)  // Both are out, save nothing
-            if (Vj.y >= rdp.clip_min_y) // First is out, second is in, save intersection & in point
-            {
-               percent = (rdp.clip_min_y - Vj.y) / (Vi.y - Vj.y);
-               rdp.vtxbuf[index].x = Vj.x + (Vi.x - Vj.x) * percent;
-               rdp.vtxbuf[index].y = rdp.clip_min_y;
-               rdp.vtxbuf[index].z = Vj.z + (Vi.z - Vj.z) * percent;
-               rdp.vtxbuf[index].q = Vj.q + (Vi.q - Vj.q) * percent;
-               rdp.vtxbuf[index].u0 = Vj.u0 + (Vi.u0 - Vj.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vj.v0 + (Vi.v0 - Vj.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vj.u1 + (Vi.u1 - Vj.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vj.v1 + (Vi.v1 - Vj.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number | 16;
+            percent = (bound - (&Vj.x)[axis]) / ((&Vi.x)[axis] - (&Vj.x)[axis]);
+            InterpolateCoords(&Vj, &Vi, &rdp.vtxbuf[index], percent);
+            (&rdp.vtxbuf[index].x)[axis] = value;
+            if (interpolate_colors)
+               InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
+            else
+               rdp.vtxbuf[index++].number = Vi.number | Vj.number | flag;
 
-               // Save the in point
-               rdp.vtxbuf[index++] = Vj;
-            }
+            // Save the in point
+            rdp.vtxbuf[index++] = Vj;
          }
       }
-      n = index;
    }
+   return index;
+}
 
+void clip_tri(int interpolate_colors)
+{
+   int n=rdp.n_global;
+
+   // Check which clipping is needed
+   if (rdp.clip & CLIP_XMAX) // right of the screen
+      n = clip_plane(n, 0, CLIP_BELOW, rdp.clip_max_x, rdp.clip_max_x, 8, interpolate_colors);
+   if (rdp.clip & CLIP_XMIN) // left of the screen
+      n = clip_plane(n, 0, CLIP_ABOVE, rdp.clip_min_x, rdp.clip_min_x, 8, interpolate_colors);
+   if (rdp.clip & CLIP_YMAX) // top of the screen
+      n = clip_plane(n, 1, CLIP_BELOW, rdp.clip_max_y, rdp.clip_max_y, 16, interpolate_colors);
+   if (rdp.clip & CLIP_YMIN) // bottom of the screen
+      n = clip_plane(n, 1, CLIP_ABOVE, rdp.clip_min_y, rdp.clip_min_y, 16, interpolate_colors);
    if (rdp.clip & CLIP_ZMAX) // far plane
    {
-      // Swap vertex buffers
-      VERTEX *tmp = rdp.vtxbuf2;
-      rdp.vtxbuf2 = rdp.vtxbuf;
-      rdp.vtxbuf = tmp;
-      rdp.vtx_buffer ^= 1;
-      index = 0;
       float maxZ = rdp.view_trans[2] + rdp.view_scale[2];
-
-      // Check the vertices for clipping
-      for (i=0; i<n; i++)
-      {
-         j = i+1;
-         if (j == n) j = 0;
-
-         if (Vi.z < maxZ)
-         {
-            if (Vj.z < maxZ)   // Both are in, save the last one
-            {
-               rdp.vtxbuf[index++] = Vj;
-            }
-            else      // First is in, second is out, save intersection
-            {
-               percent = (maxZ - Vi.z) / (Vj.z - Vi.z);
-               rdp.vtxbuf[index].x = Vi.x + (Vj.x - Vi.x) * percent;
-               rdp.vtxbuf[index].y = Vi.y + (Vj.y - Vi.y) * percent;
-               rdp.vtxbuf[index].z = maxZ - 0.001f;
-               rdp.vtxbuf[index].q = Vi.q + (Vj.q - Vi.q) * percent;
-               rdp.vtxbuf[index].u0 = Vi.u0 + (Vj.u0 - Vi.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vi.v0 + (Vj.v0 - Vi.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vi.u1 + (Vj.u1 - Vi.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vi.v1 + (Vj.v1 - Vi.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vi, &Vj, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number;
-            }
-         }
-         else
-         {
-            //if (Vj.z > maxZ)  // Both are out, save nothing
-            if (Vj.z < maxZ) // First is out, second is in, save intersection & in point
-            {
-               percent = (maxZ - Vj.z) / (Vi.z - Vj.z);
-               rdp.vtxbuf[index].x = Vj.x + (Vi.x - Vj.x) * percent;
-               rdp.vtxbuf[index].y = Vj.y + (Vi.y - Vj.y) * percent;
-               rdp.vtxbuf[index].z = maxZ - 0.001f;;
-               rdp.vtxbuf[index].q = Vj.q + (Vi.q - Vj.q) * percent;
-               rdp.vtxbuf[index].u0 = Vj.u0 + (Vi.u0 - Vj.u0) * percent;
-               rdp.vtxbuf[index].v0 = Vj.v0 + (Vi.v0 - Vj.v0) * percent;
-               rdp.vtxbuf[index].u1 = Vj.u1 + (Vi.u1 - Vj.u1) * percent;
-               rdp.vtxbuf[index].v1 = Vj.v1 + (Vi.v1 - Vj.v1) * percent;
-               if (interpolate_colors)
-                  InterpolateColors(&Vj, &Vi, &rdp.vtxbuf[index++], percent);
-               else
-                  rdp.vtxbuf[index++].number = Vi.number | Vj.number;
-
-               // Save the in point
-               rdp.vtxbuf[index++] = Vj;
-            }
-         }
-      }
-      n = index;
+      n = clip_plane(n, 2, CLIP_BELOW_OPEN, maxZ, maxZ - 0.001f, 0, interpolate_colors);
    }
 
    /*
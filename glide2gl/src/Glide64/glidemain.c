@@ -47,8 +47,10 @@
 #include "DepthBufferRender.h"
 
 #include "../../../libretro/libretro.h"
+#include "../../libretro/SDL.h"
 
 extern unsigned retro_filtering;
+extern unsigned retro_dlist_cache;
 extern retro_environment_t environ_cb;
 extern void update_variables(void);
 
@@ -326,10 +328,45 @@ void ReadSettings(void)
    settings.unk_clear = false;
 }
 
-extern uint8_t microcode[4096];
+extern uint32_t uc_crc;
 
 extern bool no_audio;
 
+// Per-ROM overrides from glide64rom.conf, in the format of gles2n64rom.conf:
+// a "rom name=" line with the name from the ROM header, then key=value lines
+// for that ROM. Only dlist_cache is read, so a game whose display lists change
+// behind the display list cache's back can be listed with dlist_cache=0.
+static void ReadRomSettings (const char * name)
+{
+   char line[256];
+   bool isRom = false;
+   const char *filename = ConfigGetSharedDataFilepath("glide64rom.conf");
+   FILE *f = filename ? fopen(filename, "r") : NULL;
+
+   if (!f)
+      return;
+
+   while (fgets(line, sizeof(line), f))
+   {
+      char *val;
+      line[strcspn(line, "\r\n")] = 0;
+
+      if (strncmp(line, "rom name=", 9) == 0)
+      {
+         isRom = (strcasecmp(name, line + 9) == 0);
+         continue;
+      }
+      if (!isRom || !(val = strchr(line, '=')))
+         continue;
+      *val++ = 0;
+
+      if (strcmp(line, "dlist_cache") == 0)
+         settings.dlist_cache = atoi(val) && retro_dlist_cache;
+   }
+
+   fclose(f);
+}
+
 void ReadSpecialSettings (const char * name)
 {
    int smart_read, hires, get_fbinfo, read_always, depth_render, fb_crc_mode,
@@ -383,15 +420,10 @@ void ReadSpecialSettings (const char * name)
    }
 
    settings.hacks = 0;
+   settings.dlist_cache = retro_dlist_cache;
 
-   // We might want to detect some games by ucode crc, so set
-   // up uc_crc here
-   uint32_t i, uc_crc;
-   uc_crc = 0;
-
-   for (i = 0; i < 3072 >> 2; i++)
-      uc_crc += ((uint32_t*)microcode)[i];
-
+   // uc_crc is the sum of the last ucode microcheck saw, some games
+   // are detected by it
    // Glide64 mk2 INI config
    if (strstr(name, (const char *)"1080 SNOWBOARDING"))
    {
@@ -1989,13 +2021,22 @@ void ReadSpecialSettings (const char * name)
    else if (strstr(name, (const char *)"Resident Evil II") || strstr(name, (const char *)"BioHazard II"))
       settings.hacks |= hack_RE2;
    else if (strstr(name, (const char *)"YOSHI STORY"))
+   {
       settings.hacks |= hack_Yoshi;
+      settings.dlist_cache = 0;
+   }
    else if (strstr(name, (const char *)"F-Zero X") || strstr(name, (const char *)"F-ZERO X"))
       settings.hacks |= hack_Fzero;
    else if (strstr(name, (const char *)"PAPER MARIO") || strstr(name, (const char *)"MARIO STORY"))
+   {
       settings.hacks |= hack_PMario;
+      settings.dlist_cache = 0;
+   }
    else if (strstr(name, (const char *)"TOP GEAR RALLY 2"))
+   {
       settings.hacks |= hack_TGR2;
+      settings.dlist_cache = 0;
+   }
    else if (strstr(name, (const char *)"TOP GEAR RALLY"))
       settings.hacks |= hack_TGR;
    else if (strstr(name, (const char *)"Top Gear Hyper Bike"))
@@ -2025,7 +2066,12 @@ void ReadSpecialSettings (const char * name)
    else if (strstr(name, (const char *)"GOLDENEYE"))
       settings.hacks |= hack_GoldenEye;
    else if (strstr(name, (const char *)"PUZZLE LEAGUE"))
+   {
       settings.hacks |= hack_PPL;
+      settings.dlist_cache = 0;
+   }
+
+   ReadRomSettings(name);
 
    if (settings.n64_z_scale)
       ZLUT_init();
@@ -2490,6 +2536,42 @@ EXPORT void CALL MoveScreen (int xpos, int ypos)
    rdp.window_changed = true;
 }
 
+// texture pool counters, summed over the frames since the rom was opened
+static GrTexPoolStats tex_pool_total;
+static uint32_t tex_pool_frames, tex_pool_peak;
+
+static void tex_pool_count_frame(void)
+{
+   GrTexPoolStats stats;
+
+   grTexPoolStatsExt(&stats);
+   tex_pool_total.uploads += stats.uploads;
+   tex_pool_total.upload_bytes += stats.upload_bytes;
+   tex_pool_total.reused += stats.reused;
+   tex_pool_total.allocated += stats.allocated;
+   tex_pool_total.evicted += stats.evicted;
+   tex_pool_total.batches += stats.batches;
+   if (stats.vram_bytes > tex_pool_peak)
+      tex_pool_peak = stats.vram_bytes;
+   tex_pool_frames++;
+
+   if (log_cb && (tex_pool_frames % 600) == 0)
+      log_cb(RETRO_LOG_DEBUG, "Texture pool: %u uploads (%u KB), %u reused, %u allocated, %u evicted, %u batches, %u KB held\n",
+            stats.uploads, stats.upload_bytes >> 10, stats.reused, stats.allocated,
+            stats.evicted, stats.batches, stats.vram_bytes >> 10);
+}
+
+static void tex_pool_report(void)
+{
+   if (log_cb && tex_pool_frames)
+      log_cb(RETRO_LOG_INFO, "Texture pool: %u frames, %u uploads (%u KB), %u reused, %u allocated, %u evicted, %u KB peak\n",
+            tex_pool_frames, tex_pool_total.uploads, tex_pool_total.upload_bytes >> 10,
+            tex_pool_total.reused, tex_pool_total.allocated, tex_pool_total.evicted,
+            tex_pool_peak >> 10);
+   memset(&tex_pool_total, 0, sizeof(tex_pool_total));
+   tex_pool_frames = tex_pool_peak = 0;
+}
+
 /******************************************************************
 Function: RomClosed
 Purpose:  This function is called when a rom is closed.
@@ -2502,8 +2584,13 @@ EXPORT void CALL RomClosed (void)
 
    CLOSE_RDP_LOG ();
    CLOSE_RDP_E_LOG ();
+   if (log_cb)
+      log_cb(RETRO_LOG_INFO, "Combine cache: %u hits, %u misses\n",
+            combine_cache_hits, combine_cache_misses);
+   tex_pool_report();
    rdp.window_changed = true;
    romopen = false;
+   dlist_cache_reset();
    ReleaseGfx ();
 }
 
@@ -2735,6 +2822,7 @@ void newSwapBuffers(void)
 #endif
 
    rdp.updatescreen = 0;
+   int dlc_recording = dlist_cache_swap_begin();
 
    LRDP("swapped\n");
 
@@ -2749,6 +2837,7 @@ void newSwapBuffers(void)
 
    {
       grBufferSwap (settings.vsync);
+      tex_pool_count_frame();
 
       if  (settings.buff_clear || (settings.hacks&hack_PPL && settings.ucode == 6))
       {
@@ -2761,6 +2850,7 @@ void newSwapBuffers(void)
       DrawWholeFrameBufferToScreen();
 
    frame_count ++;
+   dlist_cache_swap_end(dlc_recording);
 }
 
 /******************************************************************
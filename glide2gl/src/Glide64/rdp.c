@@ -46,7 +46,10 @@
 #include "TexCache.h"
 #include "TexBuffer.h"
 #include "FBtoScreen.h"
+#include "DepthBufferRender.h"
+#include "TexLoadSIMD.h"
 #include "CRC.h"
+#include "plugin/ucode_id.h"
 
 #ifdef __LIBRETRO__ // Prefix API
 #define VIDEO_TAG(X) glide64##X
@@ -222,10 +225,10 @@ static void rsp_reserved2(void);
 static void rsp_reserved3(void);
 
 static void ys_memrect(void);
+static int dlist_cache_state(DLIST_CACHE_STATE *state);
 
-uint8_t microcode[4096];
 uint32_t uc_crc;
-void microcheck ();
+void microcheck(uint32_t addr);
 
 // ** UCODE FUNCTIONS **
 #include "ucode00.h"
@@ -293,6 +296,7 @@ void rdp_reset(void)
 {
    int i;
    reset = 1;
+   dlist_cache_reset();
 
    // set all vertex numbers
    for (i = 0; i < MAX_VTX; i++)
@@ -317,18 +321,39 @@ void rdp_reset(void)
    rdp.maincimg[0].addr = rdp.maincimg[1].addr = rdp.last_drawn_ci_addr = 0x7FFFFFFF;
 }
 
-void microcheck(void)
+static const char *ucode_family_name(int family)
 {
-   uint32_t i;
-   uc_crc = 0;
+   switch (family)
+   {
+      case UCODE_FAMILY_UNSUPPORTED: return "Unknown Microcode.";
+      case UCODE_FAMILY_FAST3D:      return "RSP SW 2.0X (Super Mario 64)";
+      case UCODE_FAMILY_F3DEX:       return "F3DEX 1.XX (Star Fox 64)";
+      case UCODE_FAMILY_F3DEX2:      return "F3DEX 2.XX (The Legend of Zelda: Ocarina of Time)";
+      case UCODE_FAMILY_WAVERACE:    return "F3DEX ? (WaveRace)";
+      case UCODE_FAMILY_SOTE:        return "RSP SW 2.0D EXT (Star Wars: Shadows of the Empire)";
+      case UCODE_FAMILY_DKR:         return "RSP SW 2.0 (Diddy Kong Racing)";
+      case UCODE_FAMILY_S2DEX:       return "S2DEX 1.XX  (Yoshi's Story - SimCity 2000)";
+      case UCODE_FAMILY_PD:          return "RSP SW PD (Perfect Dark)";
+      case UCODE_FAMILY_CBFD:        return "F3DEXBG 2.08 (Conker's Bad Fur Day)";
+      case UCODE_FAMILY_ZSORT:       return "(Star Wars: Battle for Naboo)";
+   }
+   return NULL;
+}
 
-   // Check first 3k of ucode, because the last 1k sometimes contains trash
-   for (i = 0; i < 3072 >> 2; i++)
-      uc_crc += ((uint32_t*)microcode)[i];
+// The core hashes the ucode once per upload and keeps the result
+// until RDRAM under it changes, see plugin/ucode_id.h
+void microcheck(uint32_t addr)
+{
+   const struct ucode_info *info = ucode_id_lookup(addr);
+   const char *name;
+
+   // Sum of the first 3k of ucode, because the last 1k sometimes contains trash
+   uc_crc = info->sum;
 
    FRDP_E ("crc: %08lx\n", uc_crc);
 
 #ifdef LOG_UCODE
+   uint32_t i;
    std::ofstream ucf;
    ucf.open ("ucode.txt", std::ios::out | std::ios::binary);
    char d;
@@ -342,254 +367,23 @@ void microcheck(void)
 
    fprintf(stderr, "ucode = %08lx\n", uc_crc);
 
+   old_ucode = settings.ucode;
+   if (info->family != UCODE_FAMILY_UNKNOWN)
    {
-      old_ucode = settings.ucode;
-
-      if (
-               uc_crc == 0x006bd77f
-            || uc_crc == 0x07200895
-            || uc_crc == UCODE_GOLDENEYE_007
-            || uc_crc == UCODE_DUKE_NUKEM_64
-            || uc_crc == UCODE_ROBOTECH_CRYSTAL_DREAMS_PROTO
-            || uc_crc == 0xb62f900f
-            || uc_crc == 0xbc03e969
-            || uc_crc == 0xd5604971
-            || uc_crc == 0xd5d68b1f
-            || uc_crc == 0xd67c2f8b
-            || uc_crc == UCODE_KILLER_INSTINCT_GOLD
-            || uc_crc == UCODE_MISCHIEF_MAKERS
-            || uc_crc == UCODE_MORTAL_KOMBAT_TRILOGY
-            || uc_crc == 0x5182f610
-            || uc_crc == UCODE_BLAST_CORPS
-            || uc_crc == UCODE_PILOTWINGS_64
-            || uc_crc == UCODE_CRUISN_USA
-            || uc_crc == UCODE_SUPER_MARIO_64
-            || uc_crc == UCODE_TETRISPHERE
-            || uc_crc == 0x4165e1fd
-            || uc_crc == 0x6e4d50af
-         )
-      {
-         settings.ucode = 0;
-         fprintf(stderr, "RSP SW 2.0X (Super Mario 64)\n");
-      }
-      else if (
-               uc_crc == 0x05165579
-            || uc_crc == 0x05777c62
-            || uc_crc == 0x057e7c62
-            || uc_crc == 0x1118b3e0
-            || uc_crc == UCODE_MINI_RACERS_CRC1
-            || uc_crc == 0x1de712ff
-            || uc_crc == 0x24cd885b
-            || uc_crc == 0x26a7879a
-            || uc_crc == 0xfb816260
-            || uc_crc == 0x2c7975d6
-            || uc_crc == 0x2d3fe3f1
-            || uc_crc == UCODE_FIGHTING_FORCE_64_CRC1
-            || uc_crc == 0x339872a6
-            || uc_crc == 0x3ff1a4ca
-            || uc_crc == 0x4340ac9b
-            || uc_crc == 0x440cfad6
-            || uc_crc == 0x4fe6df78
-            || uc_crc == 0x5257cd2a
-            || uc_crc == 0x5414030c
-            || uc_crc == 0x5414030d
-            || uc_crc == 0x559ff7d4
-            || uc_crc == UCODE_YOSHIS_STORY_CRC2
-            || uc_crc == 0x5ef4e34a
-            || uc_crc == 0x6075e9eb
-            || uc_crc == 0x60c1dcc4
-            || uc_crc == UCODE_1080_SNOWBOARDING
-            || uc_crc == 0x66c0b10a
-            || uc_crc == 0x6eaa1da8
-            || uc_crc == 0x72a4f34e
-            || uc_crc == 0x73999a23
-            || uc_crc == 0x7df75834
-            || uc_crc == UCODE_DOOM_64
-            || uc_crc == UCODE_TUROK_1
-            || uc_crc == 0x82f48073
-            || uc_crc == UCODE_MINI_RACERS_CRC2
-            || uc_crc == 0x841ce10f
-            || uc_crc == 0x863e1ca7
-            || uc_crc == UCODE_MARIO_KART_64
-            || uc_crc == 0x8d5735b2
-            || uc_crc == 0x8d5735b3
-            || uc_crc == 0x97d1b58a
-            || uc_crc == UCODE_QUAKE_64
-            || uc_crc == UCODE_WETRIX
-            || uc_crc == UCODE_STAR_FOX_64
-            || uc_crc == UCODE_FIGHTING_FORCE_64_CRC2
-            || uc_crc == 0xb4577b9c
-            || uc_crc == 0xbe78677c
-            || uc_crc == 0xbed8b069
-            || uc_crc == 0xc3704e41
-            || uc_crc == UCODE_EXTREME_G
-            || uc_crc == 0xc99a4c6c
-            || uc_crc == 0xcee7920f
-            || uc_crc == 0xd1663234
-            || uc_crc == 0xd2a9f59c
-            || uc_crc == 0xd41db5f7
-            || uc_crc == 0xd57049a5
-            || uc_crc == 0xd802ec04
-            || uc_crc == UCODE_WIPEOUT_64
-            || uc_crc == 0xe9231df2
-            || uc_crc == 0xec040469
-            || uc_crc == UCODE_DUAL_HEROES
-            || uc_crc == UCODE_HEXEN_64
-            || uc_crc == UCODE_CHAMELEON_TWIST
-            || uc_crc == UCODE_BANJO_KAZOOIE
-            || uc_crc == UCODE_MACE_THE_DARK_AGE
-            || uc_crc == 0xef54ee35
-            )
-      {
-         settings.ucode = 1;
-         fprintf(stderr, "F3DEX 1.XX (Star Fox 64)\n");
-      }
-      else if (
-               uc_crc == 0x03044b84
-            || uc_crc == 0x030f4b84
-            || uc_crc == 0x0ff79527
-            || uc_crc == UCODE_COMMAND_AND_CONQUER
-            || uc_crc == 0x1a1e18a0
-            || uc_crc == 0x1a1e1920
-            || uc_crc == UCODE_DONKEY_KONG_64
-            || uc_crc == 0x1a62dc2f
-            || uc_crc == UCODE_PAPER_MARIO
-            || uc_crc == 0x21f91874
-            || uc_crc == UCODE_ZELDA_MAJORAS_MASK
-            || uc_crc == UCODE_ZELDA_OOT
-            || uc_crc == 0x6124a508
-            || uc_crc == 0x630a61fb
-            || uc_crc == UCODE_CASTLEVANIA_64
-            || uc_crc == UCODE_CASTLEVANIA_64
-            || uc_crc == 0x65201a09
-            || uc_crc == 0x679e1205
-            || uc_crc == 0x6d8f8f8a
-            || uc_crc == 0x753be4a5
-            || uc_crc == 0xda13ab96
-            || uc_crc == 0xe65cb4ad
-            || uc_crc == 0xe1290fa2
-            || uc_crc == 0xde7d67d4
-            || uc_crc == 0x485abff2
-            || uc_crc == UCODE_STARCRAFT_64
-            || uc_crc == 0x2b291027
-            || uc_crc == 0x2f71d1d5
-            || uc_crc == 0x2f7dd1d5
-            || uc_crc == 0x485abff2
-            || uc_crc == 0x93d11f7b
-            || uc_crc == 0x93d11ffb
-            || uc_crc == 0x93d1ff7b
-            || uc_crc == UCODE_FZERO_X
-            || uc_crc == 0x955117fb
-            || uc_crc == UCODE_BIOHAZARD_2
-            || uc_crc == 0xa2d0f88e 
-            || uc_crc == 0xaa86cb1d
-            || uc_crc == 0xaae4a5b9
-            || uc_crc == 0xad0a6292
-            || uc_crc == 0xad0a6312
-            || uc_crc == 0xb62f900f
-            || uc_crc == 0xba65ea1e
-            || uc_crc == UCODE_KIRBY_64_CRYSTAL_SHARDS
-            || uc_crc == UCODE_SUPER_SMASH_BROS
-            || uc_crc == UCODE_MARIO_TENNIS
-            || uc_crc == UCODE_MEGA_MAN_64
-            || uc_crc == UCODE_RIDGE_RACER_64
-            || uc_crc == UCODE_40WINKS
-            || uc_crc == 0xcb8c9b6c
-            || uc_crc == 0xcfa35a45
-            )
-      {
-         settings.ucode = 2;
-         fprintf(stderr, "F3DEX 2.XX (The Legend of Zelda: Ocarina of Time)\n");
-      }
-      else if (
-               uc_crc == UCODE_WAVERACE_64
-            )
-      {
-         settings.ucode = 3;
-         fprintf(stderr, "F3DEX ? (WaveRace)\n");
-      }
-      else if (
-               uc_crc == UCODE_STAR_WARS_SHADOW_OF_THE_EMPIRE
-            )
-      {
-         settings.ucode = 4;
-         fprintf(stderr, "RSP SW 2.0D EXT (Star Wars: Shadows of the Empire)\n");
-      }
-      else if (
-                  uc_crc == UCODE_JET_FORCE_GEMINI
-               || uc_crc == UCODE_MICKEYS_SPEEDWAY_USA
-               || uc_crc == UCODE_DIDDY_KONG_RACING
-               || uc_crc == 0x63be08b3
-            )
-      {
-         settings.ucode = 5;
-         fprintf(stderr, "RSP SW 2.0 (Diddy Kong Racing)\n");
-      }
-      else if (
-                  uc_crc == 0x1ea9e30f
-               || uc_crc == 0x74af0a74
-               || uc_crc == 0x794c3e28
-               || uc_crc == UCODE_BANGAIOH
-               || uc_crc == 0x2b5a89c2
-               || uc_crc == UCODE_YOSHIS_STORY_CRC1
-               || uc_crc == 0xd20dedbf
-            )
-      {
-         settings.ucode = 6;
-         fprintf(stderr, "S2DEX 1.XX  (Yoshi's Story - SimCity 2000)\n");
-      }
-      else if (
-               uc_crc == UCODE_PERFECT_DARK
-            )
-      {
-         settings.ucode = 7;
-         fprintf(stderr, "RSP SW PD (Perfect Dark)\n");
-      }
-      else if (
-               uc_crc == UCODE_CONKERS_BAD_FUR_DAY
-            )
-      {
-         settings.ucode = 8;
-         fprintf(stderr, "F3DEXBG 2.08 (Conker's Bad Fur Day)\n");
-      }
-      else if (
-               uc_crc == 0x0bf36d36
-            )
-      {
-         settings.ucode = 9;
-         fprintf(stderr, "(Star Wars: Battle for Naboo)\n");
-      }
-      else if (
-                  uc_crc == 0x1f120bbb
-               || uc_crc == 0xf9893f70
-               || uc_crc == 0xff372492
-            )
-      {
-         settings.ucode = 21;
-      }
-      else if (
-               uc_crc == 0x0d7bbffb
-            || uc_crc == 0x0ff795bf
-            || uc_crc == UCODE_STAR_WARS_ROGUE_SQUADRON
-            || uc_crc == 0x844b55b5
-            || uc_crc == 0x8ec3e124
-            || uc_crc == 0xd5c4dc96
-            )
-      {
-         settings.ucode = -1;
-         fprintf(stderr, "Unknown Microcode.\n");
-      }
-
+      settings.ucode = info->family;
+      name = ucode_family_name(info->family);
+      if (name)
+         fprintf(stderr, "%s\n", name);
+   }
 
-      fprintf(stderr, "microcheck: old ucode: %d,  new ucode: %d\n", old_ucode, settings.ucode);
-      if (uc_crc == 0x8d5735b2 || uc_crc == 0xb1821ed3 || uc_crc == 0x1118b3e0) //F3DLP.Rej ucode. perspective texture correction is not implemented
-      {
-         rdp.Persp_en = 1;
-         rdp.persp_supported = false;
-      }
-      else if (settings.texture_correction)
-         rdp.persp_supported = true;
+   fprintf(stderr, "microcheck: old ucode: %d,  new ucode: %d\n", old_ucode, settings.ucode);
+   if (uc_crc == 0x8d5735b2 || uc_crc == 0xb1821ed3 || uc_crc == 0x1118b3e0) //F3DLP.Rej ucode. perspective texture correction is not implemented
+   {
+      rdp.Persp_en = 1;
+      rdp.persp_supported = false;
    }
+   else if (settings.texture_correction)
+      rdp.persp_supported = true;
 }
 
 static uint32_t d_ul_x, d_ul_y, d_lr_x, d_lr_y;
@@ -768,6 +562,14 @@ uint32_t ucode5_texshiftcount = 0;
 uint16_t ucode5_texshift = 0;
 int depth_buffer_fog;
 
+// The display list cache follows the F3D family only and can't see what
+// frame buffer emulation does with RDRAM behind its back
+static int dlist_cacheable(void)
+{
+  return settings.dlist_cache && settings.ucode <= ucode_F3DEX2 && !fb_emulation_enabled &&
+    !(settings.frame_buffer & (fb_ref|fb_read_back_to_screen|fb_read_back_to_screen2|fb_cpu_write_hack));
+}
+
 EXPORT void CALL ProcessDList(void)
 {
   no_dlist = false;
@@ -784,19 +586,11 @@ EXPORT void CALL ProcessDList(void)
     if (settings.autodetect_ucode)
     {
       // Thanks to ZeZu for ucode autodetection!!!
-      uint32_t startUcode = *(uint32_t*)(gfx.DMEM+0xFD0);
-      memcpy (microcode, gfx.RDRAM+startUcode, 4096);
-      microcheck ();
+      microcheck (*(uint32_t*)(gfx.DMEM+0xFD0));
     }
-    else
-      memset (microcode, 0, 4096);
   }
   else if ( ((old_ucode == ucode_S2DEX) && (settings.ucode == ucode_F3DEX)) || settings.force_microcheck)
-  {
-    uint32_t startUcode = *(uint32_t*)(gfx.DMEM+0xFD0);
-    memcpy (microcode, gfx.RDRAM+startUcode, 4096);
-    microcheck ();
-  }
+    microcheck (*(uint32_t*)(gfx.DMEM+0xFD0));
 
   if (exception)
     return;
@@ -887,7 +681,18 @@ EXPORT void CALL ProcessDList(void)
   rdp.halt = 0;
   uint32_t a;
 
-  if (settings.ucode == ucode_Turbo3d)
+  DLIST_CACHE_STATE dlc_state[16];
+  int dlc_count = 0;
+  int replayed = false;
+  if (dlist_cacheable())
+  {
+    dlc_count = dlist_cache_state(dlc_state);
+    replayed = dlist_cache_begin(dlc_state, dlc_count);
+  }
+
+  if (replayed)
+    LRDP("display list replayed from the cache\n");
+  else if (settings.ucode == ucode_Turbo3d)
      Turbo3D();
   else
   {
@@ -897,6 +702,7 @@ EXPORT void CALL ProcessDList(void)
         a = rdp.pc[rdp.pc_i] & BMASK;
 
         // Load the next command and its input
+        dlist_cache_read(a, 8);
         rdp.cmd0 = ((uint32_t*)gfx.RDRAM)[a>>2];   // \ Current command, 64 bit
         rdp.cmd1 = ((uint32_t*)gfx.RDRAM)[(a>>2)+1]; // /
         // cmd2 and cmd3 are filled only when needed, by the function that needs them
@@ -927,6 +733,10 @@ EXPORT void CALL ProcessDList(void)
      } while (!rdp.halt);
   }
 
+  RasterizeFlush();
+  if (dlc_count && !replayed)
+    dlist_cache_end(dlc_state, dlc_count);
+
   if (fb_emulation_enabled)
   {
     rdp.scale_x = rdp.scale_x_bak;
@@ -948,6 +758,7 @@ EXPORT void CALL ProcessDList(void)
 // undef - undefined instruction, always ignore
 static void undef()
 {
+  dlist_cache_abort();
 #ifdef _ENDUSER_RELEASE_
   *gfx.MI_INTR_REG |= 0x20;
   gfx.CheckInterrupts();
@@ -972,6 +783,7 @@ static void rdp_noop()
 
 static void ys_memrect ()
 {
+  dlist_cache_abort();
   uint32_t tile = (uint16_t)((rdp.cmd1 & 0x07000000) >> 24);
 
   uint32_t lr_x = (uint16_t)((rdp.cmd0 & 0x00FFF000) >> 14);
@@ -1017,6 +829,7 @@ static void pm_palette_mod ()
    uint8_t prmb = (uint8_t)((float)((rdp.prim_color >> 8)&0xFF)/255.0f*31.0f);
    uint16_t prim16 = (uint16_t)((prmr<<11)|(prmg<<6)|(prmb<<1)|1);
    uint16_t * dst = (uint16_t*)(gfx.RDRAM+rdp.cimg);
+   dlist_cache_abort();
    for (i = 0; i < 16; i++)
       dst[i^1] = (rdp.pal_8[i]&1) ? prim16 : env16;
 
@@ -1033,6 +846,9 @@ static void pd_zcopy ()
    uint16_t width = lr_x - ul_x;
    uint16_t * ptr_src = ((uint16_t*)rdp.tmem)+ul_u;
    uint16_t c;
+
+   RasterizeFlush();
+   dlist_cache_abort();
    for (x = 0; x < width; x++)
    {
       c = ptr_src[x];
@@ -1047,6 +863,7 @@ static void DrawDepthBufferFog(void)
   if (rdp.zi_width < 200)
     return;
 
+  dlist_cache_abort();
   FB_TO_SCREEN_INFO *fb_info = (FB_TO_SCREEN_INFO*)malloc(sizeof(FB_TO_SCREEN_INFO));
   fb_info->addr   = rdp.zimg;
   fb_info->size   = 2;
@@ -1067,6 +884,7 @@ static void rdp_texrect()
   if (!rdp.LLE)
   {
     uint32_t a = rdp.pc[rdp.pc_i];
+    dlist_cache_read(a, 16);
     uint8_t cmdHalf1 = gfx.RDRAM[a+3];
     uint8_t cmdHalf2 = gfx.RDRAM[a+11];
     a >>= 2;
@@ -1481,6 +1299,7 @@ static void rdp_fullsync()
   // Set an interrupt to allow the game to continue
   *gfx.MI_INTR_REG |= 0x20;
   gfx.CheckInterrupts();
+  dlist_cache_interrupt();
   LRDP("fullsync\n");
 }
 
@@ -1590,6 +1409,7 @@ static void rdp_setothermode()
 void load_palette (uint32_t addr, uint16_t start, uint16_t count)
 {
   LRDP("Loading palette... ");
+  dlist_cache_read(addr, count << 1);
   uint16_t *dpal = rdp.pal_8 + start;
   uint16_t end = start+count;
   uint16_t i, p;
@@ -1628,6 +1448,8 @@ static void rdp_loadtlut()
 
    if (start+count > 256) count = 256-start;
 
+   RasterizeFlushRange(rdp.timg.addr, count << 1);
+
    FRDP("loadtlut: tile: %d, start: %d, count: %d, from: %08lx\n", tile, start, count,
          rdp.timg.addr);
 
@@ -1767,11 +1589,9 @@ static INLINE void loadBlock(uint32_t *src, uint32_t *dst, uint32_t off, int dxt
     if ( cnt != 1 )
     {
 LABEL_23:
-      do
-      {
-        *v5++ = bswap32(*v7++);
-        *v5++ = bswap32(*v7++);
-      }while (--v6 );
+      tmem_bswap_qwords(v5, v7, v6);
+      v5 += v6 << 1;
+      v7 += v6 << 1;
     }
     v13 = off & 3;
     if ( off & 3 )
@@ -1803,27 +1623,16 @@ dxt_test:
            v16 += dxt;
            if ( v16 >= 0 )
            {
-              do
-              {
-                 *dst    ^= dst[1];
-                 dst[1] ^= *dst;
-                 *dst    ^= dst[1];
-                 dst += 2;
-              }while(--v18);
+              tmem_swap_words(dst, v18);
+              dst += v18 << 1;
+              v18 = 0;
               goto dxt_test;
            }
         }while(1);
      }
   }while(1);
 end_dxt_test:
-  while ( v18 )
-  {
-     *dst    ^= dst[1];
-     dst[1] ^= *dst;
-     *dst    ^= dst[1];
-     dst += 2;
-     --v18;
-  }
+  tmem_swap_words(dst, v18);
 }
 
 void LoadBlock32b(uint32_t tile, uint32_t ul_s, uint32_t ul_t, uint32_t lr_s, uint32_t dxt);
@@ -1861,6 +1670,9 @@ static void rdp_loadblock()
 
   uint32_t addr = segoffset(rdp.timg.addr) & BMASK;
 
+  // at most 8 bytes per texel
+  RasterizeFlushRange(addr, (lr_s + 1) << 3);
+
   // lr_s specifies number of 64-bit words to copy
   // 10.2 format
   uint16_t ul_s = (uint16_t)(rdp.cmd0 >> 14) & 0x3FF;
@@ -1894,7 +1706,10 @@ static void rdp_loadblock()
   if (rdp.timg.size == 3)
     LoadBlock32b(tile, ul_s, ul_t, lr_s, dxt);
   else
+  {
+    dlist_cache_read(off, cnt << 3);
     loadBlock((uint32_t *)gfx.RDRAM, (uint32_t *)dst, off, _dxt, cnt);
+  }
 
   rdp.timg.addr += cnt << 3;
   rdp.tiles[tile].lr_t = ul_t + ((dxt*cnt)>>11);
@@ -1985,11 +1800,9 @@ static INLINE void loadTile(uint32_t *src, uint32_t *dst, int width, int height,
       if (--v8)
       {
 LABEL_20:
-        do
-        {
-          *v7++ = bswap32(*v13++);
-          *v7++ = bswap32(*v13++);
-        }while (--v8);
+        tmem_bswap_qwords(v7, v13, v8);
+        v7 += v8 << 1;
+        v13 += v8 << 1;
       }
       v19 = v23 & 3;
       if ( v23 & 3 )
@@ -2011,16 +1824,8 @@ LABEL_20:
     if ( v28 == 1 )
     {
       v7 = v31;
-      if ( v30 )
-      {
-        do
-        {
-           *v7    ^= v7[1];
-           v7[1] ^= *v7;
-           *v7    ^= v7[1];
-           v7 += 2;
-        }while (--v8);
-      }
+      tmem_swap_words(v7, v30);
+      v7 += v30 << 1;
       v21 = v29;
       v8 = v30;
     }
@@ -2050,6 +1855,8 @@ static void rdp_loadtile()
 
   if (lr_s < ul_s || lr_t < ul_t) return;
 
+  RasterizeFlushRange(rdp.timg.addr, (lr_t + 1) * ((rdp.timg.width << rdp.timg.size) >> 1));
+
   if (wrong_tile >= 0)  //there was a tile with zero length
   {
     rdp.tiles[wrong_tile].lr_s = lr_s;
@@ -2103,6 +1910,7 @@ static void rdp_loadtile()
     uint32_t wid_64 = rdp.tiles[tile].line;
     unsigned char *dst = ((unsigned char *)rdp.tmem) + (rdp.tiles[tile].t_mem<<3);
     unsigned char *end = ((unsigned char *)rdp.tmem) + 4096 - (wid_64<<3);
+    dlist_cache_read(offs, line_n*height + (wid_64<<3));
     loadTile((uint32_t *)gfx.RDRAM, (uint32_t *)dst, wid_64, height, line_n, offs, (uint32_t *)end);
   }
   FRDP("loadtile: tile: %d, ul_s: %d, ul_t: %d, lr_s: %d, lr_t: %d\n", tile,
@@ -2193,6 +2001,7 @@ static void rdp_fillrect()
   if ((rdp.cimg == rdp.zimg) || (fb_emulation_enabled && rdp.frame_buffers[rdp.ci_count-1].status == ci_zimg) || pd_multiplayer)
   {
     LRDP("Fillrect - cleared the depth buffer\n");
+    RasterizeFlush();
     {
       if (!(settings.hacks&hack_Hyperbike) || rdp.ci_width > 64) //do not clear main depth buffer for aux depth buffers
       {
@@ -2214,6 +2023,13 @@ static void rdp_fillrect()
         ul_x >>= 1;
         lr_x >>= 1;
         uint32_t * dst = (uint32_t*)(gfx.RDRAM+rdp.cimg);
+        if (ul_x == 0 && lr_x == zi_width_in_dwords)
+          dlist_cache_write(rdp.cimg + ((ul_y * zi_width_in_dwords) << 2), ((lr_y - ul_y) * zi_width_in_dwords) << 2, 1);
+        else if (dlist_cache_recording)
+        {
+          for (y = ul_y; y < lr_y; y++)
+            dlist_cache_write_range(rdp.cimg + ((y * zi_width_in_dwords + ul_x) << 2), (lr_x - ul_x) << 2, 1);
+        }
         dst += ul_y * zi_width_in_dwords;
         for (y = ul_y; y < lr_y; y++)
         {
@@ -2498,6 +2314,7 @@ static void rdp_settextureimage()
 
 static void rdp_setdepthimage()
 {
+  RasterizeFlush();
   rdp.zimg = segoffset(rdp.cmd1) & BMASK;
   rdp.zi_width = rdp.ci_width;
   FRDP("setdepthimage - %08lx\n", rdp.zimg);
@@ -2530,6 +2347,8 @@ static void rdp_setcolorimage()
 {
    int i;
 
+   RasterizeFlush();
+
    if (fb_emulation_enabled && (rdp.num_of_ci < NUMTEXBUF))
    {
       COLOR_IMAGE *cur_fb  = &rdp.frame_buffers[rdp.ci_count];
@@ -3351,6 +3170,7 @@ static uint32_t rdp_cmd_data[0x1000];
 void lle_triangle(uint32_t w1, uint32_t w2, int shade, int texture, int zbuffer,
                   uint32_t * rdp_cmd)
 {
+  dlist_cache_abort();
   rdp.cur_tile = (w1 >> 16) & 0x7;
   int j;
   int xleft, xright, xleft_inc, xright_inc;
@@ -3869,6 +3689,7 @@ static void rdphalf_1(void)
    if (cmd >= 0xc8 && cmd <=0xcf) //triangle command
    {
       LRDP("rdphalf_1 - lle triangle\n");
+      dlist_cache_abort();
       rdp_cmd_ptr = 0;
       rdp_cmd_cur = 0;
       uint32_t a;
@@ -3989,9 +3810,34 @@ EXPORT void CALL ProcessRDPList(void)
       rdp_cmd_cur += rdp_command_length[cmd] / 4;
    };
 
+   RasterizeFlush();
    rdp.LLE = false;
    dp_start = dp_end;
    dp_status &= ~0x0002;
 
    //}
 }
+
+// The rdp.c globals a display list can change, saved and restored by the
+// display list cache together with rdp
+static int dlist_cache_state(DLIST_CACHE_STATE *state)
+{
+   int n = 0;
+#define DLC_STATE(var) state[n].ptr = &(var); state[n].size = sizeof(var); n++
+   DLC_STATE(wrong_tile);
+   DLC_STATE(tile_set);
+   DLC_STATE(SwapOK);
+   DLC_STATE(swapped_addr);
+   DLC_STATE(d_ul_x);
+   DLC_STATE(d_ul_y);
+   DLC_STATE(d_lr_x);
+   DLC_STATE(d_lr_y);
+   DLC_STATE(CI_SET);
+   DLC_STATE(ucode5_texshiftaddr);
+   DLC_STATE(ucode5_texshiftcount);
+   DLC_STATE(ucode5_texshift);
+   DLC_STATE(depth_buffer_fog);
+   DLC_STATE(branch_dl);
+#undef DLC_STATE
+   return n;
+}
@@ -64,6 +64,10 @@ extern uint32_t frame_count; // frame counter
 #define CLIP_ZMAX 0x00000020
 #define CLIP_ZMIN 0x00000040
 
+// How far past the screen edges, in pixels, the vertices of a triangle may
+// lie for the x/y clipping to be left to the hardware scissor
+#define GUARD_BAND 8192.0f
+
 // Flags
 #define ZBUF_ENABLED  0x00000001
 #define ZBUF_DECAL    0x00000002
@@ -299,6 +303,7 @@ typedef struct
    int zmode_compare_less; //force GR_CMP_LESS for zmode=0 (opaque)and zmode=1 (interpenetrating)
    int old_style_adither; //apply alpha dither regardless of alpha_dither_mode
    int n64_z_scale; //scale vertex z value before writing to depth buffer, as N64 does.
+   int dlist_cache; //replay unchanged display lists from the display list cache
 
    uint32_t hacks;
 
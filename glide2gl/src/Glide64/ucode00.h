@@ -49,11 +49,13 @@
 #define ucode_zSort 9
 #define ucode_Turbo3d 21
 
+// Positions of the vertices being loaded, shared by all ucodes
+static VERTEX_BATCH vtx_batch;
+
 static void rsp_vertex(int v0, int n)
 {
    uint32_t addr = segoffset(rdp.cmd1) & 0x00FFFFFF;
    int i;
-   float x, y, z;
 
    rdp.v0 = v0; // Current vertex
    rdp.vn = n;  // Number to copy
@@ -83,70 +85,31 @@ static void rsp_vertex(int v0, int n)
 
    FRDP ("rsp:vertex v0:%d, n:%d, from: %08lx\n", v0, n, addr);
 
-   for (i=0; i < (n<<4); i+=16)
+   dlist_cache_read(addr, n << 4);
+   LoadVertices(&rdp.vtx[v0], &vtx_batch, addr, n, rdp.geom_mode & 0x00020000);
+   TransformVertices(&rdp.vtx[v0], &vtx_batch, n, rdp.combined, NULL, VTX_FOG);
+
+   if (rdp.geom_mode & 0x00020000)
    {
-      VERTEX *v = &rdp.vtx[v0 + (i>>4)];
-      x   = (float)((short*)gfx.RDRAM)[(((addr+i) >> 1) + 0)^1];
-      y   = (float)((short*)gfx.RDRAM)[(((addr+i) >> 1) + 1)^1];
-      z   = (float)((short*)gfx.RDRAM)[(((addr+i) >> 1) + 2)^1];
-      v->flags  = ((uint16_t*)gfx.RDRAM)[(((addr+i) >> 1) + 3)^1];
-      v->ou = (float)((short*)gfx.RDRAM)[(((addr+i) >> 1) + 4)^1];
-      v->ov = (float)((short*)gfx.RDRAM)[(((addr+i) >> 1) + 5)^1];
-      v->uv_scaled = 0;
-      v->a    = ((uint8_t*)gfx.RDRAM)[(addr+i + 15)^3];
-
-      v->x = x*rdp.combined[0][0] + y*rdp.combined[1][0] + z*rdp.combined[2][0] + rdp.combined[3][0];
-      v->y = x*rdp.combined[0][1] + y*rdp.combined[1][1] + z*rdp.combined[2][1] + rdp.combined[3][1];
-      v->z = x*rdp.combined[0][2] + y*rdp.combined[1][2] + z*rdp.combined[2][2] + rdp.combined[3][2];
-      v->w = x*rdp.combined[0][3] + y*rdp.combined[1][3] + z*rdp.combined[2][3] + rdp.combined[3][3];
-
-
-      if (fabs(v->w) < 0.001) v->w = 0.001f;
-      v->oow = 1.0f / v->w;
-      v->x_w = v->x * v->oow;
-      v->y_w = v->y * v->oow;
-      v->z_w = v->z * v->oow;
-      CalculateFog (v);
-
-      v->uv_calculated = 0xFFFFFFFF;
-      v->screen_translated = 0;
-      v->shade_mod = 0;
-
-      v->scr_off = 0;
-      if (v->x < -v->w) v->scr_off |= 1;
-      if (v->x > v->w) v->scr_off |= 2;
-      if (v->y < -v->w) v->scr_off |= 4;
-      if (v->y > v->w) v->scr_off |= 8;
-      if (v->w < 0.1f) v->scr_off |= 16;
-      //    if (v->z_w > 1.0f) v->scr_off |= 32;
-
-      if (rdp.geom_mode & 0x00020000)
+      if (rdp.geom_mode & 0x40000)
       {
-         v->vec[0] = ((char*)gfx.RDRAM)[(addr+i + 12)^3];
-         v->vec[1] = ((char*)gfx.RDRAM)[(addr+i + 13)^3];
-         v->vec[2] = ((char*)gfx.RDRAM)[(addr+i + 14)^3];
-         if (rdp.geom_mode & 0x40000)
+         for (i = 0; i < n; i++)
          {
             if (rdp.geom_mode & 0x80000)
-               calc_linear (v);
+               calc_linear (&rdp.vtx[v0 + i]);
             else
-               calc_sphere (v);
+               calc_sphere (&rdp.vtx[v0 + i]);
          }
-         NormalizeVector (v->vec);
-
-         calc_light (v);
-      }
-      else
-      {
-         v->r = ((uint8_t*)gfx.RDRAM)[(addr+i + 12)^3];
-         v->g = ((uint8_t*)gfx.RDRAM)[(addr+i + 13)^3];
-         v->b = ((uint8_t*)gfx.RDRAM)[(addr+i + 14)^3];
       }
+      LightVertices(&rdp.vtx[v0], n);
+   }
 #ifdef EXTREME_LOGGING
-      FRDP ("v%d - x: %f, y: %f, z: %f, w: %f, u: %f, v: %f, f: %f, z_w: %f, r=%d, g=%d, b=%d, a=%d\n", i>>4, v->x, v->y, v->z, v->w, v->ou*rdp.tiles[rdp.cur_tile].s_scale, v->ov*rdp.tiles[rdp.cur_tile].t_scale, v->f, v->z_w, v->r, v->g, v->b, v->a);
-#endif
-
+   for (i = 0; i < n; i++)
+   {
+      VERTEX *v = &rdp.vtx[v0 + i];
+      FRDP ("v%d - x: %f, y: %f, z: %f, w: %f, u: %f, v: %f, f: %f, z_w: %f, r=%d, g=%d, b=%d, a=%d\n", i, v->x, v->y, v->z, v->w, v->ou*rdp.tiles[rdp.cur_tile].s_scale, v->ov*rdp.tiles[rdp.cur_tile].t_scale, v->f, v->z_w, v->r, v->g, v->b, v->a);
    }
+#endif
 }
 
 static void rsp_tri1(VERTEX **v, uint16_t linew)
@@ -271,6 +234,7 @@ void load_matrix (float m[4][4], uint32_t addr)
 {
    FRDP ("matrix - addr: %08lx\n", addr);
    int x,y;  // matrix index
+   dlist_cache_read(addr, 64);
    addr >>= 1;
    uint16_t * src = (uint16_t*)gfx.RDRAM;
 
@@ -365,6 +329,7 @@ static void uc0_movemem()
    LRDP("uc0:movemem ");
 
    uint32_t i,a;
+   dlist_cache_read(segoffset(rdp.cmd1) & 0xFFFFFF, 16);
 
    // Check the command
    switch ((rdp.cmd0 >> 16) & 0xFF)
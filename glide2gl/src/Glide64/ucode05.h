@@ -132,64 +132,30 @@ static void uc5_vertex(void)
    int prj = cur_mtx;
 
    int start = 0;
-   float x, y, z;
    for (i = first; i < first + n; i++)
    {
       start = (i-first) * 10;
       VERTEX *v = &rdp.vtx[i];
-      x   = (float)((short*)gfx.RDRAM)[(((addr+start) >> 1) + 0)^1];
-      y   = (float)((short*)gfx.RDRAM)[(((addr+start) >> 1) + 1)^1];
-      z   = (float)((short*)gfx.RDRAM)[(((addr+start) >> 1) + 2)^1];
-
-      v->x = x*rdp.dkrproj[prj][0][0] + y*rdp.dkrproj[prj][1][0] + z*rdp.dkrproj[prj][2][0] + rdp.dkrproj[prj][3][0];
-      v->y = x*rdp.dkrproj[prj][0][1] + y*rdp.dkrproj[prj][1][1] + z*rdp.dkrproj[prj][2][1] + rdp.dkrproj[prj][3][1];
-      v->z = x*rdp.dkrproj[prj][0][2] + y*rdp.dkrproj[prj][1][2] + z*rdp.dkrproj[prj][2][2] + rdp.dkrproj[prj][3][2];
-      v->w = x*rdp.dkrproj[prj][0][3] + y*rdp.dkrproj[prj][1][3] + z*rdp.dkrproj[prj][2][3] + rdp.dkrproj[prj][3][3];
-
-      if (billboarding)
-      {
-         v->x += rdp.vtx[0].x;
-         v->y += rdp.vtx[0].y;
-         v->z += rdp.vtx[0].z;
-         v->w += rdp.vtx[0].w;
-      }
-
-      if (fabs(v->w) < 0.001)
-         v->w = 0.001f;
-
-      v->oow = 1.0f / v->w;
-      v->x_w = v->x * v->oow;
-      v->y_w = v->y * v->oow;
-      v->z_w = v->z * v->oow;
-
-      v->uv_calculated = 0xFFFFFFFF;
-      v->screen_translated = 0;
-      v->shade_mod = 0;
-
-      v->scr_off = 0;
-      if (v->x < -v->w)
-         v->scr_off |= 1;
-      if (v->x > v->w)
-         v->scr_off |= 2;
-      if (v->y < -v->w)
-         v->scr_off |= 4;
-      if (v->y > v->w)
-         v->scr_off |= 8;
-      if (v->w < 0.1f)
-         v->scr_off |= 16;
-      if (fabs(v->z_w) > 1.0)
-         v->scr_off |= 32;
+      vtx_batch.x[i-first] = (float)((short*)gfx.RDRAM)[(((addr+start) >> 1) + 0)^1];
+      vtx_batch.y[i-first] = (float)((short*)gfx.RDRAM)[(((addr+start) >> 1) + 1)^1];
+      vtx_batch.z[i-first] = (float)((short*)gfx.RDRAM)[(((addr+start) >> 1) + 2)^1];
 
       v->r = ((uint8_t*)gfx.RDRAM)[(addr+start + 6)^3];
       v->g = ((uint8_t*)gfx.RDRAM)[(addr+start + 7)^3];
       v->b = ((uint8_t*)gfx.RDRAM)[(addr+start + 8)^3];
       v->a = ((uint8_t*)gfx.RDRAM)[(addr+start + 9)^3];
-      CalculateFog (v);
+   }
+
+   TransformVertices(&rdp.vtx[first], &vtx_batch, n, rdp.dkrproj[prj],
+         billboarding ? &rdp.vtx[0] : NULL, VTX_FOG | VTX_CLIP_Z);
 
 #ifdef EXTREME_LOGGING
+   for (i = first; i < first + n; i++)
+   {
+      VERTEX *v = &rdp.vtx[i];
       FRDP ("v%d - x: %f, y: %f, z: %f, w: %f, z_w: %f, r=%d, g=%d, b=%d, a=%d\n", i, v->x, v->y, v->z, v->w, v->z_w, v->r, v->g, v->b, v->a);
-#endif
    }
+#endif
 
    vtx_last += n;
 }
@@ -692,6 +692,7 @@ struct MAT2D {
 
 static void uc6_read_background_data (DRAWIMAGE *d, bool bReadScale)
 {
+  dlist_cache_abort();
   uint32_t addr = segoffset(rdp.cmd1) >> 1;
 
   d->imageX      = (((uint16_t *)gfx.RDRAM)[(addr+0)^1] >> 5);   // 0
@@ -962,6 +963,7 @@ static void uc6_draw_polygons (VERTEX v[4])
 
 static void uc6_read_object_data (DRAWOBJECT *d)
 {
+  dlist_cache_abort();
   uint32_t addr = segoffset(rdp.cmd1) >> 1;
 
   d->objX            = ((short*)gfx.RDRAM)[(addr+0)^1] / 4.0f;               // 0
@@ -1137,6 +1139,7 @@ static void uc6_obj_sprite ()
 
 static void uc6_obj_movemem ()
 {
+  dlist_cache_abort();
   LRDP("uc6:obj_movemem\n");
 
   int index = rdp.cmd0 & 0xFFFF;
@@ -1174,6 +1177,7 @@ static void uc6_select_dl ()
 
 static void uc6_obj_rendermode ()
 {
+  dlist_cache_abort();
   LRDP("uc6:obj_rendermode\n");
   RDP_E ("uc6:obj_rendermode\n");
 }
@@ -1306,6 +1310,7 @@ static void uc6_obj_rectangle_r(void)
 
 static void uc6_obj_loadtxtr(void)
 {
+   dlist_cache_abort();
    LRDP("uc6:obj_loadtxtr ");
    rdp.s2dex_tex_loaded = true;
    rdp.update |= UPDATE_TEXTURE;
@@ -1403,19 +1408,16 @@ static void uc6_ldtx_rect_r(void)
 
 static void uc6_loaducode(void)
 {
+   dlist_cache_abort();
    LRDP("uc6:load_ucode\n");
    RDP_E ("uc6:load_ucode\n");
 
-   // copy the microcode data
-   uint32_t addr = segoffset(rdp.cmd1);
-   uint32_t size = (rdp.cmd0 & 0xFFFF) + 1;
-   memcpy (microcode, gfx.RDRAM+addr, size);
-
-   microcheck ();
+   microcheck (segoffset(rdp.cmd1));
 }
 
 void uc6_sprite2d(void)
 {
+   dlist_cache_abort();
    int i, s;
    uint32_t a = rdp.pc[rdp.pc_i] & BMASK;
    uint32_t cmd0 = ((uint32_t*)gfx.RDRAM)[a>>2]; //check next command
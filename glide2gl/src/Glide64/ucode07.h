@@ -87,7 +87,6 @@ static void uc7_vertex(void)
 
    uint32_t addr = segoffset(rdp.cmd1);
    uint32_t v0, i, n;
-   float x, y, z;
 
    rdp.v0 = v0 = (rdp.cmd0 & 0x0F0000) >> 16;
    rdp.vn = n = ((rdp.cmd0 & 0xF00000) >> 20) + 1;
@@ -99,80 +98,63 @@ static void uc7_vertex(void)
    for (i = 0; i < n; i++)
    {
       VERTEX *v = &rdp.vtx[v0 + i];
-      x   = (float)vertex->x;
-      y   = (float)vertex->y;
-      z   = (float)vertex->z;
+      vtx_batch.x[i] = (float)vertex->x;
+      vtx_batch.y[i] = (float)vertex->y;
+      vtx_batch.z[i] = (float)vertex->z;
       v->flags  = 0;
       v->ou   = (float)vertex->s;
       v->ov   = (float)vertex->t;
       v->uv_scaled = 0;
 
-#ifdef EXTREME_LOGGING
-      //    FRDP ("before: v%d - x: %f, y: %f, z: %f, flags: %04lx, ou: %f, ov: %f\n", i>>4, x, y, z, v->flags, v->ou, v->ov);
-#endif
-
-      v->x = x*rdp.combined[0][0] + y*rdp.combined[1][0] + z*rdp.combined[2][0] + rdp.combined[3][0];
-      v->y = x*rdp.combined[0][1] + y*rdp.combined[1][1] + z*rdp.combined[2][1] + rdp.combined[3][1];
-      v->z = x*rdp.combined[0][2] + y*rdp.combined[1][2] + z*rdp.combined[2][2] + rdp.combined[3][2];
-      v->w = x*rdp.combined[0][3] + y*rdp.combined[1][3] + z*rdp.combined[2][3] + rdp.combined[3][3];
-
-
-      if (fabs(v->w) < 0.001) v->w = 0.001f;
-      v->oow = 1.0f / v->w;
-      v->x_w = v->x * v->oow;
-      v->y_w = v->y * v->oow;
-      v->z_w = v->z * v->oow;
-
-      v->uv_calculated = 0xFFFFFFFF;
-      v->screen_translated = 0;
-
-      v->scr_off = 0;
-      if (v->x < -v->w) v->scr_off |= 1;
-      if (v->x > v->w) v->scr_off |= 2;
-      if (v->y < -v->w) v->scr_off |= 4;
-      if (v->y > v->w) v->scr_off |= 8;
-      if (v->w < 0.1f) v->scr_off |= 16;
-
       uint8_t *color = &gfx.RDRAM[pd_col_addr + (vertex->idx & 0xff)];
 
       v->a = color[0];
-      CalculateFog (v);
 
       if (rdp.geom_mode & 0x00020000)
       {
-         v->vec[0] = (char)color[3];
-         v->vec[1] = (char)color[2];
-         v->vec[2] = (char)color[1];
+         v->vec[0] = (int8_t)color[3];
+         v->vec[1] = (int8_t)color[2];
+         v->vec[2] = (int8_t)color[1];
+      }
+      else
+      {
+         v->r = color[3];
+         v->g = color[2];
+         v->b = color[1];
+      }
+      vertex++;
+   }
+
+   TransformVertices(&rdp.vtx[v0], &vtx_batch, n, rdp.combined, NULL, VTX_FOG);
 
+   if (rdp.geom_mode & 0x00020000)
+   {
+      for (i = 0; i < n; i++)
+      {
+         VERTEX *v = &rdp.vtx[v0 + i];
          if (rdp.geom_mode & 0x80000) 
          {
             calc_linear (v);
 #ifdef EXTREME_LOGGING
-            FRDP ("calc linear: v%d - u: %f, v: %f\n", i>>4, v->ou, v->ov);
+            FRDP ("calc linear: v%d - u: %f, v: %f\n", i, v->ou, v->ov);
 #endif
          }
          else if (rdp.geom_mode & 0x40000) 
          {
             calc_sphere (v);
 #ifdef EXTREME_LOGGING
-            FRDP ("calc sphere: v%d - u: %f, v: %f\n", i>>4, v->ou, v->ov);
+            FRDP ("calc sphere: v%d - u: %f, v: %f\n", i, v->ou, v->ov);
 #endif
          }
-
-         NormalizeVector (v->vec);
-
-         calc_light (v);
-      }
-      else
-      {
-         v->r = color[3];
-         v->g = color[2];
-         v->b = color[1];
       }
+      LightVertices(&rdp.vtx[v0], n);
+   }
 #ifdef EXTREME_LOGGING
-      FRDP ("v%d - x: %f, y: %f, z: %f, w: %f, u: %f, v: %f\n", i>>4, v->x, v->y, v->z, v->w, v->ou, v->ov);
-#endif
-      vertex++;
+   for (i = 0; i < n; i++)
+   {
+      VERTEX *v = &rdp.vtx[v0 + i];
+      FRDP ("v%d - x: %f, y: %f, z: %f, w: %f, u: %f, v: %f\n", i, v->x, v->y, v->z, v->w, v->ou, v->ov);
    }
+#endif
 }
 
@@ -57,6 +57,8 @@ void vbo_init(void) { }
 
 void vbo_draw(void)
 {
+   tex_upload_flush();
+
    if(!vertex_buffer_count)
       return;
 
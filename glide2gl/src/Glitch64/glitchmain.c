@@ -854,6 +854,7 @@ grBufferSwap( FxU32 swap_interval )
       return;
 
    retro_return(true);
+   tex_pool_end_frame();
 
    for (i = 0; i < nb_fb; i++)
       fbs[i].buff_clear = 1;
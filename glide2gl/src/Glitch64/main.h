@@ -78,6 +78,8 @@ void add_tex(unsigned int id);
 void init_textures(void);
 void free_textures(void);
 void remove_tex(unsigned int idmin, unsigned int idmax);
+void tex_upload_flush(void);
+void tex_pool_end_frame(void);
 
 void set_lambda(void);
 
@@ -23,6 +23,7 @@
 #else // _WIN32
 #include <stdlib.h>
 #endif // _WIN32
+#include <string.h>
 #include "glide.h"
 #include "main.h"
 #include <stdio.h>
@@ -50,15 +51,59 @@ static int min_filter1, mag_filter1, wrap_s1, wrap_t1;
 
 unsigned char *filter(unsigned char *source, int width, int height, int *width2, int *height2);
 
+// Texture names are TMU addresses + 1. Textures downloaded by
+// grTexDownloadMipMap remember their storage, so that a later download
+// of the same size and format to the same address reuses it with
+// glTexSubImage2D; width is 0 for the texture buffers (FBOs).
 typedef struct _texlist
 {
    unsigned int id;
+   int width, height;
+   int gltexfmt, glpixfmt, glpackfmt;
+   unsigned int bytes;
    struct _texlist *next;
 } texlist;
 
 static int nbTex = 0;
 static texlist *list = NULL;
 
+// Bytes of GL storage held by downloaded textures, and the most the
+// pool may hold before Glide64 is asked to clear its cache
+static unsigned int pool_bytes;
+static unsigned int downloads_since_trim;
+extern unsigned retro_texture_budget;
+
+static unsigned int bound_tex[NUM_TMU];
+static GrTexPoolStats pool_frame, pool_last_frame;
+
+// Uploads wait here until the next draw call (vbo_draw), so the
+// downloads between two draws go to GL in one batch and a texture
+// downloaded twice in between is only uploaded once.
+#define MAX_PENDING_UPLOADS  64
+#define UPLOAD_STAGING_SIZE  (4 * 1024 * 1024)
+
+typedef struct
+{
+   unsigned int id;     // 0 once superseded or removed
+   int sub;             // the storage is already there
+   int width, height;
+   int gltexfmt, glpixfmt, glpackfmt;
+   unsigned int offset, bytes;
+} pending_upload;
+
+static pending_upload pending[MAX_PENDING_UPLOADS];
+static int nb_pending;
+static unsigned int staging_used;
+static unsigned char *staging = NULL;
+
+static void drop_pending(unsigned int idmin, unsigned int idmax)
+{
+   int i;
+   for (i = 0; i < nb_pending; i++)
+      if (pending[i].id >= idmin && pending[i].id < idmax)
+         pending[i].id = 0;
+}
+
 void remove_tex(unsigned int idmin, unsigned int idmax)
 {
   unsigned int *t;
@@ -73,6 +118,7 @@ void remove_tex(unsigned int idmin, unsigned int idmax)
     if (n >= sz)
       t = (unsigned int *) realloc(t, ++sz*sizeof(int));
     t[n++] = aux->id;
+    pool_bytes -= aux->bytes;
     aux = aux->next;
     free(list);
     list = aux;
@@ -86,17 +132,27 @@ void remove_tex(unsigned int idmin, unsigned int idmax)
       if (n >= sz)
         t = (unsigned int *) realloc(t, ++sz*sizeof(int));
       t[n++] = aux->next->id;
+      pool_bytes -= aux->next->bytes;
       free(aux->next);
       aux->next = aux2;
       nbTex--;
     }
     aux = aux->next;
   }
+  drop_pending(idmin, idmax);
   glDeleteTextures(n, t);
   free(t);
   TEXLOG("RMVTEX nbtex is now %d (%06x - %06x)\n", nbTex, idmin, idmax);
 }
 
+static texlist *find_tex(unsigned int id)
+{
+  texlist *aux = list;
+  while (aux != NULL && aux->id < id)
+    aux = aux->next;
+  return (aux != NULL && aux->id == id) ? aux : NULL;
+}
+
 
 void add_tex(unsigned int id)
 {
@@ -105,7 +161,7 @@ void add_tex(unsigned int id)
   if (list == NULL || id < list->id)
   {
     nbTex++;
-    list = (texlist*)malloc(sizeof(texlist));
+    list = (texlist*)calloc(1, sizeof(texlist));
     list->next = aux;
     list->id = id;
     goto addtex_log;
@@ -116,7 +172,7 @@ void add_tex(unsigned int id)
      return;
   nbTex++;
   aux2 = aux->next;
-  aux->next = (texlist*)malloc(sizeof(texlist));
+  aux->next = (texlist*)calloc(1, sizeof(texlist));
   aux->next->id = id;
   aux->next->next = aux2;
 addtex_log:
@@ -129,19 +185,196 @@ void init_textures(void)
 
   list = NULL;
   nbTex = 0;
+  pool_bytes = 0;
+  downloads_since_trim = 0;
+  bound_tex[0] = bound_tex[1] = 0;
+  nb_pending = 0;
+  staging_used = 0;
+  memset(&pool_frame, 0, sizeof(pool_frame));
+  memset(&pool_last_frame, 0, sizeof(pool_last_frame));
 
   if (!texture)
      texture = (unsigned char*)malloc(2048*2048*4);
+  if (!staging)
+     staging = (unsigned char*)malloc(UPLOAD_STAGING_SIZE);
 }
 
 void free_textures()
 {
   remove_tex(0x00000000, 0xFFFFFFFF);
+  nb_pending = 0;
+  staging_used = 0;
   if (texture != NULL)
   {
     free(texture);
     texture = NULL;
   }
+  if (staging != NULL)
+  {
+    free(staging);
+    staging = NULL;
+  }
+}
+
+// bytes per texel GL stores for a format/type pair
+static int gl_texel_size(int glpixfmt, int glpackfmt)
+{
+   if (glpackfmt == GL_UNSIGNED_BYTE)
+   {
+      switch (glpixfmt)
+      {
+         case GL_LUMINANCE:
+         case GL_ALPHA:
+            return 1;
+         case GL_LUMINANCE_ALPHA:
+            return 2;
+         case GL_RGB:
+            return 3;
+      }
+      return 4;
+   }
+#ifndef GLES
+   if (glpackfmt == GL_UNSIGNED_INT_8_8_8_8_REV)
+      return 4;
+#endif
+   return 2;
+}
+
+static void upload(unsigned int id, int sub, int width, int height,
+      int gltexfmt, int glpixfmt, int glpackfmt, const void *data)
+{
+   glBindTexture(GL_TEXTURE_2D, id);
+   if (sub)
+      glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, glpixfmt, glpackfmt, data);
+   else
+      glTexImage2D(GL_TEXTURE_2D, 0, gltexfmt, width, height, 0, glpixfmt, glpackfmt, data);
+}
+
+void tex_upload_flush(void)
+{
+   GLint active;
+   int i;
+
+   if (!nb_pending)
+      return;
+
+   glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+   glActiveTexture(GL_TEXTURE2);
+   for (i = 0; i < nb_pending; i++)
+   {
+      pending_upload *p = &pending[i];
+      if (p->id)
+         upload(p->id, p->sub, p->width, p->height, p->gltexfmt, p->glpixfmt, p->glpackfmt, staging + p->offset);
+   }
+   glBindTexture(GL_TEXTURE_2D, default_texture);
+   glActiveTexture(active);
+
+   pool_frame.batches++;
+   nb_pending = 0;
+   staging_used = 0;
+}
+
+static void queue_upload(unsigned int id, int sub, int width, int height,
+      int gltexfmt, int glpixfmt, int glpackfmt, const void *data, unsigned int bytes)
+{
+   pending_upload *p;
+   int i;
+
+   for (i = 0; i < nb_pending; i++)
+   {
+      if (pending[i].id == id)
+      {
+         // the storage only exists once the first upload is made
+         sub &= pending[i].sub;
+         pending[i].id = 0;
+      }
+   }
+
+   if (bytes > UPLOAD_STAGING_SIZE || staging == NULL)
+   {
+      tex_upload_flush();
+      glActiveTexture(GL_TEXTURE2);
+      upload(id, sub, width, height, gltexfmt, glpixfmt, glpackfmt, data);
+      glBindTexture(GL_TEXTURE_2D, default_texture);
+      return;
+   }
+   if (nb_pending == MAX_PENDING_UPLOADS || staging_used + bytes > UPLOAD_STAGING_SIZE)
+      tex_upload_flush();
+
+   p = &pending[nb_pending++];
+   p->id = id;
+   p->sub = sub;
+   p->width = width;
+   p->height = height;
+   p->gltexfmt = gltexfmt;
+   p->glpixfmt = glpixfmt;
+   p->glpackfmt = glpackfmt;
+   p->offset = staging_used;
+   p->bytes = bytes;
+   memcpy(staging + staging_used, data, bytes);
+   staging_used += (bytes + 15) & ~15;
+}
+
+void tex_pool_end_frame(void)
+{
+   pool_frame.vram_bytes = pool_bytes;
+   pool_last_frame = pool_frame;
+   memset(&pool_frame, 0, sizeof(pool_frame));
+}
+
+FX_ENTRY void FX_CALL
+grTexPoolStatsExt(GrTexPoolStats *stats)
+{
+   *stats = pool_last_frame;
+}
+
+// The few downloads Glide64 makes right after clearing its cache never
+// ask for another clear, even if the bound textures alone are over
+FX_ENTRY FxBool FX_CALL
+grTexPoolFullExt(void)
+{
+   return pool_bytes > retro_texture_budget && downloads_since_trim >= 8;
+}
+
+// Called once Glide64 has cleared its texture cache: nothing refers to
+// the downloaded textures any more, except the two bound ones. Those at
+// the lowest addresses are kept, the cache is refilled from there and
+// will mostly reuse them; the rest goes until half the budget is left.
+FX_ENTRY void FX_CALL
+grTexPoolTrimExt(void)
+{
+   unsigned int kept = 0, evicted = 0, *t;
+   int n = 0;
+   texlist *aux, **link = &list;
+
+   downloads_since_trim = 0;
+   if (pool_bytes <= retro_texture_budget / 2)
+      return;
+
+   t = (unsigned int*)malloc(nbTex * sizeof(int));
+   if (t == NULL)
+      return;
+   while ((aux = *link) != NULL)
+   {
+      if (aux->width && aux->id != bound_tex[0] && aux->id != bound_tex[1]
+            && kept + aux->bytes > retro_texture_budget / 2)
+      {
+         t[n++] = aux->id;
+         evicted += aux->bytes;
+         drop_pending(aux->id, aux->id + 1);
+         *link = aux->next;
+         free(aux);
+         nbTex--;
+         continue;
+      }
+      kept += aux->bytes;
+      link = &aux->next;
+   }
+   glDeleteTextures(n, t);
+   free(t);
+   pool_bytes -= evicted;
+   pool_frame.evicted += n;
+   TEXLOG("TRIMTEX nbtex is now %d, %d bytes\n", nbTex, pool_bytes);
 }
 
 FX_ENTRY FxU32 FX_CALL
@@ -352,6 +585,9 @@ grTexDownloadMipMap( GrChipID_t tmu,
    int width, height;
    int factor;
    int gltexfmt, glpixfmt, glpackfmt;
+   texlist *tex;
+   unsigned int bytes;
+   int sub;
    LOG("grTexDownloadMipMap(%d,%d,%d)\r\n", tmu, startAddress, evenOdd);
    if (info->largeLodLog2 != info->smallLodLog2) DISPLAY_WARNING("grTexDownloadMipMap : loading more than one LOD");
 
@@ -513,14 +749,33 @@ grTexDownloadMipMap( GrChipID_t tmu,
       }
    }
 
-   glActiveTexture(GL_TEXTURE2);
-   remove_tex(startAddress+1, startAddress+1+(width*height*factor));
+   // the textures this one overwrites in TMU memory go, its own name
+   // keeps its storage if the size and format are unchanged
+   remove_tex(startAddress+2, startAddress+1+(width*height*factor));
 
    add_tex(startAddress+1);
-   glBindTexture(GL_TEXTURE_2D, startAddress+1);
+   tex = find_tex(startAddress+1);
+   bytes = width * height * gl_texel_size(glpixfmt, glpackfmt);
+   sub = tex->width == width && tex->height == height && tex->gltexfmt == gltexfmt
+      && tex->glpixfmt == glpixfmt && tex->glpackfmt == glpackfmt;
+   if (sub)
+      pool_frame.reused++;
+   else
+   {
+      pool_bytes += bytes - tex->bytes;
+      tex->width = width;
+      tex->height = height;
+      tex->gltexfmt = gltexfmt;
+      tex->glpixfmt = glpixfmt;
+      tex->glpackfmt = glpackfmt;
+      tex->bytes = bytes;
+      pool_frame.allocated++;
+   }
+   pool_frame.uploads++;
+   pool_frame.upload_bytes += bytes;
+   downloads_since_trim++;
 
-   glTexImage2D(GL_TEXTURE_2D, 0, gltexfmt, width, height, 0, glpixfmt, glpackfmt, info->data);
-   glBindTexture(GL_TEXTURE_2D, default_texture);
+   queue_upload(startAddress+1, sub, width, height, gltexfmt, glpixfmt, glpackfmt, info->data, bytes);
 }
 
 FX_ENTRY void FX_CALL
@@ -531,6 +786,8 @@ grTexSource( GrChipID_t tmu,
 {
    LOG("grTexSource(%d,%d,%d)\r\n", tmu, startAddress, evenOdd);
 
+   bound_tex[tmu == GR_TMU1 ? 0 : 1] = startAddress+1;
+
    if (tmu == GR_TMU1)
    {
       glActiveTexture(GL_TEXTURE0);
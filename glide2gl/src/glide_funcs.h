@@ -164,6 +164,22 @@ grTextureAuxBufferExt( GrChipID_t tmu,
 FX_ENTRY void FX_CALL grAuxBufferExt( GrBuffer_t buffer );
 #endif
 
+// texture pool extension, counts of the last complete frame
+typedef struct
+{
+   FxU32 uploads;       // grTexDownloadMipMap calls
+   FxU32 upload_bytes;  // bytes handed to GL
+   FxU32 reused;        // uploads into the storage already there
+   FxU32 allocated;     // uploads that needed new storage
+   FxU32 evicted;       // textures deleted to stay within the budget
+   FxU32 batches;       // draw flushes that uploaded textures
+   FxU32 vram_bytes;    // storage held at the end of the frame
+} GrTexPoolStats;
+
+FX_ENTRY void FX_CALL grTexPoolStatsExt(GrTexPoolStats *stats);
+FX_ENTRY FxBool FX_CALL grTexPoolFullExt(void);
+FX_ENTRY void FX_CALL grTexPoolTrimExt(void);
+
 //#define DISPLAY_WARNING_DEBUG
 
 #ifdef DISPLAY_WARNING_DEBUG
@@ -0,0 +1,158 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// Splits the cost of Combine() for a frame that cycles through a few
+// combine modes: the whole call, the cached list lookups (FindCombine), the
+// uncached binary searches (SearchCombine), the cc_/ac_ functions alone,
+// and copying a COMBINE the size of cmb, which is the least a cache of the
+// resolved state would have to do on a hit. Combine.c is included here to
+// reach its static lists.
+// Build and run from the glide2gl directory:
+//
+//   FLAGS="-O2 -D__LIBRETRO__ -DINLINE=inline -I../libretro -I../mupen64plus-core/src
+//          -I../mupen64plus-core/src/api -Isrc -Isrc/Glide64 -Isrc/Glitch64/inc"
+//   gcc $FLAGS -o combine_bench tools/combine_bench.c
+//   ./combine_bench [rounds]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/Glide64/Combine.c"
+
+// what glidemain.c, DListCache.c and Glitch64 would provide
+struct RDP rdp;
+SETTINGS settings;
+int dlist_cache_recording;
+void dlist_cache_abort(void) { }
+void dlist_cache_op(int op, const uint32_t *args, int count) { }
+#undef grChromakeyMode
+FX_ENTRY void FX_CALL grChromakeyMode(GrChromakeyMode_t mode) { }
+
+#define MODES 12   // distinct combine modes in the "frame"
+#define CALLS 400  // Combine() calls per frame
+
+static uint32_t cycle1[MODES], cycle2[MODES];
+static COMBINER *cc_entry[MODES], *ac_entry[MODES];
+static volatile uintptr_t sink;
+
+static double now(void)
+{
+   return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static void pick_modes(void)
+{
+   int cc_size = sizeof(color_cmb_list) / sizeof(COMBINER);
+   int ac_size = sizeof(alpha_cmb_list) / sizeof(COMBINER);
+   int i;
+
+   srand(64);
+   for (i = 0; i < MODES; i++)
+   {
+      uint32_t c = color_cmb_list[rand() % cc_size].key;
+      uint32_t a = alpha_cmb_list[rand() % ac_size].key;
+
+      // Combine() builds (cycle1 << 16) | (cycle2 & 0xFFFF) for color and
+      // (cycle1 & 0x0FFF0000) | ((cycle2 >> 16) & 0xFFF) for alpha
+      cycle1[i] = (c >> 16) | (a & 0x0FFF0000);
+      cycle2[i] = (c & 0xFFFF) | ((a & 0xFFF) << 16);
+      cc_entry[i] = SearchCombine(color_cmb_list, &cc_lookup[c >> 24], c);
+      ac_entry[i] = SearchCombine(alpha_cmb_list, &ac_lookup[(a >> 20) & 0xFF], a);
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   int rounds = argc > 1 ? atoi(argv[1]) : 2000;
+   double t[5], start;
+   COMBINE saved;
+   int r, i;
+
+   CountCombine();
+   settings.lodmode = 0;
+   rdp.cycle_mode = 1;
+   pick_modes();
+
+   // the whole call
+   start = now();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < CALLS; i++)
+      {
+         rdp.cycle1 = cycle1[i % MODES];
+         rdp.cycle2 = cycle2[i % MODES];
+         Combine();
+      }
+   t[0] = now() - start;
+
+   // the cached lookups alone
+   start = now();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < CALLS; i++)
+      {
+         uint32_t c = (cycle1[i % MODES] << 16) | (cycle2[i % MODES] & 0xFFFF);
+         uint32_t a = (cycle1[i % MODES] & 0x0FFF0000) | ((cycle2[i % MODES] >> 16) & 0xFFF);
+         sink += (uintptr_t)FindCombine(cc_cache, color_cmb_list, &cc_lookup[c >> 24], c);
+         sink += (uintptr_t)FindCombine(ac_cache, alpha_cmb_list, &ac_lookup[(a >> 20) & 0xFF], a);
+      }
+   t[1] = now() - start;
+
+   // the searches the lookup cache saves
+   start = now();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < CALLS; i++)
+      {
+         uint32_t c = (cycle1[i % MODES] << 16) | (cycle2[i % MODES] & 0xFFFF);
+         uint32_t a = (cycle1[i % MODES] & 0x0FFF0000) | ((cycle2[i % MODES] >> 16) & 0xFFF);
+         sink += (uintptr_t)SearchCombine(color_cmb_list, &cc_lookup[c >> 24], c);
+         sink += (uintptr_t)SearchCombine(alpha_cmb_list, &ac_lookup[(a >> 20) & 0xFF], a);
+      }
+   t[2] = now() - start;
+
+   // the cc_/ac_ functions a resolved state cache would skip
+   start = now();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < CALLS; i++)
+      {
+         rdp.cycle1 = cycle1[i % MODES];
+         rdp.cycle2 = cycle2[i % MODES];
+         if (cc_entry[i % MODES]) cc_entry[i % MODES]->func();
+         if (ac_entry[i % MODES]) ac_entry[i % MODES]->func();
+      }
+   t[3] = now() - start;
+
+   // restoring such a state, at least cmb itself
+   start = now();
+   for (r = 0; r < rounds; r++)
+      for (i = 0; i < CALLS; i++)
+      {
+         memcpy(&saved, &cmb, sizeof(cmb));
+         sink += saved.c_fnc;
+      }
+   t[4] = now() - start;
+
+   printf("%d modes, %d calls per frame, ns per call:\n", MODES, CALLS);
+   printf("  Combine()             %6.1f\n", t[0] * 1e9 / ((double)rounds * CALLS));
+   printf("  FindCombine (cached)  %6.1f\n", t[1] * 1e9 / ((double)rounds * CALLS));
+   printf("  SearchCombine         %6.1f\n", t[2] * 1e9 / ((double)rounds * CALLS));
+   printf("  cc_/ac_ functions     %6.1f\n", t[3] * 1e9 / ((double)rounds * CALLS));
+   printf("  copy of cmb (%d B)   %6.1f\n", (int)sizeof(cmb), t[4] * 1e9 / ((double)rounds * CALLS));
+   printf("lookup cache: %u hits, %u misses\n", combine_cache_hits, combine_cache_misses);
+   return 0;
+}
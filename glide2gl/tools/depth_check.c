@@ -0,0 +1,169 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// Queues random polygons with random scissors into the software depth
+// renderer of DepthBufferRender.c and flushes them once on the calling
+// thread alone and once split in MAX_DEPTH_BANDS bands on the worker pool,
+// then checks that both depth images are the same to the bit and times
+// them. The renderer is included here so its band count can be forced.
+// Build and run from the glide2gl directory:
+//
+//   FLAGS="-O2 -D__LIBRETRO__ -DINLINE=inline -I../libretro -I../mupen64plus-core/src
+//          -I../mupen64plus-core/src/api -Isrc -Isrc/Glide64 -Isrc/Glitch64/inc"
+//   gcc $FLAGS -o depth_check tools/depth_check.c ../mupen64plus-core/src/osal/thread.c -lpthread -lm
+//   ./depth_check [rounds]
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/Glide64/DepthBufferRender.c"
+
+// what glidemain.c and DListCache.c would provide
+GFX_INFO gfx;
+struct RDP rdp;
+int dlist_cache_recording;
+void dlist_cache_write_range(uint32_t addr, uint32_t size, int overwrite) { }
+
+#define ZI_WIDTH  640
+#define ZI_HEIGHT 480
+#define ZIMG      0x100000
+#define POLYS     400
+
+static uint8_t rdram[0x400000];
+static int unsplit;   // rounds too small to be split in bands
+
+static int irand(int lo, int hi)
+{
+   return lo + rand() % (hi - lo + 1);
+}
+
+// Fills the queue with the same polygons for a given seed
+static void queue_polys(unsigned int seed)
+{
+   int i, n;
+
+   srand(seed);
+   for (i = 0; i < POLYS; i++)
+   {
+      struct vertexi vtx[12];
+      int vertices = irand(3, 8);
+      int cx = irand(-64, ZI_WIDTH + 64), cy = irand(-64, ZI_HEIGHT + 64);
+      int radius = irand(2, 200);
+      int z = irand(0, 0x7FFF) << 16;
+      int dir = (rand() & 1) ? 1 : -1;
+
+      // a convex polygon around (cx, cy), in either winding
+      for (n = 0; n < vertices; n++)
+      {
+         double a = dir * (n + rand() / (double)RAND_MAX * 0.9) * 6.2831853 / vertices;
+         vtx[n].x = (int)((cx + radius * cos(a)) * 65536.0);
+         vtx[n].y = (int)((cy + radius * sin(a)) * 65536.0);
+         vtx[n].z = z + irand(-0x100000, 0x100000);
+      }
+
+      rdp.scissor_o.ul_x = irand(0, ZI_WIDTH / 4);
+      rdp.scissor_o.ul_y = irand(0, ZI_HEIGHT / 4);
+      rdp.scissor_o.lr_x = irand(ZI_WIDTH * 3 / 4, ZI_WIDTH);
+      rdp.scissor_o.lr_y = irand(ZI_HEIGHT * 3 / 4, ZI_HEIGHT);
+      Rasterize(vtx, vertices, irand(-0x40000, 0x40000));
+   }
+}
+
+static void clear_depth(unsigned int seed)
+{
+   uint16_t *z = (uint16_t*)(rdram + ZIMG);
+   int i;
+
+   srand(seed);
+   for (i = 0; i < ZI_WIDTH * ZI_HEIGHT; i++)
+      z[i] = (rand() & 1) ? 0xFFFC : (uint16_t)(rand() & 0xFFFC);
+}
+
+static double now(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// Renders one seed with the given number of bands, returns the seconds
+// spent in RasterizeFlush
+static double render(unsigned int seed, int bands, osal_pool *pool)
+{
+   double start;
+
+   clear_depth(seed);
+   queue_polys(seed);
+   if (bands > 1 && depth_queue_pixels < DEPTH_BAND_MIN_PIXELS)
+      unsplit++;
+   depth_bands = bands;
+   depth_pool = pool;
+   start = now();
+   RasterizeFlush();
+   return now() - start;
+}
+
+int main(int argc, char *argv[])
+{
+   static uint16_t golden[ZI_WIDTH * ZI_HEIGHT];
+   int rounds = argc > 1 ? atoi(argv[1]) : 200;
+   double seconds[2] = { 0, 0 };
+   osal_pool *pool;
+   int r, i, bad = 0;
+
+   gfx.RDRAM = rdram;
+   rdp.zimg = ZIMG;
+   rdp.zi_width = ZI_WIDTH;
+   ZLUT_init();
+
+   pool = osal_pool_create(MAX_DEPTH_BANDS - 1);
+   if (pool == NULL)
+   {
+      printf("could not start the worker pool\n");
+      return 1;
+   }
+
+   for (r = 0; r < rounds; r++)
+   {
+      const uint16_t *z = (const uint16_t*)(rdram + ZIMG);
+
+      seconds[0] += render(r, 1, NULL);
+      memcpy(golden, z, sizeof(golden));
+      seconds[1] += render(r, MAX_DEPTH_BANDS, pool);
+
+      for (i = 0; i < ZI_WIDTH * ZI_HEIGHT; i++)
+      {
+         if (z[i] != golden[i] && bad++ < 16)
+            printf("round %d: depth at %d,%d is %04x, not %04x\n",
+                  r, (i ^ 1) % ZI_WIDTH, (i ^ 1) / ZI_WIDTH, z[i], golden[i]);
+      }
+   }
+
+   depth_bands = 0;
+   depth_pool = 0;
+   osal_pool_destroy(pool);
+   ZLUT_release();
+
+   printf("%d rounds of %d polygons (%d too small to split): 1 band %.3f s, %d bands %.3f s, %s\n",
+         rounds, POLYS, unsplit, seconds[0], MAX_DEPTH_BANDS, seconds[1],
+         bad ? "MISMATCH" : "identical");
+   return bad != 0;
+}
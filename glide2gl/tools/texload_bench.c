@@ -0,0 +1,249 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// Checks the SSE2/NEON paths of the texture loaders (TexLoad*.h), the
+// converters (TexConv.h) and the TMEM copies used by loadBlock/loadTile
+// (TexLoadSIMD.h) against the scalar loops, one format at a time with
+// random TMEM, palettes and tile sizes, then reports MB/s for each. The
+// file is built twice, the scalar copy with TEXLOAD_NO_SIMD.
+// Build and run from the glide2gl directory:
+//
+//   FLAGS="-O2 -D__LIBRETRO__ -DINLINE=inline -I../libretro -I../mupen64plus-core/src
+//          -I../mupen64plus-core/src/api -Isrc -Isrc/Glide64 -Isrc/Glitch64/inc"
+//   gcc $FLAGS -DTEXLOAD_NO_SIMD -c -o texload_ref.o tools/texload_bench.c
+//   gcc $FLAGS -o texload_bench tools/texload_bench.c texload_ref.o
+//   ./texload_bench [rounds]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef TEXLOAD_NO_SIMD
+// the scalar copy gets its own names for everything TexLoad.h exports
+#define LoadNone       scalar_LoadNone
+#define load_table     scalar_load_table
+#define Load4bCI       scalar_Load4bCI
+#define Load4bIA       scalar_Load4bIA
+#define Load4bI        scalar_Load4bI
+#define Load4bSelect   scalar_Load4bSelect
+#define Load8bCI       scalar_Load8bCI
+#define Load8bIA       scalar_Load8bIA
+#define Load8bI        scalar_Load8bI
+#define Load16bRGBA    scalar_Load16bRGBA
+#define Load16bIA      scalar_Load16bIA
+#define Load16bYUV     scalar_Load16bYUV
+#define yuv_to_rgb565  scalar_yuv_to_rgb565
+#define Load32bRGBA    scalar_Load32bRGBA
+#define LoadTile32b    scalar_LoadTile32b
+#define LoadBlock32b   scalar_LoadBlock32b
+#define texload_run    texload_run_scalar
+#endif
+
+#include "Gfx_1.3.h"
+#include "Combine.h"
+#include "Util.h"
+#include "TexLoad.h"
+#include "TexConv.h"
+
+enum
+{
+   RUN_LOAD,         // load_table[a][b]
+   RUN_BSWAP,        // loadBlock/loadTile copy, a qwords
+   RUN_SWAP,         // odd line interleave, a qwords
+   RUN_CONV,         // TexConv_*, a selects the converter, b texels
+   RUN_TILE32,       // LoadTile32b, a x b texels
+   RUN_BLOCK32       // LoadBlock32b, a texels, dxt b
+};
+
+uint32_t texload_run(int what, int a, int b, uint8_t *dst, uint8_t *src, int line, int real_width)
+{
+   switch (what)
+   {
+      case RUN_LOAD:
+         return load_table[a][b]((uintptr_t)dst, (uintptr_t)src, 8, 32, line, real_width, 0);
+      case RUN_BSWAP:
+         tmem_bswap_qwords((uint32_t *)dst, (const uint32_t *)src, a);
+         break;
+      case RUN_SWAP:
+         tmem_swap_words((uint32_t *)dst, a);
+         break;
+      case RUN_CONV:
+         if (a == 0)
+            TexConv_ARGB1555_ARGB4444(src, dst, b, 1);
+         else if (a == 1)
+            TexConv_AI88_ARGB4444(src, dst, b, 1);
+         else
+            TexConv_A8_ARGB4444(src, dst, b, 1);
+         break;
+      case RUN_TILE32:
+         LoadTile32b(0, 0, 0, a, b);
+         break;
+      case RUN_BLOCK32:
+         LoadBlock32b(0, 0, 0, a - 1, b);
+         break;
+   }
+   return 0;
+}
+
+#ifndef TEXLOAD_NO_SIMD
+uint32_t texload_run_scalar(int what, int a, int b, uint8_t *dst, uint8_t *src, int line, int real_width);
+
+// The parts of the plugin state the loaders use
+GFX_INFO gfx;
+struct RDP rdp;
+COMBINE cmb;
+int dlist_cache_recording;
+void dlist_cache_read_range(uint32_t addr, uint32_t size) { }
+
+static uint8_t bench_rdram[0x100000];
+
+typedef struct
+{
+   const char *name;
+   int what, a, b;
+   int tlut_mode, mod;
+   int bytes;        // source bytes per run, for MB/s
+} FORMAT;
+
+// 8 qwords x 32 lines of TMEM for the loaders, 2KB
+static const FORMAT formats[] =
+{
+   { "4b CI",        RUN_LOAD, 0, 2, 2, 0, 2048 },
+   { "4b IA",        RUN_LOAD, 0, 3, 0, 0, 2048 },
+   { "4b I",         RUN_LOAD, 0, 4, 0, 0, 2048 },
+   { "8b CI",        RUN_LOAD, 1, 2, 2, 0, 2048 },
+   { "8b IA pal",    RUN_LOAD, 1, 2, 1, 0, 2048 },
+   { "8b IA",        RUN_LOAD, 1, 3, 0, 0, 2048 },
+   { "8b I",         RUN_LOAD, 1, 4, 0, 0, 2048 },
+   { "16b RGBA",     RUN_LOAD, 2, 0, 0, 0, 2048 },
+   { "16b IA",       RUN_LOAD, 2, 3, 0, 0, 2048 },
+   { "32b RGBA",     RUN_LOAD, 3, 0, 0, 0, 2048 },
+   { "32b to 4444",  RUN_LOAD, 3, 0, 0, 1, 2048 },
+   { "tmem bswap",   RUN_BSWAP, 512, 0, 0, 0, 4096 },
+   { "tmem swap",    RUN_SWAP, 512, 0, 0, 0, 4096 },
+   { "1555 to 4444", RUN_CONV, 0, 2048, 0, 0, 4096 },
+   { "AI88 to 4444", RUN_CONV, 1, 2048, 0, 0, 4096 },
+   { "A8 to 4444",   RUN_CONV, 2, 4096, 0, 0, 4096 },
+   { "LoadTile32b",  RUN_TILE32, 32, 16, 0, 0, 2048 },
+   { "LoadBlock32b", RUN_BLOCK32, 512, 0, 0, 0, 2048 },
+};
+
+#define FORMATS (sizeof(formats) / sizeof(formats[0]))
+
+static void setup(const FORMAT *f)
+{
+   int i;
+   for (i = 0; i < 4096; i++)
+      rdp.tmem[i] = rand();
+   for (i = 0; i < 256; i++)
+      rdp.pal_8[i] = rand();
+   rdp.tlut_mode = f->tlut_mode;
+   rdp.cur_tile = 0;
+   cmb.mod_0 = f->mod;
+   rdp.tiles[0].t_mem = rand() % 256;
+   rdp.tiles[0].line = rand() % 64;
+   rdp.timg.addr = (rand() % 0x10000) << 2;
+   rdp.timg.width = 32 + rand() % 320;
+}
+
+int main(int argc, char *argv[])
+{
+   static uint8_t ref[128 * 1024], simd[128 * 1024], tmem_before[4096], tmem_after[4096];
+   static uint8_t src[8192 + 16];
+   int rounds = (argc > 1) ? atoi(argv[1]) : 20000;
+   unsigned f;
+   int r, i, bad = 0;
+
+   gfx.RDRAM = bench_rdram;
+   for (i = 0; i < (int)sizeof(bench_rdram); i++)
+      bench_rdram[i] = rand();
+
+   printf("%-14s %12s %12s\n", "format", "scalar MB/s", "simd MB/s");
+   for (f = 0; f < FORMATS; f++)
+   {
+      const FORMAT *fmt = &formats[f];
+      double seconds[2];
+      int pass;
+
+      // exactness: odd counts and unaligned TMEM offsets for the tails
+      for (r = 0; r < 512; r++)
+      {
+         int a = fmt->a, b = fmt->b;
+         int line = (rand() % 16) << 3;
+         int off = (fmt->what == RUN_LOAD) ? (rand() % 256) << 3 : rand() & 15;
+         int real_width = 8 * (16 >> fmt->a);
+
+         setup(fmt);
+         for (i = 0; i < (int)sizeof(src); i++)
+            src[i] = rand();
+         if (fmt->what == RUN_BSWAP || fmt->what == RUN_SWAP)
+            a = 1 + rand() % fmt->a;
+         else if (fmt->what == RUN_CONV)
+            b = (1 + rand() % (fmt->b / 4)) * 4;
+         else if (fmt->what == RUN_TILE32)
+            a = rand() % 64, b = 1 + rand() % 32;
+         else if (fmt->what == RUN_BLOCK32)
+            a = 1 + rand() % fmt->a, b = (rand() & 1) ? rand() % 2048 : 0;
+
+         // the 32-bit TMEM loads write rdp.tmem, run both from the same state
+         memcpy(tmem_before, rdp.tmem, sizeof(tmem_before));
+         memset(ref, 0xAA, sizeof(ref));
+         memcpy(ref, src, sizeof(src));
+         texload_run_scalar(fmt->what, a, b, ref, fmt->what == RUN_LOAD ? rdp.tmem + off : src + off, line, real_width);
+         memcpy(tmem_after, rdp.tmem, sizeof(tmem_after));
+         memcpy(rdp.tmem, tmem_before, sizeof(tmem_before));
+
+         memset(simd, 0xAA, sizeof(simd));
+         memcpy(simd, src, sizeof(src));
+         texload_run(fmt->what, a, b, simd, fmt->what == RUN_LOAD ? rdp.tmem + off : src + off, line, real_width);
+         if (memcmp(ref, simd, sizeof(ref)) || memcmp(tmem_after, rdp.tmem, sizeof(tmem_after)))
+         {
+            printf("%s: mismatch (a %d b %d line %d offset %d)\n", fmt->name, a, b, line, off);
+            bad++;
+            break;
+         }
+      }
+
+      setup(fmt);
+      for (pass = 0; pass < 2; pass++)
+      {
+         clock_t start = clock();
+         for (r = 0; r < rounds; r++)
+         {
+            uint8_t *from = fmt->what == RUN_LOAD ? rdp.tmem : src;
+            if (pass)
+               texload_run(fmt->what, fmt->a, fmt->b, simd, from, 0, 8 * (16 >> fmt->a));
+            else
+               texload_run_scalar(fmt->what, fmt->a, fmt->b, simd, from, 0, 8 * (16 >> fmt->a));
+         }
+         seconds[pass] = (double)(clock() - start) / CLOCKS_PER_SEC;
+      }
+      printf("%-14s %12.0f %12.0f\n", fmt->name,
+            seconds[0] > 0 ? (double)fmt->bytes * rounds / seconds[0] / 1e6 : 0.0,
+            seconds[1] > 0 ? (double)fmt->bytes * rounds / seconds[1] / 1e6 : 0.0);
+   }
+
+   if (bad)
+   {
+      printf("MISMATCH in %d formats\n", bad);
+      return 1;
+   }
+   return 0;
+}
+#endif
@@ -0,0 +1,202 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// Runs every texture modifier of TexMod.h and every palette modifier of
+// TexModCI.h with the SSE2 paths and with the plain scalar loops, checks
+// that both give the same texels for random textures and colors, and
+// times them. The file is built twice, the scalar copy with TEXMOD_NO_SIMD.
+// Build and run from the glide2gl directory:
+//
+//   gcc -O2 -Isrc/Glide64 -Isrc/Glitch64/inc -DTEXMOD_NO_SIMD -c -o texmod_ref.o tools/texmod_bench.c
+//   gcc -O2 -Isrc/Glide64 -Isrc/Glitch64/inc -o texmod_bench tools/texmod_bench.c texmod_ref.o
+//   ./texmod_bench [rounds]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define INLINE inline
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+
+// The parts of the rdp state the palette modifiers use
+static struct
+{
+   uint16_t pal_8[256];
+} rdp;
+
+#include <glide.h>
+#include "Combine.h"
+#include "TexMod.h"
+#include "TexModCI.h"
+
+#ifdef TEXMOD_NO_SIMD
+#define texmod_run    texmod_run_scalar
+#define texmod_run_ci texmod_run_ci_scalar
+#endif
+
+void texmod_run(int mod, uint16_t *dst, int size, uint32_t c0, uint32_t c1, uint32_t c2, uint32_t factor)
+{
+   switch (mod)
+   {
+      case TMOD_TEX_INTER_COLOR_USING_FACTOR: mod_tex_inter_color_using_factor (dst, size, c0, factor); break;
+      case TMOD_TEX_INTER_COL_USING_COL1: mod_tex_inter_col_using_col1 (dst, size, c0, c1); break;
+      case TMOD_FULL_COLOR_SUB_TEX: mod_full_color_sub_tex (dst, size, c0); break;
+      case TMOD_COL_INTER_COL1_USING_TEX: mod_col_inter_col1_using_tex (dst, size, c0, c1); break;
+      case TMOD_COL_INTER_COL1_USING_TEXA: mod_col_inter_col1_using_texa (dst, size, c0, c1); break;
+      case TMOD_COL_INTER_COL1_USING_TEXA__MUL_TEX: mod_col_inter_col1_using_texa__mul_tex (dst, size, c0, c1); break;
+      case TMOD_COL_INTER_TEX_USING_TEXA: mod_col_inter_tex_using_texa (dst, size, c0); break;
+      case TMOD_COL2_INTER__COL_INTER_COL1_USING_TEX__USING_TEXA: mod_col2_inter__col_inter_col1_using_tex__using_texa (dst, size, c0, c1, c2); break;
+      case TMOD_TEX_SCALE_FAC_ADD_FAC: mod_tex_scale_fac_add_fac (dst, size, factor); break;
+      case TMOD_TEX_SUB_COL_MUL_FAC_ADD_TEX: mod_tex_sub_col_mul_fac_add_tex (dst, size, c0, factor); break;
+      case TMOD_TEX_SCALE_COL_ADD_COL: mod_tex_scale_col_add_col (dst, size, c0, c1); break;
+      case TMOD_TEX_ADD_COL: mod_tex_add_col (dst, size, c0); break;
+      case TMOD_TEX_SUB_COL: mod_tex_sub_col (dst, size, c0); break;
+      case TMOD_TEX_SUB_COL_MUL_FAC: mod_tex_sub_col_mul_fac (dst, size, c0, factor); break;
+      case TMOD_COL_INTER_TEX_USING_COL1: mod_col_inter_tex_using_col1 (dst, size, c0, c1); break;
+      case TMOD_COL_MUL_TEXA_ADD_TEX: mod_col_mul_texa_add_tex (dst, size, c0); break;
+      case TMOD_COL_INTER_TEX_USING_TEX: mod_col_inter_tex_using_tex (dst, size, c0); break;
+      case TMOD_TEX_INTER_NOISE_USING_COL: mod_tex_inter_noise_using_col (dst, size, c0); break;
+      case TMOD_TEX_INTER_COL_USING_TEXA: mod_tex_inter_col_using_texa (dst, size, c0); break;
+      case TMOD_TEX_MUL_COL: mod_tex_mul_col (dst, size, c0); break;
+      case TMOD_TEX_SCALE_FAC_ADD_COL: mod_tex_scale_fac_add_col (dst, size, c0, factor); break;
+   }
+}
+
+void texmod_run_ci(int mod, uint16_t *pal, uint32_t c0, uint32_t c1, uint32_t factor)
+{
+   memcpy(rdp.pal_8, pal, sizeof(rdp.pal_8));
+   ModifyPalette(mod, c0, c1, factor);
+   memcpy(pal, rdp.pal_8, sizeof(rdp.pal_8));
+}
+
+#ifndef TEXMOD_NO_SIMD
+void texmod_run_scalar(int mod, uint16_t *dst, int size, uint32_t c0, uint32_t c1, uint32_t c2, uint32_t factor);
+void texmod_run_ci_scalar(int mod, uint16_t *pal, uint32_t c0, uint32_t c1, uint32_t factor);
+
+#define TEX_SIZE (64 * 64)
+#define MODES 21
+#define CI_ROUNDS 64
+
+static uint32_t random_color(void)
+{
+   // mostly random, with the saturating corners now and then
+   switch (rand() & 7)
+   {
+      case 0: return 0;
+      case 1: return 0xFFFFFFFF;
+      default: return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   static uint16_t src[TEX_SIZE + 3], ref[TEX_SIZE + 3], simd[TEX_SIZE + 3];
+   static uint16_t pal[256], pal_ref[256], pal_simd[256];
+   int rounds = (argc > 1) ? atoi(argv[1]) : 2000;
+   int mod, r, i, bad = 0;
+   double total[2] = { 0, 0 }, total_ci[2] = { 0, 0 };
+
+   printf("%-8s %12s %12s %12s %12s\n", "mode", "scalar ns", "sse2 ns", "CI scalar", "CI sse2");
+   for (mod = 1; mod <= MODES; mod++)
+   {
+      uint32_t c0, c1, c2, factor;
+      double ns[2], ns_ci[2];
+      clock_t start;
+      int pass;
+
+      // exactness: many random colors, odd sizes for the scalar tails
+      for (r = 0; r < 256; r++)
+      {
+         int size = TEX_SIZE - (r & 3);
+         unsigned seed = rand();
+         for (i = 0; i < TEX_SIZE; i++)
+            src[i] = rand();
+         for (i = 0; i < 256; i++)
+            pal[i] = rand();
+         c0 = random_color(); c1 = random_color(); c2 = random_color(); factor = rand() & 0xFF;
+
+         memcpy(ref, src, sizeof(src));
+         memcpy(simd, src, sizeof(src));
+         // the noise mode draws from rand(), give both the same sequence
+         srand(seed);
+         texmod_run_scalar(mod, ref, size, c0, c1, c2, factor);
+         srand(seed);
+         texmod_run(mod, simd, size, c0, c1, c2, factor);
+         if (memcmp(ref, simd, sizeof(src)))
+         {
+            printf("mode %d: texture mismatch (colors %08x %08x %08x factor %u)\n", mod, c0, c1, c2, factor);
+            bad++;
+            break;
+         }
+
+         memcpy(pal_ref, pal, sizeof(pal));
+         memcpy(pal_simd, pal, sizeof(pal));
+         texmod_run_ci_scalar(mod, pal_ref, c0, c1, factor);
+         texmod_run_ci(mod, pal_simd, c0, c1, factor);
+         if (memcmp(pal_ref, pal_simd, sizeof(pal)))
+         {
+            printf("mode %d: palette mismatch (colors %08x %08x factor %u)\n", mod, c0, c1, factor);
+            bad++;
+            break;
+         }
+      }
+
+      c0 = 0x80604020; c1 = 0x20406080; c2 = 0x10305070; factor = 0x60;
+      for (pass = 0; pass < 2; pass++)
+      {
+         start = clock();
+         for (r = 0; r < rounds; r++)
+         {
+            memcpy(simd, src, sizeof(src));
+            if (pass)
+               texmod_run(mod, simd, TEX_SIZE, c0, c1, c2, factor);
+            else
+               texmod_run_scalar(mod, simd, TEX_SIZE, c0, c1, c2, factor);
+         }
+         ns[pass] = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / rounds;
+         total[pass] += ns[pass];
+
+         start = clock();
+         for (r = 0; r < rounds * CI_ROUNDS; r++)
+         {
+            if (pass)
+               texmod_run_ci(mod, pal, c0, c1, factor);
+            else
+               texmod_run_ci_scalar(mod, pal, c0, c1, factor);
+         }
+         ns_ci[pass] = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / (rounds * CI_ROUNDS);
+         total_ci[pass] += ns_ci[pass];
+      }
+      printf("%-8d %12.0f %12.0f %12.0f %12.0f\n", mod, ns[0], ns[1], ns_ci[0], ns_ci[1]);
+   }
+
+   printf("all modes, %d texels: scalar %.0f ns, sse2 %.0f ns (%.1f%%)\n", TEX_SIZE, total[0], total[1],
+         total[0] > 0 ? 100.0 * total[1] / total[0] : 100.0);
+   printf("all modes, 256 colors: scalar %.0f ns, sse2 %.0f ns (%.1f%%)\n", total_ci[0], total_ci[1],
+         total_ci[0] > 0 ? 100.0 * total_ci[1] / total_ci[0] : 100.0);
+   if (bad)
+   {
+      printf("MISMATCH in %d modes\n", bad);
+      return 1;
+   }
+   return 0;
+}
+#endif
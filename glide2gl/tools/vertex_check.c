@@ -0,0 +1,245 @@
+/*
+* Glide64 - Glide video plugin for Nintendo 64 emulators.
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+// Checks the SSE2 (x86) or NEON (ARM) vertex kernels of 3dmath.c against
+// the scalar ones: LoadVertices from random RDRAM at aligned and halfword
+// addresses, TransformVertices with random matrices, billboard origins and
+// fog/clip flags, and LightVertices with 0 to 7 lights, for every batch
+// size up to 67 so all the n & 3 tails are covered. Then times both sets.
+// vertex_kernels_match() in 3dmath.c only checks one batch at startup.
+// 3dmath.c is included here to reach its static kernels.
+// Build and run from the glide2gl directory:
+//
+//   FLAGS="-O2 -D__LIBRETRO__ -DINLINE=inline -I../libretro -I../mupen64plus-core/src
+//          -I../mupen64plus-core/src/api -Isrc -Isrc/Glide64 -Isrc/Glitch64/inc"
+//   gcc $FLAGS -o vertex_check tools/vertex_check.c -lm
+//   ./vertex_check [rounds]
+//
+// On ARM add -DNOSSE -DHAVE_NEON -mfpu=neon.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/Glide64/3dmath.c"
+
+// what glidemain.c and libretro.c would provide
+GFX_INFO gfx;
+struct RDP rdp;
+SETTINGS settings;
+retro_log_printf_t log_cb;
+retro_get_cpu_features_t perf_get_cpu_features_cb;
+
+#if !defined(NOSSE)
+#define SIMD_NAME "SSE2"
+#define SimdLoadVertices      LoadVerticesSSE2
+#define SimdTransformVertices TransformVerticesSSE
+#define SimdLightVertices     LightVerticesSSE
+#elif defined(HAVE_NEON)
+#define SIMD_NAME "NEON"
+#define SimdLoadVertices      LoadVerticesNeon
+#define SimdTransformVertices TransformVerticesNeon
+#define SimdLightVertices     LightVerticesNeon
+#else
+#error "no SIMD vertex kernels for this target"
+#endif
+
+#define MAX_BATCH 67
+#define TIME_BATCH 64
+#define TIME_ROUNDS 20000
+
+static uint8_t rdram[0x10000];
+static int bad;
+
+static float frand(float lo, float hi)
+{
+   return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+static void check(const char *what, int n, int i, double got, double want)
+{
+   if (!close_enough((float)got, (float)want) && bad++ < 16)
+      printf("%s: vertex %d of %d is %.9g, not %.9g\n", what, i, n, got, want);
+}
+
+static void check_int(const char *what, int n, int i, int got, int want, int slack)
+{
+   if (abs(got - want) > slack && bad++ < 16)
+      printf("%s: vertex %d of %d is %d, not %d\n", what, i, n, got, want);
+}
+
+static void random_scene(float mat[4][4])
+{
+   int i, j;
+
+   for (i = 0; i < 4; i++)
+      for (j = 0; j < 4; j++)
+         mat[i][j] = frand(-1.5f, 1.5f);
+   for (j = 0; j < 4; j++)
+      mat[3][j] = frand(-400.0f, 400.0f);
+
+   rdp.flags = (rand() & 1) ? FOG_ENABLED : 0;
+   rdp.fog_multiplier = frand(-256.0f, 256.0f);
+   rdp.fog_offset = frand(-128.0f, 128.0f);
+   rdp.num_lights = rand() % 8;
+   for (i = 0; i <= (int)rdp.num_lights; i++)
+   {
+      float x = frand(-1, 1), y = frand(-1, 1), z = frand(-1, 1);
+      float len = sqrtf(x*x + y*y + z*z) + 1e-6f;
+      rdp.light[i].r = frand(0, 1);
+      rdp.light[i].g = frand(0, 1);
+      rdp.light[i].b = frand(0, 1);
+      rdp.light_vector[i][0] = x / len;
+      rdp.light_vector[i][1] = y / len;
+      rdp.light_vector[i][2] = z / len;
+   }
+}
+
+static void check_batch(int n)
+{
+   static VERTEX_BATCH simd_batch, ref_batch;
+   static VERTEX simd[MAX_BATCH], ref[MAX_BATCH];
+   float mat[4][4];
+   VERTEX origin;
+   uint32_t addr = (rand() % 0x800) * 2;
+   uint32_t flags = rand() & (VTX_FOG | VTX_CLIP_Z);
+   int lit = rand() & 1, billboard = !(rand() & 3);
+   int i;
+
+   for (i = 0; i < (int)sizeof(rdram); i++)
+      rdram[i] = rand();
+   random_scene(mat);
+   memset(&origin, 0, sizeof(origin));
+   origin.x = frand(-100, 100);
+   origin.y = frand(-100, 100);
+   origin.z = frand(-100, 100);
+   origin.w = frand(-100, 100);
+   memset(simd, 0, sizeof(simd));
+   memset(ref, 0, sizeof(ref));
+
+   SimdLoadVertices(simd, &simd_batch, addr, n, lit);
+   LoadVerticesC(ref, &ref_batch, addr, n, lit);
+   for (i = 0; i < n; i++)
+   {
+      check("load x", n, i, simd_batch.x[i], ref_batch.x[i]);
+      check("load y", n, i, simd_batch.y[i], ref_batch.y[i]);
+      check("load z", n, i, simd_batch.z[i], ref_batch.z[i]);
+      check("load ou", n, i, simd[i].ou, ref[i].ou);
+      check("load ov", n, i, simd[i].ov, ref[i].ov);
+      check_int("load flags", n, i, simd[i].flags, ref[i].flags, 0);
+      check_int("load a", n, i, simd[i].a, ref[i].a, 0);
+      if (lit)
+      {
+         check("load nx", n, i, simd[i].vec[0], ref[i].vec[0]);
+         check("load ny", n, i, simd[i].vec[1], ref[i].vec[1]);
+         check("load nz", n, i, simd[i].vec[2], ref[i].vec[2]);
+      }
+      else
+      {
+         check_int("load r", n, i, simd[i].r, ref[i].r, 0);
+         check_int("load g", n, i, simd[i].g, ref[i].g, 0);
+         check_int("load b", n, i, simd[i].b, ref[i].b, 0);
+      }
+   }
+
+   // the rest runs on the same input, whatever the loaders did
+   memcpy(simd, ref, sizeof(simd));
+   SimdTransformVertices(simd, &ref_batch, n, mat, billboard ? &origin : NULL, flags);
+   TransformVerticesC(ref, &ref_batch, n, mat, billboard ? &origin : NULL, flags);
+   if (lit)
+   {
+      SimdLightVertices(simd, n);
+      LightVerticesC(ref, n);
+   }
+   for (i = 0; i < n; i++)
+   {
+      check("x", n, i, simd[i].x, ref[i].x);
+      check("y", n, i, simd[i].y, ref[i].y);
+      check("z", n, i, simd[i].z, ref[i].z);
+      check("w", n, i, simd[i].w, ref[i].w);
+      check("oow", n, i, simd[i].oow, ref[i].oow);
+      check("x_w", n, i, simd[i].x_w, ref[i].x_w);
+      check("y_w", n, i, simd[i].y_w, ref[i].y_w);
+      check("z_w", n, i, simd[i].z_w, ref[i].z_w);
+      if (flags & VTX_FOG)
+      {
+         check("fog", n, i, simd[i].f, ref[i].f);
+         check_int("fog alpha", n, i, simd[i].a, ref[i].a, 1);
+      }
+      check_int("scr_off", n, i, simd[i].scr_off, ref[i].scr_off, 0);
+      check_int("uv_calculated", n, i, simd[i].uv_calculated, ref[i].uv_calculated, 0);
+      if (lit)
+      {
+         check("normal x", n, i, simd[i].vec[0], ref[i].vec[0]);
+         check("normal y", n, i, simd[i].vec[1], ref[i].vec[1]);
+         check("normal z", n, i, simd[i].vec[2], ref[i].vec[2]);
+         check_int("light r", n, i, simd[i].r, ref[i].r, 1);
+         check_int("light g", n, i, simd[i].g, ref[i].g, 1);
+         check_int("light b", n, i, simd[i].b, ref[i].b, 1);
+      }
+   }
+}
+
+static double time_kernels(LOADVERTICES load, TRANSFORMVERTICES transform, LIGHTVERTICES light)
+{
+   static VERTEX_BATCH batch;
+   static VERTEX v[TIME_BATCH];
+   float mat[4][4];
+   clock_t start;
+   int r;
+
+   srand(1);
+   for (r = 0; r < (int)sizeof(rdram); r++)
+      rdram[r] = rand();
+   random_scene(mat);
+   rdp.flags = FOG_ENABLED;
+   rdp.num_lights = 2;
+
+   start = clock();
+   for (r = 0; r < TIME_ROUNDS; r++)
+   {
+      load(v, &batch, (r & 0xFF) << 4, TIME_BATCH, 1);
+      transform(v, &batch, TIME_BATCH, mat, NULL, VTX_FOG);
+      light(v, TIME_BATCH);
+   }
+   return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+   int rounds = argc > 1 ? atoi(argv[1]) : 200;
+   double simd_time, c_time;
+   int r, n;
+
+   gfx.RDRAM = rdram;
+   srand(64);
+   for (r = 0; r < rounds; r++)
+      for (n = 1; n <= MAX_BATCH; n++)
+         check_batch(n);
+
+   c_time = time_kernels(LoadVerticesC, TransformVerticesC, LightVerticesC);
+   simd_time = time_kernels(SimdLoadVertices, SimdTransformVertices, SimdLightVertices);
+
+   printf("%d rounds of batches of 1 to %d vertices: %s\n", rounds, MAX_BATCH,
+         bad ? "MISMATCH" : "all within tolerance");
+   printf("load+transform+light of %d lit vertices: C %.1f ns, %s %.1f ns per vertex\n",
+         TIME_BATCH, c_time * 1e9 / (TIME_ROUNDS * TIME_BATCH),
+         SIMD_NAME, simd_time * 1e9 / (TIME_ROUNDS * TIME_BATCH));
+   return bad != 0;
+}
@@ -24,6 +24,8 @@ PFNGLENABLEVERTEXATTRIBARRAYPROC pglEnableVertexAttribArray;
 PFNGLDISABLEVERTEXATTRIBARRAYPROC pglDisableVertexAttribArray;
 PFNGLGENBUFFERSPROC pglGenBuffers;
 PFNGLBUFFERDATAPROC pglBufferData;
+PFNGLBUFFERSUBDATAPROC pglBufferSubData;
+PFNGLDELETEBUFFERSPROC pglDeleteBuffers;
 PFNGLBINDBUFFERPROC pglBindBuffer;
 PFNGLMAPBUFFERRANGEPROC pglMapBufferRange;
 PFNGLACTIVETEXTUREPROC pglActiveTexture;
@@ -83,6 +85,8 @@ static const struct gl_proc_map proc_map[] = {
    PROC_BIND(DisableVertexAttribArray),
    PROC_BIND(GenBuffers),
    PROC_BIND(BufferData),
+   PROC_BIND(BufferSubData),
+   PROC_BIND(DeleteBuffers),
    PROC_BIND(BindBuffer),
    PROC_BIND(MapBufferRange),
    PROC_BIND(ActiveTexture),
@@ -61,6 +61,8 @@
 #define glGetAttribLocation pglGetAttribLocation
 #define glGenBuffers pglGenBuffers
 #define glBufferData pglBufferData
+#define glBufferSubData pglBufferSubData
+#define glDeleteBuffers pglDeleteBuffers
 #define glBindBuffer pglBindBuffer
 #define glGetShaderiv pglGetShaderiv
 #define glGetShaderInfoLog pglGetShaderInfoLog
@@ -105,6 +107,8 @@ extern PFNGLENABLEVERTEXATTRIBARRAYPROC pglEnableVertexAttribArray;
 extern PFNGLDISABLEVERTEXATTRIBARRAYPROC pglDisableVertexAttribArray;
 extern PFNGLGENBUFFERSPROC pglGenBuffers;
 extern PFNGLBUFFERDATAPROC pglBufferData;
+extern PFNGLBUFFERSUBDATAPROC pglBufferSubData;
+extern PFNGLDELETEBUFFERSPROC pglDeleteBuffers;
 extern PFNGLBINDBUFFERPROC pglBindBuffer;
 extern PFNGLMAPBUFFERRANGEPROC pglMapBufferRange;
 extern PFNGLACTIVETEXTUREPROC pglActiveTexture;
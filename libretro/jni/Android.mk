@@ -55,7 +55,7 @@ COMMON_FLAGS += -DANDROID_MIPS
 endif
 
 # libretro
-LOCAL_SRC_FILES += $(LIBRETRODIR)/libretro.c $(LIBRETRODIR)/adler32.c $(LIBRETRODIR)/glsym.c $(LIBRETRODIR)/libco/libco.c $(LIBRETRODIR)/opengl_state_machine.c \
+LOCAL_SRC_FILES += $(LIBRETRODIR)/libretro.c $(LIBRETRODIR)/adler32.c $(LIBRETRODIR)/glsym.c $(LIBRETRODIR)/libco/libco.c $(LIBRETRODIR)/opengl_state_machine.c $(LIBRETRODIR)/texdecode.c $(LIBRETRODIR)/texhash.c \
           $(LIBRETRODIR)/audio_plugin.c $(LIBRETRODIR)/input_plugin.c $(LIBRETRODIR)/resampler.c
 
 # RSP Plugin
@@ -107,6 +107,7 @@ LOCAL_SRC_FILES += $(VIDEODIR_RICE)/Blender.cpp \
             $(VIDEODIR_RICE)/Video.cpp
 
 LOCAL_SRC_FILES += $(VIDEODIR_GLN64)/3DMath.c \
+            $(VIDEODIR_GLN64)/3DMathSSE.c \
             $(VIDEODIR_GLN64)/Config.c \
             $(VIDEODIR_GLN64)/CRC.c \
             $(VIDEODIR_GLN64)/DepthBuffer.c \
@@ -121,6 +122,7 @@ LOCAL_SRC_FILES += $(VIDEODIR_GLN64)/3DMath.c \
             $(VIDEODIR_GLN64)/gDP.c \
             $(VIDEODIR_GLN64)/gles2N64.c \
             $(VIDEODIR_GLN64)/gSP.c \
+            $(VIDEODIR_GLN64)/gSPSSE.c \
             $(VIDEODIR_GLN64)/L3D.c \
             $(VIDEODIR_GLN64)/L3DEX2.c \
             $(VIDEODIR_GLN64)/L3DEX.c \
@@ -143,6 +145,7 @@ LOCAL_SRC_FILES += $(VIDEODIR_GLIDE)/Glide64/3dmath.c \
             $(VIDEODIR_GLIDE)/Glide64/rdp.c \
             $(VIDEODIR_GLIDE)/Glide64/Combine.c \
             $(VIDEODIR_GLIDE)/Glide64/DepthBufferRender.c \
+            $(VIDEODIR_GLIDE)/Glide64/DListCache.c \
             $(VIDEODIR_GLIDE)/Glide64/TexCache.c
 LOCAL_SRC_FILES   += $(VIDEODIR_GLIDE)/Glitch64/combiner.c \
             $(VIDEODIR_GLIDE)/Glitch64/geometry.c \
@@ -160,7 +163,9 @@ LOCAL_SRC_FILES += \
     $(COREDIR)/src/main/cheat.c \
     $(COREDIR)/src/main/main.c \
     $(COREDIR)/src/main/md5.c \
+    $(COREDIR)/src/main/memusage.c \
     $(COREDIR)/src/main/rom.c \
+    $(COREDIR)/src/main/romdb.c \
     $(COREDIR)/src/main/savestates.c \
     $(COREDIR)/src/main/util.c \
     $(COREDIR)/src/memory/dma.c \
@@ -169,7 +174,9 @@ LOCAL_SRC_FILES += \
     $(COREDIR)/src/memory/n64_cic_nus_6105.c \
     $(COREDIR)/src/memory/pif.c \
     $(COREDIR)/src/memory/tlb.c \
+    $(COREDIR)/src/osal/thread.c \
     $(COREDIR)/src/plugin/plugin.c \
+    $(COREDIR)/src/plugin/ucode_id.c \
     $(COREDIR)/src/r4300/profile.c \
     $(COREDIR)/src/r4300/recomp.c \
     $(COREDIR)/src/r4300/exception.c \
@@ -180,7 +187,7 @@ LOCAL_SRC_FILES += \
 
 LOCAL_SRC_FILES += $(CXD4DIR)/rsp.c
 
-COMMON_FLAGS += -DM64P_CORE_PROTOTYPES -D_ENDUSER_RELEASE -DM64P_PLUGIN_API -D__LIBRETRO__ -DINLINE="inline" -DNO_ASM -DNOSSE -DSDL_VIDEO_OPENGL_ES2=1 -DGLES -DANDROID -DSINC_LOWER_QUALITY -DGLES -DHAVE_LOGGER
+COMMON_FLAGS += -DM64P_CORE_PROTOTYPES -D_ENDUSER_RELEASE -DM64P_PLUGIN_API -D__LIBRETRO__ -DINLINE="inline" -DNO_ASM -DNOSSE -DSDL_VIDEO_OPENGL_ES2=1 -D__VEC4_OPT -DGLES -DANDROID -DSINC_LOWER_QUALITY -DGLES -DHAVE_LOGGER
 COMMON_OPTFLAGS = -O3 -ffast-math
 
 LOCAL_CFLAGS += $(COMMON_OPTFLAGS) $(COMMON_FLAGS)
@@ -5,6 +5,8 @@
 #include "libretro.h"
 #include "resampler.h"
 #include "utils.h"
+#include "texdecode.h"
+#include "texhash.h"
 #include "libco.h"
 
 #include "api/m64p_frontend.h"
@@ -47,9 +49,6 @@ void (*audio_convert_s16_to_float_arm)(float *out,
 void (*audio_convert_float_to_s16_arm)(int16_t *out,
       const float *in, size_t samples);
 
-static uint8_t* game_data;
-static uint32_t game_size;
-
 static enum gfx_plugin_type gfx_plugin;
 static enum rsp_plugin_type rsp_plugin;
 static uint32_t screen_width;
@@ -144,6 +143,12 @@ static void setup_variables_balanced(void)
         "Player 4 Pak; none|memory|rumble"},
       { "mupen64-disableexpmem",
          "Disable Expansion RAM; no|yes" },
+      { "mupen64-lowmemory",
+         "Low memory mode; no|yes" },
+#ifdef NEW_DYNAREC
+      { "mupen64-dynarec-cache",
+         "Dynarec cache size; automatic|32MB|16MB|8MB|4MB" },
+#endif
       { "mupen64-gfxplugin",
          "Graphics Plugin; automatic (balanced)" },
       { "mupen64-rspplugin",
@@ -154,6 +159,10 @@ static void setup_variables_balanced(void)
          "Texture filtering; automatic|bilinear|nearest" },
       { "mupen64-dupe",
          "Frame duping; no|yes" },
+      { "mupen64-dlist-cache",
+         "Display list cache (Glide64); no|yes" },
+      { "mupen64-texture-budget",
+         "Texture memory budget (Glide64); 64MB|128MB|32MB|16MB" },
       { NULL, NULL },
    };
 
@@ -181,6 +190,12 @@ static void setup_variables(void)
         "Player 4 Pak; none|memory|rumble"},
       { "mupen64-disableexpmem",
          "Disable Expansion RAM; no|yes" },
+      { "mupen64-lowmemory",
+         "Low memory mode; no|yes" },
+#ifdef NEW_DYNAREC
+      { "mupen64-dynarec-cache",
+         "Dynarec cache size; automatic|32MB|16MB|8MB|4MB" },
+#endif
       { "mupen64-gfxplugin",
          "Graphics Plugin; gln64|glide64|rice" },
       { "mupen64-rspplugin",
@@ -191,6 +206,10 @@ static void setup_variables(void)
          "Texture filtering; automatic|bilinear|nearest" },
       { "mupen64-dupe",
          "Frame duping; no|yes" },
+      { "mupen64-dlist-cache",
+         "Display list cache (Glide64); no|yes" },
+      { "mupen64-texture-budget",
+         "Texture memory budget (Glide64); 64MB|128MB|32MB|16MB" },
       { NULL, NULL },
    };
 
@@ -201,26 +220,6 @@ static void EmuThreadFunction()
 {
     emu_thread_has_run = true;
 
-    if(CoreStartup(FRONTEND_API_VERSION, ".", ".", "Core", n64DebugCallback, 0, 0) && log_cb)
-        log_cb(RETRO_LOG_ERROR, "mupen64plus: Failed to initialize core\n");
-
-    if(CoreDoCommand(M64CMD_ROM_OPEN, game_size, (void*)game_data))
-    {
-       if (log_cb)
-          log_cb(RETRO_LOG_ERROR, "mupen64plus: Failed to load ROM\n");
-        goto load_fail;
-    }
-
-    free(game_data);
-    game_data = 0;
-
-    if(CoreDoCommand(M64CMD_ROM_GET_HEADER, sizeof(romgame), &romgame))
-    {
-       if (log_cb)
-          log_cb(RETRO_LOG_ERROR, "mupen64plus; Failed to query ROM header information\n");
-       goto load_fail;
-    }
-
     core_settings_set_defaults();
 
     struct retro_variable var = { "mupen64-balanced-profile", 0 };
@@ -238,10 +237,6 @@ static void EmuThreadFunction()
 
     co_switch(main_thread);
 
-load_fail:
-    free(game_data);
-    game_data = 0;
-
     //NEVER RETURN! That's how libco rolls
     while(1)
     {
@@ -392,6 +387,8 @@ void retro_init(void)
    environ_cb(RETRO_ENVIRONMENT_GET_PERF_INTERFACE, &perf_cb);
    if (perf_cb.get_cpu_features)
       perf_get_cpu_features_cb = perf_cb.get_cpu_features;
+   texdec_init(perf_get_cpu_features_cb ? perf_get_cpu_features_cb() : 0);
+   texhash_init(perf_get_cpu_features_cb ? perf_get_cpu_features_cb() : 0);
 
    environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &colorMode);
 
@@ -423,6 +420,8 @@ void retro_deinit(void)
 }
 
 unsigned retro_filtering = 0;
+unsigned retro_dlist_cache = 0;
+unsigned retro_texture_budget = 64 * 1024 * 1024;
 static bool frame_dupe = true;
 
 void update_variables(void)
@@ -451,6 +450,18 @@ void update_variables(void)
       else if (!strcmp(var.value, "no"))
          frame_dupe = false;
    }
+
+   var.key = "mupen64-dlist-cache";
+   var.value = NULL;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      retro_dlist_cache = !strcmp(var.value, "yes");
+
+   var.key = "mupen64-texture-budget";
+   var.value = NULL;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      retro_texture_budget = atoi(var.value) * 1024 * 1024;
    
    
    {
@@ -551,9 +562,25 @@ bool retro_load_game(const struct retro_game_info *game)
        return false;
     }
 
-    game_data = malloc(game->size);
-    memcpy(game_data, game->data, game->size);
-    game_size = game->size;
+    if(CoreStartup(FRONTEND_API_VERSION, ".", ".", "Core", n64DebugCallback, 0, 0) && log_cb)
+        log_cb(RETRO_LOG_ERROR, "mupen64plus: Failed to initialize core\n");
+
+    // Open the ROM straight from the frontend's buffer while it is guaranteed
+    // to be valid; the core makes the only copy, already in its native order.
+    if(CoreDoCommand(M64CMD_ROM_OPEN, game->size, (void*)game->data))
+    {
+       if (log_cb)
+          log_cb(RETRO_LOG_ERROR, "mupen64plus: Failed to load ROM\n");
+       return false;
+    }
+
+    if(CoreDoCommand(M64CMD_ROM_GET_HEADER, sizeof(romgame), &romgame))
+    {
+       if (log_cb)
+          log_cb(RETRO_LOG_ERROR, "mupen64plus; Failed to query ROM header information\n");
+       CoreDoCommand(M64CMD_ROM_CLOSE, 0, NULL);
+       return false;
+    }
 
     main_thread = co_active();
     emulator_thread = co_create(65536 * sizeof(void*) * 16, EmuThreadFunction);
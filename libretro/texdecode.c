@@ -0,0 +1,646 @@
+#include <string.h>
+
+#include "libretro.h"
+#include "texdecode.h"
+
+/* Rows are decoded in chunks: the source bytes are gathered into N64 order
+ * (when xor_mask is not 0), decoded to RGBA8888, then packed. */
+#define CHUNK 256
+
+#if !defined(NOSSE)
+#define TEXDEC_SIMD RETRO_SIMD_SSE2
+#include <emmintrin.h>
+
+typedef __m128i td_vec;
+
+#define td_load(p)         _mm_loadu_si128((const __m128i*)(p))
+#define td_store(p, v)     _mm_storeu_si128((__m128i*)(p), (v))
+#define td_set8(c)         _mm_set1_epi8((char)(c))
+#define td_set16(c)        _mm_set1_epi16((short)(c))
+#define td_set32(c)        _mm_set1_epi32((int)(c))
+#define td_and(a, b)       _mm_and_si128((a), (b))
+#define td_or(a, b)        _mm_or_si128((a), (b))
+#define td_cmpeq8(a, b)    _mm_cmpeq_epi8((a), (b))
+#define td_srl16(v, n)     _mm_srli_epi16((v), (n))
+#define td_sll16(v, n)     _mm_slli_epi16((v), (n))
+#define td_sra16(v, n)     _mm_srai_epi16((v), (n))
+#define td_srl32(v, n)     _mm_srli_epi32((v), (n))
+#define td_sll32(v, n)     _mm_slli_epi32((v), (n))
+#define td_zip_lo8(a, b)   _mm_unpacklo_epi8((a), (b))
+#define td_zip_hi8(a, b)   _mm_unpackhi_epi8((a), (b))
+#define td_zip_lo16(a, b)  _mm_unpacklo_epi16((a), (b))
+#define td_zip_hi16(a, b)  _mm_unpackhi_epi16((a), (b))
+
+static INLINE td_vec td_bswap16(td_vec v)
+{
+   return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+static INLINE td_vec td_rev16in32(td_vec v)
+{
+   return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static INLINE td_vec td_rev32in64(td_vec v)
+{
+   return _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+static INLINE td_vec td_rev64(td_vec v)
+{
+   return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+/* eight 32 bit lanes below 0x10000 to 16 bit lanes, a first */
+static INLINE td_vec td_narrow32(td_vec a, td_vec b)
+{
+   a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+   b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+   return _mm_packs_epi32(a, b);
+}
+
+/* sixteen 16 bit lanes below 0x100 to bytes, a first */
+static INLINE td_vec td_narrow16(td_vec a, td_vec b)
+{
+   return _mm_packus_epi16(a, b);
+}
+
+#elif defined(HAVE_NEON)
+#define TEXDEC_SIMD RETRO_SIMD_NEON
+#include <arm_neon.h>
+
+typedef uint8x16_t td_vec;
+
+#define TD_U16(v)          vreinterpretq_u16_u8(v)
+#define TD_U32(v)          vreinterpretq_u32_u8(v)
+#define TD_V16(v)          vreinterpretq_u8_u16(v)
+#define TD_V32(v)          vreinterpretq_u8_u32(v)
+
+#define td_load(p)         vld1q_u8((const uint8_t*)(p))
+#define td_store(p, v)     vst1q_u8((uint8_t*)(p), (v))
+#define td_set8(c)         vdupq_n_u8((uint8_t)(c))
+#define td_set16(c)        TD_V16(vdupq_n_u16((uint16_t)(c)))
+#define td_set32(c)        TD_V32(vdupq_n_u32((uint32_t)(c)))
+#define td_and(a, b)       vandq_u8((a), (b))
+#define td_or(a, b)        vorrq_u8((a), (b))
+#define td_cmpeq8(a, b)    vceqq_u8((a), (b))
+#define td_srl16(v, n)     TD_V16(vshrq_n_u16(TD_U16(v), (n)))
+#define td_sll16(v, n)     TD_V16(vshlq_n_u16(TD_U16(v), (n)))
+#define td_sra16(v, n)     TD_V16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u8(v), (n))))
+#define td_srl32(v, n)     TD_V32(vshrq_n_u32(TD_U32(v), (n)))
+#define td_sll32(v, n)     TD_V32(vshlq_n_u32(TD_U32(v), (n)))
+#define td_zip_lo8(a, b)   (vzipq_u8((a), (b)).val[0])
+#define td_zip_hi8(a, b)   (vzipq_u8((a), (b)).val[1])
+#define td_zip_lo16(a, b)  TD_V16(vzipq_u16(TD_U16(a), TD_U16(b)).val[0])
+#define td_zip_hi16(a, b)  TD_V16(vzipq_u16(TD_U16(a), TD_U16(b)).val[1])
+
+static INLINE td_vec td_bswap16(td_vec v)
+{
+   return vrev16q_u8(v);
+}
+
+static INLINE td_vec td_rev16in32(td_vec v)
+{
+   return TD_V16(vrev32q_u16(TD_U16(v)));
+}
+
+static INLINE td_vec td_rev32in64(td_vec v)
+{
+   return TD_V32(vrev64q_u32(TD_U32(v)));
+}
+
+static INLINE td_vec td_rev64(td_vec v)
+{
+   return vextq_u8(v, v, 8);
+}
+
+static INLINE td_vec td_narrow32(td_vec a, td_vec b)
+{
+   return TD_V16(vcombine_u16(vmovn_u32(TD_U32(a)), vmovn_u32(TD_U32(b))));
+}
+
+static INLINE td_vec td_narrow16(td_vec a, td_vec b)
+{
+   return vcombine_u8(vmovn_u16(TD_U16(a)), vmovn_u16(TD_U16(b)));
+}
+#endif
+
+typedef void (*texdec_gather_func)(uint8_t *raw, const uint8_t *src, uint32_t start, uint32_t bytes, uint32_t xor_mask);
+typedef void (*texdec_decode_func)(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut);
+typedef void (*texdec_pack_func)(void *dst, const uint32_t *rgba, unsigned n);
+
+/* bits per texel and the texel alignment a decode has to start on */
+static const uint8_t format_bits[TEXDEC_FORMATS]  = { 16, 32, 16, 4, 8, 16, 4, 8, 4, 8 };
+static const uint8_t format_align[TEXDEC_FORMATS] = {  1,  1,  2, 2, 1,  1, 2, 1, 2, 1 };
+static const uint8_t output_size[TEXDEC_OUTPUTS]  = { 4, 4, 2, 2, 2, 2, 2, 1 };
+
+/* Scalar kernels, also the tails of the vector ones */
+
+static INLINE uint32_t make_rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+{
+   return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+static INLINE uint32_t expand5(uint32_t c)
+{
+   return (c << 3) | (c >> 2);
+}
+
+static INLINE uint32_t expand3(uint32_t c)
+{
+   return (c << 5) | (c << 2) | (c >> 1);
+}
+
+static INLINE uint32_t rgba16_to_rgba(uint32_t c)
+{
+   return make_rgba(expand5(c >> 11), expand5((c >> 6) & 0x1F), expand5((c >> 1) & 0x1F), (c & 1) ? 0xFF : 0);
+}
+
+static INLINE uint32_t ia16_to_rgba(uint32_t c)
+{
+   uint32_t i = c >> 8;
+   return make_rgba(i, i, i, c & 0xFF);
+}
+
+static INLINE uint32_t ia4_to_rgba(uint32_t c)
+{
+   uint32_t i = expand3(c >> 1);
+   return make_rgba(i, i, i, (c & 1) ? 0xFF : 0);
+}
+
+static INLINE uint32_t yuv_to_rgba(int y, int u, int v)
+{
+   int r = (int)(y + 1.370705f * (v - 128));
+   int g = (int)(y - 0.698001f * (v - 128) - 0.337633f * (u - 128));
+   int b = (int)(y + 1.732446f * (u - 128));
+   r = r < 0 ? 0 : (r > 255 ? 255 : r);
+   g = g < 0 ? 0 : (g > 255 ? 255 : g);
+   b = b < 0 ? 0 : (b > 255 ? 255 : b);
+   return make_rgba(r, g, b, 0xFF);
+}
+
+// the n-th 4 bit texel, the high nibble first
+#define NIBBLE(raw, n) (((n) & 1) ? (raw)[(n) >> 1] & 0x0F : (raw)[(n) >> 1] >> 4)
+
+static void gather_c(uint8_t *raw, const uint8_t *src, uint32_t start, uint32_t bytes, uint32_t xor_mask)
+{
+   uint32_t i;
+   for (i = 0; i < bytes; i++)
+      raw[i] = src[(start + i) ^ xor_mask];
+}
+
+static void decode_rgba16_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = rgba16_to_rgba((raw[i * 2] << 8) | raw[i * 2 + 1]);
+}
+
+static void decode_rgba32_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = make_rgba(raw[i * 4], raw[i * 4 + 1], raw[i * 4 + 2], raw[i * 4 + 3]);
+}
+
+static void decode_yuv16_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i += 2, raw += 4)
+   {
+      rgba[i] = yuv_to_rgba(raw[1], raw[0], raw[2]);
+      rgba[i + 1] = yuv_to_rgba(raw[3], raw[0], raw[2]);
+   }
+}
+
+static void decode_ia4_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = ia4_to_rgba(NIBBLE(raw, i));
+}
+
+static void decode_ia8_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+   {
+      uint32_t c = (raw[i] >> 4) * 0x11;
+      rgba[i] = make_rgba(c, c, c, (raw[i] & 0x0F) * 0x11);
+   }
+}
+
+static void decode_ia16_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = ia16_to_rgba((raw[i * 2] << 8) | raw[i * 2 + 1]);
+}
+
+static void decode_i4_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = NIBBLE(raw, i) * 0x11111111;
+}
+
+static void decode_i8_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = raw[i] * 0x01010101;
+}
+
+static void decode_ci4_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = lut[NIBBLE(raw, i)];
+}
+
+static void decode_ci8_c(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   unsigned i;
+   for (i = 0; i < n; i++)
+      rgba[i] = lut[raw[i]];
+}
+
+static INLINE uint32_t to_bgra8888(uint32_t c)
+{
+   return (c & 0xFF00FF00) | ((c >> 16) & 0xFF) | ((c & 0xFF) << 16);
+}
+
+static INLINE uint32_t to_rgba5551(uint32_t c)
+{
+   return ((c << 8) & 0xF800) | ((c >> 5) & 0x07C0) | ((c >> 18) & 0x003E) | (c >> 31);
+}
+
+static INLINE uint32_t to_argb1555(uint32_t c)
+{
+   return ((c >> 16) & 0x8000) | ((c << 7) & 0x7C00) | ((c >> 6) & 0x03E0) | ((c >> 19) & 0x001F);
+}
+
+static INLINE uint32_t to_rgba4444(uint32_t c)
+{
+   return ((c << 8) & 0xF000) | ((c >> 4) & 0x0F00) | ((c >> 16) & 0x00F0) | (c >> 28);
+}
+
+static INLINE uint32_t to_argb4444(uint32_t c)
+{
+   return ((c >> 16) & 0xF000) | ((c << 4) & 0x0F00) | ((c >> 8) & 0x00F0) | ((c >> 20) & 0x000F);
+}
+
+static INLINE uint32_t to_ia88(uint32_t c)
+{
+   return (c & 0xFF) | ((c >> 16) & 0xFF00);
+}
+
+static INLINE uint32_t to_i8(uint32_t c)
+{
+   return c & 0xFF;
+}
+
+static void pack_rgba8888_c(void *dst, const uint32_t *rgba, unsigned n)
+{
+   memcpy(dst, rgba, n * 4);
+}
+
+#define PACK_C(name, type, conv) \
+static void name(void *dst, const uint32_t *rgba, unsigned n) \
+{ \
+   type *out = (type*)dst; \
+   unsigned i; \
+   for (i = 0; i < n; i++) \
+      out[i] = (type)conv(rgba[i]); \
+}
+
+PACK_C(pack_bgra8888_c, uint32_t, to_bgra8888)
+PACK_C(pack_rgba5551_c, uint16_t, to_rgba5551)
+PACK_C(pack_argb1555_c, uint16_t, to_argb1555)
+PACK_C(pack_rgba4444_c, uint16_t, to_rgba4444)
+PACK_C(pack_argb4444_c, uint16_t, to_argb4444)
+PACK_C(pack_ia88_c, uint16_t, to_ia88)
+PACK_C(pack_i8_c, uint8_t, to_i8)
+
+static const texdec_decode_func decode_c[TEXDEC_FORMATS] =
+{
+   decode_rgba16_c, decode_rgba32_c, decode_yuv16_c,
+   decode_ia4_c, decode_ia8_c, decode_ia16_c,
+   decode_i4_c, decode_i8_c, decode_ci4_c, decode_ci8_c
+};
+
+static const texdec_pack_func pack_c[TEXDEC_OUTPUTS] =
+{
+   pack_rgba8888_c, pack_bgra8888_c, pack_rgba5551_c, pack_argb1555_c,
+   pack_rgba4444_c, pack_argb4444_c, pack_ia88_c, pack_i8_c
+};
+
+#ifdef TEXDEC_SIMD
+/* SSE2/NEON kernels, written once with the td_* helpers */
+
+static void gather_simd(uint8_t *raw, const uint8_t *src, uint32_t start, uint32_t bytes, uint32_t xor_mask)
+{
+   // the mask only moves bytes inside aligned 16 byte blocks of src
+   uint32_t end = start + bytes;
+   uint32_t i = start;
+
+   for (; (i & 15) && i < end; i++)
+      raw[i - start] = src[i ^ xor_mask];
+   for (; i + 16 <= end; i += 16)
+   {
+      td_vec v = td_load(src + i);
+      if (xor_mask & 1)
+         v = td_bswap16(v);
+      if (xor_mask & 2)
+         v = td_rev16in32(v);
+      if (xor_mask & 4)
+         v = td_rev32in64(v);
+      if (xor_mask & 8)
+         v = td_rev64(v);
+      td_store(raw + i - start, v);
+   }
+   for (; i < end; i++)
+      raw[i - start] = src[i ^ xor_mask];
+}
+
+// 16 texels from their intensity and alpha bytes
+static INLINE void store_ia(uint32_t *rgba, td_vec i, td_vec a)
+{
+   td_vec ii = td_zip_lo8(i, i), ia = td_zip_lo8(i, a);
+   td_store(rgba, td_zip_lo16(ii, ia));
+   td_store(rgba + 4, td_zip_hi16(ii, ia));
+   ii = td_zip_hi8(i, i);
+   ia = td_zip_hi8(i, a);
+   td_store(rgba + 8, td_zip_lo16(ii, ia));
+   td_store(rgba + 12, td_zip_hi16(ii, ia));
+}
+
+// n * 0x11 for the nibbles in the high and in the low half of each byte
+static INLINE td_vec td_hi4x11(td_vec v)
+{
+   v = td_and(td_srl16(v, 4), td_set8(0x0F));
+   return td_or(v, td_sll16(v, 4));
+}
+
+static INLINE td_vec td_lo4x11(td_vec v)
+{
+   v = td_and(v, td_set8(0x0F));
+   return td_or(v, td_sll16(v, 4));
+}
+
+static INLINE td_vec td_expand5(td_vec c)
+{
+   return td_or(td_sll16(c, 3), td_srl16(c, 2));
+}
+
+static void decode_rgba16_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   for (; n >= 8; n -= 8, raw += 16, rgba += 8)
+   {
+      td_vec c = td_bswap16(td_load(raw));
+      td_vec r = td_expand5(td_srl16(c, 11));
+      td_vec g = td_expand5(td_and(td_srl16(c, 6), td_set16(0x1F)));
+      td_vec b = td_expand5(td_and(td_srl16(c, 1), td_set16(0x1F)));
+      td_vec a = td_and(td_sra16(td_sll16(c, 15), 15), td_set16(0xFF00));
+      td_vec rg = td_or(r, td_sll16(g, 8));
+      td_vec ba = td_or(b, a);
+      td_store(rgba, td_zip_lo16(rg, ba));
+      td_store(rgba + 4, td_zip_hi16(rg, ba));
+   }
+   decode_rgba16_c(rgba, raw, n, lut);
+}
+
+static void decode_rgba32_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   memcpy(rgba, raw, n * 4);
+}
+
+static void decode_ia4_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   for (; n >= 32; n -= 32, raw += 16, rgba += 32)
+   {
+      td_vec v = td_load(raw);
+      td_vec hi = td_and(td_srl16(v, 4), td_set8(0x0F));
+      td_vec lo = td_and(v, td_set8(0x0F));
+      td_vec c[2];
+      int k;
+
+      c[0] = td_zip_lo8(hi, lo);
+      c[1] = td_zip_hi8(hi, lo);
+      for (k = 0; k < 2; k++)
+      {
+         td_vec i3 = td_and(td_srl16(c[k], 1), td_set8(0x07));
+         td_vec i = td_or(td_or(td_sll16(i3, 5), td_sll16(i3, 2)), td_and(td_srl16(i3, 1), td_set8(0x03)));
+         td_vec a = td_cmpeq8(td_and(c[k], td_set8(0x01)), td_set8(0x01));
+         store_ia(rgba + k * 16, i, a);
+      }
+   }
+   decode_ia4_c(rgba, raw, n, lut);
+}
+
+static void decode_ia8_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   for (; n >= 16; n -= 16, raw += 16, rgba += 16)
+   {
+      td_vec v = td_load(raw);
+      store_ia(rgba, td_hi4x11(v), td_lo4x11(v));
+   }
+   decode_ia8_c(rgba, raw, n, lut);
+}
+
+static void decode_ia16_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   for (; n >= 8; n -= 8, raw += 16, rgba += 8)
+   {
+      // each 16 bit lane is I | A << 8, the texel is I I I A
+      td_vec c = td_load(raw);
+      td_vec i = td_and(c, td_set16(0xFF));
+      td_vec ii = td_or(i, td_sll16(i, 8));
+      td_store(rgba, td_zip_lo16(ii, c));
+      td_store(rgba + 4, td_zip_hi16(ii, c));
+   }
+   decode_ia16_c(rgba, raw, n, lut);
+}
+
+static void decode_i4_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   for (; n >= 32; n -= 32, raw += 16, rgba += 32)
+   {
+      td_vec v = td_load(raw);
+      td_vec hi = td_hi4x11(v), lo = td_lo4x11(v);
+      td_vec c = td_zip_lo8(hi, lo);
+      store_ia(rgba, c, c);
+      c = td_zip_hi8(hi, lo);
+      store_ia(rgba + 16, c, c);
+   }
+   decode_i4_c(rgba, raw, n, lut);
+}
+
+static void decode_i8_simd(uint32_t *rgba, const uint8_t *raw, unsigned n, const uint32_t *lut)
+{
+   for (; n >= 16; n -= 16, raw += 16, rgba += 16)
+   {
+      td_vec v = td_load(raw);
+      store_ia(rgba, v, v);
+   }
+   decode_i8_c(rgba, raw, n, lut);
+}
+
+static INLINE td_vec td_to_bgra8888(td_vec c)
+{
+   return td_or(td_and(c, td_set32(0xFF00FF00)),
+         td_or(td_and(td_srl32(c, 16), td_set32(0xFF)), td_and(td_sll32(c, 16), td_set32(0xFF0000))));
+}
+
+static INLINE td_vec td_to_rgba5551(td_vec c)
+{
+   return td_or(td_or(td_and(td_sll32(c, 8), td_set32(0xF800)), td_and(td_srl32(c, 5), td_set32(0x07C0))),
+         td_or(td_and(td_srl32(c, 18), td_set32(0x003E)), td_srl32(c, 31)));
+}
+
+static INLINE td_vec td_to_argb1555(td_vec c)
+{
+   return td_or(td_or(td_and(td_srl32(c, 16), td_set32(0x8000)), td_and(td_sll32(c, 7), td_set32(0x7C00))),
+         td_or(td_and(td_srl32(c, 6), td_set32(0x03E0)), td_and(td_srl32(c, 19), td_set32(0x001F))));
+}
+
+static INLINE td_vec td_to_rgba4444(td_vec c)
+{
+   return td_or(td_or(td_and(td_sll32(c, 8), td_set32(0xF000)), td_and(td_srl32(c, 4), td_set32(0x0F00))),
+         td_or(td_and(td_srl32(c, 16), td_set32(0x00F0)), td_srl32(c, 28)));
+}
+
+static INLINE td_vec td_to_argb4444(td_vec c)
+{
+   return td_or(td_or(td_and(td_srl32(c, 16), td_set32(0xF000)), td_and(td_sll32(c, 4), td_set32(0x0F00))),
+         td_or(td_and(td_srl32(c, 8), td_set32(0x00F0)), td_and(td_srl32(c, 20), td_set32(0x000F))));
+}
+
+static INLINE td_vec td_to_ia88(td_vec c)
+{
+   return td_or(td_and(c, td_set32(0xFF)), td_and(td_srl32(c, 16), td_set32(0xFF00)));
+}
+
+static void pack_bgra8888_simd(void *dst, const uint32_t *rgba, unsigned n)
+{
+   uint32_t *out = (uint32_t*)dst;
+   for (; n >= 4; n -= 4, rgba += 4, out += 4)
+      td_store(out, td_to_bgra8888(td_load(rgba)));
+   pack_bgra8888_c(out, rgba, n);
+}
+
+#define PACK16_SIMD(name, conv) \
+static void name##_simd(void *dst, const uint32_t *rgba, unsigned n) \
+{ \
+   uint16_t *out = (uint16_t*)dst; \
+   for (; n >= 8; n -= 8, rgba += 8, out += 8) \
+      td_store(out, td_narrow32(td_##conv(td_load(rgba)), td_##conv(td_load(rgba + 4)))); \
+   name##_c(out, rgba, n); \
+}
+
+PACK16_SIMD(pack_rgba5551, to_rgba5551)
+PACK16_SIMD(pack_argb1555, to_argb1555)
+PACK16_SIMD(pack_rgba4444, to_rgba4444)
+PACK16_SIMD(pack_argb4444, to_argb4444)
+PACK16_SIMD(pack_ia88, to_ia88)
+
+static void pack_i8_simd(void *dst, const uint32_t *rgba, unsigned n)
+{
+   uint8_t *out = (uint8_t*)dst;
+   td_vec mask = td_set32(0xFF);
+   for (; n >= 16; n -= 16, rgba += 16, out += 16)
+   {
+      td_vec lo = td_narrow32(td_and(td_load(rgba), mask), td_and(td_load(rgba + 4), mask));
+      td_vec hi = td_narrow32(td_and(td_load(rgba + 8), mask), td_and(td_load(rgba + 12), mask));
+      td_store(out, td_narrow16(lo, hi));
+   }
+   pack_i8_c(out, rgba, n);
+}
+
+static const texdec_decode_func decode_simd[TEXDEC_FORMATS] =
+{
+   decode_rgba16_simd, decode_rgba32_simd, decode_yuv16_c,
+   decode_ia4_simd, decode_ia8_simd, decode_ia16_simd,
+   decode_i4_simd, decode_i8_simd, decode_ci4_c, decode_ci8_c
+};
+
+static const texdec_pack_func pack_simd[TEXDEC_OUTPUTS] =
+{
+   pack_rgba8888_c, pack_bgra8888_simd, pack_rgba5551_simd, pack_argb1555_simd,
+   pack_rgba4444_simd, pack_argb4444_simd, pack_ia88_simd, pack_i8_simd
+};
+#endif
+
+static texdec_gather_func gather = gather_c;
+static const texdec_decode_func *decode = decode_c;
+static const texdec_pack_func *pack = pack_c;
+
+void texdec_init(uint64_t simd_flags)
+{
+   gather = gather_c;
+   decode = decode_c;
+   pack = pack_c;
+#ifdef TEXDEC_SIMD
+   if (simd_flags & TEXDEC_SIMD)
+   {
+      gather = gather_simd;
+      decode = decode_simd;
+      pack = pack_simd;
+   }
+#endif
+}
+
+int texdec_simd(void)
+{
+   return decode != decode_c;
+}
+
+unsigned texdec_output_size(unsigned output)
+{
+   return output_size[output];
+}
+
+void texdec_palette(uint32_t *lut, const uint16_t *tlut, unsigned count, unsigned tlut_format)
+{
+   unsigned i;
+   for (i = 0; i < count; i++)
+      lut[i] = (tlut_format == TEXDEC_TLUT_IA16) ? ia16_to_rgba(tlut[i]) : rgba16_to_rgba(tlut[i]);
+}
+
+void texdec_row(void *dst, unsigned output, unsigned format, const void *src,
+      uint32_t texel, uint32_t xor_mask, unsigned count, const uint32_t *lut)
+{
+   uint8_t raw[CHUNK * 4];
+   uint32_t rgba[CHUNK];
+   uint8_t *out = (uint8_t*)dst;
+   unsigned bits = format_bits[format];
+   unsigned align = format_align[format];
+
+   while (count)
+   {
+      // decode from an aligned texel and drop the first skip ones
+      uint32_t first = texel & ~(align - 1);
+      unsigned skip = texel - first;
+      unsigned n = (count < CHUNK - skip) ? count : CHUNK - skip;
+      unsigned decoded = (skip + n + align - 1) & ~(align - 1);
+      uint32_t start = (first * bits) >> 3;
+      uint32_t bytes = (decoded * bits) >> 3;
+      const uint8_t *data = (const uint8_t*)src + start;
+      uint32_t *to = rgba;
+
+      if (xor_mask)
+      {
+         gather(raw, (const uint8_t*)src, start, bytes, xor_mask);
+         data = raw;
+      }
+      if (output == TEXDEC_OUT_RGBA8888 && decoded == n)
+         to = (uint32_t*)out;
+      decode[format](to, data, decoded, lut);
+      if (to == rgba)
+         pack[output](out, rgba + skip, n);
+
+      out += n * output_size[output];
+      texel += n;
+      count -= n;
+   }
+}
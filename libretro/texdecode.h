@@ -0,0 +1,85 @@
+#ifndef TEXDECODE_H__
+#define TEXDECODE_H__
+
+/* N64 texture decoding shared by the video plugins.
+ *
+ * Every source format is first decoded to RGBA8888 the way the RDP expands
+ * it (5 bit and 3 bit channels by bit replication, 4 bit intensity/alpha
+ * times 0x11, I formats with alpha = intensity), then packed to the
+ * plugin's output format by truncation. A row is decoded with one call;
+ * the SSE2/NEON kernels are picked at runtime by texdec_init(), the scalar
+ * ones are used before that or when the CPU lacks the extension.
+ *
+ * Sources are addressed in texels from a base pointer. xor_mask is applied
+ * to every byte offset from that base, so the same call reads N64 byte
+ * order (0), RDRAM as the core keeps it (TEXDEC_XOR_HOST) and TMEM odd
+ * line interleaving (| 4, or | 8 for 32 bit texels). The mask must be
+ * below 16. Little endian hosts only, like the rest of the byte swapping
+ * in the core. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* RDRAM is stored as host order 32 bit words */
+#define TEXDEC_XOR_HOST 3
+
+enum texdec_format
+{
+   TEXDEC_RGBA16 = 0,
+   TEXDEC_RGBA32,
+   TEXDEC_YUV16,        /* U Y0 V Y1, two texels per 32 bits */
+   TEXDEC_IA4,
+   TEXDEC_IA8,
+   TEXDEC_IA16,
+   TEXDEC_I4,
+   TEXDEC_I8,
+   TEXDEC_CI4,          /* need a palette from texdec_palette() */
+   TEXDEC_CI8,
+   TEXDEC_FORMATS
+};
+
+enum texdec_output
+{
+   TEXDEC_OUT_RGBA8888 = 0,   /* bytes R, G, B, A */
+   TEXDEC_OUT_BGRA8888,       /* bytes B, G, R, A (D3D/Glide ARGB8888) */
+   TEXDEC_OUT_RGBA5551,       /* GL_UNSIGNED_SHORT_5_5_5_1 */
+   TEXDEC_OUT_ARGB1555,
+   TEXDEC_OUT_RGBA4444,       /* GL_UNSIGNED_SHORT_4_4_4_4 */
+   TEXDEC_OUT_ARGB4444,
+   TEXDEC_OUT_IA88,           /* bytes I, A (GL_LUMINANCE_ALPHA) */
+   TEXDEC_OUT_I8,
+   TEXDEC_OUTPUTS
+};
+
+enum texdec_tlut
+{
+   TEXDEC_TLUT_RGBA16 = 0,
+   TEXDEC_TLUT_IA16
+};
+
+/* Selects the kernels from RETRO_SIMD_* flags, 0 forces the scalar ones. */
+void texdec_init(uint64_t simd_flags);
+
+/* Non-zero when the SSE2/NEON kernels are in use. */
+int texdec_simd(void);
+
+/* Decodes count palette entries, given as numeric 16 bit values, into the
+ * RGBA8888 lookup table the CI formats read. */
+void texdec_palette(uint32_t *lut, const uint16_t *tlut, unsigned count, unsigned tlut_format);
+
+/* Decodes count texels of format starting at texel index texel of src
+ * into dst. lut is only read for the CI formats. */
+void texdec_row(void *dst, unsigned output, unsigned format, const void *src,
+      uint32_t texel, uint32_t xor_mask, unsigned count, const uint32_t *lut);
+
+/* Bytes per texel of an output format */
+unsigned texdec_output_size(unsigned output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
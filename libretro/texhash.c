@@ -0,0 +1,196 @@
+#include <string.h>
+
+#include "libretro.h"
+#include "texhash.h"
+
+#if !defined(NOSSE) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define TEXHASH_X86
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TEXHASH_TARGET_SSE42
+#else
+#include <cpuid.h>
+#define TEXHASH_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#define TEXHASH_ARM
+#include <arm_acle.h>
+#endif
+
+/* CRC32C, reflected */
+#define POLY 0x82F63B78
+
+typedef uint32_t (*texhash_func)(uint32_t crc, const uint8_t *p, size_t len);
+
+static uint32_t table[8][256];
+static int table_built;
+
+static void build_table(void)
+{
+   unsigned i, j;
+   for (i = 0; i < 256; i++)
+   {
+      uint32_t crc = i;
+      for (j = 0; j < 8; j++)
+         crc = (crc >> 1) ^ (POLY & (0 - (crc & 1)));
+      table[0][i] = crc;
+   }
+   for (j = 1; j < 8; j++)
+      for (i = 0; i < 256; i++)
+         table[j][i] = (table[j - 1][i] >> 8) ^ table[0][table[j - 1][i] & 0xFF];
+   table_built = 1;
+}
+
+/* slice-by-8, little endian hosts like the rest of the core */
+static uint32_t crc_table(uint32_t crc, const uint8_t *p, size_t len)
+{
+   if (!table_built)
+      build_table();
+
+   while (len && ((uintptr_t)p & 7))
+   {
+      crc = table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+      len--;
+   }
+   while (len >= 8)
+   {
+      uint32_t lo, hi;
+      memcpy(&lo, p, 4);
+      memcpy(&hi, p + 4, 4);
+      lo ^= crc;
+      crc = table[7][lo & 0xFF] ^ table[6][(lo >> 8) & 0xFF] ^ table[5][(lo >> 16) & 0xFF] ^ table[4][lo >> 24]
+          ^ table[3][hi & 0xFF] ^ table[2][(hi >> 8) & 0xFF] ^ table[1][(hi >> 16) & 0xFF] ^ table[0][hi >> 24];
+      p += 8;
+      len -= 8;
+   }
+   while (len--)
+      crc = table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+   return crc;
+}
+
+#ifdef TEXHASH_X86
+static TEXHASH_TARGET_SSE42 uint32_t crc_sse42(uint32_t crc, const uint8_t *p, size_t len)
+{
+   while (len && ((uintptr_t)p & 7))
+   {
+      crc = _mm_crc32_u8(crc, *p++);
+      len--;
+   }
+#if defined(__x86_64__) || defined(_M_X64)
+   {
+      uint64_t crc64 = crc;
+      while (len >= 8)
+      {
+         uint64_t v;
+         memcpy(&v, p, 8);
+         crc64 = _mm_crc32_u64(crc64, v);
+         p += 8;
+         len -= 8;
+      }
+      crc = (uint32_t)crc64;
+   }
+#endif
+   while (len >= 4)
+   {
+      uint32_t v;
+      memcpy(&v, p, 4);
+      crc = _mm_crc32_u32(crc, v);
+      p += 4;
+      len -= 4;
+   }
+   while (len--)
+      crc = _mm_crc32_u8(crc, *p++);
+   return crc;
+}
+
+static int cpu_has_sse42(void)
+{
+#ifdef _MSC_VER
+   int info[4];
+   __cpuid(info, 1);
+   return (info[2] >> 20) & 1;
+#else
+   unsigned a, b, c, d;
+   if (!__get_cpuid(1, &a, &b, &c, &d))
+      return 0;
+   return (c >> 20) & 1;
+#endif
+}
+#endif
+
+#ifdef TEXHASH_ARM
+static uint32_t crc_armv8(uint32_t crc, const uint8_t *p, size_t len)
+{
+   while (len && ((uintptr_t)p & 7))
+   {
+      crc = __crc32cb(crc, *p++);
+      len--;
+   }
+   while (len >= 8)
+   {
+      uint64_t v;
+      memcpy(&v, p, 8);
+      crc = __crc32cd(crc, v);
+      p += 8;
+      len -= 8;
+   }
+   while (len--)
+      crc = __crc32cb(crc, *p++);
+   return crc;
+}
+#endif
+
+static texhash_func crc = crc_table;
+static int backend = TEXHASH_TABLE;
+
+void texhash_init(uint64_t simd_flags)
+{
+   if (!table_built)
+      build_table();
+
+   crc = crc_table;
+   backend = TEXHASH_TABLE;
+   if (!simd_flags)
+      return;
+#ifdef TEXHASH_X86
+   if (cpu_has_sse42())
+   {
+      crc = crc_sse42;
+      backend = TEXHASH_SSE42;
+   }
+#endif
+#ifdef TEXHASH_ARM
+   /* built for a CPU with the CRC extension */
+   crc = crc_armv8;
+   backend = TEXHASH_ARMV8;
+#endif
+}
+
+int texhash_backend(void)
+{
+   return backend;
+}
+
+const char *texhash_backend_name(void)
+{
+   static const char *names[] = { "table", "SSE4.2", "ARMv8 CRC" };
+   return names[backend];
+}
+
+uint32_t texhash(uint32_t hash, const void *src, size_t len)
+{
+   return ~crc(~hash, (const uint8_t*)src, len);
+}
+
+uint32_t texhash_rect(uint32_t hash, const void *src, size_t row_bytes,
+      unsigned rows, ptrdiff_t pitch)
+{
+   const uint8_t *p = (const uint8_t*)src;
+   uint32_t c = ~hash;
+   for (; rows; rows--, p += pitch)
+      c = crc(c, p, row_bytes);
+   return ~c;
+}
@@ -0,0 +1,46 @@
+#ifndef TEXHASH_H__
+#define TEXHASH_H__
+
+/* Texture change detection shared by the video plugins.
+ *
+ * Every byte is hashed with CRC32C (Castagnoli), on the CRC instructions of
+ * SSE4.2 or ARMv8 when the CPU has them and with a slice-by-8 table
+ * otherwise. All the backends give the same values, so a hash never depends
+ * on the host, and a single changed bit always changes it: there is no
+ * sampling. The values are not those of any plugin's old hash, so nothing
+ * that names files after a texture hash should use them. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum texhash_backend
+{
+   TEXHASH_TABLE = 0,
+   TEXHASH_SSE42,
+   TEXHASH_ARMV8
+};
+
+/* Picks the backend. simd_flags 0 forces the table, anything else uses the
+ * CRC instructions when the CPU has them; the table is used before this. */
+void texhash_init(uint64_t simd_flags);
+
+/* enum texhash_backend in use, and its name */
+int texhash_backend(void);
+const char *texhash_backend_name(void);
+
+/* Hash of len bytes, continuing from hash (0 to start). */
+uint32_t texhash(uint32_t hash, const void *src, size_t len);
+
+/* Hash of rows of row_bytes bytes, pitch bytes apart. */
+uint32_t texhash_rect(uint32_t hash, const void *src, size_t row_bytes,
+      unsigned rows, ptrdiff_t pitch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1235,11 +1235,13 @@ EXPORT int CALL ConfigGetParamInt(m64p_handle ConfigSectionHandle, const char *P
     {
         const char* ParamName;
         const char* RetroName;
-        const value_pair Values[4];
+        const value_pair Values[6];
     }   libretro_translate[] =
     {
         { "R4300Emulator", "mupen64-cpucore", { { 0, "pure_interpreter" }, { 1, "cached_interpreter" }, { 2, "dynamic_recompiler" }, { 0, 0 } } },
         { "DisableExtraMem", "mupen64-disableexpmem", { { 0, "no" }, { 1, "yes" }, { 0, 0 } } },
+        { "LowMemory", "mupen64-lowmemory", { { 0, "no" }, { 1, "yes" }, { 0, 0 } } },
+        { "DynarecCacheSize", "mupen64-dynarec-cache", { { 0, "automatic" }, { 32, "32MB" }, { 16, "16MB" }, { 8, "8MB" }, { 4, "4MB" }, { 0, 0 } } },
         { "ScreenWidth", "mupen64-screensize", { { 320, "320x240" }, { 640, "640x480" }, { 1280, "1280x960" }, { 0, 0 } } },
         { "ScreenHeight", "mupen64-screensize", { { 240, "320x240" }, { 480, "640x480" }, { 960, "1280x960" }, { 0, 0 } } },
         0
@@ -319,8 +319,8 @@ uint32 read_memory_32(uint32 addr){
   switch(get_memory_type(addr))
     {
     case M64P_MEM_NOMEM:
-      if(tlb_LUT_r[addr>>12])
-        return read_memory_32((tlb_LUT_r[addr>>12]&0xFFFFF000)|(addr&0xFFF));
+      if(tlb_lut_r(addr>>12))
+        return read_memory_32((tlb_lut_r(addr>>12)&0xFFFFF000)|(addr&0xFFF));
       return M64P_MEM_INVALID;
     case M64P_MEM_RDRAM:
       return *((uint32 *)(rdramb + (addr & 0xFFFFFF)));
@@ -335,43 +335,43 @@ uint32 read_memory_32(uint32 addr){
       return *((uint32 *)(rom + (addr & 0x03FFFFFF)));
     case M64P_MEM_RDRAMREG:
       if (addrlow < 0x28)
-        return *(readrdramreg[addrlow&0xfffc]);
+        return *(readrdramreg[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_RSPREG:
       if (addrlow < 0x20)
-        return *(readrspreg[addrlow&0xfffc]);
+        return *(readrspreg[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_RSP:
       if (addrlow < 0x8)
-        return *(readrsp[addrlow&0xfffc]);
+        return *(readrsp[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_DP:
       if (addrlow < 0x20)
-        return *(readdp[addrlow&0xfffc]);
+        return *(readdp[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_DPS:
       if (addrlow < 0x10)
-        return *(readdps[addrlow&0xfffc]);
+        return *(readdps[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_VI:
       if (addrlow < 0x38)
-        return *(readvi[addrlow&0xfffc]);
+        return *(readvi[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_AI:
       if (addrlow < 0x18)
-        return *(readai[addrlow&0xfffc]);
+        return *(readai[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_PI:
       if (addrlow < 0x34)
-        return *(readpi[addrlow&0xfffc]);
+        return *(readpi[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_RI:
       if (addrlow < 0x20)
-        return *(readri[addrlow&0xfffc]);
+        return *(readri[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_SI:
       if (addrlow < 0x1c)
-        return *(readsi[addrlow&0xfffc]);
+        return *(readsi[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     case M64P_MEM_PIF:
       if (addrlow >= 0x7C0 && addrlow <= 0x7FF)
@@ -379,7 +379,7 @@ uint32 read_memory_32(uint32 addr){
       break;
     case M64P_MEM_MI:
       if (addrlow < 0x10)
-        return *(readmi[addrlow&0xfffc]);
+        return *(readmi[MEM_REG_INDEX(addrlow&0xfffc)]);
       break;
     default:
       break;
@@ -453,7 +453,7 @@ uint32 get_memory_flags(uint32 addr)
   switch(type)
   {
     case M64P_MEM_NOMEM:
-      if(tlb_LUT_r[addr>>12])
+      if(tlb_lut_r(addr>>12))
         flags = M64P_MEM_FLAG_READABLE | M64P_MEM_FLAG_WRITABLE_EMUONLY;
       break;
     case M64P_MEM_NOTHING:
@@ -28,6 +28,7 @@
 
 #include "memory/memory.h"
 #include "cheat.h"
+#include "eventloop.h"
 #include "main.h"
 #include "rom.h"
 #include "list.h"
@@ -54,48 +55,111 @@ typedef struct cheat {
     struct list_head list;
 } cheat_t;
 
+// Cheats are compiled into flat programs of pre-resolved operations whenever
+// the cheat list changes, so that applying them each VI is a single loop
+// over RDRAM pointers instead of a walk of the code lists.
+enum {
+    CHEAT_OP_WRITE8,
+    CHEAT_OP_WRITE16,
+    CHEAT_OP_EE,
+    CHEAT_OP_RESTORE8,
+    CHEAT_OP_RESTORE16
+};
+
+enum {
+    CHEAT_COND_NONE,
+    CHEAT_COND_EQ8,
+    CHEAT_COND_EQ16,
+    CHEAT_COND_NE8,
+    CHEAT_COND_NE16
+};
+
+typedef struct cheat_op {
+    unsigned char *ptr;         // write target in RDRAM
+    unsigned char *cond_ptr;    // value tested by the condition, if any
+    int *old_value;             // where the overwritten value is kept, or NULL
+    unsigned short value;
+    unsigned short cond_value;
+    unsigned char kind;
+    unsigned char cond;
+    unsigned char gs_button;    // only applied while the GS button is held
+} cheat_op_t;
+
+typedef struct cheat_program {
+    cheat_op_t *ops;
+    int count;
+    int capacity;
+    int has_restores;
+} cheat_program_t;
+
 // local variables
 static LIST_HEAD(active_cheats);
 
+static cheat_program_t boot_program;
+static cheat_program_t vi_program;
+static cheat_program_t builtin_program;
+static int cheats_dirty = 1;
+static int builtin_valid = 0;
+static unsigned int builtin_crc1, builtin_crc2;
+
 // private functions
-static unsigned short read_address_16bit(unsigned int address)
+static unsigned char *cheat_pointer_8bit(unsigned int address)
 {
-    return *(unsigned short *)((rdramb + ((address & 0xFFFFFF)^S16)));
+    unsigned int offset = (address & 0xFFFFFF) ^ S8;
+    return offset < 0x800000 ? rdramb + offset : NULL;
 }
 
-static unsigned char read_address_8bit(unsigned int address)
+static unsigned char *cheat_pointer_16bit(unsigned int address)
 {
-    return *(unsigned char *)((rdramb + ((address & 0xFFFFFF)^S8)));
+    unsigned int offset = (address & 0xFFFFFF) ^ S16;
+    return offset < 0x800000 ? rdramb + offset : NULL;
 }
 
-static void update_address_16bit(unsigned int address, unsigned short new_value)
+static int cheat_is_gs_conditional(unsigned int address)
 {
-    *(unsigned short *)((rdramb + ((address & 0xFFFFFF)^S16))) = new_value;
+    switch (address & 0xFF000000)
+    {
+        case 0xD8000000:
+        case 0xD9000000:
+        case 0xDA000000:
+        case 0xDB000000:
+            return 1;
+        default:
+            return 0;
+    }
 }
 
-static void update_address_8bit(unsigned int address, unsigned char new_value)
+static cheat_op_t *cheat_program_append(cheat_program_t *program)
 {
-    *(unsigned char *)((rdramb + ((address & 0xFFFFFF)^S8))) = new_value;
-}
+    if (program->count == program->capacity)
+    {
+        int capacity = program->capacity ? program->capacity * 2 : 64;
+        cheat_op_t *ops = realloc(program->ops, capacity * sizeof(cheat_op_t));
+        if (ops == NULL)
+            return NULL;
+        program->ops = ops;
+        program->capacity = capacity;
+    }
 
-static int address_equal_to_8bit(unsigned int address, unsigned char value)
-{
-    unsigned char value_read;
-    value_read = *(unsigned char *)((rdramb + ((address & 0xFFFFFF)^S8)));
-    return value_read == value;
+    memset(&program->ops[program->count], 0, sizeof(cheat_op_t));
+    return &program->ops[program->count++];
 }
 
-static int address_equal_to_16bit(unsigned int address, unsigned short value)
+static void cheat_program_free(cheat_program_t *program)
 {
-    unsigned short value_read;
-    value_read = *(unsigned short *)((rdramb + ((address & 0xFFFFFF)^S16)));
-    return value_read == value;
+    free(program->ops);
+    memset(program, 0, sizeof(*program));
 }
 
-// individual application - returns 0 if we are supposed to skip the next cheat
-// (only really used on conditional codes)
-static int execute_cheat(unsigned int address, unsigned short value, int *old_value)
+// compiles the effect execute_cheat() used to have for a write code; codes
+// that do nothing when executed (conditionals, unknown types) return NULL
+static cheat_op_t *compile_write(cheat_program_t *program, unsigned int address,
+                                 unsigned short value, int *old_value)
 {
+    cheat_op_t *op;
+    unsigned char *ptr;
+    int kind;
+
     switch (address & 0xFF000000)
     {
         case 0x80000000:
@@ -103,41 +167,289 @@ static int execute_cheat(unsigned int address, unsigned short value, int *old_va
         case 0xA0000000:
         case 0xA8000000:
         case 0xF0000000:
-            // if pointer to old value is valid and uninitialized, write current value to it
-            if(old_value && (*old_value == CHEAT_CODE_MAGIC_VALUE))
-                *old_value = (int) read_address_8bit(address);
-            update_address_8bit(address,(unsigned char) value);
-            return 1;
+            kind = CHEAT_OP_WRITE8;
+            ptr = cheat_pointer_8bit(address);
+            break;
         case 0x81000000:
         case 0x89000000:
         case 0xA1000000:
         case 0xA9000000:
         case 0xF1000000:
-            // if pointer to old value is valid and uninitialized, write current value to it
-            if(old_value && (*old_value == CHEAT_CODE_MAGIC_VALUE))
-                *old_value = (int) read_address_16bit(address);
-            update_address_16bit(address,value);
-            return 1;
+            kind = CHEAT_OP_WRITE16;
+            ptr = cheat_pointer_16bit(address);
+            break;
+        case 0xEE000000:
+            // most likely, this doesnt do anything.
+            kind = CHEAT_OP_EE;
+            ptr = rdramb;
+            old_value = NULL;
+            break;
+        default:
+            return NULL;
+    }
+
+    if (ptr == NULL || (op = cheat_program_append(program)) == NULL)
+        return NULL;
+
+    op->kind = kind;
+    op->ptr = ptr;
+    op->value = value;
+    op->old_value = old_value;
+    return op;
+}
+
+// attaches the test of a Dx conditional code to the code it guards; returns 0
+// if the condition can never hold
+static int compile_condition(cheat_op_t *op, unsigned int address, unsigned short value)
+{
+    switch (address & 0xFF000000)
+    {
         case 0xD0000000:
         case 0xD8000000:
-            return address_equal_to_8bit(address,(unsigned char) value);
+            op->cond = CHEAT_COND_EQ8;
+            op->cond_ptr = cheat_pointer_8bit(address);
+            break;
         case 0xD1000000:
         case 0xD9000000:
-            return address_equal_to_16bit(address,value);
+            op->cond = CHEAT_COND_EQ16;
+            op->cond_ptr = cheat_pointer_16bit(address);
+            break;
         case 0xD2000000:
         case 0xDB000000:
-            return !(address_equal_to_8bit(address,(unsigned char) value));
+            op->cond = CHEAT_COND_NE8;
+            op->cond_ptr = cheat_pointer_8bit(address);
+            break;
         case 0xD3000000:
         case 0xDA000000:
-            return !(address_equal_to_16bit(address,value));
-        case 0xEE000000:
-            // most likely, this doesnt do anything.
-            execute_cheat(0xF1000318, 0x0040, NULL);
-            execute_cheat(0xF100031A, 0x0000, NULL);
-            return 1;
+            op->cond = CHEAT_COND_NE16;
+            op->cond_ptr = cheat_pointer_16bit(address);
+            break;
         default:
+            // other conditional codes always evaluate to true
             return 1;
     }
+
+    op->cond_value = value;
+    return op->cond_ptr != NULL;
+}
+
+static void compile_vi_codes(cheat_t *cheat)
+{
+    cheat_code_t *code;
+    struct list_head *next;
+
+    list_for_each_entry(code, &cheat->cheat_codes, cheat_code_t, list) {
+        // conditional cheat codes guard the code that follows them
+        if ((code->address & 0xF0000000) == 0xD0000000)
+        {
+            cheat_code_t *guarded;
+            cheat_op_t *op;
+
+            next = code->list.next;
+            if (next == &cheat->cheat_codes)
+                break;
+            guarded = list_entry(next, cheat_code_t, list);
+
+            op = compile_write(&vi_program, guarded->address, guarded->value, &guarded->old_value);
+            if (op != NULL)
+            {
+                // if code needs GS button pressed and it's not, skip it
+                op->gs_button = cheat_is_gs_conditional(code->address);
+                if (!compile_condition(op, code->address, code->value))
+                    vi_program.count--;
+            }
+
+            code = guarded;
+        }
+        // GS button triggers cheat code
+        else if ((code->address & 0xFF000000) == 0x88000000 ||
+                 (code->address & 0xFF000000) == 0x89000000 ||
+                 (code->address & 0xFF000000) == 0xA8000000 ||
+                 (code->address & 0xFF000000) == 0xA9000000)
+        {
+            cheat_op_t *op = compile_write(&vi_program, code->address, code->value, NULL);
+            if (op != NULL)
+                op->gs_button = 1;
+        }
+        // normal cheat code, excluding boot-time cheat codes
+        else if ((code->address & 0xF0000000) != 0xF0000000)
+        {
+            compile_write(&vi_program, code->address, code->value, &code->old_value);
+        }
+    }
+}
+
+// set memory back to old values when a cheat that was applied is disabled
+static void compile_restore_codes(cheat_t *cheat)
+{
+    cheat_code_t *code;
+
+    list_for_each_entry(code, &cheat->cheat_codes, cheat_code_t, list) {
+        cheat_op_t *op;
+        if ((code->address & 0xFF000000) == 0xEE000000)
+            continue;
+        if ((op = compile_write(&vi_program, code->address, 0, &code->old_value)) == NULL)
+            continue;
+        op->kind = (op->kind == CHEAT_OP_WRITE8) ? CHEAT_OP_RESTORE8 : CHEAT_OP_RESTORE16;
+        vi_program.has_restores = 1;
+    }
+}
+
+static void compile_cheats(void)
+{
+    cheat_t *cheat;
+    cheat_code_t *code;
+
+    boot_program.count = 0;
+    vi_program.count = 0;
+    vi_program.has_restores = 0;
+
+    list_for_each_entry(cheat, &active_cheats, cheat_t, list) {
+        if (cheat->enabled)
+        {
+            cheat->was_enabled = 1;
+
+            // code should only be written once at boot time
+            list_for_each_entry(code, &cheat->cheat_codes, cheat_code_t, list) {
+                if ((code->address & 0xF0000000) == 0xF0000000)
+                    compile_write(&boot_program, code->address, code->value, &code->old_value);
+            }
+            compile_vi_codes(cheat);
+        }
+        else if (cheat->was_enabled)
+        {
+            compile_restore_codes(cheat);
+        }
+    }
+
+    cheats_dirty = 0;
+}
+
+// game-specific fixes that are always applied at VI time
+static void compile_builtin_cheats(void)
+{
+    unsigned int crc1 = sl(ROM_HEADER.CRC1), crc2 = sl(ROM_HEADER.CRC2);
+
+    if (builtin_valid && builtin_crc1 == crc1 && builtin_crc2 == crc2)
+        return;
+
+    builtin_program.count = 0;
+    builtin_crc1 = crc1;
+    builtin_crc2 = crc2;
+    builtin_valid = 1;
+
+    // If game is Zelda OOT, apply subscreen delay fix
+    if (strncmp((char *)ROM_HEADER.Name, "THE LEGEND OF ZELDA", 19) == 0) {
+        if (crc1 == 0xEC7011B7 && crc2 == 0x7616D72B) {
+            // Legend of Zelda, The - Ocarina of Time (U) + (J) (V1.0)
+            compile_write(&builtin_program, 0x801DA5CB, 0x0002, NULL);
+        } else if (crc1 == 0xD43DA81F && crc2 == 0x021E1E19) {
+            // Legend of Zelda, The - Ocarina of Time (U) + (J) (V1.1)
+            compile_write(&builtin_program, 0x801DA78B, 0x0002, NULL);
+        } else if (crc1 == 0x693BA2AE && crc2 == 0xB7F14E9F) {
+            // Legend of Zelda, The - Ocarina of Time (U) + (J) (V1.2)
+            compile_write(&builtin_program, 0x801DAE8B, 0x0002, NULL);
+        } else if (crc1 == 0xB044B569 && crc2 == 0x373C1985) {
+            // Legend of Zelda, The - Ocarina of Time (E) (V1.0)
+            compile_write(&builtin_program, 0x801D860B, 0x0002, NULL);
+        } else if (crc1 == 0xB2055FBD && crc2 == 0x0BAB4E0C) {
+            // Legend of Zelda, The - Ocarina of Time (E) (V1.1)
+            compile_write(&builtin_program, 0x801D864B, 0x0002, NULL);
+        } else {
+            // Legend of Zelda, The - Ocarina of Time Master Quest
+            compile_write(&builtin_program, 0x801D8F4B, 0x0002, NULL);
+        }
+    }
+
+    // If game is Pokemon Snap, apply controller fix
+    // (the D1 codes these fixes used to start with never guarded anything)
+    if (strncmp((char *)ROM_HEADER.Name, "POKEMON SNAP", 12) == 0) {
+       if ((crc1 == 0xCA12B547 && crc2 == 0x71FA4EE4) ||   // Pokemon Snap (U)
+           (crc1 == 0x7BB18D40 && crc2 == 0x83138559) ||   // Pokemon Snap (A)
+           (crc1 == 0x39119872 && crc2 == 0x07722E9F)) {   // Pokemon Snap Station (U)
+          compile_write(&builtin_program, 0x80382D0F, 0x0000, NULL);
+       }
+       else if ((crc1 == 0xEC0F690D && crc2 == 0x32A7438C) ||   // Pokemon Snap (J) (V1.0)
+                (crc1 == 0xE0044E9E && crc2 == 0xCD659D0D)) {   // Pokemon Snap (J) (V1.1)
+          compile_write(&builtin_program, 0x8036D21F, 0x0000, NULL);
+       }
+       else if (crc1 == 0x5753720D && crc2 == 0x2A8A884D) {
+          // Pokemon Snap (G)
+          compile_write(&builtin_program, 0x80381BCF, 0x0000, NULL);
+       }
+       else {
+          // Pokemon Snap (E) + (F) + (I) + (S)
+          compile_write(&builtin_program, 0x80381BEF, 0x0000, NULL);
+       }
+    }
+}
+
+static void run_cheat_program(const cheat_program_t *program)
+{
+    const cheat_op_t *op = program->ops;
+    const cheat_op_t *end = op + program->count;
+    int gs_active = event_gameshark_active();
+
+    for (; op < end; op++)
+    {
+        if (op->gs_button && !gs_active)
+            continue;
+
+        switch (op->cond)
+        {
+            case CHEAT_COND_EQ8:
+                if (*op->cond_ptr != (unsigned char) op->cond_value)
+                    continue;
+                break;
+            case CHEAT_COND_EQ16:
+                if (*(unsigned short *)op->cond_ptr != op->cond_value)
+                    continue;
+                break;
+            case CHEAT_COND_NE8:
+                if (*op->cond_ptr == (unsigned char) op->cond_value)
+                    continue;
+                break;
+            case CHEAT_COND_NE16:
+                if (*(unsigned short *)op->cond_ptr == op->cond_value)
+                    continue;
+                break;
+            default:
+                break;
+        }
+
+        switch (op->kind)
+        {
+            case CHEAT_OP_WRITE8:
+                // if pointer to old value is valid and uninitialized, write current value to it
+                if (op->old_value && *op->old_value == CHEAT_CODE_MAGIC_VALUE)
+                    *op->old_value = (int) *op->ptr;
+                *op->ptr = (unsigned char) op->value;
+                break;
+            case CHEAT_OP_WRITE16:
+                if (op->old_value && *op->old_value == CHEAT_CODE_MAGIC_VALUE)
+                    *op->old_value = (int) *(unsigned short *)op->ptr;
+                *(unsigned short *)op->ptr = op->value;
+                break;
+            case CHEAT_OP_EE:
+                *(unsigned short *)(op->ptr + (0x318 ^ S16)) = 0x0040;
+                *(unsigned short *)(op->ptr + (0x31A ^ S16)) = 0x0000;
+                break;
+            case CHEAT_OP_RESTORE8:
+                if (*op->old_value != CHEAT_CODE_MAGIC_VALUE)
+                {
+                    *op->ptr = (unsigned char) *op->old_value;
+                    *op->old_value = CHEAT_CODE_MAGIC_VALUE;
+                }
+                break;
+            case CHEAT_OP_RESTORE16:
+                if (*op->old_value != CHEAT_CODE_MAGIC_VALUE)
+                {
+                    *(unsigned short *)op->ptr = (unsigned short) *op->old_value;
+                    *op->old_value = CHEAT_CODE_MAGIC_VALUE;
+                }
+                break;
+        }
+    }
 }
 
 static cheat_t *find_or_create_cheat(const char *name)
@@ -186,263 +498,47 @@ void cheat_init(void)
 
 void cheat_uninit(void)
 {
+    cheat_delete_all();
+    cheat_program_free(&builtin_program);
+    builtin_valid = 0;
 }
 
 void cheat_apply_cheats(int entry)
 {
     cheat_t *cheat;
-    cheat_code_t *code;
-    int skip;
-    int execute_next;
-
-#if 0
-	// If game is Pilotwing 64, apply shadow fix
-	// Cheatcodes taken from Laughy of emutalk.net
-	// Doesn't work for japanese version 9cc4801 e42ee491 and only first rom has actually been tested
-	if (strncmp((char *)ROM_HEADER.Name, "Pilot Wings64", 13) == 0 && entry == ENTRY_VI) {
-		if ((sl(ROM_HEADER.CRC1) == 0xC851961C && sl(ROM_HEADER.CRC2) == 0x78FCAAFA) ||
-		(sl(ROM_HEADER.CRC1) == 0x1AA05AD5 && sl(ROM_HEADER.CRC2) == 0x46F52D80) ||
-		(sl(ROM_HEADER.CRC1) == 0x09CC4801 && sl(ROM_HEADER.CRC2) == 0xE42EE491) ||
-		(sl(ROM_HEADER.CRC1) == 0x70478A35 && sl(ROM_HEADER.CRC2) == 0xF9897402)){
-			execute_cheat(0xD0263B41, 0x0012, NULL);
-			execute_cheat(0x80263B41, 0x00FF, NULL);
-			execute_cheat(0xD02643C1, 0x0012, NULL);
-			execute_cheat(0x802643C1, 0x00FF, NULL);
-			execute_cheat(0xD0264581, 0x0012, NULL);
-			execute_cheat(0x80264581, 0x00FF, NULL);
-			execute_cheat(0xD0263FC1, 0x0012, NULL);
-			execute_cheat(0x80263FC1, 0x00FF, NULL);
-			execute_cheat(0xD0263E81, 0x0012, NULL);
-			execute_cheat(0x80263E81, 0x00FF, NULL);
-			execute_cheat(0xD0263E41, 0x0012, NULL);
-			execute_cheat(0x80263E41, 0x00FF, NULL);
-			execute_cheat(0xD0264181, 0x0012, NULL);
-			execute_cheat(0x80264181, 0x00FF, NULL);
-			execute_cheat(0xD0264381, 0x0012, NULL);
-			execute_cheat(0x80264381, 0x00FF, NULL);
-			execute_cheat(0xD0264281, 0x0012, NULL);
-			execute_cheat(0x80264281, 0x00FF, NULL);
-			execute_cheat(0xD02639C1, 0x0020, NULL);
-			execute_cheat(0x802639C1, 0x00FF, NULL);
-			execute_cheat(0xD02640C1, 0x0020, NULL);
-			execute_cheat(0x802640C1, 0x00FF, NULL);
-			execute_cheat(0xD0264541, 0x0020, NULL);
-			execute_cheat(0x80264541, 0x00FF, NULL);
-			execute_cheat(0xD0264201, 0x0020, NULL);
-			execute_cheat(0x80264201, 0x00FF, NULL);
-			execute_cheat(0xD0263D81, 0x0020, NULL);
-			execute_cheat(0x80263D81, 0x00FF, NULL);
-			execute_cheat(0xD0263F81, 0x0020, NULL);
-			execute_cheat(0x80263F81, 0x00FF, NULL);
-			execute_cheat(0xD0263A81, 0x0029, NULL);
-			execute_cheat(0x80263A81, 0x00FF, NULL);
-			execute_cheat(0xD0264101, 0x0029, NULL);
-			execute_cheat(0x80264101, 0x00FF, NULL);
-			execute_cheat(0xD0263E01, 0x0029, NULL);
-			execute_cheat(0x80263E01, 0x00FF, NULL);
-			execute_cheat(0xD0264201, 0x0029, NULL);
-			execute_cheat(0x80264201, 0x00FF, NULL);
-			execute_cheat(0xD0264441, 0x0029, NULL);
-			execute_cheat(0x80264441, 0x00FF, NULL);
-			execute_cheat(0xD0263F81, 0x0029, NULL);
-			execute_cheat(0x80263F81, 0x00FF, NULL);
-			execute_cheat(0xD02647C1, 0x0029, NULL);
-			execute_cheat(0x802647C1, 0x00FF, NULL);
-			execute_cheat(0xD0264941, 0x0029, NULL);
-			execute_cheat(0x80264941, 0x00FF, NULL);
-			execute_cheat(0xD0264281, 0x0029, NULL);
-			execute_cheat(0x80264281, 0x00FF, NULL);
-			execute_cheat(0xD02639C1, 0x003D, NULL);
-			execute_cheat(0x802639C1, 0x00FF, NULL);
-			execute_cheat(0xD02641C1, 0x003D, NULL);
-			execute_cheat(0x802641C1, 0x00FF, NULL);
-			execute_cheat(0xD0263D41, 0x003D, NULL);
-			execute_cheat(0x80263D41, 0x00FF, NULL);
-			execute_cheat(0xD0263EC1, 0x003D, NULL);
-			execute_cheat(0x80263EC1, 0x00FF, NULL);
-			execute_cheat(0xD0263F01, 0x003D, NULL);
-			execute_cheat(0x80263F01, 0x00FF, NULL);
-		}
-	}
-#endif
-
-#if 0
-   if ((
-         strncmp((char *)ROM_HEADER.Name, (const char *)"BANJO KAZOOIE 2", 15) == 0
-         || strncmp((char *)ROM_HEADER.Name, (const char *)"BANJO TOOIE", 11) == 0
-         ) && entry == ENTRY_VI)
-   {
-      execute_cheat(0x8107913C, 0x0000, NULL);
-      execute_cheat(0x8107913E, 0x0000, NULL);
-   }
-#endif
 
-    // If game is Zelda OOT, apply subscreen delay fix
-    if (strncmp((char *)ROM_HEADER.Name, "THE LEGEND OF ZELDA", 19) == 0 && entry == ENTRY_VI) {
-        if (sl(ROM_HEADER.CRC1) == 0xEC7011B7 && sl(ROM_HEADER.CRC2) == 0x7616D72B) {
-            // Legend of Zelda, The - Ocarina of Time (U) + (J) (V1.0)
-            execute_cheat(0x801DA5CB, 0x0002, NULL);
-        } else if (sl(ROM_HEADER.CRC1) == 0xD43DA81F && sl(ROM_HEADER.CRC2) == 0x021E1E19) {
-            // Legend of Zelda, The - Ocarina of Time (U) + (J) (V1.1)
-            execute_cheat(0x801DA78B, 0x0002, NULL);
-        } else if (sl(ROM_HEADER.CRC1) == 0x693BA2AE && sl(ROM_HEADER.CRC2) == 0xB7F14E9F) {
-            // Legend of Zelda, The - Ocarina of Time (U) + (J) (V1.2)
-            execute_cheat(0x801DAE8B, 0x0002, NULL);
-        } else if (sl(ROM_HEADER.CRC1) == 0xB044B569 && sl(ROM_HEADER.CRC2) == 0x373C1985) {
-            // Legend of Zelda, The - Ocarina of Time (E) (V1.0)
-            execute_cheat(0x801D860B, 0x0002, NULL);
-        } else if (sl(ROM_HEADER.CRC1) == 0xB2055FBD && sl(ROM_HEADER.CRC2) == 0x0BAB4E0C) {
-            // Legend of Zelda, The - Ocarina of Time (E) (V1.1)
-            execute_cheat(0x801D864B, 0x0002, NULL);
-        } else {
-            // Legend of Zelda, The - Ocarina of Time Master Quest
-            execute_cheat(0x801D8F4B, 0x0002, NULL);
-        }
+    if (entry == ENTRY_VI)
+    {
+        compile_builtin_cheats();
+        run_cheat_program(&builtin_program);
     }
 
-    // If game is Pokemon Snap, apply controller fix
-    if (strncmp((char *)ROM_HEADER.Name, "POKEMON SNAP", 12) == 0 && entry == ENTRY_VI) {
-       if (sl(ROM_HEADER.CRC1) == 0xCA12B547 && sl(ROM_HEADER.CRC2) == 0x71FA4EE4) {
-          // Pokemon Snap (U)
-          execute_cheat(0xD1382D1C, 0x0002, NULL);
-          execute_cheat(0x80382D0F, 0x0000, NULL);
-       }
-       else if (sl(ROM_HEADER.CRC1) == 0x7BB18D40 && sl(ROM_HEADER.CRC2) == 0x83138559) {
-          // Pokemon Snap (A)
-          execute_cheat(0xD1382D1C, 0x0002, NULL);
-          execute_cheat(0x80382D0F, 0x0000, NULL);
-       }
-       else if (sl(ROM_HEADER.CRC1) == 0x39119872 && sl(ROM_HEADER.CRC2) == 0x07722E9F) {
-          // Pokemon Snap Station (U)
-          execute_cheat(0xD1382D1C, 0x0002, NULL);
-          execute_cheat(0x80382D0F, 0x0000, NULL);
-       }
-       else if (sl(ROM_HEADER.CRC1) == 0xEC0F690D && sl(ROM_HEADER.CRC2) == 0x32A7438C) {
-          // Pokemon Snap (J) (V1.0)
-          execute_cheat(0xD136D22C, 0x802A, NULL);
-          execute_cheat(0x8036D21F, 0x0000, NULL);
-       }
-       else if (sl(ROM_HEADER.CRC1) == 0xE0044E9E && sl(ROM_HEADER.CRC2) == 0xCD659D0D) {
-          // Pokemon Snap (J) (V1.1)
-          execute_cheat(0xD136D22C, 0x802A, NULL);
-          execute_cheat(0x8036D21F, 0x0000, NULL);
-       }
-       else if (sl(ROM_HEADER.CRC1) == 0x5753720D && sl(ROM_HEADER.CRC2) == 0x2A8A884D) {
-          // Pokemon Snap (G)
-          execute_cheat(0xD1381BDC, 0x802C, NULL);
-          execute_cheat(0x80381BCF, 0x0000, NULL);
-       }
-       else {
-          // Pokemon Snap (E) + (F) + (I) + (S)
-          execute_cheat(0xD1381BFC, 0x802C, NULL);
-          execute_cheat(0x80381BEF, 0x0000, NULL);
-       }
-    }
-    
     if (list_empty(&active_cheats))
         return;
 
-    list_for_each_entry(cheat, &active_cheats, cheat_t, list) {
-        if (cheat->enabled)
-        {
-            cheat->was_enabled = 1;
-            switch(entry)
-            {
-                case ENTRY_BOOT:
-                    list_for_each_entry(code, &cheat->cheat_codes, cheat_code_t, list) {
-                        // code should only be written once at boot time
-                        if((code->address & 0xF0000000) == 0xF0000000)
-                            execute_cheat(code->address, code->value, &code->old_value);
-                    }
-                    break;
-                case ENTRY_VI:
-                    skip = 0;
-                    execute_next = 0;
-                    list_for_each_entry(code, &cheat->cheat_codes, cheat_code_t, list) {
-                        if (skip) {
-                            skip = 0;
-                            continue;
-                        }
-                        if (execute_next) {
-                            execute_next = 0;
-
-                            // if code needs GS button pressed, don't save old value
-                            if(((code->address & 0xFF000000) == 0xD8000000 ||
-                                (code->address & 0xFF000000) == 0xD9000000 ||
-                                (code->address & 0xFF000000) == 0xDA000000 ||
-                                (code->address & 0xFF000000) == 0xDB000000))
-                               execute_cheat(code->address, code->value, NULL);
-                            else
-                               execute_cheat(code->address, code->value, &code->old_value);
-
-                            continue;
-                        }
-                        // conditional cheat codes
-                        if((code->address & 0xF0000000) == 0xD0000000)
-                        {
-                            // if code needs GS button pressed and it's not, skip it
-                            if(((code->address & 0xFF000000) == 0xD8000000 ||
-                                (code->address & 0xFF000000) == 0xD9000000 ||
-                                (code->address & 0xFF000000) == 0xDA000000 ||
-                                (code->address & 0xFF000000) == 0xDB000000) &&
-                               !event_gameshark_active())
-                            {
-                                // skip next code
-                                skip = 1;
-                                continue;
-                            }
-
-                            if (execute_cheat(code->address, code->value, NULL)) {
-                                // if condition true, execute next cheat code
-                                execute_next = 1;
-                            } else {
-                                // if condition false, skip next code
-                                skip = 1;
-                                continue;
-                            }
-                        }
-                        // GS button triggers cheat code
-                        else if((code->address & 0xFF000000) == 0x88000000 ||
-                                (code->address & 0xFF000000) == 0x89000000 ||
-                                (code->address & 0xFF000000) == 0xA8000000 ||
-                                (code->address & 0xFF000000) == 0xA9000000)
-                        {
-                            if(event_gameshark_active())
-                                execute_cheat(code->address, code->value, NULL);
-                        }
-                        // normal cheat code
-                        else
-                        {
-                            // exclude boot-time cheat codes
-                            if((code->address & 0xF0000000) != 0xF0000000)
-                                execute_cheat(code->address, code->value, &code->old_value);
-                        }
-                    }
-                    break;
-                default:
-                    break;
-            }
-        }
-        // if cheat was enabled, but is now disabled, restore old memory values
-        else if (cheat->was_enabled)
-        {
-            cheat->was_enabled = 0;
-            switch(entry)
+    if (cheats_dirty)
+        compile_cheats();
+
+    switch (entry)
+    {
+        case ENTRY_BOOT:
+            run_cheat_program(&boot_program);
+            break;
+        case ENTRY_VI:
+            run_cheat_program(&vi_program);
+
+            // restores only run once, drop them from the program
+            if (vi_program.has_restores)
             {
-                case ENTRY_VI:
-                    list_for_each_entry(code, &cheat->cheat_codes, cheat_code_t, list) {
-                        // set memory back to old value and clear saved copy of old value
-                        if(code->old_value != CHEAT_CODE_MAGIC_VALUE)
-                        {
-                            execute_cheat(code->address, code->old_value, NULL);
-                            code->old_value = CHEAT_CODE_MAGIC_VALUE;
-                        }
-                    }
-                    break;
-                default:
-                    break;
+                list_for_each_entry(cheat, &active_cheats, cheat_t, list) {
+                    if (!cheat->enabled)
+                        cheat->was_enabled = 0;
+                }
+                cheats_dirty = 1;
             }
-        }
+            break;
+        default:
+            break;
     }
 }
 
@@ -452,6 +548,10 @@ void cheat_delete_all(void)
     cheat_t *cheat, *safe_cheat;
     cheat_code_t *code, *safe_code;
 
+    cheats_dirty = 1;
+    cheat_program_free(&boot_program);
+    cheat_program_free(&vi_program);
+
     if (list_empty(&active_cheats))
         return;
 
@@ -478,6 +578,7 @@ int cheat_set_enabled(const char *name, int enabled)
         if (strcmp(name, cheat->name) == 0)
         {
             cheat->enabled = enabled;
+            cheats_dirty = 1;
             return 1;
         }
     }
@@ -495,6 +596,8 @@ int cheat_add_new(const char *name, m64p_cheat_code *code_list, int num_codes)
     if (cheat == NULL)
         return 0;
 
+    cheats_dirty = 1;
+
     cheat->enabled = 1; /* default for new cheats is enabled */
 
     for (i = 0; i < num_codes; i++)
@@ -54,6 +54,9 @@
 #include "r4300/r4300.h"
 #include "r4300/interupt.h"
 #include "r4300/reset.h"
+#ifdef NEW_DYNAREC
+#include "r4300/new_dynarec/new_dynarec.h"
+#endif
 
 #ifdef DBG
 #include "debugger/dbg_types.h"
@@ -70,6 +73,7 @@ m64p_frame_callback g_FrameCallback = NULL;
 
 int         g_MemHasBeenBSwapped = 0;   // store byte-swapped flag so we don't swap twice when re-playing game
 int         g_EmulatorRunning = 0;      // need separate boolean to tell if emulator is running, since --nogui doesn't use a thread
+int         g_LowMemory = 0;            // use smaller emulator buffers, for devices with little RAM
 
 /** static (local) variables **/
 static int   l_CurrentFrame = 0;         // frame counter
@@ -138,6 +142,8 @@ int main_set_core_defaults(void)
     ConfigSetDefaultBool(g_CoreConfig, "EnableDebugger", 0, "Activate the R4300 debugger when ROM execution begins, if core was built with Debugger support");
     ConfigSetDefaultInt(g_CoreConfig, "CountPerOp", 0, "Force number of cycles per emulated instruction.");
     ConfigSetDefaultBool(g_CoreConfig, "DelaySI", 1, "Delay interrupt after DMA SI read/write");
+    ConfigSetDefaultBool(g_CoreConfig, "LowMemory", 0, "Use smaller emulator buffers, for devices with little memory");
+    ConfigSetDefaultInt(g_CoreConfig, "DynarecCacheSize", 0, "Size of the dynamic recompiler's code cache in MB (4 to 32), or 0 for the default");
 
     if (bSaveConfig)
         ConfigSaveSection("Core");
@@ -284,11 +290,18 @@ m64p_error main_run(void)
 
     /* set some other core parameters based on the config file values */
     no_compiled_jump = ConfigGetParamBool(g_CoreConfig, "NoCompiledJump");
+    g_LowMemory = ConfigGetParamInt(g_CoreConfig, "LowMemory");
+#ifdef NEW_DYNAREC
+    new_dynarec_cache_mb = ConfigGetParamInt(g_CoreConfig, "DynarecCacheSize");
+#endif
     //count_per_op = ConfigGetParamInt(g_CoreConfig, "CountPerOp");
 
     if (count_per_op <= 0)
        count_per_op = 2;
 
+    // finish the background rom hash and database lookup before starting up
+    rom_resolve_settings();
+
     // initialize memory, and do byte-swapping if it's not been done yet
     if (g_MemHasBeenBSwapped == 0)
     {
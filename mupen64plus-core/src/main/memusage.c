@@ -0,0 +1,126 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - memusage.c                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "api/m64p_types.h"
+#include "api/callbacks.h"
+
+#include "main.h"
+#include "memusage.h"
+#include "rom.h"
+
+#include "memory/memory.h"
+#include "memory/tlb.h"
+#include "r4300/r4300.h"
+#ifdef NEW_DYNAREC
+#include "r4300/new_dynarec/new_dynarec.h"
+#endif
+
+size_t memusage_resident(const void *base, size_t size)
+{
+#if !defined(_WIN32)
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t start = (size_t) base & ~(page - 1);
+    size_t pages = ((size_t) base + size - start + page - 1) / page;
+    size_t i, resident = 0;
+    unsigned char *vec;
+
+    if (base == NULL || size == 0)
+        return 0;
+
+    vec = (unsigned char *) malloc(pages);
+    if (vec == NULL || mincore((void *) start, pages * page, (void *) vec) != 0)
+    {
+        free(vec);
+        return size;
+    }
+
+    for (i = 0; i < pages; i++)
+        if (vec[i] & 1)
+            resident += page;
+    free(vec);
+
+    return resident < size ? resident : size;
+#else
+    return (base == NULL) ? 0 : size;
+#endif
+}
+
+static void report(const char *subsystem, size_t allocated, size_t resident)
+{
+    DebugMessage(M64MSG_INFO, "Memory: %-20s %6u KB allocated, %6u KB resident",
+                 subsystem, (unsigned int) (allocated >> 10), (unsigned int) (resident >> 10));
+}
+
+void memusage_report(void)
+{
+    void *handler_tables[] = { readmem, readmemb, readmemh, readmemd,
+                               writemem, writememb, writememh, writememd };
+    unsigned int *const *reg_tables[] = { readrdramreg, readrspreg, readrsp, readmi,
+                                          readvi, readai, readpi, readri, readsi,
+                                          readdp, readdps };
+    size_t allocated, resident;
+    unsigned int i;
+
+    if (g_LowMemory)
+        DebugMessage(M64MSG_INFO, "Memory: low memory mode");
+
+    report("RDRAM", sizeof(rdram), memusage_resident(rdram, sizeof(rdram)));
+    report("ROM", rom_size, memusage_resident(rom, rom_size));
+
+    allocated = resident = 0;
+    for (i = 0; i < sizeof(handler_tables) / sizeof(handler_tables[0]); i++)
+    {
+        allocated += sizeof(readmem);
+        resident += memusage_resident(handler_tables[i], sizeof(readmem));
+    }
+    report("memory handlers", allocated, resident);
+
+    allocated = resident = 0;
+    for (i = 0; i < sizeof(reg_tables) / sizeof(reg_tables[0]); i++)
+    {
+        allocated += sizeof(readrdramreg);
+        resident += memusage_resident(reg_tables[i], sizeof(readrdramreg));
+    }
+    report("register tables", allocated, resident);
+
+    /* the TLB tables only hold allocated leaves, all of them in use */
+    report("TLB lookup", tlb_lut_allocated(), tlb_lut_allocated());
+
+    report("block tables", sizeof(blocks) + sizeof(invalid_code),
+           memusage_resident(blocks, sizeof(blocks)) +
+           memusage_resident(invalid_code, sizeof(invalid_code)));
+
+#ifdef NEW_DYNAREC
+    if (r4300emu == CORE_DYNAREC)
+    {
+        new_dynarec_memory_usage(&allocated, &resident);
+        report("dynarec", allocated, resident);
+        new_dynarec_compile_usage(&allocated, &resident);
+        report("dynarec compile tables", allocated, resident);
+    }
+#endif
+}
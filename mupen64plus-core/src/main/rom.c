@@ -24,6 +24,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <sys/stat.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 #define M64P_CORE_PROTOTYPES 1
 #include "api/m64p_types.h"
@@ -33,11 +39,13 @@
 
 #include "md5.h"
 #include "rom.h"
+#include "romdb.h"
 #include "main.h"
 #include "util.h"
 
 #include "memory/memory.h"
 #include "osal/preproc.h"
+#include "osal/thread.h"
 
 #include "../r4300/r4300.h"
 
@@ -80,52 +88,182 @@ static int is_valid_rom(const unsigned char *buffer)
         return 0;
 }
 
-/* If rom is a .v64 or .n64 image, byteswap or wordswap loadlength amount of
- * rom data to native .z64 before forwarding. Makes sure that data extraction
- * and MD5ing routines always deal with a .z64 image.
+/* Returns the image type of a rom whose first word passed is_valid_rom(). */
+static unsigned char rom_image_type(const unsigned char *buffer)
+{
+    if (buffer[0] == 0x37)
+        return V64IMAGE;
+    else if (buffer[0] == 0x40)
+        return N64IMAGE;
+    else
+        return Z64IMAGE;
+}
+
+/* Rom byte order conversion kernels. Each copies len bytes from src to dst
+ * (which may alias) while reordering every 32-bit word:
+ *   rom_copy_swap16: swap the bytes of each halfword    [BADC] <-> [ABCD]
+ *   rom_copy_swap32: reverse the bytes of each word     [DCBA] <-> [ABCD]
+ *   rom_copy_hswap:  swap the halfwords of each word    [CDAB] <-> [ABCD]
+ * A trailing partial word, if any, is copied unchanged.
  */
-static void swap_rom(unsigned char* localrom, unsigned char* imagetype, int loadlength)
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define ROM_SWAP_SIMD(shuf) \
+    { \
+        const __m128i mask = shuf; \
+        for (; i + 16 <= len; i += 16) \
+        { \
+            __m128i v = _mm_loadu_si128((const __m128i *)(src + i)); \
+            _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(v, mask)); \
+        } \
+    }
+#define ROM_SWAP16_SIMD ROM_SWAP_SIMD(_mm_set_epi8(14,15,12,13,10,11,8,9,6,7,4,5,2,3,0,1))
+#define ROM_SWAP32_SIMD ROM_SWAP_SIMD(_mm_set_epi8(12,13,14,15,8,9,10,11,4,5,6,7,0,1,2,3))
+#define ROM_HSWAP_SIMD  ROM_SWAP_SIMD(_mm_set_epi8(13,12,15,14,9,8,11,10,5,4,7,6,1,0,3,2))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ROM_SSE2_SWAP16(v) _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8))
+#define ROM_SSE2_HSWAP(v) \
+    _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2,3,0,1)), _MM_SHUFFLE(2,3,0,1))
+#define ROM_SWAP_SIMD(op) \
+    for (; i + 16 <= len; i += 16) \
+    { \
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i)); \
+        _mm_storeu_si128((__m128i *)(dst + i), op); \
+    }
+#define ROM_SWAP16_SIMD ROM_SWAP_SIMD(ROM_SSE2_SWAP16(v))
+#define ROM_SWAP32_SIMD ROM_SWAP_SIMD(ROM_SSE2_SWAP16(ROM_SSE2_HSWAP(v)))
+#define ROM_HSWAP_SIMD  ROM_SWAP_SIMD(ROM_SSE2_HSWAP(v))
+#elif defined(HAVE_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ROM_SWAP_SIMD(op) \
+    for (; i + 16 <= len; i += 16) \
+        vst1q_u8(dst + i, op(vld1q_u8(src + i)));
+#define ROM_NEON_HSWAP(v) vreinterpretq_u8_u16(vrev32q_u16(vreinterpretq_u16_u8(v)))
+#define ROM_SWAP16_SIMD ROM_SWAP_SIMD(vrev16q_u8)
+#define ROM_SWAP32_SIMD ROM_SWAP_SIMD(vrev32q_u8)
+#define ROM_HSWAP_SIMD  ROM_SWAP_SIMD(ROM_NEON_HSWAP)
+#else
+#define ROM_SWAP16_SIMD
+#define ROM_SWAP32_SIMD
+#define ROM_HSWAP_SIMD
+#endif
+
+static void rom_copy_tail(unsigned char *dst, const unsigned char *src, size_t i, size_t len)
 {
-    unsigned char temp;
-    int i;
+    if (dst != src)
+        for (; i < len; i++)
+            dst[i] = src[i];
+}
 
-    /* Btyeswap if .v64 image. */
-    if(localrom[0]==0x37)
-        {
-        *imagetype = V64IMAGE;
-        for (i = 0; i < loadlength; i+=2)
-            {
-            temp=localrom[i];
-            localrom[i]=localrom[i+1];
-            localrom[i+1]=temp;
-            }
-        }
-    /* Wordswap if .n64 image. */
-    else if(localrom[0]==0x40)
-        {
-        *imagetype = N64IMAGE;
-        for (i = 0; i < loadlength; i+=4)
-            {
-            temp=localrom[i];
-            localrom[i]=localrom[i+3];
-            localrom[i+3]=temp;
-            temp=localrom[i+1];
-            localrom[i+1]=localrom[i+2];
-            localrom[i+2]=temp;
-            }
-        }
+#ifdef M64P_BIG_ENDIAN
+static void rom_copy_swap16(unsigned char *dst, const unsigned char *src, size_t len)
+{
+    size_t i = 0;
+    ROM_SWAP16_SIMD
+    for (; i + 4 <= len; i += 4)
+    {
+        unsigned char b0 = src[i], b1 = src[i+1], b2 = src[i+2], b3 = src[i+3];
+        dst[i] = b1; dst[i+1] = b0; dst[i+2] = b3; dst[i+3] = b2;
+    }
+    rom_copy_tail(dst, src, i, len);
+}
+#endif
+
+static void rom_copy_swap32(unsigned char *dst, const unsigned char *src, size_t len)
+{
+    size_t i = 0;
+    ROM_SWAP32_SIMD
+    for (; i + 4 <= len; i += 4)
+    {
+        unsigned char b0 = src[i], b1 = src[i+1], b2 = src[i+2], b3 = src[i+3];
+        dst[i] = b3; dst[i+1] = b2; dst[i+2] = b1; dst[i+3] = b0;
+    }
+    rom_copy_tail(dst, src, i, len);
+}
+
+#ifndef M64P_BIG_ENDIAN
+static void rom_copy_hswap(unsigned char *dst, const unsigned char *src, size_t len)
+{
+    size_t i = 0;
+    ROM_HSWAP_SIMD
+    for (; i + 4 <= len; i += 4)
+    {
+        unsigned char b0 = src[i], b1 = src[i+1], b2 = src[i+2], b3 = src[i+3];
+        dst[i] = b2; dst[i+1] = b3; dst[i+2] = b0; dst[i+3] = b1;
+    }
+    rom_copy_tail(dst, src, i, len);
+}
+#endif
+
+/* Copies a .z64, .v64 or .n64 image straight into the word order the memory
+ * subsystem reads the cartridge in (native .z64 words run through sl()), so
+ * the rom is only touched once and init_memory() has nothing left to swap.
+ */
+static void copy_rom_native(unsigned char *dst, const unsigned char *src, unsigned char imagetype, size_t len)
+{
+#ifndef M64P_BIG_ENDIAN
+    if (imagetype == Z64IMAGE)
+        rom_copy_swap32(dst, src, len);
+    else if (imagetype == V64IMAGE)
+        rom_copy_hswap(dst, src, len);
+    else
+        memcpy(dst, src, len);
+#else
+    if (imagetype == V64IMAGE)
+        rom_copy_swap16(dst, src, len);
+    else if (imagetype == N64IMAGE)
+        rom_copy_swap32(dst, src, len);
     else
-        *imagetype = Z64IMAGE;
+        memcpy(dst, src, len);
+#endif
 }
 
-m64p_error open_rom(const unsigned char* romimage, unsigned int size)
+/* Converts len bytes of the loaded rom back to the .z64 byte order. */
+static void copy_rom_z64(unsigned char *dst, const unsigned char *src, size_t len)
 {
-    md5_state_t state;
+#ifndef M64P_BIG_ENDIAN
+    rom_copy_swap32(dst, src, len);
+#else
+    memcpy(dst, src, len);
+#endif
+}
+
+/* The MD5 of the rom is only needed for the database lookup, so it is hashed
+ * on a worker thread while the frontend carries on with plugin and core init.
+ * rom_resolve_settings() joins it before anything reads ROM_SETTINGS.
+ */
+static struct
+{
+    osal_thread *thread;
     md5_byte_t digest[16];
-    romdatabase_entry* entry;
+    int lookup_pending;
+    int resolved;
+} l_RomHash;
+
+static void rom_md5_job(void *arg)
+{
+    md5_state_t state;
+    unsigned char chunk[16384];
+    size_t offset;
+
+    (void)arg;
+    md5_init(&state);
+    for (offset = 0; offset < (size_t)rom_size; offset += sizeof(chunk))
+    {
+        size_t len = rom_size - offset;
+        if (len > sizeof(chunk))
+            len = sizeof(chunk);
+        copy_rom_z64(chunk, rom + offset, len);
+        md5_append(&state, (const md5_byte_t*)chunk, (int)len);
+    }
+    md5_finish(&state, l_RomHash.digest);
+}
+
+m64p_error open_rom(const unsigned char* romimage, unsigned int size)
+{
     char buffer[256];
     unsigned char imagetype;
-    int i;
 
     /* check input requirements */
     if (rom != NULL)
@@ -139,26 +277,24 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
         return M64ERR_INPUT_INVALID;
     }
 
-    /* Clear Byte-swapped flag, since ROM is now deleted. */
-    g_MemHasBeenBSwapped = 0;
-    /* allocate new buffer for ROM and copy into this buffer */
+    /* allocate new buffer for ROM and convert the image into it */
     rom_size = size;
     rom = (unsigned char *) malloc(size);
     if (rom == NULL)
         return M64ERR_NO_MEMORY;
-    memcpy(rom, romimage, size);
-    swap_rom(rom, &imagetype, rom_size);
+    imagetype = rom_image_type(romimage);
+    copy_rom_native(rom, romimage, imagetype, rom_size);
+    /* The copy is already in the byte order init_memory() would swap it to. */
+    g_MemHasBeenBSwapped = 1;
 
-    memcpy(&ROM_HEADER, rom, sizeof(m64p_rom_header));
+    copy_rom_z64((unsigned char *)&ROM_HEADER, rom, sizeof(m64p_rom_header));
 
-    /* Calculate MD5 hash  */
-    md5_init(&state);
-    md5_append(&state, (const md5_byte_t*)rom, rom_size);
-    md5_finish(&state, digest);
-    for ( i = 0; i < 16; ++i )
-        sprintf(buffer+i*2, "%02X", digest[i]);
-    buffer[32] = '\0';
-    strcpy(ROM_SETTINGS.MD5, buffer);
+    /* Calculate MD5 hash in the background */
+    l_RomHash.lookup_pending = 0;
+    l_RomHash.resolved = 0;
+    l_RomHash.thread = osal_thread_create(rom_md5_job, NULL);
+    if (l_RomHash.thread == NULL)
+        rom_md5_job(NULL);
 
     /* add some useful properties to ROM_PARAMS */
     ROM_PARAMS.systemtype = rom_country_code_to_system_type(ROM_HEADER.Country_code);
@@ -224,26 +360,9 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
        ROM_SETTINGS.rumble = 1;
        DebugMessage(M64MSG_INFO, "Neon Genesis Evangelion INI patches applied.");
     }
-    /* Look up this ROM in the .ini file and fill in goodname, etc */
-    else if ((entry=ini_search_by_md5(digest)) != NULL ||
-        (entry=ini_search_by_crc(sl(ROM_HEADER.CRC1),sl(ROM_HEADER.CRC2))) != NULL)
-    {
-        strncpy(ROM_SETTINGS.goodname, entry->goodname, 255);
-        ROM_SETTINGS.goodname[255] = '\0';
-        ROM_SETTINGS.savetype = entry->savetype;
-        ROM_SETTINGS.status = entry->status;
-        ROM_SETTINGS.players = entry->players;
-        ROM_SETTINGS.rumble = entry->rumble;
-    }
+    /* Look up this ROM in the .ini file once its MD5 is known */
     else
-    {
-        strcpy(ROM_SETTINGS.goodname, ROM_PARAMS.headername);
-        strcat(ROM_SETTINGS.goodname, " (unknown rom)");
-        ROM_SETTINGS.savetype = NONE;
-        ROM_SETTINGS.status = 0;
-        ROM_SETTINGS.players = 0;
-        ROM_SETTINGS.rumble = 0;
-    }
+        l_RomHash.lookup_pending = 1;
 
     /* count_per_op tweaks */
     // see - https://github.com/paulscode/mupen64plus-ae/commit/5d5ff6af92d035eb66ee281239b9f10c9ce0e866
@@ -292,11 +411,9 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
     }
 
     /* print out a bunch of info about the ROM */
-    DebugMessage(M64MSG_INFO, "Goodname: %s", ROM_SETTINGS.goodname);
     DebugMessage(M64MSG_INFO, "Headername: %s", ROM_PARAMS.headername);
     DebugMessage(M64MSG_INFO, "Name: %s", ROM_HEADER.Name);
     imagestring(imagetype, buffer);
-    DebugMessage(M64MSG_INFO, "MD5: %s", ROM_SETTINGS.MD5);
     DebugMessage(M64MSG_INFO, "CRC: %x %x", sl(ROM_HEADER.CRC1), sl(ROM_HEADER.CRC2));
     DebugMessage(M64MSG_INFO, "Imagetype: %s", buffer);
     DebugMessage(M64MSG_INFO, "Rom size: %d bytes (or %d Mb or %d Megabits)", rom_size, rom_size/1024/1024, rom_size/1024/1024*8);
@@ -320,11 +437,61 @@ m64p_error open_rom(const unsigned char* romimage, unsigned int size)
     return M64ERR_SUCCESS;
 }
 
+void rom_resolve_settings(void)
+{
+    romdatabase_entry* entry;
+    char buffer[33];
+    int i;
+
+    if (rom == NULL || l_RomHash.resolved)
+        return;
+
+    osal_thread_join(l_RomHash.thread);
+    l_RomHash.thread = NULL;
+    l_RomHash.resolved = 1;
+
+    for ( i = 0; i < 16; ++i )
+        sprintf(buffer+i*2, "%02X", l_RomHash.digest[i]);
+    buffer[32] = '\0';
+    strcpy(ROM_SETTINGS.MD5, buffer);
+
+    if (l_RomHash.lookup_pending)
+    {
+        l_RomHash.lookup_pending = 0;
+
+        if ((entry=ini_search_by_md5(l_RomHash.digest)) != NULL ||
+            (entry=ini_search_by_crc(sl(ROM_HEADER.CRC1),sl(ROM_HEADER.CRC2))) != NULL)
+        {
+            strncpy(ROM_SETTINGS.goodname, entry->goodname, 255);
+            ROM_SETTINGS.goodname[255] = '\0';
+            ROM_SETTINGS.savetype = entry->savetype;
+            ROM_SETTINGS.status = entry->status;
+            ROM_SETTINGS.players = entry->players;
+            ROM_SETTINGS.rumble = entry->rumble;
+        }
+        else
+        {
+            strcpy(ROM_SETTINGS.goodname, ROM_PARAMS.headername);
+            strcat(ROM_SETTINGS.goodname, " (unknown rom)");
+            ROM_SETTINGS.savetype = NONE;
+            ROM_SETTINGS.status = 0;
+            ROM_SETTINGS.players = 0;
+            ROM_SETTINGS.rumble = 0;
+        }
+    }
+
+    DebugMessage(M64MSG_INFO, "Goodname: %s", ROM_SETTINGS.goodname);
+    DebugMessage(M64MSG_INFO, "MD5: %s", ROM_SETTINGS.MD5);
+}
+
 m64p_error close_rom(void)
 {
     if (rom == NULL)
         return M64ERR_INVALID_STATE;
 
+    /* The MD5 job may still be reading the image. */
+    rom_resolve_settings();
+
     free(rom);
     rom = NULL;
 
@@ -396,10 +563,154 @@ static int rom_system_type_to_ai_dac_rate(m64p_system_type system_type)
 /********************************************************************************************/
 /* INI Rom database functions */
 
+static void romdatabase_release_binary(void)
+{
+    if (g_romdatabase.binary == NULL)
+        return;
+
+#if !defined(_WIN32)
+    if (g_romdatabase.binary_mapped)
+        munmap((void*)g_romdatabase.binary, g_romdatabase.binary_size);
+    else
+#endif
+        free((void*)g_romdatabase.binary);
+
+    g_romdatabase.binary = NULL;
+    g_romdatabase.binary_size = 0;
+    g_romdatabase.binary_mapped = 0;
+}
+
+/* Maps the precompiled database next to mupen64plus.ini, if there is one and
+ * it was built from the ini that is installed. Returns 0 to fall back to
+ * parsing the text database.
+ */
+static int romdatabase_open_binary(const char *ini_pathname)
+{
+    const char *pathname = ConfigGetSharedDataFilepath("mupen64plus.rdb");
+    const romdb_header *header;
+    const uint32_t *crc_index;
+    struct stat st, ini_st;
+    FILE *fPtr;
+    uint32_t i;
+
+    if (pathname == NULL || stat(pathname, &st) != 0 || st.st_size < (off_t)sizeof(romdb_header))
+        return 0;
+
+#if !defined(_WIN32)
+    {
+        int fd = open(pathname, O_RDONLY);
+        if (fd >= 0)
+        {
+            void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            close(fd);
+            if (map != MAP_FAILED)
+            {
+                g_romdatabase.binary = (const unsigned char*)map;
+                g_romdatabase.binary_mapped = 1;
+            }
+        }
+    }
+#endif
+    if (g_romdatabase.binary == NULL)
+    {
+        unsigned char *data = (unsigned char*)malloc(st.st_size);
+        if (data == NULL || (fPtr = fopen(pathname, "rb")) == NULL)
+        {
+            free(data);
+            return 0;
+        }
+        if (fread(data, 1, st.st_size, fPtr) != (size_t)st.st_size)
+        {
+            fclose(fPtr);
+            free(data);
+            return 0;
+        }
+        fclose(fPtr);
+        g_romdatabase.binary = data;
+    }
+    g_romdatabase.binary_size = st.st_size;
+
+    header = (const romdb_header*)g_romdatabase.binary;
+    if (memcmp(header->magic, ROMDB_MAGIC, sizeof(ROMDB_MAGIC)) != 0 ||
+        header->version != ROMDB_VERSION ||
+        header->byte_order != ROMDB_BYTE_ORDER ||
+        header->records_offset + (size_t)header->record_count * sizeof(romdb_record) > g_romdatabase.binary_size ||
+        header->crc_index_offset + (size_t)header->crc_count * sizeof(uint32_t) > g_romdatabase.binary_size ||
+        header->strings_size == 0 ||
+        header->strings_offset + (size_t)header->strings_size > g_romdatabase.binary_size ||
+        g_romdatabase.binary[header->strings_offset + header->strings_size - 1] != '\0')
+    {
+        DebugMessage(M64MSG_WARNING, "ROM Database: ignoring invalid '%s'", pathname);
+        romdatabase_release_binary();
+        return 0;
+    }
+
+    /* Lookups index records through the crc index without further checks. */
+    crc_index = (const uint32_t*)(g_romdatabase.binary + header->crc_index_offset);
+    for (i = 0; i < header->crc_count; i++)
+    {
+        if (crc_index[i] >= header->record_count)
+        {
+            DebugMessage(M64MSG_WARNING, "ROM Database: ignoring invalid '%s'", pathname);
+            romdatabase_release_binary();
+            return 0;
+        }
+    }
+
+    /* A stale index would hide edits to the text database, including those
+     * that keep its size. */
+    if (ini_pathname != NULL && stat(ini_pathname, &ini_st) == 0)
+    {
+        int stale = ini_st.st_size != header->source_size;
+
+        if (!stale && (fPtr = fopen(ini_pathname, "rb")) != NULL)
+        {
+            stale = romdb_hash_file(fPtr) != header->source_hash;
+            fclose(fPtr);
+        }
+        if (stale)
+        {
+            DebugMessage(M64MSG_WARNING, "ROM Database: '%s' is out of date, using text database", pathname);
+            romdatabase_release_binary();
+            return 0;
+        }
+    }
+
+    DebugMessage(M64MSG_INFO, "ROM Database: %s (%u entries)", pathname, header->record_count);
+    g_romdatabase.have_database = 1;
+    return 1;
+}
+
+static const romdb_record* romdatabase_binary_records(void)
+{
+    const romdb_header *header = (const romdb_header*)g_romdatabase.binary;
+    return (const romdb_record*)(g_romdatabase.binary + header->records_offset);
+}
+
+/* Returns the romdatabase_entry view of a record in the precompiled database. */
+static romdatabase_entry* romdatabase_binary_entry(const romdb_record *record)
+{
+    static romdatabase_entry entry;
+    const romdb_header *header = (const romdb_header*)g_romdatabase.binary;
+
+    entry.goodname = (char*)(g_romdatabase.binary + header->strings_offset +
+                             (record->goodname < header->strings_size ? record->goodname : 0));
+    memcpy(entry.md5, record->md5, 16);
+    entry.refmd5 = NULL;
+    entry.crc1 = record->crc1;
+    entry.crc2 = record->crc2;
+    entry.status = record->status;
+    entry.savetype = record->savetype;
+    entry.players = record->players;
+    entry.rumble = record->rumble;
+    return &entry;
+}
+
 void romdatabase_open(void)
 {
     FILE *fPtr;
     char buffer[256];
+    char ini_pathname[PATH_MAX];
     romdatabase_search* search = NULL;
     romdatabase_search** next_search;
 
@@ -411,6 +722,16 @@ void romdatabase_open(void)
     if(g_romdatabase.have_database)
         return;
 
+    /* Prefer the precompiled index; the text parser below is the fallback. */
+    if (pathname != NULL)
+    {
+        strncpy(ini_pathname, pathname, PATH_MAX - 1);
+        ini_pathname[PATH_MAX - 1] = '\0';
+        pathname = ini_pathname;
+    }
+    if (romdatabase_open_binary(pathname))
+        return;
+
     /* Open romdatabase. */
     if (pathname == NULL || (fPtr = fopen(pathname, "rb")) == NULL)
     {
@@ -589,6 +910,9 @@ void romdatabase_close(void)
     if (!g_romdatabase.have_database)
         return;
 
+    g_romdatabase.have_database = 0;
+    romdatabase_release_binary();
+
     while (g_romdatabase.list != NULL)
         {
         romdatabase_search* search = g_romdatabase.list->next_entry;
@@ -608,6 +932,25 @@ static romdatabase_entry* ini_search_by_md5(md5_byte_t* md5)
     if(!g_romdatabase.have_database)
         return NULL;
 
+    if (g_romdatabase.binary != NULL)
+    {
+        const romdb_header *header = (const romdb_header*)g_romdatabase.binary;
+        const romdb_record *records = romdatabase_binary_records();
+        unsigned int lo = 0, hi = header->record_count;
+
+        while (lo < hi)
+        {
+            unsigned int mid = (lo + hi) / 2;
+            if (memcmp(records[mid].md5, md5, 16) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < header->record_count && memcmp(records[lo].md5, md5, 16) == 0)
+            return romdatabase_binary_entry(&records[lo]);
+        return NULL;
+    }
+
     search = g_romdatabase.md5_lists[md5[0]];
 
     while (search != NULL && memcmp(search->entry.md5, md5, 16) != 0)
@@ -626,9 +969,32 @@ romdatabase_entry* ini_search_by_crc(unsigned int crc1, unsigned int crc2)
     if(!g_romdatabase.have_database) 
         return NULL;
 
+    if (g_romdatabase.binary != NULL)
+    {
+        const romdb_header *header = (const romdb_header*)g_romdatabase.binary;
+        const romdb_record *records = romdatabase_binary_records();
+        const uint32_t *crc_index = (const uint32_t*)(g_romdatabase.binary + header->crc_index_offset);
+        unsigned int lo = 0, hi = header->crc_count;
+
+        while (lo < hi)
+        {
+            unsigned int mid = (lo + hi) / 2;
+            const romdb_record *r = &records[crc_index[mid]];
+            if (r->crc1 < crc1 || (r->crc1 == crc1 && r->crc2 < crc2))
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo < header->crc_count &&
+            records[crc_index[lo]].crc1 == crc1 && records[crc_index[lo]].crc2 == crc2)
+            return romdatabase_binary_entry(&records[crc_index[lo]]);
+        return NULL;
+    }
+
     search = g_romdatabase.crc_lists[((crc1 >> 24) & 0xff)];
 
-    while (search != NULL && search->entry.crc1 != crc1 && search->entry.crc2 != crc2)
+    /* Both CRCs must match, as in the binary index above */
+    while (search != NULL && (search->entry.crc1 != crc1 || search->entry.crc2 != crc2))
         search = search->next_crc;
 
     if(search == NULL) 
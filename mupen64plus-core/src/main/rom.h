@@ -23,6 +23,8 @@
 #ifndef __ROM_H__
 #define __ROM_H__
 
+#include <stddef.h>
+
 #include "api/m64p_types.h"
 #include "md5.h"
 
@@ -30,6 +32,8 @@
 
 m64p_error open_rom(const unsigned char* romimage, unsigned int size);
 m64p_error close_rom(void);
+/* Waits for the rom MD5 and completes the database lookup that depends on it. */
+void rom_resolve_settings(void);
 
 extern unsigned char* rom;
 extern int rom_size;
@@ -127,6 +131,10 @@ typedef struct
     romdatabase_search* crc_lists[256];
     romdatabase_search* md5_lists[256];
     romdatabase_search* list;
+    /* Precompiled database (mupen64plus.rdb), used instead of the lists above */
+    const unsigned char* binary;
+    size_t binary_size;
+    int binary_mapped;
 } _romdatabase;
 
 void romdatabase_open(void);
@@ -0,0 +1,39 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - romdb.c                                                 *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include "romdb.h"
+
+uint32_t romdb_hash(uint32_t hash, const unsigned char *data, size_t len)
+{
+    while (len--)
+        hash = (hash ^ *data++) * 16777619u;
+    return hash;
+}
+
+uint32_t romdb_hash_file(FILE *f)
+{
+    unsigned char buffer[4096];
+    uint32_t hash = ROMDB_HASH_INIT;
+    size_t len;
+
+    while ((len = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        hash = romdb_hash(hash, buffer, len);
+    return hash;
+}
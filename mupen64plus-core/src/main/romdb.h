@@ -0,0 +1,80 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - romdb.h                                                 *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Layout of the precompiled rom database (mupen64plus.rdb), produced from
+ * mupen64plus.ini by tools/romdb_compile.c. The file is used in place, so
+ * everything is stored in host byte order with 4-byte alignment:
+ *
+ *   romdb_header
+ *   romdb_record[record_count]     sorted by md5
+ *   uint32_t[crc_count]            record indices sorted by (crc1, crc2)
+ *   char[strings_size]             NUL-terminated goodnames
+ *
+ * RefMD5 references are already resolved by the compiler. The core only uses
+ * the file if source_size and source_hash match the installed ini.
+ */
+
+#ifndef __ROMDB_H__
+#define __ROMDB_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define ROMDB_MAGIC      "M64+RDB"
+#define ROMDB_VERSION    2
+#define ROMDB_BYTE_ORDER 0x01020304
+
+typedef struct
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;     /* ROMDB_BYTE_ORDER as written by the compiler */
+    uint32_t source_size;    /* size of the mupen64plus.ini it was built from */
+    uint32_t record_count;
+    uint32_t crc_count;
+    uint32_t records_offset;
+    uint32_t crc_index_offset;
+    uint32_t strings_offset;
+    uint32_t strings_size;
+    uint32_t source_hash;    /* romdb_hash() of that mupen64plus.ini */
+} romdb_header;
+
+typedef struct
+{
+    uint8_t  md5[16];
+    uint32_t crc1;
+    uint32_t crc2;
+    uint32_t goodname;       /* offset into the string pool */
+    uint8_t  status;
+    uint8_t  savetype;
+    uint8_t  players;
+    uint8_t  rumble;
+} romdb_record;
+
+#define ROMDB_HASH_INIT  2166136261u
+
+/* FNV-1a, continued over consecutive blocks of the source ini */
+uint32_t romdb_hash(uint32_t hash, const unsigned char *data, size_t len);
+
+/* romdb_hash() of the rest of a file, which is left at its end */
+uint32_t romdb_hash_file(FILE *f);
+
+#endif /* __ROMDB_H__ */
@@ -44,6 +44,7 @@
 #include "r4300/interupt.h"
 #include "r4300/new_dynarec/new_dynarec.h"
 #include "osal/preproc.h"
+#include "plugin/ucode_id.h"
 
 static const char* savestate_magic = "M64+SAVE";
 static const int savestate_latest_version = 0x00010000;  /* 1.0 */
@@ -209,6 +210,7 @@ int savestates_load_m64p(const unsigned char *data, size_t size)
     COPYARRAY(SP_DMEM, curr, unsigned int, 0x1000/4);
     COPYARRAY(SP_IMEM, curr, unsigned int, 0x1000/4);
     COPYARRAY(PIF_RAM, curr, unsigned char, 0x40);
+    ucode_id_reset();
 
     flashram_info.use_flashram = GETDATA(curr, int);
     flashram_info.mode = GETDATA(curr, int);
@@ -216,8 +218,8 @@ int savestates_load_m64p(const unsigned char *data, size_t size)
     flashram_info.erase_offset = GETDATA(curr, unsigned int);
     flashram_info.write_pointer = GETDATA(curr, unsigned int);
 
-    COPYARRAY(tlb_LUT_r, curr, unsigned int, 0x100000);
-    COPYARRAY(tlb_LUT_w, curr, unsigned int, 0x100000);
+    tlb_lut_import(tlb_LUT_r, (unsigned char *) GETARRAY(curr, unsigned int, TLB_LUT_PAGES));
+    tlb_lut_import(tlb_LUT_w, (unsigned char *) GETARRAY(curr, unsigned int, TLB_LUT_PAGES));
 
     llbit = GETDATA(curr, unsigned int);
     COPYARRAY(reg, curr, long long int, 32);
@@ -477,8 +479,12 @@ int savestates_save_m64p(unsigned char *data, size_t size)
     PUTDATA(curr, unsigned int, flashram_info.erase_offset);
     PUTDATA(curr, unsigned int, flashram_info.write_pointer);
 
-    PUTARRAY(tlb_LUT_r, curr, unsigned int, 0x100000);
-    PUTARRAY(tlb_LUT_w, curr, unsigned int, 0x100000);
+    tlb_lut_export(tlb_LUT_r, curr);
+    to_little_endian_buffer(curr, sizeof(unsigned int), TLB_LUT_PAGES);
+    curr += TLB_LUT_PAGES*sizeof(unsigned int);
+    tlb_lut_export(tlb_LUT_w, curr);
+    to_little_endian_buffer(curr, sizeof(unsigned int), TLB_LUT_PAGES);
+    curr += TLB_LUT_PAGES*sizeof(unsigned int);
 
     PUTDATA(curr, unsigned int, llbit);
     PUTARRAY(reg, curr, long long int, 32);
@@ -43,6 +43,7 @@
 #include "main/main.h"
 #include "main/rom.h"
 #include "main/util.h"
+#include "plugin/ucode_id.h"
 
 int delay_si = 0;
 
@@ -186,6 +187,7 @@ void dma_pi_write(void)
                 rom[(((pi_register.pi_cart_addr_reg-0x10000000)&0x3FFFFFF)+i)^S8];
         }
     }
+    ucode_id_rdram_written(pi_register.pi_dram_addr_reg, longueur);
 
     // Set the RDRAM memory size when copying main ROM code
     // (This is just a convenient way to run this code once at the beginning)
@@ -280,6 +282,8 @@ void dma_sp_read(void)
         }
         dramaddr+=skip;
     }
+
+    ucode_id_rdram_written(sp_register.sp_dram_addr_reg & 0xffffff, count * (length + skip));
 }
 
 void dma_si_write(void)
@@ -48,6 +48,7 @@
 #include "main/rom.h"
 #include "osal/preproc.h"
 #include "plugin/plugin.h"
+#include "plugin/ucode_id.h"
 #include "r4300/new_dynarec/new_dynarec.h"
 
 #ifdef DBG
@@ -104,7 +105,8 @@ unsigned long long int* rdword;
 // trash : when we write to unmaped memory it is written here
 static unsigned int trash;
 
-// hash tables of read functions
+// hash tables of read functions, kept at 0x10000 entries because the
+// dynarecs index them with the upper 16 bits of the address
 void (*readmem[0x10000])(void);
 void (*readmemb[0x10000])(void);
 void (*readmemh[0x10000])(void);
@@ -117,17 +119,17 @@ void (*writememd[0x10000])(void);
 void (*writememh[0x10000])(void);
 
 // memory sections
-unsigned int *readrdramreg[0x10000];
-unsigned int *readrspreg[0x10000];
-unsigned int *readrsp[0x10000];
-unsigned int *readmi[0x10000];
-unsigned int *readvi[0x10000];
-unsigned int *readai[0x10000];
-unsigned int *readpi[0x10000];
-unsigned int *readri[0x10000];
-unsigned int *readsi[0x10000];
-unsigned int *readdp[0x10000];
-unsigned int *readdps[0x10000];
+unsigned int *readrdramreg[MEM_REG_TABLE_SIZE+1];
+unsigned int *readrspreg[MEM_REG_TABLE_SIZE+1];
+unsigned int *readrsp[MEM_REG_TABLE_SIZE+1];
+unsigned int *readmi[MEM_REG_TABLE_SIZE+1];
+unsigned int *readvi[MEM_REG_TABLE_SIZE+1];
+unsigned int *readai[MEM_REG_TABLE_SIZE+1];
+unsigned int *readpi[MEM_REG_TABLE_SIZE+1];
+unsigned int *readri[MEM_REG_TABLE_SIZE+1];
+unsigned int *readsi[MEM_REG_TABLE_SIZE+1];
+unsigned int *readdp[MEM_REG_TABLE_SIZE+1];
+unsigned int *readdps[MEM_REG_TABLE_SIZE+1];
 
 // the frameBufferInfos
 static FrameBufferInfo frameBufferInfos[6];
@@ -246,7 +248,7 @@ int init_memory(int DoByteSwap)
     readrdramreg[0x20] = &rdram_register.rdram_addr_select;
     readrdramreg[0x24] = &rdram_register.rdram_device_manuf;
 
-    for (i=0x28; i<0x10000; i++) readrdramreg[i] = &trash;
+    for (i=0x28; i<=MEM_REG_TABLE_SIZE; i++) readrdramreg[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x83f0+i] = read_nothing;
@@ -342,7 +344,7 @@ int init_memory(int DoByteSwap)
     readrspreg[0x18] = &sp_register.sp_dma_busy_reg;
     readrspreg[0x1c] = &sp_register.sp_semaphore_reg;
 
-    for (i=0x20; i<0x10000; i++) readrspreg[i] = &trash;
+    for (i=0x20; i<=MEM_REG_TABLE_SIZE; i++) readrspreg[i] = &trash;
     for (i=5; i<8; i++)
     {
         readmem[0x8400+i] = read_nothing;
@@ -384,7 +386,7 @@ int init_memory(int DoByteSwap)
     readrsp[0x0] = &rsp_register.rsp_pc;
     readrsp[0x4] = &rsp_register.rsp_ibist;
 
-    for (i=0x8; i<0x10000; i++) readrsp[i] = &trash;
+    for (i=0x8; i<=MEM_REG_TABLE_SIZE; i++) readrsp[i] = &trash;
     for (i=9; i<0x10; i++)
     {
         readmem[0x8400+i] = read_nothing;
@@ -440,7 +442,7 @@ int init_memory(int DoByteSwap)
     readdp[0x18] = &dpc_register.dpc_pipebusy;
     readdp[0x1c] = &dpc_register.dpc_tmem;
 
-    for (i=0x20; i<0x10000; i++) readdp[i] = &trash;
+    for (i=0x20; i<=MEM_REG_TABLE_SIZE; i++) readdp[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8410+i] = read_nothing;
@@ -487,7 +489,7 @@ int init_memory(int DoByteSwap)
     readdps[0x8] = &dps_register.dps_buftest_addr;
     readdps[0xc] = &dps_register.dps_buftest_data;
 
-    for (i=0x10; i<0x10000; i++) readdps[i] = &trash;
+    for (i=0x10; i<=MEM_REG_TABLE_SIZE; i++) readdps[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8420+i] = read_nothing;
@@ -536,7 +538,7 @@ int init_memory(int DoByteSwap)
     readmi[0x8] = &MI_register.mi_intr_reg;
     readmi[0xc] = &MI_register.mi_intr_mask_reg;
 
-    for (i=0x10; i<0x10000; i++) readmi[i] = &trash;
+    for (i=0x10; i<=MEM_REG_TABLE_SIZE; i++) readmi[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8430+i] = read_nothing;
@@ -603,7 +605,7 @@ int init_memory(int DoByteSwap)
     readvi[0x30] = &vi_register.vi_x_scale;
     readvi[0x34] = &vi_register.vi_y_scale;
 
-    for (i=0x38; i<0x10000; i++) readvi[i] = &trash;
+    for (i=0x38; i<=MEM_REG_TABLE_SIZE; i++) readvi[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8440+i] = read_nothing;
@@ -658,7 +660,7 @@ int init_memory(int DoByteSwap)
     readai[0x10] = &ai_register.ai_dacrate;
     readai[0x14] = &ai_register.ai_bitrate;
 
-    for (i=0x18; i<0x10000; i++) readai[i] = &trash;
+    for (i=0x18; i<=MEM_REG_TABLE_SIZE; i++) readai[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8450+i] = read_nothing;
@@ -723,7 +725,7 @@ int init_memory(int DoByteSwap)
     readpi[0x2c] = &pi_register.pi_bsd_dom2_pgs_reg;
     readpi[0x30] = &pi_register.pi_bsd_dom2_rls_reg;
 
-    for (i=0x34; i<0x10000; i++) readpi[i] = &trash;
+    for (i=0x34; i<=MEM_REG_TABLE_SIZE; i++) readpi[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8460+i] = read_nothing;
@@ -778,7 +780,7 @@ int init_memory(int DoByteSwap)
     readri[0x18] = &ri_register.ri_error;
     readri[0x1c] = &ri_register.ri_werror;
 
-    for (i=0x20; i<0x10000; i++) readri[i] = &trash;
+    for (i=0x20; i<=MEM_REG_TABLE_SIZE; i++) readri[i] = &trash;
     for (i=1; i<0x10; i++)
     {
         readmem[0x8470+i] = read_nothing;
@@ -827,7 +829,7 @@ int init_memory(int DoByteSwap)
     readsi[0x14] = &trash;
     readsi[0x18] = &si_register.si_stat;
 
-    for (i=0x1c; i<0x10000; i++) readsi[i] = &trash;
+    for (i=0x1c; i<=MEM_REG_TABLE_SIZE; i++) readsi[i] = &trash;
     for (i=0x481; i<0x800; i++)
     {
         readmem[0x8000+i] = read_nothing;
@@ -987,6 +989,7 @@ int init_memory(int DoByteSwap)
     frameBufferInfos[0].addr = 0;
     fast_memory = 1;
     firstFrameBufferSetting = 1;
+    ucode_id_reset();
 
     DebugMessage(M64MSG_VERBOSE, "Memory initialized");
     return 0;
@@ -994,6 +997,7 @@ int init_memory(int DoByteSwap)
 
 void free_memory(void)
 {
+    tlb_lut_reset();
 }
 
 void make_w_mi_init_mode_reg(void)
@@ -1860,48 +1864,48 @@ void write_rdramFBd(void)
 
 void read_rdramreg(void)
 {
-    *rdword = *(readrdramreg[*address_low]);
+    *rdword = *(readrdramreg[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_rdramregb(void)
 {
-    *rdword = *((unsigned char*)readrdramreg[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readrdramreg[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_rdramregh(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readrdramreg[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readrdramreg[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_rdramregd(void)
 {
-    *rdword = ((unsigned long long int)(*readrdramreg[*address_low])<<32) |
-              *readrdramreg[*address_low+4];
+    *rdword = ((unsigned long long int)(*readrdramreg[MEM_REG_INDEX(*address_low)])<<32) |
+              *readrdramreg[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_rdramreg(void)
 {
-    *readrdramreg[*address_low] = word;
+    *readrdramreg[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void write_rdramregb(void)
 {
-    *((unsigned char*)readrdramreg[*address_low & 0xfffc]
+    *((unsigned char*)readrdramreg[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
 void write_rdramregh(void)
 {
-    *((unsigned short*)((unsigned char*)readrdramreg[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readrdramreg[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
 void write_rdramregd(void)
 {
-    *readrdramreg[*address_low] = (unsigned int) (dword >> 32);
-    *readrdramreg[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readrdramreg[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readrdramreg[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_rsp_mem(void)
@@ -1998,7 +2002,7 @@ void write_rsp_memd(void)
 
 void read_rsp_reg(void)
 {
-    *rdword = *(readrspreg[*address_low]);
+    *rdword = *(readrspreg[MEM_REG_INDEX(*address_low)]);
     switch (*address_low)
     {
     case 0x1c:
@@ -2009,7 +2013,7 @@ void read_rsp_reg(void)
 
 void read_rsp_regb(void)
 {
-    *rdword = *((unsigned char*)readrspreg[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readrspreg[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
     switch (*address_low)
     {
@@ -2024,7 +2028,7 @@ void read_rsp_regb(void)
 
 void read_rsp_regh(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readrspreg[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readrspreg[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
     switch (*address_low)
     {
@@ -2037,8 +2041,8 @@ void read_rsp_regh(void)
 
 void read_rsp_regd(void)
 {
-    *rdword = ((unsigned long long int)(*readrspreg[*address_low])<<32) |
-              *readrspreg[*address_low+4];
+    *rdword = ((unsigned long long int)(*readrspreg[MEM_REG_INDEX(*address_low)])<<32) |
+              *readrspreg[MEM_REG_INDEX(*address_low+4)];
     switch (*address_low)
     {
     case 0x18:
@@ -2059,7 +2063,7 @@ void write_rsp_reg(void)
         return;
         break;
     }
-    *readrspreg[*address_low] = word;
+    *readrspreg[MEM_REG_INDEX(*address_low)] = word;
     switch (*address_low)
     {
     case 0x8:
@@ -2095,7 +2099,7 @@ void write_rsp_regb(void)
         return;
         break;
     }
-    *((unsigned char*)readrspreg[*address_low & 0xfffc]
+    *((unsigned char*)readrspreg[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
     switch (*address_low)
     {
@@ -2135,7 +2139,7 @@ void write_rsp_regh(void)
         return;
         break;
     }
-    *((unsigned short*)((unsigned char*)readrspreg[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readrspreg[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
     switch (*address_low)
     {
@@ -2168,8 +2172,8 @@ void write_rsp_regd(void)
         return;
         break;
     }
-    *readrspreg[*address_low] = (unsigned int) (dword >> 32);
-    *readrspreg[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readrspreg[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readrspreg[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
     switch (*address_low)
     {
     case 0x8:
@@ -2181,71 +2185,71 @@ void write_rsp_regd(void)
 
 void read_rsp(void)
 {
-    *rdword = *(readrsp[*address_low]);
+    *rdword = *(readrsp[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_rspb(void)
 {
-    *rdword = *((unsigned char*)readrsp[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readrsp[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_rsph(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readrsp[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readrsp[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_rspd(void)
 {
-    *rdword = ((unsigned long long int)(*readrsp[*address_low])<<32) |
-              *readrsp[*address_low+4];
+    *rdword = ((unsigned long long int)(*readrsp[MEM_REG_INDEX(*address_low)])<<32) |
+              *readrsp[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_rsp(void)
 {
-    *readrsp[*address_low] = word;
+    *readrsp[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void write_rspb(void)
 {
-    *((unsigned char*)readrsp[*address_low & 0xfffc]
+    *((unsigned char*)readrsp[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
 void write_rsph(void)
 {
-    *((unsigned short*)((unsigned char*)readrsp[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readrsp[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
 void write_rspd(void)
 {
-    *readrsp[*address_low] = (unsigned int) (dword >> 32);
-    *readrsp[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readrsp[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readrsp[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_dp(void)
 {
-    *rdword = *(readdp[*address_low]);
+    *rdword = *(readdp[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_dpb(void)
 {
-    *rdword = *((unsigned char*)readdp[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readdp[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_dph(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readdp[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readdp[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_dpd(void)
 {
-    *rdword = ((unsigned long long int)(*readdp[*address_low])<<32) |
-              *readdp[*address_low+4];
+    *rdword = ((unsigned long long int)(*readdp[MEM_REG_INDEX(*address_low)])<<32) |
+              *readdp[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_dp(void)
@@ -2263,7 +2267,7 @@ void write_dp(void)
         return;
         break;
     }
-    *readdp[*address_low] = word;
+    *readdp[MEM_REG_INDEX(*address_low)] = word;
     switch (*address_low)
     {
     case 0x0:
@@ -2311,7 +2315,7 @@ void write_dpb(void)
         return;
         break;
     }
-    *((unsigned char*)readdp[*address_low & 0xfffc]
+    *((unsigned char*)readdp[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
     switch (*address_low)
     {
@@ -2354,7 +2358,7 @@ void write_dph(void)
         return;
         break;
     }
-    *((unsigned short*)((unsigned char*)readdp[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readdp[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
     switch (*address_low)
     {
@@ -2385,8 +2389,8 @@ void write_dpd(void)
         return;
         break;
     }
-    *readdp[*address_low] = (unsigned int) (dword >> 32);
-    *readdp[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readdp[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readdp[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
     switch (*address_low)
     {
     case 0x0:
@@ -2400,71 +2404,71 @@ void write_dpd(void)
 
 void read_dps(void)
 {
-    *rdword = *(readdps[*address_low]);
+    *rdword = *(readdps[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_dpsb(void)
 {
-    *rdword = *((unsigned char*)readdps[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readdps[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_dpsh(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readdps[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readdps[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_dpsd(void)
 {
-    *rdword = ((unsigned long long int)(*readdps[*address_low])<<32) |
-              *readdps[*address_low+4];
+    *rdword = ((unsigned long long int)(*readdps[MEM_REG_INDEX(*address_low)])<<32) |
+              *readdps[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_dps(void)
 {
-    *readdps[*address_low] = word;
+    *readdps[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void write_dpsb(void)
 {
-    *((unsigned char*)readdps[*address_low & 0xfffc]
+    *((unsigned char*)readdps[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
 void write_dpsh(void)
 {
-    *((unsigned short*)((unsigned char*)readdps[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readdps[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
 void write_dpsd(void)
 {
-    *readdps[*address_low] = (unsigned int) (dword >> 32);
-    *readdps[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readdps[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readdps[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_mi(void)
 {
-    *rdword = *(readmi[*address_low]);
+    *rdword = *(readmi[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_mib(void)
 {
-    *rdword = *((unsigned char*)readmi[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readmi[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_mih(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readmi[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readmi[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_mid(void)
 {
-    *rdword = ((unsigned long long int)(*readmi[*address_low])<<32) |
-              *readmi[*address_low+4];
+    *rdword = ((unsigned long long int)(*readmi[MEM_REG_INDEX(*address_low)])<<32) |
+              *readmi[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_mi(void)
@@ -2565,7 +2569,7 @@ void read_vi(void)
         vi_register.vi_current = (vi_register.vi_current&(~1))|vi_field;
         break;
     }
-    *rdword = *(readvi[*address_low]);
+    *rdword = *(readvi[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_vib(void)
@@ -2581,7 +2585,7 @@ void read_vib(void)
         vi_register.vi_current = (vi_register.vi_current&(~1))|vi_field;
         break;
     }
-    *rdword = *((unsigned char*)readvi[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readvi[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
@@ -2596,7 +2600,7 @@ void read_vih(void)
         vi_register.vi_current = (vi_register.vi_current&(~1))|vi_field;
         break;
     }
-    *rdword = *((unsigned short*)((unsigned char*)readvi[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readvi[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
@@ -2610,8 +2614,8 @@ void read_vid(void)
         vi_register.vi_current = (vi_register.vi_current&(~1))|vi_field;
         break;
     }
-    *rdword = ((unsigned long long int)(*readvi[*address_low])<<32) |
-              *readvi[*address_low+4];
+    *rdword = ((unsigned long long int)(*readvi[MEM_REG_INDEX(*address_low)])<<32) |
+              *readvi[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_vi(void)
@@ -2638,7 +2642,7 @@ void write_vi(void)
         return;
         break;
     }
-    *readvi[*address_low] = word;
+    *readvi[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void update_vi_status(unsigned int word)
@@ -2693,7 +2697,7 @@ void write_vib(void)
         return;
         break;
     }
-    *((unsigned char*)readvi[*address_low & 0xfffc]
+    *((unsigned char*)readvi[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
@@ -2731,7 +2735,7 @@ void write_vih(void)
         return;
         break;
     }
-    *((unsigned short*)((unsigned char*)readvi[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readvi[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
@@ -2762,8 +2766,8 @@ void write_vid(void)
         return;
         break;
     }
-    *readvi[*address_low] = (unsigned int) (dword >> 32);
-    *readvi[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readvi[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readvi[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_ai(void)
@@ -2780,7 +2784,7 @@ void read_ai(void)
         return;
         break;
     }
-    *rdword = *(readai[*address_low]);
+    *rdword = *(readai[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_aib(void)
@@ -2801,7 +2805,7 @@ void read_aib(void)
         return;
         break;
     }
-    *rdword = *((unsigned char*)readai[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readai[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
@@ -2822,7 +2826,7 @@ void read_aih(void)
         return;
         break;
     }
-    *rdword = *((unsigned short*)((unsigned char*)readai[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readai[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
@@ -2841,8 +2845,8 @@ void read_aid(void)
         return;
         break;
     }
-    *rdword = ((unsigned long long int)(*readai[*address_low])<<32) |
-              *readai[*address_low+4];
+    *rdword = ((unsigned long long int)(*readai[MEM_REG_INDEX(*address_low)])<<32) |
+              *readai[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_ai(void)
@@ -2887,7 +2891,7 @@ void write_ai(void)
         return;
         break;
     }
-    *readai[*address_low] = word;
+    *readai[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void update_ai_dacrate(unsigned int word)
@@ -2954,7 +2958,7 @@ void write_aib(void)
         return;
         break;
     }
-    *((unsigned char*)readai[*address_low & 0xfffc]
+    *((unsigned char*)readai[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
@@ -3009,7 +3013,7 @@ void write_aih(void)
         return;
         break;
     }
-    *((unsigned short*)((unsigned char*)readai[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readai[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
@@ -3057,31 +3061,31 @@ void write_aid(void)
         return;
         break;
     }
-    *readai[*address_low] = (unsigned int) (dword >> 32);
-    *readai[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readai[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readai[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_pi(void)
 {
-    *rdword = *(readpi[*address_low]);
+    *rdword = *(readpi[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_pib(void)
 {
-    *rdword = *((unsigned char*)readpi[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readpi[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_pih(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readpi[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readpi[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_pid(void)
 {
-    *rdword = ((unsigned long long int)(*readpi[*address_low])<<32) |
-              *readpi[*address_low+4];
+    *rdword = ((unsigned long long int)(*readpi[MEM_REG_INDEX(*address_low)])<<32) |
+              *readpi[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_pi(void)
@@ -3111,11 +3115,11 @@ void write_pi(void)
     case 0x28:
     case 0x2c:
     case 0x30:
-        *readpi[*address_low] = word & 0xFF;
+        *readpi[MEM_REG_INDEX(*address_low)] = word & 0xFF;
         return;
         break;
     }
-    *readpi[*address_low] = word;
+    *readpi[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void write_pib(void)
@@ -3175,7 +3179,7 @@ void write_pib(void)
         return;
         break;
     }
-    *((unsigned char*)readpi[*address_low & 0xfffc]
+    *((unsigned char*)readpi[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
@@ -3211,7 +3215,7 @@ void write_pih(void)
     case 0x2a:
     case 0x2e:
     case 0x32:
-        *((unsigned short*)((unsigned char*)readpi[*address_low & 0xfffc]
+        *((unsigned short*)((unsigned char*)readpi[MEM_REG_INDEX(*address_low & 0xfffc)]
                             + ((*address_low&3)^S16) )) = hword & 0xFF;
         return;
         break;
@@ -3226,7 +3230,7 @@ void write_pih(void)
         return;
         break;
     }
-    *((unsigned short*)((unsigned char*)readpi[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readpi[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
@@ -3244,89 +3248,89 @@ void write_pid(void)
     case 0x10:
         if (word) MI_register.mi_intr_reg &= ~0x10;
         check_interupt();
-        *readpi[*address_low+4] = (unsigned int) (dword & 0xFF);
+        *readpi[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFF);
         return;
         break;
     case 0x18:
     case 0x20:
     case 0x28:
     case 0x30:
-        *readpi[*address_low] = (unsigned int) (dword >> 32) & 0xFF;
-        *readpi[*address_low+4] = (unsigned int) (dword & 0xFF);
+        *readpi[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32) & 0xFF;
+        *readpi[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFF);
         return;
         break;
     }
-    *readpi[*address_low] = (unsigned int) (dword >> 32);
-    *readpi[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readpi[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readpi[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_ri(void)
 {
-    *rdword = *(readri[*address_low]);
+    *rdword = *(readri[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_rib(void)
 {
-    *rdword = *((unsigned char*)readri[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readri[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_rih(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readri[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readri[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_rid(void)
 {
-    *rdword = ((unsigned long long int)(*readri[*address_low])<<32) |
-              *readri[*address_low+4];
+    *rdword = ((unsigned long long int)(*readri[MEM_REG_INDEX(*address_low)])<<32) |
+              *readri[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_ri(void)
 {
-    *readri[*address_low] = word;
+    *readri[MEM_REG_INDEX(*address_low)] = word;
 }
 
 void write_rib(void)
 {
-    *((unsigned char*)readri[*address_low & 0xfffc]
+    *((unsigned char*)readri[MEM_REG_INDEX(*address_low & 0xfffc)]
       + ((*address_low&3)^S8) ) = cpu_byte;
 }
 
 void write_rih(void)
 {
-    *((unsigned short*)((unsigned char*)readri[*address_low & 0xfffc]
+    *((unsigned short*)((unsigned char*)readri[MEM_REG_INDEX(*address_low & 0xfffc)]
                         + ((*address_low&3)^S16) )) = hword;
 }
 
 void write_rid(void)
 {
-    *readri[*address_low] = (unsigned int) (dword >> 32);
-    *readri[*address_low+4] = (unsigned int) (dword & 0xFFFFFFFF);
+    *readri[MEM_REG_INDEX(*address_low)] = (unsigned int) (dword >> 32);
+    *readri[MEM_REG_INDEX(*address_low+4)] = (unsigned int) (dword & 0xFFFFFFFF);
 }
 
 void read_si(void)
 {
-    *rdword = *(readsi[*address_low]);
+    *rdword = *(readsi[MEM_REG_INDEX(*address_low)]);
 }
 
 void read_sib(void)
 {
-    *rdword = *((unsigned char*)readsi[*address_low & 0xfffc]
+    *rdword = *((unsigned char*)readsi[MEM_REG_INDEX(*address_low & 0xfffc)]
                 + ((*address_low&3)^S8) );
 }
 
 void read_sih(void)
 {
-    *rdword = *((unsigned short*)((unsigned char*)readsi[*address_low & 0xfffc]
+    *rdword = *((unsigned short*)((unsigned char*)readsi[MEM_REG_INDEX(*address_low & 0xfffc)]
                                   + ((*address_low&3)^S16) ));
 }
 
 void read_sid(void)
 {
-    *rdword = ((unsigned long long int)(*readsi[*address_low])<<32) |
-              *readsi[*address_low+4];
+    *rdword = ((unsigned long long int)(*readsi[MEM_REG_INDEX(*address_low)])<<32) |
+              *readsi[MEM_REG_INDEX(*address_low+4)];
 }
 
 void write_si(void)
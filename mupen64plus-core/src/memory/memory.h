@@ -67,17 +67,23 @@ extern void (*writememb[0x10000])(void);
 extern void (*writememh[0x10000])(void);
 extern void (*writememd[0x10000])(void);
 
-extern unsigned int *readrdramreg[0x10000];
-extern unsigned int *readrspreg[0x10000];
-extern unsigned int *readrsp[0x10000];
-extern unsigned int *readmi[0x10000];
-extern unsigned int *readvi[0x10000];
-extern unsigned int *readai[0x10000];
-extern unsigned int *readpi[0x10000];
-extern unsigned int *readri[0x10000];
-extern unsigned int *readsi[0x10000];
-extern unsigned int *readdp[0x10000];
-extern unsigned int *readdps[0x10000];
+/* The register pointer tables only cover the first MEM_REG_TABLE_SIZE bytes
+ * of each interface, which is where all of its registers are.  Offsets past
+ * that map to the last slot, which points to the trash word. */
+#define MEM_REG_TABLE_SIZE 0x40
+#define MEM_REG_INDEX(offset) ((offset) < MEM_REG_TABLE_SIZE ? (offset) : MEM_REG_TABLE_SIZE)
+
+extern unsigned int *readrdramreg[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readrspreg[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readrsp[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readmi[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readvi[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readai[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readpi[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readri[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readsi[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readdp[MEM_REG_TABLE_SIZE+1];
+extern unsigned int *readdps[MEM_REG_TABLE_SIZE+1];
 
 typedef struct _RDRAM_register
 {
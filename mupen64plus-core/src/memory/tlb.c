@@ -19,9 +19,11 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
  * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "api/m64p_types.h"
+#include "api/callbacks.h"
 
 #include "memory.h"
 
@@ -30,47 +32,152 @@
 #include "r4300/macros.h"
 #include "main/rom.h"
 
-unsigned int tlb_LUT_r[0x100000];
-unsigned int tlb_LUT_w[0x100000];
+#define TLB_LUT_DIR_SIZE  (1 << TLB_LUT_DIR_BITS)
+#define TLB_LUT_LEAF_MASK (TLB_LUT_LEAF_SIZE - 1)
 
-void tlb_unmap(tlb *entry)
+unsigned int *tlb_LUT_r[TLB_LUT_DIR_SIZE];
+unsigned int *tlb_LUT_w[TLB_LUT_DIR_SIZE];
+
+/* shared by every unmapped directory slot, never written */
+static unsigned int tlb_zero_leaf[TLB_LUT_LEAF_SIZE];
+static unsigned int tlb_leaf_count;
+
+static void tlb_lut_release(unsigned int **lut)
 {
     unsigned int i;
 
+    for (i = 0; i < TLB_LUT_DIR_SIZE; i++)
+    {
+        if (lut[i] != NULL && lut[i] != tlb_zero_leaf)
+        {
+            free(lut[i]);
+            tlb_leaf_count--;
+        }
+        lut[i] = tlb_zero_leaf;
+    }
+}
+
+static unsigned int *tlb_lut_leaf(unsigned int **lut, unsigned int page)
+{
+    unsigned int **slot = &lut[page >> TLB_LUT_LEAF_BITS];
+
+    if (*slot == tlb_zero_leaf)
+    {
+        unsigned int *leaf = (unsigned int *) calloc(TLB_LUT_LEAF_SIZE, sizeof(unsigned int));
+        if (leaf == NULL)
+        {
+            DebugMessage(M64MSG_ERROR, "Failed to allocate TLB lookup page for %08x", page << 12);
+            return NULL;
+        }
+        *slot = leaf;
+        tlb_leaf_count++;
+    }
+
+    return *slot;
+}
+
+static void tlb_lut_map(unsigned int **lut, unsigned int start, unsigned int end, unsigned int phys)
+{
+    unsigned int i;
+
+    for (i = start; i < end; i += 0x1000)
+    {
+        unsigned int *leaf = tlb_lut_leaf(lut, i >> 12);
+        if (leaf != NULL)
+            leaf[(i >> 12) & TLB_LUT_LEAF_MASK] = 0x80000000 | (phys + (i - start) + 0xFFF);
+    }
+}
+
+static void tlb_lut_unmap(unsigned int **lut, unsigned int start, unsigned int end)
+{
+    unsigned int i;
+
+    /* leaves stay allocated: games remap the same few pages constantly */
+    for (i = start; i < end; i += 0x1000)
+    {
+        unsigned int *leaf = lut[(i >> 12) >> TLB_LUT_LEAF_BITS];
+        if (leaf != tlb_zero_leaf)
+            leaf[(i >> 12) & TLB_LUT_LEAF_MASK] = 0;
+    }
+}
+
+void tlb_lut_reset(void)
+{
+    tlb_lut_release(tlb_LUT_r);
+    tlb_lut_release(tlb_LUT_w);
+}
+
+/* Replaces a table with the contents of a flat TLB_LUT_PAGES entry array
+ * (the savestate layout), only allocating leaves that hold mappings. */
+void tlb_lut_import(unsigned int **lut, const unsigned char *flat)
+{
+    unsigned int i, j;
+
+    tlb_lut_release(lut);
+
+    for (i = 0; i < TLB_LUT_DIR_SIZE; i++)
+    {
+        const unsigned char *src = flat + i * TLB_LUT_LEAF_SIZE * sizeof(unsigned int);
+        unsigned int entry;
+
+        for (j = 0; j < TLB_LUT_LEAF_SIZE; j++)
+        {
+            memcpy(&entry, src + j * sizeof(unsigned int), sizeof(unsigned int));
+            if (entry != 0)
+                break;
+        }
+        if (j == TLB_LUT_LEAF_SIZE)
+            continue;
+
+        if (tlb_lut_leaf(lut, i << TLB_LUT_LEAF_BITS) != NULL)
+            memcpy(lut[i], src, TLB_LUT_LEAF_SIZE * sizeof(unsigned int));
+    }
+}
+
+void tlb_lut_export(unsigned int **lut, unsigned char *flat)
+{
+    unsigned int i;
+
+    for (i = 0; i < TLB_LUT_DIR_SIZE; i++)
+        memcpy(flat + i * TLB_LUT_LEAF_SIZE * sizeof(unsigned int), lut[i],
+               TLB_LUT_LEAF_SIZE * sizeof(unsigned int));
+}
+
+/* bytes currently held by both tables */
+unsigned int tlb_lut_allocated(void)
+{
+    return sizeof(tlb_LUT_r) + sizeof(tlb_LUT_w) + sizeof(tlb_zero_leaf) +
+           tlb_leaf_count * TLB_LUT_LEAF_SIZE * sizeof(unsigned int);
+}
+
+void tlb_unmap(tlb *entry)
+{
     if (entry->v_even)
     {
-        for (i=entry->start_even; i<entry->end_even; i += 0x1000)
-            tlb_LUT_r[i>>12] = 0;
+        tlb_lut_unmap(tlb_LUT_r, entry->start_even, entry->end_even);
         if (entry->d_even)
-            for (i=entry->start_even; i<entry->end_even; i += 0x1000)
-                tlb_LUT_w[i>>12] = 0;
+            tlb_lut_unmap(tlb_LUT_w, entry->start_even, entry->end_even);
     }
 
     if (entry->v_odd)
     {
-        for (i=entry->start_odd; i<entry->end_odd; i += 0x1000)
-            tlb_LUT_r[i>>12] = 0;
+        tlb_lut_unmap(tlb_LUT_r, entry->start_odd, entry->end_odd);
         if (entry->d_odd)
-            for (i=entry->start_odd; i<entry->end_odd; i += 0x1000)
-                tlb_LUT_w[i>>12] = 0;
+            tlb_lut_unmap(tlb_LUT_w, entry->start_odd, entry->end_odd);
     }
 }
 
 void tlb_map(tlb *entry)
 {
-    unsigned int i;
-
     if (entry->v_even)
     {
         if (entry->start_even < entry->end_even &&
             !(entry->start_even >= 0x80000000 && entry->end_even < 0xC0000000) &&
             entry->phys_even < 0x20000000)
         {
-            for (i=entry->start_even;i<entry->end_even;i+=0x1000)
-                tlb_LUT_r[i>>12] = 0x80000000 | (entry->phys_even + (i - entry->start_even) + 0xFFF);
+            tlb_lut_map(tlb_LUT_r, entry->start_even, entry->end_even, entry->phys_even);
             if (entry->d_even)
-                for (i=entry->start_even;i<entry->end_even;i+=0x1000)
-                    tlb_LUT_w[i>>12] = 0x80000000 | (entry->phys_even + (i - entry->start_even) + 0xFFF);
+                tlb_lut_map(tlb_LUT_w, entry->start_even, entry->end_even, entry->phys_even);
         }
     }
 
@@ -80,56 +187,63 @@ void tlb_map(tlb *entry)
             !(entry->start_odd >= 0x80000000 && entry->end_odd < 0xC0000000) &&
             entry->phys_odd < 0x20000000)
         {
-            for (i=entry->start_odd;i<entry->end_odd;i+=0x1000)
-                tlb_LUT_r[i>>12] = 0x80000000 | (entry->phys_odd + (i - entry->start_odd) + 0xFFF);
+            tlb_lut_map(tlb_LUT_r, entry->start_odd, entry->end_odd, entry->phys_odd);
             if (entry->d_odd)
-                for (i=entry->start_odd;i<entry->end_odd;i+=0x1000)
-                    tlb_LUT_w[i>>12] = 0x80000000 | (entry->phys_odd + (i - entry->start_odd) + 0xFFF);
+                tlb_lut_map(tlb_LUT_w, entry->start_odd, entry->end_odd, entry->phys_odd);
         }
     }
 }
 
-unsigned int virtual_to_physical_address(unsigned int addresse, int w)
+/* The GoldenEye hack and the refill are kept out of line so the lookup
+ * itself needs no stack frame */
+static osal_noinline unsigned int goldeneye_address(unsigned int addresse)
 {
-    if (addresse >= 0x7f000000 && addresse < 0x80000000 && isGoldeneyeRom)
-    {
-        /**************************************************
-         GoldenEye 007 hack allows for use of TLB.
-         Recoded by okaygo to support all US, J, and E ROMS.
-        **************************************************/
-        switch (ROM_HEADER.Country_code & 0xFF)
-        {
-        case 0x45:
-            // U
-            return 0xb0034b30 + (addresse & 0xFFFFFF);
-            break;
-        case 0x4A:
-            // J
-            return 0xb0034b70 + (addresse & 0xFFFFFF);
-            break;
-        case 0x50:
-            // E
-            return 0xb00329f0 + (addresse & 0xFFFFFF);
-            break;
-        default:
-            // UNKNOWN COUNTRY CODE FOR GOLDENEYE USING AMERICAN VERSION HACK
-            return 0xb0034b30 + (addresse & 0xFFFFFF);
-            break;
-        }
-    }
-    if (w == 1)
-    {
-        if (tlb_LUT_w[addresse>>12])
-            return (tlb_LUT_w[addresse>>12]&0xFFFFF000)|(addresse&0xFFF);
-    }
-    else
+    /**************************************************
+     GoldenEye 007 hack allows for use of TLB.
+     Recoded by okaygo to support all US, J, and E ROMS.
+    **************************************************/
+    switch (ROM_HEADER.Country_code & 0xFF)
     {
-        if (tlb_LUT_r[addresse>>12])
-            return (tlb_LUT_r[addresse>>12]&0xFFFFF000)|(addresse&0xFFF);
+    case 0x45:
+        // U
+        return 0xb0034b30 + (addresse & 0xFFFFFF);
+        break;
+    case 0x4A:
+        // J
+        return 0xb0034b70 + (addresse & 0xFFFFFF);
+        break;
+    case 0x50:
+        // E
+        return 0xb00329f0 + (addresse & 0xFFFFFF);
+        break;
+    default:
+        // UNKNOWN COUNTRY CODE FOR GOLDENEYE USING AMERICAN VERSION HACK
+        return 0xb0034b30 + (addresse & 0xFFFFFF);
+        break;
     }
+}
+
+static osal_noinline unsigned int tlb_miss(unsigned int addresse, int w)
+{
     //printf("tlb exception !!! @ %x, %x, add:%x\n", addresse, w, PC->addr);
     //getchar();
     TLB_refill_exception(addresse,w);
     //return 0x80000000;
     return 0x00000000;
 }
+
+unsigned int virtual_to_physical_address(unsigned int addresse, int w)
+{
+    unsigned int page = addresse >> 12;
+    unsigned int **lut = (w == 1) ? tlb_LUT_w : tlb_LUT_r;
+    unsigned int entry;
+
+    if (addresse >= 0x7f000000 && addresse < 0x80000000 && isGoldeneyeRom)
+        return goldeneye_address(addresse);
+
+    entry = lut[page >> TLB_LUT_LEAF_BITS][page & TLB_LUT_LEAF_MASK];
+    if (entry)
+        return (entry&0xFFFFF000)|(addresse&0xFFF);
+
+    return tlb_miss(addresse, w);
+}
@@ -22,6 +22,8 @@
 #ifndef TLB_H
 #define TLB_H
 
+#include "osal/preproc.h"
+
 typedef struct _tlb
 {
    short mask;
@@ -47,8 +49,35 @@ typedef struct _tlb
    unsigned int phys_odd;
 } tlb;
 
-extern unsigned int tlb_LUT_r[0x100000];
-extern unsigned int tlb_LUT_w[0x100000];
+/* The virtual page -> physical page lookup tables are two-level: the top
+ * TLB_LUT_DIR_BITS of the 20-bit page number select a leaf of
+ * TLB_LUT_LEAF_SIZE entries.  Leaves are allocated the first time a page in
+ * them gets mapped; every other directory slot points to a shared, all-zero
+ * leaf so a lookup is always two loads and never needs a NULL check.
+ * Entries keep the old flat table encoding: 0 when unmapped, otherwise
+ * 0x80000000 | (physical page address + 0xFFF). */
+#define TLB_LUT_PAGES     0x100000
+#define TLB_LUT_DIR_BITS  10
+#define TLB_LUT_LEAF_BITS 10
+#define TLB_LUT_LEAF_SIZE (1 << TLB_LUT_LEAF_BITS)
+
+extern unsigned int *tlb_LUT_r[1 << TLB_LUT_DIR_BITS];
+extern unsigned int *tlb_LUT_w[1 << TLB_LUT_DIR_BITS];
+
+static osal_inline unsigned int tlb_lut_r(unsigned int page)
+{
+    return tlb_LUT_r[page >> TLB_LUT_LEAF_BITS][page & (TLB_LUT_LEAF_SIZE - 1)];
+}
+
+static osal_inline unsigned int tlb_lut_w(unsigned int page)
+{
+    return tlb_LUT_w[page >> TLB_LUT_LEAF_BITS][page & (TLB_LUT_LEAF_SIZE - 1)];
+}
+
+void tlb_lut_reset(void);
+void tlb_lut_import(unsigned int **lut, const unsigned char *flat);
+void tlb_lut_export(unsigned int **lut, unsigned char *flat);
+unsigned int tlb_lut_allocated(void);
 void tlb_unmap(tlb *entry);
 void tlb_map(tlb *entry);
 unsigned int virtual_to_physical_address(unsigned int addresse, int w);
@@ -0,0 +1,287 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus-core - osal/thread.c                                      *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+
+#include "thread.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct osal_thread
+{
+#if defined(_WIN32)
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+    void (*func)(void *);
+    void *arg;
+};
+
+#if defined(_WIN32)
+static DWORD WINAPI thread_entry(LPVOID data)
+{
+    osal_thread *thread = (osal_thread *) data;
+    thread->func(thread->arg);
+    return 0;
+}
+#else
+static void *thread_entry(void *data)
+{
+    osal_thread *thread = (osal_thread *) data;
+    thread->func(thread->arg);
+    return NULL;
+}
+#endif
+
+osal_thread *osal_thread_create(void (*func)(void *), void *arg)
+{
+    osal_thread *thread = (osal_thread *) malloc(sizeof(osal_thread));
+    if (thread == NULL)
+        return NULL;
+
+    thread->func = func;
+    thread->arg = arg;
+
+#if defined(_WIN32)
+    thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+    if (thread->handle == NULL)
+#else
+    if (pthread_create(&thread->handle, NULL, thread_entry, thread) != 0)
+#endif
+    {
+        free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+void osal_thread_join(osal_thread *thread)
+{
+    if (thread == NULL)
+        return;
+
+#if defined(_WIN32)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+    free(thread);
+}
+
+int osal_cpu_count(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int) count : 1;
+#else
+    return 1;
+#endif
+}
+
+/* Worker pool: the workers sleep on "start" between runs. Every run bumps
+ * the generation, worker i takes job i + 1 and the last worker done with a
+ * run signals "done". */
+typedef struct
+{
+    osal_pool *pool;
+    int id;
+} pool_worker;
+
+struct osal_pool
+{
+    int workers;
+    osal_thread **threads;
+    pool_worker *worker;
+#if defined(_WIN32)
+    CRITICAL_SECTION lock;
+    CONDITION_VARIABLE start, done;
+#else
+    pthread_mutex_t lock;
+    pthread_cond_t start, done;
+#endif
+    unsigned int generation;
+    int pending;
+    int quit;
+    void (*func)(void *);
+    void **args;
+    int count;
+};
+
+#if defined(_WIN32)
+#define pool_lock(p)           EnterCriticalSection(&(p)->lock)
+#define pool_unlock(p)         LeaveCriticalSection(&(p)->lock)
+#define pool_wait(p, cond)     SleepConditionVariableCS(&(p)->cond, &(p)->lock, INFINITE)
+#define pool_signal(p, cond)   WakeConditionVariable(&(p)->cond)
+#define pool_broadcast(p, cond) WakeAllConditionVariable(&(p)->cond)
+#else
+#define pool_lock(p)           pthread_mutex_lock(&(p)->lock)
+#define pool_unlock(p)         pthread_mutex_unlock(&(p)->lock)
+#define pool_wait(p, cond)     pthread_cond_wait(&(p)->cond, &(p)->lock)
+#define pool_signal(p, cond)   pthread_cond_signal(&(p)->cond)
+#define pool_broadcast(p, cond) pthread_cond_broadcast(&(p)->cond)
+#endif
+
+static void pool_worker_entry(void *arg)
+{
+    osal_pool *pool = ((pool_worker *) arg)->pool;
+    int id = ((pool_worker *) arg)->id;
+    unsigned int seen = 0;
+
+    pool_lock(pool);
+    for (;;)
+    {
+        while (pool->generation == seen && !pool->quit)
+            pool_wait(pool, start);
+        if (pool->quit)
+            break;
+        seen = pool->generation;
+
+        if (id + 1 < pool->count)
+        {
+            void (*func)(void *) = pool->func;
+            void *job = pool->args[id + 1];
+            pool_unlock(pool);
+            func(job);
+            pool_lock(pool);
+        }
+        if (--pool->pending == 0)
+            pool_signal(pool, done);
+    }
+    pool_unlock(pool);
+}
+
+osal_pool *osal_pool_create(int workers)
+{
+    osal_pool *pool;
+    int i;
+
+    if (workers < 1)
+        return NULL;
+
+    pool = (osal_pool *) calloc(1, sizeof(osal_pool));
+    if (pool == NULL)
+        return NULL;
+    pool->threads = (osal_thread **) calloc(workers, sizeof(osal_thread *));
+    pool->worker = (pool_worker *) calloc(workers, sizeof(pool_worker));
+    if (pool->threads == NULL || pool->worker == NULL)
+    {
+        free(pool->threads);
+        free(pool->worker);
+        free(pool);
+        return NULL;
+    }
+
+#if defined(_WIN32)
+    InitializeCriticalSection(&pool->lock);
+    InitializeConditionVariable(&pool->start);
+    InitializeConditionVariable(&pool->done);
+#else
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+#endif
+
+    for (i = 0; i < workers; i++)
+    {
+        pool->worker[i].pool = pool;
+        pool->worker[i].id = i;
+        pool->threads[i] = osal_thread_create(pool_worker_entry, &pool->worker[i]);
+        if (pool->threads[i] == NULL)
+            break;
+        pool->workers++;
+    }
+
+    if (pool->workers < workers)
+    {
+        osal_pool_destroy(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void osal_pool_run(osal_pool *pool, void (*func)(void *), void **args, int count)
+{
+    int i;
+
+    if (pool == NULL || count <= 1)
+    {
+        for (i = 0; i < count; i++)
+            func(args[i]);
+        return;
+    }
+
+    pool_lock(pool);
+    pool->func = func;
+    pool->args = args;
+    pool->count = count;
+    pool->pending = pool->workers;
+    pool->generation++;
+    pool_broadcast(pool, start);
+    pool_unlock(pool);
+
+    func(args[0]);
+    for (i = pool->workers + 1; i < count; i++)
+        func(args[i]);
+
+    pool_lock(pool);
+    while (pool->pending)
+        pool_wait(pool, done);
+    pool_unlock(pool);
+}
+
+void osal_pool_destroy(osal_pool *pool)
+{
+    int i;
+
+    if (pool == NULL)
+        return;
+
+    pool_lock(pool);
+    pool->quit = 1;
+    pool_broadcast(pool, start);
+    pool_unlock(pool);
+
+    for (i = 0; i < pool->workers; i++)
+        osal_thread_join(pool->threads[i]);
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&pool->lock);
+#else
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+#endif
+    free(pool->threads);
+    free(pool->worker);
+    free(pool);
+}
@@ -0,0 +1,62 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus-core - osal/thread.h                                      *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Minimal system-independent worker thread support. The emulator itself runs
+ * on a libco cothread, so these are only used for self-contained background
+ * jobs that are always joined before their results are consumed.
+ */
+
+#if !defined (OSAL_THREAD_H)
+#define OSAL_THREAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct osal_thread osal_thread;
+
+/* Starts func(arg) on a new thread. Returns NULL if no thread could be
+ * created, in which case the caller is expected to run the job itself. */
+osal_thread *osal_thread_create(void (*func)(void *), void *arg);
+
+/* Waits for the thread to finish and releases it. */
+void osal_thread_join(osal_thread *thread);
+
+/* Number of processors available to worker threads, at least 1. */
+int osal_cpu_count(void);
+
+typedef struct osal_pool osal_pool;
+
+/* Starts a pool of idle worker threads that are reused by every
+ * osal_pool_run() call. Returns NULL if not all of them could be started. */
+osal_pool *osal_pool_create(int workers);
+
+/* Runs func(args[i]) for the count jobs and returns once all are done. The
+ * calling thread runs args[0] and whatever the workers can't take. */
+void osal_pool_run(osal_pool *pool, void (*func)(void *), void **args, int count);
+
+/* Stops the workers and releases the pool. */
+void osal_pool_destroy(osal_pool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSAL_THREAD_H */
@@ -0,0 +1,350 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - ucode_id.c                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ucode_id.h"
+
+#include "memory/memory.h"
+
+#define UCODE_BYTES  0x1000
+#define UCODE_SUM    0xC00       /* the last 1KB sometimes contains trash */
+#define CACHE_SIZE   16
+
+struct ucode_family_entry
+{
+    uint32_t sum;
+    int family;
+};
+
+/* Glide64 sums, in ascending order for bsearch */
+static const struct ucode_family_entry families[] =
+{
+    { 0x006bd77f, UCODE_FAMILY_FAST3D },
+    { 0x03044b84, UCODE_FAMILY_F3DEX2 },
+    { 0x030f4b84, UCODE_FAMILY_F3DEX2 },
+    { 0x05165579, UCODE_FAMILY_F3DEX },
+    { 0x05777c62, UCODE_FAMILY_F3DEX },
+    { 0x057e7c62, UCODE_FAMILY_F3DEX },
+    { 0x07200895, UCODE_FAMILY_FAST3D },
+    { 0x0bf36d36, UCODE_FAMILY_ZSORT },
+    { 0x0d7bbffb, UCODE_FAMILY_UNSUPPORTED },
+    { 0x0d7cbffb, UCODE_FAMILY_DKR },             /* Jet Force Gemini, Mickeys Speedway Usa */
+    { 0x0ff79527, UCODE_FAMILY_F3DEX2 },
+    { 0x0ff795bf, UCODE_FAMILY_UNSUPPORTED },
+    { 0x1118b3e0, UCODE_FAMILY_F3DEX },
+    { 0x1517a281, UCODE_FAMILY_F3DEX },           /* Mini Racers */
+    { 0x168e9cd5, UCODE_FAMILY_F3DEX2 },          /* Command And Conquer */
+    { 0x1a1e18a0, UCODE_FAMILY_F3DEX2 },
+    { 0x1a1e1920, UCODE_FAMILY_F3DEX2 },
+    { 0x1a62dbaf, UCODE_FAMILY_F3DEX2 },          /* Donkey Kong 64 */
+    { 0x1a62dc2f, UCODE_FAMILY_F3DEX2 },
+    { 0x1de712ff, UCODE_FAMILY_F3DEX },
+    { 0x1ea9e30f, UCODE_FAMILY_S2DEX },
+    { 0x1f120bbb, UCODE_FAMILY_TURBO3D },
+    { 0x21f91834, UCODE_FAMILY_F3DEX2 },          /* Paper Mario */
+    { 0x21f91874, UCODE_FAMILY_F3DEX2 },
+    { 0x22099872, UCODE_FAMILY_F3DEX2 },          /* Zelda Majoras Mask */
+    { 0x24cd885b, UCODE_FAMILY_F3DEX },
+    { 0x26a7879a, UCODE_FAMILY_F3DEX },
+    { 0x299d5072, UCODE_FAMILY_S2DEX },           /* Bangaioh */
+    { 0x2b291027, UCODE_FAMILY_F3DEX2 },
+    { 0x2b5a89c2, UCODE_FAMILY_S2DEX },
+    { 0x2c7975d6, UCODE_FAMILY_F3DEX },
+    { 0x2d3fe3f1, UCODE_FAMILY_F3DEX },
+    { 0x2f71d1d5, UCODE_FAMILY_F3DEX2 },
+    { 0x2f7dd1d5, UCODE_FAMILY_F3DEX2 },
+    { 0x327b933d, UCODE_FAMILY_F3DEX },           /* Fighting Force 64 */
+    { 0x339872a6, UCODE_FAMILY_F3DEX },
+    { 0x377359b6, UCODE_FAMILY_F3DEX2 },          /* Starcraft 64 */
+    { 0x3a1c2b34, UCODE_FAMILY_FAST3D },          /* Cruisn Usa */
+    { 0x3a1cbac3, UCODE_FAMILY_FAST3D },          /* Super Mario 64 */
+    { 0x3f7247fb, UCODE_FAMILY_FAST3D },          /* Tetrisphere */
+    { 0x3ff1a4ca, UCODE_FAMILY_F3DEX },
+    { 0x4165e1fd, UCODE_FAMILY_FAST3D },
+    { 0x4340ac9b, UCODE_FAMILY_F3DEX },
+    { 0x440cfad6, UCODE_FAMILY_F3DEX },
+    { 0x47d46e86, UCODE_FAMILY_PD },              /* Perfect Dark */
+    { 0x485abff2, UCODE_FAMILY_F3DEX2 },
+    { 0x4fe6df78, UCODE_FAMILY_F3DEX },
+    { 0x5182f610, UCODE_FAMILY_FAST3D },
+    { 0x5257cd2a, UCODE_FAMILY_F3DEX },
+    { 0x5414030c, UCODE_FAMILY_F3DEX },
+    { 0x5414030d, UCODE_FAMILY_F3DEX },
+    { 0x559ff7d4, UCODE_FAMILY_F3DEX },
+    { 0x5b5d36e3, UCODE_FAMILY_SOTE },            /* Star Wars Shadow Of The Empire */
+    { 0x5b5d3763, UCODE_FAMILY_WAVERACE },        /* Waverace 64 */
+    { 0x5d1d6f53, UCODE_FAMILY_FAST3D },          /* Blast Corps, Pilotwings 64 */
+    { 0x5d3099f1, UCODE_FAMILY_F3DEX2 },          /* Zelda Oot */
+    { 0x5df1408c, UCODE_FAMILY_F3DEX },           /* Yoshis Story */
+    { 0x5ef4e34a, UCODE_FAMILY_F3DEX },
+    { 0x6075e9eb, UCODE_FAMILY_F3DEX },
+    { 0x60c1dcc4, UCODE_FAMILY_F3DEX },
+    { 0x6124a508, UCODE_FAMILY_F3DEX2 },
+    { 0x630a61fb, UCODE_FAMILY_F3DEX2 },
+    { 0x63be08b1, UCODE_FAMILY_DKR },             /* Diddy Kong Racing */
+    { 0x63be08b3, UCODE_FAMILY_DKR },
+    { 0x64ed27e5, UCODE_FAMILY_F3DEX },           /* 1080 Snowboarding */
+    { 0x65201989, UCODE_FAMILY_F3DEX2 },          /* Castlevania 64 */
+    { 0x65201a09, UCODE_FAMILY_F3DEX2 },
+    { 0x66c0b10a, UCODE_FAMILY_F3DEX },
+    { 0x679e1205, UCODE_FAMILY_F3DEX2 },
+    { 0x6bb745c9, UCODE_FAMILY_S2DEX },           /* Yoshis Story */
+    { 0x6d8f8f8a, UCODE_FAMILY_F3DEX2 },
+    { 0x6e4d50af, UCODE_FAMILY_FAST3D },
+    { 0x6eaa1da8, UCODE_FAMILY_F3DEX },
+    { 0x72a4f34e, UCODE_FAMILY_F3DEX },
+    { 0x73999a23, UCODE_FAMILY_F3DEX },
+    { 0x74af0a74, UCODE_FAMILY_S2DEX },
+    { 0x753be4a5, UCODE_FAMILY_F3DEX2 },
+    { 0x794c3e28, UCODE_FAMILY_S2DEX },
+    { 0x7df75834, UCODE_FAMILY_F3DEX },
+    { 0x7f2d0a2e, UCODE_FAMILY_F3DEX },           /* Doom 64, Turok 1 */
+    { 0x82f48073, UCODE_FAMILY_F3DEX },
+    { 0x832fcb99, UCODE_FAMILY_F3DEX },           /* Mini Racers */
+    { 0x841ce10f, UCODE_FAMILY_F3DEX },
+    { 0x844b55b5, UCODE_FAMILY_UNSUPPORTED },
+    { 0x863e1ca7, UCODE_FAMILY_F3DEX },
+    { 0x86b1593e, UCODE_FAMILY_UNSUPPORTED },     /* Star Wars Rogue Squadron */
+    { 0x8805ffea, UCODE_FAMILY_F3DEX },           /* Mario Kart 64 */
+    { 0x8d5735b2, UCODE_FAMILY_F3DEX },
+    { 0x8d5735b3, UCODE_FAMILY_F3DEX },
+    { 0x8ec3e124, UCODE_FAMILY_UNSUPPORTED },
+    { 0x93d11f7b, UCODE_FAMILY_F3DEX2 },
+    { 0x93d11ffb, UCODE_FAMILY_F3DEX2 },
+    { 0x93d1ff7b, UCODE_FAMILY_F3DEX2 },
+    { 0x9551177b, UCODE_FAMILY_F3DEX2 },          /* Fzero X */
+    { 0x955117fb, UCODE_FAMILY_F3DEX2 },
+    { 0x95cd0062, UCODE_FAMILY_F3DEX2 },          /* Biohazard 2 */
+    { 0x97d1b58a, UCODE_FAMILY_F3DEX },
+    { 0xa2d0f88e, UCODE_FAMILY_F3DEX2 },
+    { 0xa346a5cc, UCODE_FAMILY_F3DEX },           /* Wetrix, Quake 64, Star Fox 64 */
+    { 0xaa86cb1d, UCODE_FAMILY_F3DEX2 },
+    { 0xaae4a5b9, UCODE_FAMILY_F3DEX2 },
+    { 0xad0a6292, UCODE_FAMILY_F3DEX2 },
+    { 0xad0a6312, UCODE_FAMILY_F3DEX2 },
+    { 0xae08d5b9, UCODE_FAMILY_FAST3D },          /* Goldeneye 007 */
+    { 0xb1821ed3, UCODE_FAMILY_F3DEX },           /* Fighting Force 64 */
+    { 0xb4577b9c, UCODE_FAMILY_F3DEX },
+    { 0xb54e7f93, UCODE_FAMILY_FAST3D },          /* Duke Nukem 64, Robotech Crystal Dreams Proto */
+    { 0xb62f900f, UCODE_FAMILY_FAST3D },
+    { 0xba65ea1e, UCODE_FAMILY_F3DEX2 },
+    { 0xba86cb1d, UCODE_FAMILY_CBFD },            /* Conkers Bad Fur Day */
+    { 0xbc03e969, UCODE_FAMILY_FAST3D },
+    { 0xbc45382e, UCODE_FAMILY_F3DEX2 },          /* Kirby 64 Crystal Shards, Super Smash Bros */
+    { 0xbe78677c, UCODE_FAMILY_F3DEX },
+    { 0xbed8b069, UCODE_FAMILY_F3DEX },
+    { 0xc3704e41, UCODE_FAMILY_F3DEX },
+    { 0xc46dbc3d, UCODE_FAMILY_F3DEX },           /* Extreme G */
+    { 0xc901ce73, UCODE_FAMILY_F3DEX2 },          /* Mario Tennis, Mega Man 64, Ridge Racer 64 */
+    { 0xc901cef3, UCODE_FAMILY_F3DEX2 },          /* 40Winks */
+    { 0xc99a4c6c, UCODE_FAMILY_F3DEX },
+    { 0xcb8c9b6c, UCODE_FAMILY_F3DEX2 },
+    { 0xcee7920f, UCODE_FAMILY_F3DEX },
+    { 0xcfa35a45, UCODE_FAMILY_F3DEX2 },
+    { 0xd1663234, UCODE_FAMILY_F3DEX },
+    { 0xd20dedbf, UCODE_FAMILY_S2DEX },
+    { 0xd2a9f59c, UCODE_FAMILY_F3DEX },
+    { 0xd41db5f7, UCODE_FAMILY_F3DEX },
+    { 0xd5604971, UCODE_FAMILY_FAST3D },
+    { 0xd57049a5, UCODE_FAMILY_F3DEX },
+    { 0xd5c4dc96, UCODE_FAMILY_UNSUPPORTED },
+    { 0xd5d68b1f, UCODE_FAMILY_FAST3D },
+    { 0xd67c2f8b, UCODE_FAMILY_FAST3D },
+    { 0xd802ec04, UCODE_FAMILY_F3DEX },
+    { 0xda13ab96, UCODE_FAMILY_F3DEX2 },
+    { 0xde7d67d4, UCODE_FAMILY_F3DEX2 },
+    { 0xe1290fa2, UCODE_FAMILY_F3DEX2 },
+    { 0xe41ec47e, UCODE_FAMILY_FAST3D },          /* Killer Instinct Gold, Mischief Makers, Mortal Kombat Trilogy */
+    { 0xe65cb4ad, UCODE_FAMILY_F3DEX2 },
+    { 0xe89c2b92, UCODE_FAMILY_F3DEX },           /* Wipeout 64 */
+    { 0xe9231df2, UCODE_FAMILY_F3DEX },
+    { 0xec040469, UCODE_FAMILY_F3DEX },
+    { 0xee47381b, UCODE_FAMILY_F3DEX },           /* Dual Heroes, Hexen 64, Chameleon Twist, Banjo Kazooie, Mace The Dark Age */
+    { 0xef54ee35, UCODE_FAMILY_F3DEX },
+    { 0xf9893f70, UCODE_FAMILY_TURBO3D },
+    { 0xfb816260, UCODE_FAMILY_F3DEX },
+    { 0xff372492, UCODE_FAMILY_TURBO3D },
+};
+
+struct cache_entry
+{
+    struct ucode_info info;
+    unsigned int generation;
+    uint32_t samples[4];        /* words the CPU may have stored to since */
+    unsigned int sum_length;    /* last ucode_id_byte_sum() request */
+    unsigned int byte_sum;
+};
+
+static struct cache_entry cache[CACHE_SIZE];
+static unsigned int next_entry;
+static unsigned int generation = 1;     /* 0 marks a free entry */
+static uint32_t crc_table[256];
+
+static const uint32_t sample_offsets[4] = { 0, 0x400, 0x800, UCODE_SUM - 4 };
+
+static uint32_t crc32_update(uint32_t crc, const unsigned char *bytes, unsigned int length)
+{
+    unsigned int i;
+
+    if (crc_table[1] == 0)
+    {
+        for (i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            int k;
+            for (k = 0; k < 8; k++)
+                c = (c & 1) ? (c >> 1) ^ 0xEDB88320 : c >> 1;
+            crc_table[i] = c;
+        }
+    }
+
+    crc = ~crc;
+    for (i = 0; i < length; i++)
+        crc = crc_table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static int compare_sum(const void *key, const void *entry)
+{
+    uint32_t sum = *(const uint32_t *)key;
+    uint32_t other = ((const struct ucode_family_entry *)entry)->sum;
+    return (sum > other) - (sum < other);
+}
+
+/* Copies the ucode out of RDRAM, zero past the end of it */
+static void read_ucode(unsigned char *dst, uint32_t address, unsigned int length)
+{
+    unsigned int avail = 0x800000 - address;
+
+    if (avail > length)
+        avail = length;
+    memcpy(dst, (const unsigned char *)rdram + address, avail);
+    memset(dst + avail, 0, length - avail);
+}
+
+static void read_samples(uint32_t *samples, uint32_t address)
+{
+    unsigned int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        uint32_t offset = address + sample_offsets[i];
+        samples[i] = offset + 4 <= 0x800000 ? *(const uint32_t *)((const unsigned char *)rdram + offset) : 0;
+    }
+}
+
+static struct cache_entry *find_entry(uint32_t address)
+{
+    unsigned char ucode[UCODE_BYTES];
+    struct cache_entry *entry;
+    const struct ucode_family_entry *known;
+    uint32_t samples[4], word;
+    unsigned int i;
+
+    address &= 0x7FFFFF;
+    read_samples(samples, address);
+
+    for (i = 0; i < CACHE_SIZE; i++)
+    {
+        entry = &cache[i];
+        if (entry->generation == generation && entry->info.address == address
+                && memcmp(entry->samples, samples, sizeof(samples)) == 0)
+            return entry;
+    }
+
+    entry = &cache[next_entry];
+    next_entry = (next_entry + 1) % CACHE_SIZE;
+
+    read_ucode(ucode, address, UCODE_BYTES);
+    entry->info.address = address;
+    entry->info.sum = 0;
+    for (i = 0; i < UCODE_SUM; i += 4)
+    {
+        memcpy(&word, ucode + i, 4);
+        entry->info.sum += word;
+    }
+    entry->info.crc_2k = crc32_update(0, ucode, UCODE_BYTES / 2);
+    entry->info.crc_4k = crc32_update(entry->info.crc_2k, ucode + UCODE_BYTES / 2, UCODE_BYTES / 2);
+
+    known = (const struct ucode_family_entry *)bsearch(&entry->info.sum, families,
+            sizeof(families) / sizeof(families[0]), sizeof(families[0]), compare_sum);
+    entry->info.family = known ? known->family : UCODE_FAMILY_UNKNOWN;
+
+    memcpy(entry->samples, samples, sizeof(samples));
+    entry->sum_length = 0;
+    entry->byte_sum = 0;
+    entry->generation = generation;
+    return entry;
+}
+
+const struct ucode_info *ucode_id_lookup(uint32_t address)
+{
+    return &find_entry(address)->info;
+}
+
+unsigned int ucode_id_byte_sum(uint32_t address, unsigned int length)
+{
+    struct cache_entry *entry = find_entry(address);
+
+    if (length > UCODE_BYTES)
+        length = UCODE_BYTES;
+
+    if (entry->sum_length != length)
+    {
+        unsigned char ucode[UCODE_BYTES];
+        unsigned int i, sum = 0;
+
+        read_ucode(ucode, entry->info.address, length);
+        for (i = 0; i < length; i++)
+            sum += ucode[i];
+        entry->sum_length = length;
+        entry->byte_sum = sum;
+    }
+    return entry->byte_sum;
+}
+
+void ucode_id_rdram_written(uint32_t address, uint32_t length)
+{
+    unsigned int i;
+
+    address &= 0x7FFFFF;
+    for (i = 0; i < CACHE_SIZE; i++)
+    {
+        if (cache[i].generation == generation
+                && address < cache[i].info.address + UCODE_BYTES
+                && cache[i].info.address < address + length)
+        {
+            /* a new generation drops every entry, DMAs over ucode are rare */
+            ucode_id_reset();
+            return;
+        }
+    }
+}
+
+void ucode_id_reset(void)
+{
+    if (++generation == 0)
+    {
+        memset(cache, 0, sizeof(cache));
+        generation = 1;
+    }
+}
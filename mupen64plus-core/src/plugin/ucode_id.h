@@ -0,0 +1,83 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - ucode_id.h                                              *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __UCODE_ID_H__
+#define __UCODE_ID_H__
+
+/* Microcode identification shared by the RSP and video plugins.
+ *
+ * The first 4KB of a ucode in RDRAM are hashed once and the result is
+ * cached by RDRAM address until the core DMAs over that range or a load
+ * state replaces RDRAM. Each plugin keeps its own fingerprint flavour,
+ * since its tables are keyed by it; the family comes from a sorted table
+ * keyed by the Glide64 sum. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Glide64's numbering of the graphics ucodes (settings.ucode) */
+enum ucode_family
+{
+    UCODE_FAMILY_UNKNOWN     = -2,   /* not in the table */
+    UCODE_FAMILY_UNSUPPORTED = -1,   /* known, but no plugin emulates it */
+    UCODE_FAMILY_FAST3D      = 0,    /* RSP SW 2.0X (Super Mario 64) */
+    UCODE_FAMILY_F3DEX       = 1,
+    UCODE_FAMILY_F3DEX2      = 2,
+    UCODE_FAMILY_WAVERACE    = 3,    /* F3DEX variant of Wave Race 64 */
+    UCODE_FAMILY_SOTE        = 4,    /* RSP SW 2.0D EXT (Shadows of the Empire) */
+    UCODE_FAMILY_DKR         = 5,    /* Diddy Kong Racing, Jet Force Gemini */
+    UCODE_FAMILY_S2DEX       = 6,
+    UCODE_FAMILY_PD          = 7,    /* Perfect Dark */
+    UCODE_FAMILY_CBFD        = 8,    /* F3DEXBG 2.08 (Conker's Bad Fur Day) */
+    UCODE_FAMILY_ZSORT       = 9,    /* Battle for Naboo */
+    UCODE_FAMILY_TURBO3D     = 21
+};
+
+struct ucode_info
+{
+    uint32_t address;   /* RDRAM offset of the ucode text */
+    uint32_t sum;       /* sum of the first 3KB as host order words (Glide64) */
+    uint32_t crc_2k;    /* crc32 of the first 2KB of host memory (Rice) */
+    uint32_t crc_4k;    /* crc32 of the first 4KB of host memory (gles2n64) */
+    int family;         /* enum ucode_family */
+};
+
+/* Fingerprints of the ucode at address. The pointer stays valid until the
+ * next call. */
+const struct ucode_info *ucode_id_lookup(uint32_t address);
+
+/* Sum of the first length bytes of the ucode at address, length at most
+ * 4KB (mupen64plus-rsp-hle task identification). */
+unsigned int ucode_id_byte_sum(uint32_t address, unsigned int length);
+
+/* Called by the core whenever it writes RDRAM behind the CPU's back */
+void ucode_id_rdram_written(uint32_t address, uint32_t length);
+
+/* Forgets every cached ucode, for reset and load state */
+void ucode_id_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __UCODE_ID_H__ */
@@ -227,7 +227,7 @@ static u_int jump_table_symbols[] = {
   (int)neg_d
 };
 
-static unsigned int needs_clear_cache[1<<(TARGET_SIZE_2-17)];
+static unsigned int needs_clear_cache[1<<(TARGET_SIZE_2_MAX-17)];
 
 #define JUMP_TABLE_SIZE (sizeof(jump_table_symbols)*2)
 
@@ -997,7 +997,7 @@ static u_int genjmp(u_int addr)
     {
       if(addr==jump_table_symbols[n])
       {
-        offset=BASE_ADDR+(1<<TARGET_SIZE_2)-JUMP_TABLE_SIZE+n*8-(int)out-8;
+        offset=BASE_ADDR+(1<<target_size_2)-JUMP_TABLE_SIZE+n*8-(int)out-8;
         break;
       }
     }
@@ -4500,7 +4500,7 @@ static void wb_invalidate_arm(signed char pre[],signed char entry[],uint64_t dir
 static void do_clear_cache()
 {
   int i,j;
-  for (i=0;i<(1<<(TARGET_SIZE_2-17));i++)
+  for (i=0;i<(1<<(target_size_2-17));i++)
   {
     u_int bitmap=needs_clear_cache[i];
     if(bitmap) {
@@ -4547,7 +4547,7 @@ static void arch_init() {
   // Trampolines for jumps >32M
   int *ptr,*ptr2;
   ptr=(int *)jump_table_symbols;
-  ptr2=(int *)((void *)BASE_ADDR+(1<<TARGET_SIZE_2)-JUMP_TABLE_SIZE);
+  ptr2=(int *)((void *)BASE_ADDR+(1<<target_size_2)-JUMP_TABLE_SIZE);
   while((void *)ptr<(void *)jump_table_symbols+sizeof(jump_table_symbols))
   {
     int offset=*ptr-(int)ptr2-8;
@@ -4566,9 +4566,9 @@ static void arch_init() {
   // If part of the cache is beyond the 32M limit, avoid using this area
   // initially.  It will be used later if the cache gets full.
   if((u_int)dyna_linker-33554432>(u_int)BASE_ADDR) {
-    if((u_int)dyna_linker-33554432<(u_int)BASE_ADDR+(1<<(TARGET_SIZE_2-1))) {
+    if((u_int)dyna_linker-33554432<(u_int)BASE_ADDR+(1<<(target_size_2-1))) {
       out=(u_char *)(((u_int)dyna_linker-33554432)&~4095);
-      expirep=((((int)out-BASE_ADDR)>>(TARGET_SIZE_2-16))+16384)&65535;
+      expirep=((((int)out-BASE_ADDR)>>(target_size_2-16))+16384)&65535;
     }
   }
 }
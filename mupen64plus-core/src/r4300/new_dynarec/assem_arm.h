@@ -39,5 +39,6 @@ extern char *invc_ptr;
 extern char extra_memory[33554432];
 
 #define BASE_ADDR ((int)(&extra_memory))
-//#define TARGET_SIZE_2 24 // 2^24 = 16 megabytes
-#define TARGET_SIZE_2 25 // 2^25 = 32 megabytes
+// The translation cache size is picked at runtime, see new_dynarec_init()
+#define TARGET_SIZE_2_MIN 22 // 2^22 = 4 megabytes
+#define TARGET_SIZE_2_MAX 25 // 2^25 = 32 megabytes
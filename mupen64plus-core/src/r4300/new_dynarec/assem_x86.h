@@ -12,7 +12,9 @@
 #define USE_MINI_HT 1
 
 extern void *base_addr; // Code generator target address
-#define TARGET_SIZE_2 25 // 2^25 = 32 megabytes
+// The translation cache size is picked at runtime, see new_dynarec_init()
+#define TARGET_SIZE_2_MIN 22 // 2^22 = 4 megabytes
+#define TARGET_SIZE_2_MAX 25 // 2^25 = 32 megabytes
 #define JUMP_TABLE_SIZE 0 // Not needed for 32-bit x86
 
 /* x86 calling convention:
@@ -40,6 +40,8 @@ typedef unsigned int u_int;
 #include "new_dynarec.h"
 
 #include "../../memory/memory.h"
+#include "../../main/main.h"
+#include "../../main/memusage.h"
 #include "../../main/rom.h"
 
 #include <sys/mman.h>
@@ -53,10 +55,19 @@ typedef unsigned int u_int;
 #endif
 
 #define MAXBLOCK 4096
+#define MAXBLOCK_LOWMEM 1024 // Shorter blocks, 1/4 of the per-compile tables
 #define MAX_OUTPUT_BLOCK_SIZE 262144
+
+// Pass 10 expires the cache an eighth at a time, a block must fit in one
+#if (1<<(TARGET_SIZE_2_MIN-3)) <= MAX_OUTPUT_BLOCK_SIZE
+#error Translation cache too small for MAX_OUTPUT_BLOCK_SIZE
+#endif
 #define CLOCK_DIVIDER count_per_op
 
 void *base_addr;
+int new_dynarec_cache_mb;
+static int target_size_2;
+static int maxblock; // MAXBLOCK or MAXBLOCK_LOWMEM
 
 struct regstat
 {
@@ -84,50 +95,50 @@ struct ll_entry
 static u_int start;
 static u_int *source;
 static u_int pagelimit;
-static char insn[MAXBLOCK][10];
-static u_char itype[MAXBLOCK];
-static u_char opcode[MAXBLOCK];
-static u_char opcode2[MAXBLOCK];
-static u_char bt[MAXBLOCK];
-static u_char rs1[MAXBLOCK];
-static u_char rs2[MAXBLOCK];
-static u_char rt1[MAXBLOCK];
-static u_char rt2[MAXBLOCK];
-static u_char us1[MAXBLOCK];
-static u_char us2[MAXBLOCK];
-static u_char dep1[MAXBLOCK];
-static u_char dep2[MAXBLOCK];
-static u_char lt1[MAXBLOCK];
-static int imm[MAXBLOCK];
-static u_int ba[MAXBLOCK];
-static char likely[MAXBLOCK];
-static char is_ds[MAXBLOCK];
-static char ooo[MAXBLOCK];
-static uint64_t unneeded_reg[MAXBLOCK];
-static uint64_t unneeded_reg_upper[MAXBLOCK];
-static uint64_t branch_unneeded_reg[MAXBLOCK];
-static uint64_t branch_unneeded_reg_upper[MAXBLOCK];
-static uint64_t p32[MAXBLOCK];
-static uint64_t pr32[MAXBLOCK];
-static signed char regmap_pre[MAXBLOCK][HOST_REGS];
+static char (*insn)[10];
+static u_char *itype;
+static u_char *opcode;
+static u_char *opcode2;
+static u_char *bt;
+static u_char *rs1;
+static u_char *rs2;
+static u_char *rt1;
+static u_char *rt2;
+static u_char *us1;
+static u_char *us2;
+static u_char *dep1;
+static u_char *dep2;
+static u_char *lt1;
+static int *imm;
+static u_int *ba;
+static char *likely;
+static char *is_ds;
+static char *ooo;
+static uint64_t *unneeded_reg;
+static uint64_t *unneeded_reg_upper;
+static uint64_t *branch_unneeded_reg;
+static uint64_t *branch_unneeded_reg_upper;
+static uint64_t *p32;
+static uint64_t *pr32;
+static signed char (*regmap_pre)[HOST_REGS];
 #ifdef ASSEM_DEBUG
-static signed char regmap[MAXBLOCK][HOST_REGS];
-static signed char regmap_entry[MAXBLOCK][HOST_REGS];
+static signed char (*regmap)[HOST_REGS];
+static signed char (*regmap_entry)[HOST_REGS];
 #endif
-static uint64_t constmap[MAXBLOCK][HOST_REGS];
-static struct regstat regs[MAXBLOCK];
-static struct regstat branch_regs[MAXBLOCK];
-static signed char minimum_free_regs[MAXBLOCK];
-static u_int needed_reg[MAXBLOCK];
-static uint64_t requires_32bit[MAXBLOCK];
-static u_int wont_dirty[MAXBLOCK];
-static u_int will_dirty[MAXBLOCK];
-static int ccadj[MAXBLOCK];
+static uint64_t (*constmap)[HOST_REGS];
+static struct regstat *regs;
+static struct regstat *branch_regs;
+static signed char *minimum_free_regs;
+static u_int *needed_reg;
+static uint64_t *requires_32bit;
+static u_int *wont_dirty;
+static u_int *will_dirty;
+static int *ccadj;
 static int slen;
-static u_int instr_addr[MAXBLOCK];
-static u_int link_addr[MAXBLOCK][3];
+static u_int *instr_addr;
+static u_int (*link_addr)[3];
 static int linkcount;
-static u_int stubs[MAXBLOCK*3][8];
+static u_int (*stubs)[8];
 static int stubcount;
 static int literalcount;
 static int is_delayslot;
@@ -136,8 +147,44 @@ u_char *out;
 struct ll_entry *jump_in[4096];
 static struct ll_entry *jump_out[4096];
 struct ll_entry *jump_dirty[4096];
+// Fixed size whatever the cache size: the emitted code indexes it directly
 u_int hash_table[65536][4]  __attribute__((aligned(16)));
-static char shadow[2097152]  __attribute__((aligned(16)));
+static char *shadow;
+static u_int shadow_size;
+
+// The per-compile tables above hold maxblock entries each and share one
+// mapping, made by new_dynarec_init()
+#define COMPILE_TABLE(array,count) { (void **)&array, sizeof(*array)*(count) }
+static const struct
+{
+  void **array;
+  u_int size; // for MAXBLOCK entries
+} compile_tables[] = {
+  COMPILE_TABLE(insn,MAXBLOCK), COMPILE_TABLE(itype,MAXBLOCK),
+  COMPILE_TABLE(opcode,MAXBLOCK), COMPILE_TABLE(opcode2,MAXBLOCK),
+  COMPILE_TABLE(bt,MAXBLOCK), COMPILE_TABLE(rs1,MAXBLOCK),
+  COMPILE_TABLE(rs2,MAXBLOCK), COMPILE_TABLE(rt1,MAXBLOCK),
+  COMPILE_TABLE(rt2,MAXBLOCK), COMPILE_TABLE(us1,MAXBLOCK),
+  COMPILE_TABLE(us2,MAXBLOCK), COMPILE_TABLE(dep1,MAXBLOCK),
+  COMPILE_TABLE(dep2,MAXBLOCK), COMPILE_TABLE(lt1,MAXBLOCK),
+  COMPILE_TABLE(imm,MAXBLOCK), COMPILE_TABLE(ba,MAXBLOCK),
+  COMPILE_TABLE(likely,MAXBLOCK), COMPILE_TABLE(is_ds,MAXBLOCK),
+  COMPILE_TABLE(ooo,MAXBLOCK), COMPILE_TABLE(unneeded_reg,MAXBLOCK),
+  COMPILE_TABLE(unneeded_reg_upper,MAXBLOCK), COMPILE_TABLE(branch_unneeded_reg,MAXBLOCK),
+  COMPILE_TABLE(branch_unneeded_reg_upper,MAXBLOCK), COMPILE_TABLE(p32,MAXBLOCK),
+  COMPILE_TABLE(pr32,MAXBLOCK), COMPILE_TABLE(regmap_pre,MAXBLOCK),
+#ifdef ASSEM_DEBUG
+  COMPILE_TABLE(regmap,MAXBLOCK), COMPILE_TABLE(regmap_entry,MAXBLOCK),
+#endif
+  COMPILE_TABLE(constmap,MAXBLOCK), COMPILE_TABLE(regs,MAXBLOCK),
+  COMPILE_TABLE(branch_regs,MAXBLOCK), COMPILE_TABLE(minimum_free_regs,MAXBLOCK),
+  COMPILE_TABLE(needed_reg,MAXBLOCK), COMPILE_TABLE(requires_32bit,MAXBLOCK),
+  COMPILE_TABLE(wont_dirty,MAXBLOCK), COMPILE_TABLE(will_dirty,MAXBLOCK),
+  COMPILE_TABLE(ccadj,MAXBLOCK), COMPILE_TABLE(instr_addr,MAXBLOCK),
+  COMPILE_TABLE(link_addr,MAXBLOCK), COMPILE_TABLE(stubs,MAXBLOCK*3)
+};
+static char *compile_mem;
+static u_int compile_mem_size;
 static void *copy;
 static int expirep;
 u_int using_tlb;
@@ -370,9 +417,9 @@ void *get_addr(u_int vaddr)
 {
   u_int page=(vaddr^0x80000000)>>12;
   u_int vpage=page;
-  if(page>262143&&tlb_LUT_r[vaddr>>12]) page=(tlb_LUT_r[vaddr>>12]^0x80000000)>>12;
+  if(page>262143&&tlb_lut_r(vaddr>>12)) page=(tlb_lut_r(vaddr>>12)^0x80000000)>>12;
   if(page>2048) page=2048+(page&2047);
-  if(vpage>262143&&tlb_LUT_r[vaddr>>12]) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
+  if(vpage>262143&&tlb_lut_r(vaddr>>12)) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
   if(vpage>2048) vpage=2048+(vpage&2047);
   struct ll_entry *head;
   //DebugMessage(M64MSG_VERBOSE, "TRACE: count=%d next=%d (get_addr %x,page %d)",Count,next_interupt,vaddr,page);
@@ -394,15 +441,15 @@ void *get_addr(u_int vaddr)
     if(head->vaddr==vaddr&&head->reg32==0) {
       //DebugMessage(M64MSG_VERBOSE, "TRACE: count=%d next=%d (get_addr match dirty %x: %x)",Count,next_interupt,vaddr,(int)head->addr);
       // Don't restore blocks which are about to expire from the cache
-      if((((u_int)head->addr-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2)))
+      if((((u_int)head->addr-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2)))
       if(verify_dirty(head->addr)) {
         //DebugMessage(M64MSG_VERBOSE, "restore candidate: %x (%d) d=%d",vaddr,page,invalid_code[vaddr>>12]);
         invalid_code[vaddr>>12]=0;
         memory_map[vaddr>>12]|=0x40000000;
         if(vpage<2048) {
-          if(tlb_LUT_r[vaddr>>12]) {
-            invalid_code[tlb_LUT_r[vaddr>>12]>>12]=0;
-            memory_map[tlb_LUT_r[vaddr>>12]>>12]|=0x40000000;
+          if(tlb_lut_r(vaddr>>12)) {
+            invalid_code[tlb_lut_r(vaddr>>12)>>12]=0;
+            memory_map[tlb_lut_r(vaddr>>12)>>12]|=0x40000000;
           }
           restore_candidate[vpage>>3]|=1<<(vpage&7);
         }
@@ -453,9 +500,9 @@ void *get_addr_32(u_int vaddr,u_int flags)
   if(ht_bin[2]==vaddr) return (void *)ht_bin[3];
   u_int page=(vaddr^0x80000000)>>12;
   u_int vpage=page;
-  if(page>262143&&tlb_LUT_r[vaddr>>12]) page=(tlb_LUT_r[vaddr>>12]^0x80000000)>>12;
+  if(page>262143&&tlb_lut_r(vaddr>>12)) page=(tlb_lut_r(vaddr>>12)^0x80000000)>>12;
   if(page>2048) page=2048+(page&2047);
-  if(vpage>262143&&tlb_LUT_r[vaddr>>12]) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
+  if(vpage>262143&&tlb_lut_r(vaddr>>12)) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
   if(vpage>2048) vpage=2048+(vpage&2047);
   struct ll_entry *head;
   head=jump_in[page];
@@ -485,15 +532,15 @@ void *get_addr_32(u_int vaddr,u_int flags)
     if(head->vaddr==vaddr&&(head->reg32&flags)==0) {
       //DebugMessage(M64MSG_VERBOSE, "TRACE: count=%d next=%d (get_addr_32 match dirty %x: %x)",Count,next_interupt,vaddr,(int)head->addr);
       // Don't restore blocks which are about to expire from the cache
-      if((((u_int)head->addr-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2)))
+      if((((u_int)head->addr-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2)))
       if(verify_dirty(head->addr)) {
         //DebugMessage(M64MSG_VERBOSE, "restore candidate: %x (%d) d=%d",vaddr,page,invalid_code[vaddr>>12]);
         invalid_code[vaddr>>12]=0;
         memory_map[vaddr>>12]|=0x40000000;
         if(vpage<2048) {
-          if(tlb_LUT_r[vaddr>>12]) {
-            invalid_code[tlb_LUT_r[vaddr>>12]>>12]=0;
-            memory_map[tlb_LUT_r[vaddr>>12]>>12]|=0x40000000;
+          if(tlb_lut_r(vaddr>>12)) {
+            invalid_code[tlb_lut_r(vaddr>>12)>>12]=0;
+            memory_map[tlb_lut_r(vaddr>>12)>>12]|=0x40000000;
           }
           restore_candidate[vpage>>3]|=1<<(vpage&7);
         }
@@ -1019,21 +1066,21 @@ static void *check_addr(u_int vaddr)
 {
   u_int *ht_bin=hash_table[((vaddr>>16)^vaddr)&0xFFFF];
   if(ht_bin[0]==vaddr) {
-    if(((ht_bin[1]-MAX_OUTPUT_BLOCK_SIZE-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2)))
+    if(((ht_bin[1]-MAX_OUTPUT_BLOCK_SIZE-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2)))
       if(isclean(ht_bin[1])) return (void *)ht_bin[1];
   }
   if(ht_bin[2]==vaddr) {
-    if(((ht_bin[3]-MAX_OUTPUT_BLOCK_SIZE-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2)))
+    if(((ht_bin[3]-MAX_OUTPUT_BLOCK_SIZE-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2)))
       if(isclean(ht_bin[3])) return (void *)ht_bin[3];
   }
   u_int page=(vaddr^0x80000000)>>12;
-  if(page>262143&&tlb_LUT_r[vaddr>>12]) page=(tlb_LUT_r[vaddr>>12]^0x80000000)>>12;
+  if(page>262143&&tlb_lut_r(vaddr>>12)) page=(tlb_lut_r(vaddr>>12)^0x80000000)>>12;
   if(page>2048) page=2048+(page&2047);
   struct ll_entry *head;
   head=jump_in[page];
   while(head!=NULL) {
     if(head->vaddr==vaddr&&head->reg32==0) {
-      if((((u_int)head->addr-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2))) {
+      if((((u_int)head->addr-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2))) {
         // Update existing entry with current address
         if(ht_bin[0]==vaddr) {
           ht_bin[1]=(int)head->addr;
@@ -1160,9 +1207,9 @@ void invalidate_block(u_int block)
 {
   u_int page,vpage;
   page=vpage=block^0x80000;
-  if(page>262143&&tlb_LUT_r[block]) page=(tlb_LUT_r[block]^0x80000000)>>12;
+  if(page>262143&&tlb_lut_r(block)) page=(tlb_lut_r(block)^0x80000000)>>12;
   if(page>2048) page=2048+(page&2047);
-  if(vpage>262143&&tlb_LUT_r[block]) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
+  if(vpage>262143&&tlb_lut_r(block)) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
   if(vpage>2048) vpage=2048+(vpage&2047);
   inv_debug("INVALIDATE: %x (%d)\n",block<<12,page);
   //inv_debug("invalid_code[block]=%d\n",invalid_code[block]);
@@ -1210,11 +1257,11 @@ void invalidate_block(u_int block)
   // Don't trap writes
   invalid_code[block]=1;
   // If there is a valid TLB entry for this page, remove write protect
-  if(tlb_LUT_w[block]) {
-    assert(tlb_LUT_r[block]==tlb_LUT_w[block]);
+  if(tlb_lut_w(block)) {
+    assert(tlb_lut_r(block)==tlb_lut_w(block));
     // CHECK: Is this right?
-    memory_map[block]=((tlb_LUT_w[block]&0xFFFFF000)-(block<<12)+(unsigned int)rdram-0x80000000)>>2;
-    u_int real_block=tlb_LUT_w[block]>>12;
+    memory_map[block]=((tlb_lut_w(block)&0xFFFFF000)-(block<<12)+(unsigned int)rdram-0x80000000)>>2;
+    u_int real_block=tlb_lut_w(block)>>12;
     invalid_code[real_block]=1;
     if(real_block>=0x80000&&real_block<0x80800) memory_map[real_block]=((u_int)rdram-0x80000000)>>2;
   }
@@ -1244,17 +1291,17 @@ void invalidate_all_pages()
       restore_candidate[((page&2047)>>3)+256]|=1<<(page&7);
     }
   #if NEW_DYNAREC == NEW_DYNAREC_ARM
-  __clear_cache((void *)base_addr,(void *)base_addr+(1<<TARGET_SIZE_2));
-  //cacheflush((void *)base_addr,(void *)base_addr+(1<<TARGET_SIZE_2),0);
+  __clear_cache((void *)base_addr,(void *)base_addr+(1<<target_size_2));
+  //cacheflush((void *)base_addr,(void *)base_addr+(1<<target_size_2),0);
   #endif
   #ifdef USE_MINI_HT
   memset(mini_ht,-1,sizeof(mini_ht));
   #endif
   // TLB
   for(page=0;page<0x100000;page++) {
-    if(tlb_LUT_r[page]) {
-      memory_map[page]=((tlb_LUT_r[page]&0xFFFFF000)-(page<<12)+(unsigned int)rdram-0x80000000)>>2;
-      if(!tlb_LUT_w[page]||!invalid_code[page])
+    if(tlb_lut_r(page)) {
+      memory_map[page]=((tlb_lut_r(page)&0xFFFFF000)-(page<<12)+(unsigned int)rdram-0x80000000)>>2;
+      if(!tlb_lut_w(page)||!invalid_code[page])
         memory_map[page]|=0x40000000; // Write protect
     }
     else memory_map[page]=-1;
@@ -1267,7 +1314,7 @@ void invalidate_all_pages()
 void add_link(u_int vaddr,void *src)
 {
   u_int page=(vaddr^0x80000000)>>12;
-  if(page>262143&&tlb_LUT_r[vaddr>>12]) page=(tlb_LUT_r[vaddr>>12]^0x80000000)>>12;
+  if(page>262143&&tlb_lut_r(vaddr>>12)) page=(tlb_lut_r(vaddr>>12)^0x80000000)>>12;
   if(page>4095) page=2048+(page&2047);
   inv_debug("add_link: %x -> %x (%d)\n",(int)src,vaddr,page);
   ll_add(jump_out+page,vaddr,src);
@@ -1287,7 +1334,7 @@ void clean_blocks(u_int page)
   while(head!=NULL) {
     if(!invalid_code[head->vaddr>>12]) {
       // Don't restore blocks which are about to expire from the cache
-      if((((u_int)head->addr-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2))) {
+      if((((u_int)head->addr-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2))) {
         u_int start,end;
         if(verify_dirty(head->addr)) {
           //DebugMessage(M64MSG_VERBOSE, "Possibly Restore %x (%x)",head->vaddr, (int)head->addr);
@@ -1309,9 +1356,9 @@ void clean_blocks(u_int page)
           }
           if(!inv) {
             void * clean_addr=(void *)get_clean_addr((int)head->addr);
-            if((((u_int)clean_addr-(u_int)out)<<(32-TARGET_SIZE_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-TARGET_SIZE_2))) {
+            if((((u_int)clean_addr-(u_int)out)<<(32-target_size_2))>0x60000000+(MAX_OUTPUT_BLOCK_SIZE<<(32-target_size_2))) {
               u_int ppage=page;
-              if(page<2048&&tlb_LUT_r[head->vaddr>>12]) ppage=(tlb_LUT_r[head->vaddr>>12]^0x80000000)>>12;
+              if(page<2048&&tlb_lut_r(head->vaddr>>12)) ppage=(tlb_lut_r(head->vaddr>>12)^0x80000000)>>12;
               inv_debug("INV: Restored %x (%x/%x)\n",head->vaddr, (int)head->addr, (int)clean_addr);
               //DebugMessage(M64MSG_VERBOSE, "page=%x, addr=%x",page,head->vaddr);
               //assert(head->vaddr>>12==(page|0x80000));
@@ -6377,9 +6424,9 @@ static void pagespan_ds()
   u_int vaddr=start+1;
   u_int page=(0x80000000^vaddr)>>12;
   u_int vpage=page;
-  if(page>262143&&tlb_LUT_r[vaddr>>12]) page=(tlb_LUT_r[page^0x80000]^0x80000000)>>12;
+  if(page>262143&&tlb_lut_r(vaddr>>12)) page=(tlb_lut_r(page^0x80000)^0x80000000)>>12;
   if(page>2048) page=2048+(page&2047);
-  if(vpage>262143&&tlb_LUT_r[vaddr>>12]) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
+  if(vpage>262143&&tlb_lut_r(vaddr>>12)) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
   if(vpage>2048) vpage=2048+(vpage&2047);
   ll_add(jump_dirty+vpage,vaddr,(void *)out);
   do_dirty_stub_ds();
@@ -7571,13 +7618,47 @@ void new_dynarec_init()
 {
   DebugMessage(M64MSG_INFO, "Init new dynarec");
 
+  // Translation cache: 32MB, 8MB in low memory mode, or the size asked for
+  target_size_2=g_LowMemory?TARGET_SIZE_2_MIN+1:TARGET_SIZE_2_MAX;
+  if(new_dynarec_cache_mb>0) {
+    target_size_2=TARGET_SIZE_2_MAX;
+    while(target_size_2>TARGET_SIZE_2_MIN&&(1<<(target_size_2-20))>new_dynarec_cache_mb)
+      target_size_2--;
+  }
+  // Copies of the source code of compiled blocks, used to detect changes
+  shadow_size=g_LowMemory?524288:2097152;
+  if ((shadow = mmap (NULL, shadow_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0)) == MAP_FAILED) {DebugMessage(M64MSG_ERROR, "mmap() failed");}
+
+  // Per-compile tables, for blocks of up to maxblock instructions
+  u_int t;
+  maxblock=g_LowMemory?MAXBLOCK_LOWMEM:MAXBLOCK;
+  compile_mem_size=0;
+  for(t=0;t<sizeof(compile_tables)/sizeof(compile_tables[0]);t++)
+    compile_mem_size+=((compile_tables[t].size/MAXBLOCK*maxblock)+15)&~15;
+  if ((compile_mem = mmap (NULL, compile_mem_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS,
+            -1, 0)) == MAP_FAILED) {DebugMessage(M64MSG_ERROR, "mmap() failed");compile_mem=NULL;}
+  else {
+    char *next=compile_mem;
+    for(t=0;t<sizeof(compile_tables)/sizeof(compile_tables[0]);t++) {
+      *compile_tables[t].array=next;
+      next+=((compile_tables[t].size/MAXBLOCK*maxblock)+15)&~15;
+    }
+  }
+  DebugMessage(M64MSG_INFO, "Translation cache %d KB, shadow buffer %d KB, compile tables %d KB",
+               (1<<target_size_2)>>10, shadow_size>>10, compile_mem_size>>10);
+
 #if NEW_DYNAREC == NEW_DYNAREC_ARM
-  if ((base_addr = mmap ((u_char *)BASE_ADDR, 1<<TARGET_SIZE_2,
+  if ((base_addr = mmap ((u_char *)BASE_ADDR, 1<<target_size_2,
             PROT_READ | PROT_WRITE | PROT_EXEC,
             MAP_FIXED | MAP_PRIVATE | MAP_ANONYMOUS,
             -1, 0)) <= 0) {DebugMessage(M64MSG_ERROR, "mmap() failed");}
 #else
-  if ((base_addr = mmap (NULL, 1<<TARGET_SIZE_2,
+  if ((base_addr = mmap (NULL, 1<<target_size_2,
             PROT_READ | PROT_WRITE | PROT_EXEC,
             MAP_PRIVATE | MAP_ANONYMOUS,
             -1, 0)) <= 0) {DebugMessage(M64MSG_ERROR, "mmap() failed");}
@@ -7645,7 +7726,11 @@ void new_dynarec_init()
 void new_dynarec_cleanup()
 {
   int n;
-  if (munmap (base_addr, 1<<TARGET_SIZE_2) < 0) {DebugMessage(M64MSG_ERROR, "munmap() failed");}
+  if (munmap (base_addr, 1<<target_size_2) < 0) {DebugMessage(M64MSG_ERROR, "munmap() failed");}
+  if (munmap (shadow, shadow_size) < 0) {DebugMessage(M64MSG_ERROR, "munmap() failed");}
+  shadow=NULL;
+  if (munmap (compile_mem, compile_mem_size) < 0) {DebugMessage(M64MSG_ERROR, "munmap() failed");}
+  compile_mem=NULL;
   for(n=0;n<4096;n++) ll_clear(jump_in+n);
   for(n=0;n<4096;n++) ll_clear(jump_out+n);
   for(n=0;n<4096;n++) ll_clear(jump_dirty+n);
@@ -7654,6 +7739,35 @@ void new_dynarec_cleanup()
   #endif
 }
 
+// Allocated and resident size of the translation cache and of the larger
+// tables, for memusage_report().  The per-compile tables are counted apart
+// by new_dynarec_compile_usage().
+#define ARRAY_USAGE(array) \
+  (*allocated+=sizeof(array),*resident+=memusage_resident(array,sizeof(array)))
+void new_dynarec_memory_usage(size_t *allocated, size_t *resident)
+{
+  *allocated=*resident=0;
+  if(base_addr) {
+    *allocated+=1<<target_size_2;
+    *resident+=memusage_resident(base_addr,1<<target_size_2);
+  }
+  if(shadow) {
+    *allocated+=shadow_size;
+    *resident+=memusage_resident(shadow,shadow_size);
+  }
+  ARRAY_USAGE(hash_table);
+  ARRAY_USAGE(memory_map);
+}
+
+void new_dynarec_compile_usage(size_t *allocated, size_t *resident)
+{
+  *allocated=*resident=0;
+  if(compile_mem) {
+    *allocated=compile_mem_size;
+    *resident=memusage_resident(compile_mem,compile_mem_size);
+  }
+}
+
 int new_recompile_block(int addr)
 {
 /*
@@ -7691,8 +7805,8 @@ int new_recompile_block(int addr)
   }
   else if ((signed int)addr >= (signed int)0xC0000000) {
     //DebugMessage(M64MSG_VERBOSE, "addr=%x mm=%x",(u_int)addr,(memory_map[start>>12]<<2));
-    //if(tlb_LUT_r[start>>12])
-      //source = (u_int *)(((int)rdram)+(tlb_LUT_r[start>>12]&0xFFFFF000)+(((int)addr)&0xFFF)-0x80000000);
+    //if(tlb_lut_r(start>>12))
+      //source = (u_int *)(((int)rdram)+(tlb_lut_r(start>>12)&0xFFFFF000)+(((int)addr)&0xFFF)-0x80000000);
     if((signed int)memory_map[start>>12]>=0) {
       source = (u_int *)((u_int)(start+(memory_map[start>>12]<<2)));
       pagelimit=(start+4096)&0xFFFFF000;
@@ -8245,13 +8359,13 @@ int new_recompile_block(int addr)
       // Don't recompile stuff that's already compiled
       if(check_addr(start+i*4+4)) done=1;
       // Don't get too close to the limit
-      if(i>MAXBLOCK/2) done=1;
+      if(i>maxblock/2) done=1;
     }
     if(i>0&&itype[i-1]==SYSCALL&&stop_after_jal) done=1;
-    assert(i<MAXBLOCK-1);
+    assert(i<maxblock-1);
     if(start+i*4==pagelimit-4) done=1;
     assert(start+i*4<pagelimit);
-    if (i==MAXBLOCK-1) done=1;
+    if (i==maxblock-1) done=1;
     // Stop if we're compiling junk
     if(itype[i]==NI&&opcode[i]==0x11) {
       done=stop_after_jal=1;
@@ -10798,7 +10912,7 @@ int new_recompile_block(int addr)
     }
   }
   // External Branch Targets (jump_in)
-  if(copy+slen*4>(void *)shadow+sizeof(shadow)) copy=shadow;
+  if(copy+slen*4>(void *)shadow+shadow_size) copy=shadow;
   for(i=0;i<slen;i++)
   {
     if(bt[i]||i==0)
@@ -10808,9 +10922,9 @@ int new_recompile_block(int addr)
         u_int vaddr=start+i*4;
         u_int page=(0x80000000^vaddr)>>12;
         u_int vpage=page;
-        if(page>262143&&tlb_LUT_r[vaddr>>12]) page=(tlb_LUT_r[page^0x80000]^0x80000000)>>12;
+        if(page>262143&&tlb_lut_r(vaddr>>12)) page=(tlb_lut_r(page^0x80000)^0x80000000)>>12;
         if(page>2048) page=2048+(page&2047);
-        if(vpage>262143&&tlb_LUT_r[vaddr>>12]) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
+        if(vpage>262143&&tlb_lut_r(vaddr>>12)) vpage&=2047; // jump_dirty uses a hash of the virtual address instead
         if(vpage>2048) vpage=2048+(vpage&2047);
         literal_pool(256);
         //if(!(is32[i]&(~unneeded_reg_upper[i])&~(1LL<<CCREG)))
@@ -10871,7 +10985,7 @@ int new_recompile_block(int addr)
 
   // If we're within 256K of the end of the buffer,
   // start over from the beginning. (Is 256K enough?)
-  if(out > (u_char *)(base_addr+(1<<TARGET_SIZE_2)-MAX_OUTPUT_BLOCK_SIZE-JUMP_TABLE_SIZE))
+  if(out > (u_char *)(base_addr+(1<<target_size_2)-MAX_OUTPUT_BLOCK_SIZE-JUMP_TABLE_SIZE))
     out=(u_char *)base_addr;
   
   // Trap writes to any of the pages we compiled
@@ -10888,11 +11002,15 @@ int new_recompile_block(int addr)
   }
   
   /* Pass 10 - Free memory by expiring oldest blocks */
-  
-  int end=((((intptr_t)out-(intptr_t)base_addr)>>(TARGET_SIZE_2-16))+16384)&65535;
+
+  // expirep counts 65536 phases per trip around the cache whatever its
+  // size: 8 blocks of 4 steps of 2048 phases, one jump_in/jump_out list
+  // (plus its 2048+ twin) or 32 hash bins per phase.  It stays a quarter
+  // of the cache ahead of out.
+  int end=((((intptr_t)out-(intptr_t)base_addr)>>(target_size_2-16))+16384)&65535;
   while(expirep!=end)
   {
-    int shift=TARGET_SIZE_2-3; // Divide into 8 blocks
+    int shift=target_size_2-3; // Divide into 8 blocks
     int base=(int)base_addr+((expirep>>13)<<shift); // Base address of this block
     inv_debug("EXP: Phase %d\n",expirep);
     switch((expirep>>11)&3)
@@ -10974,16 +11092,17 @@ void TLBWI_new(void)
      for fast look up. */
   for (i=tlb_e[Index&0x3F].start_even>>12; i<=tlb_e[Index&0x3F].end_even>>12; i++)
   {
-    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_LUT_r[i],tlb_LUT_w[i]);
+    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_lut_r(i),tlb_lut_w(i));
     if(i<0x80000||i>0xBFFFF)
     {
-      if(tlb_LUT_r[i]) {
-        memory_map[i]=((tlb_LUT_r[i]&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
+      u_int lut_r=tlb_lut_r(i),lut_w=tlb_lut_w(i);
+      if(lut_r) {
+        memory_map[i]=((lut_r&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
         // FIXME: should make sure the physical page is invalid too
-        if(!tlb_LUT_w[i]||!invalid_code[i]) {
+        if(!lut_w||!invalid_code[i]) {
           memory_map[i]|=0x40000000; // Write protect
         }else{
-          assert(tlb_LUT_r[i]==tlb_LUT_w[i]);
+          assert(lut_r==lut_w);
         }
         if(!using_tlb) DebugMessage(M64MSG_VERBOSE, "Enabled TLB");
         // Tell the dynamic recompiler to generate tlb lookup code
@@ -10995,16 +11114,17 @@ void TLBWI_new(void)
   }
   for (i=tlb_e[Index&0x3F].start_odd>>12; i<=tlb_e[Index&0x3F].end_odd>>12; i++)
   {
-    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_LUT_r[i],tlb_LUT_w[i]);
+    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_lut_r(i),tlb_lut_w(i));
     if(i<0x80000||i>0xBFFFF)
     {
-      if(tlb_LUT_r[i]) {
-        memory_map[i]=((tlb_LUT_r[i]&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
+      u_int lut_r=tlb_lut_r(i),lut_w=tlb_lut_w(i);
+      if(lut_r) {
+        memory_map[i]=((lut_r&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
         // FIXME: should make sure the physical page is invalid too
-        if(!tlb_LUT_w[i]||!invalid_code[i]) {
+        if(!lut_w||!invalid_code[i]) {
           memory_map[i]|=0x40000000; // Write protect
         }else{
-          assert(tlb_LUT_r[i]==tlb_LUT_w[i]);
+          assert(lut_r==lut_w);
         }
         if(!using_tlb) DebugMessage(M64MSG_VERBOSE, "Enabled TLB");
         // Tell the dynamic recompiler to generate tlb lookup code
@@ -11046,16 +11166,17 @@ void TLBWR_new(void)
      for fast look up. */
   for (i=tlb_e[Random&0x3F].start_even>>12; i<=tlb_e[Random&0x3F].end_even>>12; i++)
   {
-    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_LUT_r[i],tlb_LUT_w[i]);
+    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_lut_r(i),tlb_lut_w(i));
     if(i<0x80000||i>0xBFFFF)
     {
-      if(tlb_LUT_r[i]) {
-        memory_map[i]=((tlb_LUT_r[i]&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
+      u_int lut_r=tlb_lut_r(i),lut_w=tlb_lut_w(i);
+      if(lut_r) {
+        memory_map[i]=((lut_r&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
         // FIXME: should make sure the physical page is invalid too
-        if(!tlb_LUT_w[i]||!invalid_code[i]) {
+        if(!lut_w||!invalid_code[i]) {
           memory_map[i]|=0x40000000; // Write protect
         }else{
-          assert(tlb_LUT_r[i]==tlb_LUT_w[i]);
+          assert(lut_r==lut_w);
         }
         if(!using_tlb) DebugMessage(M64MSG_VERBOSE, "Enabled TLB");
         // Tell the dynamic recompiler to generate tlb lookup code
@@ -11067,16 +11188,17 @@ void TLBWR_new(void)
   }
   for (i=tlb_e[Random&0x3F].start_odd>>12; i<=tlb_e[Random&0x3F].end_odd>>12; i++)
   {
-    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_LUT_r[i],tlb_LUT_w[i]);
+    //DebugMessage(M64MSG_VERBOSE, "%x: r:%8x w:%8x",i,tlb_lut_r(i),tlb_lut_w(i));
     if(i<0x80000||i>0xBFFFF)
     {
-      if(tlb_LUT_r[i]) {
-        memory_map[i]=((tlb_LUT_r[i]&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
+      u_int lut_r=tlb_lut_r(i),lut_w=tlb_lut_w(i);
+      if(lut_r) {
+        memory_map[i]=((lut_r&0xFFFFF000)-(i<<12)+(unsigned int)rdram-0x80000000)>>2;
         // FIXME: should make sure the physical page is invalid too
-        if(!tlb_LUT_w[i]||!invalid_code[i]) {
+        if(!lut_w||!invalid_code[i]) {
           memory_map[i]|=0x40000000; // Write protect
         }else{
-          assert(tlb_LUT_r[i]==tlb_LUT_w[i]);
+          assert(lut_r==lut_w);
         }
         if(!using_tlb) DebugMessage(M64MSG_VERBOSE, "Enabled TLB");
         // Tell the dynamic recompiler to generate tlb lookup code
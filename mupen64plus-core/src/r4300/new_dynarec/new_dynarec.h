@@ -22,17 +22,22 @@
 #ifndef NEW_DYNAREC_H
 #define NEW_DYNAREC_H
 
+#include <stddef.h>
+
 #define NEW_DYNAREC_X86 1
 #define NEW_DYNAREC_AMD64 2
 #define NEW_DYNAREC_ARM 3
 
 extern int pcaddr;
 extern int pending_exception;
+extern int new_dynarec_cache_mb; // translation cache size, 0 for the default
 
 void invalidate_all_pages(void);
 void invalidate_block(unsigned int block);
 void new_dynarec_init(void);
 void new_dyna_start(void);
 void new_dynarec_cleanup(void);
+void new_dynarec_memory_usage(size_t *allocated, size_t *resident);
+void new_dynarec_compile_usage(size_t *allocated, size_t *resident);
 
 #endif /* NEW_DYNAREC_H */
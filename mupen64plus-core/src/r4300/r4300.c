@@ -27,6 +27,7 @@
 #include "api/debugger.h"
 #include "memory/memory.h"
 #include "main/main.h"
+#include "main/memusage.h"
 #include "main/rom.h"
 
 #include "r4300.h"
@@ -727,7 +728,10 @@ void init_blocks(void)
    for (i=0; i<0x100000; i++)
    {
       invalid_code[i] = 1;
-      blocks[i] = NULL;
+      /* only store where needed, so the pages of this 4-8MB table that
+       * never got a block stay unbacked */
+      if (blocks[i])
+         blocks[i] = NULL;
    }
 }
 
@@ -780,11 +784,7 @@ void r4300_reset_hard(void)
         tlb_e[i].end_odd=0;
         tlb_e[i].phys_odd=0;
     }
-    for (i=0; i<0x100000; i++)
-    {
-        tlb_LUT_r[i] = 0;
-        tlb_LUT_w[i] = 0;
-    }
+    tlb_lut_reset();
     llbit=0;
     hi=0;
     lo=0;
@@ -1000,6 +1000,7 @@ void r4300_execute(void)
     {
         DebugMessage(M64MSG_INFO, "Starting R4300 emulator: Pure Interpreter");
         r4300emu = CORE_PURE_INTERPRETER;
+        memusage_report();
         pure_interpreter();
     }
 #if defined(DYNAREC)
@@ -1011,9 +1012,11 @@ void r4300_execute(void)
 
 #ifdef NEW_DYNAREC
         new_dynarec_init();
+        memusage_report();
         new_dyna_start();
         new_dynarec_cleanup();
 #else
+        memusage_report();
         dyna_start(dynarec_setup_code);
         PC++;
 #endif
@@ -1044,6 +1047,7 @@ void r4300_execute(void)
         DebugMessage(M64MSG_INFO, "Starting R4300 emulator: Cached Interpreter");
         r4300emu = CORE_INTERPRETER;
         init_blocks();
+        memusage_report();
         jump_to(0xa4000040);
 
         /* Prevent segfault on failed jump_to */
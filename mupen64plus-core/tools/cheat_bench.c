@@ -0,0 +1,91 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - cheat_bench.c                                           *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Measures the per-VI cost of cheat_apply_cheats() with a few hundred active
+ * GameShark codes (plain writes, conditionals, GS button codes and repeat
+ * codes). Build and run from the core directory:
+ *
+ *   gcc -O2 -Isrc -o cheat_bench tools/cheat_bench.c src/main/cheat.c
+ *   ./cheat_bench [vi_count]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "api/m64p_types.h"
+#include "main/cheat.h"
+#include "main/rom.h"
+#include "memory/memory.h"
+
+/* The parts of the core cheat.c links against */
+static unsigned int bench_rdram[0x800000/4];
+unsigned char *rdramb = (unsigned char *) bench_rdram;
+m64p_rom_header ROM_HEADER;
+static int gs_button;
+int event_gameshark_active(void) { return gs_button; }
+
+#define BENCH_CHEATS 40
+
+int main(int argc, char *argv[])
+{
+    m64p_cheat_code codes[8];
+    char name[32];
+    int vi_count = (argc > 1) ? atoi(argv[1]) : 200000;
+    int i, j, total = 0;
+    clock_t start;
+    double seconds;
+
+    srand(64);
+    for (i = 0; i < BENCH_CHEATS; i++)
+    {
+        unsigned int base = 0x80100000 | ((rand() % 0x3000) << 4);
+
+        /* two writes, a conditional write, a GS button write and a
+         * repeat code expanding to 4 writes: 9 codes per cheat */
+        codes[0].address = base;                     codes[0].value = rand() & 0xFF;
+        codes[1].address = (base + 2) | 0x01000000;  codes[1].value = rand() & 0xFFFF;
+        codes[2].address = (base + 8) ^ 0x51000000;  codes[2].value = 0;
+        codes[3].address = base + 9;                 codes[3].value = 0x63;
+        codes[4].address = (base + 16) ^ 0x28000000; codes[4].value = 1;
+        codes[5].address = 0x50000402;               codes[5].value = 1;
+        codes[6].address = (base + 32) | 0x01000000; codes[6].value = 0x1000;
+        snprintf(name, sizeof(name), "bench cheat %d", i);
+        cheat_add_new(name, codes, 7);
+        total += 9;
+    }
+
+    /* compile outside of the timed loop, like the first VI in a game */
+    cheat_apply_cheats(ENTRY_VI);
+
+    start = clock();
+    for (j = 0; j < vi_count; j++)
+    {
+        gs_button = (j & 63) == 0;
+        cheat_apply_cheats(ENTRY_VI);
+    }
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%d codes, %d VIs: %.1f ns per VI, %.2f ns per code\n", total, vi_count,
+           seconds * 1e9 / vi_count, seconds * 1e9 / vi_count / total);
+
+    cheat_delete_all();
+    return 0;
+}
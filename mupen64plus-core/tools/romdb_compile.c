@@ -0,0 +1,310 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - romdb_compile.c                                         *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Compiles mupen64plus.ini into the binary rom database the core loads at
+ * startup (see src/main/romdb.h). Build and run from the core directory:
+ *
+ *   gcc -Isrc -o romdb_compile tools/romdb_compile.c src/main/util.c src/main/romdb.c
+ *   ./romdb_compile data/mupen64plus.ini data/mupen64plus.rdb
+ *
+ * The top-level Makefile does this with "make romdb".
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main/rom.h"
+#include "main/romdb.h"
+#include "main/util.h"
+
+#define DEFAULT 16 /* same "not specified" marker as src/main/rom.c */
+
+typedef struct
+{
+    romdb_record record;
+    char *goodname;
+    unsigned char refmd5[16];
+    int has_refmd5;
+    int has_crc;
+    int order;
+} entry_t;
+
+static entry_t *entries;
+static int entry_count, entry_alloc;
+
+static int compare_md5(const void *a, const void *b)
+{
+    const entry_t *x = (const entry_t *)a, *y = (const entry_t *)b;
+    int cmp = memcmp(x->record.md5, y->record.md5, 16);
+    /* on duplicates the text parser finds the last definition first */
+    return cmp ? cmp : y->order - x->order;
+}
+
+static int compare_crc(const void *a, const void *b)
+{
+    const entry_t *x = &entries[*(const uint32_t *)a], *y = &entries[*(const uint32_t *)b];
+    if (x->record.crc1 != y->record.crc1)
+        return x->record.crc1 < y->record.crc1 ? -1 : 1;
+    if (x->record.crc2 != y->record.crc2)
+        return x->record.crc2 < y->record.crc2 ? -1 : 1;
+    return y->order - x->order;
+}
+
+static entry_t *find_md5(const unsigned char *md5)
+{
+    int lo = 0, hi = entry_count;
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+        if (memcmp(entries[mid].record.md5, md5, 16) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < entry_count && memcmp(entries[lo].record.md5, md5, 16) == 0)
+        return &entries[lo];
+    return NULL;
+}
+
+static int parse_ini(FILE *f)
+{
+    char buffer[256];
+    entry_t *e = NULL;
+    int lineno, value;
+
+    for (lineno = 1; fgets(buffer, 255, f) != NULL; lineno++)
+    {
+        char *line = buffer;
+        ini_line l = ini_parse_line(&line);
+
+        if (l.type == INI_SECTION)
+        {
+            unsigned char md5[16];
+            if (!parse_hex(l.name, md5, 16))
+            {
+                fprintf(stderr, "line %i: invalid MD5\n", lineno);
+                e = NULL;
+                continue;
+            }
+            if (entry_count == entry_alloc)
+            {
+                entry_alloc = entry_alloc ? entry_alloc * 2 : 4096;
+                entries = (entry_t *)realloc(entries, entry_alloc * sizeof(entry_t));
+                if (entries == NULL)
+                    return 0;
+            }
+            e = &entries[entry_count];
+            memset(e, 0, sizeof(*e));
+            memcpy(e->record.md5, md5, 16);
+            e->record.savetype = DEFAULT;
+            e->record.players = DEFAULT;
+            e->record.rumble = DEFAULT;
+            e->order = entry_count++;
+        }
+        else if (l.type == INI_PROPERTY && e != NULL)
+        {
+            if (!strcmp(l.name, "GoodName"))
+            {
+                free(e->goodname);
+                e->goodname = strdup(l.value);
+            }
+            else if (!strcmp(l.name, "CRC"))
+            {
+                char garbage_sweeper;
+                unsigned int crc1, crc2;
+                if (sscanf(l.value, "%X %X%c", &crc1, &crc2, &garbage_sweeper) == 2)
+                {
+                    e->record.crc1 = crc1;
+                    e->record.crc2 = crc2;
+                    e->has_crc = 1;
+                }
+                else
+                    fprintf(stderr, "line %i: invalid CRC\n", lineno);
+            }
+            else if (!strcmp(l.name, "RefMD5"))
+            {
+                if (parse_hex(l.value, e->refmd5, 16))
+                    e->has_refmd5 = 1;
+                else
+                    fprintf(stderr, "line %i: invalid RefMD5\n", lineno);
+            }
+            else if (!strcmp(l.name, "SaveType"))
+            {
+                if (!strcmp(l.value, "Eeprom 4KB"))
+                    e->record.savetype = EEPROM_4KB;
+                else if (!strcmp(l.value, "Eeprom 16KB"))
+                    e->record.savetype = EEPROM_16KB;
+                else if (!strcmp(l.value, "SRAM"))
+                    e->record.savetype = SRAM;
+                else if (!strcmp(l.value, "Flash RAM"))
+                    e->record.savetype = FLASH_RAM;
+                else if (!strcmp(l.value, "Controller Pack"))
+                    e->record.savetype = CONTROLLER_PACK;
+                else if (!strcmp(l.value, "None"))
+                    e->record.savetype = NONE;
+                else
+                    fprintf(stderr, "line %i: invalid save type\n", lineno);
+            }
+            else if (!strcmp(l.name, "Status"))
+            {
+                if (string_to_int(l.value, &value) && value >= 0 && value < 6)
+                    e->record.status = value;
+                else
+                    fprintf(stderr, "line %i: invalid status\n", lineno);
+            }
+            else if (!strcmp(l.name, "Players"))
+            {
+                if (string_to_int(l.value, &value) && value >= 0 && value < 8)
+                    e->record.players = value;
+                else
+                    fprintf(stderr, "line %i: invalid player count\n", lineno);
+            }
+            else if (!strcmp(l.name, "Rumble"))
+            {
+                if (!strcmp(l.value, "Yes"))
+                    e->record.rumble = 1;
+                else if (!strcmp(l.value, "No"))
+                    e->record.rumble = 0;
+                else
+                    fprintf(stderr, "line %i: invalid rumble string\n", lineno);
+            }
+            else
+                fprintf(stderr, "line %i: unknown property\n", lineno);
+        }
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    FILE *in, *out;
+    romdb_header header;
+    uint32_t *crc_index;
+    char *strings;
+    long source_size;
+    uint32_t source_hash;
+    int i, crc_count = 0;
+    uint32_t strings_size = 0;
+
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s mupen64plus.ini mupen64plus.rdb\n", argv[0]);
+        return 1;
+    }
+
+    if ((in = fopen(argv[1], "rb")) == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(in, 0, SEEK_END);
+    source_size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    source_hash = romdb_hash_file(in);
+    fseek(in, 0, SEEK_SET);
+    if (!parse_ini(in))
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    fclose(in);
+
+    qsort(entries, entry_count, sizeof(entry_t), compare_md5);
+
+    /* Resolve RefMD5 references, exactly like romdatabase_open() does */
+    for (i = 0; i < entry_count; i++)
+    {
+        entry_t *ref;
+        if (!entries[i].has_refmd5)
+            continue;
+        if ((ref = find_md5(entries[i].refmd5)) == NULL)
+        {
+            fprintf(stderr, "unresolved RefMD5 in entry %i\n", entries[i].order);
+            continue;
+        }
+        if (ref->record.savetype != DEFAULT)
+            entries[i].record.savetype = ref->record.savetype;
+        if (ref->record.status != 0)
+            entries[i].record.status = ref->record.status;
+        if (ref->record.players != DEFAULT)
+            entries[i].record.players = ref->record.players;
+        if (ref->record.rumble != DEFAULT)
+            entries[i].record.rumble = ref->record.rumble;
+    }
+
+    /* Build the string pool and the CRC index */
+    for (i = 0; i < entry_count; i++)
+        strings_size += (entries[i].goodname ? strlen(entries[i].goodname) : 0) + 1;
+    strings_size = (strings_size + 3) & ~3;
+    strings = (char *)calloc(1, strings_size);
+    crc_index = (uint32_t *)malloc((entry_count + 1) * sizeof(uint32_t));
+    if (strings == NULL || crc_index == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    strings_size = 0;
+    for (i = 0; i < entry_count; i++)
+    {
+        const char *name = entries[i].goodname ? entries[i].goodname : "";
+        entries[i].record.goodname = strings_size;
+        strcpy(strings + strings_size, name);
+        strings_size += strlen(name) + 1;
+        if (entries[i].has_crc)
+            crc_index[crc_count++] = i;
+    }
+    strings_size = (strings_size + 3) & ~3;
+    qsort(crc_index, crc_count, sizeof(uint32_t), compare_crc);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ROMDB_MAGIC, sizeof(ROMDB_MAGIC));
+    header.version = ROMDB_VERSION;
+    header.byte_order = ROMDB_BYTE_ORDER;
+    header.source_size = (uint32_t)source_size;
+    header.source_hash = source_hash;
+    header.record_count = entry_count;
+    header.crc_count = crc_count;
+    header.records_offset = sizeof(romdb_header);
+    header.crc_index_offset = header.records_offset + entry_count * sizeof(romdb_record);
+    header.strings_offset = header.crc_index_offset + crc_count * sizeof(uint32_t);
+    header.strings_size = strings_size;
+
+    if ((out = fopen(argv[2], "wb")) == NULL)
+    {
+        fprintf(stderr, "cannot create %s\n", argv[2]);
+        return 1;
+    }
+    fwrite(&header, sizeof(header), 1, out);
+    for (i = 0; i < entry_count; i++)
+        fwrite(&entries[i].record, sizeof(romdb_record), 1, out);
+    fwrite(crc_index, sizeof(uint32_t), crc_count, out);
+    fwrite(strings, 1, strings_size, out);
+    if (fclose(out) != 0)
+    {
+        fprintf(stderr, "error writing %s\n", argv[2]);
+        return 1;
+    }
+
+    printf("%s: %i roms, %i CRCs, %u bytes of names\n", argv[2], entry_count, crc_count, strings_size);
+    return 0;
+}
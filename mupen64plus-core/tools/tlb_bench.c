@@ -0,0 +1,195 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+ *   Mupen64plus - tlb_bench.c                                             *
+ *   Mupen64Plus homepage: http://code.google.com/p/mupen64plus/           *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.          *
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/* Compares the two-level TLB lookup tables of src/memory/tlb.c with the old
+ * flat 1M-entry arrays under a GoldenEye / Perfect Dark like load: all 32
+ * TLB entries mapped with mixed page sizes, a few entries rewritten every
+ * "frame" and a stream of virtual_to_physical_address() lookups, mostly
+ * hits, each followed by the RDRAM access it translates.  Results of both implementations are checked against each other.
+ * Build and run from the core directory:
+ *
+ *   gcc -O2 -Isrc -o tlb_bench tools/tlb_bench.c src/memory/tlb.c
+ *   ./tlb_bench [frames]
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "api/m64p_types.h"
+#include "memory/tlb.h"
+#include "main/rom.h"
+
+/* The parts of the core tlb.c links against */
+unsigned char isGoldeneyeRom;
+m64p_rom_header ROM_HEADER;
+static unsigned int refills;
+/* out of line, like the real one in r4300/exception.c */
+osal_noinline void TLB_refill_exception(unsigned int address, int w) { refills++; }
+void DebugMessage(int level, const char *message, ...) { }
+
+#define ENTRIES 32
+#define LOOKUPS_PER_FRAME 20000
+#define LOOKUP_ROUNDS 16
+#define REMAPS_PER_FRAME 4
+#define TRIALS 3
+
+/* every translation is followed by the emulated load, like in the core */
+static unsigned int bench_rdram[0x800000/4];
+
+/* the old flat tables, as a reference */
+static unsigned int flat_r[TLB_LUT_PAGES];
+static unsigned int flat_w[TLB_LUT_PAGES];
+
+static void flat_range(unsigned int *lut, unsigned int start, unsigned int end, unsigned int phys, int map)
+{
+    unsigned int i;
+    for (i = start; i < end; i += 0x1000)
+        lut[i>>12] = map ? 0x80000000 | (phys + (i - start) + 0xFFF) : 0;
+}
+
+static void flat_unmap(tlb *e)
+{
+    if (e->v_even) { flat_range(flat_r, e->start_even, e->end_even, 0, 0); if (e->d_even) flat_range(flat_w, e->start_even, e->end_even, 0, 0); }
+    if (e->v_odd)  { flat_range(flat_r, e->start_odd, e->end_odd, 0, 0);   if (e->d_odd)  flat_range(flat_w, e->start_odd, e->end_odd, 0, 0); }
+}
+
+static void flat_map(tlb *e)
+{
+    if (e->v_even) { flat_range(flat_r, e->start_even, e->end_even, e->phys_even, 1); if (e->d_even) flat_range(flat_w, e->start_even, e->end_even, e->phys_even, 1); }
+    if (e->v_odd)  { flat_range(flat_r, e->start_odd, e->end_odd, e->phys_odd, 1);   if (e->d_odd)  flat_range(flat_w, e->start_odd, e->end_odd, e->phys_odd, 1); }
+}
+
+/* the old lookup body, minus the GoldenEye hack which is disabled here */
+static unsigned int flat_virtual_to_physical_address(unsigned int addresse, int w)
+{
+    unsigned int *lut = (w == 1) ? flat_w : flat_r;
+    if (addresse >= 0x7f000000 && addresse < 0x80000000 && isGoldeneyeRom)
+        return 0;
+    if (lut[addresse>>12])
+        return (lut[addresse>>12]&0xFFFFF000)|(addresse&0xFFF);
+    TLB_refill_exception(addresse,w);
+    return 0;
+}
+
+static void random_entry(tlb *e, int slot)
+{
+    /* 4KB to 64KB pages in the kuseg/kseg3 areas these games use */
+    static const unsigned int sizes[] = { 0x1000, 0x4000, 0x10000 };
+    unsigned int size = sizes[rand() % 3];
+    unsigned int base = ((rand() & 1) ? 0x7F000000 : 0x00100000) + slot * 0x40000;
+
+    e->start_even = base;
+    e->end_even = base + size;
+    e->phys_even = (rand() % 0x700) << 12;
+    e->start_odd = base + size;
+    e->end_odd = base + 2 * size;
+    e->phys_odd = (rand() % 0x700) << 12;
+    e->v_even = e->v_odd = 1;
+    e->d_even = rand() & 1;
+    e->d_odd = 1;
+}
+
+static unsigned int random_address(tlb *entries)
+{
+    tlb *e = &entries[rand() % ENTRIES];
+    /* one lookup in 64 misses and goes through the refill path */
+    if ((rand() & 63) == 0)
+        return 0x20000000 + (rand() << 4);
+    return e->start_even + (rand() % (e->end_odd - e->start_even));
+}
+
+int main(int argc, char *argv[])
+{
+    static unsigned int addresses[LOOKUPS_PER_FRAME];
+    tlb entries[ENTRIES];
+    int frames = (argc > 1) ? atoi(argv[1]) : 500;
+    int trial, pass, f, i, r;
+    double seconds[2] = { 1e9, 1e9 };
+    unsigned int checksum[2], refill_count[2];
+    /* called through a pointer so neither side gets inlined into the loop */
+    unsigned int (*volatile lookup[2])(unsigned int, int) =
+        { flat_virtual_to_physical_address, virtual_to_physical_address };
+
+    for (i = 0; i < 0x800000/4; i++)
+        bench_rdram[i] = i * 2654435761u;
+
+    /* alternate the two sides and keep the best run of each */
+    for (trial = 0; trial < 2 * TRIALS; trial++)
+    {
+        clock_t elapsed = 0, start;
+
+        pass = trial & 1;
+        tlb_lut_reset();
+        memset(flat_r, 0, sizeof(flat_r));
+        memset(flat_w, 0, sizeof(flat_w));
+        srand(64);
+        refills = 0;
+        checksum[pass] = 0;
+        for (i = 0; i < ENTRIES; i++)
+        {
+            random_entry(&entries[i], i);
+            if (pass) tlb_map(&entries[i]); else flat_map(&entries[i]);
+        }
+
+        for (f = 0; f < frames; f++)
+        {
+            for (i = 0; i < LOOKUPS_PER_FRAME; i++)
+                addresses[i] = random_address(entries);
+
+            start = clock();
+            for (i = 0; i < REMAPS_PER_FRAME; i++)
+            {
+                int slot = rand() % ENTRIES;
+                if (pass) tlb_unmap(&entries[slot]); else flat_unmap(&entries[slot]);
+                random_entry(&entries[slot], slot);
+                if (pass) tlb_map(&entries[slot]); else flat_map(&entries[slot]);
+            }
+            for (r = 0; r < LOOKUP_ROUNDS; r++)
+            {
+                unsigned int (*translate)(unsigned int, int) = lookup[pass];
+                for (i = 0; i < LOOKUPS_PER_FRAME; i++)
+                    checksum[pass] += bench_rdram[(translate(addresses[i], i & 1) & 0x7FFFFC) / 4];
+            }
+            elapsed += clock() - start;
+        }
+        if ((double)elapsed / CLOCKS_PER_SEC < seconds[pass])
+            seconds[pass] = (double)elapsed / CLOCKS_PER_SEC;
+        refill_count[pass] = refills;
+    }
+
+    printf("%d frames, %d lookups, best of %d: flat %.3f s, two-level %.3f s (%.1f%%)\n",
+           frames, frames * LOOKUPS_PER_FRAME * LOOKUP_ROUNDS, TRIALS, seconds[0], seconds[1],
+           seconds[0] > 0 ? 100.0 * seconds[1] / seconds[0] : 100.0);
+    printf("table memory: flat %u KB, two-level %u KB\n",
+           (unsigned int)(sizeof(flat_r) + sizeof(flat_w)) / 1024, tlb_lut_allocated() / 1024);
+
+    if (checksum[0] != checksum[1] || refill_count[0] != refill_count[1])
+    {
+        printf("MISMATCH: checksum %08x/%08x, refills %u/%u\n",
+               checksum[0], checksum[1], refill_count[0], refill_count[1]);
+        return 1;
+    }
+
+    tlb_lut_reset();
+    return 0;
+}
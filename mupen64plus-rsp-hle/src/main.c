@@ -33,6 +33,7 @@
 #include "alist.h"
 #include "cicx105.h"
 #include "jpeg.h"
+#include "plugin/ucode_id.h"
 
 #define min(a,b) (((a) < (b)) ? (a) : (b))
 
@@ -210,7 +211,7 @@ static void normal_task_dispatching()
 {
     const OSTask_t * const task = get_task();
     const unsigned int sum =
-        sum_bytes(rspInfo.RDRAM + task->ucode, min(task->ucode_size, 0xf80) >> 1);
+        ucode_id_byte_sum(task->ucode, min(task->ucode_size, 0xf80) >> 1);
 
     switch (sum)
     {
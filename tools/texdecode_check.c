@@ -0,0 +1,297 @@
+/* Conformance check and benchmark for libretro/texdecode.c.
+ *
+ * Every 4, 8 and 16 bit texel value and every palette entry is decoded to
+ * every output format and compared with the definition of the formats
+ * below, written independently of the library. Random rows then cover
+ * 32 bit texels, CI, odd start texels, lengths across the chunk size and
+ * the RDRAM/TMEM xor masks, and check nothing is written past the row.
+ * Both the scalar and the SSE2/NEON kernels are checked, then timed.
+ * Build and run from the top directory:
+ *
+ *   gcc -O2 -DINLINE=inline -Ilibretro -o texdecode_check tools/texdecode_check.c libretro/texdecode.c
+ *   ./texdecode_check [rounds]
+ *
+ * Add -DNOSSE (and -DHAVE_NEON -mfpu=neon on ARM) to check the other builds.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libretro.h"
+#include "texdecode.h"
+
+static const char *format_names[TEXDEC_FORMATS] =
+{
+   "RGBA16", "RGBA32", "YUV16", "IA4", "IA8", "IA16", "I4", "I8", "CI4", "CI8"
+};
+
+static const char *output_names[TEXDEC_OUTPUTS] =
+{
+   "RGBA8888", "BGRA8888", "RGBA5551", "ARGB1555", "RGBA4444", "ARGB4444", "IA88", "I8"
+};
+
+static const unsigned format_bits[TEXDEC_FORMATS] = { 16, 32, 16, 4, 8, 16, 4, 8, 4, 8 };
+
+/* A bits wide channel repeated until it fills a byte, what the RDP does */
+static unsigned replicate(unsigned value, unsigned bits)
+{
+   unsigned out = 0, filled = 0;
+   while (filled < 8)
+   {
+      out = (out << bits) | value;
+      filled += bits;
+   }
+   return out >> (filled - 8);
+}
+
+typedef struct
+{
+   unsigned r, g, b, a;
+} COLOR;
+
+static COLOR color(unsigned r, unsigned g, unsigned b, unsigned a)
+{
+   COLOR c;
+   c.r = r; c.g = g; c.b = b; c.a = a;
+   return c;
+}
+
+static COLOR ref_rgba16(unsigned v)
+{
+   return color(replicate(v >> 11, 5), replicate((v >> 6) & 31, 5), replicate((v >> 1) & 31, 5), (v & 1) ? 255 : 0);
+}
+
+static COLOR ref_ia16(unsigned v)
+{
+   return color(v >> 8, v >> 8, v >> 8, v & 255);
+}
+
+static unsigned clamp(float f)
+{
+   int v = (int)f;
+   return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+/* texel t of a texture whose N64 byte o is at src[o ^ xor_mask] */
+static COLOR ref_texel(unsigned format, const uint8_t *src, uint32_t t, uint32_t xor_mask,
+      const uint16_t *tlut, unsigned tlut_format)
+{
+#define BYTE(o) src[(o) ^ xor_mask]
+   unsigned nibble = (t & 1) ? (BYTE(t >> 1) & 15) : (BYTE(t >> 1) >> 4);
+   unsigned i, y, u, v;
+
+   switch (format)
+   {
+      case TEXDEC_RGBA16:
+         return ref_rgba16((BYTE(t * 2) << 8) | BYTE(t * 2 + 1));
+      case TEXDEC_RGBA32:
+         return color(BYTE(t * 4), BYTE(t * 4 + 1), BYTE(t * 4 + 2), BYTE(t * 4 + 3));
+      case TEXDEC_YUV16:
+         u = BYTE((t >> 1) * 4);
+         y = BYTE((t >> 1) * 4 + 1 + (t & 1) * 2);
+         v = BYTE((t >> 1) * 4 + 2);
+         return color(clamp(y + 1.370705f * ((int)v - 128)),
+               clamp(y - 0.698001f * ((int)v - 128) - 0.337633f * ((int)u - 128)),
+               clamp(y + 1.732446f * ((int)u - 128)), 255);
+      case TEXDEC_IA4:
+         i = replicate(nibble >> 1, 3);
+         return color(i, i, i, (nibble & 1) ? 255 : 0);
+      case TEXDEC_IA8:
+         i = replicate(BYTE(t) >> 4, 4);
+         return color(i, i, i, replicate(BYTE(t) & 15, 4));
+      case TEXDEC_IA16:
+         return ref_ia16((BYTE(t * 2) << 8) | BYTE(t * 2 + 1));
+      case TEXDEC_I4:
+         i = replicate(nibble, 4);
+         return color(i, i, i, i);
+      case TEXDEC_I8:
+         return color(BYTE(t), BYTE(t), BYTE(t), BYTE(t));
+      case TEXDEC_CI4:
+      case TEXDEC_CI8:
+         i = (format == TEXDEC_CI4) ? nibble : BYTE(t);
+         return tlut_format == TEXDEC_TLUT_IA16 ? ref_ia16(tlut[i]) : ref_rgba16(tlut[i]);
+   }
+#undef BYTE
+   return color(0, 0, 0, 0);
+}
+
+static void ref_store(uint8_t *dst, unsigned output, COLOR c)
+{
+   unsigned v = 0;
+   switch (output)
+   {
+      case TEXDEC_OUT_RGBA8888:
+         dst[0] = c.r; dst[1] = c.g; dst[2] = c.b; dst[3] = c.a;
+         return;
+      case TEXDEC_OUT_BGRA8888:
+         dst[0] = c.b; dst[1] = c.g; dst[2] = c.r; dst[3] = c.a;
+         return;
+      case TEXDEC_OUT_IA88:
+         dst[0] = c.r; dst[1] = c.a;
+         return;
+      case TEXDEC_OUT_I8:
+         dst[0] = c.r;
+         return;
+      case TEXDEC_OUT_RGBA5551:
+         v = ((c.r >> 3) << 11) | ((c.g >> 3) << 6) | ((c.b >> 3) << 1) | (c.a >> 7);
+         break;
+      case TEXDEC_OUT_ARGB1555:
+         v = ((c.a >> 7) << 15) | ((c.r >> 3) << 10) | ((c.g >> 3) << 5) | (c.b >> 3);
+         break;
+      case TEXDEC_OUT_RGBA4444:
+         v = ((c.r >> 4) << 12) | ((c.g >> 4) << 8) | ((c.b >> 4) << 4) | (c.a >> 4);
+         break;
+      case TEXDEC_OUT_ARGB4444:
+         v = ((c.a >> 4) << 12) | ((c.r >> 4) << 8) | ((c.g >> 4) << 4) | (c.b >> 4);
+         break;
+   }
+   dst[0] = v & 0xFF;
+   dst[1] = v >> 8;
+}
+
+#define SRC_SIZE  8192
+#define MAX_ROW   1100
+#define GUARD     64
+
+static uint8_t src[65536 * 2 + 16];
+static uint8_t ref[65536 * 4 + GUARD], out[65536 * 4 + GUARD];
+static uint16_t tlut[65536];
+static uint32_t lut[65536];
+
+/* Decodes a row with the library and with the definition, 0 when they match */
+static int check_row(unsigned format, unsigned output, uint32_t texel, uint32_t xor_mask,
+      unsigned count, unsigned tlut_format)
+{
+   unsigned size = texdec_output_size(output), i;
+
+   memset(ref, 0xAA, count * size + GUARD);
+   memset(out, 0xAA, count * size + GUARD);
+   for (i = 0; i < count; i++)
+      ref_store(ref + i * size, output, ref_texel(format, src, texel + i, xor_mask, tlut, tlut_format));
+   texdec_row(out, output, format, src, texel, xor_mask, count, lut);
+
+   if (memcmp(ref, out, count * size + GUARD))
+   {
+      for (i = 0; i < count * size + GUARD && ref[i] == out[i]; i++);
+      printf("%s: %s to %s, texel %u, xor %u, count %u, tlut %u: byte %u is %02x, not %02x\n",
+            texdec_simd() ? "simd" : "scalar", format_names[format], output_names[output],
+            texel, xor_mask, count, tlut_format, i, out[i], ref[i]);
+      return 1;
+   }
+   return 0;
+}
+
+static int check_all(unsigned rounds)
+{
+   static const uint32_t masks[] = { 0, 3, 4, 7, 8, 11, 1, 2 };
+   unsigned format, output, i, r;
+   int bad = 0;
+
+   // every texel value, the formats up to 16 bits in N64 order
+   for (format = 0; format < TEXDEC_FORMATS; format++)
+   {
+      unsigned count = 65536;
+      if (format == TEXDEC_RGBA32 || format == TEXDEC_YUV16 || format == TEXDEC_CI4 || format == TEXDEC_CI8)
+         continue;
+      if (format_bits[format] == 16)
+         for (i = 0; i < 65536; i++)
+         {
+            src[i * 2] = i >> 8;
+            src[i * 2 + 1] = i & 0xFF;
+         }
+      else
+      {
+         for (i = 0; i < 256; i++)
+            src[i] = i;
+         count = format_bits[format] == 8 ? 256 : 512;
+      }
+      for (output = 0; output < TEXDEC_OUTPUTS; output++)
+         bad += check_row(format, output, 0, 0, count, 0);
+   }
+
+   // every palette entry, through CI8
+   for (i = 0; i < 256; i++)
+      src[i] = i;
+   for (r = 0; r < 2; r++)
+      for (i = 0; i < 65536; i += 256)
+      {
+         unsigned k;
+         for (k = 0; k < 256; k++)
+            tlut[k] = i + k;
+         texdec_palette(lut, tlut, 256, r);
+         for (output = 0; output < TEXDEC_OUTPUTS; output++)
+            bad += check_row(TEXDEC_CI8, output, 0, 0, 256, r);
+      }
+
+   // random rows
+   for (r = 0; r < rounds && bad < 16; r++)
+   {
+      unsigned tlut_format = rand() & 1;
+      uint32_t xor_mask = masks[rand() % 8];
+      uint32_t texel = rand() % 64;
+      unsigned count = (rand() & 3) ? rand() % 64 : rand() % MAX_ROW;
+
+      format = rand() % TEXDEC_FORMATS;
+      output = rand() % TEXDEC_OUTPUTS;
+      for (i = 0; i < SRC_SIZE; i++)
+         src[i] = rand();
+      for (i = 0; i < 256; i++)
+         tlut[i] = rand();
+      texdec_palette(lut, tlut, 256, tlut_format);
+      bad += check_row(format, output, texel, xor_mask, count, tlut_format);
+   }
+   return bad;
+}
+
+static double time_rows(unsigned format, unsigned output, unsigned rounds)
+{
+   clock_t start = clock();
+   unsigned r;
+   for (r = 0; r < rounds; r++)
+      texdec_row(out, output, format, src, 0, TEXDEC_XOR_HOST, 1024, lut);
+   return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+   static const unsigned outputs[] = { TEXDEC_OUT_RGBA8888, TEXDEC_OUT_BGRA8888, TEXDEC_OUT_RGBA5551, TEXDEC_OUT_ARGB4444 };
+   unsigned rounds = (argc > 1) ? atoi(argv[1]) : 200000;
+   unsigned format, o, i;
+   int bad, simd;
+
+   texdec_init(0);
+   bad = check_all(rounds);
+   texdec_init(~0ULL);
+   simd = texdec_simd();
+   if (simd)
+      bad += check_all(rounds);
+   else
+      printf("no SSE2/NEON kernels in this build, checked the scalar ones only\n");
+
+   printf("%-8s %-9s %12s %12s   (1024 texel rows from RDRAM, MB/s of output)\n", "format", "output", "scalar", "simd");
+   for (i = 0; i < SRC_SIZE; i++)
+      src[i] = rand();
+   for (format = 0; format < TEXDEC_FORMATS; format++)
+      for (o = 0; o < sizeof(outputs) / sizeof(outputs[0]); o++)
+      {
+         double bytes = 1024.0 * texdec_output_size(outputs[o]) * (rounds / 10);
+         double seconds[2];
+         texdec_init(0);
+         seconds[0] = time_rows(format, outputs[o], rounds / 10);
+         texdec_init(~0ULL);
+         seconds[1] = time_rows(format, outputs[o], rounds / 10);
+         printf("%-8s %-9s %12.0f %12.0f\n", format_names[format], output_names[outputs[o]],
+               seconds[0] > 0 ? bytes / seconds[0] / 1e6 : 0.0,
+               seconds[1] > 0 ? bytes / seconds[1] / 1e6 : 0.0);
+      }
+
+   if (bad)
+   {
+      printf("MISMATCH in %d rows\n", bad);
+      return 1;
+   }
+   printf("all rows match\n");
+   return 0;
+}
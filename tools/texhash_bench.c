@@ -0,0 +1,267 @@
+/* Conformance check and benchmark for libretro/texhash.c.
+ *
+ * Every backend the host has is checked against a bitwise CRC32C written
+ * independently of the library: the standard check value, chaining, random
+ * lengths and alignments, and rectangles with a pitch. The backends are then
+ * timed on texture sized rectangles next to copies of the hashes the video
+ * plugins used before: the gles2n64 byte table CRC32, the exact and the
+ * sampled Rice hashes, and the Glide64 one. Last, single bit changes are
+ * counted that the sampled Rice hash does not see.
+ * Build and run from the top directory:
+ *
+ *   gcc -O2 -Ilibretro -o texhash_bench tools/texhash_bench.c libretro/texhash.c
+ *   ./texhash_bench [rounds]
+ *
+ * Add -DNOSSE (and -march=armv8-a+crc on ARM) to check the other builds.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libretro.h"
+#include "texhash.h"
+
+#define POLY 0x82F63B78
+
+static int bad;
+
+/* the definition, one bit at a time */
+static uint32_t crc32c_bitwise(uint32_t crc, const uint8_t *p, size_t len)
+{
+   unsigned j;
+   crc = ~crc;
+   while (len--)
+   {
+      crc ^= *p++;
+      for (j = 0; j < 8; j++)
+         crc = (crc >> 1) ^ (POLY & (0 - (crc & 1)));
+   }
+   return ~crc;
+}
+
+static void expect(const char *what, uint32_t got, uint32_t want)
+{
+   if (got != want && bad++ < 16)
+      printf("%s: %s gives %08x, not %08x\n", texhash_backend_name(), what, got, want);
+}
+
+static void check(unsigned rounds)
+{
+   static uint8_t buf[8192 + 64];
+   unsigned r, i;
+
+   expect("\"123456789\"", texhash(0, "123456789", 9), 0xE3069283);
+   expect("empty", texhash(0, buf, 0), 0);
+
+   for (i = 0; i < sizeof(buf); i++)
+      buf[i] = rand();
+
+   for (r = 0; r < rounds && bad < 16; r++)
+   {
+      unsigned offset = rand() % 64;
+      size_t len = rand() % 4096, split = len ? rand() % len : 0;
+      unsigned rows = 1 + rand() % 16;
+      size_t row_bytes = rand() % 200;
+      ptrdiff_t pitch = row_bytes + rand() % 64;
+      uint32_t want = 0;
+      const uint8_t *p = buf + offset;
+
+      expect("random length", texhash(0, p, len), crc32c_bitwise(0, p, len));
+      expect("chained", texhash(texhash(0, p, split), p + split, len - split),
+            crc32c_bitwise(0, p, len));
+
+      for (i = 0; i < rows; i++)
+         want = crc32c_bitwise(want, p + i * pitch, row_bytes);
+      expect("rectangle", texhash_rect(0, p, row_bytes, rows, pitch), want);
+   }
+}
+
+/* gles2n64 CRC_Calculate before, CRC32 a byte at a time */
+static uint32_t crc32_table[256];
+
+static void build_crc32_table(void)
+{
+   unsigned i, j;
+   for (i = 0; i < 256; i++)
+   {
+      uint32_t crc = i;
+      for (j = 0; j < 8; j++)
+         crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+      crc32_table[i] = crc;
+   }
+}
+
+static uint32_t old_gles2n64(const uint8_t *p, size_t row_bytes, unsigned rows, ptrdiff_t pitch)
+{
+   uint32_t crc = 0xFFFFFFFF;
+   for (; rows; rows--, p += pitch)
+   {
+      uint32_t orig = crc;
+      const uint8_t *q = p;
+      size_t count = row_bytes;
+      while (count--)
+         crc = (crc >> 8) ^ crc32_table[(crc & 0xFF) ^ *q++];
+      crc ^= orig;
+   }
+   return crc;
+}
+
+/* Rice CalculateRDRAMCRC before, every dword */
+static uint32_t old_rice(const uint8_t *p, size_t row_bytes, unsigned rows, ptrdiff_t pitch)
+{
+   uint32_t crc = 0;
+   int y;
+   for (y = rows - 1; y >= 0; y--, p += pitch)
+   {
+      uint32_t esi = 0;
+      int x;
+      for (x = row_bytes - 4; x >= 0; x -= 4)
+      {
+         memcpy(&esi, p + x, 4);
+         esi ^= x;
+         crc = (crc << 4) + ((crc >> 28) & 15);
+         crc += esi;
+      }
+      esi ^= y;
+      crc += esi;
+   }
+   return crc;
+}
+
+/* Rice with bFastTexCRC: a dword in 2 to 7 of every 2nd or 3rd row */
+static uint32_t old_rice_fast(const uint8_t *p, size_t row_bytes, unsigned rows, ptrdiff_t pitch)
+{
+   uint32_t width = row_bytes >> 2;
+   uint32_t xinc = width / 13, yinc = rows / 11;
+   uint32_t crc = 0, x, y;
+
+   if (xinc < 2) xinc = 2;
+   if (xinc > 7) xinc = 7;
+   if (yinc < 2) yinc = rows < 2 ? rows : 2;
+   if (yinc > 3) yinc = 3;
+   for (y = 0; y < rows; y += yinc, p += pitch)
+   {
+      for (x = 0; x < width; )
+      {
+         uint32_t v;
+         memcpy(&v, p + x * 4, 4);
+         crc = (crc << 4) + ((crc >> 28) & 15);
+         crc += v;
+         x += xinc;
+         crc += x;
+      }
+      crc ^= y;
+   }
+   return crc;
+}
+
+/* Glide64 textureCRC before */
+static uint32_t old_glide64(const uint8_t *p, size_t row_bytes, unsigned rows, ptrdiff_t pitch)
+{
+   uint32_t crc = 0;
+   for (; rows; rows--, p += pitch)
+   {
+      const uint32_t *pixelpos = (const uint32_t*)p;
+      unsigned i;
+      for (i = row_bytes >> 3; i; --i)
+      {
+         uint64_t twopixel_crc = i * (uint64_t)(pixelpos[1] + pixelpos[0] + crc);
+         crc = (twopixel_crc >> 32) + twopixel_crc;
+         pixelpos += 2;
+      }
+      crc = ((unsigned)rows * (uint64_t)crc >> 32) + rows * crc;
+   }
+   return crc;
+}
+
+static uint32_t new_texhash(const uint8_t *p, size_t row_bytes, unsigned rows, ptrdiff_t pitch)
+{
+   return texhash_rect(0, p, row_bytes, rows, pitch);
+}
+
+typedef uint32_t (*hash_func)(const uint8_t *p, size_t row_bytes, unsigned rows, ptrdiff_t pitch);
+
+/* a 64x64 16 bit texture in a 320 pixel wide RDRAM image */
+#define ROW_BYTES 128
+#define ROWS      64
+#define PITCH     640
+
+static uint8_t image[PITCH * ROWS];
+
+static void bench(const char *name, hash_func hash, unsigned rounds)
+{
+   volatile uint32_t sink = 0;
+   clock_t start = clock();
+   double seconds;
+   unsigned r;
+
+   for (r = 0; r < rounds; r++)
+   {
+      image[r % sizeof(image)]++;
+      sink += hash(image, ROW_BYTES, ROWS, PITCH);
+   }
+   seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+   printf("  %-22s %8.2f GB/s\n", name,
+         seconds > 0 ? (double)rounds * ROW_BYTES * ROWS / seconds / 1e9 : 0.0);
+}
+
+/* single bit flips of the texture each hash does not notice */
+static void missed(unsigned rounds)
+{
+   unsigned r, fast = 0, full = 0;
+   for (r = 0; r < rounds; r++)
+   {
+      unsigned byte = (rand() % ROWS) * PITCH + rand() % ROW_BYTES;
+      uint8_t bit = 1 << (rand() % 8);
+      uint32_t a = old_rice_fast(image, ROW_BYTES, ROWS, PITCH);
+      uint32_t b = new_texhash(image, ROW_BYTES, ROWS, PITCH);
+      image[byte] ^= bit;
+      fast += a == old_rice_fast(image, ROW_BYTES, ROWS, PITCH);
+      full += b == new_texhash(image, ROW_BYTES, ROWS, PITCH);
+   }
+   printf("single bit changes missed: Rice fast %.1f%%, texhash %.1f%%\n",
+         100.0 * fast / rounds, 100.0 * full / rounds);
+   if (full)
+      bad++;
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned rounds = (argc > 1) ? atoi(argv[1]) : 100000;
+   unsigned i;
+
+   for (i = 0; i < sizeof(image); i++)
+      image[i] = rand();
+   build_crc32_table();
+
+   printf("%ix%i bytes, pitch %i\n", ROW_BYTES, ROWS, PITCH);
+   bench("gles2n64 CRC32", old_gles2n64, rounds / 10);
+   bench("Rice", old_rice, rounds / 10);
+   bench("Rice fast (sampled)", old_rice_fast, rounds / 10);
+   bench("Glide64", old_glide64, rounds / 10);
+
+   texhash_init(0);
+   check(rounds);
+   bench("texhash table", new_texhash, rounds / 10);
+
+   texhash_init(RETRO_SIMD_SSE2 | RETRO_SIMD_NEON);
+   if (texhash_backend() != TEXHASH_TABLE)
+   {
+      check(rounds);
+      bench("texhash hardware", new_texhash, rounds / 10);
+   }
+   else
+      printf("  no CRC instructions in this build or CPU\n");
+
+   missed(rounds / 100);
+
+   if (bad)
+   {
+      printf("MISMATCH in %i checks\n", bad);
+      return 1;
+   }
+   printf("all %s and table hashes are CRC32C\n", texhash_backend_name());
+   return 0;
+}